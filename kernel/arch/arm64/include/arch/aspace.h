@@ -63,9 +63,14 @@ private:
                          uint index_shift, uint page_size_shift,
                          volatile pte_t* page_table) TA_REQ(lock_);
 
+    // |flush_terminal| controls whether terminal entries get a TLB flush as
+    // they are removed; page table entries are always flushed before their
+    // tables are freed. Callers that pass false must invalidate the whole
+    // ASID afterwards (see FlushAsid()).
     ssize_t UnmapPageTable(vaddr_t vaddr, vaddr_t vaddr_rel, size_t size,
                            uint index_shift, uint page_size_shift,
-                           volatile pte_t* page_table) TA_REQ(lock_);
+                           volatile pte_t* page_table,
+                           bool flush_terminal) TA_REQ(lock_);
 
     int ProtectPageTable(vaddr_t vaddr_in, vaddr_t vaddr_rel_in, size_t size_in,
                          pte_t attrs, uint index_shift, uint page_size_shift,
@@ -90,6 +95,9 @@ private:
 
     void FlushTLBEntry(vaddr_t vaddr, bool terminal) TA_REQ(lock_);
 
+    // Invalidate every TLB entry for this aspace's ASID (or VMID for guests).
+    void FlushAsid() TA_REQ(lock_);
+
     fbl::Canary<fbl::magic("VAAS")> canary_;
 
     fbl::Mutex lock_;
@@ -49,6 +49,10 @@
 #define LOCAL_KTRACE64(probe, x)
 #endif
 
+// Unmaps covering more than this many pages invalidate the whole asid
+// instead of issuing a broadcast TLBI per page.
+static constexpr size_t kTlbFlushAllPageCount = 32;
+
 static_assert(((long)KERNEL_BASE >> MMU_KERNEL_SIZE_SHIFT) == -1, "");
 static_assert(((long)KERNEL_ASPACE_BASE >> MMU_KERNEL_SIZE_SHIFT) == -1, "");
 static_assert(MMU_KERNEL_SIZE_SHIFT <= 48, "");
@@ -510,11 +514,25 @@ void ArmArchVmAspace::FlushTLBEntry(vaddr_t vaddr, bool terminal) {
     }
 }
 
+// Invalidate all TLB entries tagged with this aspace's asid (or vmid for a
+// guest). Used instead of per page invalidations when unmapping large ranges.
+void ArmArchVmAspace::FlushAsid() {
+    DEBUG_ASSERT(asid_ != MMU_ARM64_GLOBAL_ASID);
+    if (flags_ & ARCH_ASPACE_FLAG_GUEST) {
+        paddr_t vttbr = arm64_vttbr(asid_, tt_phys_);
+        __UNUSED zx_status_t status = arm64_el2_tlbi_vmid(vttbr);
+        DEBUG_ASSERT(status == ZX_OK);
+    } else {
+        ARM64_TLBI(ASIDE1IS, asid_);
+    }
+}
+
 // NOTE: caller must DSB afterwards to ensure TLB entries are flushed
 ssize_t ArmArchVmAspace::UnmapPageTable(vaddr_t vaddr, vaddr_t vaddr_rel,
                                         size_t size, uint index_shift,
                                         uint page_size_shift,
-                                        volatile pte_t* page_table) {
+                                        volatile pte_t* page_table,
+                                        bool flush_terminal) {
     volatile pte_t* next_page_table;
     vaddr_t index;
     size_t chunk_size;
@@ -544,7 +562,7 @@ ssize_t ArmArchVmAspace::UnmapPageTable(vaddr_t vaddr, vaddr_t vaddr_rel,
             next_page_table = static_cast<volatile pte_t*>(paddr_to_physmap(page_table_paddr));
             UnmapPageTable(vaddr, vaddr_rem, chunk_size,
                            index_shift - (page_size_shift - 3),
-                           page_size_shift, next_page_table);
+                           page_size_shift, next_page_table, flush_terminal);
             if (chunk_size == block_size ||
                 page_table_is_clear(next_page_table, page_size_shift)) {
                 LTRACEF("pte %p[0x%lx] = 0 (was page table)\n", page_table, index);
@@ -566,8 +584,11 @@ ssize_t ArmArchVmAspace::UnmapPageTable(vaddr_t vaddr, vaddr_t vaddr_rel,
             // ensure that the update is observable from hardware page table walkers
             DMB_ISHST;
 
-            // flush the terminal TLB entry
-            FlushTLBEntry(vaddr, true);
+            // flush the terminal TLB entry, unless the caller is going to
+            // invalidate the whole asid when the unmap is done
+            if (flush_terminal) {
+                FlushTLBEntry(vaddr, true);
+            }
         } else {
             LTRACEF("pte %p[0x%lx] already clear\n", page_table, index);
         }
@@ -661,7 +682,7 @@ ssize_t ArmArchVmAspace::MapPageTable(vaddr_t vaddr_in, vaddr_t vaddr_rel_in,
 
 err:
     UnmapPageTable(vaddr_in, vaddr_rel_in, size_in - size, index_shift,
-                   page_size_shift, page_table);
+                   page_size_shift, page_table, true);
     return ZX_ERR_INTERNAL;
 }
 
@@ -784,8 +805,18 @@ ssize_t ArmArchVmAspace::UnmapPages(vaddr_t vaddr, size_t size,
 
     LOCAL_KTRACE64("mmu unmap", (vaddr & ~PAGE_MASK) | ((size >> PAGE_SIZE_SHIFT) & PAGE_MASK));
 
+    // For large ranges one invalidation of the whole asid at the end is
+    // cheaper than broadcasting a TLBI per page. The kernel aspace shares the
+    // global asid, so it always flushes per page. Page table entries are
+    // still flushed individually before their tables are freed.
+    const bool flush_all = ((size >> page_size_shift) > kTlbFlushAllPageCount) &&
+                           (asid_ != MMU_ARM64_GLOBAL_ASID);
+
     ssize_t ret = UnmapPageTable(vaddr, vaddr_rel, size, top_index_shift,
-                                 page_size_shift, tt_virt_);
+                                 page_size_shift, tt_virt_, !flush_all);
+    if (flush_all) {
+        FlushAsid();
+    }
     DSB;
     return ret;
 }
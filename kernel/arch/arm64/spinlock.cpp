@@ -12,20 +12,40 @@
 // implementing the locks themselves.  Without this, the header-level
 // annotations cause Clang to detect violations.
 
+// Upper bound on the backoff delay between acquisition attempts, in
+// yield iterations.
+constexpr uint32_t kSpinLockMaxBackoff = 1024;
+
 void arch_spin_lock(spin_lock_t* lock) TA_NO_THREAD_SAFETY_ANALYSIS {
     unsigned long val = arch_curr_cpu_num() + 1;
     uint64_t temp;
+    uint32_t delay = 1;
 
-    __asm__ volatile(
-        "sevl;"
-        "1: wfe;"
-        "ldaxr   %[temp], [%[lock]];"
-        "cbnz    %[temp], 1b;"
-        "stxr    %w[temp], %[val], [%[lock]];"
-        "cbnz    %w[temp], 1b;"
-        : [temp] "=&r"(temp)
-        : [lock] "r"(&lock->value), [val] "r"(val)
-        : "cc", "memory");
+    for (;;) {
+        __asm__ volatile(
+            "sevl;"
+            "1: wfe;"
+            "ldaxr   %[temp], [%[lock]];"
+            "cbnz    %[temp], 1b;"
+            "stxr    %w[temp], %[val], [%[lock]];"
+            : [temp] "=&r"(temp)
+            : [lock] "r"(&lock->value), [val] "r"(val)
+            : "cc", "memory");
+        if (temp == 0) {
+            return;
+        }
+
+        // The store-exclusive lost the race against another waiter. Every
+        // loss doubles the delay (capped) before rejoining the wfe loop,
+        // so when an unlock wakes many waiters at once they do not all
+        // stampede the line again on the next release.
+        for (uint32_t i = 0; i < delay; i++) {
+            __asm__ volatile("yield" ::: "memory");
+        }
+        if (delay < kSpinLockMaxBackoff) {
+            delay <<= 1;
+        }
+    }
 }
 
 int arch_spin_trylock(spin_lock_t* lock) TA_NO_THREAD_SAFETY_ANALYSIS {
@@ -32,6 +32,7 @@
 
 #include <lib/counters.h>
 #include <lib/ktrace.h>
+#include <lib/latency_watch.h>
 
 #include <zircon/syscalls/exception.h>
 #include <zircon/types.h>
@@ -413,7 +414,9 @@ static void handle_exception_types(x86_iframe_t* frame) {
     /* pass all other non-Intel defined irq vectors to the platform */
     case X86_INT_PLATFORM_BASE ... X86_INT_PLATFORM_MAX: {
         kcounter_add(exceptions_irq, 1);
+        zx_time_t lw_start = latency_watch_begin();
         platform_irq(frame);
+        latency_watch_end(LW_CLASS_IRQ, lw_start);
         break;
     }
 
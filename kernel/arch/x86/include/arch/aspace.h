@@ -13,6 +13,7 @@
 #include <fbl/algorithm.h>
 #include <fbl/atomic.h>
 #include <fbl/canary.h>
+#include <kernel/cpu.h>
 #include <vm/arch_vm_aspace.h>
 #include <zircon/compiler.h>
 #include <zircon/types.h>
@@ -96,6 +97,27 @@ public:
 
     int active_cpus() { return active_cpus_.load(); }
 
+    // TLB-generation bookkeeping, used to skip shootdown IPIs to cpus whose
+    // TLB provably holds no stale entries for this aspace; see
+    // x86_tlb_invalidate_page in mmu.cpp.
+
+    // Assign the next generation to a shootdown being issued.
+    uint64_t AdvanceTlbGen() { return tlb_gen_.fetch_add(1) + 1; }
+
+    uint64_t CurrentTlbGen() { return tlb_gen_.load(); }
+
+    // Record that |cpu|'s TLB holds no entries for this aspace staler than
+    // |gen| (because it completed a full flush, or reloaded cr3).
+    void MarkTlbFlushed(cpu_num_t cpu, uint64_t gen) {
+        // A racy overwrite with an older generation is benign: it can only
+        // cause an extra flush, never a missed one.
+        if (cpu_flushed_tlb_gen_[cpu].load() < gen) {
+            cpu_flushed_tlb_gen_[cpu].store(gen);
+        }
+    }
+
+    uint64_t CpuFlushedTlbGen(cpu_num_t cpu) { return cpu_flushed_tlb_gen_[cpu].load(); }
+
     IoBitmap& io_bitmap() { return io_bitmap_; }
 
     static void ContextSwitch(X86ArchVmAspace* from, X86ArchVmAspace* to);
@@ -129,6 +151,12 @@ private:
     // CPUs that are currently executing in this aspace.
     // Actually an mp_cpu_mask_t, but header dependencies.
     fbl::atomic_int active_cpus_{0};
+
+    // Monotonic count of TLB invalidations issued against this aspace and,
+    // per cpu, the generation up to which that cpu's TLB has provably been
+    // flushed of this aspace's entries.
+    fbl::atomic<uint64_t> tlb_gen_{0};
+    fbl::atomic<uint64_t> cpu_flushed_tlb_gen_[SMP_MAX_CPUS] = {};
 };
 
 using ArchVmAspace = X86ArchVmAspace;
@@ -488,7 +488,7 @@ static inline void outpdrep(uint16_t _port, uint32_t* _buffer,
 }
 
 void x86_monitor(volatile void* addr);
-void x86_mwait(void);
+void x86_mwait(uint32_t hint);
 void x86_idle(void);
 
 __END_CDECLS
@@ -73,6 +73,10 @@ struct x86_percpu {
 
     /* Reserved space for interrupt stacks */
     uint8_t interrupt_stacks[NUM_ASSIGNED_IST_ENTRIES][PAGE_SIZE] __ALIGNED(16);
+
+    /* Idle-state governor bookkeeping (see arch_idle_thread_routine) */
+    zx_time_t idle_enter_time;
+    zx_duration_t idle_duration_ewma;
 } __CPU_ALIGN;
 
 static_assert(__offsetof(struct x86_percpu, direct) == PERCPU_DIRECT_OFFSET, "");
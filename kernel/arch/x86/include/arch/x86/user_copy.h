@@ -11,9 +11,10 @@
 
 __BEGIN_CDECLS
 
-/* This function is used by arch_copy_from_user() and arch_copy_to_user().
- * It should not be called anywhere except in the x86 usercopy
- * implementation. */
+/* These functions are used by arch_copy_from_user() and arch_copy_to_user().
+ * They should not be called anywhere except in the x86 usercopy
+ * implementation.  The first relies on fast "rep movsb" (ERMS); the _quad
+ * variant moves the bulk of the buffer as quadwords for CPUs without it. */
 
 zx_status_t _x86_copy_to_or_from_user(
         void *dst,
@@ -21,4 +22,10 @@ zx_status_t _x86_copy_to_or_from_user(
         size_t len,
         void **fault_return);
 
+zx_status_t _x86_copy_to_or_from_user_quad(
+        void *dst,
+        const void *src,
+        size_t len,
+        void **fault_return);
+
 __END_CDECLS
@@ -141,6 +141,7 @@ static void x86_tlb_nonglobal_invalidate() {
 struct TlbInvalidatePage_context {
     ulong target_cr3;
     const PendingTlbInvalidation* pending;
+    X86ArchVmAspace* aspace;
 };
 static void TlbInvalidatePage_task(void* raw_context) {
     DEBUG_ASSERT(arch_ints_disabled());
@@ -153,11 +154,21 @@ static void TlbInvalidatePage_task(void* raw_context) {
     }
 
     if (context->pending->full_shootdown) {
+        uint64_t flushed_gen = 0;
+        if (context->aspace != nullptr) {
+            /* Any generation assigned before this point had its page table
+             * writes completed before it, so the flush below covers all of
+             * them. */
+            flushed_gen = context->aspace->CurrentTlbGen();
+        }
         if (context->pending->contains_global) {
             x86_tlb_global_invalidate();
         } else {
             x86_tlb_nonglobal_invalidate();
         }
+        if (context->aspace != nullptr) {
+            context->aspace->MarkTlbFlushed(arch_curr_cpu_num(), flushed_gen);
+        }
         return;
     }
 
@@ -188,7 +199,7 @@ static void x86_tlb_invalidate_page(const X86PageTableBase* pt, PendingTlbInvali
 
     ulong cr3 = pt ? pt->phys() : x86_get_cr3();
     struct TlbInvalidatePage_context task_context = {
-        .target_cr3 = cr3, .pending = pending,
+        .target_cr3 = cr3, .pending = pending, .aspace = nullptr,
     };
 
     /* Target only CPUs this aspace is active on.  It may be the case that some
@@ -202,7 +213,24 @@ static void x86_tlb_invalidate_page(const X86PageTableBase* pt, PendingTlbInvali
         target = MP_IPI_TARGET_ALL;
     } else {
         target = MP_IPI_TARGET_MASK;
-        target_mask = static_cast<X86ArchVmAspace*>(pt->ctx())->active_cpus();
+        X86ArchVmAspace* aspace = static_cast<X86ArchVmAspace*>(pt->ctx());
+        task_context.aspace = aspace;
+
+        /* Stamp this shootdown with the next TLB generation. The page table
+         * writes it covers are already visible, so a cpu whose flushed
+         * generation reaches |gen| (via a concurrent full shootdown or a cr3
+         * reload on context switch) provably holds no stale entries for this
+         * invalidation and can be skipped. */
+        uint64_t gen = aspace->AdvanceTlbGen();
+        target_mask = aspace->active_cpus();
+        cpu_mask_t remaining = target_mask;
+        while (remaining) {
+            cpu_num_t cpu_id = lowest_cpu_set(remaining);
+            remaining &= ~cpu_num_to_mask(cpu_id);
+            if (aspace->CpuFlushedTlbGen(cpu_id) >= gen) {
+                target_mask &= ~cpu_num_to_mask(cpu_id);
+            }
+        }
     }
 
     mp_sync_exec(target, target_mask, TlbInvalidatePage_task, &task_context);
@@ -646,12 +674,17 @@ void X86ArchVmAspace::ContextSwitch(X86ArchVmAspace* old_aspace, X86ArchVmAspace
         aspace->canary_.Assert();
         paddr_t phys = aspace->pt_phys();
         LTRACEF_LEVEL(3, "switching to aspace %p, pt %#" PRIXPTR "\n", aspace, phys);
+        // Loading cr3 discards this cpu's non-global TLB entries, so any
+        // invalidation generation assigned before this point no longer has
+        // stale entries here.
+        uint64_t tlb_gen = aspace->CurrentTlbGen();
         x86_set_cr3(phys);
 
         if (old_aspace != nullptr) {
             old_aspace->active_cpus_.fetch_and(~cpu_bit);
         }
         aspace->active_cpus_.fetch_or(cpu_bit);
+        aspace->MarkTlbFlushed(arch_curr_cpu_num(), tlb_gen);
     } else {
         LTRACEF_LEVEL(3, "switching to kernel aspace, pt %#" PRIxPTR "\n", kernel_pt_phys);
         x86_set_cr3(kernel_pt_phys);
@@ -26,7 +26,9 @@
 #include <arch/x86/tsc.h>
 #include <dev/hw_rng.h>
 #include <dev/interrupt.h>
+#include <kernel/cmdline.h>
 #include <kernel/event.h>
+#include <kernel/percpu.h>
 #include <kernel/timer.h>
 #include <platform.h>
 #include <zircon/types.h>
@@ -37,8 +39,64 @@ struct x86_percpu* ap_percpus;
 uint8_t x86_num_cpus = 1;
 static bool use_monitor = false;
 
+/* Idle-state governor: mwait hint used when a long idle period is expected
+ * (hint (n << 4) requests C-state n+1; 0 requests C1), and the expected
+ * idle duration above which it is worth paying that state's wakeup
+ * latency. */
+static uint32_t mwait_deep_hint = 0;
+static zx_duration_t deep_idle_threshold = ZX_USEC(300);
+
 extern struct idt _idt;
 
+static void x86_idle_states_init(void) {
+    // Pick the deepest mwait C-state with at least one sub-state enumerated
+    // in CPUID leaf 5. The hint (n << 4) requests C-state n+1.
+    uint32_t sub_states = x86_get_cpuid_leaf(X86_CPUID_MON)->d;
+    for (uint32_t cstate = 1; cstate < 8; cstate++) {
+        if ((sub_states >> (4 * cstate)) & 0xf) {
+            mwait_deep_hint = (cstate - 1) << 4;
+        }
+    }
+
+    // kernel.x86.max-cstate caps how deep the governor may go; 1 pins the
+    // idle loop to C1 for latency-sensitive deployments.
+    uint32_t max_cstate = cmdline_get_uint32("kernel.x86.max-cstate", 8);
+    if (max_cstate < 1) {
+        max_cstate = 1;
+    }
+    if (mwait_deep_hint > ((max_cstate - 1) << 4)) {
+        mwait_deep_hint = (max_cstate - 1) << 4;
+    }
+
+    deep_idle_threshold =
+        ZX_USEC(cmdline_get_uint32("kernel.x86.deep-idle-threshold-us", 300));
+}
+
+// Choose an mwait hint for the idle period which is starting now.
+//
+// The expected idle duration is the sooner of the cpu's next local timer
+// and what recent wakeups suggest. Interrupts and reschedule requests can
+// end the idle period well before any timer, so the history term keeps
+// bursty cpus in shallow states even when the timer queue is far out.
+static uint32_t x86_idle_hint(struct x86_percpu* pc) {
+    zx_time_t now = current_time();
+    pc->idle_enter_time = now;
+
+    zx_duration_t expected = pc->idle_duration_ewma;
+    zx_time_t deadline = percpu[pc->cpu_num].next_timer_deadline;
+    if (deadline > now && deadline - now < expected) {
+        expected = deadline - now;
+    }
+    return expected >= deep_idle_threshold ? mwait_deep_hint : 0;
+}
+
+// Fold the idle period which just ended into the wakeup history
+// (exponentially weighted moving average, alpha = 1/4).
+static void x86_idle_wakeup(struct x86_percpu* pc) {
+    zx_duration_t idled = current_time() - pc->idle_enter_time;
+    pc->idle_duration_ewma += (idled - pc->idle_duration_ewma) / 4;
+}
+
 zx_status_t x86_allocate_ap_structures(uint32_t* apic_ids, uint8_t cpu_count) {
     ASSERT(ap_percpus == nullptr);
 
@@ -56,6 +114,7 @@ zx_status_t x86_allocate_ap_structures(uint32_t* apic_ids, uint8_t cpu_count) {
         memset(ap_percpus, 0, len);
 
         if ((use_monitor = x86_feature_test(X86_FEATURE_MON))) {
+            x86_idle_states_init();
             uint16_t monitor_size = x86_get_cpuid_leaf(X86_CPUID_MON)->b & 0xffff;
             if (monitor_size < MAX_CACHE_LINE) {
                 monitor_size = MAX_CACHE_LINE;
@@ -270,7 +329,8 @@ __NO_RETURN int arch_idle_thread_routine(void*) {
                 // the monitor being armed. Any writes after arming the monitor will trigger
                 // it and cause mwait to return, so there aren't races after this check.
                 if (*percpu->monitor) {
-                    x86_mwait();
+                    x86_mwait(x86_idle_hint(percpu));
+                    x86_idle_wakeup(percpu);
                 }
             }
             thread_preempt();
@@ -857,13 +857,11 @@ zx_status_t X86PageTableBase::MapPages(vaddr_t vaddr, paddr_t* phys, size_t coun
         fbl::AutoLock a(&lock_);
         DEBUG_ASSERT(virt_);
 
-        // TODO(teisenbe): Improve performance of this function by integrating deeper into
-        // the algorithm (e.g. make the cursors aware of the page array).
-        size_t idx = 0;
+        size_t mapped_size = 0;
         auto undo = fbl::MakeAutoCall([&]() TA_NO_THREAD_SAFETY_ANALYSIS {
-            if (idx > 0) {
+            if (mapped_size > 0) {
                 MappingCursor start = {
-                    .paddr = 0, .vaddr = vaddr, .size = idx * PAGE_SIZE,
+                    .paddr = 0, .vaddr = vaddr, .size = mapped_size,
                 };
 
                 MappingCursor result;
@@ -874,9 +872,19 @@ zx_status_t X86PageTableBase::MapPages(vaddr_t vaddr, paddr_t* phys, size_t coun
         });
 
         vaddr_t v = vaddr;
-        for (; idx < count; ++idx) {
+        size_t idx = 0;
+        while (idx < count) {
+            // Coalesce physically contiguous pages into a single mapping
+            // request, so AddMapping can use large pages for any suitably
+            // aligned portion of the run.
+            size_t run = 1;
+            while (idx + run < count &&
+                   phys[idx + run] == phys[idx] + run * PAGE_SIZE) {
+                run++;
+            }
+
             MappingCursor start = {
-                .paddr = phys[idx], .vaddr = v, .size = PAGE_SIZE,
+                .paddr = phys[idx], .vaddr = v, .size = run * PAGE_SIZE,
             };
             MappingCursor result;
             zx_status_t status = AddMapping(virt_, mmu_flags, top, start, &result, &cm);
@@ -886,7 +894,9 @@ zx_status_t X86PageTableBase::MapPages(vaddr_t vaddr, paddr_t* phys, size_t coun
             }
             DEBUG_ASSERT(result.size == 0);
 
-            v += PAGE_SIZE;
+            v += run * PAGE_SIZE;
+            mapped_size += run * PAGE_SIZE;
+            idx += run;
         }
 
         undo.cancel();
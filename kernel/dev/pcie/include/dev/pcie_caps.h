@@ -236,6 +236,18 @@ public:
     PciReg32 pending_bits_reg() const { return pending_bits_; }
     msi_block_t irq_block() const { return irq_block_; }
 
+    // The PVM mask bits register is shadowed in memory so the
+    // mask/unmask hot path can read-modify-write without touching
+    // config space for the read half.  All writes to the register must
+    // go through SetMaskBits() to keep the shadow coherent; the shadow
+    // is re-primed along with the hardware when the capability is
+    // (re)initialized.
+    uint32_t CachedMaskBits() const { return mask_bits_shadow_; }
+    void SetMaskBits(const PciConfig* cfg, uint32_t val) {
+        cfg->Write(mask_bits_reg(), val);
+        mask_bits_shadow_ = val;
+    }
+
 private:
     // TODO(cja): Dragons here. irq_block_ is setup by PcieDevice rather than the init for
     // PciCapMsi. This should be refactored.
@@ -244,6 +256,7 @@ private:
     bool has_pvm_;
     bool is_64_bit_;
     unsigned int max_irqs_ = 0;
+    uint32_t mask_bits_shadow_ = 0;
     msi_block_t irq_block_;
 
     // Cached registers
@@ -251,7 +251,7 @@ PciCapMsi::PciCapMsi(const PcieDevice& dev, uint16_t base, uint8_t id)
     cfg->Write(ctrl_reg(), PCIE_CAP_MSI_CTRL_SET_MME(0,
                            PCIE_CAP_MSI_CTRL_SET_ENB(0, ctrl)));
     if (has_pvm_)
-        cfg->Write(mask_bits_reg(), 0xFFFFFFFF);
+        SetMaskBits(cfg, 0xFFFFFFFF);
 
     is_valid_ = true;
 }
@@ -287,10 +287,10 @@ bool PcieDevice::MaskUnmaskMsiIrqLocked(uint irq_id, bool mask) {
     /* If we can mask at the PCI device level, do so. */
     if (irq_.msi->has_pvm()) {
         DEBUG_ASSERT(irq_id < PCIE_MAX_MSI_IRQS);
-        uint32_t  val  = cfg_->Read(irq_.msi->mask_bits_reg());
+        uint32_t  val  = irq_.msi->CachedMaskBits();
         if (mask) val |=  (static_cast<uint32_t>(1u) << irq_id);
         else      val &= ~(static_cast<uint32_t>(1u) << irq_id);
-        cfg_->Write(irq_.msi->mask_bits_reg(), val);
+        irq_.msi->SetMaskBits(cfg_, val);
     }
 
     /* If we can mask at the platform interrupt controller level, do so. */
@@ -335,7 +335,7 @@ void PcieDevice::MaskAllMsiVectors() {
      * have already been masked during the calls to MaskUnmaskMsiIrq.  Just to
      * be careful, however, we explicitly mask all of the upper bits as well. */
     if (irq_.msi->has_pvm())
-        cfg_->Write(irq_.msi->mask_bits_reg(), 0xFFFFFFFF);
+        irq_.msi->SetMaskBits(cfg_, 0xFFFFFFFF);
 }
 
 void PcieDevice::SetMsiTarget(uint64_t tgt_addr, uint32_t tgt_data) {
@@ -426,7 +426,7 @@ zx_status_t PcieDevice::EnterMsiIrqMode(uint requested_irqs) {
     // attempting to allocte the block of IRQs.
     bool initially_masked;
     if (irq_.msi->has_pvm()) {
-        cfg_->Write(irq_.msi->mask_bits_reg(), 0xFFFFFFFF);
+        irq_.msi->SetMaskBits(cfg_, 0xFFFFFFFF);
         initially_masked = true;
     } else {
         // If we cannot mask at the PCI level, then our IRQs will be initially
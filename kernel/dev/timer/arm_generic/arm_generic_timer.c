@@ -257,6 +257,12 @@ zx_ticks_t ticks_per_second(void)
     return u64_mul_u32_fp32_64(1000 * 1000 * 1000, cntpct_per_ns);
 }
 
+bool platform_monotonic_ticks_rate(struct fp_32_64 *ns_per_tick)
+{
+    *ns_per_tick = ns_per_cntpct;
+    return true;
+}
+
 static uint32_t abs_int32(int32_t a)
 {
     return (a > 0) ? a : -a;
@@ -39,6 +39,16 @@ struct display_info {
 
     // Update function
     void (*flush)(uint starty, uint endy);
+
+    // Optional panning support: the framebuffer holds |vheight| total rows
+    // (vheight >= height) and the driver can move the scanout window so it
+    // starts at pixel row |starty|. gfxconsole uses this to scroll without
+    // copying the whole screen. A driver providing |pan| must treat the
+    // rows passed to |flush| as relative to the current scanout window.
+    // Leave NULL (and vheight 0) if the controller's scanout base cannot
+    // be moved.
+    uint vheight;
+    void (*pan)(uint starty);
 };
 
 __BEGIN_CDECLS
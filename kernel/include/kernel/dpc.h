@@ -23,6 +23,9 @@ typedef struct dpc {
 
     dpc_func_t func;
     void* arg;
+
+    // time the dpc was queued; maintained by dpc_queue*() for latency counters
+    zx_time_t queue_time;
 } dpc_t;
 
 #define DPC_INITIAL_VALUE                   \
@@ -30,6 +33,7 @@ typedef struct dpc {
         .node = LIST_INITIAL_CLEARED_VALUE, \
         .func = 0,                          \
         .arg = 0,                           \
+        .queue_time = 0,                    \
     }
 
 // initializes dpc for the current cpu
@@ -39,6 +43,12 @@ void dpc_init_for_cpu(void);
 // the deferred procedure runs in a dedicated thread that runs at DPC_THREAD_PRIORITY
 zx_status_t dpc_queue(dpc_t* dpc, bool reschedule);
 
+// queue a dpc on the low-priority lane. low lane dpcs only run when the local
+// high lane is empty and may be stolen by another cpu's idle dpc thread, so
+// use this for bulk work (teardown, deferred frees) whose callback does not
+// depend on which cpu it runs on.
+zx_status_t dpc_queue_low(dpc_t* dpc, bool reschedule);
+
 // queue a dpc, but must be holding the thread lock
 // does not force a reschedule
 zx_status_t dpc_queue_thread_locked(dpc_t* dpc) TA_REQ(thread_lock);
@@ -92,6 +92,11 @@ struct mp_state {
     cpu_mask_t idle_cpus TA_GUARDED(thread_lock);
     cpu_mask_t realtime_cpus TA_GUARDED(thread_lock);
 
+    // cpus with a reschedule IPI sent but not yet acknowledged. further
+    // reschedule requests to those cpus are coalesced into the in-flight
+    // interrupt. updated atomically from both senders and the irq handler.
+    volatile cpu_mask_t ipi_resched_pending;
+
     spin_lock_t ipi_task_lock;
     // list of outstanding tasks for CPUs to execute.  Should only be
     // accessed with the ipi_task_lock held
@@ -160,6 +165,10 @@ static inline void mp_set_curr_cpu_active(bool active) {
         atomic_or((volatile int*)&mp.active_cpus, cpu_num_to_mask(arch_curr_cpu_num()));
     } else {
         atomic_and((volatile int*)&mp.active_cpus, ~cpu_num_to_mask(arch_curr_cpu_num()));
+        // drop any unacknowledged reschedule IPI so it can't suppress the
+        // first real one if this cpu comes back online
+        atomic_and((volatile int*)&mp.ipi_resched_pending,
+                   ~cpu_num_to_mask(arch_curr_cpu_num()));
     }
 }
 
@@ -31,6 +31,10 @@ struct percpu {
     struct list_node run_queue[NUM_PRIORITIES];
     uint32_t run_queue_bitmap;
 
+    // per cpu queue of deadline class threads, sorted by absolute deadline.
+    // deadline threads always run ahead of the priority run queues.
+    struct list_node deadline_queue;
+
 #if WITH_LOCK_DEP
     // state for runtime lock validation when in irq context
     lockdep_state_t lock_state;
@@ -47,6 +51,8 @@ struct percpu {
 
     // dpc context
     list_node_t dpc_list;
+    // bulk dpcs; only serviced when dpc_list is empty, stealable by other cpus
+    list_node_t dpc_low_list;
     event_t dpc_event;
     // request the dpc thread to stop by setting to true; guarded by dpc_lock
     bool dpc_stop;
@@ -34,6 +34,13 @@ void sched_inherit_priority(thread_t* t, int pri, bool* local_resched) TA_REQ(th
 // pri should be 0 <= to <= MAX_PRIORITY.
 void sched_change_priority(thread_t* t, int pri) TA_REQ(thread_lock);
 
+// move a thread into the deadline class with the given capacity/deadline/period
+// triple (all > 0, capacity <= relative_deadline <= period). This function
+// might reschedule.
+void sched_change_deadline(thread_t* t, zx_duration_t capacity,
+                           zx_duration_t relative_deadline,
+                           zx_duration_t period) TA_REQ(thread_lock);
+
 // return true if the thread was placed on the current cpu's run queue
 // this usually means the caller should locally reschedule soon
 bool sched_unblock(thread_t* t) __WARN_UNUSED_RESULT TA_REQ(thread_lock);
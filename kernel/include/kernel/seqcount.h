@@ -0,0 +1,64 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+#pragma once
+
+#include <arch/ops.h>
+#include <fbl/atomic.h>
+#include <zircon/compiler.h>
+
+// SeqCount is the counter half of a seqlock. Writers are serialized by an
+// external lock and bump the count around their updates; readers copy the
+// published data without taking that lock and retry if a writer ran
+// concurrently. Suited to small state that changes rarely but is read often
+// (diagnostics, get_info), where readers must never contend with the
+// owning object's hot path.
+//
+// Writer (holding the serializing lock):
+//     seq.WriteBegin();
+//     <update published data>
+//     seq.WriteEnd();
+//
+// Reader:
+//     uint32_t gen;
+//     do {
+//         gen = seq.ReadBegin();
+//         <copy published data>
+//     } while (seq.ReadRetry(gen));
+class SeqCount {
+public:
+    constexpr SeqCount() = default;
+    SeqCount(const SeqCount&) = delete;
+    SeqCount& operator=(const SeqCount&) = delete;
+
+    void WriteBegin() {
+        seq_.fetch_add(1u, fbl::memory_order_relaxed);
+        fbl::atomic_thread_fence(fbl::memory_order_release);
+    }
+
+    void WriteEnd() {
+        fbl::atomic_thread_fence(fbl::memory_order_release);
+        seq_.fetch_add(1u, fbl::memory_order_relaxed);
+    }
+
+    // Spins past in-progress writers, which only hold the count odd for the
+    // few stores between WriteBegin and WriteEnd.
+    uint32_t ReadBegin() const {
+        for (;;) {
+            uint32_t seq = seq_.load(fbl::memory_order_acquire);
+            if ((seq & 1u) == 0u)
+                return seq;
+            arch_spinloop_pause();
+        }
+    }
+
+    bool ReadRetry(uint32_t seq) const {
+        fbl::atomic_thread_fence(fbl::memory_order_acquire);
+        return seq_.load(fbl::memory_order_relaxed) != seq;
+    }
+
+private:
+    fbl::atomic<uint32_t> seq_{0u};
+};
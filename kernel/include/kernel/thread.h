@@ -49,6 +49,7 @@ typedef void (*thread_tls_callback_t)(void* tls_value);
 #define THREAD_FLAG_FREE_STRUCT              (1 << 1)
 #define THREAD_FLAG_REAL_TIME                (1 << 2)
 #define THREAD_FLAG_IDLE                     (1 << 3)
+#define THREAD_FLAG_DEADLINE                 (1 << 4)
 
 #define THREAD_SIGNAL_KILL                   (1 << 0)
 #define THREAD_SIGNAL_SUSPEND                (1 << 1)
@@ -107,6 +108,16 @@ typedef struct thread {
     int priority_boost;
     int inherited_priority;
 
+    // deadline scheduling parameters, valid when THREAD_FLAG_DEADLINE is set.
+    // the thread is granted deadline_capacity of run time out of every
+    // deadline_period, due within deadline_relative of the period start.
+    // absolute_deadline is the end of the current window and orders the
+    // per cpu deadline run queue.
+    zx_duration_t deadline_capacity;
+    zx_duration_t deadline_relative;
+    zx_duration_t deadline_period;
+    zx_time_t absolute_deadline;
+
     // current cpu the thread is either running on or in the ready queue, undefined otherwise
     cpu_num_t curr_cpu;
     cpu_num_t last_cpu;      // last cpu the thread ran on, INVALID_CPU if it's never run
@@ -232,6 +243,8 @@ void thread_construct_first(thread_t* t, const char* name);
 thread_t* thread_create_idle_thread(uint cpu_num);
 void thread_set_name(const char* name);
 void thread_set_priority(thread_t* t, int priority);
+void thread_set_deadline(thread_t* t, zx_duration_t capacity,
+                         zx_duration_t relative_deadline, zx_duration_t period);
 void thread_set_user_callback(thread_t* t, thread_user_callback_t cb);
 thread_t* thread_create(const char* name, thread_start_routine entry, void* arg, int priority);
 thread_t* thread_create_etc(thread_t* t, const char* name, thread_start_routine entry, void* arg,
@@ -319,6 +332,10 @@ void dump_thread_user_tid_locked(uint64_t tid, bool full);
 // global thread list
 thread_t* thread_id_to_thread_slow(uint64_t tid);
 
+static inline bool thread_is_deadline(thread_t* t) {
+    return !!(t->flags & THREAD_FLAG_DEADLINE);
+}
+
 static inline bool thread_is_realtime(thread_t* t) {
     return (t->flags & THREAD_FLAG_REAL_TIME) && t->base_priority > DEFAULT_PRIORITY;
 }
@@ -0,0 +1,38 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <kernel/cpu.h>
+#include <stdint.h>
+#include <zircon/compiler.h>
+
+// Small cpu topology model consulted by the scheduler when placing threads.
+//
+// Platform code records where each cpu sits in the cache hierarchy during smp
+// bringup; the scheduler then prefers waking a thread on an SMT sibling of, or
+// a cpu sharing a last level cache with, the cpu it last ran on.  CPUs that
+// are never registered fall back to masks that reproduce the scheduler's
+// topology-blind behavior.
+
+__BEGIN_CDECLS
+
+// Record the position of |cpu| in the cache hierarchy.  CPUs with the same
+// |package_id| and |node_id| share a last level cache; CPUs that additionally
+// share |core_id| are SMT siblings.  Called once per cpu during platform smp
+// init, before the secondary cpus are brought up.
+void topology_set_cpu_info(cpu_num_t cpu, uint32_t package_id, uint32_t node_id,
+                           uint32_t core_id);
+
+// Returns the mask of cpus (including |cpu| itself) that share a physical
+// core with |cpu|, or just |cpu|'s own mask if its topology is unknown.
+cpu_mask_t topology_smt_sibling_mask(cpu_num_t cpu);
+
+// Returns the mask of cpus (including |cpu| itself) that share a last level
+// cache with |cpu|, or CPU_MASK_ALL if its topology is unknown.
+cpu_mask_t topology_llc_mask(cpu_num_t cpu);
+
+__END_CDECLS
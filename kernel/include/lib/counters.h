@@ -94,3 +94,16 @@ static inline void kcounter_add(const struct k_counter_desc* var,
 }
 
 __END_CDECLS
+
+#ifdef __cplusplus
+
+#include <fbl/ref_ptr.h>
+
+class VmObject;
+
+// Returns the VMO in which the kernel periodically publishes aggregated
+// counter values (see zircon/kcounters.h for the layout), or nullptr if it
+// could not be created.  Userboot hands this to userspace as a kernel file.
+fbl::RefPtr<VmObject> counters_get_published_vmo();
+
+#endif // __cplusplus
@@ -38,6 +38,14 @@ zx_ticks_t ticks_per_second(void);
 /* high-precision timer current_ticks */
 zx_ticks_t current_ticks(void);
 
+struct fp_32_64;
+
+/* Returns true and fills |ns_per_tick| with the ticks-to-nanoseconds
+ * conversion factor when current_time() is computed by scaling
+ * current_ticks(); returns false when the monotonic clock is driven by a
+ * different source. */
+bool platform_monotonic_ticks_rate(struct fp_32_64* ns_per_tick);
+
 /* super early platform initialization, before almost everything */
 void platform_early_init(void);
 
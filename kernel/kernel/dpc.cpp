@@ -7,17 +7,28 @@
 #include <assert.h>
 #include <err.h>
 #include <list.h>
+#include <platform.h>
 #include <trace.h>
 
 #include <kernel/dpc.h>
 #include <kernel/event.h>
 #include <kernel/percpu.h>
 #include <kernel/spinlock.h>
+#include <lib/counters.h>
+#include <lib/latency_watch.h>
 #include <lk/init.h>
 
+// Approximate per-lane queue depths (queued minus executed).
+KCOUNTER(dpc_high_depth, "kernel.dpc.high.depth");
+KCOUNTER(dpc_low_depth, "kernel.dpc.low.depth");
+// Accumulated queue-to-execution latency per lane.
+KCOUNTER(dpc_high_latency, "kernel.dpc.high.latency_ns");
+KCOUNTER(dpc_low_latency, "kernel.dpc.low.latency_ns");
+KCOUNTER(dpc_low_steals, "kernel.dpc.low.steals");
+
 static spin_lock_t dpc_lock = SPIN_LOCK_INITIAL_VALUE;
 
-zx_status_t dpc_queue(dpc_t* dpc, bool reschedule) {
+static zx_status_t dpc_queue_common(dpc_t* dpc, bool reschedule, bool low) {
     DEBUG_ASSERT(dpc);
     DEBUG_ASSERT(dpc->func);
 
@@ -32,8 +43,10 @@ zx_status_t dpc_queue(dpc_t* dpc, bool reschedule) {
 
     struct percpu* cpu = get_local_percpu();
 
-    // put the dpc at the tail of the list and signal the worker
-    list_add_tail(&cpu->dpc_list, &dpc->node);
+    // put the dpc at the tail of its lane and signal the worker
+    dpc->queue_time = current_time();
+    list_add_tail(low ? &cpu->dpc_low_list : &cpu->dpc_list, &dpc->node);
+    kcounter_add(low ? dpc_low_depth : dpc_high_depth, 1);
 
     spin_unlock_irqrestore(&dpc_lock, state);
 
@@ -42,6 +55,14 @@ zx_status_t dpc_queue(dpc_t* dpc, bool reschedule) {
     return ZX_OK;
 }
 
+zx_status_t dpc_queue(dpc_t* dpc, bool reschedule) {
+    return dpc_queue_common(dpc, reschedule, false);
+}
+
+zx_status_t dpc_queue_low(dpc_t* dpc, bool reschedule) {
+    return dpc_queue_common(dpc, reschedule, true);
+}
+
 zx_status_t dpc_queue_thread_locked(dpc_t* dpc) {
     DEBUG_ASSERT(dpc);
     DEBUG_ASSERT(dpc->func);
@@ -56,8 +77,12 @@ zx_status_t dpc_queue_thread_locked(dpc_t* dpc) {
 
     struct percpu* cpu = get_local_percpu();
 
-    // put the dpc at the tail of the list and signal the worker
+    // put the dpc at the tail of the high lane and signal the worker. this
+    // path stays on the high lane: its callers rely on the dpc running on
+    // this cpu, so it must not be stealable.
+    dpc->queue_time = current_time();
     list_add_tail(&cpu->dpc_list, &dpc->node);
+    kcounter_add(dpc_high_depth, 1);
     event_signal_thread_locked(&cpu->dpc_event);
 
     spin_unlock(&dpc_lock);
@@ -113,8 +138,15 @@ void dpc_shutdown_transition_off_cpu(uint cpu_id) {
         list_add_tail(dst_list, &dpc->node);
     }
 
+    src_list = &percpu[cpu_id].dpc_low_list;
+    dst_list = &percpu[cur_cpu].dpc_low_list;
+    while ((dpc = list_remove_head_type(src_list, dpc_t, node))) {
+        list_add_tail(dst_list, &dpc->node);
+    }
+
     // Reset the state so we can restart DPC processing if the CPU comes back online.
     DEBUG_ASSERT(list_is_empty(&percpu[cpu_id].dpc_list));
+    DEBUG_ASSERT(list_is_empty(&percpu[cpu_id].dpc_low_list));
     percpu[cpu_id].dpc_stop = false;
     event_destroy(&percpu[cpu_id].dpc_event);
 
@@ -129,7 +161,6 @@ static int dpc_thread(void* arg) {
 
     struct percpu* cpu = get_local_percpu();
     event_t* event = &cpu->dpc_event;
-    list_node_t* list = &cpu->dpc_list;
 
     arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
 
@@ -145,22 +176,49 @@ static int dpc_thread(void* arg) {
             return 0;
         }
 
-        // pop a dpc off the list, make a local copy.
-        dpc_t* dpc = list_remove_head_type(list, dpc_t, node);
+        // drain the high lane before touching the low lane so latency
+        // sensitive dpcs are never queued behind bulk work.
+        bool low = false;
+        dpc_t* dpc = list_remove_head_type(&cpu->dpc_list, dpc_t, node);
+        if (!dpc) {
+            dpc = list_remove_head_type(&cpu->dpc_low_list, dpc_t, node);
+            low = (dpc != NULL);
+        }
 
-        // if the list is now empty, unsignal the event so we block until it is
+        if (!dpc) {
+            // both local lanes are empty; try to steal low lane work queued
+            // behind a slow dpc on another cpu before blocking.
+            for (uint i = 0; i < SMP_MAX_CPUS && !dpc; i++) {
+                // skip ourselves and cpus whose dpc state was never set up
+                if (&percpu[i] == cpu || percpu[i].dpc_low_list.next == NULL)
+                    continue;
+                dpc = list_remove_head_type(&percpu[i].dpc_low_list, dpc_t, node);
+            }
+            if (dpc) {
+                low = true;
+                kcounter_add(dpc_low_steals, 1);
+            }
+        }
+
+        // if no work was found, unsignal the event so we block until there is
         if (!dpc) {
             event_unsignal(event);
             dpc_local.func = NULL;
         } else {
            dpc_local = *dpc;
+           kcounter_add(low ? dpc_low_depth : dpc_high_depth, -1);
         }
 
         spin_unlock_irqrestore(&dpc_lock, state);
 
         // call the dpc
-        if (dpc_local.func)
+        if (dpc_local.func) {
+            kcounter_add(low ? dpc_low_latency : dpc_high_latency,
+                         current_time() - dpc_local.queue_time);
+            zx_time_t lw_start = latency_watch_begin();
             dpc_local.func(&dpc_local);
+            latency_watch_end(LW_CLASS_DPC, lw_start);
+        }
     }
 
     return 0;
@@ -176,6 +234,7 @@ void dpc_init_for_cpu(void) {
     }
 
     list_initialize(&cpu->dpc_list);
+    list_initialize(&cpu->dpc_low_list);
     event_init(&cpu->dpc_event, false, 0);
     cpu->dpc_stop = false;
 
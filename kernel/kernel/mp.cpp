@@ -31,8 +31,16 @@
 #include <trace.h>
 #include <zircon/types.h>
 
+#include <lib/counters.h>
+
 #define LOCAL_TRACE 0
 
+// counters to observe how well reschedule IPI coalescing is working:
+// generated is the number of cpus targeted by mp_reschedule calls, while
+// sent is how many actually turned into interrupts
+KCOUNTER(mp_resched_ipi_generated, "kernel.mp.resched_ipi.generated");
+KCOUNTER(mp_resched_ipi_sent, "kernel.mp.resched_ipi.sent");
+
 // a global state structure, aligned on cpu cache line to minimize aliasing
 struct mp_state mp __CPU_ALIGN_EXCLUSIVE;
 
@@ -76,6 +84,20 @@ void mp_reschedule(cpu_mask_t mask, uint flags) {
     if (mask == 0)
         return;
 
+    kcounter_add(mp_resched_ipi_generated, __builtin_popcount(mask));
+
+    // coalesce with in-flight reschedule IPIs: a cpu that hasn't acknowledged
+    // a previous reschedule interrupt yet will observe this request when that
+    // interrupt lands, so don't send it another one. atomic_or returns the
+    // old mask; only the bits we newly set need an interrupt.
+    cpu_mask_t old_pending = (cpu_mask_t)atomic_or((volatile int*)&mp.ipi_resched_pending,
+                                                   (int)mask);
+    mask &= ~old_pending;
+    if (mask == 0)
+        return;
+
+    kcounter_add(mp_resched_ipi_sent, __builtin_popcount(mask));
+
     arch_mp_reschedule(mask);
 }
 
@@ -417,6 +439,10 @@ void mp_mbx_reschedule_irq() {
 
     CPU_STATS_INC(reschedule_ipis);
 
+    // acknowledge the IPI before acting on it so that requests arriving from
+    // here on trigger a fresh interrupt rather than coalescing with this one
+    atomic_and((volatile int*)&mp.ipi_resched_pending, (int)~cpu_num_to_mask(cpu));
+
     if (mp.active_cpus & cpu_num_to_mask(cpu))
         thread_preempt_set_pending();
 }
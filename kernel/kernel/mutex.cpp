@@ -20,15 +20,27 @@
 #include <debug.h>
 #include <err.h>
 #include <inttypes.h>
+#include <kernel/mp.h>
 #include <kernel/sched.h>
 #include <kernel/thread.h>
 #include <kernel/thread_lock.h>
+#include <lib/counters.h>
 #include <lib/ktrace.h>
+#include <platform.h>
 #include <trace.h>
+#include <zircon/time.h>
 #include <zircon/types.h>
 
 #define LOCAL_TRACE 0
 
+// on contention, spin this long in the hope the holder releases before we pay
+// for a block/unblock round trip through the scheduler. roughly twice a
+// typical context switch cost.
+#define MUTEX_SPIN_MAX_DURATION ZX_USEC(150)
+
+KCOUNTER(mutex_spin_acquires, "kernel.mutex.spin.acquires");
+KCOUNTER(mutex_blocking_acquires, "kernel.mutex.blocking.acquires");
+
 /**
  * @brief  Initialize a mutex_t
  */
@@ -85,6 +97,31 @@ retry:
               ct, ct->name, m);
 #endif
 
+    // adaptive spin: the holder is most likely running on another cpu and
+    // critical sections are typically short, so burn a bounded amount of time
+    // retrying before falling into the wait queue. pointless on a single
+    // active cpu (the holder can't make progress until we block), and once a
+    // waiter has queued we join the queue to keep the handoff fair.
+    if (mp_get_active_mask() & ~cpu_num_to_mask(arch_curr_cpu_num())) {
+        const zx_time_t spin_deadline = zx_time_add_duration(current_time(),
+                                                             MUTEX_SPIN_MAX_DURATION);
+        do {
+            oldval = 0;
+            if (likely(atomic_cmpxchg_u64(&m->val, &oldval, (uintptr_t)ct))) {
+                ct->mutexes_held++;
+                kcounter_add(mutex_spin_acquires, 1);
+                return;
+            }
+            if (oldval & MUTEX_FLAG_QUEUED) {
+                // someone else is already blocked on this mutex, get in line
+                break;
+            }
+            arch_spinloop_pause();
+        } while (current_time() < spin_deadline);
+    }
+
+    kcounter_add(mutex_blocking_acquires, 1);
+
     {
         // we contended with someone else, will probably need to block
         Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
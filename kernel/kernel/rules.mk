@@ -31,6 +31,7 @@ MODULE_SRCS := \
 	$(LOCAL_DIR)/sched.cpp \
 	$(LOCAL_DIR)/thread.cpp \
 	$(LOCAL_DIR)/timer.cpp \
+	$(LOCAL_DIR)/topology.cpp \
 	$(LOCAL_DIR)/wait.cpp
 
 include make/module.mk
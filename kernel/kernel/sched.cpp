@@ -13,7 +13,10 @@
 #include <kernel/mp.h>
 #include <kernel/percpu.h>
 #include <kernel/thread.h>
+#include <kernel/topology.h>
+#include <lib/counters.h>
 #include <lib/ktrace.h>
+#include <lib/latency_watch.h>
 #include <list.h>
 #include <platform.h>
 #include <printf.h>
@@ -53,6 +56,14 @@
 // threads get 10ms to run before they use up their time slice and the scheduler is invoked
 #define THREAD_INITIAL_TIME_SLICE ZX_MSEC(10)
 
+// counters to track work stealing between cpu run queues
+KCOUNTER(sched_steal_attempt_count, "kernel.sched.steal.attempts");
+KCOUNTER(sched_steal_success_count, "kernel.sched.steal.successes");
+
+// counts wakeups placed on a cpu that does not share a last level cache with
+// the cpu the thread last ran on
+KCOUNTER(sched_cross_llc_migrations, "kernel.sched.cross_llc_migrations");
+
 static bool local_migrate_if_needed(thread_t* curr_thread);
 
 // compute the effective priority of a thread
@@ -66,12 +77,21 @@ static void compute_effec_priority(thread_t* t) {
     t->effec_priority = ep;
 }
 
+// start a new deadline window for the thread: it gets a fresh capacity of run
+// time, due within its relative deadline from now
+static void deadline_replenish(thread_t* t, zx_time_t now) {
+    DEBUG_ASSERT(thread_is_deadline(t));
+
+    t->absolute_deadline = zx_time_add_duration(now, t->deadline_relative);
+    t->remaining_time_slice = t->deadline_capacity;
+}
+
 // boost the priority of the thread by +1
 static void boost_thread(thread_t* t) {
     if (NO_BOOST)
         return;
 
-    if (unlikely(thread_is_real_time_or_idle(t)))
+    if (unlikely(thread_is_real_time_or_idle(t) || thread_is_deadline(t)))
         return;
 
     if (t->priority_boost < MAX_PRIORITY_ADJ &&
@@ -88,7 +108,7 @@ static void deboost_thread(thread_t* t, bool quantum_expiration) {
     if (NO_BOOST)
         return;
 
-    if (unlikely(thread_is_real_time_or_idle(t)))
+    if (unlikely(thread_is_real_time_or_idle(t) || thread_is_deadline(t)))
         return;
 
     int boost_floor;
@@ -171,8 +191,24 @@ static cpu_mask_t find_cpu_mask(thread_t* t) TA_REQ(thread_lock) {
             return last_ran_cpu_mask;
         }
 
-        // pick an idle_cpu
         DEBUG_ASSERT((idle_cpu_mask & mp_get_active_mask()) == idle_cpu_mask);
+
+        // prefer an idle SMT sibling of the last cpu, then an idle cpu sharing
+        // its last level cache, so the thread lands near its cache footprint
+        if (t->last_cpu != INVALID_CPU) {
+            cpu_mask_t sibling_mask = topology_smt_sibling_mask(t->last_cpu) & idle_cpu_mask;
+            if (sibling_mask != 0)
+                return rand_cpu(sibling_mask);
+
+            cpu_mask_t llc_mask = topology_llc_mask(t->last_cpu) & idle_cpu_mask;
+            if (llc_mask != 0)
+                return rand_cpu(llc_mask);
+
+            // every idle cpu is on the far side of the last level cache
+            kcounter_add(sched_cross_llc_migrations, 1u);
+        }
+
+        // pick an idle_cpu
         return rand_cpu(idle_cpu_mask);
     }
 
@@ -192,6 +228,17 @@ static cpu_mask_t find_cpu_mask(thread_t* t) TA_REQ(thread_lock) {
     if (mask == 0)
         return curr_cpu_mask; // local cpu is the only choice
 
+    // of the busy cpus available, prefer one sharing a last level cache with
+    // the cpu the thread last ran on
+    if (t->last_cpu != INVALID_CPU) {
+        cpu_mask_t llc_mask = topology_llc_mask(t->last_cpu) & mask;
+        if (llc_mask != 0) {
+            mask = llc_mask;
+        } else {
+            kcounter_add(sched_cross_llc_migrations, 1u);
+        }
+    }
+
     mask = rand_cpu(mask);
     if (mask == 0)
         return curr_cpu_mask; // local cpu is the only choice
@@ -199,8 +246,32 @@ static cpu_mask_t find_cpu_mask(thread_t* t) TA_REQ(thread_lock) {
     return mask;
 }
 
+// insert a deadline class thread in the cpu's deadline queue, keeping the
+// queue sorted by ascending absolute deadline (earliest deadline first)
+static void insert_in_deadline_queue(cpu_num_t cpu, thread_t* t) TA_REQ(thread_lock) {
+    DEBUG_ASSERT(!list_in_list(&t->queue_node));
+    DEBUG_ASSERT(thread_is_deadline(t));
+
+    struct list_node* queue = &percpu[cpu].deadline_queue;
+    thread_t* entry;
+    list_for_every_entry (queue, entry, thread_t, queue_node) {
+        if (t->absolute_deadline < entry->absolute_deadline) {
+            list_add_before(&entry->queue_node, &t->queue_node);
+            mp_set_cpu_busy(cpu);
+            return;
+        }
+    }
+    list_add_tail(queue, &t->queue_node);
+    mp_set_cpu_busy(cpu);
+}
+
 // run queue manipulation
 static void insert_in_run_queue_head(cpu_num_t cpu, thread_t* t) TA_REQ(thread_lock) {
+    if (unlikely(thread_is_deadline(t))) {
+        insert_in_deadline_queue(cpu, t);
+        return;
+    }
+
     DEBUG_ASSERT(!list_in_list(&t->queue_node));
 
     list_add_head(&percpu[cpu].run_queue[t->effec_priority], &t->queue_node);
@@ -211,6 +282,11 @@ static void insert_in_run_queue_head(cpu_num_t cpu, thread_t* t) TA_REQ(thread_l
 }
 
 static void insert_in_run_queue_tail(cpu_num_t cpu, thread_t* t) TA_REQ(thread_lock) {
+    if (unlikely(thread_is_deadline(t))) {
+        insert_in_deadline_queue(cpu, t);
+        return;
+    }
+
     DEBUG_ASSERT(!list_in_list(&t->queue_node));
 
     list_add_tail(&percpu[cpu].run_queue[t->effec_priority], &t->queue_node);
@@ -225,6 +301,13 @@ static void remove_from_run_queue(thread_t* t, int prio_queue) TA_REQ(thread_loc
     DEBUG_ASSERT(t->state == THREAD_READY);
     DEBUG_ASSERT(is_valid_cpu_num(t->curr_cpu));
 
+    // deadline threads live in the separate per cpu deadline queue, which
+    // keeps no bitmap
+    if (unlikely(thread_is_deadline(t))) {
+        list_delete(&t->queue_node);
+        return;
+    }
+
     list_delete(&t->queue_node);
 
     // clear the old cpu's queue bitmap if that was the last entry
@@ -240,11 +323,72 @@ static uint highest_run_queue(const struct percpu* c) TA_REQ(thread_lock) {
            (sizeof(c->run_queue_bitmap) * CHAR_BIT - NUM_PRIORITIES);
 }
 
+// a cpu with an empty run queue tries to pull a ready thread off another cpu's
+// queue before dropping into its idle thread. only threads whose affinity mask
+// includes |cpu| are eligible. victims are scanned starting just past the
+// thief so that concurrent stealers fan out across the machine.
+static thread_t* sched_steal_thread(cpu_num_t cpu) TA_REQ(thread_lock) {
+    cpu_mask_t busy_mask = mp_get_active_mask() & ~mp_get_idle_mask() & ~cpu_num_to_mask(cpu);
+    if (busy_mask == 0)
+        return NULL;
+
+    kcounter_add(sched_steal_attempt_count, 1);
+
+    for (cpu_num_t i = 1; i < SMP_MAX_CPUS; i++) {
+        cpu_num_t victim = (cpu + i) % SMP_MAX_CPUS;
+        if ((busy_mask & cpu_num_to_mask(victim)) == 0)
+            continue;
+
+        struct percpu* c = &percpu[victim];
+        if (c->run_queue_bitmap == 0)
+            continue;
+
+        // walk the victim's queues from highest to lowest priority, looking for
+        // a thread that's allowed to run here. steal from the tail so the
+        // victim keeps the threads it would run next.
+        uint32_t bitmap = c->run_queue_bitmap;
+        while (bitmap) {
+            uint queue = HIGHEST_PRIORITY - __builtin_clz(bitmap) -
+                         (sizeof(bitmap) * CHAR_BIT - NUM_PRIORITIES);
+            bitmap &= ~(1u << queue);
+
+            for (list_node_t* node = c->run_queue[queue].prev;
+                 node != &c->run_queue[queue]; node = node->prev) {
+                thread_t* t = containerof(node, thread_t, queue_node);
+                if ((t->cpu_affinity & cpu_num_to_mask(cpu)) == 0)
+                    continue;
+
+                list_delete(&t->queue_node);
+                if (list_is_empty(&c->run_queue[queue]))
+                    c->run_queue_bitmap &= ~(1u << queue);
+
+                t->curr_cpu = cpu;
+                kcounter_add(sched_steal_success_count, 1);
+                LOCAL_KTRACE2("sched_steal", victim, t->effec_priority);
+                return t;
+            }
+        }
+    }
+
+    return NULL;
+}
+
 static thread_t* sched_get_top_thread(cpu_num_t cpu) TA_REQ(thread_lock) {
+    struct percpu* c = &percpu[cpu];
+
+    // the deadline class runs ahead of the priority classes; pick the thread
+    // with the earliest absolute deadline first
+    thread_t* dl = list_remove_head_type(&c->deadline_queue, thread_t, queue_node);
+    if (unlikely(dl != NULL)) {
+        DEBUG_ASSERT(dl->curr_cpu == cpu);
+        LOCAL_KTRACE2("sched_get_top dl", (uint32_t)dl->user_tid,
+                      (uint32_t)(dl->absolute_deadline / 1000000));
+        return dl;
+    }
+
     // pop the head of the highest priority queue with any threads
     // queued up on the passed in cpu.
 
-    struct percpu* c = &percpu[cpu];
     if (likely(c->run_queue_bitmap)) {
         uint highest_queue = highest_run_queue(c);
 
@@ -264,6 +408,12 @@ static thread_t* sched_get_top_thread(cpu_num_t cpu) TA_REQ(thread_lock) {
         return newthread;
     }
 
+    // nothing local to run, see if we can steal work from another cpu's queue
+    thread_t* newthread = sched_steal_thread(cpu);
+    if (newthread) {
+        return newthread;
+    }
+
     // no threads to run, select the idle thread for this cpu
     return &c->idle_thread;
 }
@@ -321,6 +471,11 @@ bool sched_unblock(thread_t* t) {
 
     LOCAL_KTRACE0("sched_unblock");
 
+    // a deadline thread waking up starts a fresh period
+    if (unlikely(thread_is_deadline(t))) {
+        deadline_replenish(t, current_time());
+    }
+
     // thread is being woken up, boost its priority
     boost_thread(t);
 
@@ -350,6 +505,11 @@ bool sched_unblock_list(struct list_node* list) {
         DEBUG_ASSERT(t->magic == THREAD_MAGIC);
         DEBUG_ASSERT(!thread_is_idle(t));
 
+        // a deadline thread waking up starts a fresh period
+        if (unlikely(thread_is_deadline(t))) {
+            deadline_replenish(t, current_time());
+        }
+
         // thread is being woken up, boost its priority
         boost_thread(t);
 
@@ -417,6 +577,12 @@ void sched_preempt() {
     // idle thread doesn't go in the run queue
     if (likely(!thread_is_idle(current_thread))) {
         if (current_thread->remaining_time_slice <= 0) {
+            // a deadline thread that burned its whole capacity waits for the
+            // next period; push its deadline out and refill the capacity
+            if (unlikely(thread_is_deadline(current_thread))) {
+                deadline_replenish(current_thread, current_time());
+            }
+
             // if we're out of quantum, deboost the thread and put it at the tail of a queue
             deboost_thread(current_thread, true);
         }
@@ -707,6 +873,75 @@ void sched_change_priority(thread_t* t, int pri) {
     }
 }
 
+// move the thread into the deadline class (or update its parameters if it's
+// already there). The caller is responsible for validating the triple.
+void sched_change_deadline(thread_t* t, zx_duration_t capacity,
+                           zx_duration_t relative_deadline, zx_duration_t period) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+    DEBUG_ASSERT(capacity > 0 && capacity <= relative_deadline && relative_deadline <= period);
+
+    if (unlikely(t->state == THREAD_DEATH))
+        return;
+
+    const bool was_deadline = thread_is_deadline(t);
+
+    t->deadline_capacity = capacity;
+    t->deadline_relative = relative_deadline;
+    t->deadline_period = period;
+    t->flags |= THREAD_FLAG_DEADLINE;
+
+    // any banked boost state is meaningless in the deadline class
+    t->priority_boost = 0;
+    compute_effec_priority(t);
+
+    cpu_mask_t accum_cpu_mask = 0;
+    bool local_resched = false;
+
+    switch (t->state) {
+    case THREAD_RUNNING:
+        // restart the thread's window with the new parameters and make sure
+        // its cpu revisits the decision to run it
+        deadline_replenish(t, current_time());
+        if (t == get_current_thread()) {
+            local_resched = true;
+        } else {
+            accum_cpu_mask = cpu_num_to_mask(t->curr_cpu);
+        }
+        break;
+    case THREAD_READY:
+        // pull it out of whichever queue it's in and requeue it as a
+        // deadline thread on the same cpu
+        DEBUG_ASSERT_MSG(list_in_list(&t->queue_node), "thread %p name %s curr_cpu %u\n",
+                         t, t->name, t->curr_cpu);
+        list_delete(&t->queue_node);
+        if (!was_deadline &&
+            list_is_empty(&percpu[t->curr_cpu].run_queue[t->effec_priority])) {
+            percpu[t->curr_cpu].run_queue_bitmap &= ~(1u << t->effec_priority);
+        }
+
+        deadline_replenish(t, current_time());
+        insert_in_deadline_queue(t->curr_cpu, t);
+
+        if (t->curr_cpu == arch_curr_cpu_num()) {
+            local_resched = true;
+        } else {
+            accum_cpu_mask = cpu_num_to_mask(t->curr_cpu);
+        }
+        break;
+    default:
+        // blocked/sleeping/suspended threads pick up the new parameters when
+        // they next wake via deadline_replenish()
+        break;
+    }
+
+    if (accum_cpu_mask) {
+        mp_reschedule(accum_cpu_mask, 0);
+    }
+    if (local_resched) {
+        sched_reschedule();
+    }
+}
+
 // preemption timer that is set whenever a thread is scheduled
 void sched_preempt_timer_tick(zx_time_t now) {
     // if the preemption timer went off on the idle or a real time thread, ignore it
@@ -755,6 +990,8 @@ void sched_resched_internal() {
     thread_t* current_thread = get_current_thread();
     uint cpu = arch_curr_cpu_num();
 
+    zx_time_t lw_start = latency_watch_begin();
+
     DEBUG_ASSERT(arch_ints_disabled());
     DEBUG_ASSERT(spin_lock_held(&thread_lock));
     DEBUG_ASSERT_MSG(current_thread->state != THREAD_RUNNING, "state %d\n", current_thread->state);
@@ -780,8 +1017,10 @@ void sched_resched_internal() {
     mp_prepare_current_cpu_idle_state(thread_is_idle(newthread));
 
     // if it's the same thread as we're already running, exit
-    if (newthread == oldthread)
+    if (newthread == oldthread) {
+        latency_watch_end(LW_CLASS_SCHED, lw_start);
         return;
+    }
 
     zx_time_t now = current_time();
 
@@ -794,7 +1033,11 @@ void sched_resched_internal() {
 
     // set up quantum for the new thread if it was consumed
     if (newthread->remaining_time_slice == 0) {
-        newthread->remaining_time_slice = THREAD_INITIAL_TIME_SLICE;
+        if (unlikely(thread_is_deadline(newthread))) {
+            deadline_replenish(newthread, now);
+        } else {
+            newthread->remaining_time_slice = THREAD_INITIAL_TIME_SLICE;
+        }
     }
 
     newthread->last_started_running = now;
@@ -867,13 +1110,19 @@ void sched_resched_internal() {
         vmm_context_switch(oldthread->aspace, newthread->aspace);
     }
 
+    // end the watched section here: once we context switch away, the rest of
+    // this function does not run until this thread is switched back in.
+    latency_watch_end(LW_CLASS_SCHED, lw_start);
+
     // do the low level context switch
     final_context_switch(oldthread, newthread);
 }
 
 void sched_init_early() {
     // initialize the run queues
-    for (unsigned int cpu = 0; cpu < SMP_MAX_CPUS; cpu++)
+    for (unsigned int cpu = 0; cpu < SMP_MAX_CPUS; cpu++) {
         for (unsigned int i = 0; i < NUM_PRIORITIES; i++)
             list_initialize(&percpu[cpu].run_queue[i]);
+        list_initialize(&percpu[cpu].deadline_queue);
+    }
 }
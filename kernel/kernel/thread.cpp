@@ -1010,6 +1010,22 @@ void thread_set_priority(thread_t* t, int priority) {
     sched_change_priority(t, priority);
 }
 
+/**
+ * @brief Move a thread into the deadline scheduling class
+ *
+ * The thread is granted |capacity| of run time within every |period|, due
+ * within |relative_deadline| of the period start. The caller must have
+ * validated 0 < capacity <= relative_deadline <= period.
+ */
+void thread_set_deadline(thread_t* t, zx_duration_t capacity,
+                         zx_duration_t relative_deadline, zx_duration_t period) {
+    DEBUG_ASSERT(t->magic == THREAD_MAGIC);
+
+    Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+
+    sched_change_deadline(t, capacity, relative_deadline, period);
+}
+
 /**
  * @brief  Become an idle thread
  *
@@ -31,6 +31,7 @@
 #include <kernel/stats.h>
 #include <kernel/thread.h>
 #include <kernel/timer.h>
+#include <lib/latency_watch.h>
 #include <list.h>
 #include <malloc.h>
 #include <platform.h>
@@ -88,6 +89,19 @@ static void insert_timer_in_queue(uint cpu, timer_t* timer,
     //
     timer_t* entry;
 
+    // Fast path: if the new timer's earliest acceptable deadline lies beyond
+    // the last queued timer, it cannot coalesce with (or sort before) any
+    // entry, so it belongs at the tail with no slack applied. Workloads that
+    // arm large numbers of equal-timeout timers (e.g. network retransmits)
+    // always insert in deadline order, which would otherwise walk the whole
+    // queue below.
+    timer_t* tail = list_peek_tail_type(&percpu[cpu].timer_queue, timer_t, node);
+    if (tail != NULL && earliest_deadline > tail->scheduled_time) {
+        timer->slack = 0ll;
+        list_add_tail(&percpu[cpu].timer_queue, &timer->node);
+        return;
+    }
+
     list_for_every_entry (&percpu[cpu].timer_queue, entry, timer_t, node) {
         if (entry->scheduled_time > latest_deadline) {
             // New timer latest is earlier than the current timer.
@@ -397,7 +411,9 @@ void timer_tick(zx_time_t now) {
                 CPU_STATS_INC(timers);
 
                 LTRACEF("timer %p firing callback %p, arg %p\n", timer, timer->callback, timer->arg);
+                zx_time_t lw_start = latency_watch_begin();
                 timer->callback(timer, now, timer->arg);
+                latency_watch_end(LW_CLASS_TIMER, lw_start);
 
                 DEBUG_ASSERT(arch_ints_disabled());
             }
@@ -0,0 +1,83 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <kernel/topology.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <trace.h>
+
+#define LOCAL_TRACE 0
+
+namespace {
+
+struct cpu_topology_entry {
+    uint32_t package_id;
+    uint32_t node_id;
+    uint32_t core_id;
+    bool valid;
+};
+
+cpu_topology_entry entries[SMP_MAX_CPUS];
+
+// Masks derived from the entries above, rebuilt whenever a cpu is registered.
+// Only written during single threaded smp bringup; read locklessly by the
+// scheduler afterwards.
+cpu_mask_t smt_masks[SMP_MAX_CPUS];
+cpu_mask_t llc_masks[SMP_MAX_CPUS];
+
+void rebuild_masks() {
+    for (cpu_num_t i = 0; i < SMP_MAX_CPUS; i++) {
+        if (!entries[i].valid)
+            continue;
+
+        cpu_mask_t smt = 0;
+        cpu_mask_t llc = 0;
+        for (cpu_num_t j = 0; j < SMP_MAX_CPUS; j++) {
+            if (!entries[j].valid)
+                continue;
+            if (entries[j].package_id != entries[i].package_id ||
+                entries[j].node_id != entries[i].node_id)
+                continue;
+            llc |= cpu_num_to_mask(j);
+            if (entries[j].core_id == entries[i].core_id)
+                smt |= cpu_num_to_mask(j);
+        }
+        smt_masks[i] = smt;
+        llc_masks[i] = llc;
+    }
+}
+
+} // namespace
+
+void topology_set_cpu_info(cpu_num_t cpu, uint32_t package_id, uint32_t node_id,
+                           uint32_t core_id) {
+    DEBUG_ASSERT(is_valid_cpu_num(cpu));
+
+    LTRACEF("cpu %u package %u node %u core %u\n", cpu, package_id, node_id, core_id);
+
+    entries[cpu].package_id = package_id;
+    entries[cpu].node_id = node_id;
+    entries[cpu].core_id = core_id;
+    entries[cpu].valid = true;
+
+    // O(cpus^2), but only run once per cpu at boot.
+    rebuild_masks();
+}
+
+cpu_mask_t topology_smt_sibling_mask(cpu_num_t cpu) {
+    if (!is_valid_cpu_num(cpu) || !entries[cpu].valid)
+        return cpu_num_to_mask(cpu);
+
+    return smt_masks[cpu];
+}
+
+cpu_mask_t topology_llc_mask(cpu_num_t cpu) {
+    if (!is_valid_cpu_num(cpu) || !entries[cpu].valid)
+        return CPU_MASK_ALL;
+
+    return llc_masks[cpu];
+}
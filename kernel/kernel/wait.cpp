@@ -101,6 +101,20 @@ static void wait_queue_insert(wait_queue_t* wait, thread_t* t) {
     } else {
         int pri = t->effec_priority;
 
+        // fast path: if we sort at or below the lowest queued priority, we
+        // belong at the tail. blockers arriving at the same (typically
+        // default) priority land here without walking the head list.
+        thread_t* tail = list_peek_tail_type(&wait->heads, thread_t, wait_queue_heads_node);
+        if (pri < tail->effec_priority) {
+            list_initialize(&t->queue_node);
+            list_add_tail(&wait->heads, &t->wait_queue_heads_node);
+            return;
+        } else if (pri == tail->effec_priority) {
+            list_add_tail(&tail->queue_node, &t->queue_node);
+            list_clear_node(&t->wait_queue_heads_node);
+            return;
+        }
+
         // walk through the sorted list of wait queue heads
         thread_t* temp;
         list_for_every_entry(&wait->heads, temp, thread_t, wait_queue_heads_node) {
@@ -497,6 +511,15 @@ void wait_queue_priority_changed(struct thread* t, int old_prio) {
 
     LTRACEF("%p %d -> %d\n", t, old_prio, t->effec_priority);
 
+    // if we're the only waiter there is no relative order to fix up. this is
+    // the common case for priority inheritance on a mutex with one blocker.
+    if (t->blocking_wait_queue->count == 1) {
+        if (WAIT_QUEUE_VALIDATION) {
+            wait_queue_validate_queue(t->blocking_wait_queue);
+        }
+        return;
+    }
+
     // simple algorithm: remove the thread from the queue and add it back
     // TODO: implement optimal algorithm depending on all the different edge
     // cases of how the thread was previously queued and what priority its
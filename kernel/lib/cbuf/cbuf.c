@@ -11,15 +11,14 @@
 #include <pow2.h>
 #include <string.h>
 #include <assert.h>
+#include <arch/ops.h>
 #include <lib/cbuf.h>
+#include <kernel/atomic.h>
 #include <kernel/event.h>
 #include <kernel/spinlock.h>
 
 #define LOCAL_TRACE 0
 
-#define INC_POINTER(cbuf, ptr, inc) \
-    modpow2(((ptr) + (inc)), (cbuf)->len_pow2)
-
 void cbuf_initialize(cbuf_t *cbuf, size_t len)
 {
     cbuf_initialize_etc(cbuf, len, malloc(len));
@@ -32,6 +31,7 @@ void cbuf_initialize_etc(cbuf_t *cbuf, size_t len, void *buf)
     DEBUG_ASSERT(ispow2(len));
 
     cbuf->head = 0;
+    cbuf->committed = 0;
     cbuf->tail = 0;
     cbuf->len_pow2 = log2_uint_floor(len);
     cbuf->buf = buf;
@@ -43,7 +43,7 @@ void cbuf_initialize_etc(cbuf_t *cbuf, size_t len, void *buf)
 
 size_t cbuf_space_avail(cbuf_t *cbuf)
 {
-    uint consumed = modpow2((uint)(cbuf->head - cbuf->tail), cbuf->len_pow2);
+    uint consumed = atomic_load_u32(&cbuf->head) - atomic_load_u32(&cbuf->tail);
     return valpow2(cbuf->len_pow2) - consumed - 1;
 }
 
@@ -51,21 +51,40 @@ size_t cbuf_write_char(cbuf_t *cbuf, char c)
 {
     DEBUG_ASSERT(cbuf);
 
+    const uint size = valpow2(cbuf->len_pow2);
+
+    // Producers never take the consumer lock: a slot is reserved with a
+    // compare-and-swap on head, filled, then published by advancing
+    // committed in reservation order. Interrupts stay disabled from reserve
+    // to commit so a nested producer on this cpu can't deadlock waiting on
+    // our commit.
     spin_lock_saved_state_t state;
-    spin_lock_irqsave(&cbuf->lock, state);
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
 
     size_t ret = 0;
-    if (cbuf_space_avail(cbuf) > 0) {
-        cbuf->buf[cbuf->head] = c;
+    uint head = atomic_load_u32(&cbuf->head);
+    for (;;) {
+        if (head - atomic_load_u32(&cbuf->tail) >= size - 1) {
+            // full
+            break;
+        }
+        if (atomic_cmpxchg_u32(&cbuf->head, &head, head + 1)) {
+            cbuf->buf[modpow2(head, cbuf->len_pow2)] = c;
 
-        cbuf->head = INC_POINTER(cbuf, cbuf->head, 1);
-        ret = 1;
+            // Commit in reservation order so consumers never see a slot
+            // that another producer is still filling.
+            while (atomic_load_u32(&cbuf->committed) != head)
+                arch_spinloop_pause();
+            atomic_store_u32(&cbuf->committed, head + 1);
 
-        if (cbuf->head != cbuf->tail)
             event_signal(&cbuf->event, true);
+            ret = 1;
+            break;
+        }
+        // The cmpxchg reloaded head; retry with the current value.
     }
 
-    spin_unlock_irqrestore(&cbuf->lock, state);
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
 
     return ret;
 }
@@ -84,14 +103,18 @@ retry:
 
     // see if there's data available
     size_t ret = 0;
-    if (cbuf->tail != cbuf->head) {
+    if (atomic_load_u32(&cbuf->committed) != cbuf->tail) {
 
-        *c = cbuf->buf[cbuf->tail];
-        cbuf->tail = INC_POINTER(cbuf, cbuf->tail, 1);
+        *c = cbuf->buf[modpow2(cbuf->tail, cbuf->len_pow2)];
+        atomic_store_u32(&cbuf->tail, cbuf->tail + 1);
 
-        if (cbuf->tail == cbuf->head) {
+        if (atomic_load_u32(&cbuf->committed) == cbuf->tail) {
             // we've emptied the buffer, unsignal the event
             event_unsignal(&cbuf->event);
+            // Producers commit and signal without holding our lock; don't
+            // wipe a wakeup for a byte that just arrived.
+            if (atomic_load_u32(&cbuf->committed) != cbuf->tail)
+                event_signal(&cbuf->event, false);
         }
 
         ret = 1;
@@ -16,12 +16,17 @@
 __BEGIN_CDECLS
 
 typedef struct cbuf {
-    uint head;
-    uint tail;
+    // Monotonic cursors; buffer offsets are taken mod the buffer size.
+    // Producers reserve a slot with a compare-and-swap on |head|, fill it,
+    // then publish it by advancing |committed| in reservation order, so
+    // writers never take |lock| and never wait on a reader.
+    uint head;      // producer reservation cursor
+    uint committed; // slots below this are fully written
+    uint tail;      // consumer cursor
     uint len_pow2;
     char *buf;
     event_t event;
-    spin_lock_t lock;
+    spin_lock_t lock; // serializes consumers only
 } cbuf_t;
 
 /**
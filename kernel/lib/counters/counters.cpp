@@ -17,13 +17,19 @@
 #include <kernel/percpu.h>
 #include <kernel/spinlock.h>
 
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
 #include <fbl/mutex.h>
+#include <fbl/ref_ptr.h>
 
 #include <lk/init.h>
 
 #include <lib/console.h>
 
+#include <vm/vm_object_paged.h>
+
+#include <zircon/kcounters.h>
+
 // The arena is allocated in kernel.ld linker script.
 extern int64_t kcounters_arena[];
 
@@ -37,6 +43,15 @@ static fbl::Mutex watcher_lock;
 static list_node watcher_list = LIST_INITIAL_VALUE(watcher_list);
 static thread_t* watcher_thread;
 
+// State for the publisher, which periodically sums each counter across all
+// cpus into a VMO that userboot hands to userspace (exposed by devmgr as
+// /boot/kernel/counters; see zircon/kcounters.h for the layout).
+static fbl::RefPtr<VmObject> publisher_vmo;
+static int64_t* publisher_buf;
+static uint64_t publisher_seq;
+static uint64_t publisher_values_offset;
+static uint32_t publisher_period_ms;
+
 static size_t get_num_counters() {
     return kcountdesc_end - kcountdesc_begin;
 }
@@ -217,6 +232,116 @@ static int watch_counter(int argc, const cmd_args* argv) {
     return 0;
 }
 
+fbl::RefPtr<VmObject> counters_get_published_vmo() {
+    return publisher_vmo;
+}
+
+// Sum every counter across all cpus into the publisher VMO, bracketed by
+// sequence number updates so readers can detect a torn snapshot.  The
+// per-cpu reads are not atomically consistent (just like dump_counter), so
+// each published value is an approximation from within the update window.
+static void publish_counters() {
+    const size_t num_counters = get_num_counters();
+
+    publisher_seq++;
+    publisher_vmo->Write(&publisher_seq,
+                         offsetof(kcounters_vmo_header_t, sequence),
+                         sizeof(publisher_seq));
+
+    for (size_t ix = 0; ix != num_counters; ++ix) {
+        int64_t sum = 0;
+        for (size_t cpu = 0; cpu != SMP_MAX_CPUS; ++cpu) {
+            sum += percpu[cpu].counters[ix];
+        }
+        publisher_buf[ix] = sum;
+    }
+    publisher_vmo->Write(publisher_buf, publisher_values_offset,
+                         num_counters * sizeof(int64_t));
+
+    uint64_t now = current_time();
+    publisher_vmo->Write(&now, offsetof(kcounters_vmo_header_t, update_time),
+                         sizeof(now));
+
+    publisher_seq++;
+    publisher_vmo->Write(&publisher_seq,
+                         offsetof(kcounters_vmo_header_t, sequence),
+                         sizeof(publisher_seq));
+}
+
+static int publisher_thread_fn(void* arg) {
+    while (true) {
+        thread_sleep_relative(ZX_MSEC(publisher_period_ms));
+        publish_counters();
+    }
+    return 0;
+}
+
+static void counters_publish_init(unsigned level) {
+    publisher_period_ms = cmdline_get_uint32("kernel.counters.publish-ms", 100);
+
+    const size_t num_counters = get_num_counters();
+    size_t names_size = 0;
+    for (auto it = kcountdesc_begin; it != kcountdesc_end; ++it) {
+        names_size += strlen(it->name) + 1;
+    }
+
+    const uint64_t names_offset = sizeof(kcounters_vmo_header_t);
+    const uint64_t values_offset =
+        fbl::round_up(names_offset + names_size, sizeof(int64_t));
+    const uint64_t vmo_size = values_offset + num_counters * sizeof(int64_t);
+
+    fbl::AllocChecker ac;
+    publisher_buf = new (&ac) int64_t[num_counters];
+    if (!ac.check()) {
+        printf("kcounters: no memory to publish counters\n");
+        return;
+    }
+
+    fbl::RefPtr<VmObject> vmo;
+    zx_status_t status =
+        VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, vmo_size, &vmo);
+    if (status != ZX_OK) {
+        printf("kcounters: failed to create counters vmo: %d\n", status);
+        return;
+    }
+    vmo->set_name(KCOUNTERS_VMO_NAME, sizeof(KCOUNTERS_VMO_NAME) - 1);
+
+    kcounters_vmo_header_t hdr = {};
+    hdr.magic = KCOUNTERS_MAGIC;
+    hdr.num_counters = num_counters;
+    hdr.period_ms = publisher_period_ms;
+    hdr.names_offset = names_offset;
+    hdr.names_size = names_size;
+    hdr.values_offset = values_offset;
+    vmo->Write(&hdr, 0u, sizeof(hdr));
+
+    // The names are written once; they are sorted, in the same order as the
+    // values array.
+    uint64_t offset = names_offset;
+    for (auto it = kcountdesc_begin; it != kcountdesc_end; ++it) {
+        size_t len = strlen(it->name) + 1;
+        vmo->Write(it->name, offset, len);
+        offset += len;
+    }
+
+    publisher_values_offset = values_offset;
+    publisher_vmo = fbl::move(vmo);
+
+    // Publish an initial snapshot so the VMO is coherent even when periodic
+    // updates are disabled.
+    publish_counters();
+
+    if (publisher_period_ms > 0) {
+        thread_t* t = thread_create("counter-publisher", publisher_thread_fn,
+                                    nullptr, LOW_PRIORITY);
+        if (t == nullptr) {
+            printf("kcounters: no memory for publisher thread\n");
+            return;
+        }
+        thread_detach_and_resume(t);
+    }
+}
+
 static int cmd_counters(int argc, const cmd_args* argv, uint32_t flags) {
     if (argc > 1) {
         if (strcmp(argv[1].str, "view") == 0) {
@@ -236,6 +361,7 @@ static int cmd_counters(int argc, const cmd_args* argv, uint32_t flags) {
 }
 
 LK_INIT_HOOK(kcounters, counters_init, LK_INIT_LEVEL_PLATFORM_EARLY);
+LK_INIT_HOOK(kcounters_publish, counters_publish_init, LK_INIT_LEVEL_THREADING);
 
 STATIC_COMMAND_START
 STATIC_COMMAND("counters", "view system counters", &cmd_counters)
@@ -0,0 +1,331 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <lib/crashlog_ring.h>
+
+#include <arch/ops.h>
+#include <lz4/lz4.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//TODO: ECC for more robust storage
+
+// Region layout: a ring_hdr_t followed by a byte ring of entries. An entry
+// is an entry_hdr_t immediately followed by comp_len bytes of lz4 block
+// data; entries never wrap. A pad entry (or a gap at the end of the area
+// too small for a header) marks the jump back to offset 0. Headers are
+// memcpy'd in and out since entries start at arbitrary byte offsets.
+
+#define RING_MAGIC (0x676e526873617243ULL)
+
+typedef struct {
+    uint64_t magic;
+    uint64_t nmagic;
+    uint64_t seq;   // sequence number of the next entry to be stowed
+    uint32_t head;  // write offset into the data area
+    uint32_t tail;  // offset of the oldest entry
+    uint32_t count; // number of live entries (pads excluded)
+} ring_hdr_t;
+
+#define ENTRY_MAGIC (0x31544e45u)
+#define PAD_MAGIC (0x31444150u)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;      // low bits of the ring sequence number
+    uint32_t orig_len; // uncompressed length
+    uint32_t comp_len; // compressed bytes following this header
+} entry_hdr_t;
+
+// Header used by the old single-entry format; still recognized on recovery
+// so a log stowed by a previous kernel survives an update.
+typedef struct {
+    uint64_t magic;
+    uint64_t length;
+    uint64_t nmagic;
+    uint64_t nlength;
+} legacy_hdr_t;
+
+#define LEGACY_MAGIC (0x6f8962d66b28504fULL)
+
+// LZ4_stream_t is far too large for the panic-path stack, so compression
+// uses this static state instead. Stowing only happens on the panic path,
+// so there is no concurrent use.
+static LZ4_stream_t lz4_state;
+
+static uint8_t* ring_data(void* buf) {
+    return static_cast<uint8_t*>(buf) + sizeof(ring_hdr_t);
+}
+
+static bool ring_valid(const ring_hdr_t* hdr, size_t data_len) {
+    return hdr->magic == RING_MAGIC && hdr->nmagic == ~RING_MAGIC &&
+           hdr->head <= data_len && hdr->tail <= data_len &&
+           hdr->count <= data_len / sizeof(entry_hdr_t);
+}
+
+// Largest source size whose lz4 worst case fits in `cap' bytes.
+static size_t max_src_for(size_t cap) {
+    if (cap <= 16) {
+        return 0;
+    }
+    size_t n = cap - 16;
+    n -= n / 256;
+    while (n > 0 && (size_t)LZ4_compressBound((int)n) > cap) {
+        n--;
+    }
+    return n;
+}
+
+// Normalizes an offset that may have landed on a pad entry or in the gap
+// at the end of the data area. Only meaningful while the ring holds at
+// least one live entry.
+static uint32_t norm_off(const uint8_t* data, size_t data_len, uint32_t off) {
+    if (data_len - off < sizeof(entry_hdr_t)) {
+        return 0;
+    }
+    entry_hdr_t eh;
+    memcpy(&eh, data + off, sizeof(eh));
+    if (eh.magic == PAD_MAGIC) {
+        return 0;
+    }
+    return off;
+}
+
+// Reads the live entry at (or after) *off, skipping pads and the end gap
+// and updating *off to the entry's true offset. Returns false if the walk
+// runs into anything that is not a valid entry.
+static bool read_entry(const uint8_t* data, size_t data_len, uint32_t* off, entry_hdr_t* eh) {
+    bool wrapped = false;
+    for (;;) {
+        if (data_len - *off < sizeof(entry_hdr_t)) {
+            if (wrapped) {
+                return false;
+            }
+            wrapped = true;
+            *off = 0;
+            continue;
+        }
+        memcpy(eh, data + *off, sizeof(*eh));
+        if (eh->magic == PAD_MAGIC) {
+            if (wrapped) {
+                return false;
+            }
+            wrapped = true;
+            *off = 0;
+            continue;
+        }
+        return (eh->magic == ENTRY_MAGIC) &&
+               (eh->comp_len <= data_len - *off - sizeof(entry_hdr_t));
+    }
+}
+
+size_t crashlog_ring_stow(void* buf, size_t buf_len, const void* log, size_t len) {
+    if (buf == NULL || buf_len < CRASHLOG_RING_MIN_LEN) {
+        return 0;
+    }
+    const size_t data_len = buf_len - sizeof(ring_hdr_t);
+    uint8_t* data = ring_data(buf);
+    const size_t cap = max_src_for(data_len - sizeof(entry_hdr_t));
+
+    if (log == NULL) {
+        return cap;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    if (len > cap) {
+        // worst case the compressed log would not fit even in an empty
+        // ring; drop the tail of the text rather than the whole log
+        len = cap;
+    }
+
+    ring_hdr_t hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+    if (!ring_valid(&hdr, data_len)) {
+        // first stow into this region (or a corrupt ring): start fresh. A
+        // region still holding an old single-entry log also lands here;
+        // that log is dropped in favor of the new one, since migrating it
+        // in place would need a bounce buffer we don't have on the panic
+        // path.
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.magic = RING_MAGIC;
+        hdr.nmagic = ~RING_MAGIC;
+    }
+
+    const uint32_t need = (uint32_t)(sizeof(entry_hdr_t) + (size_t)LZ4_compressBound((int)len));
+
+    // make room: evict oldest entries until a contiguous run of `need'
+    // bytes is free at the head, wrapping to the start of the area (via a
+    // pad entry) when the run to the end of the area is too short
+    for (;;) {
+        if (hdr.count == 0) {
+            // `cap' guarantees `need' fits the empty data area
+            hdr.head = 0;
+            hdr.tail = 0;
+            break;
+        }
+        size_t space;
+        if (hdr.head > hdr.tail) {
+            space = data_len - hdr.head;
+        } else if (hdr.head < hdr.tail) {
+            space = hdr.tail - hdr.head;
+        } else {
+            space = 0; // exactly full
+        }
+        if (space >= need) {
+            break;
+        }
+        if (hdr.head > hdr.tail && hdr.tail >= need) {
+            // enough room at the start of the area: pad out the end and wrap
+            if (data_len - hdr.head >= sizeof(entry_hdr_t)) {
+                entry_hdr_t pad = {};
+                pad.magic = PAD_MAGIC;
+                pad.comp_len = (uint32_t)(data_len - hdr.head - sizeof(entry_hdr_t));
+                memcpy(data + hdr.head, &pad, sizeof(pad));
+            }
+            hdr.head = 0;
+            continue;
+        }
+        // evict the oldest entry
+        entry_hdr_t eh;
+        uint32_t off = hdr.tail;
+        if (!read_entry(data, data_len, &off, &eh)) {
+            // the ring is corrupt; reset it
+            hdr.head = 0;
+            hdr.tail = 0;
+            hdr.count = 0;
+            break;
+        }
+        hdr.tail = off + (uint32_t)(sizeof(entry_hdr_t) + eh.comp_len);
+        hdr.count--;
+        if (hdr.count > 0) {
+            hdr.tail = norm_off(data, data_len, hdr.tail);
+        }
+    }
+
+    int comp = LZ4_compress_fast_extState(&lz4_state, (const char*)log,
+                                          (char*)(data + hdr.head) + sizeof(entry_hdr_t),
+                                          (int)len, (int)(need - sizeof(entry_hdr_t)), 1);
+    if (comp <= 0) {
+        return 0;
+    }
+
+    entry_hdr_t eh = {};
+    eh.magic = ENTRY_MAGIC;
+    eh.seq = (uint32_t)hdr.seq;
+    eh.orig_len = (uint32_t)len;
+    eh.comp_len = (uint32_t)comp;
+    memcpy(data + hdr.head, &eh, sizeof(eh));
+
+    hdr.head += (uint32_t)(sizeof(entry_hdr_t) + (size_t)comp);
+    if (hdr.head == data_len) {
+        hdr.head = 0;
+    }
+    hdr.seq++;
+    hdr.count++;
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    arch_clean_cache_range((uintptr_t)buf, buf_len);
+    return len;
+}
+
+// Recovers a region still in the old single-entry format, preserving the
+// old contract: the log is delivered once and the header is invalidated.
+// The next stow rewrites the region in ring format.
+static size_t legacy_recover(void* buf, size_t buf_len, size_t len, void* cookie,
+                             void (*func)(const void* data, size_t off, size_t len, void* cookie)) {
+    legacy_hdr_t hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+    const size_t max = buf_len - sizeof(legacy_hdr_t);
+    if ((hdr.magic != LEGACY_MAGIC) || (hdr.length > max) ||
+        (hdr.nmagic != ~LEGACY_MAGIC) || (hdr.nlength != ~hdr.length)) {
+        if (hdr.magic != 0) {
+            printf("crashlog-ring: bad header: %016lx %016lx %016lx %016lx\n",
+                   hdr.magic, hdr.length, hdr.nmagic, hdr.nlength);
+        }
+        return 0;
+    }
+    if (len == 0) {
+        return hdr.length;
+    }
+    if (len > hdr.length) {
+        len = hdr.length;
+    }
+    func(static_cast<char*>(buf) + sizeof(hdr), 0, len, cookie);
+
+    // invalidate header so we don't get a stale crashlog on future boots
+    hdr.magic = 0;
+    memcpy(buf, &hdr, sizeof(hdr));
+    return hdr.length;
+}
+
+size_t crashlog_ring_recover(void* buf, size_t buf_len, size_t len, void* cookie,
+                             void (*func)(const void* data, size_t off, size_t len, void* cookie)) {
+    if (buf == NULL || buf_len < CRASHLOG_RING_MIN_LEN) {
+        return 0;
+    }
+    const size_t data_len = buf_len - sizeof(ring_hdr_t);
+    const uint8_t* data = ring_data(buf);
+
+    ring_hdr_t hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+    if (!ring_valid(&hdr, data_len)) {
+        return legacy_recover(buf, buf_len, len, cookie, func);
+    }
+
+    // The sizing pass (len == 0) and the delivery pass validate entries
+    // the same way (including a trial decompression), so the total they
+    // compute always agrees.
+    size_t total = 0;
+    uint32_t off = hdr.tail;
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        entry_hdr_t eh;
+        if (!read_entry(data, data_len, &off, &eh)) {
+            break;
+        }
+        const char* comp = (const char*)(data + off) + sizeof(entry_hdr_t);
+        off += (uint32_t)(sizeof(entry_hdr_t) + eh.comp_len);
+
+        char banner[64];
+        int blen = snprintf(banner, sizeof(banner), "--- crashlog %u (%u bytes) ---\n",
+                            eh.seq, eh.orig_len);
+        if (blen < 0) {
+            continue;
+        }
+
+        char* dec = static_cast<char*>(malloc(eh.orig_len));
+        if (dec == NULL) {
+            break;
+        }
+        if (LZ4_decompress_safe(comp, dec, (int)eh.comp_len, (int)eh.orig_len) !=
+            (int)eh.orig_len) {
+            // the entry did not survive; skip it in both passes
+            free(dec);
+            continue;
+        }
+        if (len != 0 && func != NULL) {
+            if (total < len) {
+                size_t n = (size_t)blen;
+                if (n > len - total) {
+                    n = len - total;
+                }
+                func(banner, total, n, cookie);
+            }
+            if (total + (size_t)blen < len) {
+                size_t n = eh.orig_len;
+                if (n > len - total - (size_t)blen) {
+                    n = len - total - (size_t)blen;
+                }
+                func(dec, total + (size_t)blen, n, cookie);
+            }
+        }
+        free(dec);
+        total += (size_t)blen + eh.orig_len;
+    }
+    return total;
+}
@@ -0,0 +1,40 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <stddef.h>
+
+// A persistent multi-entry crashlog ring kept in the reserved crashlog
+// memory region. Each stowed log is lz4-compressed and appended as a ring
+// entry, and the oldest entries are evicted only when space runs out, so a
+// crash loop retains several boots worth of panics instead of just the
+// last one. Recovery is non-destructive: entries are delivered oldest
+// first, each prefixed with a banner carrying its sequence number, which
+// consumers can use to drop entries they have already reported.
+//
+// Regions written by the previous single-entry format are still recognized
+// by crashlog_ring_recover, so a log stowed before a kernel update is not
+// lost.
+
+// Regions smaller than this cannot hold a useful entry and are rejected.
+#define CRASHLOG_RING_MIN_LEN (128u)
+
+// Append `log' (`len' bytes) to the ring in the `buf_len'-byte region at
+// `buf'. Entries are evicted oldest-first to make room; a log whose worst
+// case compressed size exceeds the whole region has its tail dropped.
+// Returns the number of bytes of `log' stored, or, when `log' is NULL, the
+// largest log a single entry is guaranteed to hold. Only safe to call from
+// the panic path.
+size_t crashlog_ring_stow(void* buf, size_t buf_len, const void* log, size_t len);
+
+// Recover the ring at `buf'. If `len' is 0, returns the total number of
+// bytes a full recovery would produce. Otherwise calls `func' (with
+// increasing `off') to deliver each entry, oldest first and prefixed with
+// its banner, and returns the total length. The ring itself is left
+// intact. Not safe before the heap is up.
+size_t crashlog_ring_recover(void* buf, size_t buf_len, size_t len, void* cookie,
+                             void (*func)(const void* data, size_t off, size_t len, void* cookie));
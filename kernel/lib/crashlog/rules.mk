@@ -4,6 +4,10 @@ LOCAL_DIR := $(GET_LOCAL_DIR)
 MODULE := $(LOCAL_DIR)
 
 MODULE_SRCS += \
-	$(LOCAL_DIR)/crashlog.cpp
+	$(LOCAL_DIR)/crashlog.cpp \
+	$(LOCAL_DIR)/crashlog_ring.cpp
+
+MODULE_DEPS += \
+	third_party/lib/lz4
 
 include make/module.mk
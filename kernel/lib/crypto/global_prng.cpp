@@ -6,11 +6,14 @@
 
 #include <lib/crypto/global_prng.h>
 
+#include <arch/ops.h>
 #include <assert.h>
 #include <ctype.h>
 #include <err.h>
 #include <explicit-memory/bytes.h>
 #include <fbl/algorithm.h>
+#include <fbl/alloc_checker.h>
+#include <kernel/align.h>
 #include <kernel/auto_lock.h>
 #include <kernel/cmdline.h>
 #include <kernel/mutex.h>
@@ -33,11 +36,46 @@ namespace GlobalPRNG {
 
 static PRNG* kGlobalPrng = nullptr;
 
+// Each cpu gets its own generator, seeded from the root PRNG once threading
+// is up and reseeded from it every kDrawsPerReseed draws.  Draws on
+// different cpus then never contend on a shared lock, while entropy added
+// to the root pool still reaches every generator within one reseed period.
+static constexpr uint32_t kDrawsPerReseed = 4096;
+
+struct PerCpuPrng {
+    PRNG* prng;
+    uint32_t draws_left;
+} __CPU_ALIGN;
+
+static PerCpuPrng percpu_prng[SMP_MAX_CPUS];
+
 PRNG* GetInstance() {
     ASSERT(kGlobalPrng);
     return kGlobalPrng;
 }
 
+void Draw(void* out, size_t size) {
+    PerCpuPrng* local = &percpu_prng[arch_curr_cpu_num()];
+    PRNG* prng = local->prng;
+    if (unlikely(prng == nullptr)) {
+        // Early boot; the per-cpu generators haven't been seeded yet.
+        GetInstance()->Draw(out, size);
+        return;
+    }
+    if (unlikely(local->draws_left == 0)) {
+        uint8_t seed[PRNG::kMinEntropy];
+        GetInstance()->Draw(seed, sizeof(seed));
+        prng->AddEntropy(seed, sizeof(seed));
+        mandatory_memset(seed, 0, sizeof(seed));
+        local->draws_left = kDrawsPerReseed;
+    }
+    // The counter update is not atomic; a tick lost to preemption or
+    // migration just stretches the reseed period by a draw, which is
+    // harmless.
+    local->draws_left--;
+    prng->Draw(out, size);
+}
+
 // Returns true if the kernel cmdline provided at least PRNG::kMinEntropy bytes
 // of entropy, and false otherwise.
 //
@@ -162,9 +200,26 @@ static void EarlyBootSeed(uint level) {
     }
 }
 
-// Migrate the global PRNG to enter thread-safe mode.
+// Migrate the global PRNG to enter thread-safe mode and seed the per-cpu
+// generators from it.
 static void BecomeThreadSafe(uint level) {
     GetInstance()->BecomeThreadSafe();
+
+    // EarlyBootSeed has run by now, so the root PRNG draws without blocking
+    // (possibly from the insecure fallback seed, in which case the per-cpu
+    // generators are no worse than the root was).
+    for (uint i = 0; i < SMP_MAX_CPUS; i++) {
+        uint8_t seed[PRNG::kMinEntropy];
+        kGlobalPrng->Draw(seed, sizeof(seed));
+
+        fbl::AllocChecker ac;
+        PRNG* prng = new (&ac) PRNG(seed, sizeof(seed));
+        ASSERT(ac.check());
+        mandatory_memset(seed, 0, sizeof(seed));
+
+        percpu_prng[i].draws_left = kDrawsPerReseed;
+        percpu_prng[i].prng = prng;
+    }
 }
 
 } //namespace GlobalPRNG
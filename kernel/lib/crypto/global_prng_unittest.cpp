@@ -8,6 +8,7 @@
 
 #include <lib/unittest/unittest.h>
 #include <stdint.h>
+#include <string.h>
 
 namespace crypto {
 
@@ -24,10 +25,26 @@ bool identical() {
     END_TEST;
 }
 
+bool draw() {
+    BEGIN_TEST;
+
+    uint8_t buf1[16] = {0};
+    uint8_t buf2[16] = {0};
+    GlobalPRNG::Draw(buf1, sizeof(buf1));
+    GlobalPRNG::Draw(buf2, sizeof(buf2));
+
+    // Two successive draws returning the same 128 bits would indicate the
+    // per-cpu generator is not advancing.
+    EXPECT_NE(memcmp(buf1, buf2, sizeof(buf1)), 0, "");
+
+    END_TEST;
+}
+
 } // namespace
 
 UNITTEST_START_TESTCASE(global_prng_tests)
 UNITTEST("Identical", identical)
+UNITTEST("Draw", draw)
 UNITTEST_END_TESTCASE(global_prng_tests, "global_prng",
                       "Validate global PRNG singleton");
 
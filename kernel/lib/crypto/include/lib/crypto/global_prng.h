@@ -12,10 +12,18 @@ namespace crypto {
 
 namespace GlobalPRNG {
 
-// Returns a pointer to the global PRNG singleton.  The pointer is
-// guaranteed to be non-null.
+// Returns a pointer to the root PRNG singleton.  The pointer is
+// guaranteed to be non-null.  Entropy added via AddEntropy() lands here
+// and reaches the per-cpu generators on their next reseed.
 PRNG* GetInstance();
 
+// Draws |size| bytes from the current cpu's generator, falling back to
+// the root PRNG in early boot before the per-cpu generators are seeded.
+// Prefer this over GetInstance()->Draw(): the per-cpu generators are
+// periodically reseeded from the root pool and concurrent draws on
+// different cpus do not contend on a shared lock.
+void Draw(void* out, size_t size);
+
 } //namespace GlobalPRNG
 
 } // namespace crypto
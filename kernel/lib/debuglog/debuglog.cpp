@@ -6,9 +6,11 @@
 
 #include <lib/debuglog.h>
 
+#include <arch/ops.h>
 #include <dev/udisplay.h>
 #include <err.h>
 #include <fbl/atomic.h>
+#include <kernel/atomic.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
 #include <lib/crashlog.h>
@@ -35,6 +37,7 @@ static dlog_t DLOG = {
     .lock = SPIN_LOCK_INITIAL_VALUE,
     .head = 0,
     .tail = 0,
+    .committed = 0,
     .data = DLOG_DATA,
     .panic = false,
     .event = EVENT_INITIAL_VALUE(DLOG.event, 0, EVENT_FLAG_AUTOUNSIGNAL),
@@ -136,6 +139,9 @@ zx_status_t dlog_write(uint32_t flags, const void* data_ptr, size_t len) {
         hdr.tid = 0;
     }
 
+    // Reserve-then-commit: the lock only covers reserving space (pointer
+    // math plus one header word store), so concurrent writers copy their
+    // record bodies in parallel instead of serializing on the memcpy.
     spin_lock_saved_state_t state;
     spin_lock_irqsave(&log->lock, state);
 
@@ -146,8 +152,20 @@ zx_status_t dlog_write(uint32_t flags, const void* data_ptr, size_t len) {
         log->tail += DLOG_HDR_GET_FIFOLEN(header);
     }
 
-    size_t offset = (log->head & DLOG_MASK);
+    const size_t start = log->head;
+    size_t offset = (start & DLOG_MASK);
 
+    // Write the header word (which never wraps) while holding the lock, so
+    // later writers' discard loops can parse past this record before its
+    // body has been copied.
+    *reinterpret_cast<uint32_t*>(log->data + offset) = hdr.header;
+    log->head += wiresize;
+
+    spin_unlock(&log->lock);
+
+    // Copy the body with the lock released but interrupts still disabled;
+    // an interrupt handler logging on this cpu between reserve and commit
+    // would spin forever waiting for our commit below.
     size_t fifospace = DLOG_SIZE - offset;
 
     if (fifospace >= wiresize) {
@@ -167,12 +185,18 @@ zx_status_t dlog_write(uint32_t flags, const void* data_ptr, size_t len) {
         memcpy(log->data + offset, ptr, fifospace);
         memcpy(log->data, ptr + fifospace, len - fifospace);
     }
-    log->head += wiresize;
 
-    // Need to check this before re-releasing the log lock, since we may
-    // re-enable interrupts while doing that.  If interrupts are enabled when we
-    // make this check, we could see the following sequence of events between
-    // two CPUs and incorrectly conclude we are holding the thread lock:
+    // Publish in reservation order; the wait is bounded by the copy above
+    // on whichever cpus reserved before us.
+    while (atomic_load_u64(&log->committed) != start) {
+        arch_spinloop_pause();
+    }
+    atomic_store_u64(&log->committed, start + wiresize);
+
+    // Need to check this before re-enabling interrupts.  If interrupts are
+    // enabled when we make this check, we could see the following sequence
+    // of events between two CPUs and incorrectly conclude we are holding
+    // the thread lock:
     // C2: Acquire thread_lock
     // C1: Running this thread, evaluate spin_lock_holder_cpu(&thread_lock) -> C2
     // C1: Context switch away
@@ -181,7 +205,7 @@ zx_status_t dlog_write(uint32_t flags, const void* data_ptr, size_t len) {
     // C2: Running this thread, evaluate arch_curr_cpu_num() -> C2
     bool holding_thread_lock = spin_lock_holder_cpu(&thread_lock) == arch_curr_cpu_num();
 
-    spin_unlock_irqrestore(&log->lock, state);
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
 
     [log, holding_thread_lock]() TA_NO_THREAD_SAFETY_ANALYSIS {
         // if we happen to be called from within the global thread lock, use a
@@ -223,7 +247,10 @@ zx_status_t dlog_read(dlog_reader_t* rdr, uint32_t flags, void* data_ptr,
         rtail = log->tail;
     }
 
-    if (rtail != log->head) {
+    // Only records below the commit horizon are fully written; anything in
+    // committed..head is a reservation whose body may still be in flight.
+    // (If a writer lapped the buffer and pushed tail past committed, wait.)
+    if (atomic_load_u64(&log->committed) > rtail) {
         size_t offset = (rtail & DLOG_MASK);
         uint32_t header = *reinterpret_cast<uint32_t*>(log->data + offset);
 
@@ -265,7 +292,7 @@ void dlog_reader_init(dlog_reader_t* rdr, void (*notify)(void*), void* cookie) {
     spin_lock_saved_state_t state;
     spin_lock_irqsave(&log->lock, state);
     rdr->tail = log->tail;
-    do_notify = (log->tail != log->head);
+    do_notify = (atomic_load_u64(&log->committed) > log->tail);
     spin_unlock_irqrestore(&log->lock, state);
 
     // simulate notify callback for events that arrived
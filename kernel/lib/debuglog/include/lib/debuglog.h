@@ -26,6 +26,11 @@ struct dlog {
     size_t head;
     size_t tail;
 
+    // Records below this position are fully written; committed..head is the
+    // set of reservations whose bodies are still being copied. Written by
+    // producers (in reservation order) without the lock held.
+    uint64_t committed;
+
     uint8_t* data;
 
     bool panic;
@@ -8,12 +8,22 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifndef DEBUG_FIXED_POINT
 #define DEBUG_FIXED_POINT 0
 #endif
 
+/* On targets with a 64x64->128 multiply, conversions take a two-multiply
+ * fast path instead of the schoolbook evaluation over 32-bit limbs. The
+ * debug build keeps the limb-wise path so its tracing hooks still fire. */
+#if defined(__SIZEOF_INT128__) && !DEBUG_FIXED_POINT
+#define FIXED_POINT_USE_INT128 1
+#else
+#define FIXED_POINT_USE_INT128 0
+#endif
+
 struct fp_32_64 {
     uint32_t l0;    /* unshifted value */
     uint32_t l32;   /* value shifted left 32 bits (or bit -1 to -32) */
@@ -47,6 +57,13 @@ mul_u32_u32(uint32_t a, uint32_t b, int a_shift, int b_shift)
 static uint64_t
 u64_mul_u32_fp32_64(uint32_t a, struct fp_32_64 b)
 {
+#if FIXED_POINT_USE_INT128
+    uint64_t frac = ((uint64_t)b.l32 << 32) | b.l64;
+    unsigned __int128 res = (unsigned __int128)a * frac;
+    uint64_t ret = (uint64_t)a * b.l0 + (uint64_t)(res >> 64);
+    ret += ((uint64_t)res >> 63); /* Round to nearest integer */
+    return ret;
+#else
     uint64_t tmp;
     uint64_t res_0;
     uint64_t res_l32;
@@ -65,11 +82,19 @@ u64_mul_u32_fp32_64(uint32_t a, struct fp_32_64 b)
     debug_u64_mul_u32_fp32_64(a, b, res_0, res_l32_32, ret);
 
     return ret;
+#endif
 }
 
 static uint32_t
 u32_mul_u64_fp32_64(uint64_t a, struct fp_32_64 b)
 {
+#if FIXED_POINT_USE_INT128
+    uint64_t frac = ((uint64_t)b.l32 << 32) | b.l64;
+    unsigned __int128 res = (unsigned __int128)a * frac;
+    uint64_t ret = a * (uint64_t)b.l0 + (uint64_t)(res >> 64);
+    ret += ((uint64_t)res >> 63); /* Round to nearest integer */
+    return (uint32_t)ret;
+#else
     uint32_t a_r32 = (uint32_t)(a >> 32);
     uint32_t a_0 = (uint32_t)a;
     uint64_t res_l32;
@@ -86,11 +111,22 @@ u32_mul_u64_fp32_64(uint64_t a, struct fp_32_64 b)
     debug_u32_mul_u64_fp32_64(a, b, res_l32, ret);
 
     return ret;
+#endif
 }
 
 static uint64_t
 u64_mul_u64_fp32_64(uint64_t a, struct fp_32_64 b)
 {
+#if FIXED_POINT_USE_INT128
+    /* Exact evaluation of a * (b.l0 + b.l32 * 2^-32 + b.l64 * 2^-64).
+     * This may differ from the limb-wise path by one ulp in rare cases,
+     * since that path truncates a low-order partial product. */
+    uint64_t frac = ((uint64_t)b.l32 << 32) | b.l64;
+    unsigned __int128 res = (unsigned __int128)a * frac;
+    uint64_t ret = a * (uint64_t)b.l0 + (uint64_t)(res >> 64);
+    ret += ((uint64_t)res >> 63); /* Round to nearest integer */
+    return ret;
+#else
     uint32_t a_r32 = (uint32_t)(a >> 32);
     uint32_t a_0 = (uint32_t)a;
     uint64_t res_0;
@@ -120,5 +156,18 @@ u64_mul_u64_fp32_64(uint64_t a, struct fp_32_64 b)
     debug_u64_mul_u64_fp32_64(a, b, res_0, res_l32_32, ret);
 
     return ret;
+#endif
+}
+
+/* Converts a run of values in place against a single context. Hoisting the
+ * context out of the loop lets the compiler keep its limbs in registers
+ * across iterations, so converting captured tick buffers (trace or sample
+ * arrays) is cheaper than calling the scalar routine per element. */
+static void
+u64_mul_u64_fp32_64_batch(uint64_t *values, size_t count, struct fp_32_64 b)
+{
+    for (size_t i = 0; i < count; i++) {
+        values[i] = u64_mul_u64_fp32_64(values[i], b);
+    }
 }
 
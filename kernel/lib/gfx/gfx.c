@@ -187,160 +187,106 @@ static void putpixel8(gfx_surface *surface, uint x, uint y, uint color)
     *dest = (uint8_t)(surface->translate_color(color));
 }
 
-static void copyrect8(gfx_surface *surface, uint x, uint y, uint width, uint height, uint x2, uint y2)
+// Scanline span helpers. The rect ops work a whole row at a time so the
+// copies and fills run through memmove/memset and wide word stores instead
+// of per-pixel loops; console scrolling is then bound by memory bandwidth.
+
+static void fill_span16(uint16_t *dest, uint16_t color, uint width)
 {
-    // copy
-    const uint8_t *src = &((const uint8_t *)surface->ptr)[x + y * surface->stride];
-    uint8_t *dest = &((uint8_t *)surface->ptr)[x2 + y2 * surface->stride];
-    uint stride_diff = surface->stride - width;
+    uint i;
+    for (i = 0; i < width; i++)
+        dest[i] = color;
+}
+
+static void fill_span32(uint32_t *dest, uint32_t color, uint width)
+{
+    uint i;
+    for (i = 0; i < width; i++)
+        dest[i] = color;
+}
+
+// Copies height rows of width pixels within one surface, handling the
+// overlapping ranges a scroll produces. size is the pixel size in bytes,
+// stride the surface stride in pixels.
+static void copyrect_rows(void *ptr, size_t size, uint stride,
+                          uint srcpix, uint destpix, uint width, uint height)
+{
+    const uint8_t *src = (const uint8_t *)ptr + srcpix * size;
+    uint8_t *dest = (uint8_t *)ptr + destpix * size;
+    size_t row_bytes = (size_t)width * size;
+    size_t stride_bytes = (size_t)stride * size;
+    uint i;
 
     if (dest < src) {
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest++;
-                src++;
-            }
-            dest += stride_diff;
-            src += stride_diff;
+        for (i = 0; i < height; i++) {
+            memmove(dest, src, row_bytes);
+            dest += stride_bytes;
+            src += stride_bytes;
         }
     } else {
         // copy backwards
-        src += height * surface->stride + width;
-        dest += height * surface->stride + width;
-
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest--;
-                src--;
-            }
-            dest -= stride_diff;
-            src -= stride_diff;
+        src += (height - 1) * stride_bytes;
+        dest += (height - 1) * stride_bytes;
+        for (i = 0; i < height; i++) {
+            memmove(dest, src, row_bytes);
+            dest -= stride_bytes;
+            src -= stride_bytes;
         }
     }
 }
 
+static void copyrect8(gfx_surface *surface, uint x, uint y, uint width, uint height, uint x2, uint y2)
+{
+    copyrect_rows(surface->ptr, sizeof(uint8_t), surface->stride,
+                  x + y * surface->stride, x2 + y2 * surface->stride, width, height);
+}
+
 static void fillrect8(gfx_surface *surface, uint x, uint y, uint width, uint height, uint color)
 {
     uint8_t *dest = &((uint8_t *)surface->ptr)[x + y * surface->stride];
-    uint stride_diff = surface->stride - width;
 
     uint8_t color8 = (uint8_t)(surface->translate_color(color));
 
-    uint i, j;
+    uint i;
     for (i=0; i < height; i++) {
-        for (j=0; j < width; j++) {
-            *dest = color8;
-            dest++;
-        }
-        dest += stride_diff;
+        memset(dest, color8, width);
+        dest += surface->stride;
     }
 }
 
 static void copyrect16(gfx_surface *surface, uint x, uint y, uint width, uint height, uint x2, uint y2)
 {
-    // copy
-    const uint16_t *src = &((const uint16_t *)surface->ptr)[x + y * surface->stride];
-    uint16_t *dest = &((uint16_t *)surface->ptr)[x2 + y2 * surface->stride];
-    uint stride_diff = surface->stride - width;
-
-    if (dest < src) {
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest++;
-                src++;
-            }
-            dest += stride_diff;
-            src += stride_diff;
-        }
-    } else {
-        // copy backwards
-        src += height * surface->stride + width;
-        dest += height * surface->stride + width;
-
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest--;
-                src--;
-            }
-            dest -= stride_diff;
-            src -= stride_diff;
-        }
-    }
+    copyrect_rows(surface->ptr, sizeof(uint16_t), surface->stride,
+                  x + y * surface->stride, x2 + y2 * surface->stride, width, height);
 }
 
 static void fillrect16(gfx_surface *surface, uint x, uint y, uint width, uint height, uint color)
 {
     uint16_t *dest = &((uint16_t *)surface->ptr)[x + y * surface->stride];
-    uint stride_diff = surface->stride - width;
 
     uint16_t color16 = (uint16_t)(surface->translate_color(color));
 
-    uint i, j;
+    uint i;
     for (i=0; i < height; i++) {
-        for (j=0; j < width; j++) {
-            *dest = color16;
-            dest++;
-        }
-        dest += stride_diff;
+        fill_span16(dest, color16, width);
+        dest += surface->stride;
     }
 }
 
 static void copyrect32(gfx_surface *surface, uint x, uint y, uint width, uint height, uint x2, uint y2)
 {
-    // copy
-    const uint32_t *src = &((const uint32_t *)surface->ptr)[x + y * surface->stride];
-    uint32_t *dest = &((uint32_t *)surface->ptr)[x2 + y2 * surface->stride];
-    uint stride_diff = surface->stride - width;
-
-    if (dest < src) {
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest++;
-                src++;
-            }
-            dest += stride_diff;
-            src += stride_diff;
-        }
-    } else {
-        // copy backwards
-        src += height * surface->stride + width;
-        dest += height * surface->stride + width;
-
-        uint i, j;
-        for (i=0; i < height; i++) {
-            for (j=0; j < width; j++) {
-                *dest = *src;
-                dest--;
-                src--;
-            }
-            dest -= stride_diff;
-            src -= stride_diff;
-        }
-    }
+    copyrect_rows(surface->ptr, sizeof(uint32_t), surface->stride,
+                  x + y * surface->stride, x2 + y2 * surface->stride, width, height);
 }
 
 static void fillrect32(gfx_surface *surface, uint x, uint y, uint width, uint height, uint color)
 {
     uint32_t *dest = &((uint32_t *)surface->ptr)[x + y * surface->stride];
-    uint stride_diff = surface->stride - width;
 
-    uint i, j;
+    uint i;
     for (i=0; i < height; i++) {
-        for (j=0; j < width; j++) {
-            *dest = color;
-            dest++;
-        }
-        dest += stride_diff;
+        fill_span32(dest, color, width);
+        dest += surface->stride;
     }
 }
 
@@ -44,10 +44,6 @@ static struct {
     // underlying hw surface, if different from above
     gfx_surface *hw_surface;
 
-    // surface to do single line sub-region flushing with
-    gfx_surface line;
-    uint linestride;
-
     uint rows, columns;
     uint extray; // extra pixels left over if the rows doesn't fit precisely
 
@@ -55,21 +51,106 @@ static struct {
 
     uint32_t front_color;
     uint32_t back_color;
+
+    // dirty region of |surface| in pixels, accumulated by the paint path
+    // and drained by the print callback so blits and flushes only touch
+    // what changed
+    bool dirty;
+    uint dirty_x0, dirty_y0, dirty_x1, dirty_y1;
+
+    // hardware panning state: base of the framebuffer and the pixel row
+    // the scanout window currently starts at (see scroll_by_pan)
+    uint8_t *fb_base;
+    uint pan_offset;
 } gfxconsole;
 
+static void mark_dirty(uint x, uint y, uint width, uint height)
+{
+    if (x >= gfxconsole.surface->width || y >= gfxconsole.surface->height || !width || !height)
+        return;
+    uint x1 = x + width - 1;
+    uint y1 = y + height - 1;
+    if (x1 >= gfxconsole.surface->width)
+        x1 = gfxconsole.surface->width - 1;
+    if (y1 >= gfxconsole.surface->height)
+        y1 = gfxconsole.surface->height - 1;
+
+    if (!gfxconsole.dirty) {
+        gfxconsole.dirty = true;
+        gfxconsole.dirty_x0 = x;
+        gfxconsole.dirty_y0 = y;
+        gfxconsole.dirty_x1 = x1;
+        gfxconsole.dirty_y1 = y1;
+        return;
+    }
+    if (x < gfxconsole.dirty_x0)
+        gfxconsole.dirty_x0 = x;
+    if (y < gfxconsole.dirty_y0)
+        gfxconsole.dirty_y0 = y;
+    if (x1 > gfxconsole.dirty_x1)
+        gfxconsole.dirty_x1 = x1;
+    if (y1 > gfxconsole.dirty_y1)
+        gfxconsole.dirty_y1 = y1;
+}
+
+static void mark_all_dirty(void)
+{
+    mark_dirty(0, 0, gfxconsole.surface->width, gfxconsole.surface->height);
+}
+
 static void draw_char(char c, const struct gfx_font* font)
 {
     gfx_putchar(gfxconsole.surface, font, c,
                 gfxconsole.x * font->width, gfxconsole.y * font->height,
                 gfxconsole.front_color, gfxconsole.back_color);
+    mark_dirty(gfxconsole.x * font->width, gfxconsole.y * font->height,
+               font->width, font->height);
 }
 
 void gfxconsole_putpixel(unsigned x, unsigned y, unsigned color) {
     gfx_putpixel(gfxconsole.surface, x, y, color);
+    mark_dirty(x, y, 1, 1);
 }
 
 static const struct gfx_font* font = &font_9x16;
 
+static gfx_surface hw_surface;
+static gfx_surface sw_surface;
+static struct display_info dispinfo;
+
+// Scrolls up one text line by moving the display controller's scanout
+// window down the framebuffer instead of copying every surviving pixel.
+// Only possible when the console draws directly into the hardware
+// framebuffer and the driver reports spare rows and a pan hook. Returns
+// false if the caller must fall back to the copying scroll.
+static bool scroll_by_pan(void)
+{
+    gfx_surface *s = gfxconsole.surface;
+    uint fh = font->height;
+
+    if (s != gfxconsole.hw_surface || dispinfo.pan == NULL)
+        return false;
+    if (dispinfo.vheight < dispinfo.height + fh)
+        return false;
+
+    size_t row_bytes = (size_t)s->stride * s->pixelsize;
+
+    if (gfxconsole.pan_offset + fh + dispinfo.height <= dispinfo.vheight) {
+        // Slide the window one text line; the surviving lines stay put.
+        gfxconsole.pan_offset += fh;
+    } else {
+        // Ran out of spare rows: copy the surviving lines back to the top
+        // of the framebuffer. This is the only full copy, amortized over
+        // (vheight - height) / font->height pan scrolls.
+        memmove(gfxconsole.fb_base, (uint8_t *)s->ptr + fh * row_bytes,
+                (dispinfo.height - fh - gfxconsole.extray) * row_bytes);
+        gfxconsole.pan_offset = 0;
+    }
+    s->ptr = gfxconsole.fb_base + gfxconsole.pan_offset * row_bytes;
+    dispinfo.pan(gfxconsole.pan_offset);
+    return true;
+}
+
 static bool gfxconsole_putc(char c)
 {
     static enum { NORMAL, ESCAPE } state = NORMAL;
@@ -126,14 +207,18 @@ static bool gfxconsole_putc(char c)
     }
     if (gfxconsole.y >= gfxconsole.rows) {
         // scroll up
-        gfx_copyrect(gfxconsole.surface, 0, font->height, gfxconsole.surface->width,
-                     gfxconsole.surface->height - font->height - gfxconsole.extray, 0, 0);
+        if (!scroll_by_pan()) {
+            gfx_copyrect(gfxconsole.surface, 0, font->height, gfxconsole.surface->width,
+                         gfxconsole.surface->height - font->height - gfxconsole.extray, 0, 0);
+            mark_all_dirty();
+        }
         gfxconsole.y--;
 
         // clear the bottom line
         gfx_fillrect(gfxconsole.surface, 0, gfxconsole.surface->height - font->height - gfxconsole.extray,
                      gfxconsole.surface->width, font->height, gfxconsole.back_color);
-        gfx_flush(gfxconsole.surface);
+        mark_dirty(0, gfxconsole.surface->height - font->height - gfxconsole.extray,
+                   gfxconsole.surface->width, font->height);
         inval = 1;
     }
     return inval;
@@ -141,29 +226,35 @@ static bool gfxconsole_putc(char c)
 
 static void gfxconsole_print_callback(print_callback_t *cb, const char *str, size_t len)
 {
-    int refresh_full_screen = 0;
     for (size_t i = 0; i < len; i++) {
         if (str[i] == '\n')
             gfxconsole_putc('\r');
-        refresh_full_screen |= gfxconsole_putc(str[i]);
+        gfxconsole_putc(str[i]);
     }
 
+    if (!gfxconsole.dirty)
+        return;
+    uint x0 = gfxconsole.dirty_x0;
+    uint y0 = gfxconsole.dirty_y0;
+    uint x1 = gfxconsole.dirty_x1;
+    uint y1 = gfxconsole.dirty_y1;
+    gfxconsole.dirty = false;
+
     // blit from the software surface to the hardware
     if (gfxconsole.surface != gfxconsole.hw_surface) {
-        if (refresh_full_screen) {
-            gfx_surface_blend(gfxconsole.hw_surface, gfxconsole.surface, 0, 0);
-        } else {
-            // Only re-blit the active console line.
-            // Since blend only works in whole surfaces, configure a sub-surface
-            // to use as the blend source.
-            gfxconsole.line.ptr = ((uint8_t*) gfxconsole.surface->ptr) +
-                (gfxconsole.y * gfxconsole.linestride);
-            gfx_surface_blend(gfxconsole.hw_surface, &gfxconsole.line,
-                0, gfxconsole.y * font->height);
-        }
-        gfx_flush(gfxconsole.hw_surface);
+        // Only re-blit the dirty rectangle.
+        // Since blend only works in whole surfaces, configure a sub-surface
+        // to use as the blend source.
+        gfx_surface sub;
+        memcpy(&sub, gfxconsole.surface, sizeof(sub));
+        sub.ptr = ((uint8_t*) gfxconsole.surface->ptr) +
+            (y0 * sub.stride + x0) * sub.pixelsize;
+        sub.width = x1 - x0 + 1;
+        sub.height = y1 - y0 + 1;
+        gfx_surface_blend(gfxconsole.hw_surface, &sub, x0, y0);
+        gfx_flush_rows(gfxconsole.hw_surface, y0, y1);
     } else {
-        gfx_flush(gfxconsole.surface);
+        gfx_flush_rows(gfxconsole.surface, y0, y1);
     }
 }
 
@@ -187,10 +278,10 @@ static void gfxconsole_setup(gfx_surface *surface, gfx_surface *hw_surface)
     gfxconsole.surface = surface;
     gfxconsole.hw_surface = hw_surface;
 
-    // set up line-height sub-surface, for line-only invalidation
-    memcpy(&gfxconsole.line, surface, sizeof(*surface));
-    gfxconsole.line.height = font->height;
-    gfxconsole.linestride = surface->stride * surface->pixelsize * font->height;
+    // nothing painted yet, and the scanout window starts at the top
+    gfxconsole.dirty = false;
+    gfxconsole.fb_base = surface->ptr;
+    gfxconsole.pan_offset = 0;
 
     // calculate how many rows/columns we have
     gfxconsole.rows = surface->height / font->height;
@@ -219,6 +310,7 @@ static void gfxconsole_clear(bool crash_console)
     gfx_fillrect(gfxconsole.surface, 0, 0, gfxconsole.surface->width, gfxconsole.surface->height,
                  gfxconsole.back_color);
     gfx_flush(gfxconsole.surface);
+    gfxconsole.dirty = false;
 }
 
 /**
@@ -238,10 +330,6 @@ void gfxconsole_start(gfx_surface *surface, gfx_surface *hw_surface)
     register_print_callback(&cb);
 }
 
-static gfx_surface hw_surface;
-static gfx_surface sw_surface;
-static struct display_info dispinfo;
-
 zx_status_t gfxconsole_display_get_info(struct display_info *info)
 {
     if (gfxconsole.surface) {
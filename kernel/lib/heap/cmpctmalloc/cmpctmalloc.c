@@ -995,6 +995,17 @@ void* cmpct_memalign(size_t size, size_t alignment) {
     return payload;
 }
 
+size_t cmpct_alloc_size(void* payload) {
+    if (payload == NULL) {
+        return 0;
+    }
+    const header_t* header = (header_t*)payload - 1;
+    DEBUG_ASSERT(!is_tagged_as_free(header));
+    // The size of an allocated area never changes until it is freed, so this
+    // is safe to read without the heap lock.
+    return header->size - sizeof(header_t);
+}
+
 void cmpct_free(void* payload) {
     if (payload == NULL) {
         return;
@@ -19,6 +19,10 @@ void* cmpct_realloc(void*, size_t);
 void cmpct_free(void*);
 void* cmpct_memalign(size_t size, size_t alignment);
 
+// Returns the usable size of an allocated block, which may be larger than
+// the size originally requested. Takes no locks.
+size_t cmpct_alloc_size(void*);
+
 void cmpct_init(void);
 void cmpct_dump(bool panic_time);
 void cmpct_get_info(size_t* size_bytes, size_t* free_bytes);
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <err.h>
+#include <kernel/align.h>
 #include <kernel/auto_lock.h>
 #include <kernel/spinlock.h>
 #include <lib/cmpctmalloc.h>
@@ -126,6 +127,127 @@ void dump_stats() {
     }
 }
 
+// Per-cpu magazines of recently freed small blocks. Small malloc/free pairs
+// are the bulk of heap traffic (handle arrays, dispatchers) and used to take
+// the global heap mutex every time; with magazines they are served from the
+// local cpu with interrupts briefly disabled and no lock, and the underlying
+// heap only sees batched refills and drains. A magazine's state is only ever
+// touched from its own cpu with interrupts disabled.
+const size_t kMagazineClassShift = 4;
+const size_t kMagazineClassSize = 1UL << kMagazineClassShift;
+const size_t kMagazineClasses = 8; // covers allocations up to 128 bytes
+const size_t kMagazineRounds = 16;
+const size_t kMagazineDrainBatch = 8;
+
+struct Magazine {
+    void* rounds[kMagazineRounds];
+    size_t count;
+};
+
+struct HeapCpuCache {
+    Magazine mags[kMagazineClasses];
+} __CPU_ALIGN;
+
+HeapCpuCache heap_cpu_caches[SMP_MAX_CPUS];
+
+// Returns the class that serves requests of |size|, or kMagazineClasses if
+// the size is too large to cache.
+size_t size_to_class(size_t size) {
+    if (size == 0 || size > kMagazineClasses * kMagazineClassSize) {
+        return kMagazineClasses;
+    }
+    return (size - 1) >> kMagazineClassShift;
+}
+
+// Try to serve |size| from the local cpu's magazine, falling back to the
+// heap on a miss. Returns null if the size is not a cached class (or on
+// OOM in the fallback path); the caller should then allocate normally.
+void* magazine_alloc(size_t size) {
+    const size_t cls = size_to_class(size);
+    if (cls >= kMagazineClasses) {
+        return nullptr;
+    }
+
+    void* ptr = nullptr;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    Magazine* mag = &heap_cpu_caches[arch_curr_cpu_num()].mags[cls];
+    if (likely(mag->count > 0)) {
+        ptr = mag->rounds[--mag->count];
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    if (likely(ptr)) {
+        return ptr;
+    }
+
+    // Miss; allocate the full class size so the block can later be recycled
+    // for any request in the class.
+    return cmpct_alloc((cls + 1) << kMagazineClassShift);
+}
+
+// Try to stash |ptr| in the local cpu's magazine. Returns false if the block
+// is not worth caching, in which case the caller frees it normally.
+bool magazine_free(void* ptr) {
+    // Map the block's usable size down to the largest class it fully covers;
+    // the heap may have rounded the original request up. Blocks much bigger
+    // than the largest class would waste memory sitting in a magazine.
+    const size_t usable = cmpct_alloc_size(ptr);
+    if (usable < kMagazineClassSize ||
+        usable >= 2 * kMagazineClasses * kMagazineClassSize) {
+        return false;
+    }
+    size_t cls = (usable >> kMagazineClassShift) - 1;
+    if (cls >= kMagazineClasses) {
+        cls = kMagazineClasses - 1;
+    }
+
+    // Drained blocks are handed back to the heap after interrupts are
+    // restored; cmpct_free takes a mutex and may block.
+    void* drain[kMagazineDrainBatch];
+    size_t drain_count = 0;
+
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    Magazine* mag = &heap_cpu_caches[arch_curr_cpu_num()].mags[cls];
+    if (unlikely(mag->count == kMagazineRounds)) {
+        // Full; pull the coldest rounds out of the bottom so the next few
+        // frees on this cpu stay lock free.
+        drain_count = kMagazineDrainBatch;
+        memcpy(drain, mag->rounds, sizeof(drain));
+        mag->count -= kMagazineDrainBatch;
+        memmove(mag->rounds, mag->rounds + kMagazineDrainBatch,
+                mag->count * sizeof(void*));
+    }
+    mag->rounds[mag->count++] = ptr;
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    for (size_t i = 0; i < drain_count; i++) {
+        cmpct_free(drain[i]);
+    }
+    return true;
+}
+
+// Hand every block in the current cpu's magazines back to the heap. Other
+// cpus' magazines can only be drained from their own cpu.
+void magazine_trim() {
+    for (size_t cls = 0; cls < kMagazineClasses; cls++) {
+        void* drain[kMagazineRounds];
+        size_t drain_count;
+
+        spin_lock_saved_state_t state;
+        arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+        Magazine* mag = &heap_cpu_caches[arch_curr_cpu_num()].mags[cls];
+        drain_count = mag->count;
+        memcpy(drain, mag->rounds, drain_count * sizeof(void*));
+        mag->count = 0;
+        arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+        for (size_t i = 0; i < drain_count; i++) {
+            cmpct_free(drain[i]);
+        }
+    }
+}
+
 } // namespace
 
 void heap_init() {
@@ -133,6 +255,7 @@ void heap_init() {
 }
 
 void heap_trim() {
+    magazine_trim();
     cmpct_trim();
 }
 
@@ -143,7 +266,10 @@ void* malloc(size_t size) {
 
     add_stat(__GET_CALLER(), size);
 
-    void* ptr = cmpct_alloc(size);
+    void* ptr = magazine_alloc(size);
+    if (unlikely(!ptr)) {
+        ptr = cmpct_alloc(size);
+    }
     if (unlikely(heap_trace)) {
         printf("caller %p malloc %zu -> %p\n", __GET_CALLER(), size, ptr);
     }
@@ -162,7 +288,10 @@ void* malloc_debug_caller_(size_t size, void* caller) {
 
     add_stat(caller, size);
 
-    void* ptr = cmpct_alloc(size);
+    void* ptr = magazine_alloc(size);
+    if (unlikely(!ptr)) {
+        ptr = cmpct_alloc(size);
+    }
     if (unlikely(heap_trace)) {
         printf("caller %p malloc %zu -> %p\n", caller, size, ptr);
     }
@@ -239,6 +368,9 @@ void free(void* ptr) {
         printf("caller %p free %p\n", __GET_CALLER(), ptr);
     }
 
+    if (ptr && magazine_free(ptr)) {
+        return;
+    }
     cmpct_free(ptr);
 }
 
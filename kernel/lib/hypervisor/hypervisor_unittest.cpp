@@ -415,6 +415,31 @@ static bool guest_physical_address_space_page_fault() {
     END_TEST;
 }
 
+static bool guest_physical_address_space_page_fault_near_end_of_mapping() {
+    BEGIN_TEST;
+
+    if (!hypervisor_supported()) {
+        return true;
+    }
+
+    // Setup.
+    fbl::unique_ptr<hypervisor::GuestPhysicalAddressSpace> gpas;
+    zx_status_t status = create_gpas(&gpas);
+    EXPECT_EQ(ZX_OK, status, "Failed to create GuestPhysicalAddressSpace\n");
+    fbl::RefPtr<VmObject> vmo;
+    status = create_vmo(PAGE_SIZE * 2, &vmo);
+    EXPECT_EQ(ZX_OK, status, "Failed to create VMO\n");
+    status = create_mapping(gpas->RootVmar(), vmo, 0);
+    EXPECT_EQ(ZX_OK, status, "Failed to create mapping\n");
+
+    // Fault in the last page of the mapping. The speculative batch must stop
+    // at the end of the mapping rather than faulting past it.
+    status = gpas->PageFault(PAGE_SIZE);
+    EXPECT_EQ(ZX_OK, status, "Failed to fault page\n");
+
+    END_TEST;
+}
+
 static bool guest_physical_address_space_map_interrupt_controller() {
     BEGIN_TEST;
 
@@ -528,6 +553,7 @@ HYPERVISOR_UNITTEST(guest_physical_address_space_get_page)
 HYPERVISOR_UNITTEST(guest_physical_address_space_get_page_complex)
 HYPERVISOR_UNITTEST(guest_physical_address_space_get_page_not_present)
 HYPERVISOR_UNITTEST(guest_physical_address_space_page_fault)
+HYPERVISOR_UNITTEST(guest_physical_address_space_page_fault_near_end_of_mapping)
 HYPERVISOR_UNITTEST(guest_physical_address_space_map_interrupt_controller)
 HYPERVISOR_UNITTEST(guest_physical_address_space_uncached)
 HYPERVISOR_UNITTEST(guest_physical_address_space_uncached_device)
@@ -12,7 +12,9 @@
 #include <arch/ops.h>
 #include <arch/user_copy.h>
 #include <hypervisor/ktrace.h>
+#include <kernel/align.h>
 #include <kernel/cmdline.h>
+#include <kernel/spinlock.h>
 #include <lib/ktrace.h>
 #include <lk/init.h>
 #include <object/thread_dispatcher.h>
@@ -76,7 +78,7 @@ static void ktrace_report_probes(void) {
 }
 
 typedef struct ktrace_state {
-    // where the next record will be written
+    // where the next merged record will be written
     int offset;
 
     // mask of groups we allow, 0 == tracing disabled
@@ -88,12 +90,115 @@ typedef struct ktrace_state {
     // offset where tracing was stopped, 0 if tracing active
     uint32_t marker;
 
-    // raw trace buffer
+    // merged trace buffer, which is what readers see
     uint8_t* buffer;
 } ktrace_state_t;
 
 static ktrace_state_t KTRACE_STATE;
 
+// Records are emitted into per-cpu buffers so that tracing costs the hot
+// path no shared cache lines beyond the read-only group mask; the single
+// shared buffer used to bounce its offset word between every core. Each
+// record is prefixed in the per-cpu buffer with an 8-byte timestamp taken
+// while interrupts are disabled, so every stream is strictly ordered and
+// records without a timestamp field (name records) still merge correctly.
+// The prefix is stripped when the streams are merged into the main buffer
+// at stop time.
+typedef struct ktrace_cpu_state {
+    // per-cpu trace buffer, written only by the owning cpu with
+    // interrupts disabled
+    uint8_t* buffer;
+
+    // where the next record will be written
+    uint32_t offset;
+
+    // usable size of the buffer
+    uint32_t bufsize;
+} __CPU_ALIGN ktrace_cpu_state_t;
+
+static ktrace_cpu_state_t KTRACE_CPU_STATE[SMP_MAX_CPUS];
+
+static const uint32_t KTRACE_TS_PREFIX = sizeof(uint64_t);
+
+// Reserve |len| bytes in the local cpu's buffer and stamp the reservation's
+// timestamp prefix. Returns a pointer to the record area, or nullptr (and
+// stops tracing) if the buffer is exhausted. The caller may fill the record
+// after interrupts are restored; the space is already owned.
+static void* ktrace_reserve(uint32_t len) {
+    void* ptr = nullptr;
+
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    ktrace_cpu_state_t* kc = &KTRACE_CPU_STATE[arch_curr_cpu_num()];
+    if (likely(kc->buffer != nullptr && kc->offset + KTRACE_TS_PREFIX + len <= kc->bufsize)) {
+        uint64_t* ts = (uint64_t*)(kc->buffer + kc->offset);
+        *ts = ktrace_timestamp();
+        ptr = ts + 1;
+        kc->offset += KTRACE_TS_PREFIX + len;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    if (unlikely(ptr == nullptr)) {
+        // if we arrive at the end, stop
+        atomic_store(&KTRACE_STATE.grpmask, 0);
+    }
+    return ptr;
+}
+
+// Merge the per-cpu streams, each already timestamp-ordered, into the main
+// buffer where readers expect a single chronological stream. Called with
+// tracing stopped.
+static void ktrace_merge(void) {
+    ktrace_state_t* ks = &KTRACE_STATE;
+    uint32_t heads[SMP_MAX_CPUS] = {};
+    const uint max_cpus = arch_max_num_cpus();
+
+    for (;;) {
+        int best = -1;
+        uint64_t best_ts = ~(uint64_t)0;
+        for (uint i = 0; i < max_cpus; i++) {
+            ktrace_cpu_state_t* kc = &KTRACE_CPU_STATE[i];
+            if (heads[i] >= kc->offset) {
+                continue;
+            }
+            const uint64_t ts = *(const uint64_t*)(kc->buffer + heads[i]);
+            const ktrace_header_t* hdr =
+                (const ktrace_header_t*)(kc->buffer + heads[i] + KTRACE_TS_PREFIX);
+            if (KTRACE_LEN(hdr->tag) == 0) {
+                // A reservation that was never filled in (stop raced with a
+                // writer); we can't know its length, so drop the rest of
+                // this cpu's stream.
+                heads[i] = kc->offset;
+                continue;
+            }
+            if (ts < best_ts) {
+                best_ts = ts;
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        ktrace_cpu_state_t* kc = &KTRACE_CPU_STATE[best];
+        const uint32_t tag = ((const ktrace_header_t*)(kc->buffer + heads[best] +
+                                                       KTRACE_TS_PREFIX))->tag;
+        const uint32_t len = KTRACE_LEN(tag);
+        if ((uint32_t)ks->offset + len > ks->bufsize) {
+            // out of room in the merged buffer; drop the remainder
+            break;
+        }
+        memcpy(ks->buffer + ks->offset, kc->buffer + heads[best] + KTRACE_TS_PREFIX, len);
+        ks->offset += len;
+        heads[best] += KTRACE_TS_PREFIX + len;
+    }
+
+    // the merged records have been consumed
+    for (uint i = 0; i < max_cpus; i++) {
+        KTRACE_CPU_STATE[i].offset = 0;
+    }
+}
+
 ssize_t ktrace_read_user(void* ptr, uint32_t off, size_t len) {
     ktrace_state_t* ks = &KTRACE_STATE;
 
@@ -142,6 +247,8 @@ zx_status_t ktrace_control(uint32_t action, uint32_t options, void* ptr) {
         break;
     case KTRACE_ACTION_STOP: {
         atomic_store(&ks->grpmask, 0);
+        // merge the per-cpu streams into the buffer readers see
+        ktrace_merge();
         uint32_t n = ks->offset;
         if (n > ks->bufsize) {
             ks->marker = ks->bufsize;
@@ -151,7 +258,11 @@ zx_status_t ktrace_control(uint32_t action, uint32_t options, void* ptr) {
         break;
     }
     case KTRACE_ACTION_REWIND:
-        // roll back to just after the metadata
+        // roll back to just after the metadata; assumes tracing is stopped,
+        // since the per-cpu write cursors are reset from this cpu
+        for (uint i = 0; i < arch_max_num_cpus(); i++) {
+            KTRACE_CPU_STATE[i].offset = 0;
+        }
         atomic_store(&ks->offset, KTRACE_RECSIZE * 2);
         ktrace_report_syscalls(kt_syscall_info);
         ktrace_report_probes();
@@ -207,6 +318,23 @@ void ktrace_init(unsigned level) {
 
     dprintf(INFO, "ktrace: buffer at %p (%u bytes)\n", ks->buffer, mb);
 
+    // carve a second allocation of the same size into per-cpu buffers that
+    // records are emitted into; the main buffer holds the merged stream
+    const uint max_cpus = arch_max_num_cpus();
+    const uint32_t cpu_bufsize = ROUNDDOWN(mb / max_cpus, KTRACE_HDRSIZE);
+    uint8_t* cpu_buffer;
+    if ((status = aspace->Alloc("ktrace-cpu", mb, (void**)&cpu_buffer, 0,
+                                VmAspace::VMM_FLAG_COMMIT,
+                                ARCH_MMU_FLAG_PERM_READ | ARCH_MMU_FLAG_PERM_WRITE)) < 0) {
+        dprintf(INFO, "ktrace: cannot alloc per-cpu buffers %d\n", status);
+        return;
+    }
+    for (uint i = 0; i < max_cpus; i++) {
+        KTRACE_CPU_STATE[i].buffer = cpu_buffer + (size_t)i * cpu_bufsize;
+        KTRACE_CPU_STATE[i].bufsize = cpu_bufsize;
+        KTRACE_CPU_STATE[i].offset = 0;
+    }
+
     // register all static probes
     {
         fbl::AutoLock lock(&probe_list_lock);
@@ -249,13 +377,9 @@ void ktrace_tiny(uint32_t tag, uint32_t arg) {
     ktrace_state_t* ks = &KTRACE_STATE;
     if (tag & atomic_load(&ks->grpmask)) {
         tag = (tag & 0xFFFFFFF0) | 2;
-        int off;
-        if ((off = atomic_add(&ks->offset, KTRACE_HDRSIZE)) >= (int)ks->bufsize) {
-            // if we arrive at the end, stop
-            atomic_store(&ks->grpmask, 0);
-        } else {
-            ktrace_header_t* hdr = (ktrace_header_t*) (ks->buffer + off);
-            hdr->ts = ktrace_timestamp();
+        ktrace_header_t* hdr = (ktrace_header_t*)ktrace_reserve(KTRACE_HDRSIZE);
+        if (hdr != nullptr) {
+            hdr->ts = ((uint64_t*)hdr)[-1];
             hdr->tag = tag;
             hdr->tid = arg;
         }
@@ -268,15 +392,14 @@ void* ktrace_open(uint32_t tag) {
         return nullptr;
     }
 
-    int off;
-    if ((off = atomic_add(&ks->offset, KTRACE_LEN(tag))) >= (int)ks->bufsize) {
-        // if we arrive at the end, stop
-        atomic_store(&ks->grpmask, 0);
+    ktrace_header_t* hdr = (ktrace_header_t*)ktrace_reserve(KTRACE_LEN(tag));
+    if (hdr == nullptr) {
         return nullptr;
     }
 
-    ktrace_header_t* hdr = (ktrace_header_t*) (ks->buffer + off);
-    hdr->ts = ktrace_timestamp();
+    // reuse the reservation's timestamp so the record agrees with the
+    // ordering the merge uses
+    hdr->ts = ((uint64_t*)hdr)[-1];
     hdr->tag = tag;
     hdr->tid = (uint32_t)get_current_thread()->user_tid;
     return hdr + 1;
@@ -290,12 +413,8 @@ void ktrace_name_etc(uint32_t tag, uint32_t id, uint32_t arg, const char* name,
         // set size to: sizeof(hdr) + len + 1, round up to multiple of 8
         tag = (tag & 0xFFFFFFF0) | ((KTRACE_NAMESIZE + len + 1 + 7) >> 3);
 
-        int off;
-        if ((off = atomic_add(&ks->offset, KTRACE_LEN(tag))) >= (int)ks->bufsize) {
-            // if we arrive at the end, stop
-            atomic_store(&ks->grpmask, 0);
-        } else {
-            ktrace_rec_name_t* rec = (ktrace_rec_name_t*) (ks->buffer + off);
+        ktrace_rec_name_t* rec = (ktrace_rec_name_t*)ktrace_reserve(KTRACE_LEN(tag));
+        if (rec != nullptr) {
             rec->tag = tag;
             rec->id = id;
             rec->arg = arg;
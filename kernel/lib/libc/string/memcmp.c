@@ -5,17 +5,39 @@
 // license that can be found in the LICENSE file or at
 // https://opensource.org/licenses/MIT
 
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 
 int
 memcmp(const void *cs, const void *ct, size_t count)
 {
-    const unsigned char *su1, *su2;
-    signed char res = 0;
+    const unsigned char *su1 = cs;
+    const unsigned char *su2 = ct;
 
-    for (su1 = cs, su2 = ct; 0 < count; ++su1, ++su2, count--)
-        if ((res = *su1 - *su2) != 0)
-            break;
-    return res;
+    // Compare a machine word at a time when both pointers can be brought to
+    // the same alignment; this is the common case for the page and buffer
+    // comparisons the kernel does. Mismatched alignments fall through to the
+    // byte loop.
+    if (count >= sizeof(unsigned long) &&
+        (((uintptr_t)su1 ^ (uintptr_t)su2) & (sizeof(unsigned long) - 1)) == 0) {
+        while (((uintptr_t)su1 & (sizeof(unsigned long) - 1)) != 0) {
+            if (*su1 != *su2)
+                return *su1 - *su2;
+            su1++, su2++, count--;
+        }
+        while (count >= sizeof(unsigned long)) {
+            if (*(const unsigned long *)su1 != *(const unsigned long *)su2)
+                break; // Find the differing byte with the loop below.
+            su1 += sizeof(unsigned long);
+            su2 += sizeof(unsigned long);
+            count -= sizeof(unsigned long);
+        }
+    }
+
+    for (; 0 < count; su1++, su2++, count--) {
+        if (*su1 != *su2)
+            return *su1 - *su2;
+    }
+    return 0;
 }
@@ -6,6 +6,8 @@
 
 #include <arch/ops.h>
 #include <debug.h>
+#include <kernel/align.h>
+#include <kernel/cmdline.h>
 #include <kernel/event.h>
 #include <kernel/percpu.h>
 #include <kernel/thread.h>
@@ -35,6 +37,17 @@ namespace {
 event_t graph_edge_event =
     EVENT_INITIAL_VALUE(graph_edge_event, false, EVENT_FLAG_AUTOUNSIGNAL);
 
+// Validation sample rate. A rate of N runs the full dependency checks on
+// roughly 1 in N acquisitions per cpu; 0 or 1 validates every acquisition.
+// Set from kernel.lockdep.sample-rate.
+uint32_t lockdep_sample_rate = 1;
+
+struct SampleCounter {
+    uint32_t countdown;
+} __CPU_ALIGN;
+
+SampleCounter lockdep_sample_counters[SMP_MAX_CPUS];
+
 // Loop detection thread. Traverses the lock dependency graph to find circular
 // lock dependencies.
 int LockDepThread(void* /*arg*/) {
@@ -52,6 +65,8 @@ int LockDepThread(void* /*arg*/) {
 }
 
 void LockDepInit(unsigned /*level*/) {
+    lockdep_sample_rate = cmdline_get_uint32("kernel.lockdep.sample-rate", 1);
+
     thread_t* t = thread_create("lockdep", &LockDepThread, NULL,
                                 LOW_PRIORITY, DEFAULT_STACK_SIZE);
     thread_detach_and_resume(t);
@@ -59,6 +74,8 @@ void LockDepInit(unsigned /*level*/) {
 
 // Dumps the state of the lock dependency graph.
 void DumpLockClassState() {
+    printf("Validation sample rate: 1 in %u\n",
+           lockdep_sample_rate > 1 ? lockdep_sample_rate : 1);
     printf("Lock class states:\n");
     for (auto& state : lockdep::LockClassState::Iter()) {
         printf("  %s {\n", state.name());
@@ -200,6 +217,24 @@ void SystemInitThreadLockState(ThreadLockState* state) {
     new (state) ThreadLockState();
 }
 
+// Decides whether this acquisition runs the full dependency checks. The
+// per-cpu countdown is updated without disabling interrupts or preemption;
+// a tick occasionally lost to a race just shifts which acquisition gets
+// sampled.
+bool SystemLockValidationShouldSample() {
+    const uint32_t rate = lockdep_sample_rate;
+    if (rate <= 1)
+        return true;
+
+    SampleCounter* counter = &lockdep_sample_counters[arch_curr_cpu_num()];
+    if (counter->countdown == 0) {
+        counter->countdown = rate - 1;
+        return true;
+    }
+    counter->countdown--;
+    return false;
+}
+
 // Wakes up the loop detector thread to re-evaluate the depedency graph.
 void SystemTriggerLoopDetection() {
     event_signal(&graph_edge_event, /*reschedule=*/false);
@@ -12,12 +12,28 @@
 // redline.
 typedef void(oom_lowmem_callback_t)(size_t shortfall_bytes);
 
+// Graduated memory pressure levels, from least to most severe, derived from
+// the watcher thread's free-memory sampling.
+typedef enum oom_mem_level {
+    OOM_MEM_LEVEL_NORMAL = 0,
+    OOM_MEM_LEVEL_WARNING,
+    OOM_MEM_LEVEL_CRITICAL,
+    OOM_MEM_LEVEL_OOM,
+} oom_mem_level_t;
+
+// Called whenever the memory pressure level changes.
+typedef void(oom_memlevel_callback_t)(oom_mem_level_t level);
+
 // Initializes the out-of-memory system. If |enable| is true, starts the
 // memory-watcher thread, which calls |lowmem_callback| when the PMM has less
 // than |redline_bytes| free memory, sleeping for |sleep_duration_ns| between
-// checks.
+// checks. |memlevel_callback| is called (from the same thread) whenever the
+// pressure level changes: WARNING below |warning_bytes| free, CRITICAL below
+// |critical_bytes|, OOM below |redline_bytes|.
 //
 // If |enable| is false, the thread can be started manually using 'k oom start'.
 // TODO(dbort): Add a programmatic way to start/stop the thread.
 void oom_init(bool enable, uint64_t sleep_duration_ns, size_t redline_bytes,
-              oom_lowmem_callback_t* lowmem_callback);
+              size_t critical_bytes, size_t warning_bytes,
+              oom_lowmem_callback_t* lowmem_callback,
+              oom_memlevel_callback_t* memlevel_callback);
@@ -41,6 +41,17 @@ static uint64_t oom_sleep_duration_ns TA_GUARDED(oom_mutex);
 // If the PMM has fewer than this many bytes free, start killing processes.
 static uint64_t oom_redline_bytes TA_GUARDED(oom_mutex);
 
+// Function to call when the memory pressure level changes.
+static oom_memlevel_callback_t* oom_memlevel_callback TA_GUARDED(oom_mutex);
+
+// Free-memory thresholds for the WARNING and CRITICAL pressure levels; the
+// OOM level shares the redline above.
+static uint64_t oom_critical_bytes TA_GUARDED(oom_mutex);
+static uint64_t oom_warning_bytes TA_GUARDED(oom_mutex);
+
+// The pressure level reported by the last callback invocation.
+static oom_mem_level_t oom_mem_level TA_GUARDED(oom_mutex);
+
 // True if the thread should print the current free value when it runs.
 static bool oom_printing TA_GUARDED(oom_mutex);
 
@@ -60,6 +71,8 @@ static int oom_loop(void* arg) {
         bool printing = false;
         size_t shortfall_bytes = 0;
         oom_lowmem_callback_t* lowmem_callback = nullptr;
+        oom_memlevel_callback_t* memlevel_callback = nullptr;
+        oom_mem_level_t mem_level = OOM_MEM_LEVEL_NORMAL;
         uint64_t sleep_duration_ns = 0;
         {
             AutoLock lock(&oom_mutex);
@@ -78,6 +91,21 @@ static int oom_loop(void* arg) {
             }
             oom_simulate_lowmem = false;
 
+            // Classify the pressure level; only report it on transitions.
+            if (lowmem) {
+                mem_level = OOM_MEM_LEVEL_OOM;
+            } else if (free_bytes < oom_critical_bytes) {
+                mem_level = OOM_MEM_LEVEL_CRITICAL;
+            } else if (free_bytes < oom_warning_bytes) {
+                mem_level = OOM_MEM_LEVEL_WARNING;
+            } else {
+                mem_level = OOM_MEM_LEVEL_NORMAL;
+            }
+            if (mem_level != oom_mem_level) {
+                oom_mem_level = mem_level;
+                memlevel_callback = oom_memlevel_callback;
+            }
+
             printing =
                 lowmem || (oom_printing && free_bytes != last_free_bytes);
             lowmem_callback = oom_lowmem_callback;
@@ -106,6 +134,9 @@ static int oom_loop(void* arg) {
         }
         last_free_bytes = free_bytes;
 
+        if (memlevel_callback != nullptr) {
+            memlevel_callback(mem_level);
+        }
         if (lowmem) {
             lowmem_callback(shortfall_bytes);
         }
@@ -131,16 +162,25 @@ static void start_thread_locked() TA_REQ(oom_mutex) {
 }
 
 void oom_init(bool enable, uint64_t sleep_duration_ns, size_t redline_bytes,
-              oom_lowmem_callback_t* lowmem_callback) {
+              size_t critical_bytes, size_t warning_bytes,
+              oom_lowmem_callback_t* lowmem_callback,
+              oom_memlevel_callback_t* memlevel_callback) {
     DEBUG_ASSERT(sleep_duration_ns > 0);
     DEBUG_ASSERT(redline_bytes > 0);
+    DEBUG_ASSERT(redline_bytes <= critical_bytes);
+    DEBUG_ASSERT(critical_bytes <= warning_bytes);
     DEBUG_ASSERT(lowmem_callback != nullptr);
+    DEBUG_ASSERT(memlevel_callback != nullptr);
 
     AutoLock lock(&oom_mutex);
     DEBUG_ASSERT(oom_lowmem_callback == nullptr);
     oom_lowmem_callback = lowmem_callback;
+    oom_memlevel_callback = memlevel_callback;
     oom_sleep_duration_ns = sleep_duration_ns;
     oom_redline_bytes = redline_bytes;
+    oom_critical_bytes = critical_bytes;
+    oom_warning_bytes = warning_bytes;
+    oom_mem_level = OOM_MEM_LEVEL_NORMAL;
     oom_printing = false;
     oom_simulate_lowmem = false;
     if (enable) {
@@ -202,6 +242,11 @@ static int cmd_oom(int argc, const cmd_args* argv, uint32_t flags) {
         char buf[MAX_FORMAT_SIZE_LEN];
         format_size_fixed(buf, sizeof(buf), oom_redline_bytes, 'M');
         printf("  redline: %s (%" PRIu64 " bytes)\n", buf, oom_redline_bytes);
+        format_size_fixed(buf, sizeof(buf), oom_critical_bytes, 'M');
+        printf("  critical: %s (%" PRIu64 " bytes)\n", buf, oom_critical_bytes);
+        format_size_fixed(buf, sizeof(buf), oom_warning_bytes, 'M');
+        printf("  warning: %s (%" PRIu64 " bytes)\n", buf, oom_warning_bytes);
+        printf("  pressure level: %d\n", oom_mem_level);
     } else if (strcmp(argv[1].str, "print") == 0) {
         oom_printing = !oom_printing;
         printf("OOM print is now %s\n", oom_printing ? "on" : "off");
@@ -16,7 +16,7 @@
 // hash. There is also a 4 byte 'git-' prefix, and possibly a 6 byte
 // '-dirty' suffix. Let's be generous and use 64 bytes.
 #define MAX_BUILDID_SIZE 64
-#define VDSO_CONSTANTS_SIZE (4 * 4 + 2 * 8 + MAX_BUILDID_SIZE)
+#define VDSO_CONSTANTS_SIZE (8 * 4 + 2 * 8 + MAX_BUILDID_SIZE)
 
 #ifndef __ASSEMBLER__
 
@@ -47,6 +47,20 @@ struct vdso_constants {
     // Number of bytes in an instruction cache line.
     uint32_t icache_line_size;
 
+    // Conversion factor from zx_ticks_get values to nanoseconds, as a
+    // binary fixed-point value: l0 is the integer part, l32 holds bits
+    // -1..-32 and l64 bits -33..-64 (the same representation as the
+    // kernel's fp_32_64).  All three are zero unless the kernel's
+    // monotonic clock is a pure scaling of the tick counter, in which
+    // case the kernel redirects zx_clock_get_monotonic to compute
+    // ticks * ns_per_tick entirely in userspace.
+    uint32_t ns_per_tick_l0;
+    uint32_t ns_per_tick_l32;
+    uint32_t ns_per_tick_l64;
+
+    // Explicit padding to keep the 64-bit members below aligned.
+    uint32_t padding1;
+
     // Conversion factor for zx_ticks_get return values to seconds.
     zx_ticks_t ticks_per_second;
 
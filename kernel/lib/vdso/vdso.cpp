@@ -10,6 +10,7 @@
 #include <fbl/alloc_checker.h>
 #include <fbl/type_support.h>
 #include <kernel/cmdline.h>
+#include <lib/fixed_point.h>
 #include <object/handle.h>
 #include <platform.h>
 #include <vm/pmm.h>
@@ -223,6 +224,9 @@ const VDso* VDso::Create() {
         "vDSO constants", vdso->vmo()->vmo(), VDSO_DATA_CONSTANTS);
     zx_ticks_t per_second = ticks_per_second();
 
+    struct fp_32_64 ns_per_tick = {};
+    bool mono_uses_ticks = platform_monotonic_ticks_rate(&ns_per_tick);
+
     // Initialize the constants that should be visible to the vDSO.
     // Rather than assigning each member individually, do this with
     // struct assignment and a compound literal so that the compiler
@@ -232,6 +236,10 @@ const VDso* VDso::Create() {
         {arch_cpu_features()},
         arch_dcache_line_size(),
         arch_icache_line_size(),
+        ns_per_tick.l0,
+        ns_per_tick.l32,
+        ns_per_tick.l64,
+        0,
         per_second,
         pmm_count_total_bytes(),
         BUILDID,
@@ -243,9 +251,22 @@ const VDso* VDso::Create() {
         // Make zx_ticks_per_second return nanoseconds per second.
         constants_window.data()->ticks_per_second = ZX_SEC(1);
 
+        // The conversion factor no longer applies to what zx_ticks_get
+        // returns; hide it so the fast monotonic path stays disabled.
+        constants_window.data()->ns_per_tick_l0 = 0;
+        constants_window.data()->ns_per_tick_l32 = 0;
+        constants_window.data()->ns_per_tick_l64 = 0;
+
         // Adjust the zx_ticks_get entry point to be soft_ticks_get.
         VDsoDynSymWindow dynsym_window(vdso->vmo()->vmo());
         REDIRECT_SYSCALL(dynsym_window, zx_ticks_get, soft_ticks_get);
+    } else if (mono_uses_ticks) {
+        // The monotonic clock is a pure scaling of the tick counter, so
+        // zx_clock_get_monotonic can be computed entirely in userspace
+        // from the hardware counter and the constants published above.
+        VDsoDynSymWindow dynsym_window(vdso->vmo()->vmo());
+        REDIRECT_SYSCALL(dynsym_window, zx_clock_get_monotonic,
+                         fast_clock_get_monotonic);
     }
 
     for (size_t v = static_cast<size_t>(Variant::FULL) + 1;
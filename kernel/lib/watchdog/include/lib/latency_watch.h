@@ -0,0 +1,47 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <platform.h>
+#include <sys/types.h>
+#include <zircon/compiler.h>
+#include <zircon/types.h>
+
+__BEGIN_CDECLS
+
+/* The latency watch complements the watchdog: where the watchdog catches
+ * full hangs, the latency watch makes short stalls in critical sections
+ * visible. Watched sections record their elapsed time into per-cpu
+ * max/count/log2-histogram state (a handful of stores; no locks), and a
+ * section that crosses its class threshold emits a ktrace probe, so the
+ * stalls preceding an audio glitch can be found without full tracing.
+ * Statistics and thresholds are accessible from the kernel console via the
+ * "lw" command.
+ */
+
+/* Classes of critical section tracked by the latency watch. */
+typedef enum lw_class {
+    LW_CLASS_IRQ = 0, /* hardware interrupt dispatch */
+    LW_CLASS_TIMER,   /* timer callbacks */
+    LW_CLASS_DPC,     /* dpc callbacks */
+    LW_CLASS_SCHED,   /* scheduler reschedule operations */
+    LW_CLASS_COUNT
+} lw_class_t;
+
+/* Marks the start of a watched section; pass the result to latency_watch_end. */
+static inline zx_time_t latency_watch_begin(void) {
+    return current_time();
+}
+
+/* Records the elapsed time of a watched section on the current cpu. */
+void latency_watch_end(lw_class_t cls, zx_time_t start);
+
+/* Sets the duration (ns) above which a section of |cls| emits a ktrace
+ * probe. 0 (the default) disables the events for the class. */
+void latency_watch_set_threshold(lw_class_t cls, zx_duration_t threshold);
+
+__END_CDECLS
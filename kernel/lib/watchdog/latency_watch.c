@@ -0,0 +1,145 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <lib/latency_watch.h>
+
+#include <arch/ops.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <kernel/mp.h>
+#include <lib/console.h>
+#include <lib/ktrace.h>
+#include <platform.h>
+#include <pow2.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LW_BUCKET_COUNT 32
+
+typedef struct lw_cpu_state {
+    uint64_t count;
+    zx_duration_t max;
+    // log2 histogram of section lengths: bucket i counts sections with
+    // floor(log2(ns)) == i; the last bucket collects the tail.
+    uint64_t buckets[LW_BUCKET_COUNT];
+} lw_cpu_state_t;
+
+// Written only by the owning cpu, with interrupts disabled or preemption
+// effectively excluded by the watched section itself; reads from the console
+// tolerate tearing.
+static lw_cpu_state_t lw_state[SMP_MAX_CPUS][LW_CLASS_COUNT];
+
+static zx_duration_t lw_threshold[LW_CLASS_COUNT];
+
+static const char* lw_class_name(lw_class_t cls) {
+    switch (cls) {
+    case LW_CLASS_IRQ:
+        return "irq";
+    case LW_CLASS_TIMER:
+        return "timer";
+    case LW_CLASS_DPC:
+        return "dpc";
+    case LW_CLASS_SCHED:
+        return "sched";
+    default:
+        return "unknown";
+    }
+}
+
+void latency_watch_end(lw_class_t cls, zx_time_t start) {
+    DEBUG_ASSERT(cls < LW_CLASS_COUNT);
+
+    zx_duration_t elapsed = current_time() - start;
+    if (elapsed < 0) {
+        elapsed = 0;
+    }
+
+    lw_cpu_state_t* state = &lw_state[arch_curr_cpu_num()][cls];
+    state->count++;
+    if (elapsed > state->max) {
+        state->max = elapsed;
+    }
+    uint bucket = (elapsed > 0) ? log2_ulong_floor((ulong)elapsed) : 0;
+    if (bucket >= LW_BUCKET_COUNT) {
+        bucket = LW_BUCKET_COUNT - 1;
+    }
+    state->buckets[bucket]++;
+
+    zx_duration_t threshold = lw_threshold[cls];
+    if (threshold != 0 && elapsed >= threshold) {
+        ktrace_probe2("latency_watch", (uint32_t)cls, (uint32_t)elapsed);
+    }
+}
+
+void latency_watch_set_threshold(lw_class_t cls, zx_duration_t threshold) {
+    DEBUG_ASSERT(cls < LW_CLASS_COUNT);
+    lw_threshold[cls] = threshold;
+}
+
+// Estimates the given percentile from the histogram; the result is the upper
+// bound (2^(bucket+1) ns) of the bucket in which the percentile falls.
+static zx_duration_t lw_percentile(const lw_cpu_state_t* state, uint pct) {
+    uint64_t target = (state->count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (uint i = 0; i < LW_BUCKET_COUNT; i++) {
+        seen += state->buckets[i];
+        if (seen >= target) {
+            return (i + 1 < 64) ? ((zx_duration_t)1 << (i + 1)) : state->max;
+        }
+    }
+    return state->max;
+}
+
+static int cmd_lw(int argc, const cmd_args* argv, uint32_t flags) {
+    if (argc >= 2 && !strcmp(argv[1].str, "reset")) {
+        memset(lw_state, 0, sizeof(lw_state));
+        return 0;
+    }
+    if (argc >= 4 && !strcmp(argv[1].str, "threshold")) {
+        for (uint cls = 0; cls < LW_CLASS_COUNT; cls++) {
+            if (!strcmp(argv[2].str, lw_class_name((lw_class_t)cls))) {
+                latency_watch_set_threshold((lw_class_t)cls, argv[3].u);
+                return 0;
+            }
+        }
+        printf("unknown class \"%s\"\n", argv[2].str);
+        return -1;
+    }
+    if (argc >= 2) {
+        printf("usage:\n");
+        printf("%s                          : dump per-cpu latency stats\n", argv[0].str);
+        printf("%s reset                    : clear latency stats\n", argv[0].str);
+        printf("%s threshold <class> <ns>   : set the ktrace event threshold (0 disables)\n",
+               argv[0].str);
+        return -1;
+    }
+
+    printf("%5s %3s %12s %12s %12s %12s\n",
+           "class", "cpu", "count", "max(ns)", "~p50(ns)", "~p99(ns)");
+    for (uint cls = 0; cls < LW_CLASS_COUNT; cls++) {
+        for (uint cpu = 0; cpu < SMP_MAX_CPUS; cpu++) {
+            if (!mp_is_cpu_active(cpu)) {
+                continue;
+            }
+            const lw_cpu_state_t* state = &lw_state[cpu][cls];
+            if (state->count == 0) {
+                continue;
+            }
+            printf("%5s %3u %12" PRIu64 " %12" PRIi64 " %12" PRIi64 " %12" PRIi64 "\n",
+                   lw_class_name((lw_class_t)cls), cpu, state->count, state->max,
+                   lw_percentile(state, 50), lw_percentile(state, 99));
+        }
+        if (lw_threshold[cls] != 0) {
+            printf("%5s ktrace threshold %" PRIi64 " ns\n",
+                   lw_class_name((lw_class_t)cls), lw_threshold[cls]);
+        }
+    }
+    return 0;
+}
+
+STATIC_COMMAND_START
+STATIC_COMMAND_MASKED("lw", "latency watch statistics and thresholds", &cmd_lw, CMD_AVAIL_NORMAL)
+STATIC_COMMAND_END(latency_watch);
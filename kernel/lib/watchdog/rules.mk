@@ -10,6 +10,7 @@ LOCAL_DIR := $(GET_LOCAL_DIR)
 MODULE := $(LOCAL_DIR)
 
 MODULE_SRCS := \
+    $(LOCAL_DIR)/latency_watch.c \
     $(LOCAL_DIR)/watchdog.c
 
 include make/module.mk
@@ -6,6 +6,142 @@
 
 #include <object/buffer_chain.h>
 
+#include <arch/ops.h>
+#include <kernel/align.h>
+#include <kernel/spinlock.h>
+#include <lib/counters.h>
+
+namespace {
+
+// Per-cpu pool of message pages, kept in VM_PAGE_STATE_IPC, so the alloc/free
+// cycle of short-lived channel messages doesn't round trip through the PMM
+// (or contend on a shared cache lock) on every packet. A pool is only touched
+// from its own cpu with interrupts disabled. Bounded so idle systems don't
+// strand memory here.
+constexpr size_t kPagePoolDepth = 64;
+
+// Number of extra pages pulled from the PMM when the local pool runs dry, so
+// a burst of messages pays for one PMM lock acquisition rather than one per
+// message.
+constexpr size_t kPagePoolRefill = 16;
+
+struct PagePool {
+    vm_page_t* pages[kPagePoolDepth];
+    size_t count;
+} __CPU_ALIGN;
+
+PagePool page_pools[SMP_MAX_CPUS];
+
+KCOUNTER(buffer_chain_pool_hits, "kernel.buffer_chain.pages.pool_hits");
+KCOUNTER(buffer_chain_pool_misses, "kernel.buffer_chain.pages.pool_misses");
+KCOUNTER(buffer_chain_pool_refills, "kernel.buffer_chain.pages.pool_refills");
+
+// Pops up to |want| pages from the local pool onto the tail of |pages|.
+// Returns the number of pages popped.
+size_t page_pool_pop(size_t want, list_node* pages) {
+    size_t popped = 0;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    PagePool* pool = &page_pools[arch_curr_cpu_num()];
+    while (popped < want && pool->count > 0) {
+        list_add_tail(pages, &pool->pages[--pool->count]->queue_node);
+        popped++;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return popped;
+}
+
+// Pushes pages from |pages| into the local pool until the pool is full or the
+// list is empty. Pages that don't fit remain on |pages| and are the caller's
+// to free.
+void page_pool_push(list_node* pages) {
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    PagePool* pool = &page_pools[arch_curr_cpu_num()];
+    while (pool->count < kPagePoolDepth && !list_is_empty(pages)) {
+        pool->pages[pool->count++] = list_remove_head_type(pages, vm_page_t, queue_node);
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+}
+
+} // anonymous namespace
+
+// static
+BufferChain* BufferChain::Alloc(size_t size) {
+    size += sizeof(BufferChain);
+    const size_t num_buffers = (size + kRawDataSize - 1) / kRawDataSize;
+
+    // Gather pages, preferring the local pool over the PMM.
+    list_node pages = LIST_INITIAL_VALUE(pages);
+    const size_t num_pooled = page_pool_pop(num_buffers, &pages);
+    kcounter_add(buffer_chain_pool_hits, num_pooled);
+
+    if (num_pooled < num_buffers) {
+        // Miss: pull the shortfall plus a refill batch from the PMM in a
+        // single call and push the surplus into the local pool, so the next
+        // few messages are served without touching the PMM lock at all.
+        const size_t num_needed = num_buffers - num_pooled;
+        list_node fresh = LIST_INITIAL_VALUE(fresh);
+        size_t num_allocated = pmm_alloc_pages(num_needed + kPagePoolRefill, 0, &fresh);
+        if (unlikely(num_allocated < num_needed)) {
+            pmm_free(&fresh);
+            pmm_free(&pages);
+            return nullptr;
+        }
+        kcounter_add(buffer_chain_pool_misses, num_needed);
+        for (size_t i = 0; i < num_needed; i++) {
+            list_add_tail(&pages, list_remove_head(&fresh));
+        }
+        if (!list_is_empty(&fresh)) {
+            kcounter_add(buffer_chain_pool_refills, 1);
+            page_pool_push(&fresh);
+            if (unlikely(!list_is_empty(&fresh))) {
+                pmm_free(&fresh);
+            }
+        }
+    }
+
+    // Construct a Buffer in each page and add them to a temporary list.
+    BufferChain::BufferList temp;
+    vm_page_t* page;
+    list_for_every_entry (&pages, page, vm_page_t, queue_node) {
+        DEBUG_ASSERT(page->state == VM_PAGE_STATE_ALLOC ||
+                     page->state == VM_PAGE_STATE_IPC);
+        page->state = VM_PAGE_STATE_IPC;
+        void* va = paddr_to_physmap(page->paddr());
+        temp.push_front(new (va) BufferChain::Buffer);
+    }
+
+    // We now have a list of buffers and a list of pages.  Construct a chain inside the first
+    // buffer and give the buffers and pages to the chain.
+    BufferChain* chain = new (temp.front().data()) BufferChain(&temp, &pages);
+    DEBUG_ASSERT(list_is_empty(&pages));
+
+    return chain;
+}
+
+// static
+void BufferChain::Free(BufferChain* chain) {
+    // Remove the buffers and vm_page_t's from the chain *before* destorying it.
+    BufferChain::BufferList buffers(fbl::move(*chain->buffers()));
+    list_node pages = LIST_INITIAL_VALUE(pages);
+    list_move(&chain->pages_, &pages);
+
+    chain->~BufferChain();
+
+    while (!buffers.is_empty()) {
+        BufferChain::Buffer* buf = buffers.pop_front();
+        buf->Buffer::~Buffer();
+    }
+
+    // Return as many pages as fit to the local pool; the rest are drained
+    // back to the PMM in one bulk call.
+    page_pool_push(&pages);
+    if (!list_is_empty(&pages)) {
+        pmm_free(&pages);
+    }
+}
+
 // Makes a const void* look like a user_in_ptr<const void>.
 //
 // Sometimes we need to copy data from kernel space. KernelPtrAdapter allows us to implement the
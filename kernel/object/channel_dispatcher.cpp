@@ -13,10 +13,12 @@
 #include <trace.h>
 
 #include <lib/counters.h>
+#include <kernel/dpc.h>
 #include <kernel/event.h>
 #include <platform.h>
 #include <object/handle.h>
 #include <object/message_packet.h>
+#include <object/port_dispatcher.h>
 #include <object/process_dispatcher.h>
 #include <object/thread_dispatcher.h>
 
@@ -34,6 +36,27 @@ KCOUNTER(channel_packet_depth_16, "kernel.channel.depth.16");
 KCOUNTER(channel_packet_depth_64, "kernel.channel.depth.64");
 KCOUNTER(channel_packet_depth_256, "kernel.channel.depth.256");
 KCOUNTER(channel_packet_depth_unbounded, "kernel.channel.depth.unbounded");
+KCOUNTER(channel_deferred_frees, "kernel.channel.deferred_frees");
+
+namespace {
+
+// A channel that dies with at least this many queued messages hands its
+// queue to a DPC to free, so closing the last handle is O(1) for the caller
+// rather than stalling on thousands of MessagePacket destructions.
+constexpr uint64_t kDeferredFreeMinCount = 64;
+
+struct DeferredMessageFree {
+    dpc_t dpc = {LIST_INITIAL_CLEARED_VALUE, nullptr, nullptr};
+    fbl::DoublyLinkedList<fbl::unique_ptr<MessagePacket>> messages;
+};
+
+void DeferredMessageFreeDpc(dpc_t* d) {
+    DeferredMessageFree* deferred = reinterpret_cast<DeferredMessageFree*>(d->arg);
+    DEBUG_ASSERT(deferred);
+    delete deferred;
+}
+
+} // anonymous namespace
 
 // static
 zx_status_t ChannelDispatcher::Create(fbl::RefPtr<Dispatcher>* dispatcher0,
@@ -80,6 +103,22 @@ ChannelDispatcher::~ChannelDispatcher() {
 
     // It's not possible to do this safely in on_zero_handles()
 
+    if (message_count_ >= kDeferredFreeMinCount) {
+        // Deep queue: punt the packets to the DPC worker instead of freeing
+        // them inline. If allocating the carrier fails, fall through to the
+        // inline clear below.
+        fbl::AllocChecker ac;
+        DeferredMessageFree* deferred = new (&ac) DeferredMessageFree;
+        if (ac.check()) {
+            deferred->messages = fbl::move(messages_);
+            deferred->dpc.func = DeferredMessageFreeDpc;
+            deferred->dpc.arg = deferred;
+            kcounter_add(channel_deferred_frees, 1);
+            // bulk frees go on the low lane so they never delay timer dpcs
+            dpc_queue_low(&deferred->dpc, false);
+        }
+    }
+
     messages_.clear();
     message_count_ = 0;
 
@@ -134,6 +173,10 @@ void ChannelDispatcher::on_zero_handles_locked() {
         auto waiter = waiters_.pop_front();
         waiter->Cancel(ZX_ERR_CANCELED);
     }
+    while (!async_waiters_.is_empty()) {
+        auto waiter = async_waiters_.pop_front();
+        waiter->Complete(ZX_ERR_CANCELED, 0u, 0u);
+    }
 }
 
 // This requires holding the shared channel lock. The thread analysis
@@ -152,6 +195,10 @@ void ChannelDispatcher::OnPeerZeroHandlesLocked() {
         auto waiter = waiters_.pop_front();
         waiter->Cancel(ZX_ERR_PEER_CLOSED);
     }
+    while (!async_waiters_.is_empty()) {
+        auto waiter = async_waiters_.pop_front();
+        waiter->Complete(ZX_ERR_PEER_CLOSED, 0u, 0u);
+    }
 }
 
 zx_status_t ChannelDispatcher::Read(uint32_t* msg_size,
@@ -223,20 +270,7 @@ zx_status_t ChannelDispatcher::Call(fbl::unique_ptr<MessagePacket> msg,
             return ZX_ERR_PEER_CLOSED;
         }
 
-        // Obtain a txid.  txid 0 is not allowed, and 1..0x7FFFFFFF are reserved
-        // for userspace.  So, bump our counter and OR in the high bit.
-alloc_txid:
-        zx_txid_t txid = (++txid_) | 0x80000000;
-
-        // If there are waiting messages, ensure we have not allocated a txid
-        // that's already in use.  This is unlikely.  It's atypical for multiple
-        // threads to be invoking channel_call() on the same channel at once, so
-        // the waiter list is most commonly empty.
-        for (auto& waiter: waiters_) {
-            if (waiter.get_txid() == txid) {
-                goto alloc_txid;
-            }
-        }
+        zx_txid_t txid = AllocTxidLocked();
 
         // Install our txid in the waiter and the outbound message
         waiter->set_txid(txid);
@@ -255,6 +289,64 @@ alloc_txid:
     return ResumeInterruptedCall(waiter, deadline, reply);
 }
 
+zx_txid_t ChannelDispatcher::AllocTxidLocked() {
+    // Obtain a txid.  txid 0 is not allowed, and 1..0x7FFFFFFF are reserved
+    // for userspace.  So, bump our counter and OR in the high bit.
+alloc_txid:
+    zx_txid_t txid = (++txid_) | 0x80000000;
+
+    // If there are outstanding calls, ensure we have not allocated a txid
+    // that's already in use.  This is unlikely.  It's atypical for multiple
+    // threads to be invoking channel_call() on the same channel at once, so
+    // the waiter lists are most commonly empty.
+    for (auto& waiter: waiters_) {
+        if (waiter.get_txid() == txid) {
+            goto alloc_txid;
+        }
+    }
+    for (auto& waiter: async_waiters_) {
+        if (waiter.get_txid() == txid) {
+            goto alloc_txid;
+        }
+    }
+    return txid;
+}
+
+zx_status_t ChannelDispatcher::CallAsync(fbl::unique_ptr<MessagePacket> msg,
+                                         fbl::RefPtr<PortDispatcher> port, uint64_t key,
+                                         zx_txid_t* actual_txid) {
+    canary_.Assert();
+
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<AsyncWaiter> waiter(new (&ac) AsyncWaiter(fbl::move(port), key));
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    // Allocate the completion packet up front, outside the lock, so that
+    // delivering the completion later cannot fail.
+    zx_status_t status = waiter->AllocPacket();
+    if (status != ZX_OK)
+        return status;
+
+    AutoReschedDisable resched_disable; // Must come before the lock guard.
+    resched_disable.Disable();
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    if (!peer_)
+        return ZX_ERR_PEER_CLOSED;
+
+    zx_txid_t txid = AllocTxidLocked();
+    waiter->set_txid(txid);
+    msg->set_txid(txid);
+    *actual_txid = txid;
+
+    // As with Call, register the waiter before writing the outbound message
+    // so a fast reply cannot miss it.
+    async_waiters_.push_back(fbl::move(waiter));
+    peer_->WriteSelf(fbl::move(msg));
+    return ZX_OK;
+}
+
 zx_status_t ChannelDispatcher::ResumeInterruptedCall(MessageWaiter* waiter,
                                                      zx_time_t deadline,
                                                      fbl::unique_ptr<MessagePacket>* reply) {
@@ -316,6 +408,18 @@ void ChannelDispatcher::WriteSelf(fbl::unique_ptr<MessagePacket> msg) {
             }
         }
     }
+    if (!async_waiters_.is_empty()) {
+        // An async call reply is queued like any other message; the waiter
+        // only needs its completion packet sent before we fall through.
+        zx_txid_t txid = msg->get_txid();
+        for (auto& waiter: async_waiters_) {
+            if (waiter.get_txid() == txid) {
+                auto async_waiter = async_waiters_.erase(waiter);
+                async_waiter->Complete(ZX_OK, msg->data_size(), msg->num_handles());
+                break;
+            }
+        }
+    }
     messages_.push_back(fbl::move(msg));
     message_count_++;
     if (message_count_ > max_message_count_) {
@@ -331,6 +435,43 @@ zx_status_t ChannelDispatcher::UserSignalSelf(uint32_t clear_mask, uint32_t set_
     return ZX_OK;
 }
 
+ChannelDispatcher::AsyncWaiter::AsyncWaiter(fbl::RefPtr<PortDispatcher> port, uint64_t key)
+    : port_(fbl::move(port)), key_(key) {
+}
+
+ChannelDispatcher::AsyncWaiter::~AsyncWaiter() {
+    if (unlikely(port_packet_)) {
+        port_packet_->Free();
+    }
+}
+
+zx_status_t ChannelDispatcher::AsyncWaiter::AllocPacket() {
+    DEBUG_ASSERT(!port_packet_);
+    port_packet_ = PortDispatcher::DefaultPortAllocator()->Alloc();
+    return port_packet_ ? ZX_OK : ZX_ERR_NO_MEMORY;
+}
+
+void ChannelDispatcher::AsyncWaiter::Complete(zx_status_t status, uint32_t actual_bytes,
+                                              uint32_t actual_handles) {
+    DEBUG_ASSERT(port_packet_);
+
+    zx_port_packet_t packet = {};
+    packet.key = key_;
+    packet.type = ZX_PKT_TYPE_CHANNEL_CALL;
+    packet.status = status;
+    packet.channel_call.txid = txid_;
+    packet.channel_call.actual_bytes = actual_bytes;
+    packet.channel_call.actual_handles = actual_handles;
+    port_packet_->packet = packet;
+
+    // On success the port owns the packet; the only failure is the port
+    // having no handles left, in which case no one can observe the loss.
+    if (port_->Queue(port_packet_, 0u, 0u) != ZX_OK) {
+        port_packet_->Free();
+    }
+    port_packet_ = nullptr;
+}
+
 ChannelDispatcher::MessageWaiter::~MessageWaiter() {
     if (unlikely(channel_)) {
         channel_->RemoveWaiter(this);
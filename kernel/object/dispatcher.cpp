@@ -311,6 +311,16 @@ void Dispatcher::UpdateInternalLocked(ObserverList* obs_to_remove, zx_signals_t
     ZX_DEBUG_ASSERT(has_state_tracker());
 
     for (auto it = observers_.begin(); it != observers_.end();) {
+        // Skip observers whose watched signals don't intersect the new state;
+        // for a port with many waiters on one noisy object this avoids a
+        // virtual call into every observer for every unrelated transition.
+        // Observers with the default all-signals mask are always invoked so
+        // they also see transitions that clear the last asserted signal.
+        const zx_signals_t watched = it->watched_signals();
+        if ((watched & signals) == 0u && watched != StateObserver::kWatchAllSignals) {
+            ++it;
+            continue;
+        }
         StateObserver::Flags it_flags = it->OnStateChange(signals);
         if (it_flags & StateObserver::kNeedRemoval) {
             auto to_remove = it;
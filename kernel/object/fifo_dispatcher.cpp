@@ -65,7 +65,8 @@ FifoDispatcher::FifoDispatcher(fbl::RefPtr<PeerHolder<FifoDispatcher>> holder,
                                fbl::unique_ptr<uint8_t[]> data)
     : PeeredDispatcher(fbl::move(holder), ZX_FIFO_WRITABLE),
       elem_count_(count), elem_size_(elem_size), mask_(count - 1),
-      head_(0u), tail_(0u), data_(fbl::move(data)) {
+      head_(0u), head_committed_(0u), tail_(0u), tail_committed_(0u),
+      data_(fbl::move(data)) {
 }
 
 FifoDispatcher::~FifoDispatcher() {
@@ -99,14 +100,18 @@ zx_status_t FifoDispatcher::WriteFromUser(size_t elem_size, user_in_ptr<const ui
     TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
-    Guard<fbl::Mutex> guard{get_lock()};
-    if (!peer_)
-        return ZX_ERR_PEER_CLOSED;
-    return peer_->WriteSelfLocked(elem_size, ptr, count, actual);
+    fbl::RefPtr<FifoDispatcher> other;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        if (!peer_)
+            return ZX_ERR_PEER_CLOSED;
+        other = peer_;
+    }
+    return other->WriteSelf(elem_size, ptr, count, actual);
 }
 
-zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const uint8_t> ptr,
-                                            size_t count, size_t* actual)
+zx_status_t FifoDispatcher::WriteSelf(size_t elem_size, user_in_ptr<const uint8_t> ptr,
+                                      size_t count, size_t* actual)
     TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
@@ -115,52 +120,72 @@ zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const
     if (count == 0)
         return ZX_ERR_OUT_OF_RANGE;
 
-    uint32_t old_head = head_;
+    Guard<fbl::Mutex> write_guard{&write_lock_};
+
+    uint32_t old_head;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
 
-    // total number of available empty slots in the fifo
-    size_t avail = elem_count_ - (head_ - tail_);
+        // Total number of available empty slots in the fifo. Slots below
+        // tail_committed_ may still be being copied out; don't reuse them.
+        size_t avail = elem_count_ - (head_ - tail_committed_);
 
-    if (avail == 0)
-        return ZX_ERR_SHOULD_WAIT;
+        if (avail == 0)
+            return ZX_ERR_SHOULD_WAIT;
 
-    bool was_empty = (avail == elem_count_);
+        if (count > avail)
+            count = avail;
 
-    if (count > avail)
-        count = avail;
+        old_head = head_;
+        // due to size limitations on fifo, count will always fit in a u32
+        head_ += static_cast<uint32_t>(count);
+    }
 
-    while (count > 0) {
-        uint32_t offset = (head_ & mask_);
+    // Copy into the reserved slots with only write_lock_ held, so a
+    // concurrent reader can copy out of its own slots at the same time.
+    size_t left = count;
+    uint32_t pos = old_head;
+    while (left > 0) {
+        uint32_t offset = (pos & mask_);
 
         // number of slots from target to end, inclusive
         uint32_t n = elem_count_ - offset;
 
         // number of slots we can actually copy
-        size_t to_copy = (count > n) ? n : count;
+        size_t to_copy = (left > n) ? n : left;
 
         zx_status_t status = ptr.copy_array_from_user(&data_[offset * elem_size_],
                                                       to_copy * elem_size_);
         if (status != ZX_OK) {
-            // roll back, in case this is the second copy
+            // Roll back the reservation; as the only in-flight producer
+            // our slots are still on top.
+            Guard<fbl::Mutex> guard{get_lock()};
             head_ = old_head;
             return ZX_ERR_INVALID_ARGS;
         }
 
-        // adjust head and count
-        // due to size limitations on fifo, to_copy will always fit in a u32
-        head_ += static_cast<uint32_t>(to_copy);
-        count -= to_copy;
+        pos += static_cast<uint32_t>(to_copy);
+        left -= to_copy;
         ptr = ptr.byte_offset(to_copy * elem_size_);
     }
 
-    // if was empty, we've become readable
-    if (was_empty)
-        UpdateStateLocked(0u, ZX_FIFO_READABLE);
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
 
-    // if now full, we're no longer writable
-    if (elem_count_ == (head_ - tail_))
-        peer_->UpdateStateLocked(ZX_FIFO_WRITABLE, 0u);
+        // Publish the new elements to readers.
+        bool was_empty = (head_committed_ == tail_);
+        head_committed_ = old_head + static_cast<uint32_t>(count);
+
+        // if was empty, we've become readable
+        if (was_empty)
+            UpdateStateLocked(0u, ZX_FIFO_READABLE);
+
+        // if now full, our peer is no longer writable
+        if (peer_ && elem_count_ == (head_ - tail_committed_))
+            peer_->UpdateStateLocked(ZX_FIFO_WRITABLE, 0u);
+    }
 
-    *actual = (head_ - old_head);
+    *actual = count;
     return ZX_OK;
 }
 
@@ -174,53 +199,71 @@ zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_out_ptr<uint8_t> p
     if (count == 0)
         return ZX_ERR_OUT_OF_RANGE;
 
-    Guard<fbl::Mutex> guard{get_lock()};
+    Guard<fbl::Mutex> read_guard{&read_lock_};
 
-    uint32_t old_tail = tail_;
+    uint32_t old_tail;
+    bool was_full;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
 
-    // total number of available entries to read from the fifo
-    size_t avail = (head_ - tail_);
+        // Total number of committed entries available to read.
+        size_t avail = (head_committed_ - tail_);
 
-    if (avail == 0)
-        return peer_ ? ZX_ERR_SHOULD_WAIT : ZX_ERR_PEER_CLOSED;
+        if (avail == 0)
+            return peer_ ? ZX_ERR_SHOULD_WAIT : ZX_ERR_PEER_CLOSED;
 
-    bool was_full = (avail == elem_count_);
+        was_full = (elem_count_ == (head_ - tail_committed_));
 
-    if (count > avail)
-        count = avail;
+        if (count > avail)
+            count = avail;
 
-    while (count > 0) {
-        uint32_t offset = (tail_ & mask_);
+        old_tail = tail_;
+        // due to size limitations on fifo, count will always fit in a u32
+        tail_ += static_cast<uint32_t>(count);
+    }
+
+    // Copy out of the reserved slots with only read_lock_ held.
+    size_t left = count;
+    uint32_t pos = old_tail;
+    while (left > 0) {
+        uint32_t offset = (pos & mask_);
 
         // number of slots from target to end, inclusive
         uint32_t n = elem_count_ - offset;
 
         // number of slots we can actually copy
-        size_t to_copy = (count > n) ? n : count;
+        size_t to_copy = (left > n) ? n : left;
 
         zx_status_t status = ptr.copy_array_to_user(&data_[offset * elem_size_],
                                                     to_copy * elem_size_);
         if (status != ZX_OK) {
-            // roll back, in case this is the second copy
+            // Roll back the reservation; as the only in-flight consumer
+            // our slots are still first in line.
+            Guard<fbl::Mutex> guard{get_lock()};
             tail_ = old_tail;
             return ZX_ERR_INVALID_ARGS;
         }
 
-        // adjust tail and count
-        // due to size limitations on fifo, to_copy will always fit in a u32
-        tail_ += static_cast<uint32_t>(to_copy);
-        count -= to_copy;
+        pos += static_cast<uint32_t>(to_copy);
+        left -= to_copy;
         ptr = ptr.byte_offset(to_copy * elem_size_);
     }
 
-    // if we were full, we have become writable
-    if (was_full && peer_)
-        peer_->UpdateStateLocked(0u, ZX_FIFO_WRITABLE);
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+
+        // Release the drained slots to producers.
+        tail_committed_ = old_tail + static_cast<uint32_t>(count);
 
-    // if we've become empty, we're no longer readable
-    if ((head_ - tail_) == 0)
-        UpdateStateLocked(ZX_FIFO_READABLE, 0u);
+        // if we were full, we have become writable
+        if (was_full && peer_)
+            peer_->UpdateStateLocked(0u, ZX_FIFO_WRITABLE);
+
+        // if we've become empty, we're no longer readable
+        if (head_committed_ == tail_)
+            UpdateStateLocked(ZX_FIFO_READABLE, 0u);
+    }
 
-    *actual = (tail_ - old_tail);
+    *actual = count;
     return ZX_OK;
 }
@@ -23,7 +23,9 @@ FutexContext::~FutexContext() {
 
     // All of the threads should have removed themselves from wait queues
     // by the time the process has exited.
-    DEBUG_ASSERT(futex_table_.is_empty());
+    for (Shard& shard : shards_) {
+        DEBUG_ASSERT(shard.futex_table.is_empty());
+    }
 }
 
 zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int current_value, zx_time_t deadline) {
@@ -39,7 +41,8 @@ zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int curren
     // If a FutexWake() operation could occur between them, a userland mutex
     // operation built on top of futexes would have a race condition that
     // could miss wakeups.
-    Guard<fbl::Mutex> guard{&lock_};
+    Shard* shard = GetShard(futex_key);
+    Guard<fbl::Mutex> guard{&shard->lock};
 
     int value;
     zx_status_t result = value_ptr.copy_from_user(&value);
@@ -54,9 +57,10 @@ zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int curren
     node.set_hash_key(futex_key);
     node.SetAsSingletonList();
 
-    QueueNodesLocked(&node);
+    QueueNodesLocked(shard, &node);
 
-    // Block current thread.  This releases lock_ and does not reacquire it.
+    // Block current thread.  This releases the shard lock and does not
+    // reacquire it.
     result = node.BlockThread(guard.take(), deadline);
     if (result == ZX_OK) {
         DEBUG_ASSERT(!node.IsInQueue());
@@ -69,10 +73,21 @@ zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int curren
     // (ZX_ERR_INTERNAL_INTR_RETRY).
     //
     // We need to ensure that the thread's node is removed from the wait
-    // queue, because FutexWake() probably didn't do that.
-    Guard<fbl::Mutex> guard2{&lock_};
-    if (UnqueueNodeLocked(&node)) {
-        return result;
+    // queue, because FutexWake() probably didn't do that.  While we were
+    // blocked, FutexRequeue() may have moved the node to another futex --
+    // and therefore to another shard -- so look up the node's current shard
+    // from its (possibly updated) key, and retry if a concurrent requeue
+    // moves it again before we get the lock.
+    for (;;) {
+        Shard* cleanup_shard = GetShard(node.GetKey());
+        Guard<fbl::Mutex> guard2{&cleanup_shard->lock};
+        if (GetShard(node.GetKey()) != cleanup_shard) {
+            continue;
+        }
+        if (UnqueueNodeLocked(cleanup_shard, &node)) {
+            return result;
+        }
+        break;
     }
     // The current thread was not found on the wait queue.  This means
     // that, although we hit the deadline (or were suspended/killed), we
@@ -108,9 +123,10 @@ zx_status_t FutexContext::FutexWake(user_in_ptr<const int> value_ptr,
 
     AutoReschedDisable resched_disable; // Must come before the Guard.
     resched_disable.Disable();
-    Guard<fbl::Mutex> guard{&lock_};
+    Shard* shard = GetShard(futex_key);
+    Guard<fbl::Mutex> guard{&shard->lock};
 
-    FutexNode* node = futex_table_.erase(futex_key);
+    FutexNode* node = shard->futex_table.erase(futex_key);
     if (!node) {
         // nothing blocked on this futex if we can't find it
         return ZX_OK;
@@ -122,7 +138,7 @@ zx_status_t FutexContext::FutexWake(user_in_ptr<const int> value_ptr,
 
     if (remaining_waiters) {
         DEBUG_ASSERT(remaining_waiters->GetKey() == futex_key);
-        futex_table_.insert(remaining_waiters);
+        shard->futex_table.insert(remaining_waiters);
     }
 
     return ZX_OK;
@@ -135,8 +151,39 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
     if ((requeue_ptr.get() == nullptr) && requeue_count)
         return ZX_ERR_INVALID_ARGS;
 
-    AutoReschedDisable resched_disable; // Must come before the Guard.
-    Guard<fbl::Mutex> guard{&lock_};
+    uintptr_t wake_key = reinterpret_cast<uintptr_t>(wake_ptr.get());
+    uintptr_t requeue_key = reinterpret_cast<uintptr_t>(requeue_ptr.get());
+    if (wake_key == requeue_key) return ZX_ERR_INVALID_ARGS;
+    if (wake_key % sizeof(int) || requeue_key % sizeof(int))
+        return ZX_ERR_INVALID_ARGS;
+
+    AutoReschedDisable resched_disable; // Must come before the Guards.
+
+    Shard* wake_shard = GetShard(wake_key);
+    Shard* requeue_shard = GetShard(requeue_key);
+    if (wake_shard == requeue_shard) {
+        Guard<fbl::Mutex> guard{&wake_shard->lock};
+        return FutexRequeueLocked(wake_shard, requeue_shard, wake_ptr, wake_count,
+                                  current_value, requeue_key, requeue_count,
+                                  &resched_disable);
+    }
+
+    // GuardMultiple acquires same-class locks in address order, so two
+    // concurrent requeues spanning the same pair of shards cannot deadlock.
+    GuardMultiple<2, fbl::Mutex> guard{&wake_shard->lock, &requeue_shard->lock};
+    return FutexRequeueLocked(wake_shard, requeue_shard, wake_ptr, wake_count,
+                              current_value, requeue_key, requeue_count,
+                              &resched_disable);
+}
+
+zx_status_t FutexContext::FutexRequeueLocked(Shard* wake_shard, Shard* requeue_shard,
+                                             user_in_ptr<const int> wake_ptr, uint32_t wake_count,
+                                             int current_value, uintptr_t requeue_key,
+                                             uint32_t requeue_count,
+                                             AutoReschedDisable* resched_disable)
+    TA_NO_THREAD_SAFETY_ANALYSIS {
+    DEBUG_ASSERT(wake_shard->lock.lock().IsHeld());
+    DEBUG_ASSERT(requeue_shard->lock.lock().IsHeld());
 
     int value;
     zx_status_t result = wake_ptr.copy_from_user(&value);
@@ -144,15 +191,11 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
     if (value != current_value) return ZX_ERR_BAD_STATE;
 
     uintptr_t wake_key = reinterpret_cast<uintptr_t>(wake_ptr.get());
-    uintptr_t requeue_key = reinterpret_cast<uintptr_t>(requeue_ptr.get());
-    if (wake_key == requeue_key) return ZX_ERR_INVALID_ARGS;
-    if (wake_key % sizeof(int) || requeue_key % sizeof(int))
-        return ZX_ERR_INVALID_ARGS;
 
     // This must happen before RemoveFromHead() calls set_hash_key() on
-    // nodes below, because operations on futex_table_ look at the GetKey
+    // nodes below, because operations on the futex tables look at the GetKey
     // field of the list head nodes for wake_key and requeue_key.
-    FutexNode* node = futex_table_.erase(wake_key);
+    FutexNode* node = wake_shard->futex_table.erase(wake_key);
     if (!node) {
         // nothing blocked on this futex if we can't find it
         return ZX_OK;
@@ -160,7 +203,7 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
 
     // This must come before WakeThreads() to be useful, but we want to
     // avoid doing it before copy_from_user() in case that faults.
-    resched_disable.Disable();
+    resched_disable->Disable();
 
     if (wake_count > 0) {
         node = FutexNode::WakeThreads(node, wake_count, wake_key);
@@ -176,21 +219,21 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
 
             // now requeue our nodes to requeue_ptr mutex
             DEBUG_ASSERT(requeue_head->GetKey() == requeue_key);
-            QueueNodesLocked(requeue_head);
+            QueueNodesLocked(requeue_shard, requeue_head);
         }
     }
 
     // add any remaining nodes back to wake_key futex
     if (node != nullptr) {
         DEBUG_ASSERT(node->GetKey() == wake_key);
-        futex_table_.insert(node);
+        wake_shard->futex_table.insert(node);
     }
 
     return ZX_OK;
 }
 
-void FutexContext::QueueNodesLocked(FutexNode* head) {
-    DEBUG_ASSERT(lock_.lock().IsHeld());
+void FutexContext::QueueNodesLocked(Shard* shard, FutexNode* head) {
+    DEBUG_ASSERT(shard->lock.lock().IsHeld());
 
     FutexNode::HashTable::iterator iter;
 
@@ -198,15 +241,15 @@ void FutexContext::QueueNodesLocked(FutexNode* head) {
     // succeeds, then the current thread is first to block on this futex and we
     // are finished.  If the insert fails, then there is already a thread
     // waiting on this futex.  Add ourselves to that thread's list.
-    if (!futex_table_.insert_or_find(head, &iter))
+    if (!shard->futex_table.insert_or_find(head, &iter))
         iter->AppendList(head);
 }
 
 // This attempts to unqueue a thread (which may or may not be waiting on a
 // futex), given its FutexNode.  This returns whether the FutexNode was
 // found and removed from a futex wait queue.
-bool FutexContext::UnqueueNodeLocked(FutexNode* node) {
-    DEBUG_ASSERT(lock_.lock().IsHeld());
+bool FutexContext::UnqueueNodeLocked(Shard* shard, FutexNode* node) {
+    DEBUG_ASSERT(shard->lock.lock().IsHeld());
 
     if (!node->IsInQueue())
         return false;
@@ -217,10 +260,10 @@ bool FutexContext::UnqueueNodeLocked(FutexNode* node) {
     // FutexRequeue(), so we need to re-get the hash table key here.
     uintptr_t futex_key = node->GetKey();
 
-    FutexNode* old_head = futex_table_.erase(futex_key);
+    FutexNode* old_head = shard->futex_table.erase(futex_key);
     DEBUG_ASSERT(old_head);
     FutexNode* new_head = FutexNode::RemoveNodeFromList(old_head, node);
     if (new_head)
-        futex_table_.insert(new_head);
+        shard->futex_table.insert(new_head);
     return true;
 }
@@ -22,6 +22,7 @@
 #include <lib/oom.h>
 
 #include <object/diagnostics.h>
+#include <object/event_dispatcher.h>
 #include <object/excp_port.h>
 #include <object/job_dispatcher.h>
 #include <object/policy_manager.h>
@@ -41,10 +42,18 @@ static fbl::RefPtr<JobDispatcher> root_job;
 // not a Dispatcher, just a plain class.
 static PolicyManager* policy_manager;
 
+// The memory pressure event signaled by the OOM thread and handed out by
+// zx_system_get_event().
+static fbl::RefPtr<Dispatcher> mem_pressure_event;
+
 fbl::RefPtr<JobDispatcher> GetRootJobDispatcher() {
     return root_job;
 }
 
+fbl::RefPtr<Dispatcher> GetMemPressureEventDispatcher() {
+    return mem_pressure_event;
+}
+
 PolicyManager* GetSystemPolicyManager() {
     return policy_manager;
 }
@@ -171,16 +180,45 @@ static void oom_lowmem(size_t shortfall_bytes) {
     });
 }
 
+// Called from the OOM thread when the memory pressure level changes.
+// Pressure signals are cumulative: a level's signal stays asserted at any
+// more severe level, so a cache watching only WARNING still sees it while
+// the system is critical.
+static void oom_memlevel(oom_mem_level_t level) {
+    zx_signals_t asserted = 0;
+    if (level >= OOM_MEM_LEVEL_WARNING) {
+        asserted |= ZX_EVENT_MEMORY_PRESSURE_WARNING;
+    }
+    if (level >= OOM_MEM_LEVEL_CRITICAL) {
+        asserted |= ZX_EVENT_MEMORY_PRESSURE_CRITICAL;
+    }
+    if (level >= OOM_MEM_LEVEL_OOM) {
+        asserted |= ZX_EVENT_MEMORY_PRESSURE_OOM;
+    }
+    constexpr zx_signals_t kAllPressureSignals = ZX_EVENT_MEMORY_PRESSURE_WARNING |
+                                                 ZX_EVENT_MEMORY_PRESSURE_CRITICAL |
+                                                 ZX_EVENT_MEMORY_PRESSURE_OOM;
+    mem_pressure_event->UpdateState(kAllPressureSignals & ~asserted, asserted);
+}
+
 static void object_glue_init(uint level) TA_NO_THREAD_SAFETY_ANALYSIS {
     Handle::Init();
     root_job = JobDispatcher::CreateRootJob();
     policy_manager = PolicyManager::Create();
     PortDispatcher::Init();
+
+    zx_rights_t rights;
+    zx_status_t status = EventDispatcher::Create(0u, &mem_pressure_event, &rights);
+    ASSERT(status == ZX_OK);
+
     // Be sure to update kernel_cmdline.md if any of these defaults change.
     oom_init(cmdline_get_bool("kernel.oom.enable", true),
              ZX_SEC(cmdline_get_uint64("kernel.oom.sleep-sec", 1)),
              cmdline_get_uint64("kernel.oom.redline-mb", 50) * MB,
-             oom_lowmem);
+             cmdline_get_uint64("kernel.oom.critical-mb", 75) * MB,
+             cmdline_get_uint64("kernel.oom.warning-mb", 150) * MB,
+             oom_lowmem,
+             oom_memlevel);
 }
 
 LK_INIT_HOOK(libobject, object_glue_init, LK_INIT_LEVEL_THREADING);
@@ -6,6 +6,9 @@
 
 #include <object/handle.h>
 
+#include <arch/ops.h>
+#include <kernel/align.h>
+#include <kernel/spinlock.h>
 #include <object/dispatcher.h>
 #include <fbl/arena.h>
 #include <fbl/mutex.h>
@@ -48,6 +51,61 @@ static_assert(((3 << 30) ^ kHandleGenerationMask ^ kHandleIndexMask) ==
                   0xffffffffu,
               "Masks do not agree");
 
+// Per-cpu caches of free arena slots, so that the steady-state create and
+// destroy traffic from many processes does not serialize on (or bounce the
+// cache lines of) the global arena's lock. Slots move between a cache and
+// the arena in batches; freed slots keep their stashed base_value exactly
+// as they do on the arena free list. A cache is only touched from its own
+// cpu with interrupts disabled.
+constexpr size_t kSlotCacheDepth = 32;
+constexpr size_t kSlotBatch = 16;
+
+struct SlotCache {
+    void* slots[kSlotCacheDepth];
+    size_t count;
+} __CPU_ALIGN;
+
+SlotCache slot_caches[SMP_MAX_CPUS];
+
+void* slot_cache_pop() {
+    void* slot = nullptr;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    SlotCache* cache = &slot_caches[arch_curr_cpu_num()];
+    if (likely(cache->count > 0)) {
+        slot = cache->slots[--cache->count];
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return slot;
+}
+
+bool slot_cache_push(void* slot) {
+    bool cached = false;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    SlotCache* cache = &slot_caches[arch_curr_cpu_num()];
+    if (likely(cache->count < kSlotCacheDepth)) {
+        cache->slots[cache->count++] = slot;
+        cached = true;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return cached;
+}
+
+// Pull up to |kSlotBatch| slots out of the local cache for freeing back to
+// the arena. Returns the number of slots taken.
+size_t slot_cache_take_batch(void** slots) {
+    size_t n = 0;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    SlotCache* cache = &slot_caches[arch_curr_cpu_num()];
+    while (n < kSlotBatch && cache->count > 0) {
+        slots[n++] = cache->slots[--cache->count];
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return n;
+}
+
 }  // namespace
 
 fbl::Arena Handle::arena_;
@@ -59,7 +117,7 @@ void Handle::Init() TA_NO_THREAD_SAFETY_ANALYSIS {
 // Returns a new |base_value| based on the value stored in the free
 // arena slot pointed to by |addr|. The new value will be different
 // from the last |base_value| used by this slot.
-uint32_t Handle::GetNewBaseValue(void* addr) TA_REQ(ArenaLock::Get()) {
+uint32_t Handle::GetNewBaseValue(void* addr) TA_NO_THREAD_SAFETY_ANALYSIS {
     // Get the index of this slot within the arena.
     uint32_t handle_index = HandleToIndex(reinterpret_cast<Handle*>(addr));
     DEBUG_ASSERT((handle_index & ~kHandleIndexMask) == 0);
@@ -82,28 +140,53 @@ uint32_t Handle::GetNewBaseValue(void* addr) TA_REQ(ArenaLock::Get()) {
 // says whether this is allocation or duplication, for the error message.
 void* Handle::Alloc(const fbl::RefPtr<Dispatcher>& dispatcher,
                     const char* what, uint32_t* base_value) {
-    size_t outstanding_handles;
-    {
-        Guard<fbl::Mutex> guard{ArenaLock::Get()};
-        void* addr = arena_.Alloc();
-        outstanding_handles = arena_.DiagnosticCount();
-        if (likely(addr)) {
-            if (outstanding_handles > kHighHandleCount) {
-                // TODO: Avoid calling this for every handle after
-                // kHighHandleCount; printfs are slow and we're
-                // holding the mutex.
-                printf("WARNING: High handle count: %zu handles\n",
-                       outstanding_handles);
+    void* addr = slot_cache_pop();
+    if (unlikely(addr == nullptr)) {
+        // The local cache is empty; refill it with a batch from the arena
+        // so the next several allocations on this cpu skip the lock.
+        void* batch[kSlotBatch];
+        size_t n = 0;
+        size_t outstanding_handles;
+        {
+            Guard<fbl::Mutex> guard{ArenaLock::Get()};
+            while (n < kSlotBatch && (batch[n] = arena_.Alloc()) != nullptr) {
+                n++;
+            }
+            outstanding_handles = arena_.DiagnosticCount();
+        }
+        if (unlikely(n == 0)) {
+            printf("WARNING: Could not allocate %s handle (%zu outstanding)\n",
+                   what, outstanding_handles);
+            return nullptr;
+        }
+        if (unlikely(outstanding_handles > kHighHandleCount)) {
+            // TODO: Avoid calling this for every handle after
+            // kHighHandleCount; printfs are slow.
+            printf("WARNING: High handle count: %zu handles\n",
+                   outstanding_handles);
+        }
+        addr = batch[--n];
+        // Stash the remainder. If we migrated cpus and this cache is full,
+        // hand the leftovers straight back to the arena.
+        size_t leftover = 0;
+        while (n > 0) {
+            if (!slot_cache_push(batch[n - 1])) {
+                break;
+            }
+            n--;
+        }
+        leftover = n;
+        if (unlikely(leftover > 0)) {
+            Guard<fbl::Mutex> guard{ArenaLock::Get()};
+            for (size_t i = 0; i < leftover; i++) {
+                arena_.Free(batch[i]);
             }
-            dispatcher->increment_handle_count();
-            *base_value = GetNewBaseValue(addr);
-            return addr;
         }
     }
 
-    printf("WARNING: Could not allocate %s handle (%zu outstanding)\n",
-           what, outstanding_handles);
-    return nullptr;
+    dispatcher->increment_handle_count();
+    *base_value = GetNewBaseValue(addr);
+    return addr;
 }
 
 HandleOwner Handle::Make(fbl::RefPtr<Dispatcher> dispatcher,
@@ -177,10 +260,17 @@ void Handle::Delete() {
 
     TearDown();
 
-    bool zero_handles = false;
-    {
+    bool zero_handles = disp->decrement_handle_count();
+
+    // Park the slot in the local cpu's cache; on overflow, return a batch
+    // (plus this slot) to the arena under a single lock acquisition.
+    if (unlikely(!slot_cache_push(this))) {
+        void* batch[kSlotBatch];
+        size_t n = slot_cache_take_batch(batch);
         Guard<fbl::Mutex> guard{ArenaLock::Get()};
-        zero_handles = disp->decrement_handle_count();
+        for (size_t i = 0; i < n; i++) {
+            arena_.Free(batch[i]);
+        }
         arena_.Free(this);
     }
 
@@ -204,8 +294,6 @@ Handle* Handle::FromU32(uint32_t value) TA_NO_THREAD_SAFETY_ANALYSIS {
 }
 
 uint32_t Handle::Count(const fbl::RefPtr<const Dispatcher>& dispatcher) {
-    // Handle::ArenaLock also guards Dispatcher::handle_count_.
-    Guard<fbl::Mutex> guard{ArenaLock::Get()};
     return dispatcher->current_handle_count();
 }
 
@@ -85,56 +85,17 @@ public:
     //
     // It is the caller's responsibility to free the chain with BufferChain::Free.
     //
+    // Pages are drawn from a small free-list cache of recently freed message
+    // pages before falling back to the PMM, so short-lived messages on busy
+    // channels avoid a PMM round trip.
+    //
     // Returns nullptr on error.
-    static BufferChain* Alloc(size_t size) {
-        size += sizeof(BufferChain);
-        const size_t num_buffers = (size + kRawDataSize - 1) / kRawDataSize;
-
-        // Allocate a list of pages.
-        list_node pages = LIST_INITIAL_VALUE(pages);
-        size_t num_allocated = pmm_alloc_pages(num_buffers, 0, &pages);
-        if (unlikely(num_allocated != num_buffers)) {
-            pmm_free(&pages);
-            return nullptr;
-        }
-
-        // Construct a Buffer in each page and add them to a temporary list.
-        BufferChain::BufferList temp;
-        vm_page_t* page;
-        list_for_every_entry (&pages, page, vm_page_t, queue_node) {
-            DEBUG_ASSERT(page->state == VM_PAGE_STATE_ALLOC);
-            page->state = VM_PAGE_STATE_IPC;
-            void* va = paddr_to_physmap(page->paddr());
-            temp.push_front(new (va) BufferChain::Buffer);
-        }
-
-        // We now have a list of buffers and a list of pages.  Construct a chain inside the first
-        // buffer and give the buffers and pages to the chain.
-        BufferChain* chain = new (temp.front().data()) BufferChain(&temp, &pages);
-        DEBUG_ASSERT(list_is_empty(&pages));
-
-        return chain;
-    }
+    static BufferChain* Alloc(size_t size);
 
     // Frees |chain| and its buffers.
-    static void Free(BufferChain* chain) {
-        // Remove the buffers and vm_page_t's from the chain *before* destorying it.
-        BufferChain::BufferList buffers(fbl::move(*chain->buffers()));
-        list_node pages = LIST_INITIAL_VALUE(pages);
-        list_move(&chain->pages_, &pages);
-
-        chain->~BufferChain();
-
-        while (!buffers.is_empty()) {
-            BufferChain::Buffer* buf = buffers.pop_front();
-            buf->Buffer::~Buffer();
-        }
-        pmm_free(&pages);
-    }
+    static void Free(BufferChain* chain);
 
     // Copies |size| bytes from |src| to this chain starting at offset |dst_offset|.
-    //
-    // |dst_offset| must be in the range [0, kContig).
     zx_status_t CopyIn(user_in_ptr<const void> src, size_t dst_offset, size_t size) {
         return CopyInCommon(src, dst_offset, size);
     }
@@ -184,11 +145,16 @@ private:
     // |PTR_IN| is a user_in_ptr-like type.
     template <typename PTR_IN>
     zx_status_t CopyInCommon(PTR_IN src, size_t dst_offset, size_t size) {
-        DEBUG_ASSERT(dst_offset < buffers_.front().size());
         size_t copy_offset = dst_offset;
         size_t rem = size;
         const auto end = buffers_.end();
         for (auto iter = buffers_.begin(); rem > 0 && iter != end; ++iter) {
+            // skip whole buffers until the offset lands in one; needed for
+            // scatter-gather writes that land segments past the first buffer
+            if (copy_offset >= iter->size()) {
+                copy_offset -= iter->size();
+                continue;
+            }
             const size_t copy_len = fbl::min(rem, iter->size() - copy_offset);
             char* dst = iter->data() + copy_offset;
             const zx_status_t status = src.copy_array_from_user(dst, copy_len);
@@ -19,6 +19,9 @@
 #include <fbl/ref_counted.h>
 #include <fbl/unique_ptr.h>
 
+class PortDispatcher;
+struct PortPacket;
+
 class ChannelDispatcher final : public PeeredDispatcher<ChannelDispatcher> {
 public:
     class MessageWaiter;
@@ -46,6 +49,15 @@ public:
     zx_status_t Call(fbl::unique_ptr<MessagePacket> msg, zx_time_t deadline,
                      fbl::unique_ptr<MessagePacket>* reply) TA_NO_THREAD_SAFETY_ANALYSIS;
 
+    // Like Call, but does not block: the kernel-allocated txid is returned in
+    // |actual_txid| and the completion is delivered as a
+    // ZX_PKT_TYPE_CHANNEL_CALL packet on |port| with key |key|. The reply
+    // message itself lands in this endpoint's message queue and is retrieved
+    // with Read. Any number of async calls may be in flight on one channel.
+    zx_status_t CallAsync(fbl::unique_ptr<MessagePacket> msg,
+                          fbl::RefPtr<PortDispatcher> port, uint64_t key,
+                          zx_txid_t* actual_txid) TA_NO_THREAD_SAFETY_ANALYSIS;
+
     // Performs the wait-then-read half of Call.  This is meant for retrying
     // after an interruption caused by suspending.
     zx_status_t ResumeInterruptedCall(MessageWaiter* waiter, zx_time_t deadline,
@@ -98,14 +110,39 @@ public:
     void OnPeerZeroHandlesLocked() TA_REQ(get_lock());
 
 private:
+    // An in-flight async call. Unlike MessageWaiter there is no waiting
+    // thread: the waiter just records where the completion packet goes. The
+    // PortPacket is allocated up front so that delivering the completion
+    // (under the channel lock, possibly on the peer-close path) cannot fail.
+    // State is guarded by the owning ChannelDispatcher's lock.
+    class AsyncWaiter : public fbl::DoublyLinkedListable<fbl::unique_ptr<AsyncWaiter>> {
+    public:
+        AsyncWaiter(fbl::RefPtr<PortDispatcher> port, uint64_t key);
+        ~AsyncWaiter();
+
+        zx_status_t AllocPacket();
+        zx_txid_t get_txid() const { return txid_; }
+        void set_txid(zx_txid_t txid) { txid_ = txid; }
+        // Fills in and queues the completion packet. May only be called once.
+        void Complete(zx_status_t status, uint32_t actual_bytes, uint32_t actual_handles);
+
+    private:
+        fbl::RefPtr<PortDispatcher> port_;
+        const uint64_t key_;
+        zx_txid_t txid_ = 0;
+        PortPacket* port_packet_ = nullptr;
+    };
+
     using MessageList = fbl::DoublyLinkedList<fbl::unique_ptr<MessagePacket>>;
     using WaiterList = fbl::DoublyLinkedList<MessageWaiter*>;
+    using AsyncWaiterList = fbl::DoublyLinkedList<fbl::unique_ptr<AsyncWaiter>>;
 
     void RemoveWaiter(MessageWaiter* waiter);
 
     explicit ChannelDispatcher(fbl::RefPtr<PeerHolder<ChannelDispatcher>> holder);
     void Init(fbl::RefPtr<ChannelDispatcher> other);
     void WriteSelf(fbl::unique_ptr<MessagePacket> msg) TA_REQ(get_lock());
+    zx_txid_t AllocTxidLocked() TA_REQ(get_lock());
     zx_status_t UserSignalSelf(uint32_t clear_mask, uint32_t set_mask) TA_REQ(get_lock());
 
     fbl::Canary<fbl::magic("CHAN")> canary_;
@@ -115,4 +152,5 @@ private:
     uint64_t max_message_count_ TA_GUARDED(get_lock()) = 0;
     uint32_t txid_ TA_GUARDED(get_lock()) = 0;
     WaiterList waiters_ TA_GUARDED(get_lock());
+    AsyncWaiterList async_waiters_ TA_GUARDED(get_lock());
 };
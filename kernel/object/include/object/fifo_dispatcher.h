@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <kernel/mutex.h>
 #include <object/dispatcher.h>
 
 #include <zircon/types.h>
@@ -42,8 +43,8 @@ private:
                    uint32_t options, uint32_t elem_count, uint32_t elem_size,
                    fbl::unique_ptr<uint8_t[]> data);
     void Init(fbl::RefPtr<FifoDispatcher> other);
-    zx_status_t WriteSelfLocked(size_t elem_size, user_in_ptr<const uint8_t> ptr, size_t count,
-                                size_t* actual) TA_REQ(get_lock());
+    zx_status_t WriteSelf(size_t elem_size, user_in_ptr<const uint8_t> ptr, size_t count,
+                          size_t* actual) TA_EXCL(get_lock());
     zx_status_t UserSignalSelfLocked(uint32_t clear_mask, uint32_t set_mask) TA_REQ(get_lock());
 
     fbl::Canary<fbl::magic("FIFO")> canary_;
@@ -51,9 +52,27 @@ private:
     const uint32_t elem_size_;
     const uint32_t mask_;
 
+    // The producer and consumer indices come in reserved/committed pairs so
+    // that element copies can run outside get_lock(): a producer reserves
+    // slots by advancing head_ under the lock, copies into them with only
+    // write_lock_ held, then commits by advancing head_committed_.
+    // Consumers are symmetric with tail_/tail_committed_. Readers only see
+    // elements below head_committed_; producers only reuse slots below
+    // tail_committed_.
     uint32_t head_ TA_GUARDED(get_lock());
+    uint32_t head_committed_ TA_GUARDED(get_lock());
     uint32_t tail_ TA_GUARDED(get_lock());
-    fbl::unique_ptr<uint8_t[]> data_ TA_GUARDED(get_lock());
+    uint32_t tail_committed_ TA_GUARDED(get_lock());
+
+    // Serialize producers (resp. consumers) of data_, so commits happen in
+    // reservation order and a faulting copy can simply roll back its own
+    // reservation.
+    DECLARE_MUTEX(FifoDispatcher) write_lock_;
+    DECLARE_MUTEX(FifoDispatcher) read_lock_;
+
+    // Slot contents are protected by the reservation protocol above, not
+    // by get_lock().
+    const fbl::unique_ptr<uint8_t[]> data_;
 
     static constexpr uint32_t kMaxSizeBytes = PAGE_SIZE;
 };
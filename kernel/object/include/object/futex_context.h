@@ -10,11 +10,13 @@
 #include <zircon/types.h>
 #include <fbl/mutex.h>
 #include <kernel/lockdep.h>
+#include <kernel/thread.h>
 #include <object/futex_node.h>
 
 // FutexContext is a class that encapsulates support for futex operations.
 // FutexContext uses a hash table keyed on the futex address (a pointer to integer in userspace)
-// to contain all active futexes.
+// to contain all active futexes. The table is split into shards, each with its
+// own lock, so that operations on unrelated futexes can proceed in parallel.
 // A futex is considered active if there is one or more threads blocked on the futex.
 // After no threads are left blocked on a futex it is removed from the hash table.
 // The value in the futex hash table is the FutexNode object associated with the head
@@ -52,14 +54,38 @@ private:
     FutexContext(const FutexContext&) = delete;
     FutexContext& operator=(const FutexContext&) = delete;
 
-    void QueueNodesLocked(FutexNode* head) TA_REQ(lock_);
+    // The futex table is sharded by futex address so that operations on
+    // unrelated futexes do not all contend on a single process-wide lock.
+    struct Shard {
+        // protects futex_table
+        DECLARE_MUTEX(Shard) lock;
 
-    bool UnqueueNodeLocked(FutexNode* node) TA_REQ(lock_);
+        // Hash table for the futexes mapped to this shard.
+        // Key is futex address, value is the FutexNode for the head of
+        // futex's blocked thread list.
+        FutexNode::HashTable futex_table TA_GUARDED(lock);
+    };
 
-    // protects futex_table_
-    DECLARE_MUTEX(FutexContext) lock_;
+    static constexpr size_t kNumShards = 16;
 
-    // Hash table for futexes in this context.
-    // Key is futex address, value is the FutexNode for the head of futex's blocked thread list.
-    FutexNode::HashTable futex_table_ TA_GUARDED(lock_);
+    Shard* GetShard(uintptr_t futex_key) {
+        // Futex keys are int-aligned, so the low bits carry no information.
+        return &shards_[(futex_key >> 2) % kNumShards];
+    }
+
+    // Wakes and requeues with both shard locks held. |wake_shard| and
+    // |requeue_shard| may be the same shard, in which case the single lock is
+    // held, so this cannot be expressed with TA_REQ.
+    zx_status_t FutexRequeueLocked(Shard* wake_shard, Shard* requeue_shard,
+                                   user_in_ptr<const int> wake_ptr, uint32_t wake_count,
+                                   int current_value, uintptr_t requeue_key,
+                                   uint32_t requeue_count,
+                                   AutoReschedDisable* resched_disable)
+        TA_NO_THREAD_SAFETY_ANALYSIS;
+
+    static void QueueNodesLocked(Shard* shard, FutexNode* head) TA_REQ(shard->lock);
+
+    static bool UnqueueNodeLocked(Shard* shard, FutexNode* node) TA_REQ(shard->lock);
+
+    Shard shards_[kNumShards];
 };
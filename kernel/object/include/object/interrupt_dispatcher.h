@@ -36,7 +36,8 @@ public:
     zx_status_t Destroy();
     void InterruptHandler();
     zx_status_t Bind(fbl::RefPtr<PortDispatcher> port_dispatcher,
-                     fbl::RefPtr<InterruptDispatcher> interrupt, uint64_t key);
+                     fbl::RefPtr<InterruptDispatcher> interrupt, uint64_t key,
+                     uint32_t options);
 
 protected:
     virtual void MaskInterrupt() = 0;
@@ -53,6 +54,10 @@ protected:
     static constexpr uint32_t INTERRUPT_VIRTUAL         = (1u << 0);
     static constexpr uint32_t INTERRUPT_UNMASK_PREWAIT  = (1u << 1);
     static constexpr uint32_t INTERRUPT_MASK_POSTWAIT   = (1u << 2);
+    // Set at Bind() time by ZX_INTERRUPT_BIND_COALESCE: packets carry the
+    // count of interrupts folded into them and the most recent timestamp
+    // instead of the first.
+    static constexpr uint32_t INTERRUPT_COALESCE        = (1u << 3);
 
 private:
     event_t event_;
@@ -61,6 +66,8 @@ private:
     uint32_t flags_;
 
     zx_time_t timestamp_ TA_GUARDED(spinlock_);
+    // Number of interrupts accumulated into the next packet.
+    uint64_t pending_count_ TA_GUARDED(spinlock_) = 0;
     // Current state of the interrupt object
     InterruptState state_ TA_GUARDED(spinlock_);
     PortInterruptPacket port_packet_ TA_GUARDED(spinlock_) = {};
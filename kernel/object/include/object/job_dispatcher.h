@@ -15,6 +15,7 @@
 
 #include <zircon/types.h>
 #include <fbl/array.h>
+#include <fbl/atomic.h>
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
 #include <fbl/mutex.h>
@@ -96,6 +97,25 @@ public:
     void RemoveChildProcess(ProcessDispatcher* process);
     void Kill();
 
+    // Adjusts the aggregate handle counter of this job and all of its
+    // ancestors. Called by ProcessDispatcher as handles enter and leave its
+    // handle table.
+    void CountHandles(int64_t delta);
+
+    // Reports the aggregate counters for this job's subtree. The counters are
+    // maintained on the task and handle lifecycle paths, so this reads three
+    // atomics rather than walking the job tree.
+    void GetJobStats(zx_info_job_stats_t* stats) const;
+
+    // Adjusts the aggregate committed-page counter of this job and all of
+    // its ancestors. Called (lock-free) from the VMO commit/decommit paths
+    // via VmObjectDispatcher's memory observer.
+    void CountCommittedPages(int64_t delta);
+
+    // Reports the committed-memory counter for this job's subtree; like
+    // GetJobStats, a couple of atomic loads rather than a graph walk.
+    void GetJobMemory(zx_info_job_memory_t* memory) const;
+
     // Set policy. |mode| is is either ZX_JOB_POL_RELATIVE or ZX_JOB_POL_ABSOLUTE and
     // in_policy is an array of |count| elements.
     zx_status_t SetPolicy(uint32_t mode, const zx_policy_basic* in_policy, size_t policy_count);
@@ -146,6 +166,10 @@ private:
     void UpdateSignalsIncrementLocked() TA_REQ(get_lock());
     void UpdateSignalsDecrementLocked() TA_REQ(get_lock());
 
+    // Adjust the subtree process/job counters of this job and its ancestors.
+    void CountProcesses(int64_t delta);
+    void CountJobs(int64_t delta);
+
     template <typename T, typename Fn>
      __attribute__((warn_unused_result)) LiveRefsArray ForEachChildInLocked(
         T& children, zx_status_t* status, Fn func) TA_REQ(get_lock());
@@ -165,6 +189,15 @@ private:
     // is, there is no mechanism to mint a handle to a job via this name.
     fbl::Name<ZX_MAX_NAME_LEN> name_;
 
+    // Aggregate counters over this job's entire subtree, for
+    // ZX_INFO_JOB_STATS. Updated with relaxed atomics on the lifecycle paths
+    // (ancestors are adjusted without taking their locks), so a reader may
+    // observe the counters mid-update; they are diagnostics, not invariants.
+    fbl::atomic<int64_t> agg_handle_count_{0};
+    fbl::atomic<int64_t> agg_process_count_{0};
+    fbl::atomic<int64_t> agg_job_count_{0};
+    fbl::atomic<int64_t> agg_committed_pages_{0};
+
     // The common |get_lock()| protects all members below.
     State state_ TA_GUARDED(get_lock());
     uint32_t process_count_ TA_GUARDED(get_lock());
@@ -212,3 +245,7 @@ private:
 
 // Returns the job that is the ancestor of all other tasks.
 fbl::RefPtr<JobDispatcher> GetRootJobDispatcher();
+
+// Returns the event whose ZX_EVENT_MEMORY_PRESSURE_* signals are driven by
+// the OOM thread. Handed out by zx_system_get_event().
+fbl::RefPtr<Dispatcher> GetMemPressureEventDispatcher();
@@ -57,17 +57,32 @@ public:
     size_t max_size() const { return kSizeMax; }
 
 private:
-    // An MBuf is a small fixed-size chainable memory buffer.
+    // An MBuf is a small fixed-size chainable memory buffer. For bulk
+    // stream writes its payload may instead live in a separately allocated
+    // page-sized block, so that big transfers touch fewer buffers and make
+    // fewer user copy calls per byte.
     struct MBuf : public fbl::SinglyLinkedListable<MBuf*> {
         // 8 for the linked list and 4 for the explicit uint32_t fields.
         static constexpr size_t kHeaderSize = 8 + (4 * 4);
         // 16 is for the malloc header.
         static constexpr size_t kMallocSize = 2048 - 16;
         static constexpr size_t kPayloadSize = kMallocSize - kHeaderSize;
+        // Size of an external payload block; one page on all supported
+        // architectures.
+        static constexpr size_t kBlockSize = 4096;
+
+        // Set when the payload lives in |block_| rather than |data_|.
+        static constexpr uint32_t kFlagExternal = 1u;
 
         // Returns number of bytes of free space in this MBuf.
         size_t rem() const;
 
+        // Returns the payload buffer and its total capacity.
+        char* payload() { return (flags_ & kFlagExternal) ? block_ : data_; }
+        size_t capacity() const {
+            return (flags_ & kFlagExternal) ? kBlockSize : kPayloadSize;
+        }
+
         uint32_t off_ = 0u;
         uint32_t len_ = 0u;
         // pkt_len_ is set to the total number of bytes in a packet
@@ -76,18 +91,24 @@ private:
         //
         // Always 0 in ZX_SOCKET_STREAM mode.
         uint32_t pkt_len_ = 0u;
-        uint32_t unused_;
-        char data_[kPayloadSize] = {0};
-        // TODO: maybe union data_ with char* blocks for large messages
+        uint32_t flags_ = 0u;
+        union {
+            char data_[kPayloadSize] = {0};
+            char* block_;
+        };
     };
     static_assert(sizeof(MBuf) == MBuf::kMallocSize, "");
 
     static constexpr size_t kSizeMax = 128 * MBuf::kPayloadSize;
 
-    MBuf* AllocMBuf();
+    // Allocates an MBuf, preferring the matching freelist. When |external|
+    // is true the payload is a |kBlockSize| block.
+    MBuf* AllocMBuf(bool external);
     void FreeMBuf(MBuf* buf);
+    void DestroyMBuf(MBuf* buf);
 
     fbl::SinglyLinkedList<MBuf*> freelist_;
+    fbl::SinglyLinkedList<MBuf*> block_freelist_;
     fbl::SinglyLinkedList<MBuf*> tail_;
     MBuf* head_ = nullptr;;
     size_t size_ = 0u;
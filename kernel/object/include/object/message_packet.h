@@ -37,6 +37,12 @@ public:
     static zx_status_t Create(const void* data, uint32_t data_size,
                               uint32_t num_handles,
                               fbl::unique_ptr<MessagePacket>* msg);
+    // Creates a message packet by concatenating the user buffers described by
+    // |iovecs| (already copied into kernel space; the buffer pointers within
+    // still refer to user memory).
+    static zx_status_t Create(const zx_channel_iovec_t* iovecs, uint32_t num_iovecs,
+                              uint32_t num_handles,
+                              fbl::unique_ptr<MessagePacket>* msg);
 
     uint32_t data_size() const { return data_size_; }
 
@@ -12,6 +12,7 @@
 
 #include <zircon/syscalls/port.h>
 #include <zircon/types.h>
+#include <fbl/atomic.h>
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
 #include <fbl/mutex.h>
@@ -104,6 +105,7 @@ struct PortPacket final : public fbl::DoublyLinkedListable<PortPacket*> {
 
 struct PortInterruptPacket final : public fbl::DoublyLinkedListable<PortInterruptPacket*> {
     zx_time_t timestamp;
+    uint64_t count;
     uint64_t key;
 };
 
@@ -174,7 +176,8 @@ public:
 
     zx_status_t Queue(PortPacket* port_packet, zx_signals_t observed, uint64_t count);
     zx_status_t QueueUser(const zx_port_packet_t& packet);
-    bool QueueInterruptPacket(PortInterruptPacket* port_packet, zx_time_t timestamp);
+    bool QueueInterruptPacket(PortInterruptPacket* port_packet, zx_time_t timestamp,
+                              uint64_t count);
     zx_status_t Dequeue(zx_time_t deadline, zx_port_packet_t* packet);
     bool RemoveInterruptPacket(PortInterruptPacket* port_packet);
 
@@ -212,7 +215,9 @@ private:
     bool zero_handles_ TA_GUARDED(get_lock());
 
     // Next three members handle the object, manual and exception notifications.
-    size_t num_packets_ TA_GUARDED(get_lock());
+    // |num_packets_| is written under the lock but read without it by the
+    // Dequeue() fast path, hence atomic.
+    fbl::atomic<size_t> num_packets_;
     fbl::DoublyLinkedList<PortPacket*> packets_ TA_GUARDED(get_lock());
     fbl::DoublyLinkedList<fbl::RefPtr<ExceptionPort>> eports_ TA_GUARDED(get_lock());
     // Next two members handle the interrupt notifications.
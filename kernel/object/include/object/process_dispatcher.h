@@ -18,6 +18,7 @@
 #include <zircon/syscalls/object.h>
 #include <zircon/types.h>
 #include <fbl/array.h>
+#include <fbl/atomic.h>
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
 #include <fbl/mutex.h>
@@ -274,6 +275,10 @@ private:
     ProcessDispatcher& operator=(const ProcessDispatcher&) = delete;
 
 
+    // Validates a handle for the lock-free lookup paths; the caller must
+    // hold the handle's shard lock rather than |handle_table_lock_|.
+    bool IsHandleValidNoLock(const Handle* handle, zx_handle_t handle_value) const;
+
     zx_status_t GetDispatcherInternal(zx_handle_t handle_value, fbl::RefPtr<Dispatcher>* dispatcher,
                                       zx_rights_t* rights);
 
@@ -317,6 +322,9 @@ private:
     // our list of handles
     mutable DECLARE_MUTEX(ProcessDispatcher) handle_table_lock_; // protects |handles_|.
     fbl::DoublyLinkedList<Handle*> handles_ TA_GUARDED(handle_table_lock_);
+    // Tracks |handles_|'s length so the whole table can be subtracted from
+    // the job's aggregate counters in one step on process death.
+    fbl::atomic<uint32_t> handle_count_{0};
 
     FutexContext futex_context_;
 
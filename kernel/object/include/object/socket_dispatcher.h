@@ -57,6 +57,13 @@ public:
     size_t TransmitBufferMax() const;
     size_t TransmitBufferSize() const;
 
+    // While the threshold is nonzero, ZX_SOCKET_WRITE_THRESHOLD is asserted
+    // on this endpoint only when at least that many bytes fit in the
+    // transmit buffer. A threshold of zero (the default) deasserts the
+    // signal.
+    size_t GetWriteThreshold() const;
+    zx_status_t SetWriteThreshold(size_t threshold);
+
     zx_status_t CheckShareable(SocketDispatcher* to_send);
 
     struct ControlMsg {
@@ -79,6 +86,7 @@ private:
     zx_status_t UserSignalSelfLocked(uint32_t clear_mask, uint32_t set_mask) TA_REQ(get_lock());
     zx_status_t ShutdownOtherLocked(uint32_t how) TA_REQ(get_lock());
     zx_status_t ShareSelfLocked(HandleOwner h) TA_REQ(get_lock());
+    void UpdateWriteThresholdSignalLocked() TA_REQ(get_lock());
 
     bool is_full() const TA_REQ(get_lock()) { return data_.is_full(); }
     bool is_empty() const TA_REQ(get_lock()) { return data_.is_empty(); }
@@ -93,4 +101,5 @@ private:
     size_t control_msg_len_ TA_GUARDED(get_lock());
     HandleOwner accept_queue_ TA_GUARDED(get_lock());
     bool read_disabled_ TA_GUARDED(get_lock());
+    size_t write_threshold_ TA_GUARDED(get_lock());
 };
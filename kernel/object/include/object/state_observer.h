@@ -32,6 +32,16 @@ public:
 
     typedef unsigned Flags;
 
+    // Mask value indicating interest in every signal transition, including
+    // those that leave no signals asserted.
+    static constexpr zx_signals_t kWatchAllSignals = ~0u;
+
+    // Signals this observer is interested in. UpdateState() skips the
+    // OnStateChange() callback for observers whose mask doesn't intersect
+    // the new signal state, so observers with a narrow trigger set aren't
+    // visited when unrelated signals are raised.
+    zx_signals_t watched_signals() const { return watched_signals_; }
+
     // Bitmask of return values for On...() methods
     static constexpr Flags kNeedRemoval = 1;
     static constexpr Flags kHandled = 2;
@@ -69,11 +79,18 @@ public:
     virtual void OnRemoved() {}
 
 protected:
+    // For observers that only act when one of |watched_signals| is asserted.
+    // The mask must not change while the observer is registered.
+    explicit StateObserver(zx_signals_t watched_signals)
+        : watched_signals_(watched_signals) {}
+
     ~StateObserver() {}
 
 private:
     fbl::Canary<fbl::magic("SOBS")> canary_;
 
+    const zx_signals_t watched_signals_ = kWatchAllSignals;
+
     friend struct StateObserverListTraits;
     fbl::DoublyLinkedListNodeState<StateObserver*> state_observer_list_node_state_;
 };
@@ -11,6 +11,7 @@
 #include <arch/exception.h>
 #include <kernel/dpc.h>
 #include <kernel/event.h>
+#include <kernel/seqcount.h>
 #include <kernel/thread.h>
 #include <vm/vm_address_region.h>
 #include <object/channel_dispatcher.h>
@@ -21,6 +22,7 @@
 #include <zircon/compiler.h>
 #include <zircon/syscalls/debug.h>
 #include <zircon/syscalls/exception.h>
+#include <zircon/syscalls/profile.h>
 #include <zircon/types.h>
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
@@ -190,6 +192,7 @@ public:
                            size_t buffer_len);
     // Profile support
     zx_status_t SetPriority(int32_t priority);
+    zx_status_t SetDeadline(const zx_profile_deadline_t& params);
 
     // For ChannelDispatcher use.
     ChannelDispatcher::MessageWaiter* GetMessageWaiter() { return &channel_waiter_; }
@@ -234,6 +237,11 @@ private:
     // change states of the object, do what is appropriate for the state transition
     void SetStateLocked(State) TA_REQ(get_lock());
 
+    // Re-publish the seqlock-protected snapshot read by GetInfoForUserspace().
+    // Must be called whenever |state_|, |exception_status_| or
+    // |exception_wait_port_| change.
+    void UpdateInfoSnapshotLocked() TA_REQ(get_lock());
+
     fbl::Canary<fbl::magic("THRD")> canary_;
 
     // The containing process holds a list of all its threads.
@@ -250,6 +258,14 @@ private:
 
     State state_ TA_GUARDED(get_lock()) = State::INITIAL;
 
+    // Seqlock-published snapshot of the state reported by ZX_INFO_THREAD.
+    // Writers re-publish under |get_lock()| on every state and exception
+    // transition so that monitoring reads never take the dispatcher lock
+    // and cannot contend with this thread's hot path.
+    SeqCount info_seq_;
+    State info_state_ = State::INITIAL;
+    ExceptionPort::Type info_excp_port_type_ = ExceptionPort::Type::NONE;
+
     // This is only valid while |state_ == State::RUNNING|.
     // This is just a volatile, and not something like an atomic, because
     // the only writer is the thread itself, and readers can just pick up
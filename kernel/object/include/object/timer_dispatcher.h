@@ -7,9 +7,11 @@
 #pragma once
 
 #include <kernel/dpc.h>
+#include <kernel/lockdep.h>
 #include <kernel/timer.h>
 #include <zircon/types.h>
 #include <fbl/canary.h>
+#include <fbl/intrusive_double_list.h>
 #include <fbl/mutex.h>
 #include <object/dispatcher.h>
 
@@ -38,6 +40,13 @@ private:
     void SetTimerLocked(bool cancel_first) TA_REQ(get_lock());
     bool CancelTimerLocked() TA_REQ(get_lock());
 
+    // Aligns |deadline| to a compatible deadline already registered by
+    // another active timer, if one falls inside this timer's slack window,
+    // and registers the result. Returns the (possibly snapped) deadline.
+    zx_time_t AlignDeadline(zx_time_t deadline, zx_duration_t slack);
+    // Removes this timer's deadline from the coalescing registry.
+    void UnregisterDeadline();
+
     fbl::Canary<fbl::magic("TIMR")> canary_;
     const slack_mode slack_mode_;
     dpc_t timer_dpc_;
@@ -45,4 +54,21 @@ private:
     zx_duration_t slack_ TA_GUARDED(get_lock());
     bool cancel_pending_ TA_GUARDED(get_lock());
     timer_t timer_ TA_GUARDED(get_lock());
+
+    // Per-node state for the global deadline-coalescing registry. The kernel
+    // timer queues coalesce via slack only within one cpu's queue; the
+    // registry lets unrelated dispatcher timers share a deadline regardless
+    // of which cpu their kernel timer lands on.
+    using CoalesceNodeState = fbl::DoublyLinkedListNodeState<TimerDispatcher*>;
+    struct CoalesceListTraits {
+        static CoalesceNodeState& node_state(TimerDispatcher& timer) {
+            return timer.coalesce_node_;
+        }
+    };
+    using CoalesceList = fbl::DoublyLinkedList<TimerDispatcher*, CoalesceListTraits>;
+    DECLARE_SINGLETON_MUTEX(CoalesceLock);
+    static CoalesceList coalesce_list_ TA_GUARDED(CoalesceLock::Get());
+
+    CoalesceNodeState coalesce_node_;
+    zx_time_t coalesce_deadline_ TA_GUARDED(CoalesceLock::Get()) = 0u;
 };
@@ -8,6 +8,7 @@
 
 #include <zircon/types.h>
 
+#include <fbl/atomic.h>
 #include <fbl/canary.h>
 #include <object/dispatcher.h>
 
@@ -15,8 +16,11 @@
 #include <sys/types.h>
 #include <vm/vm_object.h>
 
+class JobDispatcher;
+
 class VmObjectDispatcher final : public SoloDispatcher<VmObjectDispatcher>,
-                                 public VmObjectChildObserver {
+                                 public VmObjectChildObserver,
+                                 public VmObjectMemoryObserver {
 public:
     static zx_status_t Create(fbl::RefPtr<VmObject> vmo,
                               fbl::RefPtr<Dispatcher>* dispatcher,
@@ -27,6 +31,15 @@ public:
     void OnZeroChild() final;
     void OnOneChild() final;
 
+    // VmObjectMemoryObserver implementation; forwards committed-page deltas
+    // into |job_|'s rollup counters. Called under the VMO lock.
+    void OnPagesCommitted(int64_t delta) final;
+
+    // Attributes this VMO's committed pages to |job| (the creating
+    // process's job) for ZX_INFO_JOB_MEMORY. Called once, right after
+    // Create, on the user-facing creation paths.
+    void AttributeMemory(fbl::RefPtr<JobDispatcher> job);
+
     // SoloDispatcher implementation.
     zx_obj_type_t get_type() const final { return ZX_OBJ_TYPE_VMO; }
     bool has_state_tracker() const final { return true; }
@@ -49,18 +62,33 @@ public:
 
     zx_status_t SetMappingCachePolicy(uint32_t cache_policy);
 
+    // Commits |size| bytes at |offset| on a low-priority kernel thread,
+    // asserting ZX_VMO_COMMIT_COMPLETE when the operation finishes. At most
+    // one asynchronous commit may be in flight per VMO handle's dispatcher.
+    zx_status_t CommitRangeAsync(uint64_t offset, uint64_t size);
+
     const fbl::RefPtr<VmObject>& vmo() const { return vmo_; }
 
 private:
     explicit VmObjectDispatcher(fbl::RefPtr<VmObject> vmo);
 
+    static int AsyncCommitWorker(void* arg);
+
     fbl::Canary<fbl::magic("VMOD")> canary_;
 
+    // True while an asynchronous commit is in flight.
+    fbl::atomic<bool> async_commit_in_flight_{false};
+
     // The 'const' here is load bearing; we give a raw pointer to
     // ourselves to |vmo_| so we have to ensure we don't reset vmo_
     // except during destruction.
     fbl::RefPtr<VmObject> const vmo_;
 
+    // The job that committed pages are attributed to; set at most once by
+    // AttributeMemory before the dispatcher is installed in a handle table,
+    // cleared only by the destructor.
+    fbl::RefPtr<JobDispatcher> job_;
+
     // VMOs do not currently maintain any VMO-specific signal state,
     // but do allow user signals to be set. In addition, the CookieJar
     // shares the same lock.
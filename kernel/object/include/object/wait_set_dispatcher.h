@@ -0,0 +1,133 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <object/dispatcher.h>
+#include <object/state_observer.h>
+
+#include <zircon/types.h>
+#include <fbl/canary.h>
+#include <fbl/intrusive_double_list.h>
+#include <fbl/ref_ptr.h>
+#include <kernel/event.h>
+
+#include <sys/types.h>
+
+// The WaitSetDispatcher implements a persistent alternative to
+// zx_object_wait_many(): handles are registered once with waitset_add() and a
+// thread then blocks in waitset_wait() repeatedly. Each registered entry stays
+// attached to its object's state tracker across wakeups, so the steady-state
+// cost of a wakeup is proportional to the number of *ready* entries rather
+// than the number of *watched* handles, which is what a select-style loop over
+// zx_object_wait_many() pays.
+//
+// Entries are level triggered: an entry is reported by waitset_wait() for as
+// long as one of its watched signals is asserted (or its handle has been
+// closed), and silently drops off the ready list when the signals deassert.
+//
+// Locking: entry callbacks (OnStateChange() et al.) run under the *watched*
+// object's state tracker lock and acquire this dispatcher's lock inside it.
+// The waitset therefore never calls into a watched object while holding its
+// own lock, and has no state tracker of its own so it cannot itself be
+// watched, which keeps the lock ordering acyclic.
+class WaitSetDispatcher final : public SoloDispatcher<WaitSetDispatcher> {
+public:
+    static zx_status_t Create(uint32_t options, fbl::RefPtr<Dispatcher>* dispatcher,
+                              zx_rights_t* rights);
+
+    ~WaitSetDispatcher() final;
+    zx_obj_type_t get_type() const final { return ZX_OBJ_TYPE_WAIT_SET; }
+    void on_zero_handles() final;
+
+    // Registers |handle|'s object under |key|. The entry observes |signals|
+    // until it is removed. Called under the handle table lock.
+    zx_status_t AddEntry(uint64_t key, Handle* handle, zx_signals_t signals);
+
+    // Unregisters the entry added under |key|.
+    zx_status_t RemoveEntry(uint64_t key);
+
+    // Blocks until at least one entry is ready, then fills |results| with up
+    // to |max_results| ready entries and sets |num_results| to the count. An
+    // entry whose handle was closed is reported with status ZX_ERR_CANCELED.
+    zx_status_t Wait(zx_time_t deadline, uint32_t max_results,
+                     zx_waitset_result_t* results, uint32_t* num_results);
+
+private:
+    // One watched handle. The entry is a StateObserver registered with the
+    // watched object's state tracker for the whole time it is in the set; it
+    // watches all signals (rather than just |watching_|) because it must also
+    // see transitions that *deassert* its trigger signals to fall off the
+    // ready list.
+    class Entry final : public StateObserver, public fbl::DoublyLinkedListable<Entry*> {
+    public:
+        // kAddPending covers the window in AddEntry() between publishing the
+        // entry in |entries_| and completing registration with the watched
+        // object; RemoveEntry() refuses to touch such an entry.
+        enum class State { kAddPending, kAdded };
+
+        Entry(WaitSetDispatcher* wait_set, uint64_t key, const Handle* handle,
+              fbl::RefPtr<Dispatcher> dispatcher, zx_signals_t watching);
+        ~Entry() = default;
+
+        uint64_t key() const { return key_; }
+        const fbl::RefPtr<Dispatcher>& dispatcher() const { return dispatcher_; }
+
+        // The following are all guarded by the owning waitset's lock.
+        State state() const { return state_; }
+        void set_state(State state) { state_ = state; }
+        zx_signals_t observed() const { return observed_; }
+        bool canceled() const { return canceled_; }
+        bool InReadyList() const { return ready_node_.InContainer(); }
+
+        struct ReadyListTraits {
+            static fbl::DoublyLinkedListNodeState<Entry*>& node_state(Entry& entry) {
+                return entry.ready_node_;
+            }
+        };
+
+    private:
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        // StateObserver overrides. All run under the watched object's state
+        // tracker lock.
+        Flags OnInitialize(zx_signals_t initial_state, const CountInfo* cinfo) final;
+        Flags OnStateChange(zx_signals_t new_state) final;
+        Flags OnCancel(const Handle* handle) final;
+
+        WaitSetDispatcher* const wait_set_;
+        const uint64_t key_;
+        const Handle* const handle_;
+        // Keeps the watched object alive while the entry is registered.
+        const fbl::RefPtr<Dispatcher> dispatcher_;
+        const zx_signals_t watching_;
+
+        State state_ = State::kAddPending;
+        zx_signals_t observed_ = 0u;
+        bool canceled_ = false;
+
+        fbl::DoublyLinkedListNodeState<Entry*> ready_node_;
+    };
+
+    WaitSetDispatcher();
+
+    Entry* FindLocked(uint64_t key) TA_REQ(get_lock());
+
+    // Moves |entry| on/off |ready_| and keeps |event_| in sync with whether
+    // any entry is ready.
+    void MakeReadyLocked(Entry* entry) TA_REQ(get_lock());
+    void MakeNotReadyLocked(Entry* entry) TA_REQ(get_lock());
+
+    fbl::Canary<fbl::magic("WTST")> canary_;
+
+    // Signaled while |ready_| is non-empty.
+    Event event_;
+
+    bool zero_handles_ TA_GUARDED(get_lock()) = false;
+    fbl::DoublyLinkedList<Entry*> entries_ TA_GUARDED(get_lock());
+    fbl::DoublyLinkedList<Entry*, Entry::ReadyListTraits> ready_ TA_GUARDED(get_lock());
+};
@@ -30,6 +30,7 @@ zx_status_t InterruptDispatcher::WaitForInterrupt(zx_time_t* out_timestamp) {
                 state_ = InterruptState::NEEDACK;
                 *out_timestamp = timestamp_;
                 timestamp_ = 0;
+                pending_count_ = 0;
                 return event_unsignal(&event_);
             case InterruptState::NEEDACK:
                 if (flags_ & INTERRUPT_UNMASK_PREWAIT) {
@@ -62,11 +63,13 @@ zx_status_t InterruptDispatcher::WaitForInterrupt(zx_time_t* out_timestamp) {
 }
 
 bool InterruptDispatcher::SendPacketLocked(zx_time_t timestamp) {
-    bool status = port_dispatcher_->QueueInterruptPacket(&port_packet_, timestamp);
+    bool status = port_dispatcher_->QueueInterruptPacket(&port_packet_, timestamp,
+                                                         pending_count_);
     if (flags_ & INTERRUPT_MASK_POSTWAIT) {
         MaskInterrupt();
     }
     timestamp_ = 0;
+    pending_count_ = 0;
     return status;
 }
 
@@ -87,16 +90,19 @@ zx_status_t InterruptDispatcher::Trigger(zx_time_t timestamp) {
     resched_disable.Disable();
     Guard<SpinLock, IrqSave> guard{&spinlock_};
 
-    // only record timestamp if this is the first signal since we started waiting
-    if (!timestamp_) {
+    // In coalescing mode the next packet carries the most recent timestamp;
+    // otherwise only record it if this is the first signal since we started
+    // waiting.
+    if ((flags_ & INTERRUPT_COALESCE) || !timestamp_) {
         timestamp_ = timestamp;
     }
+    pending_count_++;
     if (state_ == InterruptState::DESTROYED) {
         return ZX_ERR_CANCELED;
     }
     if (state_ == InterruptState::NEEDACK && port_dispatcher_) {
-        // Cannot trigger a interrupt without ACK
-        // only record timestamp if this is the first signal since we started waiting
+        // Cannot trigger a interrupt without ACK; the signal has been
+        // accumulated into the packet sent at ACK time.
         return ZX_OK;
     }
 
@@ -113,10 +119,13 @@ zx_status_t InterruptDispatcher::Trigger(zx_time_t timestamp) {
 void InterruptDispatcher::InterruptHandler() {
     Guard<SpinLock, IrqSave> guard{&spinlock_};
 
-    // only record timestamp if this is the first IRQ since we started waiting
-    if (!timestamp_) {
+    // In coalescing mode the next packet carries the most recent timestamp;
+    // otherwise only record it if this is the first IRQ since we started
+    // waiting.
+    if ((flags_ & INTERRUPT_COALESCE) || !timestamp_) {
         timestamp_ = current_time();
     }
+    pending_count_++;
     if (state_ == InterruptState::NEEDACK && port_dispatcher_) {
         return;
     }
@@ -159,7 +168,8 @@ zx_status_t InterruptDispatcher::Destroy() {
 }
 
 zx_status_t InterruptDispatcher::Bind(fbl::RefPtr<PortDispatcher> port_dispatcher,
-                                      fbl::RefPtr<InterruptDispatcher> interrupt, uint64_t key) {
+                                      fbl::RefPtr<InterruptDispatcher> interrupt, uint64_t key,
+                                      uint32_t options) {
     Guard<SpinLock, IrqSave> guard{&spinlock_};
     if (state_ == InterruptState::DESTROYED) {
         return ZX_ERR_CANCELED;
@@ -171,6 +181,9 @@ zx_status_t InterruptDispatcher::Bind(fbl::RefPtr<PortDispatcher> port_dispatche
         return ZX_ERR_BAD_STATE;
     }
 
+    if (options & ZX_INTERRUPT_BIND_COALESCE) {
+        flags_ |= INTERRUPT_COALESCE;
+    }
     port_dispatcher_ = fbl::move(port_dispatcher);
     port_packet_.key = key;
     return ZX_OK;
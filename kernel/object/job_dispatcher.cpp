@@ -207,6 +207,7 @@ bool JobDispatcher::AddChildProcess(const fbl::RefPtr<ProcessDispatcher>& proces
         return false;
     procs_.push_back(process.get());
     ++process_count_;
+    CountProcesses(1);
     UpdateSignalsIncrementLocked();
     return true;
 }
@@ -220,6 +221,7 @@ bool JobDispatcher::AddChildJob(const fbl::RefPtr<JobDispatcher>& job) {
 
     jobs_.push_back(job.get());
     ++job_count_;
+    CountJobs(1);
     UpdateSignalsIncrementLocked();
     return true;
 }
@@ -234,6 +236,7 @@ void JobDispatcher::RemoveChildProcess(ProcessDispatcher* process) {
         return;
     procs_.erase(*process);
     --process_count_;
+    CountProcesses(-1);
     UpdateSignalsDecrementLocked();
 }
 
@@ -245,9 +248,57 @@ void JobDispatcher::RemoveChildJob(JobDispatcher* job) {
         return;
     jobs_.erase(*job);
     --job_count_;
+    CountJobs(-1);
     UpdateSignalsDecrementLocked();
 }
 
+void JobDispatcher::CountHandles(int64_t delta) {
+    canary_.Assert();
+
+    for (JobDispatcher* job = this; job != nullptr; job = job->parent_.get())
+        job->agg_handle_count_.fetch_add(delta, fbl::memory_order_relaxed);
+}
+
+void JobDispatcher::CountProcesses(int64_t delta) {
+    for (JobDispatcher* job = this; job != nullptr; job = job->parent_.get())
+        job->agg_process_count_.fetch_add(delta, fbl::memory_order_relaxed);
+}
+
+void JobDispatcher::CountJobs(int64_t delta) {
+    for (JobDispatcher* job = this; job != nullptr; job = job->parent_.get())
+        job->agg_job_count_.fetch_add(delta, fbl::memory_order_relaxed);
+}
+
+void JobDispatcher::GetJobStats(zx_info_job_stats_t* stats) const {
+    canary_.Assert();
+
+    // The counters can be transiently negative from a reader's point of view
+    // (an ancestor's decrement can land before its descendant's increment);
+    // clamp rather than report a huge unsigned value.
+    auto clamp = [](int64_t value) -> uint64_t {
+        return value > 0 ? static_cast<uint64_t>(value) : 0u;
+    };
+    stats->handle_count = clamp(agg_handle_count_.load(fbl::memory_order_relaxed));
+    stats->process_count = clamp(agg_process_count_.load(fbl::memory_order_relaxed));
+    stats->job_count = clamp(agg_job_count_.load(fbl::memory_order_relaxed));
+}
+
+void JobDispatcher::CountCommittedPages(int64_t delta) {
+    canary_.Assert();
+
+    for (JobDispatcher* job = this; job != nullptr; job = job->parent_.get())
+        job->agg_committed_pages_.fetch_add(delta, fbl::memory_order_relaxed);
+}
+
+void JobDispatcher::GetJobMemory(zx_info_job_memory_t* memory) const {
+    canary_.Assert();
+
+    // See GetJobStats for why the counter is clamped.
+    int64_t pages = agg_committed_pages_.load(fbl::memory_order_relaxed);
+    memory->committed_pages = pages > 0 ? static_cast<uint64_t>(pages) : 0u;
+    memory->committed_bytes = memory->committed_pages * PAGE_SIZE;
+}
+
 void JobDispatcher::UpdateSignalsDecrementLocked() {
     canary_.Assert();
 
@@ -372,34 +423,55 @@ bool JobDispatcher::EnumerateChildren(JobEnumerator* je, bool recurse) {
     LiveRefsArray jobs_refs;
     LiveRefsArray proc_refs;
 
-    zx_status_t result = ZX_OK;
+    zx_status_t proc_result = ZX_OK;
+    zx_status_t job_result = ZX_OK;
 
+    // Take a snapshot of the child lists; the lock is held only long enough
+    // to gather refs, so enumerating a large tree (or faulting while copying
+    // results out to userspace) never blocks job/process lifecycle
+    // operations. Children that come or go after the snapshot are simply
+    // missed or skipped by this enumeration.
     {
         Guard<fbl::Mutex> guard{get_lock()};
 
         proc_refs = ForEachChildInLocked(
-            procs_, &result, [&](fbl::RefPtr<ProcessDispatcher> proc) {
-                return je->OnProcess(proc.get()) ? ZX_OK : ZX_ERR_STOP;
-            });
-        if (result != ZX_OK) {
+            procs_, &proc_result, [](const fbl::RefPtr<ProcessDispatcher>&) { return ZX_OK; });
+        jobs_refs = ForEachChildInLocked(
+            jobs_, &job_result, [](const fbl::RefPtr<JobDispatcher>&) { return ZX_OK; });
+    }
+    if (proc_result != ZX_OK || job_result != ZX_OK) {
+        return false;
+    }
+
+    // Run the callbacks with no locks held. The refs arrays may have unused
+    // trailing slots if children died before the snapshot upgraded them.
+    for (auto& ref : proc_refs) {
+        if (!ref) {
+            break;
+        }
+        auto proc = DownCastDispatcher<ProcessDispatcher>(&ref);
+        if (!je->OnProcess(proc.get())) {
             return false;
         }
+    }
 
-        jobs_refs = ForEachChildInLocked(jobs_, &result, [&](fbl::RefPtr<JobDispatcher> job) {
-            if (!je->OnJob(job.get())) {
-                return ZX_ERR_STOP;
-            }
-            if (recurse) {
-                // TODO(kulakowski): This recursive call can overflow the stack.
-                return job->EnumerateChildren(je, /* recurse */ true)
-                           ? ZX_OK
-                           : ZX_ERR_STOP;
+    for (auto& ref : jobs_refs) {
+        if (!ref) {
+            break;
+        }
+        auto job = DownCastDispatcher<JobDispatcher>(&ref);
+        if (!je->OnJob(job.get())) {
+            return false;
+        }
+        if (recurse) {
+            // TODO(kulakowski): This recursive call can overflow the stack.
+            if (!job->EnumerateChildren(je, /* recurse */ true)) {
+                return false;
             }
-            return ZX_OK;
-        });
+        }
     }
 
-    return result == ZX_OK;
+    return true;
 }
 
 fbl::RefPtr<ProcessDispatcher>
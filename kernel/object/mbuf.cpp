@@ -6,27 +6,83 @@
 
 #include <object/mbuf.h>
 
+#include <stdlib.h>
+
+#include <arch/ops.h>
+#include <kernel/align.h>
+#include <kernel/spinlock.h>
+#include <lib/counters.h>
 #include <lib/user_copy/user_ptr.h>
 
 #include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
+#include <zxcpp/new.h>
 
 #define LOCAL_TRACE 0
 
+namespace {
+
+// Per-cpu cache of raw MBuf-sized blocks, modeled on the message page pool
+// in buffer_chain.cpp, so socket traffic that outgrows (or tears down) a
+// chain's own freelist doesn't round trip through the heap lock. Only plain
+// mbufs are cached; external payload blocks are bulk-sized and rare by
+// comparison. A cache is only touched from its own cpu with interrupts
+// disabled.
+constexpr size_t kMBufCacheDepth = 16;
+
+struct MBufCache {
+    void* bufs[kMBufCacheDepth];
+    size_t count;
+} __CPU_ALIGN;
+
+MBufCache mbuf_caches[SMP_MAX_CPUS];
+
+KCOUNTER(mbuf_cache_hits, "kernel.mbuf.cache_hits");
+KCOUNTER(mbuf_heap_allocs, "kernel.mbuf.heap_allocs");
+
+void* mbuf_cache_pop() {
+    void* buf = nullptr;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    MBufCache* cache = &mbuf_caches[arch_curr_cpu_num()];
+    if (likely(cache->count > 0)) {
+        buf = cache->bufs[--cache->count];
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return buf;
+}
+
+bool mbuf_cache_push(void* buf) {
+    bool cached = false;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    MBufCache* cache = &mbuf_caches[arch_curr_cpu_num()];
+    if (likely(cache->count < kMBufCacheDepth)) {
+        cache->bufs[cache->count++] = buf;
+        cached = true;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return cached;
+}
+
+} // namespace
+
 constexpr size_t MBufChain::MBuf::kHeaderSize;
 constexpr size_t MBufChain::MBuf::kMallocSize;
 constexpr size_t MBufChain::MBuf::kPayloadSize;
 constexpr size_t MBufChain::kSizeMax;
 
 size_t MBufChain::MBuf::rem() const {
-    return kPayloadSize - (off_ + len_);
+    return capacity() - (off_ + len_);
 }
 
 MBufChain::~MBufChain() {
     while (!tail_.is_empty())
-        delete tail_.pop_front();
+        DestroyMBuf(tail_.pop_front());
     while (!freelist_.is_empty())
-        delete freelist_.pop_front();
+        DestroyMBuf(freelist_.pop_front());
+    while (!block_freelist_.is_empty())
+        DestroyMBuf(block_freelist_.pop_front());
 }
 
 bool MBufChain::is_full() const {
@@ -48,7 +104,7 @@ size_t MBufChain::Read(user_out_ptr<void> dst, size_t len, bool datagram) {
     size_t pos = 0;
     while (pos < len && !tail_.is_empty()) {
         MBuf& cur = tail_.front();
-        char* src = cur.data_ + cur.off_;
+        char* src = cur.payload() + cur.off_;
         size_t copy_len = MIN(cur.len_, len - pos);
         if (dst.byte_offset(pos).copy_array_to_user(src, copy_len) != ZX_OK)
             return pos;
@@ -86,9 +142,11 @@ zx_status_t MBufChain::WriteDatagram(user_in_ptr<const void> src, size_t len,
     if (len + size_ > kSizeMax)
         return ZX_ERR_SHOULD_WAIT;
 
+    // Datagrams stay on small mbufs; the size math below assumes a fixed
+    // per-buffer payload.
     fbl::SinglyLinkedList<MBuf*> bufs;
     for (size_t need = 1 + ((len - 1) / MBuf::kPayloadSize); need != 0; need--) {
-        auto buf = AllocMBuf();
+        auto buf = AllocMBuf(false);
         if (buf == nullptr) {
             while (!bufs.is_empty())
                 FreeMBuf(bufs.pop_front());
@@ -129,7 +187,7 @@ zx_status_t MBufChain::WriteDatagram(user_in_ptr<const void> src, size_t len,
 
 zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size_t* written) {
     if (head_ == nullptr) {
-        head_ = AllocMBuf();
+        head_ = AllocMBuf(len >= MBuf::kBlockSize);
         if (head_ == nullptr)
             return ZX_ERR_SHOULD_WAIT;
         tail_.push_front(head_);
@@ -138,13 +196,15 @@ zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size
     size_t pos = 0;
     while (pos < len) {
         if (head_->rem() == 0) {
-            auto next = AllocMBuf();
+            // Bulk writes go into page-sized blocks so they need fewer
+            // buffers and user copy calls; sub-page tails use small mbufs.
+            auto next = AllocMBuf(len - pos >= MBuf::kBlockSize);
             if (next == nullptr)
                 break;
             tail_.insert_after(tail_.make_iterator(*head_), next);
             head_ = next;
         }
-        void* dst = head_->data_ + head_->off_ + head_->len_;
+        void* dst = head_->payload() + head_->off_ + head_->len_;
         size_t copy_len = fbl::min(head_->rem(), len - pos);
         if (size_ + copy_len > kSizeMax) {
             copy_len = kSizeMax - size_;
@@ -165,17 +225,57 @@ zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size
     return ZX_OK;
 }
 
-MBufChain::MBuf* MBufChain::AllocMBuf() {
-    if (freelist_.is_empty()) {
-        fbl::AllocChecker ac;
-        MBuf* buf = new (&ac) MBuf();
-        return (!ac.check()) ? nullptr : buf;
+MBufChain::MBuf* MBufChain::AllocMBuf(bool external) {
+    auto* freelist = external ? &block_freelist_ : &freelist_;
+    if (!freelist->is_empty())
+        return freelist->pop_front();
+
+    if (!external) {
+        void* slot = mbuf_cache_pop();
+        if (slot != nullptr) {
+            kcounter_add(mbuf_cache_hits, 1);
+            return new (slot) MBuf();
+        }
+    }
+
+    fbl::AllocChecker ac;
+    MBuf* buf = new (&ac) MBuf();
+    if (!ac.check())
+        return nullptr;
+    kcounter_add(mbuf_heap_allocs, 1);
+    if (external) {
+        char* block = new (&ac) char[MBuf::kBlockSize];
+        if (!ac.check()) {
+            delete buf;
+            return nullptr;
+        }
+        buf->block_ = block;
+        buf->flags_ |= MBuf::kFlagExternal;
     }
-    return freelist_.pop_front();
+    return buf;
 }
 
 void MBufChain::FreeMBuf(MBuf* buf) {
     buf->off_ = 0u;
     buf->len_ = 0u;
-    freelist_.push_front(buf);
+    buf->pkt_len_ = 0u;
+    if (buf->flags_ & MBuf::kFlagExternal) {
+        block_freelist_.push_front(buf);
+    } else {
+        freelist_.push_front(buf);
+    }
+}
+
+void MBufChain::DestroyMBuf(MBuf* buf) {
+    if (buf->flags_ & MBuf::kFlagExternal) {
+        delete[] buf->block_;
+        delete buf;
+        return;
+    }
+
+    // Return the raw block to the local cpu's cache; its storage came from
+    // the heap, so overflow goes back via free().
+    buf->~MBuf();
+    if (!mbuf_cache_push(buf))
+        free(buf);
 }
@@ -104,6 +104,44 @@ zx_status_t MessagePacket::Create(const void* data, uint32_t data_size, uint32_t
     return ZX_OK;
 }
 
+// static
+zx_status_t MessagePacket::Create(const zx_channel_iovec_t* iovecs, uint32_t num_iovecs,
+                                  uint32_t num_handles, fbl::unique_ptr<MessagePacket>* msg) {
+    // Total up the payload; the per-message size cap makes overflow impossible
+    // to hit, but check anyway since the capacities come from userspace.
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < num_iovecs; ++i) {
+        total += iovecs[i].capacity;
+    }
+    if (unlikely(total > kMaxMessageSize)) {
+        return ZX_ERR_OUT_OF_RANGE;
+    }
+    const uint32_t data_size = static_cast<uint32_t>(total);
+
+    fbl::unique_ptr<MessagePacket> new_msg;
+    zx_status_t status = CreateCommon(data_size, num_handles, &new_msg);
+    if (unlikely(status != ZX_OK)) {
+        return status;
+    }
+
+    // Copy each segment into the chain back to back.
+    uint32_t offset = PayloadOffset(num_handles);
+    for (uint32_t i = 0; i < num_iovecs; ++i) {
+        if (iovecs[i].capacity == 0) {
+            continue;
+        }
+        status = new_msg->buffer_chain_->CopyIn(make_user_in_ptr(iovecs[i].buffer),
+                                                offset, iovecs[i].capacity);
+        if (unlikely(status != ZX_OK)) {
+            return status;
+        }
+        offset += iovecs[i].capacity;
+    }
+
+    *msg = fbl::move(new_msg);
+    return ZX_OK;
+}
+
 void MessagePacket::fbl_recycle() {
     // This function invokes the destructor so be careful about taking any references to |this|.
     BufferChain* chain = buffer_chain_;
@@ -118,6 +118,43 @@ static bool create_bad_mem() {
     END_TEST;
 }
 
+// Create a MessagePacket from scattered segments and verify the payload is
+// their in-order concatenation.
+static bool create_iovec() {
+    BEGIN_TEST;
+    constexpr size_t kSize = 8192;
+    fbl::unique_ptr<UserMemory> mem = UserMemory::Create(kSize);
+    auto mem_in = make_user_in_ptr(mem->in());
+    auto mem_out = make_user_out_ptr(mem->out());
+
+    fbl::AllocChecker ac;
+    auto buf = fbl::unique_ptr<char[]>(new (&ac) char[kSize]);
+    ASSERT_TRUE(ac.check(), "");
+    for (size_t i = 0; i < kSize; ++i) {
+        buf[i] = static_cast<char>(i);
+    }
+    ASSERT_EQ(ZX_OK, mem_out.copy_array_to_user(buf.get(), kSize), "");
+
+    // split the buffer into three unequal segments, including a zero-length one
+    const char* base = static_cast<const char*>(mem->in());
+    zx_channel_iovec_t iovecs[] = {
+        {base, 1, 0},
+        {base + 1, 0, 0},
+        {base + 1, kSize - 1, 0},
+    };
+
+    fbl::unique_ptr<MessagePacket> mp;
+    EXPECT_EQ(ZX_OK, MessagePacket::Create(iovecs, 3, 0, &mp), "");
+    ASSERT_EQ(kSize, mp->data_size(), "");
+
+    auto result_buf = fbl::unique_ptr<char[]>(new (&ac) char[kSize]);
+    ASSERT_TRUE(ac.check(), "");
+    ASSERT_EQ(ZX_OK, mp->CopyDataTo(mem_out), "");
+    ASSERT_EQ(ZX_OK, mem_in.copy_array_from_user(result_buf.get(), kSize), "");
+    EXPECT_EQ(0, memcmp(buf.get(), result_buf.get(), kSize), "");
+    END_TEST;
+}
+
 // Attempt to copy a MessagePacket to memory that's not part of userspace.
 static bool copy_bad_mem() {
     BEGIN_TEST;
@@ -147,6 +184,7 @@ UNITTEST_START_TESTCASE(message_packet_tests)
 UNITTEST("create", create)
 UNITTEST("create_void_star", create_void_star)
 UNITTEST("create_zero", create_zero)
+UNITTEST("create_iovec", create_iovec)
 UNITTEST("create_too_many_handles", create_too_many_handles)
 UNITTEST("create_bad_mem", create_bad_mem)
 UNITTEST("copy_bad_mem", copy_bad_mem)
@@ -26,6 +26,7 @@ namespace {
 union Encoding {
     static constexpr uint8_t kExplicitBit = 0b1000;
     static constexpr uint8_t kActionBits  = 0b0111;
+    static constexpr uint32_t kBitsPerItem = 4;
 
     // Indicates the the policies are fully encoded in the cookie.
     static constexpr uint8_t kPolicyInCookie = 0;
@@ -44,14 +45,37 @@ union Encoding {
         uint64_t new_fifo        :  4;
         uint64_t new_timer       :  4;
         uint64_t new_process     :  4;
-        uint64_t unused_bits     : 15;
+        uint64_t new_waitset     :  4;
+        uint64_t unused_bits     : 11;
         uint64_t cookie_mode     :  1;  // see kPolicyInCookie.
     };
 
     static uint32_t action(uint64_t item) { return item & kActionBits; }
     static bool is_default(uint64_t item) { return item == 0; }
+
+    // The struct above is a flat table of 4-bit items in condition order,
+    // except that ZX_POL_NEW_ANY is purely a set-time alias and has no
+    // storage; conditions after it sit one slot earlier.
+    static uint32_t slot(uint32_t condition) {
+        return condition < ZX_POL_NEW_ANY ? condition : condition - 1;
+    }
+
+    // Extracts a condition's item with one shift and mask, without going
+    // through the bitfields. Query-time policy checks use this so that
+    // every checked syscall pays a table lookup rather than a switch.
+    static uint64_t item(pol_cookie_t cookie, uint32_t condition) {
+        return (cookie >> (slot(condition) * kBitsPerItem)) &
+               (kExplicitBit | kActionBits);
+    }
 };
 
+// The flat lookup in Encoding::item() bakes in the condition numbering;
+// force a revisit here if it changes.
+static_assert(ZX_POL_BAD_HANDLE == 0u && ZX_POL_WRONG_OBJECT == 1u &&
+              ZX_POL_VMAR_WX == 2u && ZX_POL_NEW_ANY == 3u &&
+              ZX_POL_NEW_VMO == 4u && ZX_POL_NEW_WAITSET == 13u,
+              "Encoding::item() relies on this numbering");
+
 }  // namespace
 
 constexpr uint32_t kPolicyActionValidBits =
@@ -63,7 +87,7 @@ constexpr uint32_t kPolicyActionValidBits =
 static_assert(sizeof(Encoding) == sizeof(pol_cookie_t), "bitfield issue");
 
 // Make sure that adding new policies forces updating this file.
-static_assert(ZX_POL_MAX == 13u, "please update PolicyManager AddPolicy and QueryBasicPolicy");
+static_assert(ZX_POL_MAX == 14u, "please update PolicyManager AddPolicy and QueryBasicPolicy");
 
 PolicyManager* PolicyManager::Create(uint32_t default_action) {
     fbl::AllocChecker ac;
@@ -141,21 +165,13 @@ uint32_t PolicyManager::QueryBasicPolicy(pol_cookie_t policy, uint32_t condition
     Encoding existing = { policy };
     DEBUG_ASSERT(existing.cookie_mode == Encoding::kPolicyInCookie);
 
-    switch (condition) {
-    case ZX_POL_BAD_HANDLE: return GetEffectiveAction(existing.bad_handle);
-    case ZX_POL_WRONG_OBJECT: return GetEffectiveAction(existing.wrong_obj);
-    case ZX_POL_NEW_VMO: return GetEffectiveAction(existing.new_vmo);
-    case ZX_POL_NEW_CHANNEL: return GetEffectiveAction(existing.new_channel);
-    case ZX_POL_NEW_EVENT: return GetEffectiveAction(existing.new_event);
-    case ZX_POL_NEW_EVENTPAIR: return GetEffectiveAction(existing.new_eventpair);
-    case ZX_POL_NEW_PORT: return GetEffectiveAction(existing.new_port);
-    case ZX_POL_NEW_SOCKET: return GetEffectiveAction(existing.new_socket);
-    case ZX_POL_NEW_FIFO: return GetEffectiveAction(existing.new_fifo);
-    case ZX_POL_NEW_TIMER: return GetEffectiveAction(existing.new_timer);
-    case ZX_POL_NEW_PROCESS: return GetEffectiveAction(existing.new_process);
-    case ZX_POL_VMAR_WX: return GetEffectiveAction(existing.vmar_wx);
-    default: return ZX_POL_ACTION_DENY;
-    }
+    // The cookie is a flat 4-bit-per-condition table; this is the hot path
+    // of every policy-checked syscall, so it's a shift and a mask rather
+    // than a switch over the conditions.
+    if (condition >= ZX_POL_MAX || condition == ZX_POL_NEW_ANY)
+        return ZX_POL_ACTION_DENY;
+
+    return GetEffectiveAction(Encoding::item(policy, condition));
 }
 
 uint32_t PolicyManager::GetEffectiveAction(uint64_t policy) {
@@ -224,11 +240,19 @@ zx_status_t PolicyManager::AddPartial(uint32_t mode, pol_cookie_t existing_polic
     case ZX_POL_NEW_PROCESS:
         POLMAN_SET_ENTRY(mode, existing.new_process, policy, result.new_process);
         break;
+    case ZX_POL_NEW_WAITSET:
+        POLMAN_SET_ENTRY(mode, existing.new_waitset, policy, result.new_waitset);
+        break;
     default:
         return ZX_ERR_NOT_SUPPORTED;
     }
 
     *partial = result.encoded;
+    // The bitfield encoder above and the flat decoder in Encoding::item()
+    // must agree on where this condition's item lives.
+    DEBUG_ASSERT(Encoding::is_default(Encoding::item(*partial, condition)) ||
+                 Encoding::item(*partial, condition) ==
+                     ((policy & Encoding::kActionBits) | Encoding::kExplicitBit));
     return ZX_OK;
 }
 
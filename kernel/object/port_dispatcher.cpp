@@ -33,6 +33,8 @@ static_assert(sizeof(zx_packet_guest_io_t) == sizeof(zx_packet_user_t),
               "size of zx_packet_guest_io_t must match zx_packet_user_t");
 static_assert(sizeof(zx_packet_guest_vcpu_t) == sizeof(zx_packet_user_t),
               "size of zx_packet_guest_vcpu_t must match zx_packet_user_t");
+static_assert(sizeof(zx_packet_channel_call_t) == sizeof(zx_packet_user_t),
+              "size of zx_packet_channel_call_t must match zx_packet_user_t");
 
 KCOUNTER(port_arena_count, "kernel.port.arena.count");
 KCOUNTER(port_full_count, "kernel.port.full.count");
@@ -88,7 +90,8 @@ PortPacket::PortPacket(const void* handle, PortAllocator* allocator)
 
 PortObserver::PortObserver(uint32_t type, const Handle* handle, fbl::RefPtr<PortDispatcher> port,
                            uint64_t key, zx_signals_t signals)
-    : type_(type),
+    : StateObserver(signals),
+      type_(type),
       trigger_(signals),
       packet_(handle, nullptr),
       port_(fbl::move(port)) {
@@ -187,7 +190,7 @@ PortDispatcher::PortDispatcher(uint32_t options)
 
 PortDispatcher::~PortDispatcher() {
     DEBUG_ASSERT(zero_handles_);
-    DEBUG_ASSERT(num_packets_ == 0u);
+    DEBUG_ASSERT(num_packets_.load() == 0u);
 }
 
 void PortDispatcher::on_zero_handles() {
@@ -208,7 +211,7 @@ void PortDispatcher::on_zero_handles() {
     // Free any queued packets.
     while (!packets_.is_empty()) {
         FreePacket(packets_.pop_front());
-        --num_packets_;
+        num_packets_.fetch_sub(1u);
     }
 }
 
@@ -237,12 +240,14 @@ bool PortDispatcher::RemoveInterruptPacket(PortInterruptPacket* port_packet) {
     return false;
 }
 
-bool PortDispatcher::QueueInterruptPacket(PortInterruptPacket* port_packet, zx_time_t timestamp) {
+bool PortDispatcher::QueueInterruptPacket(PortInterruptPacket* port_packet, zx_time_t timestamp,
+                                          uint64_t count) {
     Guard<SpinLock, IrqSave> guard{&spinlock_};
     if (port_packet->InContainer()) {
         return false;
     } else {
         port_packet->timestamp = timestamp;
+        port_packet->count = count;
         interrupt_packets_.push_back(port_packet);
         sema_.Post();
         return true;
@@ -257,7 +262,7 @@ zx_status_t PortDispatcher::Queue(PortPacket* port_packet, zx_signals_t observed
     if (zero_handles_)
         return ZX_ERR_BAD_STATE;
 
-    if (num_packets_ > kMaxPendingPacketCountPerPort) {
+    if (num_packets_.load(fbl::memory_order_relaxed) > kMaxPendingPacketCountPerPort) {
         kcounter_add(port_full_count, 1);
         return ZX_ERR_SHOULD_WAIT;
     }
@@ -272,7 +277,7 @@ zx_status_t PortDispatcher::Queue(PortPacket* port_packet, zx_signals_t observed
         port_packet->packet.signal.count = count;
     }
     packets_.push_back(port_packet);
-    ++num_packets_;
+    num_packets_.fetch_add(1u);
     // This Disable() call must come before Post() to be useful, but doing
     // it earlier would also be OK.
     resched_disable.Disable();
@@ -294,14 +299,19 @@ zx_status_t PortDispatcher::Dequeue(zx_time_t deadline, zx_port_packet_t* out_pa
                 out_packet->type = ZX_PKT_TYPE_INTERRUPT;
                 out_packet->status = ZX_OK;
                 out_packet->interrupt.timestamp = port_interrupt_packet->timestamp;
+                out_packet->interrupt.count = port_interrupt_packet->count;
                 return ZX_OK;
             }
         }
-        {
+        // Only take the (contended) dispatcher lock if there's something to
+        // pop. The count is just a hint: a packet queued after the check will
+        // have posted |sema_|, so the Wait below returns immediately and we
+        // come around again.
+        if (num_packets_.load(fbl::memory_order_relaxed) > 0u) {
             Guard<fbl::Mutex> guard{get_lock()};
             PortPacket* port_packet = packets_.pop_front();
             if (port_packet != nullptr) {
-                --num_packets_;
+                num_packets_.fetch_sub(1u);
                 *out_packet = port_packet->packet;
                 FreePacket(port_packet);
                 return ZX_OK;
@@ -406,7 +416,7 @@ bool PortDispatcher::CancelQueued(const void* handle, uint64_t key) {
         if ((it->handle == handle) && (it->key() == key)) {
             auto to_remove = it++;
             delete packets_.erase(to_remove)->observer;
-            --num_packets_;
+            num_packets_.fetch_sub(1u);
             packet_removed = true;
         } else {
             ++it;
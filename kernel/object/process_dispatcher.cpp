@@ -54,6 +54,20 @@ static Handle* map_value_to_handle(zx_handle_t value, uint32_t mixer) {
     return Handle::FromU32(handle_id);
 }
 
+// Sharded locks that serialize the lock-free dispatcher lookup path against
+// handle removal. Lookups take only the shard covering their handle, so
+// concurrent syscalls on different handles do not contend; the handle table
+// mutex is left to add/remove and table enumeration. The shards are global
+// (keyed by arena slot) rather than per process, which lets a lookup lock
+// its shard before knowing whether the handle belongs to this process.
+static constexpr size_t kHandleShardCount = 16;
+static SpinLock handle_shard_locks[kHandleShardCount];
+
+static SpinLock* handle_shard_lock(const Handle* handle) {
+    const uintptr_t slot = reinterpret_cast<uintptr_t>(handle) / sizeof(Handle);
+    return &handle_shard_locks[slot % kHandleShardCount];
+}
+
 zx_status_t ProcessDispatcher::Create(
     fbl::RefPtr<JobDispatcher> job, fbl::StringPiece name, uint32_t flags,
     fbl::RefPtr<Dispatcher>* dispatcher, zx_rights_t* rights,
@@ -101,8 +115,7 @@ ProcessDispatcher::ProcessDispatcher(fbl::RefPtr<JobDispatcher> job,
 
     // Generate handle XOR mask with top bit and bottom two bits cleared
     uint32_t secret;
-    auto prng = crypto::GlobalPRNG::GetInstance();
-    prng->Draw(&secret, sizeof(secret));
+    crypto::GlobalPRNG::Draw(&secret, sizeof(secret));
 
     // Handle values cannot be negative values, so we mask the high bit.
     handle_rand_ = (secret << 2) & INT_MAX;
@@ -345,9 +358,15 @@ void ProcessDispatcher::FinishDeadTransition() {
     {
         Guard<fbl::Mutex> guard{&handle_table_lock_};
         for (auto& handle : handles_) {
+            // Take the shard lock for each clear so in-flight lock-free
+            // lookups finish before the handles are deleted below.
+            AutoSpinLock shard_guard(handle_shard_lock(&handle));
             handle.set_process_id(0u);
         }
         to_clean.swap(handles_);
+        // Subtract the whole table from the job's aggregate counters at once.
+        uint32_t removed = handle_count_.exchange(0u, fbl::memory_order_relaxed);
+        job_->CountHandles(-static_cast<int64_t>(removed));
     }
 
     // zx-1544: Here is where if we're the last holder of a handle of one of
@@ -417,6 +436,8 @@ void ProcessDispatcher::AddHandle(HandleOwner handle) {
 void ProcessDispatcher::AddHandleLocked(HandleOwner handle) {
     handle->set_process_id(get_koid());
     handles_.push_front(handle.release());
+    handle_count_.fetch_add(1u, fbl::memory_order_relaxed);
+    job_->CountHandles(1);
 }
 
 HandleOwner ProcessDispatcher::RemoveHandle(zx_handle_t handle_value) {
@@ -429,8 +450,17 @@ HandleOwner ProcessDispatcher::RemoveHandleLocked(zx_handle_t handle_value) {
     if (!handle)
         return nullptr;
 
-    handle->set_process_id(0u);
+    {
+        // Clear the owner under the shard lock so that a concurrent
+        // lock-free lookup either completes its copy out of the handle
+        // first or sees the handle as no longer ours; either way the
+        // handle cannot be torn down underneath it.
+        AutoSpinLock guard(handle_shard_lock(handle));
+        handle->set_process_id(0u);
+    }
     handles_.erase(*handle);
+    handle_count_.fetch_sub(1u, fbl::memory_order_relaxed);
+    job_->CountHandles(-1);
 
     return HandleOwner(handle);
 }
@@ -478,36 +508,59 @@ zx_koid_t ProcessDispatcher::GetKoidForHandle(zx_handle_t handle_value) {
     return handle->dispatcher()->get_koid();
 }
 
+// Validates |handle| against |handle_value| with only its shard lock held.
+// The owner check rejects other processes' handles (and handles mid-removal,
+// which have their owner cleared under the shard lock), and re-deriving the
+// value rejects a slot that was freed and reused with a new generation since
+// map_value_to_handle inspected it.
+bool ProcessDispatcher::IsHandleValidNoLock(const Handle* handle,
+                                            zx_handle_t handle_value) const {
+    return handle->process_id() == get_koid() &&
+           map_handle_to_value(handle, handle_rand_) == handle_value;
+}
+
 zx_status_t ProcessDispatcher::GetDispatcherInternal(zx_handle_t handle_value,
                                                      fbl::RefPtr<Dispatcher>* dispatcher,
                                                      zx_rights_t* rights) {
-    Guard<fbl::Mutex> guard{&handle_table_lock_};
-    Handle* handle = GetHandleLocked(handle_value);
-    if (!handle)
-        return ZX_ERR_BAD_HANDLE;
+    Handle* handle = map_value_to_handle(handle_value, handle_rand_);
+    if (likely(handle)) {
+        AutoSpinLock guard(handle_shard_lock(handle));
+        if (likely(IsHandleValidNoLock(handle, handle_value))) {
+            *dispatcher = handle->dispatcher();
+            if (rights)
+                *rights = handle->rights();
+            return ZX_OK;
+        }
+    }
 
-    *dispatcher = handle->dispatcher();
-    if (rights)
-        *rights = handle->rights();
-    return ZX_OK;
+    // Handle lookup failed.  We potentially generate an exception,
+    // depending on the job policy (see GetHandleLocked).
+    QueryPolicy(ZX_POL_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
 }
 
 zx_status_t ProcessDispatcher::GetDispatcherWithRightsInternal(zx_handle_t handle_value,
                                                                zx_rights_t desired_rights,
                                                                fbl::RefPtr<Dispatcher>* dispatcher_out,
                                                                zx_rights_t* out_rights) {
-    Guard<fbl::Mutex> guard{&handle_table_lock_};
-    Handle* handle = GetHandleLocked(handle_value);
-    if (!handle)
-        return ZX_ERR_BAD_HANDLE;
-
-    if (!handle->HasRights(desired_rights))
-        return ZX_ERR_ACCESS_DENIED;
+    Handle* handle = map_value_to_handle(handle_value, handle_rand_);
+    if (likely(handle)) {
+        AutoSpinLock guard(handle_shard_lock(handle));
+        if (likely(IsHandleValidNoLock(handle, handle_value))) {
+            if (!handle->HasRights(desired_rights))
+                return ZX_ERR_ACCESS_DENIED;
+
+            *dispatcher_out = handle->dispatcher();
+            if (out_rights)
+                *out_rights = handle->rights();
+            return ZX_OK;
+        }
+    }
 
-    *dispatcher_out = handle->dispatcher();
-    if (out_rights)
-        *out_rights = handle->rights();
-    return ZX_OK;
+    // Handle lookup failed.  We potentially generate an exception,
+    // depending on the job policy (see GetHandleLocked).
+    QueryPolicy(ZX_POL_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
 }
 
 zx_status_t ProcessDispatcher::GetInfo(zx_info_process_t* info) {
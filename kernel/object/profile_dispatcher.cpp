@@ -14,14 +14,28 @@
 #include <object/thread_dispatcher.h>
 
 #include <zircon/rights.h>
+#include <zircon/time.h>
 
 zx_status_t validate_profile(const zx_profile_info_t& info) {
-    if (info.type != ZX_PROFILE_INFO_SCHEDULER)
+    switch (info.type) {
+    case ZX_PROFILE_INFO_SCHEDULER:
+        if ((info.scheduler.priority < LOWEST_PRIORITY) ||
+            (info.scheduler.priority  > HIGHEST_PRIORITY))
+            return ZX_ERR_INVALID_ARGS;
+        return ZX_OK;
+    case ZX_PROFILE_INFO_DEADLINE:
+        if ((info.deadline.capacity <= 0) ||
+            (info.deadline.capacity > info.deadline.deadline) ||
+            (info.deadline.deadline > info.deadline.period))
+            return ZX_ERR_INVALID_ARGS;
+        // the scheduler enforces capacity with the preemption timer, which
+        // assumes time slices are well under a second
+        if (info.deadline.capacity >= ZX_SEC(1))
+            return ZX_ERR_INVALID_ARGS;
+        return ZX_OK;
+    default:
         return ZX_ERR_NOT_SUPPORTED;
-    if ((info.scheduler.priority < LOWEST_PRIORITY) ||
-        (info.scheduler.priority  > HIGHEST_PRIORITY))
-        return ZX_ERR_INVALID_ARGS;
-    return ZX_OK;
+    }
 }
 
 zx_status_t ProfileDispatcher::Create(const zx_profile_info_t& info,
@@ -48,6 +62,12 @@ ProfileDispatcher::~ProfileDispatcher() {
 }
 
 zx_status_t ProfileDispatcher::ApplyProfile(fbl::RefPtr<ThreadDispatcher> thread) {
-    // At the moment, the only thing we support is the priority.
-    return thread->SetPriority(info_.scheduler.priority);
+    switch (info_.type) {
+    case ZX_PROFILE_INFO_SCHEDULER:
+        return thread->SetPriority(info_.scheduler.priority);
+    case ZX_PROFILE_INFO_DEADLINE:
+        return thread->SetDeadline(info_.deadline);
+    default:
+        return ZX_ERR_NOT_SUPPORTED;
+    }
 }
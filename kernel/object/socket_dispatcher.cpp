@@ -90,7 +90,8 @@ SocketDispatcher::SocketDispatcher(fbl::RefPtr<PeerHolder<SocketDispatcher>> hol
       flags_(flags),
       control_msg_(fbl::move(control_msg)),
       control_msg_len_(0),
-      read_disabled_(false) {
+      read_disabled_(false),
+      write_threshold_(0u) {
 }
 
 SocketDispatcher::~SocketDispatcher() {
@@ -110,7 +111,7 @@ void SocketDispatcher::on_zero_handles_locked() {
 void SocketDispatcher::OnPeerZeroHandlesLocked() {
     canary_.Assert();
 
-    UpdateStateLocked(ZX_SOCKET_WRITABLE, ZX_SOCKET_PEER_CLOSED);
+    UpdateStateLocked(ZX_SOCKET_WRITABLE | ZX_SOCKET_WRITE_THRESHOLD, ZX_SOCKET_PEER_CLOSED);
 }
 
 zx_status_t SocketDispatcher::UserSignalSelfLocked(uint32_t clear_mask, uint32_t set_mask) {
@@ -146,7 +147,7 @@ zx_status_t SocketDispatcher::Shutdown(uint32_t how) TA_NO_THREAD_SAFETY_ANALYSI
             set_mask |= ZX_SOCKET_READ_DISABLED;
     }
     if (shutdown_write) {
-        clear_mask |= ZX_SOCKET_WRITABLE;
+        clear_mask |= ZX_SOCKET_WRITABLE | ZX_SOCKET_WRITE_THRESHOLD;
         set_mask |= ZX_SOCKET_WRITE_DISABLED;
     }
     UpdateStateLocked(clear_mask, set_mask);
@@ -170,7 +171,7 @@ zx_status_t SocketDispatcher::ShutdownOtherLocked(uint32_t how) {
     zx_signals_t set_mask = 0u;
     if (shutdown_read) {
         // If the other end shut down reading, we can't write any more.
-        clear_mask |= ZX_SOCKET_WRITABLE;
+        clear_mask |= ZX_SOCKET_WRITABLE | ZX_SOCKET_WRITE_THRESHOLD;
         set_mask |= ZX_SOCKET_WRITE_DISABLED;
     }
     if (shutdown_write) {
@@ -273,8 +274,11 @@ zx_status_t SocketDispatcher::WriteSelfLocked(user_in_ptr<const void> src, size_
             UpdateStateLocked(0u, ZX_SOCKET_READABLE);
     }
 
-    if (peer_ && is_full())
-        peer_->UpdateStateLocked(ZX_SOCKET_WRITABLE, 0u);
+    if (peer_) {
+        if (is_full())
+            peer_->UpdateStateLocked(ZX_SOCKET_WRITABLE, 0u);
+        peer_->UpdateWriteThresholdSignalLocked();
+    }
 
     *written = st;
     return status;
@@ -318,8 +322,11 @@ zx_status_t SocketDispatcher::Read(user_out_ptr<void> dst, size_t len,
         UpdateStateLocked(ZX_SOCKET_READABLE, set_mask);
     }
 
-    if (peer_ && was_full && (st > 0))
-        peer_->UpdateStateLocked(0u, ZX_SOCKET_WRITABLE);
+    if (peer_ && (st > 0)) {
+        if (was_full)
+            peer_->UpdateStateLocked(0u, ZX_SOCKET_WRITABLE);
+        peer_->UpdateWriteThresholdSignalLocked();
+    }
 
     *nread = static_cast<size_t>(st);
     return ZX_OK;
@@ -440,3 +447,47 @@ size_t SocketDispatcher::TransmitBufferSize() const TA_NO_THREAD_SAFETY_ANALYSIS
     Guard<fbl::Mutex> guard{get_lock()};
     return peer_ ? peer_->data_.size() : 0;
 }
+
+size_t SocketDispatcher::GetWriteThreshold() const {
+    canary_.Assert();
+    Guard<fbl::Mutex> guard{get_lock()};
+    return write_threshold_;
+}
+
+zx_status_t SocketDispatcher::SetWriteThreshold(size_t threshold) TA_NO_THREAD_SAFETY_ANALYSIS {
+    canary_.Assert();
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    if (threshold > (peer_ ? peer_->data_.max_size() : 0u))
+        return ZX_ERR_INVALID_ARGS;
+
+    write_threshold_ = threshold;
+    if (threshold == 0u) {
+        UpdateStateLocked(ZX_SOCKET_WRITE_THRESHOLD, 0u);
+    } else {
+        UpdateWriteThresholdSignalLocked();
+    }
+    return ZX_OK;
+}
+
+// Recomputes ZX_SOCKET_WRITE_THRESHOLD for this endpoint against the free
+// space in its transmit buffer, which lives on the peer (see the NOTE above
+// TransmitBufferMax about the aliased peer lock).
+void SocketDispatcher::UpdateWriteThresholdSignalLocked() TA_NO_THREAD_SAFETY_ANALYSIS {
+    canary_.Assert();
+
+    if (write_threshold_ == 0u)
+        return;
+
+    bool above = false;
+    if (peer_ && !(GetSignalsStateLocked() & ZX_SOCKET_WRITE_DISABLED)) {
+        const size_t max = peer_->data_.max_size();
+        const size_t used = peer_->data_.size();
+        above = (used < max) && (max - used >= write_threshold_);
+    }
+    if (above) {
+        UpdateStateLocked(0u, ZX_SOCKET_WRITE_THRESHOLD);
+    } else {
+        UpdateStateLocked(ZX_SOCKET_WRITE_THRESHOLD, 0u);
+    }
+}
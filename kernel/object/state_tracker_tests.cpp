@@ -181,6 +181,67 @@ bool on_cancel_by_key() {
 
 } // namespace removal
 
+// Tests for watched-signal filtering
+namespace filtering {
+
+class CountingObserver : public StateObserver {
+public:
+    CountingObserver() = default;
+    explicit CountingObserver(zx_signals_t watched_signals)
+        : StateObserver(watched_signals) {}
+
+    // The number of times OnStateChange() has been called.
+    int state_changes() const { return state_changes_; }
+
+private:
+    Flags OnInitialize(zx_signals_t initial_state,
+                       const StateObserver::CountInfo* cinfo) override {
+        return 0;
+    }
+    Flags OnStateChange(zx_signals_t new_state) override {
+        state_changes_++;
+        return 0;
+    }
+    Flags OnCancel(const Handle* handle) override { return 0; }
+
+    int state_changes_ = 0;
+};
+
+bool watched_signals_filter() {
+    BEGIN_TEST;
+
+    CountingObserver all_obs;
+    CountingObserver narrow_obs(ZX_USER_SIGNAL_1);
+
+    TestDispatcher st;
+    st.AddObserver(&all_obs, nullptr);
+    st.AddObserver(&narrow_obs, nullptr);
+
+    // Raising a signal the narrow observer doesn't watch should only visit
+    // the all-signals observer.
+    st.UpdateState(0, ZX_USER_SIGNAL_0);
+    EXPECT_EQ(1, all_obs.state_changes(), "");
+    EXPECT_EQ(0, narrow_obs.state_changes(), "");
+
+    // Raising a watched signal visits both.
+    st.UpdateState(0, ZX_USER_SIGNAL_1);
+    EXPECT_EQ(2, all_obs.state_changes(), "");
+    EXPECT_EQ(1, narrow_obs.state_changes(), "");
+
+    // Clearing every signal still visits the all-signals observer, since it
+    // may need to see the state going quiescent.
+    st.UpdateState(ZX_USER_SIGNAL_0 | ZX_USER_SIGNAL_1, 0);
+    EXPECT_EQ(3, all_obs.state_changes(), "");
+    EXPECT_EQ(1, narrow_obs.state_changes(), "");
+
+    st.RemoveObserver(&all_obs);
+    st.RemoveObserver(&narrow_obs);
+
+    END_TEST;
+}
+
+} // namespace filtering
+
 #define ST_UNITTEST(fname) UNITTEST(#fname, fname)
 
 UNITTEST_START_TESTCASE(state_tracker_tests)
@@ -189,6 +250,7 @@ ST_UNITTEST(removal::on_initialize)
 ST_UNITTEST(removal::on_state_change_via_update_state)
 ST_UNITTEST(removal::on_cancel)
 ST_UNITTEST(removal::on_cancel_by_key)
+ST_UNITTEST(filtering::watched_signals_filter)
 
 UNITTEST_END_TESTCASE(
     state_tracker_tests, "statetracker", "StateTracker test");
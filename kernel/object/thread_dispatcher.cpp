@@ -445,6 +445,7 @@ void ThreadDispatcher::SetStateLocked(State state) {
     DEBUG_ASSERT(get_lock()->lock().IsHeld());
 
     state_ = state;
+    UpdateInfoSnapshotLocked();
 
     switch (state) {
     case State::RUNNING:
@@ -561,6 +562,7 @@ zx_status_t ThreadDispatcher::ExceptionHandlerExchange(
         exception_wait_port_ = eport;
 
         exception_status_ = ExceptionStatus::UNPROCESSED;
+        UpdateInfoSnapshotLocked();
     }
 
     zx_status_t status;
@@ -619,6 +621,7 @@ zx_status_t ThreadDispatcher::ExceptionHandlerExchange(
 
     *out_estatus = exception_status_;
     exception_status_ = ExceptionStatus::IDLE;
+    UpdateInfoSnapshotLocked();
 
     LTRACEF("returning status %d, estatus %d\n",
             status, static_cast<int>(*out_estatus));
@@ -651,6 +654,7 @@ zx_status_t ThreadDispatcher::MarkExceptionHandled(ExceptionStatus estatus) {
         return ZX_ERR_BAD_STATE;
 
     exception_status_ = estatus;
+    UpdateInfoSnapshotLocked();
     event_signal(&exception_event_, true);
     return ZX_OK;
 }
@@ -683,6 +687,7 @@ zx_status_t ThreadDispatcher::MarkExceptionHandled(PortDispatcher* eport,
         return ZX_ERR_BAD_STATE;
 
     exception_status_ = estatus;
+    UpdateInfoSnapshotLocked();
     event_signal(&exception_event_, true);
     return ZX_OK;
 }
@@ -699,6 +704,7 @@ void ThreadDispatcher::OnExceptionPortRemoval(const fbl::RefPtr<ExceptionPort>&
         // Leave things alone if already processed. See MarkExceptionHandled.
         if (exception_status_ == ExceptionStatus::UNPROCESSED) {
             exception_status_ = ExceptionStatus::TRY_NEXT;
+            UpdateInfoSnapshotLocked();
             event_signal(&exception_event_, true);
         }
     }
@@ -712,6 +718,23 @@ bool ThreadDispatcher::InExceptionLocked() {
     return thread_stopped_in_exception(&thread_);
 }
 
+void ThreadDispatcher::UpdateInfoSnapshotLocked() {
+    // A port type of !NONE indicates to ZX_INFO_THREAD readers that the
+    // thread is waiting for an exception response, so only publish the port
+    // while |exception_status_| is UNPROCESSED; any transition away from it
+    // (handled, try-next, port removal, thread resumed) re-publishes NONE.
+    ExceptionPort::Type excp_port_type = ExceptionPort::Type::NONE;
+    if (exception_status_ == ExceptionStatus::UNPROCESSED) {
+        DEBUG_ASSERT(exception_wait_port_ != nullptr);
+        excp_port_type = exception_wait_port_->type();
+    }
+
+    info_seq_.WriteBegin();
+    info_state_ = state_;
+    info_excp_port_type_ = excp_port_type;
+    info_seq_.WriteEnd();
+}
+
 zx_status_t ThreadDispatcher::GetInfoForUserspace(zx_info_thread_t* info) {
     canary_.Assert();
 
@@ -722,29 +745,16 @@ zx_status_t ThreadDispatcher::GetInfoForUserspace(zx_info_thread_t* info) {
     State state;
     Blocked blocked_reason;
     ExceptionPort::Type excp_port_type;
-    // We need to fetch all these values under lock, but once we have them
-    // we no longer need the lock.
-    {
-        Guard<fbl::Mutex> guard{get_lock()};
-        state = state_;
-        blocked_reason = blocked_reason_;
-        if (InExceptionLocked() &&
-            // A port type of !NONE here indicates to the caller that the
-            // thread is waiting for an exception response. So don't return
-            // !NONE if the thread just woke up but hasn't reacquired
-            // |state_lock_|.
-            exception_status_ == ExceptionStatus::UNPROCESSED) {
-            DEBUG_ASSERT(exception_wait_port_ != nullptr);
-            excp_port_type = exception_wait_port_->type();
-        } else {
-            // Either we're not in an exception, or we're in the window where
-            // event_wait_deadline has woken up but |state_lock_| has
-            // not been reacquired.
-            DEBUG_ASSERT(exception_wait_port_ == nullptr ||
-                         exception_status_ != ExceptionStatus::UNPROCESSED);
-            excp_port_type = ExceptionPort::Type::NONE;
-        }
-    }
+    // Copy the seqlock-published snapshot rather than taking |get_lock()|:
+    // writers re-publish it on every state and exception transition, so
+    // monitoring reads never contend with the thread's hot path.
+    uint32_t gen;
+    do {
+        gen = info_seq_.ReadBegin();
+        state = info_state_;
+        excp_port_type = info_excp_port_type_;
+    } while (info_seq_.ReadRetry(gen));
+    blocked_reason = blocked_reason_;
 
     switch (state) {
     case ThreadDispatcher::State::INITIAL:
@@ -961,6 +971,18 @@ zx_status_t ThreadDispatcher::SetPriority(int32_t priority) {
     return ZX_OK;
 }
 
+zx_status_t ThreadDispatcher::SetDeadline(const zx_profile_deadline_t& params) {
+    Guard<fbl::Mutex> guard{get_lock()};
+    if ((state_ == State::INITIAL) ||
+        (state_ == State::DYING) ||
+        (state_ == State::DEAD)) {
+        return ZX_ERR_BAD_STATE;
+    }
+    // The parameters were already validated by the Profile dispatcher.
+    thread_set_deadline(&thread_, params.capacity, params.deadline, params.period);
+    return ZX_OK;
+}
+
 void get_user_thread_process_name(const void* user_thread,
                                   char out_name[ZX_MAX_NAME_LEN]) {
     const ThreadDispatcher* ut =
@@ -18,6 +18,8 @@
 #include <zircon/rights.h>
 #include <zircon/types.h>
 
+TimerDispatcher::CoalesceList TimerDispatcher::coalesce_list_ = {};
+
 static void timer_irq_callback(timer* timer, zx_time_t now, void* arg) {
     // We are in IRQ context and cannot touch the timer state_tracker, so we
     // schedule a DPC to do so. TODO(cpu): figure out ways to reduce the lag.
@@ -66,6 +68,7 @@ TimerDispatcher::TimerDispatcher(slack_mode slack_mode)
 
 TimerDispatcher::~TimerDispatcher() {
     DEBUG_ASSERT(deadline_ == 0u);
+    DEBUG_ASSERT(!coalesce_node_.InContainer());
 }
 
 void TimerDispatcher::on_zero_handles() {
@@ -94,8 +97,14 @@ zx_status_t TimerDispatcher::Set(zx_time_t deadline, zx_duration_t slack) {
         return ZX_OK;
     }
 
-    deadline_ = deadline;
-    slack_ = slack;
+    // Before arming the kernel timer, try to align with another active
+    // dispatcher timer whose deadline already falls in our slack window.
+    // The per-cpu timer queues only coalesce among timers on the same cpu,
+    // so this is where unrelated timers get to share one wakeup. If we
+    // snapped to a shared deadline it is exact, so no slack is passed down.
+    zx_time_t aligned = AlignDeadline(deadline, slack);
+    deadline_ = aligned;
+    slack_ = (aligned == deadline) ? slack : 0u;
 
     // If we're imminently awaiting a timer callback due to a prior cancelation request,
     // let the callback take care of restarting the timer too so everthing happens in the
@@ -130,6 +139,56 @@ void TimerDispatcher::SetTimerLocked(bool cancel_first) {
         &timer_irq_callback, &timer_dpc_);
 }
 
+zx_time_t TimerDispatcher::AlignDeadline(zx_time_t deadline, zx_duration_t slack) {
+    Guard<fbl::Mutex> guard{CoalesceLock::Get()};
+
+    // Set() may be replacing a deadline that is still registered.
+    if (coalesce_node_.InContainer())
+        coalesce_list_.erase(*this);
+
+    zx_time_t earliest = deadline;
+    zx_time_t latest = deadline;
+    switch (slack_mode_) {
+    case TIMER_SLACK_CENTER:
+        earliest = deadline - slack;
+        latest = deadline + slack;
+        break;
+    case TIMER_SLACK_EARLY:
+        earliest = deadline - slack;
+        break;
+    case TIMER_SLACK_LATE:
+        latest = deadline + slack;
+        break;
+    }
+
+    // Snap to the registered deadline closest to the requested one, if any
+    // falls inside the window. The list is small (one entry per armed
+    // dispatcher timer) and this is well off the tick path.
+    zx_time_t best = deadline;
+    zx_duration_t best_distance = 0;
+    for (const auto& other : coalesce_list_) {
+        zx_time_t candidate = other.coalesce_deadline_;
+        if (candidate < earliest || candidate > latest)
+            continue;
+        zx_duration_t distance =
+            candidate > deadline ? candidate - deadline : deadline - candidate;
+        if (best == deadline || distance < best_distance) {
+            best = candidate;
+            best_distance = distance;
+        }
+    }
+
+    coalesce_deadline_ = best;
+    coalesce_list_.push_back(this);
+    return best;
+}
+
+void TimerDispatcher::UnregisterDeadline() {
+    Guard<fbl::Mutex> guard{CoalesceLock::Get()};
+    if (coalesce_node_.InContainer())
+        coalesce_list_.erase(*this);
+}
+
 bool TimerDispatcher::CancelTimerLocked() {
     // Always clear the signal bit.
     UpdateStateLocked(ZX_TIMER_SIGNALED, 0u);
@@ -139,6 +198,7 @@ bool TimerDispatcher::CancelTimerLocked() {
         return false; // didn't call timer_cancel
     deadline_ = 0u;
     slack_ = 0;
+    UnregisterDeadline();
 
     // If we're already waiting for the timer to be canceled, then we don't need
     // to cancel it again.
@@ -182,6 +242,7 @@ void TimerDispatcher::OnTimerFired() {
             // The timer is firing.
             UpdateStateLocked(0u, ZX_TIMER_SIGNALED);
             deadline_ = 0u;
+            UnregisterDeadline();
         }
     }
 
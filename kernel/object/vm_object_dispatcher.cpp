@@ -6,12 +6,16 @@
 
 #include <object/vm_object_dispatcher.h>
 
+#include <kernel/thread.h>
+#include <object/job_dispatcher.h>
 #include <vm/vm_aspace.h>
 #include <vm/vm_object.h>
 
 #include <zircon/rights.h>
 
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
+#include <fbl/unique_ptr.h>
 
 #include <assert.h>
 #include <err.h>
@@ -20,6 +24,22 @@
 
 #define LOCAL_TRACE 0
 
+namespace {
+
+// Granularity of asynchronous commits. Committing chunk by chunk keeps the
+// VMO lock hold times bounded and makes progress observable (e.g. through
+// the committed_bytes reported by ZX_INFO_PROCESS_VMOS) while the worker
+// runs.
+constexpr uint64_t kAsyncCommitChunk = 16 * 1024 * 1024;
+
+struct AsyncCommitRequest {
+    fbl::RefPtr<VmObjectDispatcher> dispatcher;
+    uint64_t offset;
+    uint64_t size;
+};
+
+} // anonymous namespace
+
 zx_status_t VmObjectDispatcher::Create(fbl::RefPtr<VmObject> vmo,
                                        fbl::RefPtr<Dispatcher>* dispatcher,
                                        zx_rights_t* rights) {
@@ -44,6 +64,9 @@ VmObjectDispatcher::~VmObjectDispatcher() {
     // dying and the koid will no longer map to a Dispatcher. koids are never
     // recycled, and it could be a useful breadcrumb.
     vmo_->SetChildObserver(nullptr);
+    // Detaching balances the job's committed-page counter for any pages
+    // still committed; |job_| must stay set until this returns.
+    vmo_->SetMemoryObserver(nullptr);
 }
 
 
@@ -55,6 +78,19 @@ void VmObjectDispatcher::OnOneChild() {
     UpdateState(ZX_VMO_ZERO_CHILDREN, 0);
 }
 
+void VmObjectDispatcher::OnPagesCommitted(int64_t delta) {
+    job_->CountCommittedPages(delta);
+}
+
+void VmObjectDispatcher::AttributeMemory(fbl::RefPtr<JobDispatcher> job) {
+    canary_.Assert();
+    DEBUG_ASSERT(job);
+    DEBUG_ASSERT(!job_);
+
+    job_ = fbl::move(job);
+    vmo_->SetMemoryObserver(this);
+}
+
 void VmObjectDispatcher::get_name(char out_name[ZX_MAX_NAME_LEN]) const {
     canary_.Assert();
     vmo_->get_name(out_name, ZX_MAX_NAME_LEN);
@@ -113,6 +149,12 @@ zx_status_t VmObjectDispatcher::RangeOp(uint32_t op, uint64_t offset, uint64_t s
             auto status = vmo_->CommitRange(offset, size, nullptr);
             return status;
         }
+        case ZX_VMO_OP_COMMIT_ASYNC: {
+            if ((rights & ZX_RIGHT_WRITE) == 0) {
+                return ZX_ERR_ACCESS_DENIED;
+            }
+            return CommitRangeAsync(offset, size);
+        }
         case ZX_VMO_OP_DECOMMIT: {
             if ((rights & ZX_RIGHT_WRITE) == 0) {
                 return ZX_ERR_ACCESS_DENIED;
@@ -154,6 +196,58 @@ zx_status_t VmObjectDispatcher::RangeOp(uint32_t op, uint64_t offset, uint64_t s
     }
 }
 
+// static
+int VmObjectDispatcher::AsyncCommitWorker(void* arg) {
+    fbl::unique_ptr<AsyncCommitRequest> req(static_cast<AsyncCommitRequest*>(arg));
+
+    uint64_t offset = req->offset;
+    uint64_t remaining = req->size;
+    while (remaining > 0) {
+        const uint64_t chunk = fbl::min(remaining, kAsyncCommitChunk);
+        zx_status_t status = req->dispatcher->vmo()->CommitRange(offset, chunk, nullptr);
+        if (status != ZX_OK) {
+            break;
+        }
+        offset += chunk;
+        remaining -= chunk;
+    }
+
+    req->dispatcher->async_commit_in_flight_.store(false);
+    // Assert completion even if a chunk failed (e.g. out of memory); the
+    // caller can compare the VMO's committed bytes against its expectation.
+    req->dispatcher->UpdateState(0, ZX_VMO_COMMIT_COMPLETE);
+    return 0;
+}
+
+zx_status_t VmObjectDispatcher::CommitRangeAsync(uint64_t offset, uint64_t size) {
+    canary_.Assert();
+
+    if (async_commit_in_flight_.exchange(true)) {
+        return ZX_ERR_SHOULD_WAIT;
+    }
+    UpdateState(ZX_VMO_COMMIT_COMPLETE, 0);
+
+    fbl::AllocChecker ac;
+    auto req = fbl::make_unique_checked<AsyncCommitRequest>(&ac);
+    if (!ac.check()) {
+        async_commit_in_flight_.store(false);
+        return ZX_ERR_NO_MEMORY;
+    }
+    req->dispatcher = fbl::WrapRefPtr(this);
+    req->offset = offset;
+    req->size = size;
+
+    thread_t* t = thread_create("vmo-commit-async", AsyncCommitWorker, req.get(),
+                                LOW_PRIORITY);
+    if (!t) {
+        async_commit_in_flight_.store(false);
+        return ZX_ERR_NO_MEMORY;
+    }
+    __UNUSED AsyncCommitRequest* owned_by_worker = req.release();
+    thread_detach_and_resume(t);
+    return ZX_OK;
+}
+
 zx_status_t VmObjectDispatcher::SetMappingCachePolicy(uint32_t cache_policy) {
     return vmo_->SetMappingCachePolicy(cache_policy);
 }
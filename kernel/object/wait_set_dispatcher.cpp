@@ -0,0 +1,251 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <object/wait_set_dispatcher.h>
+
+#include <assert.h>
+#include <err.h>
+
+#include <fbl/alloc_checker.h>
+#include <object/handle.h>
+#include <object/thread_dispatcher.h>
+#include <zircon/rights.h>
+#include <zircon/types.h>
+
+WaitSetDispatcher::Entry::Entry(WaitSetDispatcher* wait_set, uint64_t key,
+                                const Handle* handle, fbl::RefPtr<Dispatcher> dispatcher,
+                                zx_signals_t watching)
+    : wait_set_(wait_set), key_(key), handle_(handle),
+      dispatcher_(fbl::move(dispatcher)), watching_(watching) {}
+
+StateObserver::Flags WaitSetDispatcher::Entry::OnInitialize(zx_signals_t initial_state,
+                                                            const CountInfo* cinfo) {
+    Guard<fbl::Mutex> guard{wait_set_->get_lock()};
+    observed_ = initial_state;
+    if (observed_ & watching_)
+        wait_set_->MakeReadyLocked(this);
+    return 0;
+}
+
+StateObserver::Flags WaitSetDispatcher::Entry::OnStateChange(zx_signals_t new_state) {
+    Guard<fbl::Mutex> guard{wait_set_->get_lock()};
+    observed_ = new_state;
+    if (canceled_)
+        return 0;
+    if (observed_ & watching_) {
+        wait_set_->MakeReadyLocked(this);
+    } else {
+        wait_set_->MakeNotReadyLocked(this);
+    }
+    return 0;
+}
+
+StateObserver::Flags WaitSetDispatcher::Entry::OnCancel(const Handle* handle) {
+    if (handle != handle_)
+        return 0;
+    Guard<fbl::Mutex> guard{wait_set_->get_lock()};
+    canceled_ = true;
+    wait_set_->MakeReadyLocked(this);
+    return kHandled;
+}
+
+zx_status_t WaitSetDispatcher::Create(uint32_t options, fbl::RefPtr<Dispatcher>* dispatcher,
+                                      zx_rights_t* rights) {
+    if (options != 0u)
+        return ZX_ERR_INVALID_ARGS;
+
+    fbl::AllocChecker ac;
+    auto disp = new (&ac) WaitSetDispatcher();
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    *rights = ZX_DEFAULT_WAIT_SET_RIGHTS;
+    *dispatcher = fbl::AdoptRef<Dispatcher>(disp);
+    return ZX_OK;
+}
+
+WaitSetDispatcher::WaitSetDispatcher() {}
+
+WaitSetDispatcher::~WaitSetDispatcher() {
+    // on_zero_handles() must have unregistered and freed every entry.
+    DEBUG_ASSERT(entries_.is_empty());
+    DEBUG_ASSERT(ready_.is_empty());
+}
+
+void WaitSetDispatcher::on_zero_handles() {
+    canary_.Assert();
+
+    // Unregister every fully added entry. Entries still in kAddPending belong
+    // to a concurrent AddEntry(), which will notice |zero_handles_| and tear
+    // its entry down itself. RemoveObserver() must be called outside our lock
+    // since it takes the watched object's state tracker lock.
+    for (;;) {
+        Entry* entry = nullptr;
+        {
+            Guard<fbl::Mutex> guard{get_lock()};
+            zero_handles_ = true;
+            for (auto& e : entries_) {
+                if (e.state() == Entry::State::kAdded) {
+                    entry = &e;
+                    break;
+                }
+            }
+            if (!entry)
+                break;
+            entries_.erase(*entry);
+        }
+        entry->dispatcher()->RemoveObserver(entry);
+        {
+            Guard<fbl::Mutex> guard{get_lock()};
+            if (entry->InReadyList())
+                MakeNotReadyLocked(entry);
+        }
+        delete entry;
+    }
+}
+
+zx_status_t WaitSetDispatcher::AddEntry(uint64_t key, Handle* handle, zx_signals_t signals) {
+    canary_.Assert();
+
+    fbl::RefPtr<Dispatcher> dispatcher = handle->dispatcher();
+    if (!dispatcher->has_state_tracker())
+        return ZX_ERR_NOT_SUPPORTED;
+
+    fbl::AllocChecker ac;
+    Entry* entry = new (&ac) Entry(this, key, handle, fbl::move(dispatcher), signals);
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        zx_status_t status = ZX_OK;
+        if (zero_handles_) {
+            status = ZX_ERR_BAD_STATE;
+        } else if (FindLocked(key)) {
+            status = ZX_ERR_ALREADY_EXISTS;
+        }
+        if (status != ZX_OK) {
+            guard.Release();
+            delete entry;
+            return status;
+        }
+        entries_.push_back(entry);
+    }
+
+    // Registration runs the entry's OnInitialize() under the watched object's
+    // state tracker lock, which may already mark the entry ready.
+    zx_status_t status = entry->dispatcher()->add_observer(entry);
+
+    bool defunct = false;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        if (status != ZX_OK || zero_handles_) {
+            entries_.erase(*entry);
+            if (entry->InReadyList())
+                MakeNotReadyLocked(entry);
+            defunct = true;
+        } else {
+            entry->set_state(Entry::State::kAdded);
+        }
+    }
+    if (defunct) {
+        if (status == ZX_OK) {
+            // Lost the race with on_zero_handles(); back the observer out.
+            entry->dispatcher()->RemoveObserver(entry);
+            {
+                Guard<fbl::Mutex> guard{get_lock()};
+                if (entry->InReadyList())
+                    MakeNotReadyLocked(entry);
+            }
+            status = ZX_ERR_BAD_STATE;
+        }
+        delete entry;
+    }
+    return status;
+}
+
+zx_status_t WaitSetDispatcher::RemoveEntry(uint64_t key) {
+    canary_.Assert();
+
+    Entry* entry = nullptr;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        entry = FindLocked(key);
+        if (!entry)
+            return ZX_ERR_NOT_FOUND;
+        // A concurrent AddEntry() is still registering this entry.
+        if (entry->state() == Entry::State::kAddPending)
+            return ZX_ERR_SHOULD_WAIT;
+        entries_.erase(*entry);
+    }
+
+    // After RemoveObserver() returns no callback is in flight, but one may
+    // have put the entry back on the ready list in the window above.
+    entry->dispatcher()->RemoveObserver(entry);
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        if (entry->InReadyList())
+            MakeNotReadyLocked(entry);
+    }
+    delete entry;
+    return ZX_OK;
+}
+
+zx_status_t WaitSetDispatcher::Wait(zx_time_t deadline, uint32_t max_results,
+                                    zx_waitset_result_t* results, uint32_t* num_results) {
+    canary_.Assert();
+    DEBUG_ASSERT(max_results > 0u);
+
+    for (;;) {
+        {
+            Guard<fbl::Mutex> guard{get_lock()};
+            if (!ready_.is_empty()) {
+                uint32_t count = 0u;
+                for (const auto& entry : ready_) {
+                    if (count == max_results)
+                        break;
+                    results[count].key = entry.key();
+                    results[count].status = entry.canceled() ? ZX_ERR_CANCELED : ZX_OK;
+                    results[count].observed = entry.observed();
+                    ++count;
+                }
+                *num_results = count;
+                return ZX_OK;
+            }
+        }
+
+        zx_status_t status;
+        {
+            ThreadDispatcher::AutoBlocked by(ThreadDispatcher::Blocked::WAIT_MANY);
+            status = event_.Wait(deadline);
+        }
+        if (status != ZX_OK)
+            return status;
+        // Signaled, but entries may have gone not-ready again before we took
+        // the lock; go around and look.
+    }
+}
+
+WaitSetDispatcher::Entry* WaitSetDispatcher::FindLocked(uint64_t key) {
+    for (auto& entry : entries_) {
+        if (entry.key() == key)
+            return &entry;
+    }
+    return nullptr;
+}
+
+void WaitSetDispatcher::MakeReadyLocked(Entry* entry) {
+    if (!entry->InReadyList()) {
+        ready_.push_back(entry);
+        event_.Signal();
+    }
+}
+
+void WaitSetDispatcher::MakeNotReadyLocked(Entry* entry) {
+    ready_.erase(*entry);
+    if (ready_.is_empty())
+        event_.Unsignal();
+}
@@ -23,6 +23,7 @@
 #include <kernel/cmdline.h>
 #include <kernel/dpc.h>
 #include <kernel/spinlock.h>
+#include <lib/crashlog_ring.h>
 #include <lk/init.h>
 #include <object/resource_dispatcher.h>
 #include <vm/kstack.h>
@@ -78,6 +79,7 @@ static pmm_arena_info_t mem_arena = {
     /* .name */ "sdram",
     /* .flags */ 0,
     /* .priority */ 0,
+    /* .numa_node */ 0,
     /* .base */ 0, // filled in by zbi
     /* .size */ 0, // filled in by zbi
 };
@@ -478,71 +480,21 @@ void platform_halt(platform_halt_action suggested_action, platform_halt_reason r
         ;
 }
 
-typedef struct {
-    //TODO: combine with x86 nvram crashlog handling
-    //TODO: ECC for more robust crashlogs
-    uint64_t magic;
-    uint64_t length;
-    uint64_t nmagic;
-    uint64_t nlength;
-} log_hdr_t;
-
-#define NVRAM_MAGIC (0x6f8962d66b28504fULL)
-
 size_t platform_stow_crashlog(void* log, size_t len) {
-    size_t max = lastlog_nvram.length - sizeof(log_hdr_t);
     void* nvram = paddr_to_physmap(lastlog_nvram.base);
     if (nvram == NULL) {
         return 0;
     }
-
-    if (log == NULL) {
-        return max;
-    }
-    if (len > max) {
-        len = max;
-    }
-
-    log_hdr_t hdr = {
-        .magic = NVRAM_MAGIC,
-        .length = len,
-        .nmagic = ~NVRAM_MAGIC,
-        .nlength = ~len,
-    };
-    memcpy(nvram, &hdr, sizeof(hdr));
-    memcpy(static_cast<char*>(nvram) + sizeof(hdr), log, len);
-    arch_clean_cache_range((uintptr_t)nvram, sizeof(hdr) + len);
-    return len;
+    return crashlog_ring_stow(nvram, lastlog_nvram.length, log, len);
 }
 
 size_t platform_recover_crashlog(size_t len, void* cookie,
                                  void (*func)(const void* data, size_t, size_t len, void* cookie)) {
-    size_t max = lastlog_nvram.length - sizeof(log_hdr_t);
     void* nvram = paddr_to_physmap(lastlog_nvram.base);
     if (nvram == NULL) {
         return 0;
     }
-    log_hdr_t hdr;
-    memcpy(&hdr, nvram, sizeof(hdr));
-    if ((hdr.magic != NVRAM_MAGIC) || (hdr.length > max) ||
-        (hdr.nmagic != ~NVRAM_MAGIC) || (hdr.nlength != ~hdr.length)) {
-        printf("nvram-crashlog: bad header: %016lx %016lx %016lx %016lx\n",
-               hdr.magic, hdr.length, hdr.nmagic, hdr.nlength);
-        return 0;
-    }
-    if (len == 0) {
-        return hdr.length;
-    }
-    if (len > hdr.length) {
-        len = hdr.length;
-    }
-    func(static_cast<char*>(nvram) + sizeof(hdr), 0, len, cookie);
-
-    // invalidate header so we don't get a stale crashlog
-    // on future boots
-    hdr.magic = 0;
-    memcpy(nvram, &hdr, sizeof(hdr));
-    return hdr.length;
+    return crashlog_ring_recover(nvram, lastlog_nvram.length, len, cookie, func);
 }
 
 zx_status_t platform_mexec_patch_zbi(uint8_t* zbi, const size_t len) {
@@ -18,6 +18,7 @@ KERNEL_DEFINES += \
 
 MODULE_DEPS += \
 	kernel/lib/cbuf \
+	kernel/lib/crashlog \
 	kernel/lib/lockdep \
 	kernel/lib/fbl \
 	kernel/lib/memory_limit \
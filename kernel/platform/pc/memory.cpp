@@ -117,6 +117,9 @@ static zx_status_t mem_arena_init(boot_addr_range_t* range) {
     snprintf(base_arena.name, sizeof(base_arena.name), "%s", "memory");
     base_arena.priority = 1;
     base_arena.flags = 0;
+    // Without SRAT parsing all memory lands on node 0; platforms that learn
+    // better can tag per-range arenas here.
+    base_arena.numa_node = 0;
 
     zx_status_t status;
     for (range->reset(range), range->advance(range); !range->is_reset; range->advance(range)) {
@@ -16,6 +16,7 @@
 #include <arch/x86/apic.h>
 #include <arch/x86/cpu_topology.h>
 #include <arch/x86/mmu.h>
+#include <arch/x86/mp.h>
 #include <assert.h>
 #if defined(WITH_KERNEL_PCIE)
 #include <dev/pcie_bus_driver.h>
@@ -24,6 +25,8 @@
 #include <err.h>
 #include <fbl/alloc_checker.h>
 #include <kernel/cmdline.h>
+#include <kernel/topology.h>
+#include <lib/crashlog_ring.h>
 #include <lib/debuglog.h>
 #include <libzbi/zbi-cpp.h>
 #include <lk/init.h>
@@ -315,73 +318,25 @@ static char16_t crashlog_name[] = ZIRCON_CRASHLOG_EFIVAR;
 
 static fbl::RefPtr<VmAspace> efi_aspace;
 
-typedef struct {
-    uint64_t magic;
-    uint64_t length;
-    uint64_t nmagic;
-    uint64_t nlength;
-} log_hdr_t;
-
-#define NVRAM_MAGIC (0x6f8962d66b28504fULL)
-
 static size_t nvram_stow_crashlog(void* log, size_t len) {
-    size_t max = bootloader.nvram.length - sizeof(log_hdr_t);
     void* nvram = paddr_to_physmap(bootloader.nvram.base);
     if (nvram == NULL) {
         return 0;
     }
-
-    if (log == NULL) {
-        return max;
-    }
-    if (len > max) {
-        len = max;
-    }
-
-    log_hdr_t hdr = {
-        .magic = NVRAM_MAGIC,
-        .length = len,
-        .nmagic = ~NVRAM_MAGIC,
-        .nlength = ~len,
-    };
-    memcpy(nvram, &hdr, sizeof(hdr));
-    memcpy(static_cast<char*>(nvram) + sizeof(hdr), log, len);
-    arch_clean_cache_range((uintptr_t)nvram, sizeof(hdr) + len);
-    return len;
+    return crashlog_ring_stow(nvram, bootloader.nvram.length, log, len);
 }
 
 static size_t nvram_recover_crashlog(size_t len, void* cookie,
                                      void (*func)(const void* data, size_t, size_t len, void* cookie)) {
-    size_t max = bootloader.nvram.length - sizeof(log_hdr_t);
     void* nvram = paddr_to_physmap(bootloader.nvram.base);
     if (nvram == NULL) {
         return 0;
     }
-    log_hdr_t hdr;
-    memcpy(&hdr, nvram, sizeof(hdr));
-    if ((hdr.magic != NVRAM_MAGIC) || (hdr.length > max) ||
-        (hdr.nmagic != ~NVRAM_MAGIC) || (hdr.nlength != ~hdr.length)) {
-        printf("nvram-crashlog: bad header: %016lx %016lx %016lx %016lx\n",
-               hdr.magic, hdr.length, hdr.nmagic, hdr.nlength);
-        return 0;
-    }
-    if (len == 0) {
-        return hdr.length;
-    }
-    if (len > hdr.length) {
-        len = hdr.length;
-    }
-    func(static_cast<char*>(nvram) + sizeof(hdr), 0, len, cookie);
-
-    // invalidate header so we don't get a stale crashlog
-    // on future boots
-    hdr.magic = 0;
-    memcpy(nvram, &hdr, sizeof(hdr));
-    return hdr.length;
+    return crashlog_ring_recover(nvram, bootloader.nvram.length, len, cookie, func);
 }
 
 void platform_init_crashlog(void) {
-    if (bootloader.nvram.base && bootloader.nvram.length > sizeof(log_hdr_t)) {
+    if (bootloader.nvram.base && bootloader.nvram.length >= CRASHLOG_RING_MIN_LEN) {
         // Nothing to do for simple nvram logs
         return;
     } else {
@@ -877,6 +832,17 @@ static void platform_init_smp(void) {
 
     x86_init_smp(apic_ids.get(), num_cpus);
 
+    // record where each selected cpu sits in the cache hierarchy so the
+    // scheduler can prefer SMT siblings and same-LLC cpus at wakeup
+    for (uint32_t i = 0; i < num_cpus; ++i) {
+        x86_cpu_topology_t topo;
+        x86_cpu_topology_decode(apic_ids[i], &topo);
+
+        int cpu_num = x86_apic_id_to_cpu_num(apic_ids[i]);
+        DEBUG_ASSERT(cpu_num >= 0);
+        topology_set_cpu_info((cpu_num_t)cpu_num, topo.package_id, topo.node_id, topo.core_id);
+    }
+
     // trim the boot cpu out of the apic id list before passing to the AP booting routine
     for (uint i = 0; i < num_cpus - 1; ++i) {
         if (apic_ids[i] == bsp_apic_id) {
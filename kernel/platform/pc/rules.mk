@@ -31,6 +31,7 @@ MODULE_DEPS += \
     third_party/lib/acpica \
     third_party/lib/cksum \
     kernel/lib/cbuf \
+    kernel/lib/crashlog \
     kernel/lib/gfxconsole \
     kernel/lib/fixed_point \
     kernel/lib/lockdep \
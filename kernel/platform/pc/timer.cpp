@@ -171,6 +171,16 @@ zx_ticks_t current_ticks(void) {
     return rdtsc();
 }
 
+bool platform_monotonic_ticks_rate(struct fp_32_64* ns_per_tick) {
+    // When the wall clock is the HPET or PIT, the TSC may still be
+    // calibrated for cheap timing, but current_time() is not derived
+    // from it.
+    if (wall_clock != CLOCK_TSC)
+        return false;
+    *ns_per_tick = ns_per_tsc;
+    return true;
+}
+
 zx_time_t ticks_to_nanos(zx_ticks_t ticks) {
     return u64_mul_u64_fp32_64(ticks, ns_per_tsc);
 }
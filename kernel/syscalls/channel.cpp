@@ -14,6 +14,7 @@
 #include <object/channel_dispatcher.h>
 #include <object/handle.h>
 #include <object/message_packet.h>
+#include <object/port_dispatcher.h>
 #include <object/process_dispatcher.h>
 #include <zircon/syscalls/policy.h>
 #include <zircon/types.h>
@@ -313,6 +314,121 @@ zx_status_t sys_channel_write(zx_handle_t handle_value, uint32_t options,
     return ZX_OK;
 }
 
+zx_status_t sys_channel_writev(zx_handle_t handle_value, uint32_t options,
+                               user_in_ptr<const zx_channel_iovec_t> user_iovecs,
+                               uint32_t num_iovecs,
+                               user_in_ptr<const zx_handle_t> user_handles,
+                               uint32_t num_handles) {
+    LTRACEF("handle %x iovecs %p num_iovecs %u handles %p num_handles %u options 0x%x\n",
+            handle_value, user_iovecs.get(), num_iovecs, user_handles.get(), num_handles, options);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    if (options != 0u || num_iovecs > ZX_CHANNEL_MAX_MSG_IOVECS) {
+        up->RemoveHandles(user_handles, num_handles);
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    // Snapshot the iovec array; the segment buffers are copied from user
+    // space directly into the message to avoid an intermediate gather copy.
+    zx_channel_iovec_t iovecs[ZX_CHANNEL_MAX_MSG_IOVECS];
+    zx_status_t status = user_iovecs.copy_array_from_user(iovecs, num_iovecs);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+    for (uint32_t i = 0; i < num_iovecs; ++i) {
+        if (iovecs[i].reserved != 0) {
+            up->RemoveHandles(user_handles, num_handles);
+            return ZX_ERR_INVALID_ARGS;
+        }
+    }
+
+    fbl::RefPtr<ChannelDispatcher> channel;
+    status = up->GetDispatcherWithRights(handle_value, ZX_RIGHT_WRITE, &channel);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+
+    fbl::unique_ptr<MessagePacket> msg;
+    status = MessagePacket::Create(iovecs, num_iovecs, num_handles, &msg);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+
+    if (num_handles > 0u) {
+        status = msg_put_handles(up, msg.get(), user_handles, num_handles,
+                                 static_cast<Dispatcher*>(channel.get()));
+        if (status != ZX_OK)
+            return status;
+    }
+
+    const uint32_t num_bytes = msg->data_size();
+
+    status = channel->Write(fbl::move(msg));
+    if (status != ZX_OK)
+        return status;
+
+    ktrace(TAG_CHANNEL_WRITE, (uint32_t)channel->get_koid(), num_bytes, num_handles, 0);
+    return ZX_OK;
+}
+
+zx_status_t sys_channel_call_async(zx_handle_t handle_value, uint32_t options,
+                                   zx_handle_t port_value, uint64_t key,
+                                   user_in_ptr<const void> user_bytes, uint32_t num_bytes,
+                                   user_in_ptr<const zx_handle_t> user_handles,
+                                   uint32_t num_handles,
+                                   user_out_ptr<zx_txid_t> out_txid) {
+    LTRACEF("handle %x port %x key %" PRIu64 " bytes %p num_bytes %u num_handles %u\n",
+            handle_value, port_value, key, user_bytes.get(), num_bytes, num_handles);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    if (options != 0u || num_bytes < sizeof(zx_txid_t)) {
+        up->RemoveHandles(user_handles, num_handles);
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    fbl::RefPtr<ChannelDispatcher> channel;
+    zx_status_t status =
+        up->GetDispatcherWithRights(handle_value, ZX_RIGHT_WRITE | ZX_RIGHT_READ, &channel);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+
+    fbl::RefPtr<PortDispatcher> port;
+    status = up->GetDispatcherWithRights(port_value, ZX_RIGHT_WRITE, &port);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+
+    fbl::unique_ptr<MessagePacket> msg;
+    status = MessagePacket::Create(user_bytes, num_bytes, num_handles, &msg);
+    if (status != ZX_OK) {
+        up->RemoveHandles(user_handles, num_handles);
+        return status;
+    }
+
+    if (num_handles > 0u) {
+        status = msg_put_handles(up, msg.get(), user_handles, num_handles,
+                                 static_cast<Dispatcher*>(channel.get()));
+        if (status != ZX_OK)
+            return status;
+    }
+
+    zx_txid_t txid;
+    status = channel->CallAsync(fbl::move(msg), fbl::move(port), key, &txid);
+    if (status != ZX_OK)
+        return status;
+
+    ktrace(TAG_CHANNEL_WRITE, (uint32_t)channel->get_koid(), num_bytes, num_handles, 0);
+    return out_txid.copy_to_user(txid);
+}
+
 zx_status_t sys_channel_call_noretry(zx_handle_t handle_value, uint32_t options,
                                      zx_time_t deadline,
                                      user_in_ptr<const zx_channel_call_args_t> user_args,
@@ -447,7 +447,7 @@ zx_status_t sys_interrupt_create(zx_handle_t src_obj, uint32_t src_num,
 zx_status_t sys_interrupt_bind(zx_handle_t inth, zx_handle_t porth,
                          uint64_t key, uint32_t options) {
     LTRACEF("handle %x\n", inth);
-    if (options) {
+    if (options & ~ZX_INTERRUPT_BIND_COALESCE) {
         return ZX_ERR_INVALID_ARGS;
     }
 
@@ -467,7 +467,7 @@ zx_status_t sys_interrupt_bind(zx_handle_t inth, zx_handle_t porth,
         return ZX_ERR_WRONG_TYPE;
     }
 
-    return interrupt->Bind(port, interrupt, key);
+    return interrupt->Bind(port, interrupt, key, options);
 }
 
 zx_status_t sys_interrupt_ack(zx_handle_t inth) {
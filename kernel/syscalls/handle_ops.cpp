@@ -69,6 +69,70 @@ static zx_status_t handle_dup_replace(
     return status;
 }
 
+static zx_status_t handle_dup_replace_many(
+    bool is_replace, user_inout_ptr<zx_handle_op_t> user_ops, size_t count) {
+    LTRACEF("count %zu\n", count);
+
+    if (count == 0u)
+        return ZX_OK;
+    if (count > ZX_HANDLE_OP_MAX_ITEMS)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    zx_handle_op_t ops[ZX_HANDLE_OP_MAX_ITEMS];
+    if (user_ops.copy_array_from_user(ops, count) != ZX_OK)
+        return ZX_ERR_INVALID_ARGS;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    // Validate and duplicate everything under a single handle table lock
+    // acquisition, before any state visible to the caller changes: an error
+    // leaves the handle table untouched and the unwind is just the
+    // HandleOwner destructors.
+    HandleOwner new_handles[ZX_HANDLE_OP_MAX_ITEMS];
+    {
+        Guard<fbl::Mutex> guard{up->handle_table_lock()};
+        for (size_t ix = 0; ix != count; ++ix) {
+            auto source = up->GetHandleLocked(ops[ix].handle);
+            if (!source)
+                return ZX_ERR_BAD_HANDLE;
+
+            if (!is_replace) {
+                if (!source->HasRights(ZX_RIGHT_DUPLICATE))
+                    return ZX_ERR_ACCESS_DENIED;
+            }
+
+            zx_rights_t rights = ops[ix].rights;
+            if (rights == ZX_RIGHT_SAME_RIGHTS) {
+                rights = source->rights();
+            } else if ((source->rights() & rights) != rights) {
+                return ZX_ERR_INVALID_ARGS;
+            }
+
+            new_handles[ix] = Handle::Dup(source, rights);
+            if (!new_handles[ix])
+                return ZX_ERR_NO_MEMORY;
+            ops[ix].result = up->MapHandleToValue(new_handles[ix].get());
+        }
+    }
+
+    // Copy the results out before installing anything, mirroring the
+    // begin_copyout/finish_copyout order of the single-handle wrappers: a
+    // faulting buffer leaves the handle table unchanged.
+    if (user_ops.copy_array_to_user(ops, count) != ZX_OK)
+        return ZX_ERR_INVALID_ARGS;
+
+    {
+        Guard<fbl::Mutex> guard{up->handle_table_lock()};
+        if (is_replace) {
+            for (size_t ix = 0; ix != count; ++ix)
+                up->RemoveHandleLocked(ops[ix].handle);
+        }
+        for (size_t ix = 0; ix != count; ++ix)
+            up->AddHandleLocked(fbl::move(new_handles[ix]));
+    }
+    return ZX_OK;
+}
+
 zx_status_t sys_handle_duplicate(
     zx_handle_t handle_value, zx_rights_t rights, user_out_handle* out) {
     return handle_dup_replace(false, handle_value, rights, out);
@@ -78,3 +142,13 @@ zx_status_t sys_handle_replace(
     zx_handle_t handle_value, zx_rights_t rights, user_out_handle* out) {
     return handle_dup_replace(true, handle_value, rights, out);
 }
+
+zx_status_t sys_handle_duplicate_many(
+    user_inout_ptr<zx_handle_op_t> user_ops, size_t count) {
+    return handle_dup_replace_many(false, user_ops, count);
+}
+
+zx_status_t sys_handle_replace_many(
+    user_inout_ptr<zx_handle_op_t> user_ops, size_t count) {
+    return handle_dup_replace_many(true, user_ops, count);
+}
@@ -499,7 +499,10 @@ zx_status_t sys_object_get_info(zx_handle_t handle, uint32_t topic,
         stats.total_bytes = total * PAGE_SIZE;
         size_t other_bytes = stats.total_bytes;
 
-        stats.free_bytes = state_count[VM_PAGE_STATE_FREE] * PAGE_SIZE;
+        // pages sitting in the pmm's per-cpu caches are free for all
+        // practical purposes
+        stats.free_bytes =
+            (state_count[VM_PAGE_STATE_FREE] + state_count[VM_PAGE_STATE_CACHE]) * PAGE_SIZE;
         other_bytes -= stats.free_bytes;
 
         stats.wired_bytes = state_count[VM_PAGE_STATE_WIRED] * PAGE_SIZE;
@@ -588,6 +591,34 @@ zx_status_t sys_object_get_info(zx_handle_t handle, uint32_t topic,
         return single_record_result(
             _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
     }
+    case ZX_INFO_JOB_STATS: {
+        fbl::RefPtr<JobDispatcher> job;
+        auto status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &job);
+        if (status != ZX_OK)
+            return status;
+
+        // The counters are maintained on the lifecycle paths; no tree or
+        // handle table walk happens here.
+        zx_info_job_stats_t info = {};
+        job->GetJobStats(&info);
+
+        return single_record_result(
+            _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
+    }
+    case ZX_INFO_JOB_MEMORY: {
+        fbl::RefPtr<JobDispatcher> job;
+        auto status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &job);
+        if (status != ZX_OK)
+            return status;
+
+        // Cheap enough for high-frequency polling: the rollup counter is
+        // maintained on the VMO commit/decommit paths.
+        zx_info_job_memory_t info = {};
+        job->GetJobMemory(&info);
+
+        return single_record_result(
+            _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
+    }
 
     default:
         return ZX_ERR_NOT_SUPPORTED;
@@ -669,6 +700,15 @@ zx_status_t sys_object_get_property(zx_handle_t handle_value, uint32_t property,
         size_t value = socket->TransmitBufferSize();
         return _value.reinterpret<size_t>().copy_to_user(value);
     }
+    case ZX_PROP_SOCKET_TX_BUF_THRESHOLD: {
+        if (size < sizeof(size_t))
+            return ZX_ERR_BUFFER_TOO_SMALL;
+        auto socket = DownCastDispatcher<SocketDispatcher>(&dispatcher);
+        if (!socket)
+            return ZX_ERR_WRONG_TYPE;
+        size_t value = socket->GetWriteThreshold();
+        return _value.reinterpret<size_t>().copy_to_user(value);
+    }
     case ZX_PROP_CHANNEL_TX_MSG_MAX: {
         if (size < sizeof(size_t)) {
             return ZX_ERR_BUFFER_TOO_SMALL;
@@ -765,6 +805,18 @@ zx_status_t sys_object_set_property(zx_handle_t handle_value, uint32_t property,
             return status;
         return process->set_debug_addr(value);
     }
+    case ZX_PROP_SOCKET_TX_BUF_THRESHOLD: {
+        if (size < sizeof(size_t))
+            return ZX_ERR_BUFFER_TOO_SMALL;
+        auto socket = DownCastDispatcher<SocketDispatcher>(&dispatcher);
+        if (!socket)
+            return ZX_ERR_WRONG_TYPE;
+        size_t value = 0;
+        zx_status_t status = _value.reinterpret<const size_t>().copy_from_user(&value);
+        if (status != ZX_OK)
+            return status;
+        return socket->SetWriteThreshold(value);
+    }
     }
 
     return ZX_ERR_INVALID_ARGS;
@@ -796,6 +848,42 @@ zx_status_t sys_object_signal_peer(zx_handle_t handle_value, uint32_t clear_mask
     return dispatcher->user_signal(clear_mask, set_mask, true);
 }
 
+zx_status_t sys_object_signal_batch(user_in_ptr<const zx_signal_item_t> user_items,
+                                    uint32_t count) {
+    LTRACEF("count %u\n", count);
+
+    if (count == 0)
+        return ZX_OK;
+    if (count > ZX_SIGNAL_BATCH_MAX_ITEMS)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    zx_signal_item_t items[ZX_SIGNAL_BATCH_MAX_ITEMS];
+    if (user_items.copy_array_from_user(items, count) != ZX_OK)
+        return ZX_ERR_INVALID_ARGS;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    // Resolve and signal all items under a single handle table pass. Items
+    // are processed in order; on error the earlier items have already been
+    // signaled.
+    Guard<fbl::Mutex> guard{up->handle_table_lock()};
+
+    for (uint32_t ix = 0; ix != count; ++ix) {
+        Handle* handle = up->GetHandleLocked(items[ix].handle);
+        if (!handle)
+            return ZX_ERR_BAD_HANDLE;
+        if (!handle->HasRights(ZX_RIGHT_SIGNAL))
+            return ZX_ERR_ACCESS_DENIED;
+
+        zx_status_t status = handle->dispatcher()->user_signal(
+            items[ix].clear_mask, items[ix].set_mask, false);
+        if (status != ZX_OK)
+            return status;
+    }
+
+    return ZX_OK;
+}
+
 // Given a kernel object with children objects, obtain a handle to the
 // child specified by the provided kernel object id.
 zx_status_t sys_object_get_child(zx_handle_t handle, uint64_t koid,
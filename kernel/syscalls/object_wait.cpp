@@ -19,6 +19,7 @@
 #include <object/handle.h>
 #include <object/port_dispatcher.h>
 #include <object/process_dispatcher.h>
+#include <object/wait_set_dispatcher.h>
 #include <object/wait_state_observer.h>
 
 #include <fbl/inline_array.h>
@@ -186,3 +187,89 @@ zx_status_t sys_object_wait_async(zx_handle_t handle_value, zx_handle_t port_han
         return port->MakeObserver(options, handle, key, signals);
     }
 }
+
+// ensure public headers agree
+static_assert(ZX_WAITSET_MAX_RESULTS == 32u, "");
+
+zx_status_t sys_waitset_create(uint32_t options, user_out_handle* out) {
+    LTRACEF("options 0x%x\n", options);
+
+    auto up = ProcessDispatcher::GetCurrent();
+    zx_status_t res = up->QueryPolicy(ZX_POL_NEW_WAITSET);
+    if (res != ZX_OK)
+        return res;
+
+    fbl::RefPtr<Dispatcher> dispatcher;
+    zx_rights_t rights;
+
+    zx_status_t result = WaitSetDispatcher::Create(options, &dispatcher, &rights);
+    if (result == ZX_OK)
+        result = out->make(fbl::move(dispatcher), rights);
+    return result;
+}
+
+zx_status_t sys_waitset_add(zx_handle_t ws_handle_value, uint64_t key,
+                            zx_handle_t handle_value, zx_signals_t signals) {
+    LTRACEF("waitset %x handle %x key %" PRIu64 "\n", ws_handle_value, handle_value, key);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> ws;
+    zx_status_t status = up->GetDispatcherWithRights(ws_handle_value, ZX_RIGHT_WRITE, &ws);
+    if (status != ZX_OK)
+        return status;
+
+    {
+        Guard<fbl::Mutex> guard{up->handle_table_lock()};
+        Handle* handle = up->GetHandleLocked(handle_value);
+        if (!handle)
+            return ZX_ERR_BAD_HANDLE;
+        if (!handle->HasRights(ZX_RIGHT_WAIT))
+            return ZX_ERR_ACCESS_DENIED;
+
+        return ws->AddEntry(key, handle, signals);
+    }
+}
+
+zx_status_t sys_waitset_remove(zx_handle_t ws_handle_value, uint64_t key) {
+    LTRACEF("waitset %x key %" PRIu64 "\n", ws_handle_value, key);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> ws;
+    zx_status_t status = up->GetDispatcherWithRights(ws_handle_value, ZX_RIGHT_WRITE, &ws);
+    if (status != ZX_OK)
+        return status;
+
+    return ws->RemoveEntry(key);
+}
+
+zx_status_t sys_waitset_wait(zx_handle_t ws_handle_value, zx_time_t deadline,
+                             user_out_ptr<zx_waitset_result_t> user_results, uint32_t count,
+                             user_out_ptr<uint32_t> user_actual) {
+    LTRACEF("waitset %x count %u\n", ws_handle_value, count);
+
+    if (count == 0u || count > ZX_WAITSET_MAX_RESULTS)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> ws;
+    zx_status_t status = up->GetDispatcherWithRights(ws_handle_value, ZX_RIGHT_READ, &ws);
+    if (status != ZX_OK)
+        return status;
+
+    zx_waitset_result_t results[ZX_WAITSET_MAX_RESULTS];
+    uint32_t num_results = 0u;
+    status = ws->Wait(deadline, count, results, &num_results);
+    if (status != ZX_OK)
+        return status;
+
+    if (user_results.copy_array_to_user(results, num_results) != ZX_OK)
+        return ZX_ERR_INVALID_ARGS;
+    if (user_actual) {
+        if (user_actual.copy_to_user(num_results) != ZX_OK)
+            return ZX_ERR_INVALID_ARGS;
+    }
+    return ZX_OK;
+}
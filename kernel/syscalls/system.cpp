@@ -14,6 +14,7 @@
 #include <lib/debuglog.h>
 #include <libzbi/zbi-cpp.h>
 #include <mexec.h>
+#include <object/job_dispatcher.h>
 #include <object/process_dispatcher.h>
 #include <object/resource.h>
 #include <object/vm_object_dispatcher.h>
@@ -30,6 +31,7 @@
 #include <zircon/syscalls/system.h>
 #include <zircon/types.h>
 
+#include "priv.h"
 #include "system_priv.h"
 
 #define LOCAL_TRACE 0
@@ -409,3 +411,27 @@ zx_status_t sys_system_powerctl(zx_handle_t root_rsrc, uint32_t cmd,
     }
     return ZX_OK;
 }
+
+zx_status_t sys_system_get_event(zx_handle_t root_job, uint32_t kind,
+                                 user_out_handle* event) {
+    // The root job handle stands in as the capability to receive system
+    // events; only the holder of the real root job may obtain them.
+    auto up = ProcessDispatcher::GetCurrent();
+    fbl::RefPtr<JobDispatcher> job;
+    zx_status_t status = up->GetDispatcherWithRights(root_job, ZX_RIGHT_MANAGE_JOB, &job);
+    if (status != ZX_OK) {
+        return status;
+    }
+    if (job != GetRootJobDispatcher()) {
+        return ZX_ERR_ACCESS_DENIED;
+    }
+
+    switch (kind) {
+        case ZX_SYSTEM_EVENT_MEMORY_PRESSURE:
+            // No ZX_RIGHT_SIGNAL: only the kernel drives the pressure signals.
+            return event->make(GetMemPressureEventDispatcher(),
+                               ZX_RIGHTS_BASIC | ZX_RIGHT_READ);
+        default:
+            return ZX_ERR_INVALID_ARGS;
+    }
+}
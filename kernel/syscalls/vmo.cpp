@@ -8,12 +8,16 @@
 #include <inttypes.h>
 #include <trace.h>
 
+#include <arch/ops.h>
+
+#include <vm/pmm.h>
 #include <vm/vm_object.h>
 #include <vm/vm_object_paged.h>
 
 #include <lib/user_copy/user_ptr.h>
 
 #include <object/handle.h>
+#include <object/job_dispatcher.h>
 #include <object/process_dispatcher.h>
 #include <object/resource.h>
 #include <object/vm_object_dispatcher.h>
@@ -41,12 +45,18 @@ zx_status_t sys_vmo_create(uint64_t size, uint32_t options,
                            user_out_handle* out) {
     LTRACEF("size %#" PRIx64 "\n", size);
 
-    switch (options) {
-    case 0: options = VmObjectPaged::kResizable; break;
-    case ZX_VMO_NON_RESIZABLE: options = 0u; break;
-    default: return ZX_ERR_INVALID_ARGS;
+    if (options & ~(ZX_VMO_NON_RESIZABLE | ZX_VMO_NODE_AFFINE))
+        return ZX_ERR_INVALID_ARGS;
+
+    uint32_t pmm_alloc_flags = PMM_ALLOC_FLAG_ANY;
+    if (options & ZX_VMO_NODE_AFFINE) {
+        // pin the object's page allocations to the creating cpu's NUMA node
+        // rather than whichever node later faults happen to run on
+        pmm_alloc_flags = PMM_ALLOC_FLAG_NODE(pmm_cpu_numa_node(arch_curr_cpu_num()));
     }
 
+    uint32_t vmo_options = (options & ZX_VMO_NON_RESIZABLE) ? 0u : VmObjectPaged::kResizable;
+
     auto up = ProcessDispatcher::GetCurrent();
     zx_status_t res = up->QueryPolicy(ZX_POL_NEW_VMO);
     if (res != ZX_OK)
@@ -54,7 +64,7 @@ zx_status_t sys_vmo_create(uint64_t size, uint32_t options,
 
     // create a vm object
     fbl::RefPtr<VmObject> vmo;
-    res = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, options, size, &vmo);
+    res = VmObjectPaged::Create(pmm_alloc_flags, vmo_options, size, &vmo);
     if (res != ZX_OK)
         return res;
 
@@ -65,8 +75,12 @@ zx_status_t sys_vmo_create(uint64_t size, uint32_t options,
     if (result != ZX_OK)
         return result;
 
+    // attribute committed pages to the creating process's job
+    auto vmo_dispatcher = DownCastDispatcher<VmObjectDispatcher>(&dispatcher);
+    vmo_dispatcher->AttributeMemory(up->job());
+
     // create a handle and attach the dispatcher to it
-    return out->make(fbl::move(dispatcher), rights);
+    return out->make(fbl::move(vmo_dispatcher), rights);
 }
 
 zx_status_t sys_vmo_read(zx_handle_t handle, user_out_ptr<void> _data,
@@ -254,6 +268,12 @@ zx_status_t sys_vmo_clone(zx_handle_t handle, uint32_t options,
     if (result != ZX_OK)
         return result;
 
+    // attribute pages the clone commits (COW copies) to the cloning
+    // process's job
+    auto clone_dispatcher = DownCastDispatcher<VmObjectDispatcher>(&dispatcher);
+    clone_dispatcher->AttributeMemory(up->job());
+    dispatcher = fbl::move(clone_dispatcher);
+
     // Set the rights to the new handle to no greater than the input
     // handle, plus WRITE if making a COW clone, and always allow
     // GET/SET_PROPERTY so the user can set ZX_PROP_NAME on the new clone.
@@ -22,13 +22,18 @@ enum vm_page_state {
     VM_PAGE_STATE_MMU,   // allocated to serve arch-specific mmu purposes
     VM_PAGE_STATE_IOMMU, // allocated for platform-specific iommu structures
     VM_PAGE_STATE_IPC,
+    VM_PAGE_STATE_CACHE, // free, but held in a per-cpu page cache
 
     VM_PAGE_STATE_COUNT_
 };
 
-#define VM_PAGE_STATE_BITS 3
+#define VM_PAGE_STATE_BITS 4
 static_assert((1u << VM_PAGE_STATE_BITS) >= VM_PAGE_STATE_COUNT_, "");
 
+// low bits of vm_page |flags| hold the NUMA node of the arena the page
+// belongs to, so the allocator can route a freed page without an arena lookup
+#define VM_PAGE_FLAG_NODE_MASK (0x7u)
+
 // core per page structure allocated at pmm arena creation time
 typedef struct vm_page {
     struct list_node queue_node;
@@ -55,6 +60,13 @@ typedef struct vm_page {
         return state == VM_PAGE_STATE_FREE;
     }
 
+    // NUMA node of the arena this page belongs to, stashed in |flags| at
+    // arena initialization time
+    uint numa_node() const { return flags & VM_PAGE_FLAG_NODE_MASK; }
+    void set_numa_node(uint node) {
+        flags = (flags & ~VM_PAGE_FLAG_NODE_MASK) | (node & VM_PAGE_FLAG_NODE_MASK);
+    }
+
     void dump() const;
 
     // return the physical address
@@ -12,6 +12,10 @@
 #include <zircon/compiler.h>
 #include <zircon/types.h>
 
+// Maximum number of NUMA nodes the physical allocator tracks. Arenas on
+// higher-numbered nodes are rejected.
+#define PMM_MAX_NUMA_NODES 8
+
 // physical allocator
 typedef struct pmm_arena_info {
     char name[16];
@@ -19,6 +23,10 @@ typedef struct pmm_arena_info {
     uint flags;
     uint priority;
 
+    // NUMA node this arena's memory is attached to; 0 on machines with no
+    // locality information.
+    uint numa_node;
+
     paddr_t base;
     size_t size;
 } pmm_arena_info_t;
@@ -32,6 +40,21 @@ zx_status_t pmm_add_arena(const pmm_arena_info_t* arena);
 // flags for allocation routines below
 #define PMM_ALLOC_FLAG_ANY (0x0)    // no restrictions on which arena to allocate from
 #define PMM_ALLOC_FLAG_LO_MEM (0x1) // allocate only from arenas marked LO_MEM
+// prefer the NUMA node encoded in the high bits of the flags rather than
+// the requesting cpu's node; build the flags with PMM_ALLOC_FLAG_NODE()
+#define PMM_ALLOC_FLAG_NODE_AFFINE (0x2)
+
+#define PMM_ALLOC_FLAG_NODE_SHIFT (24)
+#define PMM_ALLOC_FLAG_NODE(node) \
+    (PMM_ALLOC_FLAG_NODE_AFFINE | ((uint)(node) << PMM_ALLOC_FLAG_NODE_SHIFT))
+#define PMM_ALLOC_FLAG_TO_NODE(flags) ((flags) >> PMM_ALLOC_FLAG_NODE_SHIFT)
+
+// Record which NUMA node |cpu| is attached to. Called by platform code as
+// topology is discovered; every cpu defaults to node 0.
+void pmm_set_cpu_numa_node(uint cpu, uint numa_node);
+
+// Return the NUMA node |cpu| is attached to.
+uint pmm_cpu_numa_node(uint cpu);
 
 // Allocate count pages of physical memory, adding to the tail of the passed list.
 // The list must be initialized.
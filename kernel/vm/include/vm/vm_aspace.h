@@ -165,6 +165,15 @@ protected:
         return aslr_prng_;
     }
 
+    // Page fault fast path bookkeeping, called by VmAddressRegion when a
+    // fault resolves to a mapping and by VmMapping when a mapping goes away.
+    void set_last_fault(VmMapping* mapping) TA_REQ(lock_) { last_fault_ = mapping; }
+    void forget_last_fault(VmMapping* mapping) TA_REQ(lock_) {
+        if (last_fault_ == mapping) {
+            last_fault_ = nullptr;
+        }
+    }
+
 private:
     // can only be constructed via factory
     VmAspace(vaddr_t base, size_t size, uint32_t flags, const char* name);
@@ -202,6 +211,12 @@ private:
     // Access to this reference is guarded by lock_.
     fbl::RefPtr<VmAddressRegion> root_vmar_;
 
+    // The mapping the last page fault resolved to, so that the fault-heavy
+    // case of consecutive faults in one mapping skips the VMAR tree walk.
+    // Deliberately not a reference; VmMapping clears this via
+    // forget_last_fault before the mapping is unmapped or destroyed.
+    VmMapping* last_fault_ TA_GUARDED(lock_) = nullptr;
+
     // PRNG used by VMARs for address choices.  We record the seed to enable
     // reproducible debugging.
     crypto::PRNG aslr_prng_;
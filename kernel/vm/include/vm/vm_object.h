@@ -35,6 +35,14 @@ public:
     virtual void OnOneChild() = 0;
 };
 
+// Committed-page attribution hook, implemented by the dispatcher layer.
+// Called under the VMO's lock, so implementations must be lock-free
+// (e.g. bump relaxed atomics).
+class VmObjectMemoryObserver {
+public:
+    virtual void OnPagesCommitted(int64_t delta) = 0;
+};
+
 // The base vm object that holds a range of bytes of data
 //
 // Can be created without mapping and used as a container of data, or mappable
@@ -121,6 +129,12 @@ public:
     // The assocaited VmObjectDispatcher will set an observer to notify user mode.
     void SetChildObserver(VmObjectChildObserver* child_observer);
 
+    // Attaches or detaches (nullptr) the committed-page attribution hook.
+    // Only pages committed while an observer is attached are attributed;
+    // on detach the pages reported so far are reported back as a negative
+    // delta so rollup counters balance.
+    void SetMemoryObserver(VmObjectMemoryObserver* memory_observer);
+
     // Returns a null-terminated name, or the empty string if set_name() has not
     // been called.
     void get_name(char* out_name, size_t len) const;
@@ -233,6 +247,9 @@ protected:
     // inform all mappings and children that a range of this vmo's pages were added or removed.
     void RangeChangeUpdateLocked(uint64_t offset, uint64_t len) TA_REQ(lock_);
 
+    // Reports |delta| committed pages to the memory observer, if any.
+    void PagesCommittedLocked(int64_t delta) TA_REQ(lock_);
+
     // above call but called from a parent
     virtual void RangeChangeUpdateFromParentLocked(uint64_t offset, uint64_t len)
         // Called under the parent's lock, which confuses analysis.
@@ -274,6 +291,11 @@ private:
     // This member, if not null, is used to signal the user facing Dispatcher.
     VmObjectChildObserver* child_observer_ TA_GUARDED(lock_) = nullptr;
 
+    // Committed-page attribution. |attributed_pages_| tracks what has been
+    // reported to the observer so that detaching can balance the books.
+    VmObjectMemoryObserver* memory_observer_ TA_GUARDED(lock_) = nullptr;
+    int64_t attributed_pages_ TA_GUARDED(lock_) = 0;
+
     // Per-node state for the global VMO list.
     using NodeState = fbl::DoublyLinkedListNodeState<VmObject*>;
     NodeState global_list_state_;
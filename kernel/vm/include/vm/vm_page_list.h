@@ -194,5 +194,16 @@ public:
     bool IsEmpty();
 
 private:
+    // Find the node at |node_offset|, consulting the hint first. Returns
+    // nullptr if no such node exists. Updates the hint on success.
+    VmPageListNode* LookupNode(uint64_t node_offset);
+
     fbl::WAVLTree<uint64_t, fbl::unique_ptr<VmPageListNode>> list_;
+
+    // The most recently used node. Faults and copies overwhelmingly touch
+    // pages sequentially or repeatedly, so remembering the last node lets
+    // those lookups skip the tree walk. Owned by |list_|; cleared whenever
+    // the node (or the whole tree) is erased. Like the rest of the page
+    // list, protected externally by the owning VMO's lock.
+    VmPageListNode* hint_ = nullptr;
 };
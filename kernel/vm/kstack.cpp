@@ -5,9 +5,12 @@
 // https://opensource.org/licenses/MIT
 #include <vm/kstack.h>
 
+#include <arch/ops.h>
 #include <assert.h>
 #include <err.h>
 #include <inttypes.h>
+#include <kernel/align.h>
+#include <kernel/spinlock.h>
 #include <string.h>
 #include <trace.h>
 
@@ -24,6 +27,67 @@
 
 #define LOCAL_TRACE 0
 
+namespace {
+
+// A small per-cpu cache of fully mapped stacks, so that in the steady state
+// thread creation and destruction recycle stacks instead of mutating the
+// kernel aspace (vmar creation, mapping, and page faults) every time. Cached
+// entries keep their vmar references (stored as leaked pointers, like
+// kstack_t itself does); overflow and misses fall through to the real
+// allocate/free paths. Caches are only touched from their own cpu with
+// interrupts disabled.
+struct StackCacheEntry {
+    vaddr_t base;
+    size_t size;
+    vaddr_t top;
+    void* vmar;
+#if __has_feature(safe_stack)
+    vaddr_t unsafe_base;
+    void* unsafe_vmar;
+#endif
+};
+
+constexpr size_t kStackCacheDepth = 4;
+
+struct StackCache {
+    StackCacheEntry entries[kStackCacheDepth];
+    size_t count;
+} __CPU_ALIGN;
+
+StackCache stack_caches[SMP_MAX_CPUS];
+
+// Pops a cached stack into |entry|. Returns false if the local cache is
+// empty.
+bool stack_cache_pop(StackCacheEntry* entry) {
+    bool hit = false;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    StackCache* cache = &stack_caches[arch_curr_cpu_num()];
+    if (cache->count > 0) {
+        *entry = cache->entries[--cache->count];
+        hit = true;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return hit;
+}
+
+// Pushes |entry| into the local cache. Returns false if the cache is full,
+// in which case the caller owns the stack and should destroy it.
+bool stack_cache_push(const StackCacheEntry* entry) {
+    bool cached = false;
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+    StackCache* cache = &stack_caches[arch_curr_cpu_num()];
+    if (cache->count < kStackCacheDepth) {
+        cache->entries[cache->count++] = *entry;
+        cached = true;
+    }
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+    return cached;
+}
+
+} // namespace
+
 // Allocates and maps a kernel stack with one page of padding before and after the mapping.
 static zx_status_t allocate_vmar(bool unsafe,
                                  fbl::RefPtr<VmMapping>* out_kstack_mapping,
@@ -108,6 +172,20 @@ zx_status_t vm_allocate_kstack(kstack_t* stack) {
     DEBUG_ASSERT(stack->unsafe_vmar == nullptr);
 #endif
 
+    // serve from the local cpu's cache of recycled stacks when possible
+    StackCacheEntry entry;
+    if (likely(stack_cache_pop(&entry))) {
+        stack->base = entry.base;
+        stack->size = entry.size;
+        stack->top = entry.top;
+        stack->vmar = entry.vmar;
+#if __has_feature(safe_stack)
+        stack->unsafe_base = entry.unsafe_base;
+        stack->unsafe_vmar = entry.unsafe_vmar;
+#endif
+        return ZX_OK;
+    }
+
     fbl::RefPtr<VmMapping> mapping;
     fbl::RefPtr<VmAddressRegion> vmar;
     zx_status_t status = allocate_vmar(false, &mapping, &vmar);
@@ -138,6 +216,28 @@ zx_status_t vm_allocate_kstack(kstack_t* stack) {
 }
 
 zx_status_t vm_free_kstack(kstack_t* stack) {
+    // A complete stack (one that didn't fail partway through allocation) can
+    // be recycled as-is; the next thread overwrites the contents anyway.
+    bool complete = stack->vmar != nullptr;
+#if __has_feature(safe_stack)
+    complete = complete && stack->unsafe_vmar != nullptr;
+#endif
+    if (likely(complete)) {
+        StackCacheEntry entry;
+        entry.base = stack->base;
+        entry.size = stack->size;
+        entry.top = stack->top;
+        entry.vmar = stack->vmar;
+#if __has_feature(safe_stack)
+        entry.unsafe_base = stack->unsafe_base;
+        entry.unsafe_vmar = stack->unsafe_vmar;
+#endif
+        if (stack_cache_push(&entry)) {
+            memset(stack, 0, sizeof(*stack));
+            return ZX_OK;
+        }
+    }
+
     stack->base = 0;
     stack->size = 0;
     stack->top = 0;
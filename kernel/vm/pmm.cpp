@@ -55,6 +55,14 @@ zx_status_t pmm_add_arena(const pmm_arena_info_t* info) {
     return pmm_node.AddArena(info);
 }
 
+void pmm_set_cpu_numa_node(uint cpu, uint numa_node) {
+    pmm_node.SetCpuNode(cpu, numa_node);
+}
+
+uint pmm_cpu_numa_node(uint cpu) {
+    return pmm_node.CpuNode(cpu);
+}
+
 vm_page_t* pmm_alloc_page(uint alloc_flags, paddr_t* pa) {
     return pmm_node.AllocPage(alloc_flags, pa);
 }
@@ -20,6 +20,9 @@
 
 #define LOCAL_TRACE MAX(VM_GLOBAL_TRACE, 0)
 
+static_assert(PMM_MAX_NUMA_NODES <= VM_PAGE_FLAG_NODE_MASK + 1,
+              "vm_page cannot encode every numa node");
+
 zx_status_t PmmArena::Init(const pmm_arena_info_t* info, PmmNode* node) {
     // TODO: validate that info is sane (page aligned, etc)
     info_ = *info;
@@ -69,6 +72,7 @@ zx_status_t PmmArena::Init(const pmm_arena_info_t* info, PmmNode* node) {
         auto& p = page_array_[i];
 
         p.paddr_priv = base() + i * PAGE_SIZE;
+        p.set_numa_node(info_.numa_node);
         if (i >= array_start_index && i < array_end_index) {
             p.state = VM_PAGE_STATE_WIRED;
         } else {
@@ -104,30 +108,36 @@ vm_page_t* PmmArena::FindFreeContiguous(size_t count, uint8_t alignment_log2) {
 
     paddr_t aligned_offset = (rounded_base - base()) / PAGE_SIZE;
     paddr_t start = aligned_offset;
+    const size_t arena_pages = size() / PAGE_SIZE;
+    const size_t align_pages = 1UL << (alignment_log2 - PAGE_SIZE_SHIFT);
     LTRACEF("starting search at aligned offset %#" PRIxPTR "\n", start);
     LTRACEF("arena base %#" PRIxPTR " size %zu\n", base(), size());
 
-retry:
     // search while we're still within the arena and have a chance of finding a slot
     // (start + count < end of arena)
-    while ((start < size() / PAGE_SIZE) && ((start + count) <= size() / PAGE_SIZE)) {
-        vm_page_t* p = &page_array_[start];
-        for (uint i = 0; i < count; i++) {
-            if (!p->is_free()) {
-                // this run is broken, break out of the inner loop.
-                // start over at the next alignment boundary
-                start = ROUNDUP(start - aligned_offset + i + 1, 1UL << (alignment_log2 - PAGE_SIZE_SHIFT)) +
-                        aligned_offset;
-                goto retry;
-            }
-            p++;
+    while ((start < arena_pages) && ((start + count) <= arena_pages)) {
+        // Check the candidate window back to front. The first non-free page
+        // found invalidates every window that contains it, so the search can
+        // jump past it entirely; a fragmented arena is probed roughly once
+        // per |count| pages rather than page by page, which matters for
+        // large runs.
+        size_t i = count;
+        while (i > 0 && page_array_[start + i - 1].is_free()) {
+            i--;
         }
 
-        // we found a run
-        p = &page_array_[start];
-        LTRACEF("found run from pa %#" PRIxPTR " to %#" PRIxPTR "\n", p->paddr(), p->paddr() + count * PAGE_SIZE);
+        if (i == 0) {
+            // we found a run
+            vm_page_t* p = &page_array_[start];
+            LTRACEF("found run from pa %#" PRIxPTR " to %#" PRIxPTR "\n", p->paddr(),
+                    p->paddr() + count * PAGE_SIZE);
+
+            return p;
+        }
 
-        return p;
+        // page at start + i - 1 is not free; resume at the next alignment
+        // boundary past it
+        start = ROUNDUP(start - aligned_offset + i, align_pages) + aligned_offset;
     }
 
     return nullptr;
@@ -141,8 +151,9 @@ void PmmArena::CountStates(size_t state_count[VM_PAGE_STATE_COUNT_]) const {
 
 void PmmArena::Dump(bool dump_pages, bool dump_free_ranges) const {
     char pbuf[16];
-    printf("  arena %p: name '%s' base %#" PRIxPTR " size %s (0x%zx) priority %u flags 0x%x\n",
-           this, name(), base(), format_size(pbuf, sizeof(pbuf), size()), size(), priority(), flags());
+    printf("  arena %p: name '%s' base %#" PRIxPTR " size %s (0x%zx) priority %u flags 0x%x node %u\n",
+           this, name(), base(), format_size(pbuf, sizeof(pbuf), size()), size(), priority(), flags(),
+           numa_node());
     printf("\tpage_array %p\n", page_array_);
 
     // dump all of the pages
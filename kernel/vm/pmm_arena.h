@@ -31,6 +31,7 @@ public:
     size_t size() const { return info_.size; }
     unsigned int flags() const { return info_.flags; }
     unsigned int priority() const { return info_.priority; }
+    unsigned int numa_node() const { return info_.numa_node; }
 
     // Counts the number of pages in every state. For each page in the arena,
     // increments the corresponding VM_PAGE_STATE_*-indexed entry of
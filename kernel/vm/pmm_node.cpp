@@ -5,8 +5,10 @@
 // https://opensource.org/licenses/MIT
 #include "pmm_node.h"
 
+#include <arch/ops.h>
 #include <inttypes.h>
 #include <kernel/mp.h>
+#include <kernel/spinlock.h>
 #include <trace.h>
 #include <vm/bootalloc.h>
 #include <vm/physmap.h>
@@ -29,6 +31,13 @@ void set_state_alloc(vm_page* page) {
 } // namespace
 
 PmmNode::PmmNode() {
+    for (auto& free_list : free_lists_) {
+        list_initialize(&free_list);
+    }
+    for (auto& cache : page_caches_) {
+        list_initialize(&cache.pages);
+        cache.count = 0;
+    }
 }
 
 PmmNode::~PmmNode() {
@@ -48,6 +57,11 @@ zx_status_t PmmNode::AddArena(const pmm_arena_info_t* info) TA_NO_THREAD_SAFETY_
     DEBUG_ASSERT(IS_PAGE_ALIGNED(info->size));
     DEBUG_ASSERT(info->size > 0);
 
+    if (info->numa_node >= PMM_MAX_NUMA_NODES) {
+        printf("PMM: arena '%s' has out of range numa node %u\n", info->name, info->numa_node);
+        return ZX_ERR_INVALID_ARGS;
+    }
+
     // allocate a c++ arena object
     PmmArena* arena = new (boot_alloc_mem(sizeof(PmmArena))) PmmArena();
 
@@ -84,34 +98,196 @@ void PmmNode::AddFreePages(list_node* list) TA_NO_THREAD_SAFETY_ANALYSIS {
     vm_page *temp, *page;
     list_for_every_entry_safe (list, page, temp, vm_page, queue_node) {
         list_delete(&page->queue_node);
-        list_add_tail(&free_list_, &page->queue_node);
+        list_add_tail(&free_lists_[page->numa_node()], &page->queue_node);
         free_count_++;
     }
 
     LTRACEF("free count now %" PRIu64 "\n", free_count_);
 }
 
+vm_page* PmmNode::CachePop() {
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    PageCache* cache = &page_caches_[arch_curr_cpu_num()];
+    vm_page* page = list_remove_head_type(&cache->pages, vm_page, queue_node);
+    if (page) {
+        DEBUG_ASSERT(cache->count > 0);
+        cache->count--;
+    }
+
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    if (page)
+        free_cached_count_.fetch_sub(1, fbl::memory_order_relaxed);
+    return page;
+}
+
+bool PmmNode::CachePush(vm_page* page) {
+    DEBUG_ASSERT(page->state == VM_PAGE_STATE_CACHE);
+
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    PageCache* cache = &page_caches_[arch_curr_cpu_num()];
+    const bool pushed = cache->count < kPageCacheMax;
+    if (pushed) {
+        list_add_head(&cache->pages, &page->queue_node);
+        cache->count++;
+    }
+
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    if (pushed)
+        free_cached_count_.fetch_add(1, fbl::memory_order_relaxed);
+    return pushed;
+}
+
+void PmmNode::CacheFill(list_node* list, size_t* count) {
+    size_t added = 0;
+
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    PageCache* cache = &page_caches_[arch_curr_cpu_num()];
+    while (cache->count < kPageCacheMax) {
+        vm_page* page = list_remove_head_type(list, vm_page, queue_node);
+        if (!page)
+            break;
+        DEBUG_ASSERT(page->state == VM_PAGE_STATE_CACHE);
+        list_add_head(&cache->pages, &page->queue_node);
+        cache->count++;
+        added++;
+    }
+
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    DEBUG_ASSERT(*count >= added);
+    *count -= added;
+    if (added)
+        free_cached_count_.fetch_add(added, fbl::memory_order_relaxed);
+}
+
+void PmmNode::CacheDrain(list_node* list, size_t max) {
+    size_t removed = 0;
+
+    spin_lock_saved_state_t state;
+    arch_interrupt_save(&state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    PageCache* cache = &page_caches_[arch_curr_cpu_num()];
+    while (removed < max) {
+        // drain from the tail; those pages have been in the cache the longest
+        vm_page* page = list_remove_tail_type(&cache->pages, vm_page, queue_node);
+        if (!page)
+            break;
+        DEBUG_ASSERT(cache->count > 0);
+        cache->count--;
+        list_add_tail(list, &page->queue_node);
+        removed++;
+    }
+
+    arch_interrupt_restore(state, SPIN_LOCK_FLAG_INTERRUPTS);
+
+    if (removed)
+        free_cached_count_.fetch_sub(removed, fbl::memory_order_relaxed);
+}
+
+vm_page* PmmNode::PopFreePageLocked(uint preferred_node) {
+    DEBUG_ASSERT(preferred_node < PMM_MAX_NUMA_NODES);
+
+    for (uint i = 0; i < PMM_MAX_NUMA_NODES; i++) {
+        uint node = preferred_node + i;
+        if (node >= PMM_MAX_NUMA_NODES) {
+            node -= PMM_MAX_NUMA_NODES;
+        }
+        vm_page* page = list_remove_head_type(&free_lists_[node], vm_page, queue_node);
+        if (page) {
+            return page;
+        }
+    }
+    return nullptr;
+}
+
 vm_page_t* PmmNode::AllocPage(uint alloc_flags, paddr_t* pa) {
-    Guard<fbl::Mutex> guard{&lock_};
+    const bool node_affine = (alloc_flags & PMM_ALLOC_FLAG_NODE_AFFINE) != 0;
+
+    // Serve single page requests from the local cpu's cache when possible,
+    // avoiding the node lock entirely. Node-affine requests go straight to
+    // the per-node free queues; the cache is only biased toward the local
+    // node, not guaranteed to hold pages from any particular one.
+    vm_page* page = likely(!node_affine) ? CachePop() : nullptr;
+    if (likely(page)) {
+        DEBUG_ASSERT(page->state == VM_PAGE_STATE_CACHE);
+#if PMM_ENABLE_FREE_FILL
+        CheckFreeFill(page);
+#endif
+        page->state = VM_PAGE_STATE_ALLOC;
 
-    vm_page* page = list_remove_head_type(&free_list_, vm_page, queue_node);
-    if (!page)
-        return nullptr;
+        if (pa) {
+            *pa = page->paddr();
+        }
 
-    DEBUG_ASSERT(free_count_ > 0);
+        LTRACEF("allocating page %p, pa %#" PRIxPTR "\n", page, page->paddr());
 
-    free_count_--;
+        return page;
+    }
 
-    DEBUG_ASSERT(page->is_free());
+    list_node refill = LIST_INITIAL_VALUE(refill);
+    size_t refill_count = 0;
 
-    set_state_alloc(page);
+    const uint preferred_node = node_affine ? PMM_ALLOC_FLAG_TO_NODE(alloc_flags)
+                                            : cpu_numa_node_[arch_curr_cpu_num()];
+
+    {
+        Guard<fbl::Mutex> guard{&lock_};
+
+        page = PopFreePageLocked(preferred_node);
+        if (!page)
+            return nullptr;
+
+        DEBUG_ASSERT(free_count_ > 0);
+
+        free_count_--;
+
+        DEBUG_ASSERT(page->is_free());
+
+        set_state_alloc(page);
 
 #if PMM_ENABLE_FREE_FILL
-    CheckFreeFill(page);
+        CheckFreeFill(page);
 #endif
 
-    if (pa) {
-        *pa = page->paddr();
+        if (pa) {
+            *pa = page->paddr();
+        }
+
+        // grab a batch for the local cache while we hold the lock
+        while (!node_affine && refill_count < kPageCacheBatch) {
+            vm_page* p = PopFreePageLocked(preferred_node);
+            if (!p)
+                break;
+            DEBUG_ASSERT(p->is_free());
+            free_count_--;
+            p->state = VM_PAGE_STATE_CACHE;
+            list_add_tail(&refill, &p->queue_node);
+            refill_count++;
+        }
+    }
+
+    if (refill_count > 0) {
+        CacheFill(&refill, &refill_count);
+        if (unlikely(refill_count > 0)) {
+            // the cache filled up behind our back; put the leftovers back on
+            // the central free list
+            Guard<fbl::Mutex> guard{&lock_};
+            vm_page *p, *temp;
+            list_for_every_entry_safe (&refill, p, temp, vm_page, queue_node) {
+                list_delete(&p->queue_node);
+                p->state = VM_PAGE_STATE_FREE;
+                list_add_head(&free_lists_[p->numa_node()], &p->queue_node);
+                free_count_++;
+            }
+        }
     }
 
     LTRACEF("allocating page %p, pa %#" PRIxPTR "\n", page, page->paddr());
@@ -128,11 +304,15 @@ size_t PmmNode::AllocPages(size_t count, uint alloc_flags, list_node* list) {
     if (count == 0)
         return 0;
 
+    const uint preferred_node = (alloc_flags & PMM_ALLOC_FLAG_NODE_AFFINE)
+                                    ? PMM_ALLOC_FLAG_TO_NODE(alloc_flags)
+                                    : cpu_numa_node_[arch_curr_cpu_num()];
+
     Guard<fbl::Mutex> guard{&lock_};
 
     size_t allocated = 0;
     while (allocated < count) {
-        vm_page* page = list_remove_head_type(&free_list_, vm_page, queue_node);
+        vm_page* page = PopFreePageLocked(preferred_node);
         if (!page)
             return allocated;
 
@@ -270,8 +450,8 @@ size_t PmmNode::Free(list_node* list) {
         // mark it free
         page->state = VM_PAGE_STATE_FREE;
 
-        // add it to the free queue
-        list_add_head(&free_list_, &page->queue_node);
+        // add it to its node's free queue
+        list_add_head(&free_lists_[page->numa_node()], &page->queue_node);
 
         free_count_++;
         count++;
@@ -285,10 +465,9 @@ size_t PmmNode::Free(list_node* list) {
 void PmmNode::Free(vm_page* page) {
     LTRACEF("page %p, pa %#" PRIxPTR "\n", page, page->paddr());
 
-    Guard<fbl::Mutex> guard{&lock_};
-
     DEBUG_ASSERT(page->state != VM_PAGE_STATE_OBJECT || page->object.pin_count == 0);
     DEBUG_ASSERT(!page->is_free());
+    DEBUG_ASSERT(page->state != VM_PAGE_STATE_CACHE);
 
 #if PMM_ENABLE_FREE_FILL
     FreeFill(page);
@@ -298,18 +477,37 @@ void PmmNode::Free(vm_page* page) {
     if (list_in_list(&page->queue_node))
         list_delete(&page->queue_node);
 
-    // mark it free
-    page->state = VM_PAGE_STATE_FREE;
+    // stash it in the local cpu's cache when there is room, avoiding the
+    // node lock
+    page->state = VM_PAGE_STATE_CACHE;
+    if (likely(CachePush(page)))
+        return;
 
-    // add it to the free queue
-    list_add_head(&free_list_, &page->queue_node);
+    // the cache is full; push this page and a batch of the cache's coldest
+    // pages back to the central free list
+    list_node drain = LIST_INITIAL_VALUE(drain);
+    CacheDrain(&drain, kPageCacheBatch);
+    list_add_head(&drain, &page->queue_node);
 
-    free_count_++;
+    Guard<fbl::Mutex> guard{&lock_};
+
+    vm_page *p, *temp;
+    list_for_every_entry_safe (&drain, p, temp, vm_page, queue_node) {
+        list_delete(&p->queue_node);
+
+        // mark it free
+        p->state = VM_PAGE_STATE_FREE;
+
+        // add it to its node's free queue
+        list_add_head(&free_lists_[p->numa_node()], &p->queue_node);
+
+        free_count_++;
+    }
 }
 
 // okay if accessed outside of a lock
 uint64_t PmmNode::CountFreePages() const TA_NO_THREAD_SAFETY_ANALYSIS {
-    return free_count_;
+    return free_count_ + free_cached_count_.load(fbl::memory_order_relaxed);
 }
 
 uint64_t PmmNode::CountTotalBytes() const TA_NO_THREAD_SAFETY_ANALYSIS {
@@ -333,8 +531,9 @@ void PmmNode::DumpFree() const TA_NO_THREAD_SAFETY_ANALYSIS {
 void PmmNode::Dump(bool is_panic) const {
     // No lock analysis here, as we want to just go for it in the panic case without the lock.
     auto dump = [this]() TA_NO_THREAD_SAFETY_ANALYSIS {
-        printf("pmm node %p: free_count %zu (%zu bytes), total size %zu\n",
-                this, free_count_, free_count_ * PAGE_SIZE, arena_cumulative_size_);
+        printf("pmm node %p: free_count %zu (%zu bytes), cached %zu, total size %zu\n",
+                this, free_count_, free_count_ * PAGE_SIZE,
+                free_cached_count_.load(fbl::memory_order_relaxed), arena_cumulative_size_);
         for (auto& a : arena_list_) {
             a.Dump(false, false);
         }
@@ -352,9 +551,11 @@ void PmmNode::Dump(bool is_panic) const {
 void PmmNode::EnforceFill() {
     DEBUG_ASSERT(!enforce_fill_);
 
-    vm_page* page;
-    list_for_every_entry (&free_list_, page, vm_page, queue_node) {
-        FreeFill(page);
+    for (auto& free_list : free_lists_) {
+        vm_page* page;
+        list_for_every_entry (&free_list, page, vm_page, queue_node) {
+            FreeFill(page);
+        }
     }
 
     enforce_fill_ = true;
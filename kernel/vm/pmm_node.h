@@ -5,9 +5,11 @@
 // https://opensource.org/licenses/MIT
 #pragma once
 
+#include <fbl/atomic.h>
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
 
+#include <kernel/align.h>
 #include <kernel/lockdep.h>
 #include <kernel/mutex.h>
 #include <vm/pmm.h>
@@ -55,7 +57,48 @@ public:
     // add new pages to the free queue. used when boostrapping a PmmArena
     void AddFreePages(list_node *list);
 
+    // cpu -> NUMA node mapping, filled in by platform code via
+    // pmm_set_cpu_numa_node() as topology is discovered
+    void SetCpuNode(uint cpu, uint numa_node) {
+        DEBUG_ASSERT(cpu < SMP_MAX_CPUS);
+        DEBUG_ASSERT(numa_node < PMM_MAX_NUMA_NODES);
+        cpu_numa_node_[cpu] = static_cast<uint8_t>(numa_node);
+    }
+    uint CpuNode(uint cpu) const {
+        DEBUG_ASSERT(cpu < SMP_MAX_CPUS);
+        return cpu_numa_node_[cpu];
+    }
+
 private:
+    // Per-cpu caches of free pages, refilled and drained in batches from the
+    // central free list, so the single page alloc/free fast paths don't take
+    // |lock_|. Pages in a cache are in VM_PAGE_STATE_CACHE, which keeps them
+    // invisible to the range and contiguous allocators. Each cache is only
+    // touched by its own cpu with interrupts disabled.
+    static constexpr size_t kPageCacheMax = 32;
+    static constexpr size_t kPageCacheBatch = 16;
+
+    struct PageCache {
+        list_node pages;
+        size_t count;
+    } __CPU_ALIGN;
+
+    // pop/push a single page from/to the local cpu's cache. CachePush fails
+    // if the cache is full.
+    vm_page* CachePop();
+    bool CachePush(vm_page* page);
+
+    // move pages between |list| and the local cpu's cache, bounded by the
+    // cache capacity (CacheFill) or |max| (CacheDrain). CacheFill updates
+    // |count| to the number of pages it could not insert, leaving them on
+    // |list|.
+    void CacheFill(list_node* list, size_t* count);
+    void CacheDrain(list_node* list, size_t max);
+
+    // pop a free page, preferring |preferred_node|'s queue and falling back
+    // to the other nodes' queues when it is empty
+    vm_page* PopFreePageLocked(uint preferred_node) TA_REQ(lock_);
+
     fbl::Canary<fbl::magic("PNOD")> canary_;
 
     mutable DECLARE_MUTEX(PmmNode) lock_;
@@ -65,13 +108,24 @@ private:
 
     fbl::DoublyLinkedList<PmmArena*> arena_list_ TA_GUARDED(lock_);
 
-    // page queues
-    list_node free_list_ TA_GUARDED(lock_) = LIST_INITIAL_VALUE(free_list_);
+    // page queues. free pages are kept on a queue per NUMA node so the
+    // allocator can hand out node-local memory first; pages are routed by
+    // the node tag their arena stamped into vm_page::flags.
+    list_node free_lists_[PMM_MAX_NUMA_NODES] TA_GUARDED(lock_);
     list_node inactive_list_ TA_GUARDED(lock_) = LIST_INITIAL_VALUE(inactive_list_);
     list_node active_list_ TA_GUARDED(lock_) = LIST_INITIAL_VALUE(active_list_);
     list_node modified_list_ TA_GUARDED(lock_) = LIST_INITIAL_VALUE(modified_list_);
     list_node wired_list_ TA_GUARDED(lock_) = LIST_INITIAL_VALUE(wired_list_);
 
+    PageCache page_caches_[SMP_MAX_CPUS];
+
+    // number of pages currently sitting in per-cpu caches, kept outside
+    // |lock_| so the fast paths only touch it with relaxed atomics
+    fbl::atomic<uint64_t> free_cached_count_{0};
+
+    // NUMA node of each cpu; read on allocation paths without |lock_|
+    uint8_t cpu_numa_node_[SMP_MAX_CPUS] = {};
+
 #if PMM_ENABLE_FREE_FILL
     void FreeFill(vm_page_t* page);
     void CheckFreeFill(vm_page_t* page);
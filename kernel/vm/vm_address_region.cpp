@@ -390,7 +390,11 @@ zx_status_t VmAddressRegion::PageFault(vaddr_t va, uint pf_flags) {
     auto vmar = WrapRefPtr(this);
     while (auto next = vmar->FindRegionLocked(va)) {
         if (next->is_mapping()) {
-            return next->PageFault(va, pf_flags);
+            VmMapping* mapping = next->as_vm_mapping().get();
+            // Remember where this fault landed so the next fault can try the
+            // mapping directly before walking the tree again.
+            aspace_->set_last_fault(mapping);
+            return mapping->PageFault(va, pf_flags);
         }
         vmar = next->as_vm_address_region();
     }
@@ -532,6 +532,14 @@ zx_status_t VmAspace::PageFault(vaddr_t va, uint flags) {
     // the region out from underneath it
     Guard<fbl::Mutex> guard{&lock_};
 
+    // First consult the last mapping we faulted on; faults are bursty and
+    // overwhelmingly land in the same mapping back to back, which lets us
+    // skip the walk down the VMAR tree.
+    if (last_fault_ && va >= last_fault_->base() &&
+        va <= last_fault_->base() + (last_fault_->size() - 1)) {
+        return last_fault_->PageFault(va, flags);
+    }
+
     return root_vmar_->PageFault(va, flags);
 }
 
@@ -589,7 +597,7 @@ size_t VmAspace::AllocatedPages() const {
 void VmAspace::InitializeAslr() {
     aslr_enabled_ = is_user() && !cmdline_get_bool("aslr.disable", false);
 
-    crypto::GlobalPRNG::GetInstance()->Draw(aslr_seed_, sizeof(aslr_seed_));
+    crypto::GlobalPRNG::Draw(aslr_seed_, sizeof(aslr_seed_));
     aslr_prng_.AddEntropy(aslr_seed_, sizeof(aslr_seed_));
 }
 
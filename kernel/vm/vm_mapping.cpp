@@ -262,6 +262,10 @@ zx_status_t VmMapping::UnmapLocked(vaddr_t base, size_t size) {
 
     LTRACEF("%p\n", this);
 
+    // Our bounds are about to change (or we're going away entirely), so drop
+    // the aspace's page fault hint if it points at us.
+    aspace_->forget_last_fault(this);
+
     // grab the lock for the vmo
     DEBUG_ASSERT(object_);
     Guard<fbl::Mutex> guard{object_->lock()};
@@ -585,7 +589,8 @@ zx_status_t VmMapping::DestroyLocked() {
         parent_->RemoveSubregion(this);
     }
 
-    // mark ourself as dead
+    // mark ourself as dead; make sure the aspace doesn't route faults to us
+    aspace_->forget_last_fault(this);
     parent_ = nullptr;
     state_ = LifeCycleState::DEAD;
     return ZX_OK;
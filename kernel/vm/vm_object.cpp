@@ -198,6 +198,27 @@ void VmObject::SetChildObserver(VmObjectChildObserver* child_observer) {
     child_observer_ = child_observer;
 }
 
+void VmObject::SetMemoryObserver(VmObjectMemoryObserver* memory_observer) {
+    Guard<fbl::Mutex> guard{&lock_};
+    if (memory_observer == memory_observer_)
+        return;
+    // Balance the old observer's books before switching; only pages
+    // committed from here on are attributed to the new observer.
+    if (memory_observer_ && attributed_pages_ != 0)
+        memory_observer_->OnPagesCommitted(-attributed_pages_);
+    attributed_pages_ = 0;
+    memory_observer_ = memory_observer;
+}
+
+void VmObject::PagesCommittedLocked(int64_t delta) {
+    canary_.Assert();
+    if (memory_observer_ == nullptr || delta == 0)
+        return;
+    attributed_pages_ += delta;
+    DEBUG_ASSERT(attributed_pages_ >= 0);
+    memory_observer_->OnPagesCommitted(delta);
+}
+
 void VmObject::AddChildLocked(VmObject* o) {
     canary_.Assert();
     DEBUG_ASSERT(lock_.lock().IsHeld());
@@ -15,6 +15,8 @@
 #include <fbl/auto_call.h>
 #include <inttypes.h>
 #include <lib/console.h>
+#include <lib/counters.h>
+#include <pow2.h>
 #include <stdlib.h>
 #include <string.h>
 #include <trace.h>
@@ -26,6 +28,9 @@
 
 #define LOCAL_TRACE MAX(VM_GLOBAL_TRACE, 0)
 
+KCOUNTER(vm_zero_page_reads, "kernel.vm.fault.zero_page_reads");
+KCOUNTER(vm_zero_page_cow_allocs, "kernel.vm.fault.zero_page_cow_allocs");
+
 namespace {
 
 void ZeroPage(paddr_t pa) {
@@ -46,6 +51,11 @@ void InitializeVmPage(vm_page_t* p) {
     p->object.pin_count = 0;
 }
 
+// A large (2MB on both x86 and arm64) page worth of memory; commits of fully
+// uncommitted ranges are built out of runs of this size when possible so
+// mappings of them can use large pages.
+constexpr uint64_t kLargePageSize = 2 * MB;
+
 // round up the size to the next page size boundary and make sure we dont wrap
 zx_status_t RoundSize(uint64_t size, uint64_t* out_size) {
     *out_size = ROUNDUP_PAGE_SIZE(size);
@@ -350,6 +360,8 @@ zx_status_t VmObjectPaged::AddPageLocked(vm_page_t* p, uint64_t offset) {
     if (err != ZX_OK)
         return err;
 
+    PagesCommittedLocked(1);
+
     // other mappings may have covered this offset into the vmo, so unmap those ranges
     RangeChangeUpdateLocked(offset, PAGE_SIZE);
 
@@ -463,6 +475,7 @@ zx_status_t VmObjectPaged::GetPageLocked(uint64_t offset, uint pf_flags, list_no
     // return the single global zero page
     if ((pf_flags & VMM_PF_FLAG_WRITE) == 0) {
         LTRACEF("returning the zero page\n");
+        kcounter_add(vm_zero_page_reads, 1u);
         if (page_out)
             *page_out = vm_get_zero_page();
         if (pa_out)
@@ -502,6 +515,10 @@ zx_status_t VmObjectPaged::GetPageLocked(uint64_t offset, uint pf_flags, list_no
     // other mappings may have covered this offset into the vmo, so unmap those ranges
     RangeChangeUpdateLocked(offset, PAGE_SIZE);
 
+    // a write fault here means any prior read fault at this offset was served
+    // by the shared zero page, which we are now replacing with a private copy
+    kcounter_add(vm_zero_page_cow_allocs, 1u);
+
     LTRACEF("faulted in page %p, pa %#" PRIxPTR "\n", p, pa);
 
     if (page_out)
@@ -558,7 +575,33 @@ zx_status_t VmObjectPaged::CommitRange(uint64_t offset, uint64_t len, uint64_t*
     list_node page_list;
     list_initialize(&page_list);
 
-    size_t allocated = pmm_alloc_pages(count, pmm_alloc_flags_, &page_list);
+    // When the entire range is uncommitted, build it out of 2MB-aligned
+    // physically contiguous runs where the allocator can supply them, so that
+    // mappings of the range can be backed by large pages. The pages must be
+    // appended to |page_list| in ascending offset order, since GetPageLocked
+    // below consumes them from the head as it walks the range.
+    size_t allocated = 0;
+    const uint64_t chunk_start = ROUNDUP(offset, kLargePageSize);
+    const uint64_t chunk_end = ROUNDDOWN(end, kLargePageSize);
+    if (count == (end - offset) / PAGE_SIZE && chunk_start < chunk_end) {
+        allocated += pmm_alloc_pages((chunk_start - offset) / PAGE_SIZE,
+                                     pmm_alloc_flags_, &page_list);
+        for (uint64_t o = chunk_start; o < chunk_end; o += kLargePageSize) {
+            size_t chunk = pmm_alloc_contiguous(kLargePageSize / PAGE_SIZE, pmm_alloc_flags_,
+                                                static_cast<uint8_t>(log2_ulong_floor(kLargePageSize)),
+                                                nullptr,
+                                                &page_list);
+            if (chunk == 0) {
+                // no contiguous run available; fall back to discontiguous
+                // pages for this chunk
+                chunk = pmm_alloc_pages(kLargePageSize / PAGE_SIZE, pmm_alloc_flags_, &page_list);
+            }
+            allocated += chunk;
+        }
+        allocated += pmm_alloc_pages((end - chunk_end) / PAGE_SIZE, pmm_alloc_flags_, &page_list);
+    } else {
+        allocated = pmm_alloc_pages(count, pmm_alloc_flags_, &page_list);
+    }
     if (allocated < count) {
         LTRACEF("failed to allocate enough pages (asked for %zu, got %zu)\n", count, allocated);
         pmm_free(&page_list);
@@ -642,8 +685,11 @@ zx_status_t VmObjectPaged::DecommitRange(uint64_t offset, uint64_t len, uint64_t
     // TODO: use page_list iterator, move pages to list, free at once
     while (start < end) {
         auto status = page_list_.FreePage(start);
-        if (status == ZX_OK && decommitted) {
-            *decommitted += PAGE_SIZE;
+        if (status == ZX_OK) {
+            PagesCommittedLocked(-1);
+            if (decommitted) {
+                *decommitted += PAGE_SIZE;
+            }
         }
         start += PAGE_SIZE;
     }
@@ -798,7 +844,9 @@ zx_status_t VmObjectPaged::ResizeLocked(uint64_t s) {
         // iterate through the pages, freeing them
         // TODO: use page_list iterator, move pages to list, free at once
         while (start < end) {
-            page_list_.FreePage(start);
+            if (page_list_.FreePage(start) == ZX_OK) {
+                PagesCommittedLocked(-1);
+            }
             start += PAGE_SIZE;
         }
     } else if (s > size_) {
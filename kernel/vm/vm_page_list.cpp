@@ -69,6 +69,22 @@ VmPageList::~VmPageList() {
     DEBUG_ASSERT(list_.is_empty());
 }
 
+VmPageListNode* VmPageList::LookupNode(uint64_t node_offset) {
+    // the hint tracks the most recently touched node, which sequential and
+    // repeated lookups hit without walking the tree
+    if (hint_ && hint_->offset() == node_offset) {
+        return hint_;
+    }
+
+    auto pln = list_.find(node_offset);
+    if (!pln.IsValid()) {
+        return nullptr;
+    }
+
+    hint_ = &*pln;
+    return hint_;
+}
+
 zx_status_t VmPageList::AddPage(vm_page* p, uint64_t offset) {
     uint64_t node_offset = ROUNDDOWN(offset, PAGE_SIZE * VmPageListNode::kPageFanOut);
     size_t index = (offset >> PAGE_SIZE_SHIFT) % VmPageListNode::kPageFanOut;
@@ -77,8 +93,8 @@ zx_status_t VmPageList::AddPage(vm_page* p, uint64_t offset) {
                   node_offset, index);
 
     // lookup the tree node that holds this page
-    auto pln = list_.find(node_offset);
-    if (!pln.IsValid()) {
+    auto pln = LookupNode(node_offset);
+    if (!pln) {
         fbl::AllocChecker ac;
         fbl::unique_ptr<VmPageListNode> pl =
             fbl::unique_ptr<VmPageListNode>(new (&ac) VmPageListNode(node_offset));
@@ -89,6 +105,7 @@ zx_status_t VmPageList::AddPage(vm_page* p, uint64_t offset) {
         __UNUSED auto status = pl->AddPage(p, index);
         DEBUG_ASSERT(status == ZX_OK);
 
+        hint_ = pl.get();
         list_.insert(fbl::move(pl));
     } else {
         pln->AddPage(p, index);
@@ -105,8 +122,8 @@ vm_page* VmPageList::GetPage(uint64_t offset) {
                   index);
 
     // lookup the tree node that holds this page
-    auto pln = list_.find(node_offset);
-    if (!pln.IsValid()) {
+    auto pln = LookupNode(node_offset);
+    if (!pln) {
         return nullptr;
     }
 
@@ -121,8 +138,8 @@ zx_status_t VmPageList::FreePage(uint64_t offset) {
                   index);
 
     // lookup the tree node that holds this page
-    auto pln = list_.find(node_offset);
-    if (!pln.IsValid()) {
+    auto pln = LookupNode(node_offset);
+    if (!pln) {
         return ZX_ERR_NOT_FOUND;
     }
 
@@ -132,6 +149,9 @@ zx_status_t VmPageList::FreePage(uint64_t offset) {
         // if it was the last page in the node, remove the node from the tree
         if (pln->IsEmpty()) {
             LTRACEF_LEVEL(2, "%p freeing the list node\n", this);
+            if (hint_ == pln) {
+                hint_ = nullptr;
+            }
             list_.erase(*pln);
         }
 
@@ -167,6 +187,7 @@ size_t VmPageList::FreeAllPages() {
     DEBUG_ASSERT(freed == count);
 
     // empty the tree
+    hint_ = nullptr;
     list_.clear();
 
     return count;
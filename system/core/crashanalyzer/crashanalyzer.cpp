@@ -319,10 +319,10 @@ static void process_report(zx_handle_t process, zx_handle_t thread, bool use_lib
         inspector_dsoinfo_t* dso_list = inspector_dso_fetch_list(process);
         inspector_dso_print_list(stdout, dso_list);
         // TODO (jakehehrlich): Remove the old backtrace format.
-        inspector_print_backtrace(stdout, process, thread, dso_list,
-                                  pc, sp, fp, use_libunwind);
-        inspector_print_backtrace_markup(stdout, process, thread, dso_list,
-                                         pc, sp, fp, use_libunwind);
+        // This prints the old format followed by markup, unwinding the
+        // thread only once for both.
+        inspector_print_backtrace_all_formats(stdout, process, thread, dso_list,
+                                              pc, sp, fp, use_libunwind);
     }
 
 // TODO(ZX-588): Print a backtrace of all other threads in the process.
@@ -308,19 +308,26 @@ static zx_status_t libname_to_vmo(const char* libname, zx_handle_t* out) {
         return ZX_ERR_NOT_FOUND;
     }
 
-    // Check for cached DSO
-    if (drv->dso_vmo != ZX_HANDLE_INVALID) {
-        zx_status_t r = zx_handle_duplicate(drv->dso_vmo,
-                                            ZX_RIGHTS_BASIC | ZX_RIGHTS_PROPERTY |
-                                            ZX_RIGHT_READ | ZX_RIGHT_EXECUTE | ZX_RIGHT_MAP,
-                                            out);
-        if (r != ZX_OK) {
-            log(ERROR, "devcoord: cannot duplicate cached dso for '%s' '%s'\n", drv->name, libname);
+    // Check for cached DSO, populating the cache on first use.  Bus drivers
+    // commonly bind to many devices (one per PCI function, say), and
+    // re-reading the DSO through the filesystem on every bind serializes
+    // devhost startup behind blocking I/O in the coordinator's dispatch
+    // loop.  Once cached, each bind just duplicates a handle and the
+    // devhosts load the library concurrently on their side.
+    if (drv->dso_vmo == ZX_HANDLE_INVALID) {
+        zx_status_t r = load_vmo(libname, &drv->dso_vmo);
+        if (r < 0) {
+            return r;
         }
-        return r;
-    } else {
-        return load_vmo(libname, out);
     }
+    zx_status_t r = zx_handle_duplicate(drv->dso_vmo,
+                                        ZX_RIGHTS_BASIC | ZX_RIGHTS_PROPERTY |
+                                        ZX_RIGHT_READ | ZX_RIGHT_EXECUTE | ZX_RIGHT_MAP,
+                                        out);
+    if (r != ZX_OK) {
+        log(ERROR, "devcoord: cannot duplicate cached dso for '%s' '%s'\n", drv->name, libname);
+    }
+    return r;
 }
 
 void devmgr_set_bootdata(zx_handle_t vmo) {
@@ -659,26 +666,71 @@ static zx_status_t dc_launch_devhost(devhost_t* host,
     return ZX_OK;
 }
 
+// Pre-warmed devhost pool.  Process creation plus dynamic linking of the
+// devhost binary is most of hot-plug attach latency, so a few idle
+// devhosts are kept launched and parked on their rpc channels, to be
+// claimed (and renamed) when a device needs a new host.  The pool is
+// topped back up from the claim path.  devmgr.devhost.prewarm=N on the
+// kernel cmdline sets the pool size; 0 disables pre-warming.
+#define DEVHOST_PREWARM_DEFAULT 2
+
+static list_node_t list_devhosts_idle = LIST_INITIAL_VALUE(list_devhosts_idle);
+static unsigned devhost_prewarm_target = DEVHOST_PREWARM_DEFAULT;
+static unsigned devhost_prewarm_count;
+
+static void dc_prewarm_devhosts(void) {
+    while (devhost_prewarm_count < devhost_prewarm_target) {
+        devhost_t* dh = calloc(1, sizeof(devhost_t));
+        if (dh == NULL) {
+            return;
+        }
+        zx_handle_t hrpc;
+        if (zx_channel_create(0, &hrpc, &dh->hrpc) < 0) {
+            free(dh);
+            return;
+        }
+        if (dc_launch_devhost(dh, "devhost:idle", hrpc) < 0) {
+            zx_handle_close(dh->hrpc);
+            free(dh);
+            return;
+        }
+        list_add_tail(&list_devhosts_idle, &dh->node);
+        devhost_prewarm_count++;
+    }
+}
+
 static zx_status_t dc_new_devhost(const char* name, devhost_t* parent,
                                   devhost_t** out) {
-    devhost_t* dh = calloc(1, sizeof(devhost_t));
-    if (dh == NULL) {
-        return ZX_ERR_NO_MEMORY;
-    }
+    devhost_t* dh = list_remove_head_type(&list_devhosts_idle, devhost_t, node);
+    if (dh != NULL) {
+        devhost_prewarm_count--;
+        // Rename the claimed process so diagnostics still show which
+        // device this host serves.
+        zx_object_set_property(dh->proc, ZX_PROP_NAME, name, strlen(name));
+        log(DEVLC, "devcoord: claimed prewarmed host %p for '%s'\n", dh, name);
+    } else {
+        dh = calloc(1, sizeof(devhost_t));
+        if (dh == NULL) {
+            return ZX_ERR_NO_MEMORY;
+        }
 
-    zx_handle_t hrpc;
-    zx_status_t r;
-    if ((r = zx_channel_create(0, &hrpc, &dh->hrpc)) < 0) {
-        free(dh);
-        return r;
-    }
+        zx_handle_t hrpc;
+        zx_status_t r;
+        if ((r = zx_channel_create(0, &hrpc, &dh->hrpc)) < 0) {
+            free(dh);
+            return r;
+        }
 
-    if ((r = dc_launch_devhost(dh, name, hrpc)) < 0) {
-        zx_handle_close(dh->hrpc);
-        free(dh);
-        return r;
+        if ((r = dc_launch_devhost(dh, name, hrpc)) < 0) {
+            zx_handle_close(dh->hrpc);
+            free(dh);
+            return r;
+        }
     }
 
+    // Replace the claimed host so the next hot-plug also finds a warm one.
+    dc_prewarm_devhosts();
+
     list_initialize(&dh->devices);
     list_initialize(&dh->children);
 
@@ -2190,6 +2242,11 @@ void coordinator(void) {
 
     dc_asan_drivers = getenv_bool("devmgr.devhost.asan", false);
 
+    const char* prewarm = getenv("devmgr.devhost.prewarm");
+    if (prewarm != NULL) {
+        devhost_prewarm_target = strtoul(prewarm, NULL, 10);
+    }
+
     devfs_publish(&root_device, &misc_device);
     devfs_publish(&root_device, &sys_device);
     devfs_publish(&root_device, &test_device);
@@ -24,8 +24,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <threads.h>
 
@@ -39,16 +41,79 @@
 
 #define LAST_PANIC_FILEPATH "log/last-panic.txt"
 
+typedef struct {
+    uint64_t hash;
+    zx_off_t off;
+    size_t len;
+} dedupe_entry_t;
+
 struct callback_data {
     zx_handle_t vmo;
+    uintptr_t map;
     unsigned int file_count;
+    dedupe_entry_t* dedupe;
+    unsigned int dedupe_count;
+    unsigned int dedupe_cap;
     zx_status_t (*add_file)(const char* path, zx_handle_t vmo, zx_off_t off, size_t len);
 };
 
+static uint64_t fnv1a64(const void* data, size_t len) {
+    const uint8_t* p = data;
+    uint64_t hash = 14695981039346656037ULL;
+    while (len-- > 0) {
+        hash = (hash ^ *p++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Decommit the whole pages of [off, off + len); partial pages at either end
+// are left alone. Best effort: a handle without write rights just keeps its
+// pages.
+static void decommit_pages(zx_handle_t vmo, zx_off_t off, size_t len) {
+    zx_off_t start = (off + PAGE_SIZE - 1) & ~(zx_off_t)(PAGE_SIZE - 1);
+    zx_off_t end = (off + len) & ~(zx_off_t)(PAGE_SIZE - 1);
+    if (end > start) {
+        zx_vmo_op_range(vmo, ZX_VMO_OP_DECOMMIT, start, end - start, NULL, 0);
+    }
+}
+
+// Identical files are common in bootfs images (the same driver, library, or
+// firmware blob packed under several names). Alias later copies to the first
+// one and decommit their pages, so duplicates stop costing memory. Returns
+// the offset the file should be served from.
+static zx_off_t dedupe_file(struct callback_data* cd, zx_off_t off, size_t len) {
+    if (cd->map == 0 || len == 0) {
+        return off;
+    }
+    uint64_t hash = fnv1a64((const void*)(cd->map + off), len);
+    for (unsigned n = 0; n < cd->dedupe_count; n++) {
+        const dedupe_entry_t* de = &cd->dedupe[n];
+        if ((de->hash == hash) && (de->len == len) &&
+            !memcmp((const void*)(cd->map + de->off), (const void*)(cd->map + off), len)) {
+            decommit_pages(cd->vmo, off, len);
+            return de->off;
+        }
+    }
+    if (cd->dedupe_count == cd->dedupe_cap) {
+        unsigned cap = cd->dedupe_cap ? cd->dedupe_cap * 2 : 64;
+        dedupe_entry_t* grown = realloc(cd->dedupe, cap * sizeof(*grown));
+        if (grown == NULL) {
+            return off;
+        }
+        cd->dedupe = grown;
+        cd->dedupe_cap = cap;
+    }
+    cd->dedupe[cd->dedupe_count++] = (dedupe_entry_t){
+        .hash = hash, .off = off, .len = len,
+    };
+    return off;
+}
+
 static zx_status_t callback(void* arg, const bootfs_entry_t* entry) {
     struct callback_data* cd = arg;
     //printf("bootfs: %s @%zd (%zd bytes)\n", path, off, len);
-    cd->add_file(entry->name, cd->vmo, entry->data_off, entry->data_len);
+    zx_off_t off = dedupe_file(cd, entry->data_off, entry->data_len);
+    cd->add_file(entry->name, cd->vmo, off, entry->data_len);
     ++cd->file_count;
     return ZX_OK;
 }
@@ -72,11 +137,14 @@ static zx_status_t setup_bootfs_vmo(uint32_t n, uint32_t type, zx_handle_t vmo)
 
     // map the vmo so that ps will account for it
     // NOTE: will leak the mapping in case the bootfs is thrown away later
-    uintptr_t address;
-    zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ, 0, vmo, 0, size, &address);
+    uintptr_t address = 0;
+    if (zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ, 0, vmo, 0, size, &address) != ZX_OK) {
+        address = 0;
+    }
 
     struct callback_data cd = {
         .vmo = vmo,
+        .map = address,
         .add_file = (type == BOOTDATA_BOOTFS_SYSTEM) ? systemfs_add_file : bootfs_add_file,
     };
     if ((type == BOOTDATA_BOOTFS_SYSTEM) && !has_secondary_bootfs) {
@@ -103,6 +171,7 @@ static zx_status_t setup_bootfs_vmo(uint32_t n, uint32_t type, zx_handle_t vmo)
     } else {
         zx_handle_close(bootfs_vmo);
     }
+    free(cd.dedupe);
     if (type == BOOTDATA_BOOTFS_SYSTEM) {
         systemfs_set_readonly(getenv("zircon.system.writable") == NULL);
     }
@@ -220,6 +289,9 @@ static void setup_bootfs(void) {
                     printf("devmgr: failed to decompress bootdata: %s\n", errmsg);
                 } else {
                     setup_bootfs_vmo(idx++, bootdata.type, bootfs_vmo);
+                    // the compressed copy is dead weight now; drop its pages
+                    // so the peak doesn't stack up across multiple items
+                    decommit_pages(vmo, off + sizeof(bootdata_t), bootdata.length);
                 }
                 break;
             }
@@ -11,6 +11,7 @@
 #include <zircon/boot/bootdata.h>
 #include <zircon/syscalls.h>
 #include <string.h>
+#include <sys/param.h>
 
 #pragma GCC visibility pop
 
@@ -51,6 +52,18 @@ zx_handle_t bootdata_get_bootfs(zx_handle_t log, zx_handle_t vmar_self,
                                     sizeof(bootdata.type)),
                   "zx_vmo_write failed on bootdata VMO\n");
 
+            // The bootdata VMO lives on (devmgr walks it again later), but
+            // the compressed image inside it is dead weight now that it has
+            // been unpacked.  Decommit its whole pages so they stop costing
+            // memory; best effort, since nothing breaks if they stay.
+            size_t payload = off + sizeof(bootdata);
+            size_t start = (payload + PAGE_SIZE - 1) & -(size_t)PAGE_SIZE;
+            size_t end = (payload + bootdata.length) & -(size_t)PAGE_SIZE;
+            if (end > start) {
+                zx_vmo_op_range(bootdata_vmo, ZX_VMO_OP_DECOMMIT,
+                                start, end - start, NULL, 0);
+            }
+
             return bootfs_vmo;
         }
 
@@ -328,6 +328,7 @@ static void vc_reset(vc_t* vc) {
     vc_clear_gfx(vc);
     if (vc_gfx) {
         vc_gfx_invalidate_all(vc);
+        vc_gfx_present();
     }
 }
 
@@ -342,6 +343,7 @@ void vc_status_clear() {
 void vc_status_commit() {
     if (vc_gfx) {
         vc_gfx_invalidate_status();
+        vc_gfx_present();
     }
 }
 
@@ -363,6 +365,7 @@ void vc_render(vc_t* vc) {
     if (vc->active && vc_gfx) {
         vc_status_update();
         vc_gfx_invalidate_all(vc);
+        vc_gfx_present();
     }
 }
 
@@ -606,11 +609,13 @@ void vc_flush(vc_t* vc) {
         int invalidate_y1 = MIN(vc->invy1 - vc->viewport_y, rows);
         vc_gfx_invalidate(vc, 0, invalidate_y0,
                           vc->columns, invalidate_y1 - invalidate_y0);
+        vc_gfx_present();
     }
 }
 
 void vc_flush_all(vc_t* vc) {
     if (vc_gfx) {
         vc_gfx_invalidate_all(vc);
+        vc_gfx_present();
     }
 }
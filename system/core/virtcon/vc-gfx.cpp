@@ -4,6 +4,7 @@
 
 #include <gfx/gfx.h>
 #include <string.h>
+#include <sys/param.h>
 
 #include <zircon/process.h>
 #include <zircon/syscalls.h>
@@ -88,6 +89,10 @@ void vc_gfx_invalidate_region(vc_t* vc, unsigned x, unsigned y, unsigned w, unsi
         gfx_blend(vc_test_gfx, vc_gfx, x, y, w, h, x, desty);
     }
 }
+
+void vc_gfx_present() {
+    // test surfaces are updated synchronously by the invalidate calls
+}
 #else
 static zx_handle_t vc_gfx_vmo = ZX_HANDLE_INVALID;
 static uintptr_t vc_gfx_mem = 0;
@@ -97,6 +102,40 @@ static zx_handle_t vc_hw_gfx_vmo = ZX_HANDLE_INVALID;
 static gfx_surface* vc_hw_gfx = 0;
 static uintptr_t vc_hw_gfx_mem = 0;
 
+// Damage accumulated since the last vc_gfx_present(), in pixels relative to
+// the whole image (status bar included). All rendering goes to the offscreen
+// back buffer; presentation copies just the damaged rows to the scanout
+// image in one batch, so a partially drawn frame is never visible.
+static bool vc_gfx_damage = false;
+static unsigned vc_gfx_damage_x0, vc_gfx_damage_y0;
+static unsigned vc_gfx_damage_x1, vc_gfx_damage_y1; // exclusive
+
+static void vc_gfx_damage_add(unsigned x, unsigned y, unsigned w, unsigned h) {
+    if (!vc_hw_gfx || x >= vc_hw_gfx->width || y >= vc_hw_gfx->height || !w || !h) {
+        return;
+    }
+    unsigned x1 = x + w;
+    unsigned y1 = y + h;
+    if (x1 > vc_hw_gfx->width) {
+        x1 = vc_hw_gfx->width;
+    }
+    if (y1 > vc_hw_gfx->height) {
+        y1 = vc_hw_gfx->height;
+    }
+    if (!vc_gfx_damage) {
+        vc_gfx_damage = true;
+        vc_gfx_damage_x0 = x;
+        vc_gfx_damage_y0 = y;
+        vc_gfx_damage_x1 = x1;
+        vc_gfx_damage_y1 = y1;
+        return;
+    }
+    vc_gfx_damage_x0 = MIN(vc_gfx_damage_x0, x);
+    vc_gfx_damage_y0 = MIN(vc_gfx_damage_y0, y);
+    vc_gfx_damage_x1 = MAX(vc_gfx_damage_x1, x1);
+    vc_gfx_damage_y1 = MAX(vc_gfx_damage_y1, y1);
+}
+
 void vc_free_gfx() {
     if (vc_gfx) {
         gfx_surface_destroy(vc_gfx);
@@ -122,6 +161,7 @@ void vc_free_gfx() {
         zx_handle_close(vc_hw_gfx_vmo);
         vc_hw_gfx_vmo = ZX_HANDLE_INVALID;
     }
+    vc_gfx_damage = false;
 }
 
 zx_status_t vc_init_gfx(zx_handle_t fb_vmo, int32_t width, int32_t height,
@@ -132,31 +172,31 @@ zx_status_t vc_init_gfx(zx_handle_t fb_vmo, int32_t width, int32_t height,
     vc_gfx_size = stride * ZX_PIXEL_FORMAT_BYTES(format) * height;
 
     zx_status_t r;
-    // If we can't efficiently read from the framebuffer VMO, create a secondary
-    // surface using a regular VMO and blit contents between the two.
-    if ((r = zx_vmo_set_cache_policy(fb_vmo, ZX_CACHE_POLICY_CACHED)) == ZX_ERR_BAD_STATE) {
-        if ((r = zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ | ZX_VM_PERM_WRITE,
-                             0, fb_vmo, 0, vc_gfx_size, &vc_hw_gfx_mem)) < 0) {
-            goto fail;
-        }
-
-        if ((vc_hw_gfx = gfx_create_surface((void*) vc_hw_gfx_mem, width, height,
-                                            stride, format, 0)) == NULL) {
-            r = ZX_ERR_INTERNAL;
-            goto fail;
-        }
-
-        vc_hw_gfx_vmo = fb_vmo;
-
-        if ((r = zx_vmo_create(vc_gfx_size, 0, &fb_vmo)) < 0) {
-            goto fail;
-        }
-    } else if (r != ZX_OK) {
+    uintptr_t ptr;
+
+    // Always render into an offscreen back buffer and let vc_gfx_present()
+    // copy the damaged rows to the scanout image in one batch, so the
+    // display never scans out a partially drawn frame. A cached mapping of
+    // the scanout image speeds up those copies where the hardware allows
+    // it, but an uncached mapping works too.
+    zx_vmo_set_cache_policy(fb_vmo, ZX_CACHE_POLICY_CACHED);
+
+    vc_hw_gfx_vmo = fb_vmo;
+    if ((r = zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ | ZX_VM_PERM_WRITE,
+                         0, fb_vmo, 0, vc_gfx_size, &vc_hw_gfx_mem)) < 0) {
+        goto fail;
+    }
+
+    if ((vc_hw_gfx = gfx_create_surface((void*) vc_hw_gfx_mem, width, height,
+                                        stride, format, 0)) == NULL) {
+        r = ZX_ERR_INTERNAL;
+        goto fail;
+    }
+
+    if ((r = zx_vmo_create(vc_gfx_size, 0, &vc_gfx_vmo)) < 0) {
         goto fail;
     }
 
-    uintptr_t ptr;
-    vc_gfx_vmo = fb_vmo;
     if ((r = zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ | ZX_VM_PERM_WRITE,
                          0, vc_gfx_vmo, 0, vc_gfx_size, &vc_gfx_mem)) < 0) {
         goto fail;
@@ -185,26 +225,14 @@ fail:
     return r;
 }
 
-static void vc_gfx_invalidate_mem(size_t offset, size_t size) {
-    void* ptr;
-    if (vc_hw_gfx_mem) {
-        void* data_ptr = reinterpret_cast<void*>(vc_gfx_mem + offset);
-        ptr = reinterpret_cast<void*>(vc_hw_gfx_mem + offset);
-        memcpy(ptr, data_ptr, size);
-    } else {
-        ptr = reinterpret_cast<void*>(vc_gfx_mem + offset);
-    }
-    zx_cache_flush(ptr, size, ZX_CACHE_FLUSH_DATA);
-}
-
 void vc_gfx_invalidate_all(vc_t* vc) {
     if (vc->active) {
-        vc_gfx_invalidate_mem(0, vc_gfx_size);
+        vc_gfx_damage_add(0, 0, vc_hw_gfx->width, vc_hw_gfx->height);
     }
 }
 
 void vc_gfx_invalidate_status() {
-    vc_gfx_invalidate_mem(0, vc_tb_gfx->stride * vc_tb_gfx->height * vc_tb_gfx->pixelsize);
+    vc_gfx_damage_add(0, 0, vc_tb_gfx->width, vc_tb_gfx->height);
 }
 
 // pixel coords
@@ -212,11 +240,25 @@ void vc_gfx_invalidate_region(vc_t* vc, unsigned x, unsigned y, unsigned w, unsi
     if (!vc->active) {
         return;
     }
-    uint32_t flush_size = w * vc_gfx->pixelsize;
-    size_t offset = vc_gfx->stride * (vc->charh + y) * vc_gfx->pixelsize;
-    for (unsigned i = 0; i < h; i++, offset += (vc_gfx->stride * vc_gfx->pixelsize)) {
-        vc_gfx_invalidate_mem(offset, flush_size);
+    vc_gfx_damage_add(x, vc->charh + y, w, h);
+}
+
+void vc_gfx_present() {
+    if (!vc_gfx_damage || !vc_hw_gfx) {
+        return;
+    }
+    unsigned row_bytes = vc_hw_gfx->stride * vc_hw_gfx->pixelsize;
+    size_t offset = vc_gfx_damage_y0 * row_bytes +
+                    vc_gfx_damage_x0 * vc_hw_gfx->pixelsize;
+    size_t size = (vc_gfx_damage_x1 - vc_gfx_damage_x0) * vc_hw_gfx->pixelsize;
+    for (unsigned y = vc_gfx_damage_y0; y < vc_gfx_damage_y1; y++, offset += row_bytes) {
+        memcpy(reinterpret_cast<void*>(vc_hw_gfx_mem + offset),
+               reinterpret_cast<void*>(vc_gfx_mem + offset), size);
     }
+    // one flush covering all of the damaged rows of the scanout image
+    zx_cache_flush(reinterpret_cast<void*>(vc_hw_gfx_mem + vc_gfx_damage_y0 * row_bytes),
+                   (vc_gfx_damage_y1 - vc_gfx_damage_y0) * row_bytes, ZX_CACHE_FLUSH_DATA);
+    vc_gfx_damage = false;
 }
 
 // text coords
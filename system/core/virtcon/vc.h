@@ -141,6 +141,8 @@ static inline int vc_rows(vc_t* vc) {
 
 void vc_gfx_invalidate_all(vc_t* vc);
 void vc_gfx_invalidate_status();
+// copies accumulated damage from the back buffer to the scanout image
+void vc_gfx_present();
 // invalidates a region in characters
 void vc_gfx_invalidate(vc_t* vc, unsigned x, unsigned y, unsigned w, unsigned h);
 // invalidates a region in pixels
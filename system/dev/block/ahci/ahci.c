@@ -11,6 +11,7 @@
 #include <ddk/protocol/pci.h>
 
 #include <assert.h>
+#include <zircon/device/block.h>
 #include <zircon/listnode.h>
 #include <zircon/syscalls.h>
 #include <zircon/types.h>
@@ -66,6 +67,14 @@ typedef struct ahci_port {
     uint32_t completed; // bitmask of completed commands
     sata_txn_t* commands[AHCI_MAX_COMMANDS]; // commands in flight
     sata_txn_t* sync;   // FLUSH command in flight
+
+    // stats, guarded by lock, reported by IOCTL_BLOCK_GET_STATS
+    size_t stat_concur;
+    size_t stat_pending;
+    size_t stat_max_concur;
+    size_t stat_max_pending;
+    size_t stat_total_ops;
+    size_t stat_total_blocks;
 } ahci_port_t;
 
 struct ahci_device {
@@ -194,6 +203,22 @@ static bool ahci_port_cmd_busy(ahci_port_t* port, int slot) {
            (port->running & (1 << slot)) || (port->completed & (1 << slot));
 }
 
+// Returns a free command slot in [0, max], or -1 if all slots are busy.
+// The driver's running/completed masks mirror the hardware state, so the
+// sact/ci registers are read once per call as a cross-check rather than
+// per candidate slot; this keeps the worker filling slots without a pair
+// of MMIO reads for every slot it considers.
+static int ahci_port_find_slot(ahci_port_t* port, int max) {
+    uint32_t busy = port->running | port->completed |
+                    ahci_read(&port->regs->sact) | ahci_read(&port->regs->ci);
+    for (int i = 0; i <= max; i++) {
+        if (!(busy & (1u << i)) && (port->commands[i] == NULL)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 static bool cmd_is_read(uint8_t cmd) {
     if (cmd == SATA_CMD_READ_DMA ||
         cmd == SATA_CMD_READ_DMA_EXT ||
@@ -239,23 +264,31 @@ static zx_status_t ahci_do_txn(ahci_device_t* dev, ahci_port_t* port, int slot,
     uint64_t bytes = txn->bop.rw.length * port->devinfo.block_size;
     size_t pagecount = ((offset_vmo & (PAGE_SIZE - 1)) + bytes + (PAGE_SIZE - 1)) /
                        PAGE_SIZE;
-    zx_paddr_t pages[AHCI_MAX_PAGES];
+    zx_paddr_t pagebuf[AHCI_MAX_PAGES];
     if (pagecount > AHCI_MAX_PAGES) {
         zxlogf(SPEW, "ahci.%d: txn %p too many pages (%zd)\n", port->nr, txn, pagecount);
         return ZX_ERR_INVALID_ARGS;
     }
 
-    zx_handle_t vmo = txn->bop.rw.vmo;
     bool is_write = cmd_is_write(txn->cmd);
-    uint32_t options = is_write ? ZX_BTI_PERM_READ : ZX_BTI_PERM_WRITE;
-    zx_handle_t pmt;
-    zx_status_t st = zx_bti_pin(dev->bti_handle, options, vmo, offset_vmo & ~PAGE_MASK,
-                                pagecount * PAGE_SIZE, pages, pagecount, &pmt);
-    if (st != ZX_OK) {
-        zxlogf(SPEW, "ahci.%d: failed to pin pages, err = %d\n", port->nr, st);
-        return st;
+    zx_paddr_t* pages = (zx_paddr_t*)txn->bop.rw.pages;
+    if (pages == NULL) {
+        // pin the vmo and build the scatter list ourselves
+        zx_handle_t vmo = txn->bop.rw.vmo;
+        uint32_t options = is_write ? ZX_BTI_PERM_READ : ZX_BTI_PERM_WRITE;
+        zx_handle_t pmt;
+        zx_status_t st = zx_bti_pin(dev->bti_handle, options, vmo, offset_vmo & ~PAGE_MASK,
+                                    pagecount * PAGE_SIZE, pagebuf, pagecount, &pmt);
+        if (st != ZX_OK) {
+            zxlogf(SPEW, "ahci.%d: failed to pin pages, err = %d\n", port->nr, st);
+            return st;
+        }
+        txn->pmt = pmt;
+        pages = pagebuf;
+    } else {
+        // the caller pinned the vmo and provided its physical pages
+        txn->pmt = ZX_HANDLE_INVALID;
     }
-    txn->pmt = pmt;
 
     phys_iter_buffer_t physbuf = {
         .phys = pages,
@@ -345,6 +378,9 @@ static zx_status_t ahci_do_txn(ahci_device_t* dev, ahci_port_t* port, int slot,
 
     port->running |= (1 << slot);
     port->commands[slot] = txn;
+    if (++port->stat_concur > port->stat_max_concur) {
+        port->stat_max_concur = port->stat_concur;
+    }
 
     zxlogf(SPEW, "ahci.%d: do_txn txn %p (%c) offset 0x%" PRIx64 " length 0x%" PRIx64
                   " slot %d prdtl %u\n",
@@ -489,12 +525,37 @@ void ahci_queue(ahci_device_t* device, int portnr, sata_txn_t* txn) {
     // put the cmd on the queue
     mtx_lock(&port->lock);
     list_add_tail(&port->txn_list, &txn->node);
+    if (++port->stat_pending > port->stat_max_pending) {
+        port->stat_max_pending = port->stat_pending;
+    }
+    port->stat_total_ops++;
+    uint32_t op = BLOCK_OP(txn->bop.command);
+    if ((op == BLOCK_OP_READ) || (op == BLOCK_OP_WRITE)) {
+        port->stat_total_blocks += txn->bop.rw.length;
+    }
 
     // hit the worker thread
     sync_completion_signal(&device->worker_completion);
     mtx_unlock(&port->lock);
 }
 
+void ahci_get_stats(ahci_device_t* device, int portnr, block_stats_t* out, bool clear) {
+    ZX_DEBUG_ASSERT(ahci_port_valid(device, portnr));
+    ahci_port_t* port = &device->ports[portnr];
+    mtx_lock(&port->lock);
+    out->max_concur = port->stat_max_concur;
+    out->max_pending = port->stat_max_pending;
+    out->total_ops = port->stat_total_ops;
+    out->total_blocks = port->stat_total_blocks;
+    if (clear) {
+        port->stat_max_concur = port->stat_concur;
+        port->stat_max_pending = port->stat_pending;
+        port->stat_total_ops = 0;
+        port->stat_total_blocks = 0;
+    }
+    mtx_unlock(&port->lock);
+}
+
 static void ahci_release(void* ctx) {
     // FIXME - join threads created by this driver
     ahci_device_t* device = ctx;
@@ -537,6 +598,7 @@ static int ahci_worker_thread(void* arg) {
                 port->completed &= ~(1 << slot);
                 port->running &= ~(1 << slot);
                 port->commands[slot] = NULL;
+                port->stat_concur--;
                 // resume the port if paused for sync and no outstanding transactions
                 if ((port->flags & AHCI_PORT_FLAG_SYNC_PAUSED) && !port->running) {
                     port->flags &= ~AHCI_PORT_FLAG_SYNC_PAUSED;
@@ -563,15 +625,13 @@ static int ahci_worker_thread(void* arg) {
 
                 // find a free command tag
                 int max = MIN(port->devinfo.max_cmd, (int)((dev->cap >> 8) & 0x1f));
-                int i = 0;
-                for (i = 0; i <= max; i++) {
-                    if (!ahci_port_cmd_busy(port, i)) break;
-                }
-                if (i > max) {
+                int i = ahci_port_find_slot(port, max);
+                if (i < 0) {
                     break;
                 }
 
                 list_delete(&txn->node);
+                port->stat_pending--;
 
                 if (BLOCK_OP(txn->bop.command) == BLOCK_OP_FLUSH) {
                     if (port->running) {
@@ -632,6 +692,7 @@ static int ahci_watchdog_thread(void* arg) {
                         zxlogf(ERROR, "ahci: txn time out on port %d txn %p\n", port->nr, txn);
                         port->running &= ~(1 << slot);
                         port->commands[slot] = NULL;
+                        port->stat_concur--;
                         mtx_unlock(&port->lock);
                         block_complete(&txn->bop, ZX_ERR_TIMED_OUT);
                         mtx_lock(&port->lock);
@@ -200,6 +200,18 @@ static zx_status_t sata_ioctl(void* ctx, uint32_t op, const void* cmd, size_t cm
         *out_actual = sizeof(*info);
         return ZX_OK;
     }
+    case IOCTL_BLOCK_GET_STATS: {
+        if (cmdlen != sizeof(bool)) {
+            return ZX_ERR_INVALID_ARGS;
+        }
+        block_stats_t* out = reply;
+        if (max < sizeof(*out)) {
+            return ZX_ERR_BUFFER_TOO_SMALL;
+        }
+        ahci_get_stats(device->controller, device->port, out, *(bool*)cmd);
+        *out_actual = sizeof(*out);
+        return ZX_OK;
+    }
     case IOCTL_DEVICE_SYNC: {
         zxlogf(TRACE, "sata: IOCTL_DEVICE_SYNC\n");
         return ZX_OK;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ddk/protocol/block.h>
+#include <zircon/device/block.h>
 #include "ahci.h"
 
 #define SATA_CMD_IDENTIFY_DEVICE      0xec
@@ -65,6 +66,9 @@ void ahci_set_devinfo(ahci_device_t* controller, int portnr, sata_devinfo_t* dev
 // queue a txn on the controller
 void ahci_queue(ahci_device_t* controller, int portnr, sata_txn_t* txn);
 
+// reads (and optionally clears) the io stats for the port at portnr
+void ahci_get_stats(ahci_device_t* controller, int portnr, block_stats_t* out, bool clear);
+
 static inline void block_complete(block_op_t* bop, zx_status_t status) {
     bop->completion_cb(bop, status);
 }
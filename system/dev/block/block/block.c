@@ -192,6 +192,21 @@ static zx_status_t blkdev_ioctl(void* ctx, uint32_t op, const void* cmd,
     }
     case IOCTL_BLOCK_RR_PART:
         return blkdev_rebind(blkdev);
+    case IOCTL_BLOCK_GET_SCHED_STATS: {
+        if ((cmdlen < sizeof(bool)) || (max < sizeof(block_sched_stats_t))) {
+            return ZX_ERR_INVALID_ARGS;
+        }
+        mtx_lock(&blkdev->lock);
+        zx_status_t status = ZX_OK;
+        if (blkdev->bs == NULL) {
+            status = ZX_ERR_BAD_STATE;
+        } else {
+            blockserver_get_sched_stats(blkdev->bs, *(const bool*)cmd, reply);
+            *out_actual = sizeof(block_sched_stats_t);
+        }
+        mtx_unlock(&blkdev->lock);
+        return status;
+    }
     case IOCTL_BLOCK_GET_INFO: {
         size_t actual;
         zx_status_t status = device_ioctl(blkdev->parent, op, cmd, cmdlen, reply, max, &actual);
@@ -0,0 +1,157 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <ddk/device.h>
+#include <fbl/limits.h>
+#include <zircon/syscalls.h>
+
+#include "server.h"
+
+namespace {
+
+// How long a write may wait behind a stream of reads before it is
+// dispatched anyway.
+constexpr zx_duration_t kWriteDeadline = ZX_MSEC(500);
+
+// How many consecutive reads may be dispatched while a write is waiting.
+constexpr uint32_t kMaxReadStreak = 16;
+
+} // namespace
+
+IoScheduler::IoScheduler() : ordered_count_(0), count_(0), read_streak_(0),
+    max_xfer_blocks_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void IoScheduler::Initialize(uint32_t max_xfer_blocks) {
+    max_xfer_blocks_ = max_xfer_blocks;
+}
+
+bool IoScheduler::Mergeable(const block_msg_t* tail, const block_msg_t* msg) const {
+    if (tail->op.command != msg->op.command) {
+        return false;
+    }
+    if (tail->op.rw.vmo != msg->op.rw.vmo) {
+        return false;
+    }
+    if ((tail->op.rw.offset_dev + tail->op.rw.length != msg->op.rw.offset_dev) ||
+        (tail->op.rw.offset_vmo + tail->op.rw.length != msg->op.rw.offset_vmo)) {
+        return false;
+    }
+    uint64_t length = (uint64_t) tail->op.rw.length + msg->op.rw.length;
+    if (length > fbl::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    if ((max_xfer_blocks_ != 0) && (length > max_xfer_blocks_)) {
+        return false;
+    }
+    return true;
+}
+
+bool IoScheduler::Enqueue(block_msg_t* msg) {
+    const uint32_t opcode = msg->op.command & BLOCK_OP_MASK;
+    const bool barrier = (msg->op.command &
+                          (BLOCK_FL_BARRIER_BEFORE | BLOCK_FL_BARRIER_AFTER)) != 0;
+    const bool rw = (opcode == BLOCK_OP_READ) || (opcode == BLOCK_OP_WRITE);
+    msg->extra.sched_time = zx_clock_get_monotonic();
+
+    if (opcode == BLOCK_OP_READ) {
+        stats_.total_reads++;
+    } else if (opcode == BLOCK_OP_WRITE) {
+        stats_.total_writes++;
+    } else {
+        stats_.total_other++;
+    }
+
+    // Merging is only safe when nothing queued carries ordering
+    // constraints; otherwise the absorbed operation could effectively
+    // jump a barrier.
+    if (rw && !barrier && ordered_count_ == 0) {
+        SchedMsgList& list = (opcode == BLOCK_OP_READ) ? reads_ : writes_;
+        if (!list.is_empty()) {
+            block_msg_t* tail = &list.back();
+            if (Mergeable(tail, msg)) {
+                tail->op.rw.length += msg->op.rw.length;
+                msg->extra.merge_next = tail->extra.merge_next;
+                tail->extra.merge_next = msg;
+                stats_.merged_ops++;
+                return true;
+            }
+        }
+    }
+
+    arrival_.push_back(msg);
+    if (opcode == BLOCK_OP_READ) {
+        reads_.push_back(msg);
+    } else if (opcode == BLOCK_OP_WRITE) {
+        writes_.push_back(msg);
+    }
+    count_++;
+    if (barrier || !rw) {
+        // Everything queued so far (this operation included) must now
+        // drain in arrival order.
+        ordered_count_ = count_;
+    }
+    if (count_ > stats_.max_queued) {
+        stats_.max_queued = count_;
+    }
+    return false;
+}
+
+block_msg_t* IoScheduler::Front() {
+    if (arrival_.is_empty()) {
+        return nullptr;
+    }
+    if (ordered_count_ > 0) {
+        return &arrival_.front();
+    }
+    if (!writes_.is_empty()) {
+        if (reads_.is_empty()) {
+            return &writes_.front();
+        }
+        // Reads are dispatched first, unless the oldest write has aged
+        // past its deadline or reads have monopolized the device.
+        block_msg_t* write = &writes_.front();
+        const zx_time_t now = zx_clock_get_monotonic();
+        if ((now - write->extra.sched_time >= kWriteDeadline) ||
+            (read_streak_ >= kMaxReadStreak)) {
+            return write;
+        }
+    }
+    ZX_DEBUG_ASSERT(!reads_.is_empty());
+    return &reads_.front();
+}
+
+void IoScheduler::Pop(block_msg_t* msg) {
+    const bool was_ordered = ordered_count_ > 0;
+    ZX_DEBUG_ASSERT(!was_ordered || msg == &arrival_.front());
+    arrival_.erase(*msg);
+    if (was_ordered) {
+        ordered_count_--;
+    }
+
+    const uint32_t opcode = msg->op.command & BLOCK_OP_MASK;
+    if (opcode == BLOCK_OP_READ) {
+        reads_.erase(*msg);
+        read_streak_++;
+    } else if (opcode == BLOCK_OP_WRITE) {
+        writes_.erase(*msg);
+        if (!was_ordered && !reads_.is_empty()) {
+            stats_.expedited_writes++;
+        }
+        read_streak_ = 0;
+    } else {
+        read_streak_ = 0;
+    }
+    count_--;
+}
+
+void IoScheduler::GetStats(bool clear, block_sched_stats_t* out) {
+    *out = stats_;
+    if (clear) {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+}
@@ -28,9 +28,6 @@ namespace {
 // This signal is set on the FIFO when the server should be instructed
 // to terminate.
 constexpr zx_signals_t kSignalFifoTerminate   = ZX_USER_SIGNAL_0;
-// This signal is set on the FIFO when, after the thread enqueueing operations
-// has encountered a barrier, all prior operations have completed.
-constexpr zx_signals_t kSignalFifoOpsComplete = ZX_USER_SIGNAL_1;
 // Signalled on the fifo when it has finished terminating.
 // (If we need to free up user signals, this could easily be transformed
 // into a completion object).
@@ -56,6 +53,16 @@ void OutOfBandRespond(const fzl::fifo<block_fifo_response_t, block_fifo_request_
 
 void BlockComplete(BlockMsg* msg, zx_status_t status) {
     auto extra = msg->extra();
+    // Complete any operations the scheduler merged into this one; they
+    // were never individually submitted to the driver (and never counted
+    // against the pending op count).
+    block_msg_t* merged = extra->merge_next;
+    while (merged != nullptr) {
+        BlockMsg sub(merged);
+        merged = sub.extra()->merge_next;
+        sub.extra()->iobuf = nullptr;
+        extra->server->TxnComplete(status, sub.extra()->reqid, sub.extra()->group);
+    }
     // Since iobuf is a RefPtr, it lives at least as long as the txn,
     // and is not discarded underneath the block device driver.
     extra->iobuf = nullptr;
@@ -81,8 +88,8 @@ uint32_t OpcodeToCommand(uint32_t opcode) {
     return opcode & shared;
 }
 
-void InQueueAdd(zx_handle_t vmo, uint64_t length, uint64_t vmo_offset,
-                uint64_t dev_offset, block_msg_t* msg, BlockMsgQueue* queue) {
+void PrepareOp(zx_handle_t vmo, uint64_t length, uint64_t vmo_offset,
+               uint64_t dev_offset, block_msg_t* msg) {
     block_op_t* bop = &msg->op;
     bop->rw.length = (uint32_t) length;
     bop->rw.vmo = vmo;
@@ -91,7 +98,6 @@ void InQueueAdd(zx_handle_t vmo, uint64_t length, uint64_t vmo_offset,
     bop->rw.pages = NULL;
     bop->completion_cb = BlockCompleteCb;
     bop->cookie = msg;
-    queue->push_back(msg);
 }
 
 }  // namespace
@@ -111,28 +117,12 @@ zx_status_t IoBuffer::ValidateVmoHack(uint64_t length, uint64_t vmo_offset) {
     return ZX_OK;
 }
 
-void BlockServer::BarrierComplete() {
-    // This is the only location that unsets the OpsComplete
-    // signal. We'll never "miss" a signal, because we process
-    // the queue AFTER unsetting it.
-    barrier_in_progress_.store(false);
-    fifo_.signal(kSignalFifoOpsComplete, 0);
-    InQueueDrainer();
-}
-
 void BlockServer::TerminateQueue() {
-    InQueueDrainer();
-    while (true) {
-        if (pending_count_.load() == 0 && in_queue_.is_empty()) {
-            return;
-        }
-        zx_signals_t signals = kSignalFifoOpsComplete;
-        zx_signals_t seen = 0;
-        fifo_.wait_one(signals, zx::deadline_after(zx::msec(10)), &seen);
-        if (seen & kSignalFifoOpsComplete) {
-            BarrierComplete();
-        }
-    }
+    // The drainer thread exits only once the input queue is empty and all
+    // pending operations have completed.
+    drainer_shutdown_.store(true);
+    sync_completion_signal(&queue_signal_);
+    thrd_join(drainer_, nullptr);
 }
 void BlockServer::TxnComplete(zx_status_t status, reqid_t reqid, groupid_t group) {
     if (group == kNoGroup) {
@@ -147,7 +137,10 @@ zx_status_t BlockServer::Read(block_fifo_request_t* requests, size_t* count) {
     auto cleanup = fbl::MakeAutoCall([this]() {
         TerminateQueue();
         ZX_ASSERT(pending_count_.load() == 0);
-        ZX_ASSERT(in_queue_.is_empty());
+        {
+            fbl::AutoLock queue_lock(&queue_lock_);
+            ZX_ASSERT(sched_.is_empty());
+        }
         fifo_.signal(0, kSignalFifoTerminated);
     });
 
@@ -160,15 +153,10 @@ zx_status_t BlockServer::Read(block_fifo_request_t* requests, size_t* count) {
         zx_signals_t seen;
         switch (status) {
         case ZX_ERR_SHOULD_WAIT:
-            signals = ZX_FIFO_READABLE | ZX_FIFO_PEER_CLOSED |
-                    kSignalFifoTerminate | kSignalFifoOpsComplete;
+            signals = ZX_FIFO_READABLE | ZX_FIFO_PEER_CLOSED | kSignalFifoTerminate;
             if ((status = fifo_.wait_one(signals, zx::time::infinite(), &seen)) != ZX_OK) {
                 return status;
             }
-            if (seen & kSignalFifoOpsComplete) {
-                BarrierComplete();
-                continue;
-            }
             if ((seen & ZX_FIFO_PEER_CLOSED) || (seen & kSignalFifoTerminate)) {
                 return ZX_ERR_PEER_CLOSED;
             }
@@ -222,40 +210,49 @@ zx_status_t BlockServer::AttachVmo(zx::vmo vmo, vmoid_t* out) {
 void BlockServer::TxnEnd() {
     size_t old_count = pending_count_.fetch_sub(1);
     ZX_ASSERT(old_count > 0);
-    if ((old_count == 1) && barrier_in_progress_.load()) {
-        // Since we're avoiding locking, and there is a gap between
-        // "pending count decremented" and "FIFO signalled", it's possible
-        // that we'll receive spurious wakeup requests.
-        fifo_.signal(0, kSignalFifoOpsComplete);
+    if (old_count == 1) {
+        // Wake the drainer thread; it may be waiting for all pending
+        // operations to complete, either because of a barrier or because
+        // it is terminating. Since we're avoiding locking, and there is a
+        // gap between "pending count decremented" and "drainer signalled",
+        // it's possible that we'll deliver spurious wakeup requests.
+        sync_completion_signal(&queue_signal_);
     }
 }
 
-void BlockServer::InQueueDrainer() {
+void BlockServer::DrainQueue() {
     while (true) {
-        if (in_queue_.is_empty()) {
-            return;
-        }
+        block_msg_t* msg;
+        {
+            fbl::AutoLock queue_lock(&queue_lock_);
+            block_msg_t* front = sched_.Front();
+            if (front == nullptr) {
+                return;
+            }
 
-        auto msg = in_queue_.begin();
-        if (deferred_barrier_before_) {
-            msg->op.command |= BLOCK_FL_BARRIER_BEFORE;
-            deferred_barrier_before_ = false;
-        }
+            // A deferred barrier (from a completed BARRIER_AFTER op) and
+            // an explicit BARRIER_BEFORE are handled identically: nothing
+            // further is dispatched until all in-flight operations have
+            // completed.
+            if (deferred_barrier_before_ ||
+                (front->op.command & BLOCK_FL_BARRIER_BEFORE)) {
+                barrier_in_progress_.store(true);
+                if (pending_count_.load() > 0) {
+                    return;
+                }
+                // Since we're the only thread that could add to pending
+                // count, we reliably know it has terminated.
+                barrier_in_progress_.store(false);
+                deferred_barrier_before_ = false;
+            }
 
-        if (msg->op.command & BLOCK_FL_BARRIER_BEFORE) {
-            barrier_in_progress_.store(true);
-            if (pending_count_.load() > 0) {
-                return;
+            if (front->op.command & BLOCK_FL_BARRIER_AFTER) {
+                deferred_barrier_before_ = true;
             }
-            // Since we're the only thread that could add to pending
-            // count, we reliably know it has terminated.
-            barrier_in_progress_.store(false);
-        }
-        if (msg->op.command & BLOCK_FL_BARRIER_AFTER) {
-            deferred_barrier_before_ = true;
+            pending_count_.fetch_add(1);
+            sched_.Pop(front);
+            msg = front;
         }
-        pending_count_.fetch_add(1);
-        in_queue_.pop_front();
         // Underlying block device drivers should not see block barriers
         // which are already handled by the block midlayer.
         //
@@ -266,6 +263,26 @@ void BlockServer::InQueueDrainer() {
     }
 }
 
+int BlockServer::DrainerLoop() {
+    while (true) {
+        sync_completion_wait(&queue_signal_, ZX_TIME_INFINITE);
+        // Reset before draining; a signal which arrives mid-drain simply
+        // causes one extra (empty) pass through the queue.
+        sync_completion_reset(&queue_signal_);
+        DrainQueue();
+        if (drainer_shutdown_.load()) {
+            fbl::AutoLock queue_lock(&queue_lock_);
+            if (sched_.is_empty() && pending_count_.load() == 0) {
+                return 0;
+            }
+        }
+    }
+}
+
+int BlockServer::DrainerThunk(void* arg) {
+    return reinterpret_cast<BlockServer*>(arg)->DrainerLoop();
+}
+
 zx_status_t BlockServer::Create(zx_device_t* dev, block_protocol_t* bp,
                                 fzl::fifo<block_fifo_request_t, block_fifo_response_t>* fifo_out,
                                 BlockServer** out) {
@@ -298,6 +315,12 @@ zx_status_t BlockServer::Create(zx_device_t* dev, block_protocol_t* bp,
         bp->ops->query(bp->ctx, &bs->info_, &bs->block_op_size_);
     }
 
+    // Cap scheduler merging at the device's maximum transfer size, so a
+    // merged operation never needs to be re-split.
+    if (bs->info_.block_size > 0) {
+        bs->sched_.Initialize(bs->info_.max_transfer_size / bs->info_.block_size);
+    }
+
     // TODO(ZX-1583): Allocate BlockMsg arena based on block_op_size_.
 
     *out = bs;
@@ -391,8 +414,9 @@ void BlockServer::ProcessRequest(block_fifo_request_t* request) {
                 // Only set the "BEFORE" barrier on the first sub-txn.
                 msg.op()->command &= ~(sub_txn_idx == 0 ? 0 :
                                        BLOCK_FL_BARRIER_BEFORE);
-                InQueueAdd(iobuf->vmo(), length, vmo_offset, dev_offset, msg.release(),
-                           &sub_txns_queue);
+                block_msg_t* sub_msg = msg.release();
+                PrepareOp(iobuf->vmo(), length, vmo_offset, dev_offset, sub_msg);
+                sub_txns_queue.push_back(sub_msg);
                 vmo_offset += length;
                 dev_offset += length;
                 sub_txn_idx++;
@@ -400,11 +424,19 @@ void BlockServer::ProcessRequest(block_fifo_request_t* request) {
             groups_[group].CtrAdd(sub_txns - 1);
             ZX_DEBUG_ASSERT(len_remaining == 0);
 
-            in_queue_.splice(in_queue_.end(), sub_txns_queue);
+            fbl::AutoLock queue_lock(&queue_lock_);
+            block_msg_t* sub_msg;
+            while ((sub_msg = sub_txns_queue.pop_front()) != nullptr) {
+                sched_.Enqueue(sub_msg);
+            }
         } else {
-            InQueueAdd(iobuf->vmo(), request->length, request->vmo_offset,
-                       request->dev_offset, msg.release(), &in_queue_);
+            block_msg_t* raw_msg = msg.release();
+            PrepareOp(iobuf->vmo(), request->length, request->vmo_offset,
+                      request->dev_offset, raw_msg);
+            fbl::AutoLock queue_lock(&queue_lock_);
+            sched_.Enqueue(raw_msg);
         }
+        sync_completion_signal(&queue_signal_);
 
         break;
     }
@@ -437,7 +469,13 @@ void BlockServer::ProcessRequest(block_fifo_request_t* request) {
         extra->reqid = reqid;
         extra->group = group;
         msg.op()->command = OpcodeToCommand(request->opcode);
-        InQueueAdd(ZX_HANDLE_INVALID, 0, 0, 0, msg.release(), &in_queue_);
+        {
+            block_msg_t* raw_msg = msg.release();
+            PrepareOp(ZX_HANDLE_INVALID, 0, 0, 0, raw_msg);
+            fbl::AutoLock queue_lock(&queue_lock_);
+            sched_.Enqueue(raw_msg);
+        }
+        sync_completion_signal(&queue_signal_);
         break;
     }
     default: {
@@ -449,14 +487,17 @@ void BlockServer::ProcessRequest(block_fifo_request_t* request) {
 }
 
 zx_status_t BlockServer::Serve() {
+    // The drainer thread submits queued operations to the underlying
+    // driver while this thread reads and validates further requests.
+    if (thrd_create_with_name(&drainer_, DrainerThunk, this,
+                              "block-server-drain") != thrd_success) {
+        return ZX_ERR_NO_RESOURCES;
+    }
+
     zx_status_t status;
     block_fifo_request_t requests[BLOCK_FIFO_MAX_DEPTH];
     size_t count;
     while (true) {
-        // Attempt to drain as much of the input queue as possible
-        // before (potentially) blocking in Read.
-        InQueueDrainer();
-
         if ((status = Read(requests, &count) != ZX_OK)) {
             return status;
         }
@@ -493,15 +534,21 @@ zx_status_t BlockServer::Serve() {
 }
 
 BlockServer::BlockServer(zx_device_t* dev, block_protocol_t* bp) :
-    dev_(dev), bp_(*bp), block_op_size_(0), pending_count_(0),
-    barrier_in_progress_(false), last_id_(VMOID_INVALID + 1) {
+    dev_(dev), bp_(*bp), block_op_size_(0), drainer_shutdown_(false),
+    pending_count_(0), barrier_in_progress_(false), last_id_(VMOID_INVALID + 1) {
     size_t actual;
     device_ioctl(dev_, IOCTL_BLOCK_GET_INFO, nullptr, 0, &info_, sizeof(info_), &actual);
 }
 
 BlockServer::~BlockServer() {
     ZX_ASSERT(pending_count_.load() == 0);
-    ZX_ASSERT(in_queue_.is_empty());
+    fbl::AutoLock queue_lock(&queue_lock_);
+    ZX_ASSERT(sched_.is_empty());
+}
+
+void BlockServer::GetSchedStats(bool clear, block_sched_stats_t* out) {
+    fbl::AutoLock queue_lock(&queue_lock_);
+    sched_.GetStats(clear, out);
 }
 
 void BlockServer::ShutDown() {
@@ -534,3 +581,6 @@ zx_status_t blockserver_attach_vmo(BlockServer* bs, zx_handle_t raw_vmo, vmoid_t
     zx::vmo vmo(raw_vmo);
     return bs->AttachVmo(fbl::move(vmo), out);
 }
+void blockserver_get_sched_stats(BlockServer* bs, bool clear, block_sched_stats_t* out) {
+    bs->GetSchedStats(clear, out);
+}
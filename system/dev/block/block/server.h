@@ -7,6 +7,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <threads.h>
 
 #include <zircon/device/block.h>
 #include <ddk/protocol/block.h>
@@ -62,8 +63,14 @@ typedef struct block_msg block_msg_t;
 // C++ libraries while also using "block_op_t"s, which may require extra space.
 struct block_msg_extra {
     fbl::DoublyLinkedListNodeState<block_msg_t*> dll_node_state;
+    fbl::DoublyLinkedListNodeState<block_msg_t*> sched_node_state;
     fbl::RefPtr<IoBuffer> iobuf;
     BlockServer* server;
+    // Messages which the I/O scheduler merged into this one; they are
+    // completed alongside it, and are singly-linked through this field.
+    block_msg_t* merge_next;
+    // Time at which the message entered the scheduler.
+    zx_time_t sched_time;
     reqid_t reqid;
     groupid_t group;
 };
@@ -86,6 +93,17 @@ struct DoublyLinkedListTraits {
 
 using BlockMsgQueue = fbl::DoublyLinkedList<block_msg_t*, DoublyLinkedListTraits>;
 
+// The scheduler tracks each message on a second list (reads or writes),
+// in addition to the arrival-ordered queue above, so it needs a second
+// set of node storage.
+struct SchedulerListTraits {
+    static fbl::DoublyLinkedListNodeState<block_msg_t*>& node_state(block_msg_t& obj) {
+        return obj.extra.sched_node_state;
+    }
+};
+
+using SchedMsgList = fbl::DoublyLinkedList<block_msg_t*, SchedulerListTraits>;
+
 // C++ safe wrapper around block_msg_t.
 //
 // It's difficult to allocate a dynamic-length "block_op" as requested by the
@@ -141,6 +159,67 @@ private:
     block_msg_t* bop_;
 };
 
+// Orders queued block operations between the FIFO server and the
+// underlying driver. Reads are dispatched ahead of writes, with a
+// deadline (and a bound on consecutive reads) keeping writes from
+// starving; adjacent operations on the same VMO are merged into a single
+// driver request. Barriers and flushes are never reordered: they, and
+// everything queued before them, drain in arrival order.
+//
+// The scheduler hands operations out through a narrow Enqueue/Front/Pop
+// interface, so the policy can be swapped without touching the server's
+// intake or dispatch paths. It performs no locking of its own; the block
+// server guards it with its queue lock.
+class IoScheduler {
+public:
+    IoScheduler();
+
+    // Sets the upper bound (in blocks) for merged operations, typically
+    // the device's max transfer size. Zero means "unbounded".
+    void Initialize(uint32_t max_xfer_blocks);
+
+    // Adds |msg| to the scheduler, possibly merging it into an adjacent
+    // already-queued operation. Returns true if |msg| was absorbed by a
+    // merge, in which case ownership transfers to the surviving message.
+    bool Enqueue(block_msg_t* msg);
+
+    // Returns the operation which should be dispatched next, or nullptr
+    // if the scheduler is empty. Does not remove the operation.
+    block_msg_t* Front();
+
+    // Removes |msg| (previously returned by Front) from the scheduler.
+    void Pop(block_msg_t* msg);
+
+    bool is_empty() const { return arrival_.is_empty(); }
+
+    // Copies out the scheduling counters, optionally zeroing them.
+    void GetStats(bool clear, block_sched_stats_t* out);
+
+private:
+    DISALLOW_COPY_ASSIGN_AND_MOVE(IoScheduler);
+
+    // May |msg| be appended to |tail|, forming one driver request?
+    bool Mergeable(const block_msg_t* tail, const block_msg_t* msg) const;
+
+    // All queued operations, in arrival order.
+    BlockMsgQueue arrival_;
+    // Read and write operations, in arrival order within each class.
+    SchedMsgList reads_;
+    SchedMsgList writes_;
+
+    // Number of operations (counted from the front of |arrival_|) which
+    // must be dispatched in arrival order because a barrier or flush is
+    // among them.
+    size_t ordered_count_;
+    size_t count_;
+
+    // Consecutive reads dispatched while a write was waiting.
+    uint32_t read_streak_;
+
+    uint32_t max_xfer_blocks_;
+    block_sched_stats_t stats_;
+};
+
 class BlockServer {
 public:
     // Creates a new BlockServer.
@@ -148,7 +227,10 @@ public:
                               fzl::fifo<block_fifo_request_t, block_fifo_response_t>* fifo_out,
                               BlockServer** out);
 
-    // Starts the BlockServer using the current thread
+    // Starts the BlockServer using the current thread to read FIFO
+    // requests. A dedicated drainer thread submits queued operations to
+    // the underlying driver, so request intake and device submission
+    // proceed in parallel (with ordering preserved by the input queue).
     zx_status_t Serve() TA_EXCL(server_lock_);
     zx_status_t AttachVmo(zx::vmo vmo, vmoid_t* out) TA_EXCL(server_lock_);
 
@@ -166,6 +248,9 @@ public:
     // (If appropriate) tells the client that their operation is done.
     void TxnComplete(zx_status_t status, reqid_t reqid, groupid_t group);
 
+    // Copies out the I/O scheduler's counters, optionally zeroing them.
+    void GetSchedStats(bool clear, block_sched_stats_t* out) TA_EXCL(queue_lock_);
+
     void ShutDown();
     ~BlockServer();
 private:
@@ -175,21 +260,24 @@ private:
     // Helper for processing a single message read from the FIFO.
     void ProcessRequest(block_fifo_request_t* request);
 
-    // Helper for the server to react to a signal that a barrier
-    // operation has completed. Unsets the local "waiting for barrier"
-    // signal, and enqueues any further operations that might be
-    // pending.
-    void BarrierComplete();
-
-    // Functions that read from the fifo and invoke the queue drainer.
+    // Functions that read from the fifo.
     // Should not be invoked concurrently.
     zx_status_t Read(block_fifo_request_t* requests, size_t* count);
+
+    // Waits for the drainer thread to finish submitting and completing
+    // all queued operations, then joins it.
     void TerminateQueue();
 
-    // Attempts to enqueue all operations on the |in_queue_|. Stops
-    // when either the queue is empty, or a BARRIER_BEFORE is reached and
-    // operations are in-flight.
-    void InQueueDrainer();
+    // Body of the drainer thread: repeatedly drains |in_queue_| into the
+    // underlying driver until shut down.
+    int DrainerLoop();
+    static int DrainerThunk(void* arg);
+
+    // Attempts to submit all operations held by the scheduler to the
+    // driver. Stops when either the scheduler is empty, or a barrier is
+    // reached and operations are in-flight. Only called from the drainer
+    // thread.
+    void DrainQueue() TA_EXCL(queue_lock_);
 
     zx_status_t FindVmoIDLocked(vmoid_t* out) TA_REQ(server_lock_);
 
@@ -200,9 +288,20 @@ private:
     size_t block_op_size_;
 
     // BARRIER_AFTER is implemented by sticking "BARRIER_BEFORE" on the
-    // next operation that arrives.
+    // next operation that arrives. Only touched by the drainer thread.
     bool deferred_barrier_before_ = false;
-    BlockMsgQueue in_queue_;
+
+    // Incoming operations, pushed by the FIFO-reading thread and popped
+    // by the drainer thread in the scheduler's preferred order.
+    fbl::Mutex queue_lock_;
+    IoScheduler sched_ TA_GUARDED(queue_lock_);
+
+    // Wakes the drainer when work is queued, a barrier's operations have
+    // all completed, or shutdown has been requested.
+    sync_completion_t queue_signal_;
+    thrd_t drainer_;
+    fbl::atomic<bool> drainer_shutdown_;
+
     fbl::atomic<size_t> pending_count_;
     fbl::atomic<bool> barrier_in_progress_;
     TransactionGroup groups_[MAX_TXN_GROUP_COUNT];
@@ -237,4 +336,7 @@ zx_status_t blockserver_serve(BlockServer* bs);
 // Attach an IO buffer to the Block Server
 zx_status_t blockserver_attach_vmo(BlockServer* bs, zx_handle_t vmo, vmoid_t* out);
 
+// Copy out the I/O scheduler's counters, optionally zeroing them.
+void blockserver_get_sched_stats(BlockServer* bs, bool clear, block_sched_stats_t* out);
+
 __END_CDECLS
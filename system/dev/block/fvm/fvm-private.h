@@ -20,6 +20,7 @@
 #include <ddktl/protocol/block.h>
 #include <lib/fzl/mapped-vmo.h>
 #include <fbl/algorithm.h>
+#include <fbl/array.h>
 #include <fbl/intrusive_wavl_tree.h>
 #include <fbl/mutex.h>
 #include <fbl/unique_ptr.h>
@@ -222,6 +223,10 @@ public:
 
     // Given a virtual slice, return the physical slice allocated
     // to it. If no slice is allocated, return PSLICE_UNALLOCATED.
+    //
+    // Served by a flat translation array for vslices below the cache
+    // limit (a single index on the I/O path); falls back to walking
+    // the extent map above it.
     uint32_t SliceGetLocked(size_t vslice) const TA_REQ(lock_);
 
     // Check slices starting from |vslice_start|.
@@ -267,6 +272,12 @@ private:
 
     zx_device_t* GetParent() const { return mgr_->parent(); }
 
+    // Record the vslice -> pslice mapping in the flat translation array,
+    // growing it if necessary. The array is best-effort: if an allocation
+    // fails or |vslice| is beyond the cache limit, the mapping is simply
+    // not cached and lookups fall back to the extent map.
+    void SliceCacheUpdateLocked(size_t vslice, uint32_t pslice) TA_REQ(lock_);
+
     VPartitionManager* mgr_;
     size_t entry_index_;
 
@@ -275,6 +286,14 @@ private:
     // indicates that the vpartition is completely unmapped, and uses no
     // physical slices.
     fbl::WAVLTree<size_t, fbl::unique_ptr<SliceExtent>> slice_map_ TA_GUARDED(lock_);
+    // Flat copy of slice_map_ for vslices below the cache limit, allowing
+    // O(1) translation on the I/O path. Entries are PSLICE_UNALLOCATED
+    // where no slice is mapped.
+    fbl::Array<uint32_t> slice_cache_ TA_GUARDED(lock_);
+    // Translation counters, reported by IOCTL_BLOCK_FVM_TRANSLATION_STATS.
+    // Mutable so the (logically const) lookup path can update them.
+    mutable uint64_t stat_lookups_ TA_GUARDED(lock_) = 0;
+    mutable uint64_t stat_fast_lookups_ TA_GUARDED(lock_) = 0;
     block_info_t info_ TA_GUARDED(lock_);
 };
 
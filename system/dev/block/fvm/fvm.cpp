@@ -697,8 +697,21 @@ zx_status_t VPartition::Create(VPartitionManager* vpm, size_t entry_index,
     return ZX_OK;
 }
 
+// Largest vslice recorded in the flat translation array; lookups above
+// this limit fall back to the extent map. The full vslice address space
+// (VSLICE_MAX) is far too large to represent flatly, but partitions
+// allocate their slices at low vslice addresses in practice. At four
+// bytes per entry this caps the array at 4MiB per partition, and it is
+// only grown as far as the largest vslice actually allocated.
+constexpr size_t kSliceCacheMax = (1 << 20);
+
 uint32_t VPartition::SliceGetLocked(size_t vslice) const {
     ZX_DEBUG_ASSERT(vslice < mgr_->VSliceMax());
+    stat_lookups_++;
+    if (vslice < slice_cache_.size()) {
+        stat_fast_lookups_++;
+        return slice_cache_[vslice];
+    }
     auto extent = --slice_map_.upper_bound(vslice);
     if (!extent.IsValid()) {
         return PSLICE_UNALLOCATED;
@@ -707,6 +720,30 @@ uint32_t VPartition::SliceGetLocked(size_t vslice) const {
     return extent->get(vslice);
 }
 
+void VPartition::SliceCacheUpdateLocked(size_t vslice, uint32_t pslice) {
+    if (vslice >= slice_cache_.size()) {
+        if (pslice == PSLICE_UNALLOCATED) {
+            // Nothing to clear; uncached entries already read as unallocated.
+            return;
+        }
+        if (vslice >= kSliceCacheMax) {
+            return;
+        }
+        size_t size = fbl::max(slice_cache_.size() * 2, vslice + 1);
+        size = fbl::min(size, kSliceCacheMax);
+        fbl::AllocChecker ac;
+        uint32_t* entries = new (&ac) uint32_t[size];
+        if (!ac.check()) {
+            return;
+        }
+        memset(entries, 0, size * sizeof(uint32_t));
+        static_assert(PSLICE_UNALLOCATED == 0, "Cannot zero-fill translation array");
+        memcpy(entries, slice_cache_.get(), slice_cache_.size() * sizeof(uint32_t));
+        slice_cache_.reset(entries, size);
+    }
+    slice_cache_[vslice] = pslice;
+}
+
 zx_status_t VPartition::CheckSlices(size_t vslice_start, size_t* count, bool* allocated) {
     fbl::AutoLock lock(&lock_);
 
@@ -768,6 +805,7 @@ zx_status_t VPartition::SliceSetLocked(size_t vslice, uint32_t pslice) {
         extent = --slice_map_.upper_bound(vslice);
     }
 
+    SliceCacheUpdateLocked(vslice, pslice);
     ZX_DEBUG_ASSERT(SliceGetLocked(vslice) == pslice);
     AddBlocksLocked((mgr_->SliceSize() / info_.block_size));
 
@@ -801,6 +839,7 @@ bool VPartition::SliceFreeLocked(size_t vslice) {
         slice_map_.erase(*extent);
     }
 
+    SliceCacheUpdateLocked(vslice, PSLICE_UNALLOCATED);
     AddBlocksLocked(-(mgr_->SliceSize() / info_.block_size));
     return true;
 }
@@ -810,6 +849,9 @@ void VPartition::ExtentDestroyLocked(size_t vslice) TA_REQ(lock_) {
     ZX_DEBUG_ASSERT(SliceCanFree(vslice));
     auto extent = --slice_map_.upper_bound(vslice);
     size_t length = extent->size();
+    for (size_t vs = extent->start(); vs < extent->end(); vs++) {
+        SliceCacheUpdateLocked(vs, PSLICE_UNALLOCATED);
+    }
     slice_map_.erase(*extent);
     AddBlocksLocked(-((length * mgr_->SliceSize()) / info_.block_size));
 }
@@ -915,6 +957,24 @@ zx_status_t VPartition::DdkIoctl(uint32_t op, const void* cmd, size_t cmdlen,
         *out_actual = strlen(name);
         return ZX_OK;
     }
+    case IOCTL_BLOCK_FVM_TRANSLATION_STATS: {
+        if (cmdlen != sizeof(bool)) {
+            return ZX_ERR_INVALID_ARGS;
+        }
+        fvm_translation_stats_t* stats = static_cast<fvm_translation_stats_t*>(reply);
+        if (max < sizeof(*stats)) {
+            return ZX_ERR_BUFFER_TOO_SMALL;
+        }
+        fbl::AutoLock lock(&lock_);
+        stats->lookups = stat_lookups_;
+        stats->fast_lookups = stat_fast_lookups_;
+        if (*static_cast<const bool*>(cmd)) {
+            stat_lookups_ = 0;
+            stat_fast_lookups_ = 0;
+        }
+        *out_actual = sizeof(*stats);
+        return ZX_OK;
+    }
     case IOCTL_DEVICE_SYNC: {
         // Propagate sync to parent device
         return device_ioctl(GetParent(), IOCTL_DEVICE_SYNC, nullptr, 0, nullptr, 0, nullptr);
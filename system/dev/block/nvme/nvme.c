@@ -71,32 +71,54 @@ static_assert(PAGE_SIZE == (1ULL << PAGE_SHIFT), "");
 #define SQMAX (PAGE_SIZE / sizeof(nvme_cmd_t))
 #define CQMAX (PAGE_SIZE / sizeof(nvme_cpl_t))
 
+// Maximum number of IO submission/completion queue pairs.  The actual
+// count is bounded by the CPU count, the interrupt vectors we obtain,
+// and what the controller grants us.
+#define IO_QUEUE_COUNT 4
+
 // global driver state bits
-#define FLAG_IRQ_THREAD_STARTED  0x0001
 #define FLAG_IO_THREAD_STARTED   0x0002
 #define FLAG_SHUTDOWN            0x0004
 
 #define FLAG_HAS_VWC             0x0100
 
+typedef struct nvme_device nvme_device_t;
+
+// Per interrupt vector state.  Completion queues are distributed across
+// the vectors so separate queues can interrupt separate CPUs.
 typedef struct {
+    nvme_device_t* nvme;
+    zx_handle_t h;
+    thrd_t thread;
+} nvme_irq_t;
+
+// Per IO queue pair state.  After initialization these are only touched
+// by the io thread, which submits commands and reaps completions from
+// every pair without locks.
+typedef struct {
+    // io queue doorbell registers
+    void* sq_tail_db;
+    void* cq_head_db;
+
+    nvme_cpl_t* cq;
+    nvme_cmd_t* sq;
+    uint16_t cq_head;
+    uint16_t cq_toggle;
+    uint16_t sq_tail;
+    uint16_t sq_head;
+} nvme_ioq_t;
+
+struct nvme_device {
     void* io;
     zx_handle_t ioh;
-    zx_handle_t irqh;
     zx_handle_t bti;
     uint32_t flags;
     mtx_t lock;
 
-    // io queue doorbell registers
-    void* io_sq_tail_db;
-    void* io_cq_head_db;
-
-    nvme_cpl_t* io_cq;
-    nvme_cmd_t* io_sq;
-    uint32_t io_nsid;
-    uint16_t io_cq_head;
-    uint16_t io_cq_toggle;
-    uint16_t io_sq_tail;
-    uint16_t io_sq_head;
+    // io queue pairs, commands striped across them round-robin
+    nvme_ioq_t ioq[IO_QUEUE_COUNT];
+    uint32_t ioq_count;
+    uint32_t ioq_rr;       // next queue pair to submit to
 
     uint64_t utxn_avail;   // bitmask of available utxns
 
@@ -145,7 +167,9 @@ typedef struct {
     // source of physical pages for queues and admin commands
     io_buffer_t iob;
 
-    thrd_t irqthread;
+    nvme_irq_t irq[IO_QUEUE_COUNT];
+    uint32_t irq_count;
+    uint32_t irq_thread_count;
     thrd_t iothread;
 
 #if WITH_STATS
@@ -159,7 +183,7 @@ typedef struct {
 
     // pool of utxns
     nvme_utxn_t utxn[UTXN_COUNT];
-} nvme_device_t;
+};
 
 #if WITH_STATS
 #define STAT_INC(name) do { nvme->stat_##name++; } while (0)
@@ -245,57 +269,61 @@ static zx_status_t nvme_admin_sq_put(nvme_device_t* nvme, nvme_cmd_t* cmd) {
     return ZX_OK;
 }
 
-static zx_status_t nvme_io_cq_get(nvme_device_t* nvme, nvme_cpl_t* cpl) {
-    if ((readw(&nvme->io_cq[nvme->io_cq_head].status) & 1) != nvme->io_cq_toggle) {
+static zx_status_t nvme_io_cq_get(nvme_ioq_t* ioq, nvme_cpl_t* cpl) {
+    if ((readw(&ioq->cq[ioq->cq_head].status) & 1) != ioq->cq_toggle) {
         return ZX_ERR_SHOULD_WAIT;
     }
-    *cpl = nvme->io_cq[nvme->io_cq_head];
+    *cpl = ioq->cq[ioq->cq_head];
 
     // advance the head pointer, wrapping and inverting toggle at max
-    uint16_t next = (nvme->io_cq_head + 1) & (CQMAX - 1);
-    if ((nvme->io_cq_head = next) == 0) {
-        nvme->io_cq_toggle ^= 1;
+    uint16_t next = (ioq->cq_head + 1) & (CQMAX - 1);
+    if ((ioq->cq_head = next) == 0) {
+        ioq->cq_toggle ^= 1;
     }
 
     // note the new sq head reported by hw
-    nvme->io_sq_head = cpl->sq_head;
+    ioq->sq_head = cpl->sq_head;
     return ZX_OK;
 }
 
-static void nvme_io_cq_ack(nvme_device_t* nvme) {
+static void nvme_io_cq_ack(nvme_ioq_t* ioq) {
     // ring the doorbell
-    writel(nvme->io_cq_head, nvme->io_cq_head_db);
+    writel(ioq->cq_head, ioq->cq_head_db);
 }
 
-static zx_status_t nvme_io_sq_put(nvme_device_t* nvme, nvme_cmd_t* cmd) {
-    uint16_t next = (nvme->io_sq_tail + 1) & (SQMAX - 1);
+static zx_status_t nvme_io_sq_put(nvme_ioq_t* ioq, nvme_cmd_t* cmd) {
+    uint16_t next = (ioq->sq_tail + 1) & (SQMAX - 1);
 
     // if head+1 == tail: queue is full
-    if (next == nvme->io_sq_head) {
+    if (next == ioq->sq_head) {
         return ZX_ERR_SHOULD_WAIT;
     }
 
-    nvme->io_sq[nvme->io_sq_tail] = *cmd;
-    nvme->io_sq_tail = next;
+    ioq->sq[ioq->sq_tail] = *cmd;
+    ioq->sq_tail = next;
 
     // ring the doorbell
-    writel(next, nvme->io_sq_tail_db);
+    writel(next, ioq->sq_tail_db);
     return ZX_OK;
 }
 
 static int irq_thread(void* arg) {
-    nvme_device_t* nvme = arg;
+    nvme_irq_t* irq = arg;
+    nvme_device_t* nvme = irq->nvme;
     for (;;) {
         zx_status_t r;
-        if ((r = zx_interrupt_wait(nvme->irqh, NULL)) != ZX_OK) {
+        if ((r = zx_interrupt_wait(irq->h, NULL)) != ZX_OK) {
             zxlogf(ERROR, "nvme: irq wait failed: %d\n", r);
             break;
         }
 
-        nvme_cpl_t cpl;
-        if (nvme_admin_cq_get(nvme, &cpl) == ZX_OK) {
-            nvme->admin_result = cpl;
-            sync_completion_signal(&nvme->admin_signal);
+        // admin completions are only steered at vector zero
+        if (irq == nvme->irq) {
+            nvme_cpl_t cpl;
+            if (nvme_admin_cq_get(nvme, &cpl) == ZX_OK) {
+                nvme->admin_result = cpl;
+                sync_completion_signal(&nvme->admin_signal);
+            }
         }
 
         sync_completion_signal(&nvme->io_signal);
@@ -371,8 +399,14 @@ static bool io_process_txn(nvme_device_t* nvme, nvme_txn_t* txn) {
 
         pages = utxn->virt;
 
-        if ((r = zx_bti_pin(nvme->bti, opt, vmo, pageoffset, pagecount << PAGE_SHIFT,
-                            pages, pagecount, &utxn->pmt)) != ZX_OK) {
+        if (txn->op.rw.pages != NULL) {
+            // The caller pinned the vmo and provided its physical pages.
+            // Copy this chunk's span into the utxn's scatter list page --
+            // the controller reads PRP lists from dma-visible memory.
+            memcpy(pages, txn->op.rw.pages, pagecount * sizeof(zx_paddr_t));
+            utxn->pmt = ZX_HANDLE_INVALID;
+        } else if ((r = zx_bti_pin(nvme->bti, opt, vmo, pageoffset, pagecount << PAGE_SHIFT,
+                                   pages, pagecount, &utxn->pmt)) != ZX_OK) {
             zxlogf(ERROR, "nvme: could not pin pages: %d\n", r);
             break;
         }
@@ -400,16 +434,24 @@ static bool io_process_txn(nvme_device_t* nvme, nvme_txn_t* txn) {
         zxlogf(SPEW, "nvme: pages[] = { %016zx, %016zx, %016zx, %016zx, ... }\n",
                pages[0], pages[1], pages[2], pages[3]);
 
-        if ((r = nvme_io_sq_put(nvme, &cmd)) != ZX_OK) {
+        // Stripe commands across the IO queue pairs round-robin; with one
+        // pair per interrupt vector, completions spread across CPUs too.
+        nvme_ioq_t* ioq = nvme->ioq + nvme->ioq_rr;
+        if ((r = nvme_io_sq_put(ioq, &cmd)) != ZX_OK) {
             zxlogf(ERROR, "nvme: could not submit cmd (txn=%p id=%u)\n", txn, utxn->id);
             break;
         }
+        nvme->ioq_rr = (nvme->ioq_rr + 1) % nvme->ioq_count;
 
         utxn->txn = txn;
 
         // keep track of where we are
         txn->op.rw.offset_dev += blocks;
         txn->op.rw.offset_vmo += bytes;
+        if (txn->op.rw.pages != NULL) {
+            // keep pages pointed at the page containing offset_vmo
+            txn->op.rw.pages += (byteoffset + bytes) >> PAGE_SHIFT;
+        }
         txn->op.rw.length -= blocks;
         txn->pending_utxns++;
 
@@ -425,7 +467,8 @@ static bool io_process_txn(nvme_device_t* nvme, nvme_txn_t* txn) {
     }
 
     // failure
-    if ((r = zx_pmt_unpin(utxn->pmt)) != ZX_OK) {
+    if ((utxn->pmt != ZX_HANDLE_INVALID) &&
+        ((r = zx_pmt_unpin(utxn->pmt)) != ZX_OK)) {
         zxlogf(ERROR, "nvme: cannot unpin io buffer: %d\n", r);
     }
     utxn_put(nvme, utxn);
@@ -472,11 +515,11 @@ static void io_process_txns(nvme_device_t* nvme) {
     }
 }
 
-static void io_process_cpls(nvme_device_t* nvme) {
+static void io_process_cpls_one(nvme_device_t* nvme, nvme_ioq_t* ioq) {
     bool ring_doorbell = false;
     nvme_cpl_t cpl;
 
-    while (nvme_io_cq_get(nvme, &cpl) == ZX_OK) {
+    while (nvme_io_cq_get(ioq, &cpl) == ZX_OK) {
         ring_doorbell = true;
 
         if (cpl.cmd_id >= UTXN_COUNT) {
@@ -504,11 +547,13 @@ static void io_process_cpls(nvme_device_t* nvme) {
         }
 
         zx_status_t r;
-        if ((r = zx_pmt_unpin(utxn->pmt)) != ZX_OK) {
+        if ((utxn->pmt != ZX_HANDLE_INVALID) &&
+            ((r = zx_pmt_unpin(utxn->pmt)) != ZX_OK)) {
             zxlogf(ERROR, "nvme: cannot unpin io buffer: %d\n", r);
         }
 
         // release the microtransaction
+        utxn->pmt = ZX_HANDLE_INVALID;
         utxn->txn = NULL;
         utxn_put(nvme, utxn);
 
@@ -524,7 +569,13 @@ static void io_process_cpls(nvme_device_t* nvme) {
     }
 
     if (ring_doorbell) {
-        nvme_io_cq_ack(nvme);
+        nvme_io_cq_ack(ioq);
+    }
+}
+
+static void io_process_cpls(nvme_device_t* nvme) {
+    for (uint32_t n = 0; n < nvme->ioq_count; n++) {
+        io_process_cpls_one(nvme, nvme->ioq + n);
     }
 }
 
@@ -684,10 +735,12 @@ static void nvme_release(void* ctx) {
         zx_handle_close(nvme->ioh);
         // TODO: risks a handle use-after-close, will be resolved by IRQ api
         // changes coming soon
-        zx_handle_close(nvme->irqh);
+        for (uint32_t i = 0; i < nvme->irq_count; i++) {
+            zx_handle_close(nvme->irq[i].h);
+        }
     }
-    if (nvme->flags & FLAG_IRQ_THREAD_STARTED) {
-        thrd_join(nvme->irqthread, &r);
+    for (uint32_t i = 0; i < nvme->irq_thread_count; i++) {
+        thrd_join(nvme->irq[i].thread, &r);
     }
     if (nvme->flags & FLAG_IO_THREAD_STARTED) {
         sync_completion_signal(&nvme->io_signal);
@@ -754,10 +807,11 @@ static void infostring(const char* prefix, uint8_t* str, size_t len) {
 // dedicated pages from the page pool
 #define IDX_ADMIN_SQ   0
 #define IDX_ADMIN_CQ   1
-#define IDX_IO_SQ      2
-#define IDX_IO_CQ      3
-#define IDX_SCRATCH    4
-#define IDX_UTXN_POOL  5 // this must always be last
+#define IDX_SCRATCH    2
+#define IDX_IO_QUEUES  3 // two pages (sq then cq) per io queue pair
+#define IDX_IO_SQ(n)   (IDX_IO_QUEUES + 2 * (n))
+#define IDX_IO_CQ(n)   (IDX_IO_QUEUES + 2 * (n) + 1)
+#define IDX_UTXN_POOL  (IDX_IO_QUEUES + 2 * IO_QUEUE_COUNT) // this must always be last
 
 #define IO_PAGE_COUNT  (IDX_UTXN_POOL + UTXN_COUNT)
 
@@ -860,26 +914,18 @@ static zx_status_t nvme_init(nvme_device_t* nvme) {
     nvme->admin_cq_head = 0;
     nvme->admin_cq_toggle = 1;
 
-    // registers and buffers for IO queues
-    nvme->io_sq_tail_db = nvme->io + NVME_REG_SQnTDBL(1, cap);
-    nvme->io_cq_head_db = nvme->io + NVME_REG_CQnHDBL(1, cap);
-
-    nvme->io_sq = nvme->iob.virt + PAGE_SIZE * IDX_IO_SQ;
-    nvme->io_sq_head = 0;
-    nvme->io_sq_tail = 0;
-
-    nvme->io_cq = nvme->iob.virt + PAGE_SIZE * IDX_IO_CQ;
-    nvme->io_cq_head = 0;
-    nvme->io_cq_toggle = 1;
-
     // scratch page for admin ops
     void* scratch = nvme->iob.virt + PAGE_SIZE * IDX_SCRATCH;
 
-    if (thrd_create_with_name(&nvme->irqthread, irq_thread, nvme, "nvme-irq-thread")) {
-        zxlogf(ERROR, "nvme; cannot create irq thread\n");
-        return ZX_ERR_INTERNAL;
+    for (uint32_t i = 0; i < nvme->irq_count; i++) {
+        nvme->irq[i].nvme = nvme;
+        if (thrd_create_with_name(&nvme->irq[i].thread, irq_thread, nvme->irq + i,
+                                  "nvme-irq-thread")) {
+            zxlogf(ERROR, "nvme; cannot create irq thread\n");
+            return ZX_ERR_INTERNAL;
+        }
+        nvme->irq_thread_count++;
     }
-    nvme->flags |= FLAG_IRQ_THREAD_STARTED;
 
     if (thrd_create_with_name(&nvme->iothread, io_thread, nvme, "nvme-io-thread")) {
         zxlogf(ERROR, "nvme; cannot create io thread\n");
@@ -963,41 +1009,82 @@ static zx_status_t nvme_init(nvme_device_t* nvme) {
     FEATURE(ONCS, WRITE_UNCORRECTABLE);
     FEATURE(ONCS, COMPARE);
 
-    // set feature (number of queues) to 1 iosq and 1 iocq
+    // One IO queue pair per CPU, bounded by our pool and by the number
+    // of interrupt vectors we managed to configure.
+    uint32_t wanted = zx_system_get_num_cpus();
+    if (wanted > IO_QUEUE_COUNT) {
+        wanted = IO_QUEUE_COUNT;
+    }
+    if (wanted > nvme->irq_count) {
+        wanted = nvme->irq_count;
+    }
+    if (wanted < 1) {
+        wanted = 1;
+    }
+
+    // set feature (number of queues); the fields are zero-based
     memset(&cmd, 0, sizeof(cmd));
     cmd.cmd = NVME_CMD_CID(0) | NVME_CMD_PRP | NVME_CMD_NORMAL | NVME_CMD_OPC(NVME_ADMIN_OP_SET_FEATURE);
     cmd.u.raw[0] = NVME_FEATURE_NUMBER_OF_QUEUES;
-    cmd.u.raw[1] = 0;
+    cmd.u.raw[1] = ((wanted - 1) << 16) | (wanted - 1);
 
     nvme_cpl_t cpl;
     if (nvme_admin_txn(nvme, &cmd, &cpl) != ZX_OK) {
         zxlogf(ERROR, "nvme: set feature (number queues) op failed\n");
         return ZX_ERR_INTERNAL;
     }
-    zxlogf(INFO,"cpl.cmd %08x\n", cpl.cmd);
-
-    // create the IO completion queue
-    memset(&cmd, 0, sizeof(cmd));
-    cmd.cmd = NVME_CMD_CID(0) | NVME_CMD_PRP | NVME_CMD_NORMAL | NVME_CMD_OPC(NVME_ADMIN_OP_CREATE_IOCQ);
-    cmd.dptr.prp[0] = nvme->iob.phys_list[IDX_IO_CQ];
-    cmd.u.raw[0] = ((CQMAX - 1) << 16) | 1; // queue size, queue id
-    cmd.u.raw[1] = (0 << 16) | 2 | 1; // irq vector, irq enable, phys contig
 
-    if (nvme_admin_txn(nvme, &cmd, NULL) != ZX_OK) {
-        zxlogf(ERROR, "nvme: completion queue creation op failed\n");
-        return ZX_ERR_INTERNAL;
+    // the controller reports back how many queues it granted us
+    uint32_t nsq = (cpl.cmd & 0xFFFF) + 1;
+    uint32_t ncq = ((cpl.cmd >> 16) & 0xFFFF) + 1;
+    nvme->ioq_count = wanted;
+    if (nvme->ioq_count > nsq) {
+        nvme->ioq_count = nsq;
+    }
+    if (nvme->ioq_count > ncq) {
+        nvme->ioq_count = ncq;
     }
+    zxlogf(INFO, "nvme: io queue pairs: %u (hw grants %u sq / %u cq)\n",
+           nvme->ioq_count, nsq, ncq);
 
-    // create the IO submit queue
-    memset(&cmd, 0, sizeof(cmd));
-    cmd.cmd = NVME_CMD_CID(0) | NVME_CMD_PRP | NVME_CMD_NORMAL | NVME_CMD_OPC(NVME_ADMIN_OP_CREATE_IOSQ);
-    cmd.dptr.prp[0] = nvme->iob.phys_list[IDX_IO_SQ];
-    cmd.u.raw[0] = ((SQMAX - 1) << 16) | 1; // queue size, queue id
-    cmd.u.raw[1] = (1 << 16) | 0 | 1; // cqid, qprio, phys contig
+    for (uint32_t n = 0; n < nvme->ioq_count; n++) {
+        nvme_ioq_t* ioq = nvme->ioq + n;
 
-    if (nvme_admin_txn(nvme, &cmd, NULL) != ZX_OK) {
-        zxlogf(ERROR, "nvme: submit queue creation op failed\n");
-        return ZX_ERR_INTERNAL;
+        // registers and buffers for IO queue pair (n + 1)
+        ioq->sq_tail_db = nvme->io + NVME_REG_SQnTDBL(n + 1, cap);
+        ioq->cq_head_db = nvme->io + NVME_REG_CQnHDBL(n + 1, cap);
+
+        ioq->sq = nvme->iob.virt + PAGE_SIZE * IDX_IO_SQ(n);
+        ioq->sq_head = 0;
+        ioq->sq_tail = 0;
+
+        ioq->cq = nvme->iob.virt + PAGE_SIZE * IDX_IO_CQ(n);
+        ioq->cq_head = 0;
+        ioq->cq_toggle = 1;
+
+        // create the IO completion queue, steered at its own irq vector
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.cmd = NVME_CMD_CID(0) | NVME_CMD_PRP | NVME_CMD_NORMAL | NVME_CMD_OPC(NVME_ADMIN_OP_CREATE_IOCQ);
+        cmd.dptr.prp[0] = nvme->iob.phys_list[IDX_IO_CQ(n)];
+        cmd.u.raw[0] = ((CQMAX - 1) << 16) | (n + 1); // queue size, queue id
+        cmd.u.raw[1] = ((n % nvme->irq_count) << 16) | 2 | 1; // irq vector, irq enable, phys contig
+
+        if (nvme_admin_txn(nvme, &cmd, NULL) != ZX_OK) {
+            zxlogf(ERROR, "nvme: completion queue creation op failed\n");
+            return ZX_ERR_INTERNAL;
+        }
+
+        // create the IO submit queue
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.cmd = NVME_CMD_CID(0) | NVME_CMD_PRP | NVME_CMD_NORMAL | NVME_CMD_OPC(NVME_ADMIN_OP_CREATE_IOSQ);
+        cmd.dptr.prp[0] = nvme->iob.phys_list[IDX_IO_SQ(n)];
+        cmd.u.raw[0] = ((SQMAX - 1) << 16) | (n + 1); // queue size, queue id
+        cmd.u.raw[1] = ((n + 1) << 16) | 0 | 1; // cqid, qprio, phys contig
+
+        if (nvme_admin_txn(nvme, &cmd, NULL) != ZX_OK) {
+            zxlogf(ERROR, "nvme: submit queue creation op failed\n");
+            return ZX_ERR_INTERNAL;
+        }
     }
 
     // identify namespace 1
@@ -1101,19 +1188,35 @@ static zx_status_t nvme_bind(void* ctx, zx_device_t* dev) {
     };
     uint32_t nirq = 0;
     for (unsigned n = 0; n < countof(modes); n++) {
-        if ((pci_query_irq_mode(&nvme->pci, modes[n], &nirq) == ZX_OK) &&
-            (pci_set_irq_mode(&nvme->pci, modes[n], 1) == ZX_OK)) {
-            zxlogf(INFO, "nvme: irq mode %u, irq count %u (#%u)\n", modes[n], nirq, n);
-            goto irq_configured;
+        if (pci_query_irq_mode(&nvme->pci, modes[n], &nirq) != ZX_OK) {
+            continue;
+        }
+        // Ask for one vector per IO queue pair where the mode allows it,
+        // so completion interrupts are spread across vectors (and CPUs).
+        // MSI only supports power-of-two vector counts, so back off by
+        // halving on failure.
+        uint32_t want = (modes[n] == ZX_PCIE_IRQ_MODE_LEGACY) ? 1 : IO_QUEUE_COUNT;
+        if (want > nirq) {
+            want = nirq;
+        }
+        while (want > 0) {
+            if (pci_set_irq_mode(&nvme->pci, modes[n], want) == ZX_OK) {
+                zxlogf(INFO, "nvme: irq mode %u, irq count %u (#%u)\n", modes[n], want, n);
+                nvme->irq_count = want;
+                goto irq_configured;
+            }
+            want >>= 1;
         }
     }
     zxlogf(ERROR, "nvme: could not configure irqs\n");
     goto fail;
 
 irq_configured:
-    if (pci_map_interrupt(&nvme->pci, 0, &nvme->irqh) != ZX_OK) {
-        zxlogf(ERROR, "nvme: could not map irq\n");
-        goto fail;
+    for (uint32_t i = 0; i < nvme->irq_count; i++) {
+        if (pci_map_interrupt(&nvme->pci, i, &nvme->irq[i].h) != ZX_OK) {
+            zxlogf(ERROR, "nvme: could not map irq\n");
+            goto fail;
+        }
     }
     if (pci_enable_bus_master(&nvme->pci, true)) {
         zxlogf(ERROR, "nvme: cannot enable bus mastering\n");
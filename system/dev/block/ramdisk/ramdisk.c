@@ -267,6 +267,23 @@ static zx_status_t ramdisk_ioctl(void* ctx, uint32_t op, const void* cmd, size_t
         mtx_unlock(&ramdev->lock);
         return ZX_OK;
     }
+    case IOCTL_RAMDISK_GET_VMO: {
+        if (max < sizeof(zx_handle_t)) {
+            return ZX_ERR_INVALID_ARGS;
+        }
+        // Share the backing VMO so the caller can map the disk contents
+        // directly, bypassing the block FIFO copy. Withhold the rights needed
+        // to resize the VMO out from under us.
+        zx_handle_t vmo;
+        zx_status_t status = zx_handle_duplicate(
+            ramdev->vmo, ZX_RIGHTS_BASIC | ZX_RIGHTS_IO | ZX_RIGHT_MAP, &vmo);
+        if (status != ZX_OK) {
+            return status;
+        }
+        memcpy(reply, &vmo, sizeof(vmo));
+        *out_actual = sizeof(vmo);
+        return ZX_OK;
+    }
     case IOCTL_RAMDISK_GET_BLK_COUNTS: {
         if (max < sizeof(ramdisk_blk_counts_t)) {
             return ZX_ERR_INVALID_ARGS;
@@ -64,6 +64,26 @@ typedef struct sdhci_adma64_desc {
 
 static_assert(sizeof(sdhci_adma64_desc_t) == 12, "unexpected ADMA2 descriptor size");
 
+typedef struct sdhci_adma32_desc {
+    union {
+        struct {
+            uint8_t valid : 1;
+            uint8_t end   : 1;
+            uint8_t intr  : 1;
+            uint8_t rsvd0 : 1;
+            uint8_t act1  : 1;
+            uint8_t act2  : 1;
+            uint8_t rsvd1 : 2;
+            uint8_t rsvd2;
+        } __PACKED;
+        uint16_t attr;
+    } __PACKED;
+    uint16_t length;
+    uint32_t address;
+} __PACKED sdhci_adma32_desc_t;
+
+static_assert(sizeof(sdhci_adma32_desc_t) == 8, "unexpected 32-bit ADMA2 descriptor size");
+
 // 64k max per descriptor
 #define ADMA2_DESC_MAX_LENGTH   0x10000 // 64k
 // for 2M max transfer size for fully discontiguous
@@ -82,9 +102,15 @@ typedef struct sdhci_device {
 
     zx_handle_t bti_handle;
 
-    // DMA descriptors
+    // DMA descriptors, in the format selected by dma64 below
     io_buffer_t iobuf;
-    sdhci_adma64_desc_t* descs;
+    union {
+        void* virt;
+        sdhci_adma64_desc_t* adma64;
+        sdhci_adma32_desc_t* adma32;
+    } descs;
+    // True if the controller takes 96-bit (64-bit address) descriptors
+    bool dma64;
 
     // Held when a command or action is in progress.
     mtx_t mtx;
@@ -144,9 +170,8 @@ static bool sdmmc_cmd_has_data(uint32_t cmd_flags) {
     return cmd_flags & SDMMC_RESP_DATA_PRESENT;
 }
 
-static bool sdhci_supports_adma2_64bit(sdhci_device_t* dev) {
+static bool sdhci_supports_adma2(sdhci_device_t* dev) {
     return (dev->info.caps & SDMMC_HOST_CAP_ADMA2) &&
-           (dev->info.caps & SDMMC_HOST_CAP_64BIT) &&
            !(dev->quirks & SDHCI_QUIRK_NO_DMA);
 }
 
@@ -425,6 +450,9 @@ static zx_status_t sdhci_build_dma_desc(sdhci_device_t* dev, sdmmc_req_t* req) {
         zxlogf(ERROR, "sdhci: error %d bti_pin\n", st);
         return st;
     }
+    // Cache this for zx_pmt_unpin() later. Stored before any other failure
+    // is possible, so that sdhci_finish_req always unpins the pages.
+    req->pmt = pmt;
     if (req->cmd_flags & SDMMC_CMD_READ) {
         st = zx_vmo_op_range(req->dma_vmo, ZX_VMO_OP_CACHE_CLEAN_INVALIDATE,
                              req->buf_offset, req_len, NULL, 0);
@@ -436,8 +464,6 @@ static zx_status_t sdhci_build_dma_desc(sdhci_device_t* dev, sdmmc_req_t* req) {
         zxlogf(ERROR, "sdhci: cache clean failed with error  %d\n", st);
         return st;
     }
-    // cache this for zx_pmt_unpin() later
-    req->pmt = pmt;
 
     phys_iter_buffer_t buf = {
         .phys = phys,
@@ -451,40 +477,63 @@ static zx_status_t sdhci_build_dma_desc(sdhci_device_t* dev, sdmmc_req_t* req) {
     int count = 0;
     size_t length;
     zx_paddr_t paddr;
-    sdhci_adma64_desc_t* desc = dev->descs;
     for (;;) {
         length = phys_iter_next(&iter, &paddr);
         if (length == 0) {
-            if (desc != dev->descs) {
-                desc -= 1;
-                desc->end = 1; // set end bit on the last descriptor
+            if (count > 0) {
                 break;
-            } else {
-                zxlogf(TRACE, "sdhci: empty descriptor list!\n");
-                return ZX_ERR_NOT_SUPPORTED;
             }
+            zxlogf(TRACE, "sdhci: empty descriptor list!\n");
+            return ZX_ERR_NOT_SUPPORTED;
         } else if (length > ADMA2_DESC_MAX_LENGTH) {
             zxlogf(TRACE, "sdhci: chunk size > %zu is unsupported\n", length);
             return ZX_ERR_NOT_SUPPORTED;
-        } else if ((++count) > DMA_DESC_COUNT) {
-            zxlogf(TRACE, "sdhci: request with more than %zd chunks is unsupported\n",
-                    length);
+        } else if (count >= DMA_DESC_COUNT) {
+            zxlogf(TRACE, "sdhci: request with more than %d chunks is unsupported\n",
+                    DMA_DESC_COUNT);
             return ZX_ERR_NOT_SUPPORTED;
         }
-        desc->length = length & 0xffff; // 0 = 0x10000 bytes
-        desc->address = paddr;
-        desc->attr = 0;
-        desc->valid = 1;
-        desc->act2 = 1; // transfer data
-        desc += 1;
+        if (dev->dma64) {
+            sdhci_adma64_desc_t* desc = &dev->descs.adma64[count];
+            desc->length = length & 0xffff; // 0 = 0x10000 bytes
+            desc->address = paddr;
+            desc->attr = 0;
+            desc->valid = 1;
+            desc->act2 = 1; // transfer data
+        } else {
+            if ((paddr + length - 1) > UINT32_MAX) {
+                zxlogf(TRACE, "sdhci: chunk at 0x%" PRIx64 " not addressable with 32-bit ADMA2\n",
+                        (uint64_t)paddr);
+                return ZX_ERR_NOT_SUPPORTED;
+            }
+            sdhci_adma32_desc_t* desc = &dev->descs.adma32[count];
+            desc->length = length & 0xffff; // 0 = 0x10000 bytes
+            desc->address = (uint32_t)paddr;
+            desc->attr = 0;
+            desc->valid = 1;
+            desc->act2 = 1; // transfer data
+        }
+        count++;
+    }
+    // set end bit on the last descriptor
+    if (dev->dma64) {
+        dev->descs.adma64[count - 1].end = 1;
+    } else {
+        dev->descs.adma32[count - 1].end = 1;
     }
 
     if (driver_get_log_flags() & DDK_LOG_SPEW) {
-        desc = dev->descs;
-        do {
-            zxlogf(SPEW, "desc: addr=0x%" PRIx64 " length=0x%04x attr=0x%04x\n",
-                    desc->address, desc->length, desc->attr);
-        } while (!(desc++)->end);
+        for (int i = 0; i < count; i++) {
+            if (dev->dma64) {
+                sdhci_adma64_desc_t* desc = &dev->descs.adma64[i];
+                zxlogf(SPEW, "desc: addr=0x%" PRIx64 " length=0x%04x attr=0x%04x\n",
+                        desc->address, desc->length, desc->attr);
+            } else {
+                sdhci_adma32_desc_t* desc = &dev->descs.adma32[i];
+                zxlogf(SPEW, "desc: addr=0x%08x length=0x%04x attr=0x%04x\n",
+                        desc->address, desc->length, desc->attr);
+            }
+        }
     }
     return ZX_OK;
 }
@@ -498,7 +547,7 @@ static zx_status_t sdhci_start_req_locked(sdhci_device_t* dev, sdmmc_req_t* req)
     uint32_t cmd = sdhci_prepare_cmd(req);
     bool has_data = sdmmc_cmd_has_data(req->cmd_flags);
 
-    if (req->use_dma && !sdhci_supports_adma2_64bit(dev)) {
+    if (req->use_dma && !sdhci_supports_adma2(dev)) {
         zxlogf(TRACE, "sdhci: host does not support DMA\n");
         return ZX_ERR_NOT_SUPPORTED;
     }
@@ -955,23 +1004,39 @@ static zx_status_t sdhci_controller_init(sdhci_device_t* dev) {
     }
 
     // allocate and setup DMA descriptor
-    if (sdhci_supports_adma2_64bit(dev)) {
+    if (sdhci_supports_adma2(dev)) {
+        dev->dma64 = !!(dev->info.caps & SDMMC_HOST_CAP_64BIT);
+        const size_t desc_size = dev->dma64 ? sizeof(sdhci_adma64_desc_t)
+                                            : sizeof(sdhci_adma32_desc_t);
         status = io_buffer_init(&dev->iobuf, dev->bti_handle,
-                                DMA_DESC_COUNT * sizeof(sdhci_adma64_desc_t),
+                                DMA_DESC_COUNT * desc_size,
                                 IO_BUFFER_RW | IO_BUFFER_CONTIG);
         if (status != ZX_OK) {
             zxlogf(ERROR, "sdhci: error allocating DMA descriptors\n");
             goto fail;
         }
-        dev->descs = io_buffer_virt(&dev->iobuf);
+        if (!dev->dma64 &&
+            (io_buffer_phys(&dev->iobuf) + DMA_DESC_COUNT * desc_size) > UINT32_MAX) {
+            zxlogf(ERROR, "sdhci: descriptor table not addressable with 32-bit ADMA2,"
+                          " falling back to PIO\n");
+            io_buffer_release(&dev->iobuf);
+            dev->info.caps &= ~SDMMC_HOST_CAP_ADMA2;
+            dev->info.max_transfer_size = BLOCK_MAX_TRANSFER_UNBOUNDED;
+            goto no_dma;
+        }
+        dev->descs.virt = io_buffer_virt(&dev->iobuf);
         dev->info.max_transfer_size = DMA_DESC_COUNT * PAGE_SIZE;
 
-        // Select ADMA2
-        dev->regs->ctrl0 |= SDHCI_HOSTCTRL_DMA_SELECT_ADMA2;
+        // Select the ADMA2 descriptor format matching the allocation
+        uint32_t ctrl0 = dev->regs->ctrl0 & ~SDHCI_HOSTCTRL_DMA_SELECT_MASK;
+        ctrl0 |= dev->dma64 ? SDHCI_HOSTCTRL_DMA_SELECT_ADMA2
+                            : SDHCI_HOSTCTRL_DMA_SELECT_ADMA2_32;
+        dev->regs->ctrl0 = ctrl0;
     } else {
         // no maximum if only PIO supported
         dev->info.max_transfer_size = BLOCK_MAX_TRANSFER_UNBOUNDED;
     }
+no_dma:
     dev->info.max_transfer_size_non_dma = BLOCK_MAX_TRANSFER_UNBOUNDED;
 
     // Configure the clock.
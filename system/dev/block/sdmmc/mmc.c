@@ -180,6 +180,16 @@ static zx_status_t mmc_decode_ext_csd(sdmmc_device_t* dev, const uint8_t* raw_ex
     zxlogf(TRACE, "mmc: found card with capacity = %" PRIu64 "B\n",
            dev->block_info.block_count * dev->block_info.block_size);
 
+    // Note whether the card has a command queue engine. No supported host
+    // controller exposes CQE registers yet, so the engine is only recorded
+    // here; sdmmc_probe_mmc makes sure it is switched off so the legacy
+    // multiple-block commands keep working.
+    if (raw_ext_csd[MMC_EXT_CSD_CMDQ_SUPPORT] & MMC_EXT_CSD_CMDQ_SUPPORT_CMDQ) {
+        dev->cmdq_support = true;
+        dev->cmdq_depth = (uint8_t)((raw_ext_csd[MMC_EXT_CSD_CMDQ_DEPTH] & 0x1f) + 1);
+        zxlogf(INFO, "mmc: card supports command queuing, depth %u\n", dev->cmdq_depth);
+    }
+
     return ZX_OK;
 }
 
@@ -269,6 +279,16 @@ zx_status_t sdmmc_probe_mmc(sdmmc_device_t* dev) {
         goto err;
     }
 
+    // If the card came up with its command queue engine enabled, disable
+    // it: READ/WRITE_MULTIPLE_BLOCK are illegal while command queuing is
+    // on, and this driver does not issue queued tasks yet.
+    if (dev->cmdq_support && dev->raw_ext_csd[MMC_EXT_CSD_CMDQ_MODE_EN]) {
+        if ((st = mmc_do_switch(dev, MMC_EXT_CSD_CMDQ_MODE_EN, 0)) != ZX_OK) {
+            zxlogf(ERROR, "mmc: failed to disable command queuing, retcode = %d\n", st);
+            goto err;
+        }
+    }
+
     dev->type = SDMMC_TYPE_MMC;
     dev->bus_width = SDMMC_BUS_WIDTH_1;
     dev->signal_voltage = SDMMC_VOLTAGE_330;
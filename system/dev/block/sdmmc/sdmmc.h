@@ -65,6 +65,12 @@ typedef struct sdmmc_device {
     uint32_t raw_csd[4];
     uint8_t raw_ext_csd[512];
 
+    // eMMC command queue engine support advertised by the card. The queue
+    // depth is the number of tasks the card can track (EXT_CSD
+    // CMDQ_DEPTH + 1). The engine itself is not driven yet; see mmc.c.
+    bool cmdq_support;
+    uint8_t cmdq_depth;
+
     // sdio
     sdio_device_t sdio_dev;
     mtx_t lock;
@@ -92,7 +98,9 @@ typedef struct sdmmc_device {
 } sdmmc_device_t;
 
 static inline bool sdmmc_use_dma(sdmmc_device_t* dev) {
-    return (dev->host_info.caps & (SDMMC_HOST_CAP_ADMA2 | SDMMC_HOST_CAP_64BIT));
+    // The host DMA path requires ADMA2; a 64-bit capability alone is not
+    // enough to build a descriptor chain.
+    return (dev->host_info.caps & SDMMC_HOST_CAP_ADMA2);
 }
 
 // SD/MMC shared ops
@@ -89,20 +89,25 @@ static void ums_send_cbw(ums_t* ums, uint8_t lun, uint32_t transfer_length, uint
     // copy command_len bytes from the command passed in into the command_len
     memcpy(cbw->CBWCB, command, command_len);
 
-    sync_completion_t completion = SYNC_COMPLETION_INIT;
-    req->cookie = &completion;
+    // Queue the CBW without waiting for it to complete. Requests on a bulk
+    // endpoint execute in order and the device NAKs transfers it is not ready
+    // for, so the stages that follow may be queued immediately behind the CBW
+    // without a software turnaround in between. A CBW failure surfaces
+    // through the status stage.
+    req->cookie = NULL;
     usb_request_queue(&ums->usb, req);
-    sync_completion_wait(&completion, ZX_TIME_INFINITE);
 }
 
-static zx_status_t ums_read_csw(ums_t* ums, uint32_t* out_residue) {
-    sync_completion_t completion = SYNC_COMPLETION_INIT;
+static void ums_queue_csw(ums_t* ums, sync_completion_t* completion) {
     usb_request_t* csw_request = ums->csw_req;
-    csw_request->cookie = &completion;
+    csw_request->cookie = completion;
     usb_request_queue(&ums->usb, csw_request);
-    sync_completion_wait(&completion, ZX_TIME_INFINITE);
+}
 
-    csw_status_t csw_error = ums_verify_csw(ums, csw_request, out_residue);
+static zx_status_t ums_wait_csw(ums_t* ums, sync_completion_t* completion, uint32_t* out_residue) {
+    sync_completion_wait(completion, ZX_TIME_INFINITE);
+
+    csw_status_t csw_error = ums_verify_csw(ums, ums->csw_req, out_residue);
 
     if (csw_error == CSW_SUCCESS) {
         return ZX_OK;
@@ -117,6 +122,12 @@ static zx_status_t ums_read_csw(ums_t* ums, uint32_t* out_residue) {
     }
 }
 
+static zx_status_t ums_read_csw(ums_t* ums, uint32_t* out_residue) {
+    sync_completion_t completion = SYNC_COMPLETION_INIT;
+    ums_queue_csw(ums, &completion);
+    return ums_wait_csw(ums, &completion, out_residue);
+}
+
 static csw_status_t ums_verify_csw(ums_t* ums, usb_request_t* csw_request, uint32_t* out_residue) {
     ums_csw_t csw;
     usb_req_copy_from(&ums->usb, csw_request, &csw, sizeof(csw), 0);
@@ -259,8 +270,12 @@ static zx_status_t ums_mode_sense6(ums_t* ums, uint8_t lun, scsi_mode_sense_6_da
     return status;
 }
 
-static zx_status_t ums_data_transfer(ums_t* ums, ums_txn_t* txn, zx_off_t offset, size_t length,
-                                     uint8_t ep_address) {
+// Prepares the shared data request for a transfer. This is done before the
+// CBW is queued so that a software failure here cannot leave the device
+// waiting for a data stage that will never arrive.
+static zx_status_t ums_data_transfer_init(ums_t* ums, ums_txn_t* txn, zx_off_t offset,
+                                          size_t length, uint8_t ep_address,
+                                          sync_completion_t* completion) {
     usb_request_t* req = &ums->data_transfer_req;
 
     zx_status_t status = usb_req_init(&ums->usb, req, txn->op.rw.vmo, offset, length, ep_address);
@@ -268,13 +283,17 @@ static zx_status_t ums_data_transfer(ums_t* ums, ums_txn_t* txn, zx_off_t offset
         return status;
     }
     req->complete_cb = ums_req_complete;
+    req->cookie = completion;
+    return ZX_OK;
+}
 
-    sync_completion_t completion = SYNC_COMPLETION_INIT;
-    req->cookie = &completion;
-    usb_request_queue(&ums->usb, req);
-    sync_completion_wait(&completion, ZX_TIME_INFINITE);
+static zx_status_t ums_data_transfer_wait(ums_t* ums, size_t length,
+                                          sync_completion_t* completion) {
+    usb_request_t* req = &ums->data_transfer_req;
+
+    sync_completion_wait(completion, ZX_TIME_INFINITE);
 
-    status = req->response.status;
+    zx_status_t status = req->response.status;
     if (status == ZX_OK && req->response.actual != length) {
         status = ZX_ERR_IO;
     }
@@ -304,6 +323,14 @@ static zx_status_t ums_read(ums_block_t* dev, ums_txn_t* txn) {
         }
         size_t length = blocks * block_size;
 
+        sync_completion_t data_completion = SYNC_COMPLETION_INIT;
+        sync_completion_t csw_completion = SYNC_COMPLETION_INIT;
+        status = ums_data_transfer_init(ums, txn, vmo_offset, length, ums->bulk_in_addr,
+                                        &data_completion);
+        if (status != ZX_OK) {
+            break;
+        }
+
         // CBW Configuration
         // Need to use UMS_READ16 if block addresses are greater than 32 bit
         if (dev->total_blocks > UINT32_MAX) {
@@ -330,7 +357,13 @@ static zx_status_t ums_read(ums_block_t* dev, ums_txn_t* txn) {
             ums_send_cbw(ums, dev->lun, length, USB_DIR_IN, sizeof(command), &command);
         }
 
-        status = ums_data_transfer(ums, txn, vmo_offset, length, ums->bulk_in_addr);
+        // Queue the data stage and the status stage immediately behind the
+        // CBW so that the whole command proceeds on the bus without waiting
+        // on software between stages.
+        usb_request_queue(&ums->usb, &ums->data_transfer_req);
+        ums_queue_csw(ums, &csw_completion);
+
+        status = ums_data_transfer_wait(ums, length, &data_completion);
 
         block_offset += blocks;
         num_blocks -= blocks;
@@ -338,7 +371,10 @@ static zx_status_t ums_read(ums_block_t* dev, ums_txn_t* txn) {
 
         // receive CSW
         uint32_t residue;
-        status = ums_read_csw(ums, &residue);
+        zx_status_t csw_status = ums_wait_csw(ums, &csw_completion, &residue);
+        if (status == ZX_OK) {
+            status = csw_status;
+        }
         if (status == ZX_OK && residue) {
             zxlogf(ERROR, "unexpected residue in ums_read\n");
             status = ZX_ERR_IO;
@@ -369,6 +405,14 @@ static zx_status_t ums_write(ums_block_t* dev, ums_txn_t* txn) {
         }
         size_t length = blocks * block_size;
 
+        sync_completion_t data_completion = SYNC_COMPLETION_INIT;
+        sync_completion_t csw_completion = SYNC_COMPLETION_INIT;
+        status = ums_data_transfer_init(ums, txn, vmo_offset, length, ums->bulk_out_addr,
+                                        &data_completion);
+        if (status != ZX_OK) {
+            break;
+        }
+
         // CBW Configuration
         // Need to use UMS_WRITE16 if block addresses are greater than 32 bit
         if (dev->total_blocks > UINT32_MAX) {
@@ -395,7 +439,11 @@ static zx_status_t ums_write(ums_block_t* dev, ums_txn_t* txn) {
             ums_send_cbw(ums, dev->lun, length, USB_DIR_OUT, sizeof(command), &command);
         }
 
-        status = ums_data_transfer(ums, txn, vmo_offset, length, ums->bulk_out_addr);
+        // As in ums_read, queue all three stages of the command up front.
+        usb_request_queue(&ums->usb, &ums->data_transfer_req);
+        ums_queue_csw(ums, &csw_completion);
+
+        status = ums_data_transfer_wait(ums, length, &data_completion);
 
         block_offset += blocks;
         num_blocks -= blocks;
@@ -403,7 +451,10 @@ static zx_status_t ums_write(ums_block_t* dev, ums_txn_t* txn) {
 
         // receive CSW
         uint32_t residue;
-        status = ums_read_csw(ums, &residue);
+        zx_status_t csw_status = ums_wait_csw(ums, &csw_completion, &residue);
+        if (status == ZX_OK) {
+            status = csw_status;
+        }
         if (status == ZX_OK && residue) {
             zxlogf(ERROR, "unexpected residue in ums_write\n");
             status = ZX_ERR_IO;
@@ -23,6 +23,7 @@
 #include <zircon/device/block.h>
 #include <zircon/errors.h>
 #include <zircon/status.h>
+#include <zircon/syscalls.h>
 #include <zircon/thread_annotations.h>
 #include <zircon/types.h>
 #include <zxcrypt/volume.h>
@@ -157,13 +158,17 @@ zx_status_t Device::Init() {
         return rc;
     }
 
-    // Start workers
-    // TODO(aarongreen): Investigate performance implications of adding more workers.
+    // Start one worker per CPU, up to the limit, so that cryptographic throughput scales with
+    // the machine rather than capping at a single core.
     if ((rc = zx::port::create(0, &port_)) != ZX_OK) {
         zxlogf(ERROR, "zx::port::create failed: %s\n", zx_status_get_string(rc));
         return rc;
     }
-    for (size_t i = 0; i < kNumWorkers; ++i) {
+    size_t num_workers = fbl::min<size_t>(zx_system_get_num_cpus(), kMaxWorkers);
+    if (num_workers == 0) {
+        num_workers = 1;
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
         zx::port port;
         port_.duplicate(ZX_RIGHT_SAME_RIGHTS, &port);
         if ((rc = workers_[i].Start(this, *volume, fbl::move(port))) != ZX_OK) {
@@ -506,13 +511,86 @@ void Device::SendToWorker(block_op_t* block) {
     LOG_ENTRY_ARGS("block=%p", block);
     zx_status_t rc;
 
+    extra_op_t* extra = BlockToExtra(block, info_->op_size);
+    uint32_t cmd = block->command & BLOCK_OP_MASK;
+
+    // Decide how many shards to split this request into: enough to spread a large transaction
+    // across the workers, but never so many that a shard has less than |kMinShardSize| of
+    // cryptographic work.  Shard boundaries fall on device blocks, matching the alignment the
+    // random access ciphers require.
+    uint64_t nshards = 1;
+    uint32_t length;
+    if ((cmd == BLOCK_OP_READ || cmd == BLOCK_OP_WRITE) &&
+        !mul_overflow(block->rw.length, info_->block_size, &length)) {
+        uint64_t max_shards = fbl::max<uint64_t>(length / kMinShardSize, 1);
+        nshards = fbl::min<uint64_t>(fbl::min<uint64_t>(max_shards, info_->num_workers),
+                                     block->rw.length);
+    }
+
+    // Read shards decrypt in place in a shared mapping of the ciphertext; establish it up front
+    // so the shards don't race to create it.  If the mapping fails, fall back to a single shard,
+    // which maps the ciphertext itself; see |Worker::DecryptRead|.
+    if (nshards > 1 && cmd == BLOCK_OP_READ) {
+        uint64_t offset_vmo;
+        uintptr_t address;
+        constexpr uint32_t flags = ZX_VM_PERM_READ | ZX_VM_PERM_WRITE;
+        if (mul_overflow(block->rw.offset_vmo, info_->block_size, &offset_vmo) ||
+            zx_vmar_map(zx_vmar_root_self(), flags, 0, block->rw.vmo, offset_vmo, length,
+                        &address) != ZX_OK) {
+            nshards = 1;
+        } else {
+            extra->mapped = reinterpret_cast<uint8_t*>(address);
+        }
+    }
+
+    extra->shards.store(static_cast<uint32_t>(nshards));
+    extra->shard_status.store(ZX_OK);
+
     zx_port_packet_t packet;
-    Worker::MakeRequest(&packet, Worker::kBlockRequest, block);
-    if ((rc = port_.queue(&packet)) != ZX_OK) {
-        zxlogf(ERROR, "zx::port::queue failed: %s\n", zx_status_get_string(rc));
-        BlockComplete(block, rc);
+    for (uint64_t i = 0; i < nshards; ++i) {
+        Worker::MakeRequest(&packet, Worker::kBlockRequest, block, i, nshards);
+        if ((rc = port_.queue(&packet)) != ZX_OK) {
+            zxlogf(ERROR, "zx::port::queue failed: %s\n", zx_status_get_string(rc));
+            // Account for this and every unsent shard, so whichever shard finishes last still
+            // completes the block.
+            for (uint64_t j = i; j < nshards; ++j) {
+                ShardComplete(block, rc);
+            }
+            return;
+        }
+    }
+}
+
+void Device::ShardComplete(block_op_t* block, zx_status_t status) {
+    LOG_ENTRY_ARGS("block=%p, status=%s", block, zx_status_get_string(status));
+    ZX_DEBUG_ASSERT(info_);
+
+    // Record the first error encountered by any shard.
+    extra_op_t* extra = BlockToExtra(block, info_->op_size);
+    if (status != ZX_OK) {
+        zx_status_t expected = ZX_OK;
+        extra->shard_status.compare_exchange_strong(&expected, status, fbl::memory_order_seq_cst,
+                                                    fbl::memory_order_seq_cst);
+    }
+    if (extra->shards.fetch_sub(1) != 1) {
         return;
     }
+
+    // This was the last shard; tear down any shared mapping and finish the request.
+    status = extra->shard_status.load();
+    if (extra->mapped) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(extra->mapped);
+        extra->mapped = nullptr;
+        uint32_t length;
+        if (!mul_overflow(block->rw.length, info_->block_size, &length)) {
+            zx_vmar_unmap(zx_vmar_root_self(), address, length);
+        }
+    }
+    if ((block->command & BLOCK_OP_MASK) == BLOCK_OP_WRITE) {
+        BlockForward(block, status);
+    } else {
+        BlockComplete(block, status);
+    }
 }
 
 void Device::BlockCallback(block_op_t* block, zx_status_t status) {
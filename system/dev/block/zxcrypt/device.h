@@ -76,18 +76,30 @@ public:
     // Returns a completed |block| request to the caller of |BlockQueue|.
     void BlockComplete(block_op_t* block, zx_status_t status) __TA_EXCLUDES(mtx_);
 
+    // Records the result of one shard of a request that was split between workers (see
+    // |SendToWorker|), and, once the last shard has finished, forwards or completes |block| as
+    // appropriate for its command.
+    void ShardComplete(block_op_t* block, zx_status_t status) __TA_EXCLUDES(mtx_);
+
 private:
     DISALLOW_COPY_ASSIGN_AND_MOVE(Device);
 
-    // TODO(aarongreen): Investigate performance impact of changing this.
-    // Number of encrypting/decrypting workers
-    static const size_t kNumWorkers = 2;
+    // Maximum number of encrypting/decrypting workers.  |Init| starts one worker per CPU, up to
+    // this limit; the actual count is saved in |DeviceInfo::num_workers|.
+    static const size_t kMaxWorkers = 8;
+
+    // Minimum number of bytes of cryptographic work per shard.  Requests at least twice this
+    // size are split between workers so that a single large transaction can use several cores;
+    // smaller ones aren't worth the extra dispatch.
+    static const uint32_t kMinShardSize = 32768;
 
     // Adds |block| to the write queue if not null, and sends to the workers as many write requests
     // as fit in the space available in the write buffer.
     void EnqueueWrite(block_op_t* block = nullptr) __TA_EXCLUDES(mtx_);
 
-    // Sends a block I/O request to a worker to be encrypted or decrypted.
+    // Sends a block I/O request to the workers to be encrypted or decrypted.  Large requests are
+    // split into several shards, each encrypted or decrypted independently; the last shard to
+    // finish completes the request via |ShardComplete|.
     void SendToWorker(block_op_t* block) __TA_EXCLUDES(mtx_);
 
     // Callback used for block ops sent to the parent device.  Restores the fields saved by
@@ -146,7 +158,7 @@ private:
     thrd_t init_;
 
     // Threads that performs encryption/decryption.
-    Worker workers_[kNumWorkers];
+    Worker workers_[kMaxWorkers];
 
     // Port used to send write/read operations to be encrypted/decrypted.
     zx::port port_;
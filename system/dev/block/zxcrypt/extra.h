@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <ddk/protocol/block.h>
+#include <fbl/atomic.h>
 #include <zircon/listnode.h>
 #include <zircon/types.h>
 
@@ -36,6 +37,13 @@ struct extra_op_t {
     void (*completion_cb)(block_op_t* block, zx_status_t status);
     void* cookie;
 
+    // Used by sharded requests, i.e. those split between several workers (see
+    // |Device::SendToWorker|): the ciphertext mapping shared by read shards, the number of shards
+    // still outstanding, and the first error any shard encountered.
+    uint8_t* mapped;
+    fbl::atomic<uint32_t> shards;
+    fbl::atomic<zx_status_t> shard_status;
+
     // Resets this structure to an initial state.
     zx_status_t Init(block_op_t* block, size_t reserved_blocks);
 };
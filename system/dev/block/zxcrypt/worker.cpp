@@ -9,6 +9,7 @@
 
 #include <crypto/cipher.h>
 #include <ddk/debug.h>
+#include <fbl/algorithm.h>
 #include <fbl/auto_call.h>
 #include <lib/zx/port.h>
 #include <zircon/listnode.h>
@@ -32,7 +33,8 @@ Worker::~Worker() {
     LOG_ENTRY();
 }
 
-void Worker::MakeRequest(zx_port_packet_t* packet, uint64_t op, void* arg) {
+void Worker::MakeRequest(zx_port_packet_t* packet, uint64_t op, void* arg, uint64_t shard,
+                         uint64_t nshards) {
     static_assert(sizeof(uintptr_t) <= sizeof(uint64_t), "cannot store pointer as uint64_t");
     ZX_DEBUG_ASSERT(packet);
     packet->key = 0;
@@ -40,6 +42,8 @@ void Worker::MakeRequest(zx_port_packet_t* packet, uint64_t op, void* arg) {
     packet->status = ZX_OK;
     packet->user.u64[0] = op;
     packet->user.u64[1] = reinterpret_cast<uint64_t>(arg);
+    packet->user.u64[2] = shard;
+    packet->user.u64[3] = nshards;
 }
 
 zx_status_t Worker::Start(Device* device, const Volume& volume, zx::port&& port) {
@@ -96,34 +100,58 @@ zx_status_t Worker::Run() {
             return ZX_ERR_NOT_SUPPORTED;
         }
 
-        // Dispatch block request
+        // Dispatch block request.  Each packet holds one shard of the request; the last shard to
+        // finish forwards or completes the block op via |Device::ShardComplete|.
         block_op_t* block = reinterpret_cast<block_op_t*>(packet.user.u64[1]);
+        uint64_t shard = packet.user.u64[2];
+        uint64_t nshards = packet.user.u64[3];
         switch (block->command & BLOCK_OP_MASK) {
         case BLOCK_OP_WRITE:
-            device_->BlockForward(block, EncryptWrite(block));
+            device_->ShardComplete(block, EncryptWrite(block, shard, nshards));
             break;
 
         case BLOCK_OP_READ:
-            device_->BlockComplete(block, DecryptRead(block));
+            device_->ShardComplete(block, DecryptRead(block, shard, nshards));
             break;
 
         default:
-            device_->BlockComplete(block, ZX_ERR_NOT_SUPPORTED);
+            device_->ShardComplete(block, ZX_ERR_NOT_SUPPORTED);
         }
     }
 }
 
-zx_status_t Worker::EncryptWrite(block_op_t* block) {
-    LOG_ENTRY_ARGS("block=%p", block);
+// Returns via |first| and |count| the range of device blocks, relative to the start of the
+// request, making up shard |shard| of |nshards|.  Returns false if the shard is empty, which can
+// happen at the tail of an uneven split.
+static bool ShardRange(uint32_t length, uint64_t shard, uint64_t nshards, uint64_t* first,
+                       uint64_t* count) {
+    ZX_DEBUG_ASSERT(nshards != 0);
+    uint64_t shard_blocks = (length + nshards - 1) / nshards;
+    *first = shard * shard_blocks;
+    if (*first >= length) {
+        return false;
+    }
+    *count = fbl::min(shard_blocks, length - *first);
+    return true;
+}
+
+zx_status_t Worker::EncryptWrite(block_op_t* block, uint64_t shard, uint64_t nshards) {
+    LOG_ENTRY_ARGS("block=%p, shard=%" PRIu64 "/%" PRIu64, block, shard, nshards);
     zx_status_t rc;
 
-    // Convert blocks to bytes
     extra_op_t* extra = BlockToExtra(block, device_->op_size());
+    uint64_t first, count;
+    if (!ShardRange(extra->length, shard, nshards, &first, &count)) {
+        return ZX_OK;
+    }
+
+    // Convert this shard's slice of the request from blocks to bytes
     uint32_t length;
-    uint64_t offset_dev, offset_vmo;
-    if (mul_overflow(block->rw.length, device_->block_size(), &length) ||
-        mul_overflow(block->rw.offset_dev, device_->block_size(), &offset_dev) ||
-        mul_overflow(extra->offset_vmo, device_->block_size(), &offset_vmo)) {
+    uint64_t offset_dev, offset_vmo, offset_shard;
+    if (mul_overflow(count, device_->block_size(), &length) ||
+        mul_overflow(block->rw.offset_dev + first, device_->block_size(), &offset_dev) ||
+        mul_overflow(extra->offset_vmo + first, device_->block_size(), &offset_vmo) ||
+        mul_overflow(first, device_->block_size(), &offset_shard)) {
         zxlogf(ERROR,
                "overflow; length=%" PRIu32 "; offset_dev=%" PRIu64 "; offset_vmo=%" PRIu64 "\n",
                block->rw.length, block->rw.offset_dev, extra->offset_vmo);
@@ -131,11 +159,12 @@ zx_status_t Worker::EncryptWrite(block_op_t* block) {
     }
 
     // Copy and encrypt the plaintext
-    if ((rc = zx_vmo_read(extra->vmo, extra->data, offset_vmo, length)) != ZX_OK) {
+    uint8_t* data = extra->data + offset_shard;
+    if ((rc = zx_vmo_read(extra->vmo, data, offset_vmo, length)) != ZX_OK) {
         zxlogf(ERROR, "zx_vmo_read() failed: %s\n", zx_status_get_string(rc));
         return rc;
     }
-    if ((rc = encrypt_.Encrypt(extra->data, offset_dev, length, extra->data) != ZX_OK)) {
+    if ((rc = encrypt_.Encrypt(data, offset_dev, length, data)) != ZX_OK) {
         zxlogf(ERROR, "failed to encrypt: %s\n", zx_status_get_string(rc));
         return rc;
     }
@@ -143,22 +172,40 @@ zx_status_t Worker::EncryptWrite(block_op_t* block) {
     return ZX_OK;
 }
 
-zx_status_t Worker::DecryptRead(block_op_t* block) {
-    LOG_ENTRY_ARGS("block=%p", block);
+zx_status_t Worker::DecryptRead(block_op_t* block, uint64_t shard, uint64_t nshards) {
+    LOG_ENTRY_ARGS("block=%p, shard=%" PRIu64 "/%" PRIu64, block, shard, nshards);
     zx_status_t rc;
 
-    // Convert blocks to bytes
+    extra_op_t* extra = BlockToExtra(block, device_->op_size());
+    uint64_t first, count;
+    if (!ShardRange(extra->length, shard, nshards, &first, &count)) {
+        return ZX_OK;
+    }
+
+    // Convert this shard's slice of the request from blocks to bytes
     uint32_t length;
-    uint64_t offset_dev, offset_vmo;
-    if (mul_overflow(block->rw.length, device_->block_size(), &length) ||
-        mul_overflow(block->rw.offset_dev, device_->block_size(), &offset_dev) ||
-        mul_overflow(block->rw.offset_vmo, device_->block_size(), &offset_vmo)) {
+    uint64_t offset_dev, offset_vmo, offset_shard;
+    if (mul_overflow(count, device_->block_size(), &length) ||
+        mul_overflow(block->rw.offset_dev + first, device_->block_size(), &offset_dev) ||
+        mul_overflow(block->rw.offset_vmo + first, device_->block_size(), &offset_vmo) ||
+        mul_overflow(first, device_->block_size(), &offset_shard)) {
         zxlogf(ERROR,
                "overflow; length=%" PRIu32 "; offset_dev=%" PRIu64 "; offset_vmo=%" PRIu64 "\n",
                block->rw.length, block->rw.offset_dev, block->rw.offset_vmo);
         return ZX_ERR_OUT_OF_RANGE;
     }
 
+    // Sharded requests decrypt in place in the shared ciphertext mapping established by
+    // |Device::SendToWorker|; it is unmapped when the last shard completes.
+    if (extra->mapped) {
+        uint8_t* data = extra->mapped + offset_shard;
+        if ((rc = decrypt_.Decrypt(data, offset_dev, length, data)) != ZX_OK) {
+            zxlogf(ERROR, "failed to decrypt: %s\n", zx_status_get_string(rc));
+            return rc;
+        }
+        return ZX_OK;
+    }
+
     // Map the ciphertext
     zx_handle_t root = zx_vmar_root_self();
     uintptr_t address;
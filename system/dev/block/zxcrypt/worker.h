@@ -32,8 +32,11 @@ public:
     static constexpr uint64_t kBlockRequest = 0x1;
     static constexpr uint64_t kStopRequest = 0x2;
 
-    // Configure the given |packet| to be an |op| request, with an optional |arg|.
-    static void MakeRequest(zx_port_packet_t* packet, uint64_t op, void* arg = nullptr);
+    // Configure the given |packet| to be an |op| request, with an optional |arg|.  Block requests
+    // additionally carry which of |nshards| shards of the request this packet represents; see
+    // |Device::SendToWorker|.
+    static void MakeRequest(zx_port_packet_t* packet, uint64_t op, void* arg = nullptr,
+                            uint64_t shard = 0, uint64_t nshards = 1);
 
     // Starts the worker, which will service requests sent from the given |device| on the given
     // |port|.  Cryptographic operations will use the key material from the given |volume|.
@@ -51,12 +54,15 @@ private:
     static int WorkerRun(void* arg) { return static_cast<Worker*>(arg)->Run(); }
     zx_status_t Run();
 
-    // Copies the plaintext data to be written to the write buffer location given in |block|'s extra
-    // information, and encrypts it before sending it to the parent device.
-    zx_status_t EncryptWrite(block_op_t* block);
+    // Copies this worker's shard of the plaintext data to be written to the write buffer location
+    // given in |block|'s extra information, and encrypts it.  The request is forwarded to the
+    // parent device once every shard has been encrypted; see |Device::ShardComplete|.
+    zx_status_t EncryptWrite(block_op_t* block, uint64_t shard, uint64_t nshards);
 
-    // Maps the ciphertext data in |block|, and decrypts it in place before completing the block op.
-    zx_status_t DecryptRead(block_op_t* block);
+    // Decrypts this worker's shard of the ciphertext data in |block| in place, using the shared
+    // mapping for sharded requests and mapping the data itself otherwise.  The block op completes
+    // once every shard has been decrypted; see |Device::ShardComplete|.
+    zx_status_t DecryptRead(block_op_t* block, uint64_t shard, uint64_t nshards);
 
     // The cipher objects used to perform cryptographic.  See notes on "random access" in
     // crypto/cipher.h.
@@ -52,6 +52,12 @@ public:
     // in how Legacy vs Modern systems are laid out.
     void RingKick(uint16_t ring_index) { backend_->RingKick(ring_index); }
 
+    // Returns true if the driver acknowledged |feature| during negotiation.
+    // Used by Rings to discover ring-level features such as EVENT_IDX.
+    bool FeatureAcked(uint32_t feature) const {
+        return feature < 64 && (driver_features_ & (1ull << feature));
+    }
+
     // It is expected that each derived device will implement tag().
     zx_device_t* device() { return device_; }
     virtual const char* tag() const = 0; // Implemented by derived devices
@@ -61,7 +67,12 @@ public:
 protected:
     // Methods for checking / acknowledging features
     bool DeviceFeatureSupported(uint32_t feature) { return backend_->ReadFeature(feature); }
-    void DriverFeatureAck(uint32_t feature) { backend_->SetFeature(feature); }
+    void DriverFeatureAck(uint32_t feature) {
+        backend_->SetFeature(feature);
+        if (feature < 64) {
+            driver_features_ |= (1ull << feature);
+        }
+    }
     bool DeviceStatusFeaturesOk() { return backend_->ConfirmFeatures(); }
 
     // Devie lifecycle methods
@@ -101,6 +112,10 @@ protected:
     // This lock exists for devices to synchronize themselves, it should not be used by the base
     // device class.
     fbl::Mutex lock_;
+
+private:
+    // Bitmask of features the driver has acked via DriverFeatureAck()
+    uint64_t driver_features_ = 0;
 };
 
 } // namespace virtio
@@ -222,6 +222,13 @@ zx_status_t EthernetDevice::Init() {
       virtio_hdr_len_ -= 2;
     }
 
+    // Negotiate EVENT_IDX so the host can suppress our ring notifications
+    // (and we its interrupts) whenever it is keeping up; combined with the
+    // tx kick batching below this cuts the notify exits to one per burst.
+    if (DeviceFeatureSupported(VIRTIO_RING_F_EVENT_IDX)) {
+        DriverFeatureAck(VIRTIO_RING_F_EVENT_IDX);
+    }
+
     // TODO(aarongreen): Check additional features bits and ack/nak them
     rc = DeviceStatusFeaturesOk();
     if (rc != ZX_OK) {
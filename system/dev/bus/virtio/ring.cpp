@@ -45,6 +45,7 @@ zx_status_t Ring::Init(uint16_t index, uint16_t count) {
     // XXX check that count is a power of 2
 
     index_ = index;
+    event_idx_ = device_->FeatureAcked(VIRTIO_RING_F_EVENT_IDX);
 
     // make sure the count is available in this ring
     uint16_t max_ring_size = device_->GetRingSize(index);
@@ -141,6 +142,20 @@ void Ring::SubmitChain(uint16_t desc_index) {
 void Ring::Kick() {
     LTRACE_ENTRY;
 
+    // The device tells us when it actually needs a notification: with
+    // EVENT_IDX it publishes the avail index it is waiting on, and without
+    // it it may set NO_NOTIFY while it is already polling the ring. Either
+    // way we can skip the trap for every burst the device is keeping up with.
+    uint16_t old = kicked_avail_idx_;
+    kicked_avail_idx_ = ring_.avail->idx;
+    if (event_idx_) {
+        if (!vring_need_event(vring_avail_event(&ring_), kicked_avail_idx_, old)) {
+            return;
+        }
+    } else if (ring_.used->flags & VRING_USED_F_NO_NOTIFY) {
+        return;
+    }
+
     device_->RingKick(index_);
 }
 
@@ -39,6 +39,12 @@ private:
 
     uint16_t index_ = 0;
 
+    // true if VIRTIO_RING_F_EVENT_IDX was negotiated for this device
+    bool event_idx_ = false;
+
+    // avail index as of the last Kick(), for vring_need_event()
+    uint16_t kicked_avail_idx_ = 0;
+
     vring ring_ = {};
 };
 
@@ -61,6 +67,12 @@ inline void Ring::IrqRingUpdate(T free_chain) {
         free_chain(used_elem);
     }
     ring_.last_used = i;
+
+    // With EVENT_IDX negotiated the device ignores avail->flags and only
+    // interrupts once the used index passes the event index published here.
+    if (event_idx_) {
+        vring_used_event(&ring_) = i;
+    }
 }
 
 void virtio_dump_desc(const struct vring_desc* desc);
@@ -52,6 +52,9 @@ typedef struct ethdev0 {
     int32_t promisc_requesters;
     int32_t multicast_promisc_requesters;
 
+    // instance providing receive buffers to an RX_QUEUE-capable mac, if any
+    struct ethdev* rx_owner;
+
     ethmac_info_t info;
     uint32_t status;
     zx_device_t* zxdev;
@@ -63,6 +66,12 @@ typedef struct tx_info {
     ethmac_netbuf_t netbuf;
 } tx_info_t;
 
+typedef struct rx_info {
+    struct ethdev* edev;
+    void* fifo_cookie;
+    ethmac_netbuf_t netbuf;
+} rx_info_t;
+
 // transmit thread has been created
 #define ETHDEV_TX_THREAD (1u)
 
@@ -84,6 +93,9 @@ typedef struct tx_info {
 // This client has requested multicast promisc mode
 #define ETHDEV_MULTICAST_PROMISC (0x40u)
 
+// receive thread has been created (netbuf-based zero-copy receive)
+#define ETHDEV_RX_THREAD (0x80u)
+
 // indicates the device is busy although its lock is released
 #define ETHDEV0_BUSY (1u)
 
@@ -123,11 +135,14 @@ typedef struct ethdev {
     zx_handle_t pmt;
 
     tx_info_t all_tx_bufs[FIFO_DEPTH];
-    mtx_t lock;               // Protects free_tx_bufs
+    rx_info_t all_rx_bufs[FIFO_DEPTH];
+    mtx_t lock;               // Protects free_tx_bufs and free_rx_bufs
     list_node_t free_tx_bufs; // tx_info_t elements
+    list_node_t free_rx_bufs; // rx_info_t elements
 
-    // fifo thread
+    // fifo threads
     thrd_t tx_thr;
+    thrd_t rx_thr;
 
     zx_device_t* zxdev;
 
@@ -391,6 +406,59 @@ static void eth_put_tx_info(ethdev_t* edev, tx_info_t* tx_info) {
     mtx_unlock(&edev->lock);
 }
 
+// Borrows an RX buffer from the pool. Returns NULL if none is available
+static rx_info_t* eth_get_rx_info(ethdev_t* edev) {
+    mtx_lock(&edev->lock);
+    rx_info_t* rx_info = list_remove_head_type(&edev->free_rx_bufs, rx_info_t, netbuf.node);
+    mtx_unlock(&edev->lock);
+    return rx_info;
+}
+
+// Returns an RX buffer to the pool
+static void eth_put_rx_info(ethdev_t* edev, rx_info_t* rx_info) {
+    mtx_lock(&edev->lock);
+    list_add_head(&edev->free_rx_bufs, &rx_info->netbuf.node);
+    mtx_unlock(&edev->lock);
+}
+
+static void eth0_complete_rx(void* cookie, ethmac_netbuf_t* netbuf, size_t length) {
+    rx_info_t* rx_info = containerof(netbuf, rx_info_t, netbuf);
+    ethdev_t* edev = rx_info->edev;
+    ethdev0_t* edev0 = edev->edev0;
+
+    // The frame was DMAed directly into this client's io buffer; any other
+    // active clients still need a copy, delivered via the recv path.
+    if (length > 0) {
+        mtx_lock(&edev0->lock);
+        ethdev_t* other;
+        list_for_every_entry(&edev0->list_active, other, ethdev_t, node) {
+            if (other != edev) {
+                eth_handle_rx(other, netbuf->data, length, 0);
+            }
+        }
+        mtx_unlock(&edev0->lock);
+    }
+
+    eth_fifo_entry_t entry = {.offset = netbuf->data - edev->io_buf,
+                              .length = length,
+                              .flags = length > 0 ? ETH_FIFO_RX_OK : 0,
+                              .cookie = rx_info->fifo_cookie};
+    eth_put_rx_info(edev, rx_info);
+
+    zx_status_t status;
+    if ((status = zx_fifo_write(edev->rx_fifo, sizeof(entry), &entry, 1, NULL)) < 0) {
+        if (status == ZX_ERR_SHOULD_WAIT) {
+            if ((edev->fail_rx_write++ % FAIL_REPORT_RATE) == 0) {
+                zxlogf(ERROR, "eth [%s]: no rx_fifo space available (%u times)\n",
+                       edev->name, edev->fail_rx_write);
+            }
+        } else {
+            // Fatal, should force teardown
+            zxlogf(ERROR, "eth [%s]: rx_fifo write failed %d\n", edev->name, status);
+        }
+    }
+}
+
 static void eth0_complete_tx(void* cookie, ethmac_netbuf_t* netbuf, zx_status_t status) {
     tx_info_t* tx_info = containerof(netbuf, tx_info_t, netbuf);
     ethdev_t* edev = tx_info->edev;
@@ -411,6 +479,7 @@ static ethmac_ifc_t ethmac_ifc = {
     .status = eth0_status,
     .recv = eth0_recv,
     .complete_tx = eth0_complete_tx,
+    .complete_rx = eth0_complete_rx,
 };
 
 static void eth_tx_echo(ethdev0_t* edev0, const void* data, size_t len) {
@@ -551,6 +620,68 @@ static int eth_tx_thread(void* arg) {
     return 0;
 }
 
+// Reads empty buffer entries posted by the client and hands them down to the
+// ethmac driver, which DMAs received frames directly into them and returns
+// them via eth0_complete_rx(). Only runs against RX_QUEUE-capable macs.
+static int eth_rx_thread(void* arg) {
+    ethdev_t* edev = (ethdev_t*)arg;
+    ethdev0_t* edev0 = edev->edev0;
+    eth_fifo_entry_t entries[FIFO_BATCH_SZ];
+    zx_status_t status;
+    size_t count;
+
+    for (;;) {
+        if ((status = zx_fifo_read(edev->rx_fifo, sizeof(entries[0]), entries,
+                                   countof(entries), &count)) < 0) {
+            if (status == ZX_ERR_SHOULD_WAIT) {
+                zx_signals_t observed;
+                if ((status = zx_object_wait_one(edev->rx_fifo,
+                                                 ZX_FIFO_READABLE |
+                                                 ZX_FIFO_PEER_CLOSED |
+                                                 kSignalFifoTerminate,
+                                                 ZX_TIME_INFINITE,
+                                                 &observed)) < 0) {
+                    zxlogf(ERROR, "eth [%s]: rx_fifo: error waiting: %d\n", edev->name, status);
+                    break;
+                }
+                if (observed & kSignalFifoTerminate)
+                    break;
+                continue;
+            } else {
+                zxlogf(ERROR, "eth [%s]: rx_fifo: cannot read: %d\n", edev->name, status);
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            eth_fifo_entry_t* e = &entries[i];
+            rx_info_t* rx_info = NULL;
+            if ((e->offset >= edev->io_size) || (e->length > (edev->io_size - e->offset))) {
+                // invalid offset/length. return the entry as an error
+            } else if ((rx_info = eth_get_rx_info(edev)) != NULL) {
+                // the pool is as deep as the fifo, so this cannot fail
+                rx_info->fifo_cookie = e->cookie;
+                rx_info->netbuf.data = edev->io_buf + e->offset;
+                rx_info->netbuf.phys = edev->paddr_map[e->offset / PAGE_SIZE] +
+                                       (e->offset & PAGE_MASK);
+                rx_info->netbuf.len = e->length;
+                if (edev0->mac.ops->queue_rx(edev0->mac.ctx, 0, &rx_info->netbuf) == ZX_OK) {
+                    // ownership transferred; returned via eth0_complete_rx()
+                    continue;
+                }
+                eth_put_rx_info(edev, rx_info);
+            }
+            e->length = 0;
+            e->flags = ETH_FIFO_INVALID;
+            if (zx_fifo_write(edev->rx_fifo, sizeof(*e), e, 1, NULL) < 0) {
+                zxlogf(ERROR, "eth [%s]: rx_fifo write failed\n", edev->name);
+            }
+        }
+    }
+
+    zxlogf(INFO, "eth [%s]: rx_thread: exit: %d\n", edev->name, status);
+    return 0;
+}
+
 static zx_status_t eth_get_fifos_locked(ethdev_t* edev, struct zircon_ethernet_Fifos* fifos) {
     zx_status_t status;
     if ((status = zx_fifo_create(FIFO_DEPTH, FIFO_ESIZE, 0, &fifos->tx, &edev->tx_fifo)) < 0) {
@@ -703,6 +834,20 @@ static zx_status_t eth_start_locked(ethdev_t* edev) TA_NO_THREAD_SAFETY_ANALYSIS
         edev->state |= ETHDEV_RUNNING;
         list_delete(&edev->node);
         list_add_tail(&edev0->list_active, &edev->node);
+        // If the mac does netbuf-based receive, one running client at a time
+        // provides the receive buffers and gets its frames without a copy.
+        if ((edev0->info.features & ETHMAC_FEATURE_RX_QUEUE) &&
+            (edev->paddr_map != NULL) && (edev0->rx_owner == NULL)) {
+            int r = thrd_create_with_name(&edev->rx_thr, eth_rx_thread,
+                                          edev, "eth-rx-thread");
+            if (r == thrd_success) {
+                edev->state |= ETHDEV_RX_THREAD;
+                edev0->rx_owner = edev;
+            } else {
+                // not fatal: the mac falls back to the recv copy path
+                zxlogf(ERROR, "eth [%s]: failed to start rx thread: %d\n", edev->name, r);
+            }
+        }
         // TODO - After we get IGMP, don't automatically set multicast promisc true
         eth_set_multicast_promisc_locked(edev, true);
     } else {
@@ -721,6 +866,19 @@ static zx_status_t eth_stop_locked(ethdev_t* edev) TA_NO_THREAD_SAFETY_ANALYSIS
         edev->state &= (~ETHDEV_RUNNING);
         list_delete(&edev->node);
         list_add_tail(&edev0->list_idle, &edev->node);
+        if (edev0->rx_owner == edev) {
+            // Stop providing receive buffers. The mac returns any it still
+            // holds via complete_rx() before stop() returns; until another
+            // capable client starts, frames go through the recv copy path.
+            edev0->rx_owner = NULL;
+            if (edev->state & ETHDEV_RX_THREAD) {
+                edev->state &= (~ETHDEV_RX_THREAD);
+                zx_object_signal(edev->rx_fifo, 0, kSignalFifoTerminate);
+                int ret;
+                thrd_join(edev->rx_thr, &ret);
+                zx_object_signal(edev->rx_fifo, kSignalFifoTerminate, 0);
+            }
+        }
         // The next three lines clean up promisc, multicast-promisc, and multicast-filter, in case
         // this ethdev had any state set. Ignore failures, which may come from drivers not
         // supporting the feature. (TODO: check failure codes).
@@ -965,6 +1123,17 @@ static void eth_kill_locked(ethdev_t* edev) {
 
     // try to convince clients to close us
     if (edev->rx_fifo) {
+        if (edev->state & ETHDEV_RX_THREAD) {
+            // Stop the RX thread before its fifo goes away.
+            edev->state &= (~ETHDEV_RX_THREAD);
+            zx_object_signal(edev->rx_fifo, 0, kSignalFifoTerminate);
+            int ret;
+            thrd_join(edev->rx_thr, &ret);
+            zxlogf(TRACE, "eth [%s]: kill: rx thread exited\n", edev->name);
+        }
+        if (edev->edev0->rx_owner == edev) {
+            edev->edev0->rx_owner = NULL;
+        }
         zx_handle_close(edev->rx_fifo);
         edev->rx_fifo = ZX_HANDLE_INVALID;
     }
@@ -1044,9 +1213,12 @@ static zx_status_t eth0_open(void* ctx, zx_device_t** out, uint32_t flags) {
     edev->edev0 = edev0;
 
     list_initialize(&edev->free_tx_bufs);
+    list_initialize(&edev->free_rx_bufs);
     for (size_t ndx = 0; ndx < FIFO_DEPTH; ndx++) {
         edev->all_tx_bufs[ndx].edev = edev;
         list_add_tail(&edev->free_tx_bufs, &edev->all_tx_bufs[ndx].netbuf.node);
+        edev->all_rx_bufs[ndx].edev = edev;
+        list_add_tail(&edev->free_rx_bufs, &edev->all_rx_bufs[ndx].netbuf.node);
     }
     mtx_init(&edev->lock, mtx_plain);
 
@@ -1140,6 +1312,14 @@ static zx_status_t eth_bind(void* ctx, zx_device_t* dev) {
         goto fail;
     }
 
+    if ((edev0->info.features & ETHMAC_FEATURE_RX_QUEUE) &&
+        ((ops->queue_rx == NULL) || !(edev0->info.features & ETHMAC_FEATURE_DMA))) {
+        zxlogf(ERROR, "eth: bind: device '%s': invalid FEATURE_RX_QUEUE support\n",
+               device_get_name(dev));
+        status = ZX_ERR_NOT_SUPPORTED;
+        goto fail;
+    }
+
     mtx_init(&edev0->lock, mtx_plain);
     list_initialize(&edev0->list_active);
     list_initialize(&edev0->list_idle);
@@ -62,12 +62,21 @@ static int irq_thread(void* arg) {
             void* data;
             size_t len;
 
+            // Poll the ring with further rx interrupts masked so a
+            // burst is consumed in one batch instead of waking us per
+            // packet. Anything that lands between the final empty poll
+            // and the unmask is latched and fires immediately.
+            eth_rx_irq_mask(&edev->eth);
+            unsigned packets = 0;
             while (eth_rx(&edev->eth, &data, &len) == ZX_OK) {
                 if (edev->ifc && (edev->state == ETH_RUNNING)) {
                     edev->ifc->recv(edev->cookie, data, len, 0);
                 }
                 eth_rx_ack(&edev->eth);
+                packets++;
             }
+            eth_update_itr(&edev->eth, packets);
+            eth_rx_irq_unmask(&edev->eth);
         }
         if (irq & ETH_IRQ_LSC) {
             bool was_online = edev->online;
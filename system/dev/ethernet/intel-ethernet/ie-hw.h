@@ -16,6 +16,7 @@
 #define IE_TXCW      0x0178 // TX Config Word
 #define IE_RXCW      0x0180 // RX Config Word
 #define IE_ICR       0x00c0 // Interrupt Cause Read
+#define IE_ITR       0x00c4 // Interrupt Throttling (256ns units)
 #define IE_ICS       0x00c8 // Interrupt Cause Set
 #define IE_IMS       0x00d0 // Interrupt Mask Set / Read
 #define IE_IMC       0x00d8 // Interrupt Mask Clear
@@ -215,6 +216,7 @@ typedef struct ie_txd {
 // https://www.intel.com/content/dam/www/public/us/en/documents/datasheets/i211-ethernet-controller-datasheet.pdf?asset=9567
 
 #define IE_IAM              0x00e0  // Interrupt Acknowledge Auto Mask Register
+#define IE_EITR(n)          (0x1680 + ((n) * 4)) // Interrupt Throttle (0.25us units)
 #define IE_EEC              0x12010 // EEPROM/Flash Control
 
 #define IE_TCTL_BST(n)          (((n) & 0x3ff) << 12) // Back-Off Slot Time. This value determines
@@ -46,6 +46,59 @@ unsigned eth_handle_irq(ethdev_t* eth) {
     return readl(IE_ICR);
 }
 
+void eth_rx_irq_mask(ethdev_t* eth) {
+    writel(ETH_IRQ_RX, IE_IMC);
+}
+
+void eth_rx_irq_unmask(ethdev_t* eth) {
+    writel(ETH_IRQ_RX, IE_IMS);
+}
+
+// Adaptive interrupt moderation, after Linux's dynamic ITR: small
+// batches favor a short throttle (latency), big batches a long one
+// (fewer, larger batches). Both the legacy ITR register (256ns units)
+// and the I211 EITR registers (0.25us units) take roughly 4 counts
+// per microsecond.
+//
+// Inter-interrupt intervals, in microseconds. Roughly 70k, 20k and
+// 4k interrupts per second.
+static const uint32_t eth_itr_usec[] = { 14, 50, 250 };
+
+#define ETH_ITR_LEVELS (sizeof(eth_itr_usec) / sizeof(eth_itr_usec[0]))
+
+static void eth_set_itr(ethdev_t* eth, uint32_t level) {
+    eth->itr_level = level;
+    uint32_t val = eth_itr_usec[level] << 2;
+    if (eth->pci_did == IE_DID_I211_AT) {
+        writel(val, IE_EITR(0));
+    } else {
+        writel(val, IE_ITR);
+    }
+}
+
+void eth_update_itr(ethdev_t* eth, unsigned packets) {
+    uint32_t target;
+    if (packets <= 4) {
+        target = 0;
+    } else if (packets <= 16) {
+        target = 1;
+    } else {
+        target = ETH_ITR_LEVELS - 1;
+    }
+
+    // move one level per interrupt toward the target so a single
+    // outlier batch doesn't whipsaw the throttle
+    uint32_t level = eth->itr_level;
+    if (target > level) {
+        level++;
+    } else if (target < level) {
+        level--;
+    }
+    if (level != eth->itr_level) {
+        eth_set_itr(eth, level);
+    }
+}
+
 bool eth_status_online(ethdev_t* eth) {
     return readl(IE_STATUS) & IE_STATUS_LU;
 }
@@ -389,6 +442,10 @@ void eth_init_hw(ethdev_t* eth) {
     }
     writel(reg, IE_TCTL);
 
+    // start with the most latency-friendly interrupt throttle;
+    // eth_update_itr() scales it up as traffic grows
+    eth_set_itr(eth, 0);
+
     // enable interrupts
     if (eth->pci_did == IE_DID_I211_AT) {
         // Receiver Descriptor Write Back & Link Status Change interrupts
@@ -49,6 +49,9 @@ struct ethdev {
     mtx_t send_lock;
 
     uint16_t pci_did;
+
+    // current interrupt moderation level (index into the itr table)
+    uint32_t itr_level;
 };
 
 #define ETH_MTU 1500
@@ -94,3 +97,12 @@ bool eth_status_online(ethdev_t* eth);
 #define ETH_IRQ_RX IE_INT_RXT0
 #define ETH_IRQ_LSC IE_INT_LSC
 unsigned eth_handle_irq(ethdev_t* eth);
+
+// Mask / unmask rx interrupts so the ring can be polled without
+// further wakeups. Causes latched while masked fire on unmask.
+void eth_rx_irq_mask(ethdev_t* eth);
+void eth_rx_irq_unmask(ethdev_t* eth);
+
+// Adjust the interrupt throttle based on how many packets the last
+// interrupt delivered.
+void eth_update_itr(ethdev_t* eth, unsigned packets);
@@ -8,7 +8,9 @@
 #include <limits.h>
 #include <string.h>
 
+#include <digest/digest.h>
 #include <fbl/algorithm.h>
+#include <fbl/auto_call.h>
 #include <fbl/unique_free_ptr.h>
 #include <minfs/fsck.h>
 #include <minfs/host.h>
@@ -76,8 +78,10 @@ zx_status_t IsDirectory(const char* path, bool* result) {
     return ZX_OK;
 }
 
-// Copies a file to minfs from the host, or vice versa.
-zx_status_t CopyFile(const char* src_path, const char* dst_path) {
+// Copies a file to minfs from the host, or vice versa. If |overwrite| is
+// set, an existing destination file is truncated and rewritten rather than
+// treated as an error.
+zx_status_t CopyFile(const char* src_path, const char* dst_path, bool overwrite = false) {
     FileWrapper src;
     FileWrapper dst;
 
@@ -86,7 +90,8 @@ zx_status_t CopyFile(const char* src_path, const char* dst_path) {
         return ZX_ERR_IO;
     }
 
-    if (FileWrapper::Open(dst_path, O_WRONLY | O_CREAT | O_EXCL, 0644, &dst) < 0) {
+    int dst_flags = O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : O_EXCL);
+    if (FileWrapper::Open(dst_path, dst_flags, 0644, &dst) < 0) {
         fprintf(stderr, "error: cannot open file '%s'\n", dst_path);
         return ZX_ERR_IO;
     }
@@ -157,6 +162,7 @@ bool MinfsCreator::IsCommandValid(Command command) {
 bool MinfsCreator::IsOptionValid(Option option) {
     switch (option) {
     case Option::kDepfile:
+    case Option::kCache:
     case Option::kReadonly:
     case Option::kOffset:
     case Option::kLength:
@@ -370,15 +376,93 @@ zx_status_t MinfsCreator::Add() {
 
     // Copy all files.
     for (size_t n = 0; n < file_list_.size(); n++) {
-        if ((status = AppendDepfile(file_list_[n].first.c_str())) != ZX_OK) {
+        const char* src = file_list_[n].first.c_str();
+        const char* dst = file_list_[n].second.c_str();
+        if ((status = AppendDepfile(src)) != ZX_OK) {
             return status;
         }
-        if ((status = CopyFile(file_list_[n].first.c_str(), file_list_[n].second.c_str()))
-            != ZX_OK) {
+        if ((status = CopyFile(src, dst)) != ZX_OK) {
             return status;
         }
+        if (CacheEnabled() && GetCommand() == Command::kMkfs && host_path(src)) {
+            // Index the content just written, so the next cached create can
+            // skip this file if it is unchanged.
+            digest::Digest digest;
+            uint64_t length;
+            if ((status = ImageCache::HashFile(src, &digest, &length)) != ZX_OK) {
+                fprintf(stderr, "error: cannot hash '%s'\n", src);
+                return status;
+            }
+            Cache().Record(dst, digest, length);
+        }
+    }
+
+    return ZX_OK;
+}
+
+zx_status_t MinfsCreator::Update() {
+    zx_status_t status;
+    // Mount the minfs.
+    if ((status = MountMinfs()) != ZX_OK) {
+        return status;
+    }
+
+    // Once the mounted image is being modified, a failure below leaves it
+    // partially updated; drop the sidecar in that case so the next run
+    // rebuilds the image from scratch.
+    auto discard = fbl::MakeAutoCall([this]() { Cache().Discard(); });
+
+    // Remove files written by the previous run which are no longer in the
+    // input set, freeing their blocks before anything new is written.
+    // Directories left empty by this are retained; the next full rebuild
+    // clears them.
+    for (size_t n = 0; n < Cache().Previous().size(); n++) {
+        const char* path = Cache().Previous()[n].path.c_str();
+        bool found = false;
+        for (size_t m = 0; m < file_list_.size(); m++) {
+            if (!strcmp(path, file_list_[m].second.c_str())) {
+                found = true;
+                break;
+            }
+        }
+        if (!found && emu_unlink(path) < 0) {
+            fprintf(stderr, "error: cannot remove stale file '%s'\n", path);
+            return ZX_ERR_IO;
+        }
+    }
+
+    // Make any directories which did not exist on the previous run.
+    for (size_t n = 0; n < dir_list_.size(); n++) {
+        if ((status = MakeDirectory(dir_list_[n].c_str())) != ZX_OK) {
+            return status;
+        }
+    }
+
+    // Rewrite only the files whose content digest changed.
+    for (size_t n = 0; n < file_list_.size(); n++) {
+        const char* src = file_list_[n].first.c_str();
+        const char* dst = file_list_[n].second.c_str();
+        if ((status = AppendDepfile(src)) != ZX_OK) {
+            return status;
+        }
+
+        digest::Digest digest;
+        uint64_t length;
+        if ((status = ImageCache::HashFile(src, &digest, &length)) != ZX_OK) {
+            fprintf(stderr, "error: cannot hash '%s'\n", src);
+            return status;
+        }
+
+        const ImageCache::Entry* entry = Cache().Lookup(dst);
+        if (entry == nullptr || entry->length != length || digest != entry->digest) {
+            if ((status = CopyFile(src, dst, true)) != ZX_OK) {
+                return status;
+            }
+        }
+        Cache().Record(dst, digest, length);
     }
 
+    discard.cancel();
     return ZX_OK;
 }
 
@@ -29,6 +29,7 @@ private:
     zx_status_t Mkfs() override;
     zx_status_t Fsck() override;
     zx_status_t Add() override;
+    zx_status_t Update() override;
     zx_status_t Ls() override;
 
     // Minfs-specific methods:
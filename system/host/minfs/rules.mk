@@ -18,6 +18,7 @@ MODULE_COMPILEFLAGS := \
     -Werror-implicit-function-declaration \
     -Wstrict-prototypes -Wwrite-strings \
     -Isystem/ulib/bitmap/include \
+    -Isystem/ulib/digest/include \
     -Isystem/ulib/zxcpp/include \
     -Isystem/ulib/fdio/include \
     -Isystem/ulib/fbl/include \
@@ -27,6 +28,8 @@ MODULE_COMPILEFLAGS := \
     -Isystem/ulib/fs-host/include \
 
 MODULE_HOST_LIBS := \
+    third_party/ulib/uboringssl.hostlib \
+    system/ulib/digest.hostlib \
     system/ulib/fbl.hostlib \
     system/ulib/fs.hostlib \
     system/ulib/minfs.hostlib \
@@ -77,6 +77,14 @@
 // clears the counters
 #define IOCTL_BLOCK_GET_STATS   \
     IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_BLOCK, 18)
+// Returns stats about vslice-to-pslice address translation on an FVM
+// partition and optionally clears the counters
+#define IOCTL_BLOCK_FVM_TRANSLATION_STATS \
+    IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_BLOCK, 19)
+// Returns stats from the block midlayer's I/O scheduler and optionally
+// clears the counters. Fails if no FIFO server is running.
+#define IOCTL_BLOCK_GET_SCHED_STATS \
+    IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_BLOCK, 20)
 
 // Block Impl ioctls (specific to each block device):
 
@@ -205,9 +213,32 @@ typedef struct {
 // ssize_t ioctl_block_fvm_upgrade(int fd, const upgrade_req_t* req);
 IOCTL_WRAPPER_IN(ioctl_block_fvm_upgrade, IOCTL_BLOCK_FVM_UPGRADE, upgrade_req_t);
 
+typedef struct {
+    uint64_t lookups;      // Total number of vslice-to-pslice translations.
+    uint64_t fast_lookups; // Translations served by the flat translation array.
+} fvm_translation_stats_t;
+
+// ssize_t ioctl_block_fvm_translation_stats(int fd, bool clear, fvm_translation_stats_t* out);
+IOCTL_WRAPPER_INOUT(ioctl_block_fvm_translation_stats, IOCTL_BLOCK_FVM_TRANSLATION_STATS,
+                    bool, fvm_translation_stats_t);
+
 // ssize_t ioctl_block_get_stats(int fd, bool clear, block_stats_t* out)
 IOCTL_WRAPPER_INOUT(ioctl_block_get_stats, IOCTL_BLOCK_GET_STATS, bool, block_stats_t);
 
+typedef struct {
+    size_t total_reads;      // Read ops accepted by the scheduler
+    size_t total_writes;     // Write ops accepted by the scheduler
+    size_t total_other;      // Flush and barrier ops accepted
+    size_t merged_ops;       // Ops absorbed into an adjacent queued op
+    size_t expedited_writes; // Writes dispatched ahead of queued reads,
+                             // due to deadline expiry or read batching
+    size_t max_queued;       // High watermark of queued ops
+} block_sched_stats_t;
+
+// ssize_t ioctl_block_get_sched_stats(int fd, bool clear, block_sched_stats_t* out)
+IOCTL_WRAPPER_INOUT(ioctl_block_get_sched_stats, IOCTL_BLOCK_GET_SCHED_STATS,
+                    bool, block_sched_stats_t);
+
 // Multiple Block IO operations may be sent at once before a response is actually sent back.
 // Block IO ops may be sent concurrently to different vmoids, and they also may be sent
 // to different groups at any point in time.
@@ -24,6 +24,8 @@
     IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_RAMDISK, 5)
 #define IOCTL_RAMDISK_GET_BLK_COUNTS \
     IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_RAMDISK, 6)
+#define IOCTL_RAMDISK_GET_VMO \
+    IOCTL(IOCTL_KIND_GET_HANDLE, IOCTL_FAMILY_RAMDISK, 7)
 
 // Ramdisk-specific flags
 #define RAMDISK_FLAG_RESUME_ON_WAKE 0xFF000001
@@ -81,3 +83,11 @@ IOCTL_WRAPPER_IN(ioctl_ramdisk_sleep_after, IOCTL_RAMDISK_SLEEP_AFTER, uint64_t)
 // Retrieve the number of received, successful, and failed block writes since the last call to
 // sleep/wake.
 IOCTL_WRAPPER_OUT(ioctl_ramdisk_get_blk_counts, IOCTL_RAMDISK_GET_BLK_COUNTS, ramdisk_blk_counts_t);
+
+// ssize_t ioctl_ramdisk_get_vmo(int fd, zx_handle_t* out);
+// Retrieve a read/write handle to the VMO backing the ramdisk, so that
+// clients (tests, benchmarks) can map the disk contents directly instead of
+// copying every block through the block FIFO. The handle cannot resize the
+// VMO. Writes made through the handle are immediately visible to block reads
+// and vice versa; there is no cache to synchronize.
+IOCTL_WRAPPER_OUT(ioctl_ramdisk_get_vmo, IOCTL_RAMDISK_GET_VMO, zx_handle_t);
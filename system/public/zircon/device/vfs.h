@@ -74,6 +74,16 @@
 #define IOCTL_VFS_GET_DEVICE_PATH \
     IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_VFS, 9)
 
+// Keep the file's data resident in the filesystem's in-memory cache (if the
+// filesystem maintains one), exempt from eviction, until it is unpinned.
+// Returns ZX_ERR_NOT_SUPPORTED if the filesystem does not cache file data.
+#define IOCTL_VFS_PIN_CACHE \
+    IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_VFS, 10)
+
+// Make the file's cached data eligible for eviction again.
+#define IOCTL_VFS_UNPIN_CACHE \
+    IOCTL(IOCTL_KIND_DEFAULT, IOCTL_FAMILY_VFS, 11)
+
 typedef struct {
     zx_handle_t channel; // Channel to which watch events will be sent
     uint32_t mask;       // Bitmask of desired events (1 << WATCH_EVT_*)
@@ -159,6 +169,12 @@ IOCTL_WRAPPER_IN(ioctl_vfs_watch_dir, IOCTL_VFS_WATCH_DIR, vfs_watch_dir_t);
 // ssize_t ioctl_vfs_get_device_path(int fd, char* out, size_t out_len);
 IOCTL_WRAPPER_VAROUT(ioctl_vfs_get_device_path, IOCTL_VFS_GET_DEVICE_PATH, char);
 
+// ssize_t ioctl_vfs_pin_cache(int fd);
+IOCTL_WRAPPER(ioctl_vfs_pin_cache, IOCTL_VFS_PIN_CACHE);
+
+// ssize_t ioctl_vfs_unpin_cache(int fd);
+IOCTL_WRAPPER(ioctl_vfs_unpin_cache, IOCTL_VFS_UNPIN_CACHE);
+
 #define MOUNT_MKDIR_FLAG_REPLACE 1
 
 typedef struct mount_mkdir_config {
@@ -0,0 +1,42 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stdint.h>
+#include <zircon/compiler.h>
+
+__BEGIN_CDECLS
+
+// Layout of the "counters" VMO in which the kernel periodically publishes
+// aggregated values of its kcounters.  The VMO is handed to userboot as a
+// PA_VMO_KERNEL_FILE, so devmgr exposes it as /boot/kernel/counters; a
+// telemetry agent can map it read-only and sample the counters without
+// making any syscalls.
+//
+// The header sits at offset zero.  |names_offset| points at the counter
+// names, packed as consecutive NUL-terminated strings in the same (sorted)
+// order as the values array.  |values_offset| points at an array of
+// |num_counters| int64_t values, each the sum of that counter across all
+// cpus as of |update_time|.
+//
+// Readers must use the sequence number to get a consistent snapshot:
+// read |sequence|, retry if it is odd, copy the values, then re-read
+// |sequence| and retry if it changed.
+typedef struct kcounters_vmo_header {
+    uint64_t magic;          // KCOUNTERS_MAGIC
+    uint64_t sequence;       // odd while the kernel is mid-update
+    uint64_t num_counters;
+    uint64_t period_ms;      // publication period; 0 if updates are disabled
+    uint64_t update_time;    // ZX_CLOCK_MONOTONIC time of the last update
+    uint64_t names_offset;
+    uint64_t names_size;
+    uint64_t values_offset;
+} kcounters_vmo_header_t;
+
+#define KCOUNTERS_MAGIC ((uint64_t)0x7372746e756f636bULL) // 'kcountrs'
+
+#define KCOUNTERS_VMO_NAME "counters"
+
+__END_CDECLS
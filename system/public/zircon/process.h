@@ -30,6 +30,27 @@ zx_handle_t zx_vmar_root_self(void);
 zx_handle_t _zx_job_default(void);
 zx_handle_t zx_job_default(void);
 
+// Self-information about this process, filled in by the process creator
+// and delivered in a read-only VMO of type PA_VMO_PROCESS_INFO (see
+// <zircon/processargs.h>).  Everything here is knowable via
+// zx_object_get_info(), but reading it from the mapped page costs no
+// syscalls.
+#define ZX_PROC_INFO_MAGIC   ((uint32_t)0x50524f43u) // 'PROC'
+#define ZX_PROC_INFO_VERSION ((uint32_t)1u)
+
+typedef struct zx_proc_info {
+    uint32_t magic;        // ZX_PROC_INFO_MAGIC
+    uint32_t version;      // ZX_PROC_INFO_VERSION
+    zx_koid_t koid;        // koid of this process
+    zx_koid_t job_koid;    // koid of the job this process was created under
+    zx_time_t start_time;  // ZX_CLOCK_MONOTONIC time just before process start
+} zx_proc_info_t;
+
+// Returns the self-information page provided at process startup, or NULL
+// if the process creator did not provide one.
+const zx_proc_info_t* _zx_process_self_info(void);
+const zx_proc_info_t* zx_process_self_info(void);
+
 __END_CDECLS
 
 #endif // ZIRCON_PROCESS_H_
@@ -116,6 +116,14 @@ struct zx_proc_args {
 // VM object handle for the main executable file
 #define PA_VMO_EXECUTABLE        0x14u
 
+// Handle to a read-only VMO holding a zx_proc_info_t (see
+// <zircon/process.h>) describing the new process.  The creator warrants
+// that the whole structure was written before the process started, so
+// the new process can map it and answer self-info queries (koid, start
+// time) with no syscalls at all.  This handle is optional: runtimes must
+// fall back to zx_object_get_info() when it is not provided.
+#define PA_VMO_PROCESS_INFO      0x15u
+
 // Used by kernel and userboot during startup
 #define PA_VMO_BOOTDATA          0x1Au
 
@@ -33,6 +33,8 @@ typedef enum {
     ZX_INFO_HANDLE_COUNT               = 19, // zx_info_handle_count_t[1]
     ZX_INFO_BTI                        = 20, // zx_info_bti_t[1]
     ZX_INFO_PROCESS_HANDLE_STATS       = 21, // zx_info_process_handle_stats_t[1]
+    ZX_INFO_JOB_STATS                  = 22, // zx_info_job_stats_t[1]
+    ZX_INFO_JOB_MEMORY                 = 23, // zx_info_job_memory_t[1]
     ZX_INFO_LAST
 } zx_object_info_topic_t;
 
@@ -136,6 +138,35 @@ typedef struct zx_info_task_stats {
     size_t mem_scaled_shared_bytes;
 } zx_info_task_stats_t;
 
+// Aggregate counters over a job's entire subtree. Unlike ZX_INFO_TASK_STATS
+// these are maintained on the task/handle lifecycle paths, so reading them is
+// cheap: the kernel does not walk the job tree or any handle tables.
+typedef struct zx_info_job_stats {
+    // Number of handles owned by processes in the subtree. Handles in
+    // transit in channel messages are not counted.
+    uint64_t handle_count;
+
+    // Number of living processes in the subtree.
+    uint64_t process_count;
+
+    // Number of living jobs in the subtree, not counting the queried job.
+    uint64_t job_count;
+} zx_info_job_stats_t;
+
+// Committed memory attributed to a job's entire subtree. The counter is
+// maintained on the VMO commit/decommit paths and rolled up through the
+// job tree, so reading it is a pair of atomic loads — suitable for
+// high-frequency polling. Pages are attributed to the job of the process
+// that created the VMO; pages committed to VMOs that no longer have a
+// live handle dispatcher are not counted.
+typedef struct zx_info_job_memory {
+    // Number of committed pages attributed to the subtree.
+    uint64_t committed_pages;
+
+    // The same, in bytes.
+    uint64_t committed_bytes;
+} zx_info_job_memory_t;
+
 typedef struct zx_info_vmar {
     // Base address of the region.
     uintptr_t base;
@@ -386,6 +417,13 @@ typedef struct zx_info_resource {
 #define ZX_PROP_SOCKET_TX_BUF_MAX           10u
 #define ZX_PROP_SOCKET_TX_BUF_SIZE          11u
 
+// Argument is a size_t. While nonzero, ZX_SOCKET_WRITE_THRESHOLD is
+// asserted on this endpoint only when at least that many bytes of free
+// space are available in its transmit buffer, so a writer of fixed-size
+// bursts can wait for a full burst to fit instead of looping on short
+// writes. Zero (the default) leaves the signal deasserted.
+#define ZX_PROP_SOCKET_TX_BUF_THRESHOLD     13u
+
 // Argument is a size_t, describing the number of packets a channel
 // endpoint can have pending in its tx direction.
 #define ZX_PROP_CHANNEL_TX_MSG_MAX          12u
@@ -26,6 +26,7 @@ __BEGIN_CDECLS
 #define ZX_PKT_TYPE_GUEST_VCPU      ((uint8_t)0x06u)
 #define ZX_PKT_TYPE_INTERRUPT       ((uint8_t)0x07u)
 #define ZX_PKT_TYPE_EXCEPTION(n)    ((uint32_t)(0x08u | (((n) & 0xFFu) << 8)))
+#define ZX_PKT_TYPE_CHANNEL_CALL    ((uint8_t)0x09u)
 
 // For options passed to port_create
 #define ZX_PORT_BIND_TO_INTERRUPT   ((uint32_t)(0x1u << 0))
@@ -41,6 +42,7 @@ __BEGIN_CDECLS
 #define ZX_PKT_IS_GUEST_VCPU(type)  ((type) == ZX_PKT_TYPE_GUEST_VCPU)
 #define ZX_PKT_IS_INTERRUPT(type)   ((type) == ZX_PKT_TYPE_INTERRUPT)
 #define ZX_PKT_IS_EXCEPTION(type)   (((type) & ZX_PKT_TYPE_MASK) == ZX_PKT_TYPE_EXCEPTION(0))
+#define ZX_PKT_IS_CHANNEL_CALL(type) ((type) == ZX_PKT_TYPE_CHANNEL_CALL)
 
 // zx_packet_guest_vcpu_t::type
 #define ZX_PKT_GUEST_VCPU_INTERRUPT  ((uint8_t)0)
@@ -127,8 +129,29 @@ typedef struct zx_packet_guest_vcpu {
     uint64_t reserved;
 } zx_packet_guest_vcpu_t;
 
+// port_packet_t::type ZX_PKT_TYPE_CHANNEL_CALL. Completion of an async
+// channel call made with zx_channel_call_async(); the reply message itself
+// is delivered to the channel's message queue and read with
+// zx_channel_read(). The packet's status field is ZX_OK when a reply with
+// this txid arrived, ZX_ERR_PEER_CLOSED or ZX_ERR_CANCELED when the call
+// was aborted.
+typedef struct zx_packet_channel_call {
+    zx_txid_t txid;
+    uint32_t actual_bytes;
+    uint32_t actual_handles;
+    uint32_t reserved0;
+    uint64_t reserved1;
+    uint64_t reserved2;
+} zx_packet_channel_call_t;
+
 typedef struct zx_packet_interrupt {
     zx_time_t timestamp;
+    // Number of interrupts this packet accounts for. Always 1 unless the
+    // interrupt was bound with ZX_INTERRUPT_BIND_COALESCE, in which case
+    // interrupts that fire before the previous packet is acknowledged are
+    // folded into the next packet and |timestamp| is that of the most
+    // recent one.
+    uint64_t count;
 } zx_packet_interrupt_t;
 
 typedef struct zx_port_packet {
@@ -143,6 +166,7 @@ typedef struct zx_port_packet {
         zx_packet_guest_mem_t guest_mem;
         zx_packet_guest_io_t guest_io;
         zx_packet_guest_vcpu_t guest_vcpu;
+        zx_packet_channel_call_t channel_call;
         zx_packet_interrupt_t interrupt;
     };
 } zx_port_packet_t;
@@ -12,6 +12,7 @@ __BEGIN_CDECLS
 // clang-format off
 
 #define ZX_PROFILE_INFO_SCHEDULER   1
+#define ZX_PROFILE_INFO_DEADLINE    2
 
 typedef struct zx_profile_scheduler {
     int32_t priority;
@@ -20,6 +21,15 @@ typedef struct zx_profile_scheduler {
     uint32_t quantum;
 } zx_profile_scheduler_t;
 
+// deadline scheduling parameters: the thread is granted |capacity| of run time
+// within every |period|, and must receive it before |deadline| elapses within
+// the period. requires 0 < capacity <= deadline <= period.
+typedef struct zx_profile_deadline {
+    zx_duration_t capacity;
+    zx_duration_t deadline;
+    zx_duration_t period;
+} zx_profile_deadline_t;
+
 #define ZX_PRIORITY_LOWEST              0
 #define ZX_PRIORITY_LOW                 8
 #define ZX_PRIORITY_DEFAULT             16
@@ -30,6 +40,7 @@ typedef struct zx_profile_info {
     uint32_t type;                  // one of ZX_PROFILE_INFO_
     union {
         zx_profile_scheduler_t scheduler;
+        zx_profile_deadline_t deadline;
     };
 } zx_profile_info_t;
 
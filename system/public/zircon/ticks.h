@@ -0,0 +1,40 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <zircon/compiler.h>
+#include <zircon/types.h>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+__BEGIN_CDECLS
+
+// Read the same hardware counter zx_ticks_get() reads, without leaving the
+// caller's function: this compiles to a bare counter read (rdtsc on x86-64,
+// cntvct_el0 on arm64) rather than a call into the vDSO, which matters for
+// very hot instrumentation paths such as tracing macros.
+//
+// Caveat: on systems where the tick counter could not be calibrated at boot
+// (or "vdso.soft_ticks" is set), the kernel redirects zx_ticks_get() to a
+// software clock and the values returned here will not match it. Code that
+// must interoperate with such configurations should call zx_ticks_get()
+// instead.
+static inline zx_ticks_t zx_ticks_get_inline(void) {
+#if defined(__aarch64__)
+    zx_ticks_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#elif defined(__x86_64__)
+    return __rdtsc();
+#else
+#error Unsupported architecture
+#endif
+}
+
+__END_CDECLS
@@ -133,6 +133,7 @@ typedef uint32_t zx_signals_t;
 #define ZX_SOCKET_CONTROL_WRITABLE  __ZX_OBJECT_SIGNAL_7
 #define ZX_SOCKET_ACCEPT            __ZX_OBJECT_SIGNAL_8
 #define ZX_SOCKET_SHARE             __ZX_OBJECT_SIGNAL_9
+#define ZX_SOCKET_WRITE_THRESHOLD   __ZX_OBJECT_SIGNAL_10
 
 // Fifo
 #define ZX_FIFO_READABLE            __ZX_OBJECT_READABLE
@@ -164,6 +165,20 @@ typedef uint32_t zx_signals_t;
 // VMO
 #define ZX_VMO_ZERO_CHILDREN        __ZX_OBJECT_SIGNALED
 
+// Signals asserted on the memory pressure event returned by
+// zx_system_get_event(..., ZX_SYSTEM_EVENT_MEMORY_PRESSURE).  The signals
+// are cumulative: each level's signal remains asserted at any more severe
+// level.
+#define ZX_EVENT_MEMORY_PRESSURE_WARNING  ZX_USER_SIGNAL_0
+#define ZX_EVENT_MEMORY_PRESSURE_CRITICAL ZX_USER_SIGNAL_1
+#define ZX_EVENT_MEMORY_PRESSURE_OOM      ZX_USER_SIGNAL_2
+
+// zx_system_get_event() kinds
+#define ZX_SYSTEM_EVENT_MEMORY_PRESSURE   ((uint32_t)1u)
+// Asserted when an asynchronous commit started with ZX_VMO_OP_COMMIT_ASYNC
+// finishes; cleared when a new one starts.
+#define ZX_VMO_COMMIT_COMPLETE      __ZX_OBJECT_SIGNAL_4
+
 // global kernel object id.
 typedef uint64_t zx_koid_t;
 #define ZX_KOID_INVALID ((uint64_t) 0)
@@ -194,6 +209,26 @@ typedef struct zx_wait_item {
     zx_signals_t pending;
 } zx_wait_item_t;
 
+// Maximum number of items allowed for zx_object_signal_batch()
+#define ZX_SIGNAL_BATCH_MAX_ITEMS ((size_t)64)
+
+// Structure for zx_object_signal_batch():
+typedef struct zx_signal_item {
+    zx_handle_t handle;
+    zx_signals_t clear_mask;
+    zx_signals_t set_mask;
+} zx_signal_item_t;
+
+// Maximum number of results reported by one zx_waitset_wait() call.
+#define ZX_WAITSET_MAX_RESULTS ((uint32_t)32)
+
+// One ready entry reported by zx_waitset_wait().
+typedef struct zx_waitset_result {
+    uint64_t key;
+    zx_status_t status;
+    zx_signals_t observed;
+} zx_waitset_result_t;
+
 typedef uint32_t zx_rights_t;
 #define ZX_RIGHT_NONE             ((zx_rights_t)0u)
 #define ZX_RIGHT_DUPLICATE        ((zx_rights_t)1u << 0)
@@ -232,8 +267,22 @@ typedef uint32_t zx_rights_t;
 #define ZX_RIGHTS_POLICY \
     (ZX_RIGHT_GET_POLICY | ZX_RIGHT_SET_POLICY)
 
+// Maximum number of operations in one zx_handle_duplicate_many() or
+// zx_handle_replace_many() call.
+#define ZX_HANDLE_OP_MAX_ITEMS ((size_t)64)
+
+// One operation for zx_handle_duplicate_many()/zx_handle_replace_many():
+typedef struct zx_handle_op {
+    zx_handle_t handle;   // in: the handle to operate on
+    zx_rights_t rights;   // in: rights for the resulting handle
+    zx_handle_t result;   // out: the new handle
+} zx_handle_op_t;
+
 // VM Object creation options
 #define ZX_VMO_NON_RESIZABLE             ((uint32_t)1u)
+// Keep the object's page allocations on the NUMA node of the cpu that
+// created it, where possible.
+#define ZX_VMO_NODE_AFFINE               ((uint32_t)2u)
 
 // VM Object opcodes
 #define ZX_VMO_OP_COMMIT                 ((uint32_t)1u)
@@ -245,6 +294,7 @@ typedef uint32_t zx_rights_t;
 #define ZX_VMO_OP_CACHE_INVALIDATE       ((uint32_t)7u)
 #define ZX_VMO_OP_CACHE_CLEAN            ((uint32_t)8u)
 #define ZX_VMO_OP_CACHE_CLEAN_INVALIDATE ((uint32_t)9u)
+#define ZX_VMO_OP_COMMIT_ASYNC           ((uint32_t)10u)
 
 // VM Object clone flags
 #define ZX_VMO_CLONE_COPY_ON_WRITE        ((uint32_t)1u << 0)
@@ -297,6 +347,9 @@ typedef uint64_t zx_off_t;
 #define ZX_INTERRUPT_MODE_MASK       ((uint32_t)0xe)
 #define ZX_INTERRUPT_VIRTUAL         ((uint32_t)0x10)
 
+// Options for zx_interrupt_bind
+#define ZX_INTERRUPT_BIND_COALESCE   ((uint32_t)0x1u)
+
 // Preallocated virtual interrupt slot, typically used for signaling interrupt threads to exit.
 #define ZX_INTERRUPT_SLOT_USER              ((uint32_t)62u)
 // interrupt wait slots must be in the range 0 - 62 inclusive
@@ -310,6 +363,15 @@ typedef uint64_t zx_off_t;
 
 #define ZX_CHANNEL_MAX_MSG_BYTES            ((uint32_t)65536u)
 #define ZX_CHANNEL_MAX_MSG_HANDLES          ((uint32_t)64u)
+#define ZX_CHANNEL_MAX_MSG_IOVECS           ((uint32_t)16u)
+
+// Scatter-gather entry for zx_channel_writev(). The segments are
+// concatenated in order to form the message payload.
+typedef struct zx_channel_iovec {
+    const void* buffer;
+    uint32_t capacity;
+    uint32_t reserved;
+} zx_channel_iovec_t;
 
 // Socket options and limits.
 // These options can be passed to zx_socket_write()
@@ -377,7 +439,8 @@ typedef uint32_t zx_obj_type_t;
 #define ZX_OBJ_TYPE_PROFILE         ((zx_obj_type_t)25u)
 #define ZX_OBJ_TYPE_PMT             ((zx_obj_type_t)26u)
 #define ZX_OBJ_TYPE_SUSPEND_TOKEN   ((zx_obj_type_t)27u)
-#define ZX_OBJ_TYPE_LAST            ((zx_obj_type_t)28u)
+#define ZX_OBJ_TYPE_WAIT_SET        ((zx_obj_type_t)28u)
+#define ZX_OBJ_TYPE_LAST            ((zx_obj_type_t)29u)
 
 typedef struct zx_handle_info {
     zx_handle_t handle;
@@ -118,6 +118,10 @@ fail:
     return ZX_ERR_INTERNAL;
 }
 
+// Number of slots used to match request ids with their issue timestamps.  Must
+// be a power of two larger than the maximum number of outstanding requests.
+#define LATENCY_SLOTS 256
+
 typedef struct {
     blkdev_t* blk;
     size_t count;
@@ -129,6 +133,13 @@ typedef struct {
 
     fbl::atomic<int> pending;
     sync_completion_t signal;
+
+    // When non-null, per-request latencies are recorded here (count entries).
+    // issue_ts holds the issue time of each in-flight request, indexed by
+    // reqid % LATENCY_SLOTS.
+    uint64_t* latencies;
+    size_t latency_count;
+    zx_time_t issue_ts[LATENCY_SLOTS];
 } bio_random_args_t;
 
 static fbl::atomic<reqid_t> next_reqid(0);
@@ -180,6 +191,9 @@ static int bio_random_thread(void* arg) {
         fprintf(stderr, "IO tid=%u vid=%u op=%x len=%zu vof=%zu dof=%zu\n",
                 req.reqid, req.vmoid, req.opcode, req.length, req.vmo_offset, req.dev_offset);
 #endif
+        if (a->latencies) {
+            a->issue_ts[req.reqid % LATENCY_SLOTS] = zx_clock_get_monotonic();
+        }
         zx_status_t r = zx_fifo_write(fifo, sizeof(req), &req, 1, NULL);
         if (r == ZX_ERR_SHOULD_WAIT) {
             r = zx_object_wait_one(fifo, ZX_FIFO_WRITABLE | ZX_FIFO_PEER_CLOSED,
@@ -235,6 +249,11 @@ static zx_status_t bio_random(bio_random_args_t* a, uint64_t* _total, zx_duratio
             goto fail;
         }
         count--;
+        if (a->latencies) {
+            zx_time_t issued = a->issue_ts[resp.reqid % LATENCY_SLOTS];
+            a->latencies[a->latency_count++] =
+                zx_time_sub_time(zx_clock_get_monotonic(), issued);
+        }
         if (a->pending.fetch_sub(1) == a->max_pending) {
             sync_completion_signal(&a->signal);
         }
@@ -256,6 +275,104 @@ fail:
     return ZX_ERR_IO;
 }
 
+static int compare_u64(const void* pa, const void* pb) {
+    uint64_t a = *static_cast<const uint64_t*>(pa);
+    uint64_t b = *static_cast<const uint64_t*>(pb);
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static uint64_t percentile(const uint64_t* sorted, size_t n, int p) {
+    return (n == 0) ? 0 : sorted[(n - 1) * p / 100];
+}
+
+// Runs one cell of a sweep and appends its throughput and latency percentiles
+// to |results|.  Returns false if the I/O engine failed (which closes the
+// fifo, so the sweep cannot continue).
+static bool sweep_one(blkdev_t* blk, bool write, bool linear, size_t xfer, int depth,
+                      size_t total, perftest::ResultsSet* results) {
+    bio_random_args_t a = {};
+    a.blk = blk;
+    a.xfer = xfer;
+    a.seed = 7891263897612ULL;
+    a.max_pending = depth;
+    a.write = write;
+    a.linear = linear;
+    a.count = total / xfer;
+
+    a.latencies = static_cast<uint64_t*>(malloc(a.count * sizeof(uint64_t)));
+    if (!a.latencies) {
+        fprintf(stderr, "error: out of memory\n");
+        return false;
+    }
+
+    uint64_t bytes = 0;
+    zx_duration_t res = 0;
+    if (bio_random(&a, &bytes, &res) != ZX_OK) {
+        free(a.latencies);
+        return false;
+    }
+
+    qsort(a.latencies, a.latency_count, sizeof(uint64_t), compare_u64);
+    uint64_t p50 = percentile(a.latencies, a.latency_count, 50);
+    uint64_t p95 = percentile(a.latencies, a.latency_count, 95);
+    uint64_t p99 = percentile(a.latencies, a.latency_count, 99);
+    double throughput = static_cast<double>(bytes) / (static_cast<double>(res) / 1e9);
+
+    const char* op = write ? "write" : "read";
+    fprintf(stderr, "%s bs=%zu qd=%d: ", op, xfer, depth);
+    bytes_per_second(bytes, res);
+    fprintf(stderr, "  latency p50=%zu p95=%zu p99=%zu ns\n", p50, p95, p99);
+
+    char name[64];
+    snprintf(name, sizeof(name), "BlockDeviceSweep/%s/%zubytes/qd%d/throughput", op, xfer, depth);
+    results->AddTestCase("fuchsia.zircon", name, "bytes/second")->AppendValue(throughput);
+    struct {
+        const char* suffix;
+        uint64_t value;
+    } latencies[] = {
+        {"latency_p50", p50},
+        {"latency_p95", p95},
+        {"latency_p99", p99},
+    };
+    for (const auto& lat : latencies) {
+        snprintf(name, sizeof(name), "BlockDeviceSweep/%s/%zubytes/qd%d/%s", op, xfer, depth,
+                 lat.suffix);
+        results->AddTestCase("fuchsia.zircon", name, "nanoseconds")
+            ->AppendValue(static_cast<double>(lat.value));
+    }
+
+    free(a.latencies);
+    return true;
+}
+
+// Characterizes the device across a matrix of queue depths, block sizes, and
+// read/write, all over the one fifo connection.  |total| bounds the bytes
+// transferred per cell.
+static int run_sweep(blkdev_t* blk, bool include_write, bool linear, size_t total,
+                     const char* output_file) {
+    static const size_t kXfers[] = {4096, 32768, 131072};
+    static const int kDepths[] = {1, 4, 16, 64, 128};
+
+    perftest::ResultsSet results;
+    for (int op = 0; op < (include_write ? 2 : 1); op++) {
+        for (size_t xfer : kXfers) {
+            if (xfer > blk->bufsz || total < xfer) {
+                continue;
+            }
+            for (int depth : kDepths) {
+                if (!sweep_one(blk, op == 1, linear, xfer, depth, total, &results)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    if (output_file && !results.WriteJSONFile(output_file)) {
+        return 1;
+    }
+    return 0;
+}
+
 void usage(void) {
     fprintf(stderr, "usage: biotime <option>* <device>\n"
                     "\n"
@@ -267,6 +384,10 @@ void usage(void) {
                     "       -live-dangerously  required if using \"-write\"\n"
                     "       -linear       transfers in linear order (default)\n"
                     "       -random       random transfers across total range\n"
+                    "       -sweep        sweep queue depth and block size in one run,\n"
+                    "                     reporting throughput and latency percentiles per\n"
+                    "                     configuration (add \"-write\" to cover writes too;\n"
+                    "                     \"-tt\" bounds the bytes transferred per cell)\n"
                     "       -output-file <filename>  destination file for "
                     "writing results in JSON format\n"
                     );
@@ -292,6 +413,7 @@ int main(int argc, char** argv) {
     a.max_pending = 128;
     a.write = false;
     a.linear = true;
+    bool sweep = false;
     const char* output_file = nullptr;
 
     size_t total = 0;
@@ -327,6 +449,8 @@ int main(int argc, char** argv) {
             a.linear = true;
         } else if (!strcmp(argv[0], "-random")) {
             a.linear = false;
+        } else if (!strcmp(argv[0], "-sweep")) {
+            sweep = true;
         } else if (!strcmp(argv[0], "-output-file")) {
             needparam();
             output_file = argv[0];
@@ -361,6 +485,15 @@ int main(int argc, char** argv) {
 
     size_t devtotal = blk.info.block_count * blk.info.block_size;
 
+    if (sweep) {
+        // Bound the bytes transferred per cell so a full sweep stays quick.
+        size_t per_cell = total ? total : 32 * 1024 * 1024;
+        if (per_cell > devtotal) {
+            per_cell = devtotal;
+        }
+        return run_sweep(&blk, a.write, a.linear, per_cell, output_file);
+    }
+
     // default to entire device
     if ((total == 0) || (total > devtotal)) {
         total = devtotal;
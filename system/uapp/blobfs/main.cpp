@@ -97,9 +97,10 @@ int usage() {
     fprintf(stderr,
             "usage: blobfs [ <options>* ] <command> [ <arg>* ]\n"
             "\n"
-            "options: -r|--readonly  Mount filesystem read-only\n"
-            "         -m|--metrics   Collect filesystem metrics\n"
-            "         -h|--help      Display this message\n"
+            "options: -r|--readonly        Mount filesystem read-only\n"
+            "         -m|--metrics         Collect filesystem metrics\n"
+            "         -c|--cachesize SIZE  Set the closed blob cache budget, in bytes\n"
+            "         -h|--help            Display this message\n"
             "\n"
             "On Fuchsia, blobfs takes the block device argument by handle.\n"
             "This can make 'blobfs' commands hard to invoke from command line.\n"
@@ -119,11 +120,12 @@ int process_args(int argc, char** argv, CommandFunction* func, blobfs::blob_opti
         static struct option opts[] = {
             {"readonly", no_argument, nullptr, 'r'},
             {"metrics", no_argument, nullptr, 'm'},
+            {"cachesize", required_argument, nullptr, 'c'},
             {"help", no_argument, nullptr, 'h'},
             {nullptr, 0, nullptr, 0},
         };
         int opt_index;
-        int c = getopt_long(argc, argv, "rmh", opts, &opt_index);
+        int c = getopt_long(argc, argv, "rmc:h", opts, &opt_index);
         if (c < 0) {
             break;
         }
@@ -134,6 +136,9 @@ int process_args(int argc, char** argv, CommandFunction* func, blobfs::blob_opti
         case 'm':
             options->metrics = true;
             break;
+        case 'c':
+            options->cache_size = strtoull(optarg, nullptr, 0);
+            break;
         case 'h':
         default:
             return usage();
@@ -22,6 +22,7 @@
 #include <fvm/fvm-sparse.h>
 #include <lib/cksum.h>
 #include <lib/fzl/mapped-vmo.h>
+#include <lib/sync/completion.h>
 #include <lib/zx/fifo.h>
 #include <lib/zx/vmo.h>
 #include <zircon/boot/image.h>
@@ -100,12 +101,106 @@ zx_status_t RegisterFastBlockIo(const fbl::unique_fd& fd, zx_handle_t vmo,
     return block_client::Client::Create(fbl::move(fifo), client_out);
 }
 
+// Runs a partition stream as a two-stage pipeline: while the block server
+// drains one half of the VMO, the next chunk of payload is received and
+// decompressed into the other half. Streaming then takes roughly
+// max(source, disk) time rather than their sum.
+class PipelinedWriter {
+public:
+    PipelinedWriter(const block_client::Client& client, fzl::MappedVmo* mvmo,
+                    const block_fifo_request_t& request, size_t block_size)
+        : client_(client), mvmo_(mvmo), request_(request), block_size_(block_size),
+          half_size_(mvmo->GetSize() / 2) {
+        ZX_DEBUG_ASSERT(half_size_ % block_size == 0);
+        for (auto& buf : bufs_) {
+            sync_completion_signal(&buf.done);
+        }
+    }
+
+    // Don't let in-flight writes outlive the VMO they source from.
+    ~PipelinedWriter() {
+        Flush();
+    }
+
+    // Returns the half of the VMO with no write in flight, waiting for one
+    // to retire if necessary. Fails if an earlier queued write failed.
+    zx_status_t GetBuffer(void** out_data, size_t* out_capacity) {
+        Buffer* buf = &bufs_[current_];
+        sync_completion_wait(&buf->done, ZX_TIME_INFINITE);
+        if (buf->status != ZX_OK) {
+            return buf->status;
+        }
+        *out_data = &reinterpret_cast<uint8_t*>(mvmo_->GetData())[current_ * half_size_];
+        *out_capacity = half_size_;
+        return ZX_OK;
+    }
+
+    // Queues a write of the first |vmo_sz| bytes of the buffer returned by
+    // the last GetBuffer() to byte offset |dev_offset|, without waiting for
+    // it to complete.
+    zx_status_t Write(size_t vmo_sz, size_t dev_offset) {
+        uint64_t length = vmo_sz / block_size_;
+        if (length > UINT32_MAX) {
+            return ZX_ERR_OUT_OF_RANGE;
+        }
+        Buffer* buf = &bufs_[current_];
+        block_fifo_request_t request = request_;
+        request.group = static_cast<groupid_t>(current_);
+        request.length = static_cast<uint32_t>(length);
+        request.vmo_offset = (current_ * half_size_) / block_size_;
+        request.dev_offset = dev_offset / block_size_;
+
+        sync_completion_reset(&buf->done);
+        zx_status_t status = client_.TransactionAsync(&request, 1, WriteComplete, buf);
+        if (status != ZX_OK) {
+            sync_completion_signal(&buf->done);
+            return status;
+        }
+        current_ ^= 1;
+        return ZX_OK;
+    }
+
+    // Waits for every queued write to retire; returns the first failure.
+    zx_status_t Flush() {
+        zx_status_t status = ZX_OK;
+        for (auto& buf : bufs_) {
+            sync_completion_wait(&buf.done, ZX_TIME_INFINITE);
+            if (status == ZX_OK) {
+                status = buf.status;
+            }
+        }
+        return status;
+    }
+
+private:
+    struct Buffer {
+        sync_completion_t done;
+        zx_status_t status = ZX_OK;
+    };
+
+    // Runs on the client's response reader thread; just records the result.
+    static void WriteComplete(void* cookie, zx_status_t status) {
+        auto* buf = static_cast<Buffer*>(cookie);
+        buf->status = status;
+        sync_completion_signal(&buf->done);
+    }
+
+    const block_client::Client& client_;
+    fzl::MappedVmo* mvmo_;
+    const block_fifo_request_t request_;
+    const size_t block_size_;
+    const size_t half_size_;
+
+    Buffer bufs_[2];
+    unsigned current_ = 0;
+};
+
 // Stream an FVM partition to disk.
 zx_status_t StreamFvmPartition(fvm::SparseReader* reader, PartitionInfo* part,
                                fzl::MappedVmo* mvmo, const block_client::Client& client,
                                size_t block_size, block_fifo_request_t* request) {
     size_t slice_size = reader->Image()->slice_size;
-    const size_t vmo_cap = mvmo->GetSize();
+    PipelinedWriter writer(client, mvmo, *request, block_size);
     for (size_t e = 0; e < part->pd->extent_count; e++) {
         LOG("Writing extent %zu... \n", e);
         fvm::extent_descriptor_t* ext = GetExtent(part->pd, e);
@@ -114,11 +209,18 @@ zx_status_t StreamFvmPartition(fvm::SparseReader* reader, PartitionInfo* part,
 
         // Write real data
         while (bytes_left > 0) {
+            void* data;
+            size_t vmo_cap;
+            zx_status_t status = writer.GetBuffer(&data, &vmo_cap);
+            if (status != ZX_OK) {
+                ERROR("Error writing partition data\n");
+                return status;
+            }
+
             size_t vmo_sz = 0;
             size_t actual;
-            zx_status_t status = reader->ReadData(
-                &reinterpret_cast<uint8_t*>(mvmo->GetData())[vmo_sz],
-                fbl::min(bytes_left, vmo_cap - vmo_sz), &actual);
+            status = reader->ReadData(reinterpret_cast<uint8_t*>(data),
+                                      fbl::min(bytes_left, vmo_cap), &actual);
             vmo_sz += actual;
             bytes_left -= actual;
 
@@ -133,19 +235,9 @@ zx_status_t StreamFvmPartition(fvm::SparseReader* reader, PartitionInfo* part,
                 return status;
             }
 
-            uint64_t length = vmo_sz / block_size;
-            if (length > UINT32_MAX) {
-                ERROR("Error writing partition: Too large\n");
-                return ZX_ERR_OUT_OF_RANGE;
-            }
-            request->length = static_cast<uint32_t>(length);
-            request->vmo_offset = 0;
-            request->dev_offset = offset / block_size;
-
-            ssize_t r;
-            if ((r = client.Transaction(request, 1)) != ZX_OK) {
+            if ((status = writer.Write(vmo_sz, offset)) != ZX_OK) {
                 ERROR("Error writing partition data\n");
-                return static_cast<zx_status_t>(r);
+                return status;
             }
 
             offset += vmo_sz;
@@ -156,29 +248,30 @@ zx_status_t StreamFvmPartition(fvm::SparseReader* reader, PartitionInfo* part,
         bytes_left = (ext->slice_count * slice_size) - ext->extent_length;
         if (bytes_left > 0) {
             LOG("%zu bytes written, %zu zeroes left\n", ext->extent_length, bytes_left);
-            memset(mvmo->GetData(), 0, vmo_cap);
         }
         while (bytes_left > 0) {
-            uint64_t length = fbl::min(bytes_left, vmo_cap) / block_size;
-            if (length > UINT32_MAX) {
-                ERROR("Error writing trailing zeroes: Too large\n");
-                return ZX_ERR_OUT_OF_RANGE;
+            void* data;
+            size_t vmo_cap;
+            zx_status_t status = writer.GetBuffer(&data, &vmo_cap);
+            if (status != ZX_OK) {
+                ERROR("Error writing trailing zeroes\n");
+                return status;
             }
-            request->length = static_cast<uint32_t>(length);
-            request->vmo_offset = 0;
-            request->dev_offset = offset / block_size;
 
-            zx_status_t status;
-            if ((status = client.Transaction(request, 1)) != ZX_OK) {
+            // The buffer may still hold payload from an earlier chunk.
+            size_t vmo_sz = fbl::round_down(fbl::min(bytes_left, vmo_cap), block_size);
+            memset(data, 0, vmo_sz);
+
+            if ((status = writer.Write(vmo_sz, offset)) != ZX_OK) {
                 ERROR("Error writing trailing zeroes\n");
                 return status;
             }
 
-            offset += request->length * block_size;
-            bytes_left -= request->length * block_size;
+            offset += vmo_sz;
+            bytes_left -= vmo_sz;
         }
     }
-    return ZX_OK;
+    return writer.Flush();
 }
 
 // Stream a raw (non-FVM) partition to a vmo.
@@ -0,0 +1,215 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/algorithm.h>
+#include <fbl/atomic.h>
+#include <lib/zx/channel.h>
+#include <lib/zx/event.h>
+#include <zircon/status.h>
+#include <zircon/syscalls.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "stress_test.h"
+
+// Channel handle-passing mesh
+//
+// Builds a full mesh of channels between a pool of worker threads. Each
+// iteration a thread writes a small tagged message carrying a duplicated
+// event handle to a random peer, then drains a random one of its own
+// endpoints, validating the tag and closing the received handles. Stresses
+// channel message queues and handle duplication/transfer/teardown under
+// contention.
+//
+// Validates that received messages carry the expected tag and exactly one
+// handle; anything else is a dropped or corrupted message and is reported.
+
+class ChannelStressTest : public StressTest {
+public:
+    ChannelStressTest() = default;
+    virtual ~ChannelStressTest() = default;
+
+    virtual zx_status_t Init(bool verbose, const zx_info_kmem_stats& stats) {
+        zx_status_t status = StressTest::Init(verbose, stats);
+        if (status != ZX_OK) {
+            return status;
+        }
+
+        sent_counter_ = AddCounter("messages_sent");
+        received_counter_ = AddCounter("messages_received");
+        return ZX_OK;
+    }
+
+    virtual zx_status_t Start();
+    virtual zx_status_t Stop();
+
+    virtual const char* name() const { return "Channel Stress"; }
+
+private:
+    static constexpr uint32_t kMaxThreads = 8;
+    static constexpr uint64_t kMessageTag = 0x6b737472657373ULL; // 'kstress'
+
+    struct Message {
+        uint64_t tag;
+        uint32_t sender;
+        uint32_t seq;
+    };
+
+    int stress_thread(uint32_t id);
+    void drain_endpoint(uint32_t id, uint32_t peer);
+
+    uint32_t num_threads_{};
+    thrd_t threads_[kMaxThreads]{};
+
+    // ends_[i][j] is thread i's endpoint of the channel between threads i
+    // and j; a message written there arrives at ends_[j][i]
+    zx::channel ends_[kMaxThreads][kMaxThreads];
+
+    // one event per thread, duplicated into every message it sends
+    zx::event events_[kMaxThreads];
+
+    fbl::atomic<bool> shutdown_{false};
+
+    size_t sent_counter_{};
+    size_t received_counter_{};
+};
+
+// our singleton
+ChannelStressTest channelstress;
+
+void ChannelStressTest::drain_endpoint(uint32_t id, uint32_t peer) {
+    zx_status_t status;
+
+    for (;;) {
+        Message msg;
+        zx_handle_t handles[4];
+        uint32_t actual_bytes, actual_handles;
+        status = ends_[id][peer].read(0, &msg, sizeof(msg), &actual_bytes, handles,
+                                      fbl::count_of(handles), &actual_handles);
+        if (status == ZX_ERR_SHOULD_WAIT) {
+            return;
+        }
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to read channel message, error %d (%s)\n", status,
+                    zx_status_get_string(status));
+            return;
+        }
+
+        if (actual_bytes != sizeof(msg) || msg.tag != kMessageTag || msg.sender != peer ||
+            actual_handles != 1) {
+            fprintf(stderr,
+                    "corrupt channel message: %u bytes, %u handles, tag %" PRIx64 ", sender %u\n",
+                    actual_bytes, actual_handles, msg.tag, msg.sender);
+        }
+        for (uint32_t i = 0; i < actual_handles; i++) {
+            zx_handle_close(handles[i]);
+        }
+
+        CountOp(received_counter_);
+    }
+}
+
+int ChannelStressTest::stress_thread(uint32_t id) {
+    zx_status_t status;
+    uint32_t seq = 0;
+
+    while (!shutdown_.load()) {
+        // pick a random peer and send it a message carrying a duplicate of
+        // our event
+        uint32_t peer = rand() % num_threads_;
+        if (peer == id) {
+            peer = (peer + 1) % num_threads_;
+        }
+
+        zx::event dup;
+        status = events_[id].duplicate(ZX_RIGHT_SAME_RIGHTS, &dup);
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to duplicate event, error %d (%s)\n", status,
+                    zx_status_get_string(status));
+            break;
+        }
+
+        Message msg = {kMessageTag, id, seq++};
+        zx_handle_t handle = dup.release();
+        status = ends_[id][peer].write(0, &msg, sizeof(msg), &handle, 1);
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to write channel message, error %d (%s)\n", status,
+                    zx_status_get_string(status));
+            zx_handle_close(handle);
+            break;
+        }
+        Printf("s");
+        CountOp(sent_counter_);
+
+        // drain whatever a random peer has sent us so queues stay bounded
+        uint32_t victim = rand() % num_threads_;
+        if (victim == id) {
+            victim = (victim + 1) % num_threads_;
+        }
+        drain_endpoint(id, victim);
+    }
+
+    // drain everything outstanding so no handles leak through the queues
+    for (uint32_t peer = 0; peer < num_threads_; peer++) {
+        if (peer != id) {
+            drain_endpoint(id, peer);
+        }
+    }
+
+    return 0;
+}
+
+zx_status_t ChannelStressTest::Start() {
+    zx_status_t status;
+
+    num_threads_ = fbl::clamp(num_cpus_, 2u, kMaxThreads);
+
+    for (uint32_t i = 0; i < num_threads_; i++) {
+        status = zx::event::create(0, &events_[i]);
+        if (status != ZX_OK) {
+            return status;
+        }
+        for (uint32_t j = i + 1; j < num_threads_; j++) {
+            status = zx::channel::create(0, &ends_[i][j], &ends_[j][i]);
+            if (status != ZX_OK) {
+                return status;
+            }
+        }
+    }
+
+    struct worker_args {
+        ChannelStressTest* test;
+        uint32_t id;
+    };
+
+    auto worker = [](void* arg) -> int {
+        auto* args = static_cast<worker_args*>(arg);
+        ChannelStressTest* test = args->test;
+        uint32_t id = args->id;
+        delete args;
+
+        return test->stress_thread(id);
+    };
+
+    for (uint32_t i = 0; i < num_threads_; i++) {
+        thrd_create_with_name(&threads_[i], worker, new worker_args{this, i},
+                              "channelstress_worker");
+    }
+
+    return ZX_OK;
+}
+
+zx_status_t ChannelStressTest::Stop() {
+    shutdown_.store(true);
+
+    for (uint32_t i = 0; i < num_threads_; i++) {
+        thrd_join(threads_[i], nullptr);
+    }
+
+    return ZX_OK;
+}
@@ -0,0 +1,168 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/algorithm.h>
+#include <fbl/atomic.h>
+#include <lib/zx/time.h>
+#include <zircon/status.h>
+#include <zircon/syscalls.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include "stress_test.h"
+
+// Futex contention matrix
+//
+// A pool of threads hammers a small array of futexes with a random mix of
+// short-deadline waits, single and broadcast wakes, and requeues between
+// random pairs of futexes. Stresses the kernel futex table's hash buckets,
+// wait queue insertion/removal, and the requeue path under heavy contention.
+//
+// Waits use a short deadline so the test makes progress regardless of wake
+// ordering; any status outside the expected set (ZX_OK, ZX_ERR_BAD_STATE for
+// a stale value, ZX_ERR_TIMED_OUT) is reported as an error.
+
+class FutexStressTest : public StressTest {
+public:
+    FutexStressTest() = default;
+    virtual ~FutexStressTest() = default;
+
+    virtual zx_status_t Init(bool verbose, const zx_info_kmem_stats& stats) {
+        zx_status_t status = StressTest::Init(verbose, stats);
+        if (status != ZX_OK) {
+            return status;
+        }
+
+        wait_counter_ = AddCounter("waits");
+        wake_counter_ = AddCounter("wakes");
+        requeue_counter_ = AddCounter("requeues");
+        return ZX_OK;
+    }
+
+    virtual zx_status_t Start();
+    virtual zx_status_t Stop();
+
+    virtual const char* name() const { return "Futex Stress"; }
+
+private:
+    static constexpr uint32_t kMaxThreads = 16;
+    static constexpr uint32_t kNumFutexes = 16;
+
+    int stress_thread();
+
+    zx_futex_t* futex(uint32_t i) {
+        return reinterpret_cast<zx_futex_t*>(&futexes_[i]);
+    }
+
+    uint32_t num_threads_{};
+    thrd_t threads_[kMaxThreads]{};
+
+    // accessed both directly (atomically) and via the futex syscalls
+    fbl::atomic<int32_t> futexes_[kNumFutexes]{};
+
+    fbl::atomic<bool> shutdown_{false};
+
+    size_t wait_counter_{};
+    size_t wake_counter_{};
+    size_t requeue_counter_{};
+};
+
+// our singleton
+FutexStressTest futexstress;
+
+int FutexStressTest::stress_thread() {
+    zx_status_t status;
+
+    while (!shutdown_.load()) {
+        uint32_t f = rand() % kNumFutexes;
+
+        int r = rand() % 100;
+        switch (r) {
+        case 0 ... 49: {
+            // wait with a short deadline so shutdown and missed wakes both
+            // resolve quickly
+            Printf(".");
+            int32_t val = futexes_[f].load();
+            status = zx_futex_wait(futex(f), val, zx_deadline_after(ZX_MSEC(1)));
+            if (status != ZX_OK && status != ZX_ERR_BAD_STATE && status != ZX_ERR_TIMED_OUT) {
+                fprintf(stderr, "unexpected futex_wait error %d (%s)\n", status,
+                        zx_status_get_string(status));
+            }
+            CountOp(wait_counter_);
+            break;
+        }
+        case 50 ... 79:
+            // bump the value and wake one waiter
+            Printf("1");
+            futexes_[f].fetch_add(1);
+            status = zx_futex_wake(futex(f), 1);
+            if (status != ZX_OK) {
+                fprintf(stderr, "unexpected futex_wake error %d (%s)\n", status,
+                        zx_status_get_string(status));
+            }
+            CountOp(wake_counter_);
+            break;
+        case 80 ... 89:
+            // bump the value and wake everyone
+            Printf("*");
+            futexes_[f].fetch_add(1);
+            status = zx_futex_wake(futex(f), UINT32_MAX);
+            if (status != ZX_OK) {
+                fprintf(stderr, "unexpected futex_wake error %d (%s)\n", status,
+                        zx_status_get_string(status));
+            }
+            CountOp(wake_counter_);
+            break;
+        case 90 ... 99: {
+            // wake one waiter and shunt the rest onto another futex
+            Printf("q");
+            uint32_t f2 = (f + 1 + rand() % (kNumFutexes - 1)) % kNumFutexes;
+            int32_t val = futexes_[f].load();
+            status = zx_futex_requeue(futex(f), 1, val, futex(f2), UINT32_MAX);
+            if (status != ZX_OK && status != ZX_ERR_BAD_STATE) {
+                fprintf(stderr, "unexpected futex_requeue error %d (%s)\n", status,
+                        zx_status_get_string(status));
+            }
+            CountOp(requeue_counter_);
+            break;
+        }
+        }
+    }
+
+    return 0;
+}
+
+zx_status_t FutexStressTest::Start() {
+    num_threads_ = fbl::clamp(num_cpus_ * 2, 2u, kMaxThreads);
+
+    auto worker = [](void* arg) -> int {
+        FutexStressTest* test = static_cast<FutexStressTest*>(arg);
+
+        return test->stress_thread();
+    };
+
+    for (uint32_t i = 0; i < num_threads_; i++) {
+        thrd_create_with_name(&threads_[i], worker, this, "futexstress_worker");
+    }
+
+    return ZX_OK;
+}
+
+zx_status_t FutexStressTest::Stop() {
+    shutdown_.store(true);
+
+    // nudge anyone parked in a wait; the short deadlines bound the join
+    // regardless
+    for (uint32_t i = 0; i < kNumFutexes; i++) {
+        zx_futex_wake(futex(i), UINT32_MAX);
+    }
+
+    for (uint32_t i = 0; i < num_threads_; i++) {
+        thrd_join(threads_[i], nullptr);
+    }
+
+    return ZX_OK;
+}
@@ -2,9 +2,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <fbl/string_printf.h>
 #include <fbl/unique_ptr.h>
 #include <fbl/vector.h>
 #include <lib/zx/resource.h>
+#include <perftest/results.h>
 #include <zircon/device/sysinfo.h>
 #include <zircon/status.h>
 #include <zircon/syscalls.h>
@@ -76,10 +78,42 @@ void print_help(char** argv, FILE* f) {
     fprintf(f, "Usage: %s [options]\n", argv[0]);
     fprintf(f, "options:\n");
     fprintf(f, "\t-h:                   This help\n");
+    fprintf(f, "\t-o [path]:            write throughput counters as perftest JSON to path\n");
     fprintf(f, "\t-t [time in seconds]: stop all tests after the time has elapsed\n");
     fprintf(f, "\t-v:                   verbose, status output\n");
 }
 
+// Report each test's throughput counters as ops/second over the run, so soak
+// runs flag throughput collapses alongside any crashes or invariant failures.
+// Optionally also writes them in perftest JSON format for the benchmark
+// tooling to ingest.
+int report_counters(double run_secs, const char* output_path) {
+    perftest::ResultsSet results;
+
+    for (const auto& test : StressTest::tests()) {
+        for (size_t i = 0; i < test->num_counters(); i++) {
+            uint64_t ops = test->counter_value(i);
+            double rate = (run_secs > 0.0) ? (double)ops / run_secs : 0.0;
+            printf("%s: %s = %" PRIu64 " ops (%.1f ops/sec)\n",
+                   test->name(), test->counter_name(i), ops, rate);
+
+            if (output_path) {
+                auto* test_case = results.AddTestCase(
+                    "fuchsia.kernel.stress",
+                    fbl::StringPrintf("%s/%s", test->name(), test->counter_name(i)),
+                    "ops/second");
+                test_case->AppendValue(rate);
+            }
+        }
+    }
+
+    if (output_path && !results.WriteJSONFile(output_path)) {
+        return 1;
+    }
+
+    return 0;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -87,13 +121,17 @@ int main(int argc, char** argv) {
 
     bool verbose = false;
     zx::duration run_duration = zx::duration::infinite();
+    const char* output_path = nullptr;
 
     int c;
-    while ((c = getopt(argc, argv, "ht:v")) > 0) {
+    while ((c = getopt(argc, argv, "ho:t:v")) > 0) {
         switch (c) {
         case 'h':
             print_help(argv, stdout);
             return 0;
+        case 'o':
+            output_path = optarg;
+            break;
         case 't': {
             long t = atol(optarg);
             if (t <= 0) {
@@ -177,6 +215,10 @@ int main(int argc, char** argv) {
         }
     }
 
+    // measure the run window before tearing the tests down so shutdown time
+    // does not dilute the throughput numbers
+    zx::duration elapsed = zx::clock::get_monotonic() - start_time;
+
     // shut them down
     for (auto& test : StressTest::tests()) {
         printf("Stopping %s test\n", test->name());
@@ -187,5 +229,5 @@ int main(int argc, char** argv) {
         }
     }
 
-    return 0;
+    return report_counters((double)elapsed.to_nsecs() / ZX_SEC(1), output_path);
 }
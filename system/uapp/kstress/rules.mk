@@ -10,6 +10,8 @@ MODULE_TYPE := userapp
 MODULE_GROUP := misc
 
 MODULE_SRCS += \
+    $(LOCAL_DIR)/channelstress.cpp \
+    $(LOCAL_DIR)/futexstress.cpp \
     $(LOCAL_DIR)/main.cpp \
     $(LOCAL_DIR)/stress_test.cpp \
     $(LOCAL_DIR)/vmstress.cpp
@@ -21,6 +23,7 @@ MODULE_LIBS := \
 
 MODULE_STATIC_LIBS := \
     system/ulib/fbl \
+    system/ulib/perftest \
     system/ulib/zx \
     system/ulib/zxcpp \
 
@@ -6,9 +6,11 @@
 
 #include <stdarg.h>
 
+#include <fbl/atomic.h>
 #include <fbl/macros.h>
 #include <fbl/vector.h>
 #include <fbl/unique_ptr.h>
+#include <zircon/assert.h>
 #include <zircon/status.h>
 #include <zircon/syscalls.h>
 
@@ -48,7 +50,33 @@ public:
     // get a ref to the master test list
     static fbl::Vector<StressTest*>& tests() { return tests_; }
 
+    // Throughput counters. Worker threads bump these as operations complete
+    // and main reports each one as ops/second when the run ends, so a soak
+    // that quietly collapses in throughput is visible even when nothing
+    // crashes.
+    size_t num_counters() const { return num_counters_; }
+    const char* counter_name(size_t i) const { return counter_names_[i]; }
+    uint64_t counter_value(size_t i) const {
+        return counters_[i].load(fbl::memory_order_relaxed);
+    }
+
 protected:
+    // maximum number of named counters a single test may register
+    static constexpr size_t kMaxCounters = 8;
+
+    // register a named throughput counter during Init; returns the index to
+    // pass to CountOp
+    size_t AddCounter(const char* name) {
+        ZX_ASSERT(num_counters_ < kMaxCounters);
+        counter_names_[num_counters_] = name;
+        return num_counters_++;
+    }
+
+    // cheap enough to call from a hot worker loop
+    void CountOp(size_t counter) {
+        counters_[counter].fetch_add(1, fbl::memory_order_relaxed);
+    }
+
     // global list of all the stress tests, registered at app start
     static fbl::Vector<StressTest*> tests_;
 
@@ -78,7 +106,13 @@ protected:
     bool verbose_{false};
     zx_info_kmem_stats_t kmem_stats_{};
     uint32_t num_cpus_{};
+
+    const char* counter_names_[kMaxCounters]{};
+    fbl::atomic<uint64_t> counters_[kMaxCounters]{};
+    size_t num_counters_{};
 };
 
 // factories for local tests
 fbl::unique_ptr<StressTest> CreateVmStressTest();
+fbl::unique_ptr<StressTest> CreateChannelStressTest();
+fbl::unique_ptr<StressTest> CreateFutexStressTest();
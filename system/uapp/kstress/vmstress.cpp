@@ -33,6 +33,17 @@ public:
     VmStressTest() = default;
     virtual ~VmStressTest() = default;
 
+    virtual zx_status_t Init(bool verbose, const zx_info_kmem_stats& stats) {
+        zx_status_t status = StressTest::Init(verbose, stats);
+        if (status != ZX_OK) {
+            return status;
+        }
+
+        vmo_ops_counter_ = AddCounter("vmo_ops");
+        clone_cycles_counter_ = AddCounter("clone_cycles");
+        return ZX_OK;
+    }
+
     virtual zx_status_t Start();
     virtual zx_status_t Stop();
 
@@ -40,8 +51,13 @@ public:
 
 private:
     int stress_thread();
+    int clone_thread();
 
     thrd_t threads_[16]{};
+    thrd_t clone_threads_[4]{};
+
+    size_t vmo_ops_counter_{};
+    size_t clone_cycles_counter_{};
 
     // used by the worker threads at runtime
     fbl::atomic<bool> shutdown_{false};
@@ -61,7 +77,10 @@ VmStressTest vmstress;
 // Currently does not validate that any given operation was sucessfully performed, only
 // that the apis do not return an error.
 //
-// Will evolve over time to use multiple VMOs simultaneously along with cloned vmos.
+// A second, smaller pool of threads runs a clone/commit storm against the same
+// VMO; see clone_thread below.
+//
+// Will evolve over time to use multiple VMOs simultaneously.
 
 int VmStressTest::stress_thread() {
     zx_status_t status;
@@ -163,6 +182,7 @@ int VmStressTest::stress_thread() {
             break;
         }
 
+        CountOp(vmo_ops_counter_);
         fflush(stdout);
     }
 
@@ -173,6 +193,58 @@ int VmStressTest::stress_thread() {
     return 0;
 }
 
+// Clone/commit storm
+//
+// Repeatedly takes a copy-on-write clone of a random-sized prefix of the test
+// vmo, commits and dirties a slice of it through a mapping (racing against the
+// commit/decommit traffic the other threads throw at the parent), then drops
+// the clone. Exercises the clone creation/teardown and COW page-split paths
+// under contention.
+int VmStressTest::clone_thread() {
+    zx_status_t status;
+
+    uint64_t vmo_size = 0;
+    vmo_.get_size(&vmo_size);
+    ZX_ASSERT(vmo_size > 0);
+
+    while (!shutdown_.load()) {
+        uint64_t clone_size = fbl::max<uint64_t>(rand() % vmo_size, PAGE_SIZE);
+
+        zx::vmo clone;
+        status = vmo_.clone(ZX_VMO_CLONE_COPY_ON_WRITE, 0, clone_size, &clone);
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to clone vmo, error %d (%s)\n", status, zx_status_get_string(status));
+            continue;
+        }
+
+        // commit a random range of the clone
+        uint64_t off = rand() % clone_size;
+        uint64_t len = fbl::min(rand() % clone_size, clone_size - off);
+        status = clone.op_range(ZX_VMO_OP_COMMIT, off, len, nullptr, 0);
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to commit clone range, error %d (%s)\n", status, zx_status_get_string(status));
+        }
+
+        // dirty some of the clone's pages through a mapping, forcing COW splits
+        uintptr_t ptr = 0;
+        status = zx::vmar::root_self()->map(0, clone, 0, clone_size,
+                                            ZX_VM_PERM_READ | ZX_VM_PERM_WRITE, &ptr);
+        if (status != ZX_OK) {
+            fprintf(stderr, "failed to map clone, error %d (%s)\n", status, zx_status_get_string(status));
+        } else {
+            for (uint64_t page = 0; page < clone_size; page += PAGE_SIZE * 8) {
+                *reinterpret_cast<volatile uint8_t*>(ptr + page) = (uint8_t)page;
+            }
+            zx::vmar::root_self()->unmap(ptr, clone_size);
+        }
+
+        Printf("C");
+        CountOp(clone_cycles_counter_);
+    }
+
+    return 0;
+}
+
 zx_status_t VmStressTest::Start() {
     const uint64_t free_bytes = kmem_stats_.free_bytes;
 
@@ -199,6 +271,16 @@ zx_status_t VmStressTest::Start() {
         thrd_create_with_name(&t, worker, this, "vmstress_worker");
     }
 
+    auto cloner = [](void* arg) -> int {
+        VmStressTest* test = static_cast<VmStressTest*>(arg);
+
+        return test->clone_thread();
+    };
+
+    for (auto& t : clone_threads_) {
+        thrd_create_with_name(&t, cloner, this, "vmstress_cloner");
+    }
+
     return ZX_OK;
 }
 
@@ -208,6 +290,9 @@ zx_status_t VmStressTest::Stop() {
     for (auto& t : threads_) {
         thrd_join(t, nullptr);
     }
+    for (auto& t : clone_threads_) {
+        thrd_join(t, nullptr);
+    }
 
     return ZX_OK;
 }
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include <threads.h>
 #include <unistd.h>
 
@@ -16,6 +18,7 @@
 #include <fbl/intrusive_single_list.h>
 #include <fbl/limits.h>
 #include <fbl/unique_ptr.h>
+#include <fbl/vector.h>
 
 static constexpr uint32_t kDefaultNumThreads = 4;
 static constexpr float kDefaultMinWorkMsec = 5.0f;
@@ -139,13 +142,312 @@ double LoadGeneratorThread::MakeRandomDouble(double min, double max) {
     return min + (norm * (max - min));
 }
 
+// Replay support ------------------------------------------------------------
+//
+// Replay mode reproduces a schedule captured from a real workload (typically
+// distilled offline from a ktrace) instead of generating random load.  The
+// schedule file holds one directive per line; '#' starts a comment:
+//
+//   thread <id>      begin the action list for thread <id> (ids must be
+//                    0..N-1 and appear in order)
+//   work <usec>      spin on the CPU for <usec>
+//   sleep <usec>     sleep for <usec>
+//   wait <event>     block until <event> has been signaled
+//   signal <event>   signal <event>, waking its waiters
+//
+// Events model cross-thread wake dependencies and are one-shot: each event id
+// should be signaled exactly once in the schedule.  After the run, each
+// thread reports achieved vs. requested timing so scheduler changes can be
+// judged against the captured workload.
+
+struct ReplayAction {
+    enum class Op { kWork, kSleep, kWait, kSignal };
+
+    Op op;
+    uint64_t usec;       // kWork, kSleep
+    uint32_t event;      // kWait, kSignal
+
+    // Measured duration of the action, filled in during the run.
+    zx_duration_t achieved;
+};
+
+class ReplayThread : public fbl::SinglyLinkedListable<fbl::unique_ptr<ReplayThread>> {
+public:
+    explicit ReplayThread(uint32_t id) : id_(id) {}
+    ~ReplayThread();
+
+    bool AddAction(const ReplayAction& action);
+    zx_status_t Start(zx_time_t start_time);
+    void Join();
+
+    // Prints this thread's achieved vs. requested timing, and returns the
+    // total absolute drift in nanoseconds across its timed actions.
+    zx_duration_t Report() const;
+
+    // Shared table of wake-dependency events, indexed by event id.
+    static fbl::Vector<zx_handle_t>& events() { return events_; }
+
+private:
+    int Run();
+
+    static fbl::Vector<zx_handle_t> events_;
+
+    uint32_t id_;
+    bool thread_started_ = false;
+    thrd_t thread_;
+    zx_time_t start_time_ = 0;
+    fbl::Vector<ReplayAction> actions_;
+    volatile double accumulator_ = 1.0;
+};
+
+fbl::Vector<zx_handle_t> ReplayThread::events_;
+
+ReplayThread::~ReplayThread() {
+    Join();
+}
+
+void ReplayThread::Join() {
+    if (thread_started_) {
+        int musl_ret;
+        thrd_join(thread_, &musl_ret);
+        thread_started_ = false;
+    }
+}
+
+bool ReplayThread::AddAction(const ReplayAction& action) {
+    fbl::AllocChecker ac;
+    actions_.push_back(action, &ac);
+    return ac.check();
+}
+
+zx_status_t ReplayThread::Start(zx_time_t start_time) {
+    if (thread_started_) return ZX_ERR_BAD_STATE;
+    start_time_ = start_time;
+
+    int c11_res = thrd_create(
+            &thread_,
+            [](void* ctx) -> int { return static_cast<ReplayThread*>(ctx)->Run(); },
+            this);
+    if (c11_res != thrd_success) {
+        printf("Failed to create replay thread %u (res %d)!\n", id_, c11_res);
+        return ZX_ERR_INTERNAL;
+    }
+
+    thread_started_ = true;
+    return ZX_OK;
+}
+
+int ReplayThread::Run() {
+    // Launch from a common start time so cross-thread offsets match the
+    // capture regardless of thread creation order.
+    zx_nanosleep(start_time_);
+
+    for (auto& action : actions_) {
+        zx_time_t t0 = zx_clock_get_monotonic();
+
+        switch (action.op) {
+        case ReplayAction::Op::kWork: {
+            // Waste time with the same pointless math as the random load
+            // generator so the work is comparable.
+            zx_time_t deadline = zx_time_add_duration(t0, ZX_USEC(action.usec));
+            while (zx_clock_get_monotonic() < deadline) {
+                double tmp = accumulator_;
+                accumulator_ = fbl::clamp<double>((tmp * 3.0) + 1.0, 0.0, 100000000.0);
+            }
+            break;
+        }
+        case ReplayAction::Op::kSleep:
+            zx_nanosleep(zx_time_add_duration(t0, ZX_USEC(action.usec)));
+            break;
+        case ReplayAction::Op::kWait:
+            zx_object_wait_one(events_[action.event], ZX_EVENT_SIGNALED, ZX_TIME_INFINITE,
+                               nullptr);
+            break;
+        case ReplayAction::Op::kSignal:
+            zx_object_signal(events_[action.event], 0, ZX_EVENT_SIGNALED);
+            break;
+        }
+
+        action.achieved = zx_time_sub_time(zx_clock_get_monotonic(), t0);
+    }
+
+    return 0;
+}
+
+zx_duration_t ReplayThread::Report() const {
+    uint64_t requested = 0;
+    uint64_t achieved = 0;
+    zx_duration_t total_drift = 0;
+    zx_duration_t max_error = 0;
+    size_t timed_actions = 0;
+
+    for (const auto& action : actions_) {
+        if ((action.op != ReplayAction::Op::kWork) && (action.op != ReplayAction::Op::kSleep))
+            continue;
+        zx_duration_t want = ZX_USEC(action.usec);
+        zx_duration_t error = action.achieved - want;
+        if (error < 0) error = -error;
+        requested += want;
+        achieved += action.achieved;
+        total_drift += error;
+        max_error = fbl::max(max_error, error);
+        ++timed_actions;
+    }
+
+    printf("thread %2u: %zu timed actions, requested %" PRIu64 " usec, achieved %" PRIu64
+           " usec, max error %" PRIi64 " usec\n",
+           id_, timed_actions, requested / 1000, achieved / 1000, max_error / 1000);
+    return total_drift;
+}
+
+// Parses the schedule at |path| into per-thread action lists and creates the
+// wake-dependency events.  Returns false (after printing the problem) if the
+// file cannot be parsed.
+bool LoadSchedule(const char* path,
+                  fbl::SinglyLinkedList<fbl::unique_ptr<ReplayThread>>* threads,
+                  uint32_t* num_threads) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Failed to open schedule \"%s\"\n", path);
+        return false;
+    }
+    auto close_file = fbl::MakeAutoCall([f]() { fclose(f); });
+
+    ReplayThread* current = nullptr;
+    uint32_t max_event = 0;
+    bool have_event = false;
+    char line[256];
+    uint32_t lineno = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        ++lineno;
+        char* p = line + strspn(line, " \t");
+        if ((*p == '\0') || (*p == '\n') || (*p == '#'))
+            continue;
+
+        char op[16];
+        uint64_t arg;
+        if (sscanf(p, "%15s %" PRIu64, op, &arg) != 2) {
+            printf("%s:%u: cannot parse \"%s\"\n", path, lineno, p);
+            return false;
+        }
+
+        if (!strcmp(op, "thread")) {
+            if (arg != *num_threads) {
+                printf("%s:%u: thread ids must be 0..N-1 in order\n", path, lineno);
+                return false;
+            }
+            fbl::AllocChecker ac;
+            fbl::unique_ptr<ReplayThread> t(
+                new (&ac) ReplayThread(static_cast<uint32_t>(arg)));
+            if (!ac.check()) {
+                printf("Failed to allocate replay thread %" PRIu64 "\n", arg);
+                return false;
+            }
+            current = t.get();
+            // The list is LIFO; order doesn't matter for replay since every
+            // thread starts from the shared start time.
+            threads->push_front(fbl::move(t));
+            ++*num_threads;
+            continue;
+        }
+
+        if (!current) {
+            printf("%s:%u: \"%s\" before any thread directive\n", path, lineno, op);
+            return false;
+        }
+
+        ReplayAction action = {};
+        if (!strcmp(op, "work")) {
+            action.op = ReplayAction::Op::kWork;
+            action.usec = arg;
+        } else if (!strcmp(op, "sleep")) {
+            action.op = ReplayAction::Op::kSleep;
+            action.usec = arg;
+        } else if (!strcmp(op, "wait") || !strcmp(op, "signal")) {
+            action.op = !strcmp(op, "wait") ? ReplayAction::Op::kWait
+                                            : ReplayAction::Op::kSignal;
+            action.event = static_cast<uint32_t>(arg);
+            max_event = fbl::max(max_event, action.event);
+            have_event = true;
+        } else {
+            printf("%s:%u: unknown directive \"%s\"\n", path, lineno, op);
+            return false;
+        }
+
+        if (!current->AddAction(action)) {
+            printf("Failed to allocate action storage\n");
+            return false;
+        }
+    }
+
+    if (*num_threads == 0) {
+        printf("%s: no threads in schedule\n", path);
+        return false;
+    }
+
+    if (have_event) {
+        for (uint32_t i = 0; i <= max_event; ++i) {
+            zx_handle_t event;
+            zx_status_t res = zx_event_create(0, &event);
+            if (res != ZX_OK) {
+                printf("Failed to create event %u (res %d)\n", i, res);
+                return false;
+            }
+            fbl::AllocChecker ac;
+            ReplayThread::events().push_back(event, &ac);
+            if (!ac.check()) {
+                printf("Failed to allocate event table\n");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int ReplayMain(const char* path) {
+    fbl::SinglyLinkedList<fbl::unique_ptr<ReplayThread>> threads;
+    uint32_t num_threads = 0;
+    if (!LoadSchedule(path, &threads, &num_threads))
+        return -1;
+
+    printf("Replaying \"%s\" on %u thread%s.\n", path, num_threads,
+           num_threads == 1 ? "" : "s");
+
+    // Give every thread time to reach the common start line.
+    zx_time_t start_time = zx_deadline_after(ZX_MSEC(50));
+    zx_time_t t0 = zx_clock_get_monotonic();
+    for (auto& t : threads) {
+        zx_status_t res = t.Start(start_time);
+        if (res != ZX_OK)
+            return res;
+    }
+
+    for (auto& t : threads)
+        t.Join();
+    zx_duration_t wall = zx_time_sub_time(zx_clock_get_monotonic(), t0);
+
+    printf("Replay finished in %" PRIi64 " usec.\n", wall / 1000);
+    zx_duration_t total_drift = 0;
+    for (auto& t : threads)
+        total_drift += t.Report();
+    printf("Total drift across timed actions: %" PRIi64 " usec\n", total_drift / 1000);
+    return 0;
+}
+
 void usage(const char* program_name) {
     printf("usage: %s [N] [min_work max_work] [min_sleep max_sleep] [seed]\n"
+           "       %s --replay <schedule>\n"
            "  All arguments are positional and optional.\n"
            "  N             : Number of threads to create.  Default %u\n"
            "  min/max_work  : Min/max msec for threads to work for.  Default %.1f,%.1f mSec\n"
            "  min/max_sleep : Min/max msec for threads to sleep for.  Default %.1f,%.1f mSec\n"
-           "  seed          : RNG seed to use.  Defaults to seeding from zx_clock_get\n",
+           "  seed          : RNG seed to use.  Defaults to seeding from zx_clock_get\n"
+           "  --replay      : Instead of random load, reproduce the captured schedule\n"
+           "                  (thread/work/sleep/wait/signal directives; see source for\n"
+           "                  the format) and report achieved vs. requested timing.\n",
+           program_name,
            program_name,
            kDefaultNumThreads,
            kDefaultMinWorkMsec,
@@ -157,6 +459,12 @@ void usage(const char* program_name) {
 int main(int argc, char** argv) {
     auto show_usage = fbl::MakeAutoCall([argv]() { usage(argv[0]); });
 
+    if ((argc >= 2) && !strcmp(argv[1], "--replay")) {
+        if (argc != 3) return -1;
+        show_usage.cancel();
+        return ReplayMain(argv[2]);
+    }
+
     // 0, 1, 3, 5 and 6 arguments are the only legal number of args.
     switch (argc) {
     case 1:
@@ -14,6 +14,8 @@
 #include <unistd.h>
 
 #include <lz4/lz4frame.h>
+#include <lz4/lz4mt.h>
+#include <zircon/syscalls.h>
 
 #define BLOCK_SIZE 65536
 
@@ -21,10 +23,11 @@
 #define PERM_644 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
 
 static void usage(const char* arg0) {
-    printf("usage: %s [-1|-9] [-d] <input file> <output file>\n", arg0);
+    printf("usage: %s [-1|-9] [-d] [-t[N]] <input file> <output file>\n", arg0);
     printf("   -1  fast compression (default)\n");
     printf("   -9  high compression (slower)\n");
     printf("   -d  decompress\n");
+    printf("   -t  compress on N threads (default: one per CPU)\n");
 }
 
 static int do_decompress(const char* infile, const char* outfile) {
@@ -123,7 +126,74 @@ done:
     return 0;
 }
 
-static int do_compress(const char* infile, const char* outfile, int clevel) {
+// Fill buf with up to len bytes, looping over short reads so a whole
+// window reaches the compressor at once.  Returns bytes read, or -1.
+static ssize_t read_full(int fd, uint8_t* buf, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+        ssize_t nr = read(fd, buf + pos, len - pos);
+        if (nr < 0) {
+            return -1;
+        }
+        if (nr == 0) {
+            break;
+        }
+        pos += nr;
+    }
+    return pos;
+}
+
+// Compress a window of |threads| blocks at a time with LZ4MT, so every
+// worker has a block to chew on; output stays a plain sequence of
+// BLOCK_SIZE frames, same as the single-threaded path produces.
+static int do_compress_mt(int infd, int outfd,
+                          const char* infile, const char* outfile,
+                          int clevel, int threads) {
+    size_t window = (size_t)threads * BLOCK_SIZE;
+    size_t outsize = LZ4MT_compressBound(window, BLOCK_SIZE);
+    uint8_t* inbuf = malloc(window);
+    uint8_t* outbuf = malloc(outsize);
+    if (!inbuf || !outbuf) {
+        fprintf(stderr, "out of memory\n");
+        free(inbuf);
+        free(outbuf);
+        return ENOMEM;
+    }
+
+    int ret = 0;
+    ssize_t nr;
+    while ((nr = read_full(infd, inbuf, window)) > 0) {
+        size_t csz = LZ4MT_compressFrames(outbuf, outsize, inbuf, nr,
+                                          BLOCK_SIZE, clevel, threads);
+        if (LZ4F_isError(csz)) {
+            fprintf(stderr, "error compressing %s: %s\n", infile, LZ4F_getErrorName(csz));
+            ret = -1;
+            break;
+        }
+
+        ssize_t nw = write(outfd, outbuf, csz);
+        if (nw != (ssize_t)csz) {
+            fprintf(stderr, "could not write to %s", outfile);
+            if (nw < 0) {
+                fprintf(stderr, ": %s", strerror(errno));
+            }
+            fprintf(stderr, "\n");
+            ret = -1;
+            break;
+        }
+    }
+
+    if (nr < 0) {
+        fprintf(stderr, "error reading %s: %s\n", infile, strerror(errno));
+        ret = -1;
+    }
+
+    free(inbuf);
+    free(outbuf);
+    return ret;
+}
+
+static int do_compress(const char* infile, const char* outfile, int clevel, int threads) {
     int infd, outfd;
 
     infd = open(infile, O_RDONLY);
@@ -139,6 +209,13 @@ static int do_compress(const char* infile, const char* outfile, int clevel) {
         return -1;
     }
 
+    if (threads > 1) {
+        int ret = do_compress_mt(infd, outfd, infile, outfile, clevel, threads);
+        close(outfd);
+        close(infd);
+        return ret;
+    }
+
     LZ4F_preferences_t prefs;
     memset(&prefs, 0, sizeof(prefs));
     prefs.compressionLevel = clevel;
@@ -188,6 +265,7 @@ done:
 
 int main(int argc, char* argv[]) {
     int clevel = 1;
+    int threads = 1;
     bool decompress = false;
     const char* infile = NULL;
     const char* outfile = NULL;
@@ -201,6 +279,13 @@ int main(int argc, char* argv[]) {
             clevel = 9;
             continue;
         }
+        if (!strncmp("-t", argv[i], 2)) {
+            threads = atoi(argv[i] + 2);
+            if (threads < 1) {
+                threads = zx_system_get_num_cpus();
+            }
+            continue;
+        }
         if (!strcmp("-h", argv[i])) {
             usage(argv[0]);
             return 0;
@@ -231,12 +316,15 @@ int main(int argc, char* argv[]) {
             outfile);
     if (!decompress) {
         printf(" at level %d", clevel);
+        if (threads > 1) {
+            printf(" on %d threads", threads);
+        }
     }
     printf("\n");
 
     if (decompress) {
         return do_decompress(infile, outfile);
     } else {
-        return do_compress(infile, outfile, clevel);
+        return do_compress(infile, outfile, clevel, threads);
     }
 }
@@ -20,11 +20,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
 #include <unistd.h>
 
 #define BUFSIZE 2048
 #define ROUNDUP(a, b)   (((a) + ((b)-1)) & ~((b)-1))
 
+// A capture filter compiled from -f specs. All compare constants are
+// precomputed in network byte order so that matching a packet costs a few
+// loads and compares over the raw headers, with no byte swapping and no
+// parsing of traffic we are going to discard.
+typedef struct {
+    bool enabled;
+    bool match_ethtype;
+    uint16_t ethtype_be;
+    bool match_protocol;
+    uint8_t protocol;
+    bool match_port;
+    uint16_t port_be;
+} netdump_filter_t;
+
 typedef struct {
     const char* device;
     bool raw;
@@ -33,6 +48,7 @@ typedef struct {
     size_t packet_count;
     size_t verbose_level;
     int dumpfile;
+    netdump_filter_t filter;
 } netdump_options_t;
 
 typedef struct {
@@ -272,6 +288,206 @@ int write_packet(int fd, void* data, size_t len) {
     return 0;
 }
 
+// Compiles one -f spec into the filter. Specs accumulate: each one
+// constrains a different header field, so repeated specs AND together.
+// Returns -1 if the spec is not recognized.
+int filter_add_spec(netdump_filter_t* filter, const char* spec) {
+    if (!strcmp(spec, "ip") || !strcmp(spec, "ip4")) {
+        filter->match_ethtype = true;
+        filter->ethtype_be = htons(ETH_P_IP);
+    } else if (!strcmp(spec, "ip6")) {
+        filter->match_ethtype = true;
+        filter->ethtype_be = htons(ETH_P_IPV6);
+    } else if (!strcmp(spec, "arp")) {
+        filter->match_ethtype = true;
+        filter->ethtype_be = htons(ETH_P_ARP);
+    } else if (!strcmp(spec, "tcp")) {
+        filter->match_protocol = true;
+        filter->protocol = IPPROTO_TCP;
+    } else if (!strcmp(spec, "udp")) {
+        filter->match_protocol = true;
+        filter->protocol = IPPROTO_UDP;
+    } else {
+        char* endptr;
+        unsigned long port = strtoul(spec, &endptr, 10);
+        if (*spec == '\0' || *endptr != '\0' || port == 0 || port > UINT16_MAX) {
+            return -1;
+        }
+        filter->match_port = true;
+        filter->port_be = htons((uint16_t)port);
+    }
+    filter->enabled = true;
+    return 0;
+}
+
+// Runs the compiled filter over a packet's raw headers. Returns true if the
+// packet should be captured.
+bool filter_match(const netdump_filter_t* filter, const void* packet, size_t length) {
+    if (!filter->enabled) {
+        return true;
+    }
+    if (length < sizeof(struct ethhdr)) {
+        return false;
+    }
+    const struct ethhdr* frame = packet;
+    if (filter->match_ethtype && frame->h_proto != filter->ethtype_be) {
+        return false;
+    }
+    if (!filter->match_protocol && !filter->match_port) {
+        return true;
+    }
+
+    if (length < sizeof(struct ethhdr) + sizeof(struct iphdr)) {
+        return false;
+    }
+    const struct iphdr* ipv4 = (const void*)((uintptr_t)packet + sizeof(struct ethhdr));
+    uint8_t protocol;
+    size_t transport_off;
+    if (ipv4->version == 4) {
+        protocol = ipv4->protocol;
+        transport_off = sizeof(struct ethhdr) + ipv4->ihl * 4;
+    } else if (ipv4->version == 6) {
+        const ip6_hdr_t* ipv6 = (const void*)ipv4;
+        protocol = ipv6->next_header;
+        transport_off = sizeof(struct ethhdr) + sizeof(ip6_hdr_t);
+    } else {
+        return false;
+    }
+    if (filter->match_protocol && protocol != filter->protocol) {
+        return false;
+    }
+
+    if (filter->match_port) {
+        // Source and destination ports are the leading two fields of both
+        // the TCP and UDP headers.
+        if (protocol != IPPROTO_TCP && protocol != IPPROTO_UDP) {
+            return false;
+        }
+        if (length < transport_off + 2 * sizeof(uint16_t)) {
+            return false;
+        }
+        uint16_t ports[2];
+        memcpy(ports, (const uint8_t*)packet + transport_off, sizeof(ports));
+        if (ports[0] != filter->port_be && ports[1] != filter->port_be) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Slots in the capture ring between the rx loop and the writer thread;
+// must be a power of two.
+#define RING_DEPTH 256
+
+typedef struct {
+    uint32_t length;
+    uint8_t data[BUFSIZE];
+} ring_slot_t;
+
+// A ring of captured packets drained to the dump file by a dedicated
+// thread, so a slow disk stalls the writer rather than the rx fifo loop.
+// The reader owns tail, the writer owns head; both are guarded by lock.
+// If the writer falls RING_DEPTH packets behind, further packets are
+// dropped and counted rather than blocking the rx loop.
+typedef struct {
+    ring_slot_t* slots;
+    uint32_t head; // Next slot the writer drains.
+    uint32_t tail; // Next slot the reader fills.
+    bool done;
+    bool write_error;
+    size_t dropped;
+    mtx_t lock;
+    cnd_t readable;
+    int fd;
+    thrd_t thread;
+} pkt_ring_t;
+
+static int writer_thread(void* arg) {
+    pkt_ring_t* ring = arg;
+    for (;;) {
+        mtx_lock(&ring->lock);
+        while (ring->head == ring->tail && !ring->done) {
+            cnd_wait(&ring->readable, &ring->lock);
+        }
+        if (ring->head == ring->tail) {
+            // Done, and the ring is drained.
+            mtx_unlock(&ring->lock);
+            return 0;
+        }
+        ring_slot_t* slot = &ring->slots[ring->head & (RING_DEPTH - 1)];
+        bool failed = ring->write_error;
+        mtx_unlock(&ring->lock);
+
+        // The slot can't be reused until head advances, so write without
+        // holding the lock. After a write error, keep draining (and
+        // discarding) so the rx loop never blocks on a dead file.
+        int rc = failed ? 0 : write_packet(ring->fd, slot->data, slot->length);
+
+        mtx_lock(&ring->lock);
+        ring->head++;
+        if (rc) {
+            ring->write_error = true;
+        }
+        mtx_unlock(&ring->lock);
+    }
+}
+
+int ring_start(pkt_ring_t* ring, int fd) {
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = fd;
+    ring->slots = malloc(RING_DEPTH * sizeof(ring_slot_t));
+    if (ring->slots == NULL) {
+        return -1;
+    }
+    if (mtx_init(&ring->lock, mtx_plain) != thrd_success ||
+        cnd_init(&ring->readable) != thrd_success ||
+        thrd_create(&ring->thread, writer_thread, ring) != thrd_success) {
+        free(ring->slots);
+        return -1;
+    }
+    return 0;
+}
+
+// Copies a captured packet into the ring. Returns -1 if the writer thread
+// has hit a write error; dropped packets are counted, not reported as
+// errors.
+int ring_push(pkt_ring_t* ring, const void* data, size_t len) {
+    ZX_DEBUG_ASSERT(len <= BUFSIZE);
+    mtx_lock(&ring->lock);
+    if (ring->write_error) {
+        mtx_unlock(&ring->lock);
+        return -1;
+    }
+    if (ring->tail - ring->head == RING_DEPTH) {
+        ring->dropped++;
+        mtx_unlock(&ring->lock);
+        return 0;
+    }
+    ring_slot_t* slot = &ring->slots[ring->tail & (RING_DEPTH - 1)];
+    memcpy(slot->data, data, len);
+    slot->length = len;
+    ring->tail++;
+    cnd_signal(&ring->readable);
+    mtx_unlock(&ring->lock);
+    return 0;
+}
+
+void ring_stop(pkt_ring_t* ring) {
+    mtx_lock(&ring->lock);
+    ring->done = true;
+    cnd_signal(&ring->readable);
+    mtx_unlock(&ring->lock);
+    thrd_join(ring->thread, NULL);
+    if (ring->dropped > 0) {
+        fprintf(stderr, "netdump: dropped %zu packets (writer fell behind)\n",
+                ring->dropped);
+    }
+    mtx_destroy(&ring->lock);
+    cnd_destroy(&ring->readable);
+    free(ring->slots);
+}
+
 void handle_rx(zx_handle_t rx_fifo, char* iobuf, unsigned count, netdump_options_t* options) {
     eth_fifo_entry_t entries[count];
 
@@ -282,6 +498,13 @@ void handle_rx(zx_handle_t rx_fifo, char* iobuf, unsigned count, netdump_options
         return;
     }
 
+    pkt_ring_t ring;
+    const bool dumping = options->dumpfile != -1;
+    if (dumping && ring_start(&ring, options->dumpfile)) {
+        fprintf(stderr, "netdump: failed to start writer thread\n");
+        return;
+    }
+
     for (;;) {
         size_t n;
         zx_status_t status;
@@ -291,12 +514,15 @@ void handle_rx(zx_handle_t rx_fifo, char* iobuf, unsigned count, netdump_options
                 continue;
             }
             fprintf(stderr, "netdump: failed to read rx packets: %d\n", status);
-            return;
+            goto out;
         }
 
         eth_fifo_entry_t* e = entries;
         for (size_t i = 0; i < n; i++, e++) {
-            if (e->flags & ETH_FIFO_RX_OK) {
+            // The filter runs before any parsing or copying, so discarded
+            // traffic costs no more than the match itself.
+            if ((e->flags & ETH_FIFO_RX_OK) &&
+                filter_match(&options->filter, iobuf + e->offset, e->length)) {
                 if (options->raw) {
                     printf("---\n");
                     hexdump8_ex(iobuf + e->offset, e->length, 0);
@@ -304,13 +530,13 @@ void handle_rx(zx_handle_t rx_fifo, char* iobuf, unsigned count, netdump_options
                     parse_packet(iobuf + e->offset, e->length, options);
                 }
 
-                if (write_packet(options->dumpfile, iobuf + e->offset, e->length)) {
-                    return;
+                if (dumping && ring_push(&ring, iobuf + e->offset, e->length)) {
+                    goto out;
                 }
 
                 options->packet_count--;
                 if (options->packet_count == 0) {
-                    return;
+                    goto out;
                 }
             }
 
@@ -322,6 +548,11 @@ void handle_rx(zx_handle_t rx_fifo, char* iobuf, unsigned count, netdump_options
             }
         }
     }
+
+out:
+    if (dumping) {
+        ring_stop(&ring);
+    }
 }
 
 int usage(void) {
@@ -329,6 +560,9 @@ int usage(void) {
     fprintf(stderr, " -w file : Write packet output to file in pcapng format\n");
     fprintf(stderr, " -c count: Exit after receiving count packets\n");
     fprintf(stderr, " -e      : Print link-level header information\n");
+    fprintf(stderr, " -f spec : Capture only matching packets. spec is one of\n");
+    fprintf(stderr, "           ip, ip6, arp, tcp, udp, or a decimal TCP/UDP port.\n");
+    fprintf(stderr, "           Repeated specs are ANDed together\n");
     fprintf(stderr, " -p      : Use promiscuous mode\n");
     fprintf(stderr, " -v      : Print verbose output\n");
     fprintf(stderr, " -vv     : Print extra verbose output\n");
@@ -356,6 +590,18 @@ int parse_args(int argc, const char** argv, netdump_options_t* options) {
             argv++;
             argc--;
             options->link_level = true;
+        } else if (!strcmp(argv[0], "-f")) {
+            argv++;
+            argc--;
+            if (argc < 1) {
+                return usage();
+            }
+            if (filter_add_spec(&options->filter, argv[0])) {
+                fprintf(stderr, "Error: Unknown filter spec: %s\n", argv[0]);
+                return usage();
+            }
+            argv++;
+            argc--;
         } else if (!strcmp(argv[0], "-p")) {
             argv++;
             argc--;
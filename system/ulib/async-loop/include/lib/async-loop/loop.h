@@ -52,6 +52,23 @@ typedef struct async_loop_config {
 
     // Data to pass to the callback functions.
     void* data;
+
+    // If true, due tasks may be dispatched concurrently by every thread
+    // running the loop instead of being serialized on a single thread,
+    // and idle threads are woken to help drain a backlog of due tasks.
+    // A single slow task handler then no longer delays the others.
+    //
+    // Task handlers must be prepared to run in parallel with one another;
+    // the usual guarantee that tasks are dispatched strictly in deadline
+    // order is waived.  Wait, packet and exception dispatch are unaffected
+    // (those already balance across threads through the port).
+    bool concurrent_task_dispatch;
+
+    // If true, the loop records the execution time of every dispatched
+    // handler in a log2 histogram which can be retrieved with
+    // |async_loop_get_latency_histogram()|.  This adds two clock reads
+    // per dispatched handler.
+    bool track_dispatch_latency;
 } async_loop_config_t;
 
 // Simple config that when passed to async_loop_create will create a loop
@@ -172,6 +189,19 @@ zx_status_t async_loop_start_thread(async_loop_t* loop, const char* name,
 // have terminated.
 void async_loop_join_threads(async_loop_t* loop);
 
+// Number of buckets in the handler latency histogram.
+// Bucket |i| counts handlers whose run time fell in [2^i, 2^(i+1)) nanoseconds.
+#define ASYNC_LOOP_LATENCY_BUCKETS (64u)
+
+// Copies the handler latency histogram into |counts|, which must have room
+// for |ASYNC_LOOP_LATENCY_BUCKETS| entries.
+//
+// The histogram is only populated when the loop was created with
+// |track_dispatch_latency| set in its configuration; otherwise all buckets
+// read as zero.
+void async_loop_get_latency_histogram(async_loop_t* loop,
+                                      uint64_t counts[ASYNC_LOOP_LATENCY_BUCKETS]);
+
 __END_CDECLS
 
 #endif  // LIB_ASYNC_LOOP_LOOP_H_
\ No newline at end of file
@@ -78,13 +78,17 @@ typedef struct async_loop {
     _Atomic async_loop_state_t state;
     atomic_uint active_threads; // number of active dispatch threads
 
-    mtx_t lock; // guards the lists and the dispatching tasks flag
-    bool dispatching_tasks; // true while the loop is busy dispatching tasks
+    mtx_t lock; // guards the lists and the dispatching tasks count
+    uint32_t dispatching_tasks; // number of threads currently dispatching tasks
     list_node_t wait_list; // most recently added first
     list_node_t task_list; // pending tasks, earliest deadline first
     list_node_t due_list; // due tasks, earliest deadline first
     list_node_t thread_list; // earliest created thread first
     list_node_t exception_list; // most recently added first
+
+    // Handler run time counts, bucketed by log2 nanoseconds.  Only
+    // populated when |config.track_dispatch_latency| is set.
+    atomic_uint_fast64_t latency_buckets[ASYNC_LOOP_LATENCY_BUCKETS];
 } async_loop_t;
 
 static zx_status_t async_loop_run_once(async_loop_t* loop, zx_time_t deadline);
@@ -259,9 +263,13 @@ static zx_status_t async_loop_run_once(async_loop_t* loop, zx_time_t deadline) {
         return status;
 
     if (packet.key == KEY_CONTROL) {
-        // Handle wake-up packets.
-        if (packet.type == ZX_PKT_TYPE_USER)
+        // Handle wake-up packets.  In concurrent task dispatch mode a
+        // wake-up may also signal a backlog of due tasks to help drain.
+        if (packet.type == ZX_PKT_TYPE_USER) {
+            if (loop->config.concurrent_task_dispatch)
+                return async_loop_dispatch_tasks(loop);
             return ZX_OK;
+        }
 
         // Handle task timer expirations.
         if (packet.type == ZX_PKT_TYPE_SIGNAL_REP &&
@@ -312,12 +320,41 @@ async_loop_t* async_loop_from_dispatcher(async_dispatcher_t* async) {
     return (async_loop_t*)async;
 }
 
+// Returns the handler start time, or 0 when latency tracking is disabled.
+static zx_time_t async_loop_latency_start(async_loop_t* loop) {
+    if (!loop->config.track_dispatch_latency)
+        return 0u;
+    return zx_clock_get_monotonic();
+}
+
+static void async_loop_record_latency(async_loop_t* loop, zx_time_t start) {
+    if (start == 0u)
+        return;
+    uint64_t elapsed = zx_clock_get_monotonic() - start;
+    if (elapsed == 0u)
+        elapsed = 1u;
+    uint32_t bucket = 63u - (uint32_t)__builtin_clzll(elapsed);
+    atomic_fetch_add_explicit(&loop->latency_buckets[bucket], 1u,
+                              memory_order_relaxed);
+}
+
+void async_loop_get_latency_histogram(async_loop_t* loop,
+                                      uint64_t counts[ASYNC_LOOP_LATENCY_BUCKETS]) {
+    ZX_DEBUG_ASSERT(loop);
+    for (uint32_t i = 0u; i < ASYNC_LOOP_LATENCY_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&loop->latency_buckets[i],
+                                         memory_order_relaxed);
+    }
+}
+
 static zx_status_t async_loop_dispatch_guest_bell_trap(async_loop_t* loop,
                                                        async_guest_bell_trap_t* trap,
                                                        zx_status_t status,
                                                        const zx_packet_guest_bell_t* bell) {
     async_loop_invoke_prologue(loop);
+    zx_time_t start = async_loop_latency_start(loop);
     trap->handler((async_dispatcher_t*)loop, trap, status, bell);
+    async_loop_record_latency(loop, start);
     async_loop_invoke_epilogue(loop);
     return ZX_OK;
 }
@@ -325,19 +362,22 @@ static zx_status_t async_loop_dispatch_guest_bell_trap(async_loop_t* loop,
 static zx_status_t async_loop_dispatch_wait(async_loop_t* loop, async_wait_t* wait,
                                             zx_status_t status, const zx_packet_signal_t* signal) {
     async_loop_invoke_prologue(loop);
+    zx_time_t start = async_loop_latency_start(loop);
     wait->handler((async_dispatcher_t*)loop, wait, status, signal);
+    async_loop_record_latency(loop, start);
     async_loop_invoke_epilogue(loop);
     return ZX_OK;
 }
 
 static zx_status_t async_loop_dispatch_tasks(async_loop_t* loop) {
     // Dequeue and dispatch one task at a time in case an earlier task wants
-    // to cancel a later task which has also come due.  At most one thread
-    // can dispatch tasks at any given moment (to preserve serial ordering).
-    // Timer restarts are suppressed until we run out of tasks to dispatch.
+    // to cancel a later task which has also come due.  Unless concurrent
+    // task dispatch was requested, at most one thread can dispatch tasks at
+    // any given moment (to preserve serial ordering).  Timer restarts are
+    // suppressed until we run out of tasks to dispatch.
     mtx_lock(&loop->lock);
-    if (!loop->dispatching_tasks) {
-        loop->dispatching_tasks = true;
+    if (loop->dispatching_tasks == 0 || loop->config.concurrent_task_dispatch) {
+        loop->dispatching_tasks++;
 
         // Extract all of the tasks that are due into |due_list| for dispatch
         // unless we already have some waiting from a previous iteration which
@@ -359,6 +399,27 @@ static zx_status_t async_loop_dispatch_tasks(async_loop_t* loop) {
                 head->prev = &loop->due_list;
                 loop->due_list.prev = tail;
                 tail->next = &loop->due_list;
+
+                // In concurrent mode, wake idle threads to help drain a
+                // backlog of more than one due task.  The woken threads
+                // re-enter this function through their wake-up packets.
+                if (loop->config.concurrent_task_dispatch) {
+                    size_t backlog = list_length(&loop->due_list);
+                    uint32_t helpers = atomic_load_explicit(&loop->active_threads,
+                                                            memory_order_acquire);
+                    if (helpers > 0u)
+                        helpers--; // exclude ourselves
+                    if (backlog - 1 < helpers)
+                        helpers = (uint32_t)(backlog - 1);
+                    for (uint32_t i = 0u; i < helpers; i++) {
+                        zx_port_packet_t packet = {
+                            .key = KEY_CONTROL,
+                            .type = ZX_PKT_TYPE_USER,
+                            .status = ZX_OK};
+                        zx_status_t status = zx_port_queue(loop->port, &packet);
+                        ZX_ASSERT_MSG(status == ZX_OK, "zx_port_queue: status=%d", status);
+                    }
+                }
             }
         }
 
@@ -378,8 +439,9 @@ static zx_status_t async_loop_dispatch_tasks(async_loop_t* loop) {
                 break;
         }
 
-        loop->dispatching_tasks = false;
-        async_loop_restart_timer_locked(loop);
+        // The last dispatcher out restarts the timer.
+        if (--loop->dispatching_tasks == 0u)
+            async_loop_restart_timer_locked(loop);
     }
     mtx_unlock(&loop->lock);
     return ZX_OK;
@@ -390,7 +452,9 @@ static void async_loop_dispatch_task(async_loop_t* loop,
                                      zx_status_t status) {
     // Invoke the handler.  Note that it might destroy itself.
     async_loop_invoke_prologue(loop);
+    zx_time_t start = async_loop_latency_start(loop);
     task->handler((async_dispatcher_t*)loop, task, status);
+    async_loop_record_latency(loop, start);
     async_loop_invoke_epilogue(loop);
 }
 
@@ -398,7 +462,9 @@ static zx_status_t async_loop_dispatch_packet(async_loop_t* loop, async_receiver
                                               zx_status_t status, const zx_packet_user_t* data) {
     // Invoke the handler.  Note that it might destroy itself.
     async_loop_invoke_prologue(loop);
+    zx_time_t start = async_loop_latency_start(loop);
     receiver->handler((async_dispatcher_t*)loop, receiver, status, data);
+    async_loop_record_latency(loop, start);
     async_loop_invoke_epilogue(loop);
     return ZX_OK;
 }
@@ -409,7 +475,9 @@ static zx_status_t async_loop_dispatch_exception(async_loop_t* loop,
                                                  const zx_port_packet_t* report) {
     // Invoke the handler.  Note that it might destroy itself.
     async_loop_invoke_prologue(loop);
+    zx_time_t start = async_loop_latency_start(loop);
     exception->handler((async_dispatcher_t*)loop, exception, status, report);
+    async_loop_record_latency(loop, start);
     async_loop_invoke_epilogue(loop);
     return ZX_OK;
 }
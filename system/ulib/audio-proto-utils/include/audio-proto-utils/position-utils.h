@@ -0,0 +1,58 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <fbl/atomic.h>
+#include <fbl/macros.h>
+#include <zircon/types.h>
+
+namespace audio {
+namespace utils {
+
+// A single-writer position/clock structure intended to live in a VMO shared
+// between an audio driver and its clients. Instead of polling the driver
+// over the ring-buffer channel, the driver publishes a (position,
+// timestamp, rate) triple whenever it learns the hardware position, and
+// clients extrapolate the current position from the monotonic clock with
+// no IPC at all.
+//
+// A sequence counter (odd while an update is in flight) guards the triple,
+// so readers never observe a torn update. The driver must be the only
+// writer; clients should map the VMO read-only and use only
+// PredictPosition().
+class RingBufferPositionClock {
+public:
+    RingBufferPositionClock() = default;
+
+    // Driver side. Publish() records that the hardware read/write pointer
+    // was at |position| bytes into the ring at |timestamp| (on
+    // ZX_CLOCK_MONOTONIC) and is advancing at |bytes_per_sec|. |ring_size|
+    // is the ring-buffer size in bytes. Stop() invalidates the clock until
+    // the next Publish(); drivers should call it when the ring stops.
+    void Publish(uint64_t position, zx_time_t timestamp,
+                 uint32_t bytes_per_sec, uint32_t ring_size);
+    void Stop();
+
+    // Client side. Computes the predicted position (in bytes, wrapped to
+    // the ring size) at time |now|. Returns false while the ring buffer is
+    // stopped.
+    bool PredictPosition(zx_time_t now, uint64_t* out_position) const;
+
+private:
+    DISALLOW_COPY_ASSIGN_AND_MOVE(RingBufferPositionClock);
+
+    fbl::atomic<uint32_t> seq_{0};
+    uint32_t active_ = 0;
+    uint64_t position_ = 0;
+    zx_time_t timestamp_ = 0;
+    uint32_t bytes_per_sec_ = 0;
+    uint32_t ring_size_ = 0;
+};
+
+static_assert(sizeof(RingBufferPositionClock) <= 64,
+              "RingBufferPositionClock must stay small; it lives in shared memory");
+
+}  // namespace utils
+}  // namespace audio
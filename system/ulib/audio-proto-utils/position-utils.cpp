@@ -0,0 +1,75 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <audio-proto-utils/position-utils.h>
+
+namespace audio {
+namespace utils {
+
+void RingBufferPositionClock::Publish(uint64_t position, zx_time_t timestamp,
+                                      uint32_t bytes_per_sec, uint32_t ring_size) {
+    // Odd sequence number while the triple is inconsistent. The release
+    // fence keeps the payload stores from moving above the first bump; the
+    // second bump publishes them.
+    uint32_t seq = seq_.load(fbl::memory_order_relaxed);
+    seq_.store(seq + 1, fbl::memory_order_relaxed);
+    fbl::atomic_thread_fence(fbl::memory_order_release);
+
+    position_ = position;
+    timestamp_ = timestamp;
+    bytes_per_sec_ = bytes_per_sec;
+    ring_size_ = ring_size;
+    active_ = 1u;
+
+    fbl::atomic_thread_fence(fbl::memory_order_release);
+    seq_.store(seq + 2, fbl::memory_order_relaxed);
+}
+
+void RingBufferPositionClock::Stop() {
+    uint32_t seq = seq_.load(fbl::memory_order_relaxed);
+    seq_.store(seq + 1, fbl::memory_order_relaxed);
+    fbl::atomic_thread_fence(fbl::memory_order_release);
+
+    active_ = 0u;
+
+    fbl::atomic_thread_fence(fbl::memory_order_release);
+    seq_.store(seq + 2, fbl::memory_order_relaxed);
+}
+
+bool RingBufferPositionClock::PredictPosition(zx_time_t now,
+                                              uint64_t* out_position) const {
+    uint64_t position;
+    zx_time_t timestamp;
+    uint32_t bytes_per_sec, ring_size, active;
+    uint32_t seq;
+
+    do {
+        while ((seq = seq_.load(fbl::memory_order_acquire)) & 1u) {
+            // writer in flight; spin until the triple is consistent
+        }
+
+        position = position_;
+        timestamp = timestamp_;
+        bytes_per_sec = bytes_per_sec_;
+        ring_size = ring_size_;
+        active = active_;
+
+        fbl::atomic_thread_fence(fbl::memory_order_acquire);
+    } while (seq_.load(fbl::memory_order_relaxed) != seq);
+
+    if (!active || (ring_size == 0u) || (bytes_per_sec == 0u)) {
+        return false;
+    }
+
+    if (now > timestamp) {
+        position += (static_cast<uint64_t>(now - timestamp) * bytes_per_sec) /
+                    ZX_SEC(1);
+    }
+
+    *out_position = position % ring_size;
+    return true;
+}
+
+}  // namespace utils
+}  // namespace audio
@@ -9,7 +9,8 @@ MODULE := $(LOCAL_DIR)
 MODULE_TYPE := userlib
 
 MODULE_SRCS += \
-    $(LOCAL_DIR)/format-utils.cpp
+    $(LOCAL_DIR)/format-utils.cpp \
+    $(LOCAL_DIR)/position-utils.cpp
 
 MODULE_STATIC_LIBS := \
     system/ulib/fbl
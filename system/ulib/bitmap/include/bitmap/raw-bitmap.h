@@ -64,6 +64,15 @@ public:
     zx_status_t ReverseFind(bool is_set, size_t bitoff, size_t bitmax,
                             size_t run_len, size_t* out) const;
 
+    // Like Find, but starts the search at the rolling hint left behind by
+    // the previous successful call, wrapping around to [*bitoff*, hint) if
+    // no run is found above the hint. On success the hint is advanced past
+    // the returned run, so callers that allocate in a loop (e.g. block
+    // allocators) do not rescan the fully-allocated prefix of the bitmap on
+    // every call. The hint is reset by ClearAll and clamped by Shrink.
+    zx_status_t FindWithHint(bool is_set, size_t bitoff, size_t bitmax,
+                             size_t run_len, size_t* out);
+
     // Returns true if all the bits in [*bitoff*, *bitmax*) are set. Afterwards,
     // *first_unset* will be set to the lesser of bitmax and the index of the
     // first unset bit after *bitoff*.
@@ -86,6 +95,8 @@ protected:
     size_t size_ = 0;
     // Owned by bits_, cached
     size_t* data_ = nullptr;
+    // Rolling search hint maintained by FindWithHint.
+    size_t hint_ = 0;
 };
 
 // A simple bitmap backed by generic storage.
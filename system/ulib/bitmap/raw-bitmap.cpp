@@ -80,6 +80,7 @@ zx_status_t RawBitmapBase::Shrink(size_t size) {
         return ZX_ERR_NO_MEMORY;
     }
     size_ = size;
+    hint_ = fbl::min(hint_, size_);
     return ZX_OK;
 }
 
@@ -90,6 +91,8 @@ bool RawBitmapBase::Scan(size_t bitoff, size_t bitmax, bool is_set,
         return true;
     }
     size_t i = FirstIdx(bitoff);
+    const size_t last = LastIdx(bitmax);
+    const size_t fill = is_set ? ~size_t(0) : size_t(0);
     while (true) {
         size_t masked = MaskBits(data_[i], i, bitoff, bitmax, is_set);
         if (masked != 0) {
@@ -98,10 +101,17 @@ bool RawBitmapBase::Scan(size_t bitoff, size_t bitmax, bool is_set,
             }
             return false;
         }
-        if (i == LastIdx(bitmax)) {
+        if (i == last) {
             return true;
         }
         ++i;
+        // Interior words need no masking: skip whole words matching is_set
+        // with a plain compare, which the compiler can unroll and
+        // vectorize.  The last word may need a partial mask, so stop short
+        // of it.
+        while (i < last && data_[i] == fill) {
+            ++i;
+        }
     }
 }
 
@@ -112,6 +122,8 @@ bool RawBitmapBase::ReverseScan(size_t bitoff, size_t bitmax, bool is_set,
         return true;
     }
     size_t i = LastIdx(bitmax);
+    const size_t first = FirstIdx(bitoff);
+    const size_t fill = is_set ? ~size_t(0) : size_t(0);
     while (true) {
         size_t masked = MaskBits(data_[i], i, bitoff, bitmax, is_set);
         if (masked != 0) {
@@ -120,10 +132,16 @@ bool RawBitmapBase::ReverseScan(size_t bitoff, size_t bitmax, bool is_set,
             }
             return false;
         }
-        if (i == FirstIdx(bitoff)) {
+        if (i == first) {
             return true;
         }
         --i;
+        // As in Scan: interior words need no masking, so skip whole words
+        // matching is_set with a plain compare.  The first word may need a
+        // partial mask, so stop short of it.
+        while (i > first && data_[i] == fill) {
+            --i;
+        }
     }
 }
 
@@ -145,6 +163,32 @@ zx_status_t RawBitmapBase::Find(bool is_set, size_t bitoff, size_t bitmax,
     }
 }
 
+zx_status_t RawBitmapBase::FindWithHint(bool is_set, size_t bitoff,
+                                        size_t bitmax, size_t run_len,
+                                        size_t* out) {
+    if (!out || bitmax <= bitoff) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    if (run_len > bitmax - bitoff) {
+        return ZX_ERR_NO_RESOURCES;
+    }
+    size_t start = fbl::max(bitoff, fbl::min(hint_, bitmax));
+    if (start < bitmax && Find(is_set, start, bitmax, run_len, out) == ZX_OK) {
+        hint_ = *out + run_len;
+        return ZX_OK;
+    }
+    // Nothing above the hint; wrap around and retry below it.  A run that
+    // straddles |start| begins before it, so every candidate is contained in
+    // [bitoff, start + run_len - 1).
+    if (start > bitoff &&
+        Find(is_set, bitoff, fbl::min(bitmax, start + run_len - 1), run_len,
+             out) == ZX_OK) {
+        hint_ = *out + run_len;
+        return ZX_OK;
+    }
+    return ZX_ERR_NO_RESOURCES;
+}
+
 zx_status_t RawBitmapBase::ReverseFind(bool is_set, size_t bitoff, size_t bitmax,
                                  size_t run_len, size_t* out) const {
     if (!out || bitmax <= bitoff) {
@@ -206,6 +250,7 @@ zx_status_t RawBitmapBase::Clear(size_t bitoff, size_t bitmax) {
 }
 
 void RawBitmapBase::ClearAll() {
+    hint_ = 0;
     if (size_ == 0) {
         return;
     }
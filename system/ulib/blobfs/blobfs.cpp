@@ -16,6 +16,7 @@
 #include <fbl/auto_call.h>
 #include <fbl/limits.h>
 #include <fbl/ref_ptr.h>
+#include <fbl/vector.h>
 #include <lib/fdio/debug.h>
 #include <fs/block-txn.h>
 #include <fs/ticker.h>
@@ -202,19 +203,119 @@ zx_status_t VnodeBlob::InitVmos() {
     }
 
     if ((inode_.flags & kBlobFlagLZ4Compressed) != 0) {
+        // Compressed blobs must be decompressed in full anyway; read and
+        // verify everything up front.
         if ((status = InitCompressed()) != ZX_OK) {
             return status;
         }
-    } else {
+        if ((status = Verify()) != ZX_OK) {
+            return status;
+        }
+    } else if (merkle_blocks == 0) {
+        // Small blobs have no Merkle tree; read and verify them in full.
         if ((status = InitUncompressed()) != ZX_OK) {
             return status;
         }
+        if ((status = Verify()) != ZX_OK) {
+            return status;
+        }
+    } else {
+        // Read only the Merkle tree now; data blocks are read and verified
+        // against it on first access (see |EnsureReadable|), so opening a
+        // large blob to read a small range avoids a full-file read and hash.
+        fs::Ticker ticker(blobfs_->CollectingMetrics());
+        fs::ReadTxn txn(blobfs_);
+        uint64_t start = inode_.start_block + DataStartBlock(blobfs_->info_);
+        txn.Enqueue(vmoid_, 0, start, merkle_blocks);
+        if ((status = txn.Transact()) != ZX_OK) {
+            FS_TRACE_ERROR("Failed to flush read transaction: %d\n", status);
+            return status;
+        }
+        blobfs_->UpdateMerkleDiskReadMetrics(merkle_blocks * kBlobfsBlockSize, ticker.End());
+        if ((status = valid_data_.Reset(data_blocks)) != ZX_OK) {
+            return status;
+        }
+    }
+
+    cleanup.cancel();
+    return ZX_OK;
+}
+
+zx_status_t VnodeBlob::EnsureReadable(uint64_t off, uint64_t len) {
+    if (valid_data_.size() == 0 || len == 0) {
+        // The blob was read and verified in full when it was initialized.
+        return ZX_OK;
     }
-    if ((status = Verify()) != ZX_OK) {
+    TRACE_DURATION("blobfs", "Blobfs::EnsureReadable", "off", off, "len", len);
+
+    const uint64_t merkle_blocks = MerkleTreeBlocks(inode_);
+    const uint64_t dev_start = inode_.start_block + DataStartBlock(blobfs_->info_);
+    uint64_t block = off / kBlobfsBlockSize;
+    uint64_t block_end = fbl::min((off + len + kBlobfsBlockSize - 1) / kBlobfsBlockSize,
+                                  valid_data_.size());
+
+    // Collect the runs of blocks which have not been read yet, and fetch them
+    // with a single transaction.
+    struct BlockRun {
+        uint64_t start;
+        uint64_t length;
+    };
+    fbl::Vector<BlockRun> runs;
+    fs::ReadTxn txn(blobfs_);
+    fs::Ticker ticker(blobfs_->CollectingMetrics());
+    uint64_t read_blocks = 0;
+    while (block < block_end) {
+        size_t run_start;
+        if (valid_data_.Get(block, block_end, &run_start)) {
+            break;
+        }
+        size_t run_end = block_end;
+        valid_data_.Scan(run_start, block_end, false, &run_end);
+        fbl::AllocChecker ac;
+        runs.push_back({run_start, run_end - run_start}, &ac);
+        if (!ac.check()) {
+            return ZX_ERR_NO_MEMORY;
+        }
+        txn.Enqueue(vmoid_, merkle_blocks + run_start, dev_start + merkle_blocks + run_start,
+                    run_end - run_start);
+        read_blocks += run_end - run_start;
+        block = run_end;
+    }
+    if (runs.is_empty()) {
+        return ZX_OK;
+    }
+    zx_status_t status;
+    if ((status = txn.Transact()) != ZX_OK) {
+        FS_TRACE_ERROR("Failed to flush read transaction: %d\n", status);
         return status;
     }
+    blobfs_->UpdateMerkleDiskReadMetrics(read_blocks * kBlobfsBlockSize, ticker.End());
 
-    cleanup.cancel();
+    // Verify only the Merkle paths covering the newly read blocks.
+    const void* data = GetData();
+    const void* tree = GetMerkle();
+    const uint64_t merkle_size = MerkleTree::GetTreeLength(inode_.blob_size);
+    Digest digest;
+    digest = reinterpret_cast<const uint8_t*>(&digest_[0]);
+    for (const BlockRun& run : runs) {
+        uint64_t data_off = run.start * kBlobfsBlockSize;
+        uint64_t data_len = fbl::min(run.length * kBlobfsBlockSize,
+                                     inode_.blob_size - data_off);
+        fs::Ticker verify_ticker(blobfs_->CollectingMetrics());
+        status = MerkleTree::Verify(data, inode_.blob_size, tree, merkle_size,
+                                    data_off, data_len, digest);
+        blobfs_->UpdateMerkleVerifyMetrics(data_len, merkle_size, verify_ticker.End());
+        if (status != ZX_OK) {
+            char name[Digest::kLength * 2 + 1];
+            ZX_ASSERT(digest.ToString(name, sizeof(name)) == ZX_OK);
+            FS_TRACE_ERROR("blobfs verify(%s) Failure: %s\n", name,
+                           zx_status_get_string(status));
+            return status;
+        }
+        if ((status = valid_data_.Set(run.start, run.start + run.length)) != ZX_OK) {
+            return status;
+        }
+    }
     return ZX_OK;
 }
 
@@ -383,17 +484,13 @@ zx_status_t VnodeBlob::SpaceAllocate(uint64_t size_data) {
 
     write_info_ = fbl::make_unique<WritebackInfo>();
     if (inode_.blob_size >= kCompressionMinBytesSaved) {
-        size_t max = write_info_->compressor.BufferMax(inode_.blob_size);
+        // The blob is compressed in parallel chunks once it has been fully
+        // buffered; reserve a buffer large enough for the resulting frames.
+        size_t max = ParallelCompressBufferMax(inode_.blob_size);
         status = fzl::MappedVmo::Create(max, "compressed-blob", &write_info_->compressed_blob);
         if (status != ZX_OK) {
             return status;
         }
-        status = write_info_->compressor.Initialize(write_info_->compressed_blob->GetData(),
-                                                    write_info_->compressed_blob->GetSize());
-        if (status != ZX_OK) {
-            fprintf(stderr, "blobfs: Failed to initalize compressor: %d\n", status);
-            return status;
-        }
     }
 
     SetState(kBlobStateDataWrite);
@@ -468,13 +565,6 @@ zx_status_t VnodeBlob::WriteInternal(const void* data, size_t len, size_t* actua
         *actual = to_write;
         write_info_->bytes_written += to_write;
 
-        if (write_info_->compressor.Compressing()) {
-            if ((status = write_info_->compressor.Update(data, to_write)) != ZX_OK) {
-                return status;
-            }
-            ConsiderCompressionAbort();
-        }
-
         // More data to write.
         if (write_info_->bytes_written < inode_.blob_size) {
             return ZX_OK;
@@ -487,16 +577,21 @@ zx_status_t VnodeBlob::WriteInternal(const void* data, size_t len, size_t* actua
             return status;
         }
 
-        if (write_info_->compressor.Compressing()) {
-            if ((status = write_info_->compressor.End()) != ZX_OK) {
+        if (write_info_->compressed_blob != nullptr) {
+            // The blob is fully buffered; compress it as independent frames
+            // on a pool of workers, then decide whether the compressed form
+            // is worth keeping.
+            if ((status = ParallelCompress(GetData(), inode_.blob_size,
+                                           write_info_->compressed_blob->GetData(),
+                                           &write_info_->compressed_size)) != ZX_OK) {
                 return status;
             }
             ConsiderCompressionAbort();
         }
 
         uint64_t dev_offset = DataStartBlock(blobfs_->info_) + inode_.start_block + merkle_blocks;
-        if (write_info_->compressor.Compressing()) {
-            uint64_t blocks = fbl::round_up(write_info_->compressor.Size(),
+        if (write_info_->compressed_blob != nullptr) {
+            uint64_t blocks = fbl::round_up(write_info_->compressed_size,
                                             kBlobfsBlockSize) / kBlobfsBlockSize;
             if ((status = EnqueuePaginated(&wb, blobfs_, this,
                                            write_info_->compressed_blob->GetVmo(),
@@ -528,8 +623,8 @@ zx_status_t VnodeBlob::WriteInternal(const void* data, size_t len, size_t* actua
             const void* blob_data = GetData();
             fs::Ticker ticker(blobfs_->CollectingMetrics()); // Tracking generation time.
 
-            if ((status = MerkleTree::Create(blob_data, inode_.blob_size, merkle_data,
-                                             merkle_size, &digest)) != ZX_OK) {
+            if ((status = MerkleTree::CreateParallel(blob_data, inode_.blob_size, merkle_data,
+                                                     merkle_size, &digest)) != ZX_OK) {
                 SetState(kBlobStateError);
                 return status;
             } else if (digest != digest_) {
@@ -565,9 +660,8 @@ zx_status_t VnodeBlob::WriteInternal(const void* data, size_t len, size_t* actua
 }
 
 void VnodeBlob::ConsiderCompressionAbort() {
-    ZX_DEBUG_ASSERT(write_info_->compressor.Compressing());
-    if (inode_.blob_size - kCompressionMinBytesSaved < write_info_->compressor.Size()) {
-        write_info_->compressor.Reset();
+    ZX_DEBUG_ASSERT(write_info_->compressed_blob != nullptr);
+    if (inode_.blob_size - kCompressionMinBytesSaved < write_info_->compressed_size) {
         write_info_->compressed_blob = nullptr;
     }
 }
@@ -604,6 +698,13 @@ zx_status_t VnodeBlob::CloneVmo(zx_rights_t rights, zx_handle_t* out) {
         return status;
     }
 
+    // Clients of the cloned VMO can touch any page without going through
+    // ReadInternal, so the entire blob must be resident and verified before
+    // the clone is handed out.
+    if ((status = EnsureReadable(0, inode_.blob_size)) != ZX_OK) {
+        return status;
+    }
+
     // TODO(smklein): Only clone / verify the part of the vmo that
     // was requested.
     const size_t merkle_bytes = MerkleTreeBlocks(inode_) * kBlobfsBlockSize;
@@ -670,6 +771,10 @@ zx_status_t VnodeBlob::ReadInternal(void* data, size_t len, size_t off, size_t*
         len = inode_.blob_size - off;
     }
 
+    if ((status = EnsureReadable(off, len)) != ZX_OK) {
+        return status;
+    }
+
     const size_t merkle_bytes = MerkleTreeBlocks(inode_) * kBlobfsBlockSize;
     status = zx_vmo_read(blob_->GetVmo(), data, merkle_bytes + off, len);
     if (status == ZX_OK) {
@@ -700,6 +805,16 @@ zx_status_t VnodeBlob::VerifyBlob(Blobfs* bs, size_t node_index) {
 
     // Set blob state to "Purged" so we do not try to add it to the cached map on recycle.
     vn->SetState(kBlobStatePurged);
+
+    // Lazily-loaded blobs are verified block-by-block as their data is pulled
+    // in; faulting the whole blob verifies all of it.
+    zx_status_t status = vn->EnsureReadable(0, vn->inode_.blob_size);
+    if (status != ZX_OK) {
+        return status;
+    }
+    if (vn->valid_data_.size() != 0) {
+        return ZX_OK;
+    }
     return vn->Verify();
 }
 
@@ -1362,6 +1477,16 @@ void Blobfs::UpdateMerkleVerifyMetrics(uint64_t size_data, uint64_t size_merkle,
     }
 }
 
+void Blobfs::UpdateClosedCacheMetrics(bool hit) {
+    if (CollectingMetrics()) {
+        if (hit) {
+            metrics_.closed_cache_hits++;
+        } else {
+            metrics_.closed_cache_misses++;
+        }
+    }
+}
+
 Blobfs::Blobfs(fbl::unique_fd fd, const blobfs_info_t* info)
     : blockfd_(fbl::move(fd)) {
     memcpy(&info_, info, sizeof(blobfs_info_t));
@@ -1371,6 +1496,7 @@ Blobfs::~Blobfs() {
     writeback_ = nullptr;
 
     ZX_ASSERT(open_hash_.is_empty());
+    cache_lru_.clear();
     closed_hash_.clear();
 
     if (blockfd_) {
@@ -1498,17 +1624,43 @@ zx_status_t Blobfs::VnodeInsertClosedLocked(fbl::RefPtr<VnodeBlob> vn) {
         vn->SetState(kBlobStatePurged);
         return ZX_ERR_ALREADY_EXISTS;
     }
-    vn->TearDown();
+    // Keep the blob's mapped data resident while it is closed, so a later
+    // re-open does not re-read and re-verify the contents from disk. Pinned
+    // blobs stay resident unconditionally; everything else is accounted
+    // against the cache budget and evicted in LRU order.
+    if (vn->CachedBytes() == 0) {
+        vn->TearDown();
+    } else if (!vn->Pinned()) {
+        cached_bytes_ += vn->CachedBytes();
+        cache_lru_.push_back(vn.get());
+        EvictCacheLocked();
+    }
     __UNUSED auto leak = vn.leak_ref();
     return ZX_OK;
 }
 
+void Blobfs::EvictCacheLocked() {
+    while (cached_bytes_ > cache_size_limit_ && !cache_lru_.is_empty()) {
+        VnodeBlob* vn = cache_lru_.pop_front();
+        cached_bytes_ -= vn->CachedBytes();
+        vn->TearDown();
+        if (CollectingMetrics()) {
+            metrics_.closed_cache_evictions++;
+        }
+    }
+}
+
 fbl::RefPtr<VnodeBlob> Blobfs::VnodeUpgradeLocked(const uint8_t* key) {
     ZX_DEBUG_ASSERT(open_hash_.find(key).CopyPointer() == nullptr);
     VnodeBlob* raw_vn = closed_hash_.erase(key);
     if (raw_vn == nullptr) {
         return nullptr;
     }
+    if (raw_vn->InLruCache()) {
+        cache_lru_.erase(*raw_vn);
+        cached_bytes_ -= raw_vn->CachedBytes();
+    }
+    UpdateClosedCacheMetrics(raw_vn->CachedBytes() > 0);
     open_hash_.insert(raw_vn);
     // To have existed in the closed_hash_, this RefPtr must have
     // been leaked.
@@ -1593,6 +1745,7 @@ zx_status_t blobfs_mount(async_dispatcher_t* dispatcher, fbl::unique_fd blockfd,
 
     fs->SetDispatcher(dispatcher);
     fs->SetReadonly(options->readonly);
+    fs->SetCacheSize(options->cache_size);
     if (options->metrics) {
         fs->CollectMetrics();
     }
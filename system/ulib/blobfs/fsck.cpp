@@ -6,7 +6,11 @@
 #include <inttypes.h>
 
 #ifdef __Fuchsia__
+#include <threads.h>
+
 #include <blobfs/blobfs.h>
+#include <fbl/algorithm.h>
+#include <zircon/syscalls.h>
 #else
 #include <blobfs/host.h>
 #endif
@@ -14,6 +18,98 @@
 //TODO(planders): Add more checks for fsck.
 namespace blobfs {
 
+#ifdef __Fuchsia__
+namespace {
+
+// Maximum number of threads verifying blobs concurrently. Each worker
+// issues reads through its own block FIFO transaction group.
+constexpr uint32_t kMaxCheckWorkers = MAX_TXN_GROUP_COUNT;
+
+} // namespace
+
+struct BlobfsChecker::CheckWorker {
+    BlobfsChecker* checker = nullptr;
+    // Accumulated locally by each worker and merged by the coordinating
+    // thread after the worker is joined, so the counters need no
+    // synchronization.
+    uint32_t alloc_inodes = 0;
+    uint32_t error_blobs = 0;
+    uint32_t inode_blocks = 0;
+};
+
+int BlobfsChecker::CheckInodeWorkerThread(void* arg) {
+    auto* w = static_cast<CheckWorker*>(arg);
+    BlobfsChecker* chk = w->checker;
+    const uint64_t inode_count = chk->blobfs_->info_.inode_count;
+
+    // Workers claim the next unchecked inode from a shared cursor, so a
+    // worker stuck verifying one large blob does not hold up the others.
+    uint64_t n;
+    while ((n = chk->next_inode_.fetch_add(1)) < inode_count) {
+        blobfs_inode_t* inode = chk->blobfs_->GetNode(n);
+        if (inode->start_block < kStartBlockMinimum) {
+            continue;
+        }
+        w->alloc_inodes++;
+        w->inode_blocks += static_cast<uint32_t>(inode->num_blocks);
+
+        size_t start_block = inode->start_block;
+        size_t end_block = inode->start_block + inode->num_blocks;
+        bool valid = true;
+
+        size_t first_unset = 0;
+        if (!chk->blobfs_->block_map_.Get(start_block, end_block, &first_unset)) {
+            FS_TRACE_ERROR("check: ino %" PRIu64 " using blocks [%zu, %zu). "
+                           "Not fully allocated in block bitmap; first unset @%zu\n",
+                           n, start_block, end_block, first_unset);
+            valid = false;
+        }
+
+        if (chk->blobfs_->VerifyBlob(n) != ZX_OK) {
+            FS_TRACE_ERROR("check: detected inode %" PRIu64 " with bad state\n", n);
+            valid = false;
+        }
+        if (!valid) {
+            w->error_blobs++;
+        }
+    }
+    return 0;
+}
+
+void BlobfsChecker::TraverseInodeBitmap() {
+    // Verifying blob contents is dominated by device reads and Merkle tree
+    // hashing, both of which scale with cores, so fan the inode scan out to
+    // a pool of workers.
+    uint32_t workers = fbl::min(zx_system_get_num_cpus(), kMaxCheckWorkers);
+    CheckWorker work[kMaxCheckWorkers];
+    thrd_t threads[kMaxCheckWorkers];
+    bool spawned[kMaxCheckWorkers] = {};
+    next_inode_.store(0);
+    for (uint32_t i = 0; i < workers; i++) {
+        work[i].checker = this;
+    }
+
+    // Fan all but the first worker out to threads; if a thread cannot be
+    // created its share of inodes is simply claimed by the others. The
+    // first worker always runs on the calling thread.
+    for (uint32_t i = 1; i < workers; i++) {
+        spawned[i] = thrd_create_with_name(&threads[i], CheckInodeWorkerThread, &work[i],
+                                           "blobfs-check") == thrd_success;
+    }
+    CheckInodeWorkerThread(&work[0]);
+    for (uint32_t i = 1; i < workers; i++) {
+        if (spawned[i]) {
+            thrd_join(threads[i], nullptr);
+        }
+    }
+
+    for (uint32_t i = 0; i < workers; i++) {
+        alloc_inodes_ += work[i].alloc_inodes;
+        error_blobs_ += work[i].error_blobs;
+        inode_blocks_ += work[i].inode_blocks;
+    }
+}
+#else
 void BlobfsChecker::TraverseInodeBitmap() {
     for (unsigned n = 0; n < blobfs_->info_.inode_count; n++) {
         blobfs_inode_t* inode = blobfs_->GetNode(n);
@@ -43,6 +139,7 @@ void BlobfsChecker::TraverseInodeBitmap() {
         }
     }
 }
+#endif
 
 void BlobfsChecker::TraverseBlockBitmap() {
     for (uint64_t n = 0; n < blobfs_->info_.block_count; n++) {
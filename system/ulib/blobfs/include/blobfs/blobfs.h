@@ -71,6 +71,7 @@ constexpr BlobFlags kBlobStateMask        = 0x000000FF;
 // Informational non-state flags:
 constexpr BlobFlags kBlobFlagDeletable    = 0x00000100; // This node should be unlinked when closed
 constexpr BlobFlags kBlobFlagDirectory    = 0x00000200; // This node represents the root directory
+constexpr BlobFlags kBlobFlagPinned       = 0x00000400; // This node's data is exempt from eviction
 constexpr BlobFlags kBlobOtherMask        = 0x0000FF00;
 
 // clang-format on
@@ -82,6 +83,10 @@ public:
     struct TypeWavlTraits {
         static WAVLTreeNodeState& node_state(VnodeBlob& b) { return b.type_wavl_state_; }
     };
+    using LruNodeState = fbl::DoublyLinkedListNodeState<VnodeBlob*>;
+    struct TypeLruTraits {
+        static LruNodeState& node_state(VnodeBlob& b) { return b.type_lru_state_; }
+    };
     const uint8_t* GetKey() const {
         return &digest_[0];
     };
@@ -103,6 +108,28 @@ public:
         return flags_ & kBlobFlagDeletable;
     }
 
+    bool Pinned() const {
+        return flags_ & kBlobFlagPinned;
+    }
+
+    void SetPinned(bool pinned) {
+        if (pinned) {
+            flags_ |= kBlobFlagPinned;
+        } else {
+            flags_ &= ~kBlobFlagPinned;
+        }
+    }
+
+    // Returns the number of bytes of mapped data this blob keeps resident
+    // in the closed cache (zero if there is nothing worth caching).
+    size_t CachedBytes() const {
+        return (blob_ != nullptr && GetState() == kBlobStateReadable) ? blob_->GetSize() : 0;
+    }
+
+    bool InLruCache() const {
+        return type_lru_state_.InContainer();
+    }
+
     void SetState(BlobFlags new_state) {
         flags_ = (flags_ & ~kBlobStateMask) | new_state;
     }
@@ -150,6 +177,7 @@ public:
 
 private:
     friend struct TypeWavlTraits;
+    friend struct TypeLruTraits;
 
     DISALLOW_COPY_ASSIGN_AND_MOVE(VnodeBlob);
 
@@ -190,17 +218,24 @@ private:
     // depending on the state.
     zx_status_t WriteInternal(const void* data, size_t len, size_t* actual);
 
-    // For a blob being written, consider stopping the compressor,
-    // the blob to eventually be written uncompressed to disk.
+    // For a blob which has been fully buffered and compressed, consider
+    // discarding the compressed form, so the blob is eventually written
+    // uncompressed to disk.
     //
     // For blobs which don't compress very well, this provides an escape
-    // hatch to avoid wasting work.
+    // hatch to avoid wasting space.
     void ConsiderCompressionAbort();
 
     // Reads from a blob.
     // Requires: kBlobStateReadable
     zx_status_t ReadInternal(void* data, size_t len, size_t off, size_t* actual);
 
+    // Ensures the data bytes in [off, off + len) are resident in |blob_| and
+    // have been verified against the Merkle tree. For lazily-loaded blobs,
+    // this reads and verifies the covering blocks on first access; otherwise
+    // it is a no-op.
+    zx_status_t EnsureReadable(uint64_t off, uint64_t len);
+
     // Vnode I/O operations
     zx_status_t GetHandles(uint32_t flags, zx_handle_t* hnd, uint32_t* type,
                            zxrio_node_info_t* extra) final;
@@ -251,6 +286,7 @@ private:
     void* GetMerkle() const;
 
     WAVLTreeNodeState type_wavl_state_ = {};
+    LruNodeState type_lru_state_ = {};
 
     Blobfs* const blobfs_;
     BlobFlags flags_ = {};
@@ -279,16 +315,27 @@ private:
     size_t map_index_ = {};
     blobfs_inode_t inode_ = {};
 
+    // Tracks which data blocks have been read and verified for blobs which
+    // are loaded lazily (uncompressed, with a Merkle tree). A size of zero
+    // indicates the blob is fully resident and verified up front.
+    RawBitmap valid_data_ = {};
+
     // Data used exclusively during writeback.
     struct WritebackInfo {
         uint64_t bytes_written = {};
-        Compressor compressor;
+        // Size of the compressed stream; valid once the blob has been fully
+        // buffered and compressed, while |compressed_blob| is non-null.
+        size_t compressed_size = {};
         fbl::unique_ptr<fzl::MappedVmo> compressed_blob = {};
     };
 
     fbl::unique_ptr<WritebackInfo> write_info_ = {};
 };
 
+// Default budget, in bytes, for keeping the mapped data of closed blobs
+// resident. Pinned blobs are exempt from this budget.
+constexpr size_t kDefaultClosedCacheBytes = 16 << 20;
+
 // We need to define this structure to allow the Blob to be indexable by a key
 // which is larger than a primitive type: the keys are 'Digest::kLength'
 // bytes long.
@@ -341,6 +388,9 @@ public:
     static zx_status_t Create(fbl::unique_fd blockfd, const blobfs_info_t* info,
                               fbl::unique_ptr<Blobfs>* out);
 
+    // Sets the budget, in bytes, for keeping closed blobs' data resident.
+    void SetCacheSize(size_t bytes) { cache_size_limit_ = bytes; }
+
     void CollectMetrics() { collecting_metrics_ = true; }
     bool CollectingMetrics() const { return collecting_metrics_; }
     void DisableMetrics() { collecting_metrics_ = false; }
@@ -442,6 +492,10 @@ public:
     void UpdateMerkleVerifyMetrics(uint64_t size_data, uint64_t size_merkle,
                                    const fs::Duration& duration);
 
+    // Updates aggregate information about re-opening closed blobs which
+    // may (hit) or may not (miss) still have their data resident.
+    void UpdateClosedCacheMetrics(bool hit);
+
     blobfs_info_t info_;
 
     zx_status_t CreateWork(fbl::unique_ptr<WritebackWork>* out, VnodeBlob* vnode) {
@@ -483,9 +537,14 @@ private:
     zx_status_t LoadBitmaps();
     fbl::unique_ptr<WritebackBuffer> writeback_;
 
-    // Inserts a Vnode into the |closed_hash_|, tears down
-    // cache Vnode state, and leaks a reference to the Vnode
-    // if it was added to the cache successfully.
+    // Inserts a Vnode into the |closed_hash_| and leaks a reference
+    // to the Vnode if it was added to the cache successfully.
+    //
+    // If the Vnode has readable data resident, the data is kept mapped
+    // so a later re-open does not re-read it from disk; unpinned blobs
+    // are tracked in |cache_lru_| and evicted in LRU order once
+    // |cache_size_limit_| is exceeded. Vnodes with nothing to cache are
+    // torn down as before.
     //
     // This prevents the vnode from ever being torn down, unless
     // it is re-acquired from |closed_hash_| and released manually
@@ -494,6 +553,10 @@ private:
     // Returns an error if the Vnode already exists in the cache.
     zx_status_t VnodeInsertClosedLocked(fbl::RefPtr<VnodeBlob> vn) __TA_REQUIRES(hash_lock_);
 
+    // Tears down the least recently used unpinned blobs in |cache_lru_|
+    // until the resident data fits within |cache_size_limit_|.
+    void EvictCacheLocked() __TA_REQUIRES(hash_lock_);
+
     // Upgrades a Vnode which exists in the |closed_hash_| into |open_hash_|,
     // and acquire the strong reference the Vnode which was leaked by
     // |VnodeInsertClosedLocked()|, if it exists.
@@ -566,6 +629,14 @@ private:
     WAVLTreeByMerkle open_hash_ __TA_GUARDED(hash_lock_){};   // All 'in use' blobs.
     WAVLTreeByMerkle closed_hash_ __TA_GUARDED(hash_lock_){}; // All 'closed' blobs.
 
+    // Closed blobs which still have their mapped data resident, from least
+    // to most recently used. Pinned blobs are kept resident but are not
+    // tracked here (or counted against the budget), so they are never evicted.
+    using LruCacheList = fbl::DoublyLinkedList<VnodeBlob*, VnodeBlob::TypeLruTraits>;
+    LruCacheList cache_lru_ __TA_GUARDED(hash_lock_){};
+    size_t cached_bytes_ __TA_GUARDED(hash_lock_) = 0;
+    size_t cache_size_limit_ = kDefaultClosedCacheBytes;
+
     fbl::unique_fd blockfd_;
     block_info_t block_info_ = {};
     fbl::atomic<groupid_t> next_group_ = {};
@@ -599,6 +670,7 @@ private:
 typedef struct {
     bool readonly = false;
     bool metrics = false;
+    size_t cache_size = kDefaultClosedCacheBytes;
 } blob_options_t;
 
 zx_status_t blobfs_create(fbl::unique_ptr<Blobfs>* out, fbl::unique_fd blockfd);
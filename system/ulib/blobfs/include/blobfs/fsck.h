@@ -15,6 +15,7 @@
 
 #ifdef __Fuchsia__
 #include <blobfs/blobfs.h>
+#include <fbl/atomic.h>
 #else
 #include <blobfs/host.h>
 #endif
@@ -31,6 +32,16 @@ public:
 
 private:
     DISALLOW_COPY_ASSIGN_AND_MOVE(BlobfsChecker);
+
+#ifdef __Fuchsia__
+    // Per-thread state for the parallel inode pass; see fsck.cpp.
+    struct CheckWorker;
+    static int CheckInodeWorkerThread(void* arg);
+
+    // Shared cursor from which workers claim the next inode to check.
+    fbl::atomic<uint64_t> next_inode_{};
+#endif
+
     fbl::unique_ptr<Blobfs> blobfs_;
     uint32_t alloc_inodes_;
     uint32_t alloc_blocks_;
@@ -64,6 +64,21 @@ private:
     size_t buf_used_;
 };
 
+#ifdef __Fuchsia__
+// Returns the maximum possible size a buffer would need to be in order to
+// hold |length| bytes compressed by |ParallelCompress()|.
+size_t ParallelCompressBufferMax(size_t length);
+
+// Compresses |length| bytes from |data| into |buf| as a sequence of
+// independent LZ4 frames, one per chunk of input, compressing the chunks on
+// a pool of worker threads and merging the frames back in order. The
+// resulting stream is decodable by |Decompressor|.
+//
+// |buf| must be at least |ParallelCompressBufferMax(length)| bytes; the
+// number of bytes produced is returned in |out_size|.
+zx_status_t ParallelCompress(const void* data, size_t length, void* buf, size_t* out_size);
+#endif
+
 // A Decompressor is used to decompress a blob transparently before it is
 // read back from disk.
 class Decompressor {
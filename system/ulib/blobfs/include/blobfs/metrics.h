@@ -53,6 +53,17 @@ struct BlobfsMetrics {
     uint64_t bytes_compressed_read_from_disk = 0;
     uint64_t bytes_decompressed_from_disk = 0;
 
+    // CLOSED CACHE STATS
+
+    // Re-opens of closed blobs which still had their data resident,
+    // avoiding a re-read and re-verification from disk.
+    uint64_t closed_cache_hits = 0;
+    // Re-opens of closed blobs whose data had been evicted (or was
+    // never resident), requiring reads from the device on access.
+    uint64_t closed_cache_misses = 0;
+    // Blobs whose resident data was dropped to stay within the cache budget.
+    uint64_t closed_cache_evictions = 0;
+
     // Opened via "LookupBlob".
     uint64_t blobs_opened = 0;
     uint64_t blobs_opened_total_size = 0;
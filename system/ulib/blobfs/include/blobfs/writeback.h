@@ -67,6 +67,12 @@ public:
 
     fbl::Vector<write_request_t>& Requests() { return requests_; }
 
+    // Appends the enqueued requests to |out| as block device requests
+    // (converted to disk blocks), and clears the transaction. Used when
+    // several transactions are submitted to the device as a single group.
+    // The transaction must be ready (attached to the writeback buffer).
+    void AppendRequests(fbl::Vector<block_fifo_request_t>* out);
+
     size_t BlkStart() const;
     size_t BlkCount() const;
 
@@ -80,10 +86,6 @@ public:
         vmoid_ = vmoid;
     }
 
-protected:
-    // Activate the transaction.
-    zx_status_t Flush();
-
 private:
     friend class WritebackBuffer;
     Blobfs* bs_;
@@ -105,9 +107,11 @@ public:
     // after being created.
     void Reset();
 
-    // Actually transacts the enqueued work, and resets the WritebackWork to
-    // its initial state.
-    zx_status_t Complete();
+    // Signals the sync completion and closure (if any) with |status| and
+    // resets the WritebackWork, without touching the device; the enqueued
+    // requests must already have been submitted as part of a batched group
+    // (see WriteTxn::AppendRequests).
+    void MarkCompleted(zx_status_t status);
 
     // Adds a closure to the WritebackWork, such that it will be signalled
     // when the WritebackWork is flushed to disk.
@@ -177,6 +181,11 @@ private:
     // safely guarantee that space exists within the buffer.
     void CopyToBufferLocked(WriteTxn* txn) __TA_REQUIRES(writeback_lock_);
 
+    // Submits all work units in |group| to the device as a single sorted
+    // transaction and marks them completed. Returns the number of writeback
+    // buffer blocks consumed by the group.
+    size_t CompleteGroup(fbl::Vector<fbl::unique_ptr<WritebackWork>>* group);
+
     static int WritebackThread(void* arg);
 
     // The waiter struct may be used as a stack-allocated queue for producers.
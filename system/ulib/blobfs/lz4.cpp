@@ -4,8 +4,14 @@
 
 #include <lz4/lz4frame.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 
+#ifdef __Fuchsia__
+#include <threads.h>
+#include <zircon/syscalls.h>
+#endif
+
 #include <fbl/algorithm.h>
 #include <fbl/auto_call.h>
 #include <fbl/macros.h>
@@ -73,6 +79,110 @@ size_t Compressor::Size() const {
     return buf_used_;
 }
 
+#ifdef __Fuchsia__
+
+namespace {
+
+// Blobs are split into chunks of at least this size before being fanned out
+// to compression workers; each chunk becomes an independent LZ4 frame.
+constexpr size_t kCompressionChunkSize = (1 << 20);
+
+// Upper bound on the number of chunks (and therefore worker threads) used
+// for a single blob, regardless of how many cores are available.
+constexpr size_t kMaxCompressionChunks = 16;
+
+struct CompressWork {
+    const uint8_t* src;
+    size_t src_len;
+    uint8_t* dst;
+    size_t dst_max;
+    size_t dst_len;
+    zx_status_t status;
+};
+
+int CompressionWorker(void* arg) {
+    CompressWork* work = static_cast<CompressWork*>(arg);
+    size_t r = LZ4F_compressFrame(work->dst, work->dst_max, work->src, work->src_len, nullptr);
+    if (LZ4F_isError(r)) {
+        work->status = ZX_ERR_IO_DATA_INTEGRITY;
+        return 0;
+    }
+    work->dst_len = r;
+    work->status = ZX_OK;
+    return 0;
+}
+
+// Returns the number of chunks |length| bytes should be split into.
+size_t CompressionChunks(size_t length) {
+    size_t chunks = (length + kCompressionChunkSize - 1) / kCompressionChunkSize;
+    chunks = fbl::min(chunks, static_cast<size_t>(zx_system_get_num_cpus()));
+    chunks = fbl::min(chunks, kMaxCompressionChunks);
+    return fbl::max(chunks, static_cast<size_t>(1));
+}
+
+} // namespace
+
+size_t ParallelCompressBufferMax(size_t length) {
+    size_t chunks = CompressionChunks(length);
+    size_t chunk_len = (length + chunks - 1) / chunks;
+    return chunks * LZ4F_compressFrameBound(chunk_len, nullptr);
+}
+
+zx_status_t ParallelCompress(const void* data, size_t length, void* buf, size_t* out_size) {
+    TRACE_DURATION("blobfs", "ParallelCompress", "length", length);
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    uint8_t* dst = static_cast<uint8_t*>(buf);
+    const size_t chunks = CompressionChunks(length);
+    const size_t chunk_len = (length + chunks - 1) / chunks;
+    const size_t dst_stride = LZ4F_compressFrameBound(chunk_len, nullptr);
+
+    CompressWork work[kMaxCompressionChunks];
+    thrd_t threads[kMaxCompressionChunks];
+    bool spawned[kMaxCompressionChunks] = {};
+    for (size_t i = 0; i < chunks; i++) {
+        work[i].src = src + i * chunk_len;
+        work[i].src_len = fbl::min(chunk_len, length - i * chunk_len);
+        work[i].dst = dst + i * dst_stride;
+        work[i].dst_max = dst_stride;
+        work[i].dst_len = 0;
+        work[i].status = ZX_ERR_INTERNAL;
+    }
+
+    // Fan all but the first chunk out to workers; if a thread cannot be
+    // created, compress that chunk inline instead. The first chunk is always
+    // compressed on the calling thread.
+    for (size_t i = 1; i < chunks; i++) {
+        spawned[i] = thrd_create_with_name(&threads[i], CompressionWorker, &work[i],
+                                           "blobfs-compress") == thrd_success;
+        if (!spawned[i]) {
+            CompressionWorker(&work[i]);
+        }
+    }
+    CompressionWorker(&work[0]);
+    for (size_t i = 1; i < chunks; i++) {
+        if (spawned[i]) {
+            thrd_join(threads[i], nullptr);
+        }
+    }
+
+    // Merge the frames back in order. Each frame is no larger than its
+    // staging slot, so the stream can be compacted in place, left to right.
+    size_t used = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        if (work[i].status != ZX_OK) {
+            return work[i].status;
+        }
+        if (work[i].dst != dst + used) {
+            memmove(dst + used, work[i].dst, work[i].dst_len);
+        }
+        used += work[i].dst_len;
+    }
+    *out_size = used;
+    return ZX_OK;
+}
+
+#endif // __Fuchsia__
+
 zx_status_t Decompressor::Decompress(void* target_buf_, size_t* target_size,
                                      const void* src_buf_, size_t* src_size) {
     TRACE_DURATION("blobfs", "Decompressor::Decompress", "target_size", *target_size,
@@ -111,7 +221,15 @@ zx_status_t Decompressor::Decompress(void* target_buf_, size_t* target_size,
         src_drained += src_sz_next;
 
         if (r == 0) {
-            break;
+            // Reached the end of a frame. The stream may contain additional
+            // frames (the parallel compressor emits one per chunk), so keep
+            // decoding until either buffer is drained.
+            if (target_drained >= *target_size || src_drained >= *src_size) {
+                break;
+            }
+            dst_sz_next = 0;
+            src_sz_next = 4;
+            continue;
         }
 
         dst_sz_next = *target_size - target_drained;
@@ -45,6 +45,11 @@ void BlobfsMetrics::Dump() const {
            TicksToMs(total_read_from_disk_time_ticks),
            bytes_read_from_disk / mb,
            TicksToMs(total_verification_time_ticks));
+    printf("Closed Cache Info:\n");
+    printf("  %zu hits, %zu misses re-opening closed blobs\n",
+           closed_cache_hits, closed_cache_misses);
+    printf("  Evicted %zu blobs to stay within the cache budget\n",
+           closed_cache_evictions);
 }
 
 } // namespace blobfs
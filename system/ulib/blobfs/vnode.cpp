@@ -190,6 +190,16 @@ zx_status_t VnodeBlob::Ioctl(uint32_t op, const void* in_buf, size_t in_len, voi
         *out_actual = sizeof(vfs_query_info_t) + strlen(kFsName);
         return ZX_OK;
     }
+    case IOCTL_VFS_PIN_CACHE:
+    case IOCTL_VFS_UNPIN_CACHE: {
+        if (IsDirectory()) {
+            return ZX_ERR_NOT_SUPPORTED;
+        }
+        // The blob is open, so it is not in the closed cache; the flag
+        // takes effect the next time the last reference is dropped.
+        SetPinned(op == IOCTL_VFS_PIN_CACHE);
+        return ZX_OK;
+    }
 #ifdef __Fuchsia__
     case IOCTL_VFS_GET_DEVICE_PATH: {
         ssize_t len = ioctl_device_get_topo_path(blobfs_->Fd(), static_cast<char*>(out_buf), out_len);
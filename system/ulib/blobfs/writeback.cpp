@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdlib.h>
+
 #include <blobfs/blobfs.h>
 #include <blobfs/writeback.h>
 
@@ -36,40 +38,28 @@ void WriteTxn::Enqueue(zx_handle_t vmo, uint64_t relative_block, uint64_t absolu
     requests_.push_back(fbl::move(request));
 }
 
-zx_status_t WriteTxn::Flush() {
+void WriteTxn::AppendRequests(fbl::Vector<block_fifo_request_t>* out) {
     ZX_ASSERT(IsReady());
-    fs::Ticker ticker(bs_->CollectingMetrics());
 
     // Update all the outgoing transactions to be in disk blocks
-    block_fifo_request_t blk_reqs[requests_.size()];
     const uint32_t kDiskBlocksPerBlobfsBlock = kBlobfsBlockSize / bs_->DeviceBlockSize();
     for (size_t i = 0; i < requests_.size(); i++) {
-        blk_reqs[i].group = bs_->BlockGroupID();
-        blk_reqs[i].vmoid = vmoid_;
-        blk_reqs[i].opcode = BLOCKIO_WRITE;
-        blk_reqs[i].vmo_offset = requests_[i].vmo_offset * kDiskBlocksPerBlobfsBlock;
-        blk_reqs[i].dev_offset = requests_[i].dev_offset * kDiskBlocksPerBlobfsBlock;
+        block_fifo_request_t blk_req;
+        blk_req.group = bs_->BlockGroupID();
+        blk_req.vmoid = vmoid_;
+        blk_req.opcode = BLOCKIO_WRITE;
+        blk_req.vmo_offset = requests_[i].vmo_offset * kDiskBlocksPerBlobfsBlock;
+        blk_req.dev_offset = requests_[i].dev_offset * kDiskBlocksPerBlobfsBlock;
         uint64_t length = requests_[i].length * kDiskBlocksPerBlobfsBlock;
         // TODO(ZX-2253): Requests this long, although unlikely, should be
         // handled more gracefully.
         ZX_ASSERT_MSG(length < UINT32_MAX, "Request size too large");
-        blk_reqs[i].length = static_cast<uint32_t>(length);
-    }
-
-    // Actually send the operations to the underlying block device.
-    zx_status_t status = bs_->Transaction(blk_reqs, requests_.size());
-
-    if (bs_->CollectingMetrics()) {
-        uint64_t sum = 0;
-        for (size_t i = 0; i < requests_.size(); i++) {
-            sum += blk_reqs[i].length * kBlobfsBlockSize;
-        }
-        bs_->UpdateWritebackMetrics(sum, ticker.End());
+        blk_req.length = static_cast<uint32_t>(length);
+        out->push_back(blk_req);
     }
 
     requests_.reset();
     vmoid_ = VMOID_INVALID;
-    return status;
 }
 
 size_t WriteTxn::BlkStart() const {
@@ -100,10 +90,7 @@ void WritebackWork::SetSyncComplete() {
     sync_ = true;
 }
 
-// Returns the number of blocks of the writeback buffer that have been consumed
-zx_status_t WritebackWork::Complete() {
-    zx_status_t status = Flush();
-
+void WritebackWork::MarkCompleted(zx_status_t status) {
     //TODO(planders): On flush failure, convert fs to read-only
     if (status == ZX_OK && sync_) {
         vn_->CompleteSync();
@@ -114,7 +101,6 @@ zx_status_t WritebackWork::Complete() {
     }
 
     Reset();
-    return ZX_OK;
 }
 
 void WritebackWork::SetClosure(SyncCallback closure) {
@@ -275,30 +261,93 @@ void WritebackBuffer::Enqueue(fbl::unique_ptr<WritebackWork> work) {
     cnd_signal(&consumer_cvar_);
 }
 
+namespace {
+
+int CompareBlockRequests(const void* a, const void* b) {
+    auto* left = static_cast<const block_fifo_request_t*>(a);
+    auto* right = static_cast<const block_fifo_request_t*>(b);
+    if (left->dev_offset < right->dev_offset) {
+        return -1;
+    }
+    return (left->dev_offset > right->dev_offset) ? 1 : 0;
+}
+
+} // namespace
+
+size_t WritebackBuffer::CompleteGroup(fbl::Vector<fbl::unique_ptr<WritebackWork>>* group) {
+    TRACE_DURATION("blobfs", "WritebackBuffer::CompleteGroup", "works", group->size());
+    fs::Ticker ticker(bs_->CollectingMetrics());
+
+    // Gather the requests of every work unit into a single submission.
+    // All of them read from the writeback buffer, so they are free to be
+    // reordered relative to each other.
+    size_t blk_count = 0;
+    fbl::Vector<block_fifo_request_t> blk_reqs;
+    for (size_t i = 0; i < group->size(); i++) {
+        blk_count += (*group)[i]->BlkCount();
+        (*group)[i]->AppendRequests(&blk_reqs);
+    }
+
+    // Sort the combined requests by device offset, then merge any which
+    // ended up adjacent both on the device and in the writeback buffer, so
+    // the device sees one mostly-sequential stream per group.
+    zx_status_t status = ZX_OK;
+    size_t req_count = 0;
+    if (!blk_reqs.is_empty()) {
+        qsort(blk_reqs.get(), blk_reqs.size(), sizeof(block_fifo_request_t),
+              CompareBlockRequests);
+        size_t out = 0;
+        for (size_t i = 1; i < blk_reqs.size(); i++) {
+            if ((blk_reqs[out].dev_offset + blk_reqs[out].length == blk_reqs[i].dev_offset) &&
+                (blk_reqs[out].vmo_offset + blk_reqs[out].length == blk_reqs[i].vmo_offset)) {
+                blk_reqs[out].length += blk_reqs[i].length;
+            } else {
+                blk_reqs[++out] = blk_reqs[i];
+            }
+        }
+        req_count = out + 1;
+        status = bs_->Transaction(blk_reqs.get(), req_count);
+    }
+
+    if (bs_->CollectingMetrics()) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < req_count; i++) {
+            sum += blk_reqs[i].length * kBlobfsBlockSize;
+        }
+        bs_->UpdateWritebackMetrics(sum, ticker.End());
+    }
+
+    for (size_t i = 0; i < group->size(); i++) {
+        auto work = fbl::move((*group)[i]);
+        work->MarkCompleted(status);
+    }
+    return blk_count;
+}
+
 int WritebackBuffer::WritebackThread(void* arg) {
     WritebackBuffer* b = reinterpret_cast<WritebackBuffer*>(arg);
 
     b->writeback_lock_.Acquire();
     while (true) {
         while (!b->work_queue_.is_empty()) {
-            auto work = b->work_queue_.pop();
-            TRACE_DURATION("blobfs", "WritebackBuffer::WritebackThread", "work ptr", work.get());
-
-            size_t blk_count = work->BlkCount();
-
-            if (blk_count > 0) {
-                ZX_ASSERT(work->BlkStart() == b->start_);
-                ZX_ASSERT(blk_count <= b->len_);
+            TRACE_DURATION("blobfs", "WritebackBuffer::WritebackThread");
+
+            // Pop everything which is currently pending, so a burst of
+            // small blobs is submitted to the device as a single group
+            // rather than one transaction (and one completion wait) each.
+            fbl::Vector<fbl::unique_ptr<WritebackWork>> group;
+            while (!b->work_queue_.is_empty()) {
+                group.push_back(b->work_queue_.pop());
             }
 
-            // Stay unlocked while processing a unit of work
+            // Stay unlocked while processing the group
             b->writeback_lock_.Release();
-            work->Complete();
-            work = nullptr;
+            size_t blks_consumed = b->CompleteGroup(&group);
             b->writeback_lock_.Acquire();
-            b->start_ = (b->start_ + blk_count) % b->cap_;
-            b->len_ -= blk_count;
-            cnd_signal(&b->producer_cvar_);
+            b->start_ = (b->start_ + blks_consumed) % b->cap_;
+            b->len_ -= blks_consumed;
+            // A group may free space for several waiting producers at once.
+            cnd_broadcast(&b->producer_cvar_);
         }
 
         // Before waiting, we should check if we're unmounting.
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <assert.h>
+#include <threads.h>
 #include <unistd.h>
 
 #include <block-client/client.h>
@@ -11,6 +12,9 @@
 #include <zircon/syscalls.h>
 #include <lib/sync/completion.h>
 
+// Signal used on the FIFO handle to ask the response reader thread to exit.
+#define RELEASE_SIGNAL ZX_USER_SIGNAL_0
+
 // Writes on a FIFO, repeating the write later if the FIFO is full.
 static zx_status_t do_write(zx_handle_t fifo, block_fifo_request_t* request, size_t count) {
     zx_status_t status;
@@ -46,11 +50,16 @@ static zx_status_t do_read(zx_handle_t fifo, block_fifo_response_t* response) {
         if (status == ZX_ERR_SHOULD_WAIT) {
             zx_signals_t signals;
             if ((status = zx_object_wait_one(fifo,
-                                             ZX_FIFO_READABLE | ZX_FIFO_PEER_CLOSED,
+                                             ZX_FIFO_READABLE | ZX_FIFO_PEER_CLOSED |
+                                             RELEASE_SIGNAL,
                                              ZX_TIME_INFINITE, &signals)) != ZX_OK) {
                 return status;
+            } else if (signals & ZX_FIFO_READABLE) {
+                // Drain pending responses before honoring a release request.
             } else if (signals & ZX_FIFO_PEER_CLOSED) {
                 return ZX_ERR_PEER_CLOSED;
+            } else {
+                return ZX_ERR_CANCELED;
             }
             // Try reading again...
         } else {
@@ -62,13 +71,58 @@ static zx_status_t do_read(zx_handle_t fifo, block_fifo_response_t* response) {
 typedef struct block_completion {
     sync_completion_t completion;
     zx_status_t status;
+    // Set while an asynchronous transaction is outstanding on this group;
+    // synchronous transactions leave it NULL.
+    block_fifo_callback_t callback;
+    void* cookie;
 } block_sync_completion_t;
 
+// Maximum number of VMOs kept attached by the vmoid cache. Eviction is LRU;
+// the limit keeps the client well under the server's vmoid space.
+#define VMOID_CACHE_SIZE 64
+
+typedef struct vmoid_cache_entry {
+    zx_koid_t koid;
+    vmoid_t vmoid;
+    uint64_t last_use;
+} vmoid_cache_entry_t;
+
 typedef struct fifo_client {
     zx_handle_t fifo;
+    thrd_t reader;
     block_sync_completion_t groups[MAX_TXN_GROUP_COUNT];
+
+    mtx_t vmoid_lock;
+    vmoid_cache_entry_t vmoids[VMOID_CACHE_SIZE];
+    size_t vmoid_count;
+    uint64_t vmoid_use_counter;
 } fifo_client_t;
 
+// Reads responses off the FIFO, routing each to its transaction group:
+// asynchronous groups have their callback invoked, synchronous groups have
+// their waiter signalled. Exits when the client is released or the server
+// closes its end.
+static int reader_thread(void* arg) {
+    fifo_client_t* client = arg;
+    block_fifo_response_t response;
+    while (do_read(client->fifo, &response) == ZX_OK) {
+        block_sync_completion_t* group = &client->groups[response.group];
+        block_fifo_callback_t callback = group->callback;
+        if (callback != NULL) {
+            void* cookie = group->cookie;
+            // Clear the group before the callback runs; the callback may
+            // immediately reuse it for another transaction.
+            group->callback = NULL;
+            group->cookie = NULL;
+            callback(cookie, response.status);
+        } else {
+            group->status = response.status;
+            sync_completion_signal(&group->completion);
+        }
+    }
+    return 0;
+}
+
 zx_status_t block_fifo_create_client(zx_handle_t fifo, fifo_client_t** out) {
     fifo_client_t* client = calloc(sizeof(fifo_client_t), 1);
     if (client == NULL) {
@@ -76,6 +130,16 @@ zx_status_t block_fifo_create_client(zx_handle_t fifo, fifo_client_t** out) {
         return ZX_ERR_NO_MEMORY;
     }
     client->fifo = fifo;
+    if (mtx_init(&client->vmoid_lock, mtx_plain) != thrd_success) {
+        zx_handle_close(fifo);
+        free(client);
+        return ZX_ERR_NO_RESOURCES;
+    }
+    if (thrd_create(&client->reader, reader_thread, client) != thrd_success) {
+        zx_handle_close(fifo);
+        free(client);
+        return ZX_ERR_NO_RESOURCES;
+    }
     *out = client;
     return ZX_OK;
 }
@@ -85,10 +149,48 @@ void block_fifo_release_client(fifo_client_t* client) {
         return;
     }
 
+    zx_object_signal(client->fifo, 0, RELEASE_SIGNAL);
+    thrd_join(client->reader, NULL);
     zx_handle_close(client->fifo);
     free(client);
 }
 
+// Merges adjacent read/write requests in place: runs with the same opcode
+// and vmoid whose vmo and device ranges are both contiguous collapse into a
+// single larger request. Returns the resulting request count.
+static size_t merge_requests(block_fifo_request_t* requests, size_t count) {
+    size_t out = 0;
+    for (size_t i = 1; i < count; i++) {
+        block_fifo_request_t* prev = &requests[out];
+        block_fifo_request_t* cur = &requests[i];
+        uint32_t opcode = prev->opcode & BLOCKIO_OP_MASK;
+        if ((opcode == BLOCKIO_READ || opcode == BLOCKIO_WRITE) &&
+            cur->opcode == prev->opcode && cur->vmoid == prev->vmoid &&
+            cur->vmo_offset == prev->vmo_offset + prev->length &&
+            cur->dev_offset == prev->dev_offset + prev->length &&
+            prev->length + cur->length >= prev->length) {
+            prev->length += cur->length;
+        } else {
+            requests[++out] = *cur;
+        }
+    }
+    return out + 1;
+}
+
+// Tags |count| requests as group items and writes them to the FIFO.
+static zx_status_t send_group(fifo_client_t* client, block_fifo_request_t* requests,
+                              size_t count, groupid_t group) {
+    for (size_t i = 0; i < count; i++) {
+        assert(requests[i].group == group);
+        requests[i].opcode = (requests[i].opcode & BLOCKIO_OP_MASK) | BLOCKIO_GROUP_ITEM;
+    }
+
+    requests[0].opcode |= BLOCKIO_BARRIER_BEFORE;
+    requests[count - 1].opcode |= BLOCKIO_GROUP_LAST | BLOCKIO_BARRIER_AFTER;
+
+    return do_write(client->fifo, &requests[0], count);
+}
+
 zx_status_t block_fifo_txn(fifo_client_t* client, block_fifo_request_t* requests, size_t count) {
     if (count == 0) {
         return ZX_OK;
@@ -96,36 +198,141 @@ zx_status_t block_fifo_txn(fifo_client_t* client, block_fifo_request_t* requests
 
     groupid_t group = requests[0].group;
     assert(group < MAX_TXN_GROUP_COUNT);
+    assert(client->groups[group].callback == NULL);
     sync_completion_reset(&client->groups[group].completion);
     client->groups[group].status = ZX_ERR_IO;
 
     zx_status_t status;
-    for (size_t i = 0; i < count; i++) {
-        assert(requests[i].group == group);
-        requests[i].opcode = (requests[i].opcode & BLOCKIO_OP_MASK) | BLOCKIO_GROUP_ITEM;
+    if ((status = send_group(client, requests, count, group)) != ZX_OK) {
+        return status;
     }
 
-    requests[0].opcode |= BLOCKIO_BARRIER_BEFORE;
-    requests[count - 1].opcode |= BLOCKIO_GROUP_LAST | BLOCKIO_BARRIER_AFTER;
+    // The reader thread signals us when the group's response arrives.
+    sync_completion_wait(&client->groups[group].completion, ZX_TIME_INFINITE);
 
-    if ((status = do_write(client->fifo, &requests[0], count)) != ZX_OK) {
-        return status;
+    return client->groups[group].status;
+}
+
+static zx_koid_t vmo_koid(zx_handle_t vmo) {
+    zx_info_handle_basic_t info;
+    if (zx_object_get_info(vmo, ZX_INFO_HANDLE_BASIC, &info, sizeof(info),
+                           NULL, NULL) != ZX_OK) {
+        return ZX_KOID_INVALID;
     }
+    return info.koid;
+}
 
-    // As expected by the protocol, when we send one "BLOCKIO_GROUP_LAST" message, we
-    // must read a reply message.
-    block_fifo_response_t response;
-    if ((status = do_read(client->fifo, &response)) != ZX_OK) {
+// Sends a CLOSE_VMO request for |vmoid| through |group| and waits for it.
+static zx_status_t close_vmoid(fifo_client_t* client, groupid_t group, vmoid_t vmoid) {
+    block_fifo_request_t request;
+    request.group = group;
+    request.vmoid = vmoid;
+    request.opcode = BLOCKIO_CLOSE_VMO;
+    return block_fifo_txn(client, &request, 1);
+}
+
+zx_status_t block_fifo_attach_vmo(fifo_client_t* client, int fd, groupid_t group,
+                                  zx_handle_t vmo, vmoid_t* out) {
+    zx_koid_t koid = vmo_koid(vmo);
+    if (koid == ZX_KOID_INVALID) {
+        return ZX_ERR_BAD_HANDLE;
+    }
+
+    mtx_lock(&client->vmoid_lock);
+    for (size_t i = 0; i < client->vmoid_count; i++) {
+        if (client->vmoids[i].koid == koid) {
+            client->vmoids[i].last_use = ++client->vmoid_use_counter;
+            *out = client->vmoids[i].vmoid;
+            mtx_unlock(&client->vmoid_lock);
+            return ZX_OK;
+        }
+    }
+    mtx_unlock(&client->vmoid_lock);
+
+    // Not cached; attach outside the lock, since the ioctl is a round trip
+    // to the server. Two threads racing to attach the same VMO may both get
+    // here; the cache then holds two entries for the koid, each with its own
+    // valid vmoid, which is merely a wasted slot until eviction.
+    zx_handle_t xfer_vmo;
+    zx_status_t status = zx_handle_duplicate(vmo, ZX_RIGHT_SAME_RIGHTS, &xfer_vmo);
+    if (status != ZX_OK) {
         return status;
     }
+    vmoid_t vmoid;
+    ssize_t r = ioctl_block_attach_vmo(fd, &xfer_vmo, &vmoid);
+    if (r < 0) {
+        zx_handle_close(xfer_vmo);
+        return (zx_status_t)r;
+    }
 
-    // Wake up someone who is waiting (it might be ourselves)
-    groupid_t response_group = response.group;
-    client->groups[response_group].status = response.status;
-    sync_completion_signal(&client->groups[response_group].completion);
+    vmoid_t evicted = VMOID_INVALID;
+    mtx_lock(&client->vmoid_lock);
+    if (client->vmoid_count == VMOID_CACHE_SIZE) {
+        // Evict the least recently used entry to make room.
+        size_t lru = 0;
+        for (size_t i = 1; i < client->vmoid_count; i++) {
+            if (client->vmoids[i].last_use < client->vmoids[lru].last_use) {
+                lru = i;
+            }
+        }
+        evicted = client->vmoids[lru].vmoid;
+        client->vmoids[lru] = client->vmoids[--client->vmoid_count];
+    }
+    vmoid_cache_entry_t* entry = &client->vmoids[client->vmoid_count++];
+    entry->koid = koid;
+    entry->vmoid = vmoid;
+    entry->last_use = ++client->vmoid_use_counter;
+    mtx_unlock(&client->vmoid_lock);
 
-    // Wait for someone to signal us.
-    sync_completion_wait(&client->groups[group].completion, ZX_TIME_INFINITE);
+    if (evicted != VMOID_INVALID) {
+        close_vmoid(client, group, evicted);
+    }
 
-    return client->groups[group].status;
+    *out = vmoid;
+    return ZX_OK;
+}
+
+zx_status_t block_fifo_detach_vmo(fifo_client_t* client, groupid_t group, zx_handle_t vmo) {
+    zx_koid_t koid = vmo_koid(vmo);
+    if (koid == ZX_KOID_INVALID) {
+        return ZX_ERR_BAD_HANDLE;
+    }
+
+    mtx_lock(&client->vmoid_lock);
+    for (size_t i = 0; i < client->vmoid_count; i++) {
+        if (client->vmoids[i].koid == koid) {
+            vmoid_t vmoid = client->vmoids[i].vmoid;
+            client->vmoids[i] = client->vmoids[--client->vmoid_count];
+            mtx_unlock(&client->vmoid_lock);
+            return close_vmoid(client, group, vmoid);
+        }
+    }
+    mtx_unlock(&client->vmoid_lock);
+    return ZX_ERR_NOT_FOUND;
+}
+
+zx_status_t block_fifo_txn_async(fifo_client_t* client, block_fifo_request_t* requests,
+                                 size_t count, block_fifo_callback_t callback, void* cookie) {
+    assert(callback != NULL);
+    if (count == 0) {
+        callback(cookie, ZX_OK);
+        return ZX_OK;
+    }
+
+    groupid_t group = requests[0].group;
+    assert(group < MAX_TXN_GROUP_COUNT);
+    assert(client->groups[group].callback == NULL);
+
+    count = merge_requests(requests, count);
+
+    client->groups[group].callback = callback;
+    client->groups[group].cookie = cookie;
+
+    zx_status_t status;
+    if ((status = send_group(client, requests, count, group)) != ZX_OK) {
+        client->groups[group].callback = NULL;
+        client->groups[group].cookie = NULL;
+        return status;
+    }
+    return ZX_OK;
 }
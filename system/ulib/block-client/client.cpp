@@ -43,6 +43,23 @@ zx_status_t Client::Transaction(block_fifo_request_t* requests, size_t count) co
     return block_fifo_txn(client_, requests, count);
 }
 
+zx_status_t Client::TransactionAsync(block_fifo_request_t* requests, size_t count,
+                                     block_fifo_callback_t callback, void* cookie) const {
+    ZX_DEBUG_ASSERT(client_ != nullptr);
+    return block_fifo_txn_async(client_, requests, count, callback, cookie);
+}
+
+zx_status_t Client::AttachVmo(int fd, groupid_t group, const zx::vmo& vmo,
+                              vmoid_t* out) const {
+    ZX_DEBUG_ASSERT(client_ != nullptr);
+    return block_fifo_attach_vmo(client_, fd, group, vmo.get(), out);
+}
+
+zx_status_t Client::DetachVmo(groupid_t group, const zx::vmo& vmo) const {
+    ZX_DEBUG_ASSERT(client_ != nullptr);
+    return block_fifo_detach_vmo(client_, group, vmo.get());
+}
+
 void Client::Reset(fifo_client_t* client) {
     if (client_ != nullptr) {
         block_fifo_release_client(client_);
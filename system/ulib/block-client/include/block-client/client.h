@@ -14,6 +14,11 @@ __BEGIN_CDECLS
 
 typedef struct fifo_client fifo_client_t;
 
+// Callback invoked when an asynchronous transaction group completes.
+// Runs on the client's internal response reader thread; it must not block,
+// and must not release the client.
+typedef void (*block_fifo_callback_t)(void* cookie, zx_status_t status);
+
 // Allocates a block fifo client. The client is thread-safe, as long
 // as each thread accessing the client uses a distinct reqid.
 // This function takes ownership of |fifo|.
@@ -40,4 +45,32 @@ void block_fifo_release_client(fifo_client_t* client);
 // dev_offset                               read, write
 zx_status_t block_fifo_txn(fifo_client_t* client, block_fifo_request_t* requests, size_t count);
 
+// Sends 'count' block device requests without waiting for them to complete.
+// When the final request in the group finishes, |callback| is invoked with
+// |cookie| and the group's status. The group may not be reused (by this
+// function or |block_fifo_txn|) until the callback has run.
+//
+// Adjacent read/write requests -- same opcode and vmoid, with contiguous vmo
+// and device ranges -- are merged into single larger requests before being
+// written to the FIFO; |requests| is modified in place to do so.
+//
+// The fields of each request are as for |block_fifo_txn|.
+zx_status_t block_fifo_txn_async(fifo_client_t* client, block_fifo_request_t* requests,
+                                 size_t count, block_fifo_callback_t callback, void* cookie);
+
+// Returns the server vmoid for |vmo| on the block device |fd| (the device
+// this client's fifo was obtained from). Attach results are cached by the
+// VMO's koid, so repeated calls for the same VMO cost no IPC. At most 64
+// VMOs are kept attached; beyond that the least recently used entry is
+// detached (through transaction group |group|, which must be free for the
+// caller's use) to make room. A returned vmoid is only guaranteed valid
+// until the next attach, so callers should request it before each
+// transaction rather than storing it; a cache hit is just a lookup.
+zx_status_t block_fifo_attach_vmo(fifo_client_t* client, int fd, groupid_t group,
+                                  zx_handle_t vmo, vmoid_t* out);
+
+// Removes |vmo| from the attach cache, if present, and detaches its vmoid
+// through transaction group |group|.
+zx_status_t block_fifo_detach_vmo(fifo_client_t* client, groupid_t group, zx_handle_t vmo);
+
 __END_CDECLS
@@ -14,6 +14,7 @@
 #include <fbl/macros.h>
 #include <fbl/type_support.h>
 #include <lib/zx/fifo.h>
+#include <lib/zx/vmo.h>
 #include <zircon/types.h>
 
 namespace block_client {
@@ -45,6 +46,21 @@ public:
     // and waits for a response.
     zx_status_t Transaction(block_fifo_request_t* requests, size_t count) const;
 
+    // Issues a group of block requests over the underlying fifo without
+    // waiting; |callback| is invoked with |cookie| when the group completes.
+    // Adjacent requests are merged before transmission (see
+    // |block_fifo_txn_async|).
+    zx_status_t TransactionAsync(block_fifo_request_t* requests, size_t count,
+                                 block_fifo_callback_t callback, void* cookie) const;
+
+    // Returns the vmoid for |vmo| on the block device |fd|, attaching each
+    // VMO at most once and evicting attachments LRU (see
+    // |block_fifo_attach_vmo|).
+    zx_status_t AttachVmo(int fd, groupid_t group, const zx::vmo& vmo, vmoid_t* out) const;
+
+    // Removes |vmo| from the attach cache and detaches its vmoid.
+    zx_status_t DetachVmo(groupid_t group, const zx::vmo& vmo) const;
+
 private:
     // Replace the current fifo_client with a new one.
     void Reset(fifo_client_t* client = nullptr);
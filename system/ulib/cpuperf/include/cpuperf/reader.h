@@ -0,0 +1,88 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/zircon-internal/device/cpu-trace/cpu-perf.h>
+#include <zircon/types.h>
+
+namespace cpuperf {
+
+// A view of one record in a trace buffer.
+// The pointers point into the buffer passed to |Reader|; they remain valid
+// for as long as the buffer does.
+struct SampleRecord {
+    const cpuperf_record_header_t* header;
+    union {
+        const cpuperf_time_record_t* time;
+        const cpuperf_tick_record_t* tick;
+        const cpuperf_count_record_t* count;
+        const cpuperf_value_record_t* value;
+        const cpuperf_pc_record_t* pc;
+    };
+
+    cpuperf_record_type_t type() const {
+        return static_cast<cpuperf_record_type_t>(header->type);
+    }
+
+    cpuperf_event_id_t event() const { return header->event; }
+};
+
+// Reads the records out of one cpu's trace buffer, as filled in by the
+// cpu-trace device (see lib/zircon-internal/device/cpu-trace/cpu-perf.h
+// for the buffer format).  The reader does not own the buffer; the caller
+// typically keeps the buffer's vmo mapped for the life of the reader.
+class Reader {
+public:
+    // |buffer| must be valid for the lifetime of the reader and contain
+    // |buffer_size| bytes.
+    Reader(const void* buffer, size_t buffer_size);
+
+    // Returns true if the buffer header was recognized.
+    // If false, |ReadNextRecord()| always fails.
+    bool is_valid() const { return is_valid_; }
+
+    const cpuperf_buffer_header_t& header() const { return *header_; }
+
+    zx_ticks_t ticks_per_second() const { return header_->ticks_per_second; }
+
+    // The time from the most recently read TIME record, or zero if none
+    // has been read yet.  Applies to all records read until the next TIME
+    // record.
+    zx_time_t time() const { return time_; }
+
+    // Reads the next record, advancing the read position.
+    // Returns true on success, with the record described in |*record|.
+    // Returns false when the end of the captured data is reached or a
+    // malformed record is encountered (the two can be distinguished with
+    // |error()|).
+    bool ReadNextRecord(SampleRecord* record);
+
+    // Returns true if reading stopped because of a malformed record
+    // rather than the end of the captured data.
+    bool error() const { return error_; }
+
+    // The number of records successfully read so far.
+    uint64_t num_records_read() const { return num_records_read_; }
+
+private:
+    // Returns the size in bytes of the record at |hdr|, or zero if the
+    // record type is unknown.
+    static size_t RecordSize(const cpuperf_record_header_t* hdr);
+
+    const uint8_t* const buffer_;
+    const cpuperf_buffer_header_t* const header_;
+    const uint8_t* next_record_;
+    const uint8_t* capture_end_;
+
+    bool is_valid_ = false;
+    bool error_ = false;
+    zx_time_t time_ = 0;
+    uint64_t num_records_read_ = 0;
+};
+
+} // namespace cpuperf
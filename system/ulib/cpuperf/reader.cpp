@@ -0,0 +1,73 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cpuperf/reader.h>
+
+#include <string.h>
+
+namespace cpuperf {
+
+Reader::Reader(const void* buffer, size_t buffer_size)
+    : buffer_(reinterpret_cast<const uint8_t*>(buffer)),
+      header_(reinterpret_cast<const cpuperf_buffer_header_t*>(buffer)),
+      next_record_(nullptr),
+      capture_end_(nullptr) {
+    if (buffer_size < sizeof(cpuperf_buffer_header_t))
+        return;
+    if (header_->version != CPUPERF_BUFFER_VERSION)
+        return;
+    if (header_->capture_end < sizeof(cpuperf_buffer_header_t) ||
+        header_->capture_end > buffer_size)
+        return;
+    next_record_ = buffer_ + sizeof(cpuperf_buffer_header_t);
+    capture_end_ = buffer_ + header_->capture_end;
+    is_valid_ = true;
+}
+
+size_t Reader::RecordSize(const cpuperf_record_header_t* hdr) {
+    switch (hdr->type) {
+    case CPUPERF_RECORD_TIME:
+        return sizeof(cpuperf_time_record_t);
+    case CPUPERF_RECORD_TICK:
+        return sizeof(cpuperf_tick_record_t);
+    case CPUPERF_RECORD_COUNT:
+        return sizeof(cpuperf_count_record_t);
+    case CPUPERF_RECORD_VALUE:
+        return sizeof(cpuperf_value_record_t);
+    case CPUPERF_RECORD_PC:
+        return sizeof(cpuperf_pc_record_t);
+    default:
+        return 0;
+    }
+}
+
+bool Reader::ReadNextRecord(SampleRecord* record) {
+    if (!is_valid_ || error_)
+        return false;
+    if (next_record_ + sizeof(cpuperf_record_header_t) > capture_end_)
+        return false;
+
+    auto hdr = reinterpret_cast<const cpuperf_record_header_t*>(next_record_);
+    size_t size = RecordSize(hdr);
+    if (size == 0 || next_record_ + size > capture_end_) {
+        // Unknown record type or truncated record: we can't skip past it,
+        // so treat the rest of the buffer as unreadable.
+        error_ = true;
+        return false;
+    }
+
+    record->header = hdr;
+    // All the union members alias the same pointer; assigning one covers
+    // them all.
+    record->time = reinterpret_cast<const cpuperf_time_record_t*>(hdr);
+
+    if (hdr->type == CPUPERF_RECORD_TIME)
+        time_ = record->time->time;
+
+    next_record_ += size;
+    ++num_records_read_;
+    return true;
+}
+
+} // namespace cpuperf
@@ -0,0 +1,25 @@
+# Copyright 2018 The Fuchsia Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+LOCAL_DIR := $(GET_LOCAL_DIR)
+
+# Userspace library.
+
+MODULE := $(LOCAL_DIR)
+
+MODULE_TYPE := userlib
+MODULE_COMPILEFLAGS += -fvisibility=hidden
+
+MODULE_SRCS = \
+    $(LOCAL_DIR)/reader.cpp
+
+MODULE_STATIC_LIBS := \
+    system/ulib/zircon-internal
+
+MODULE_LIBS := \
+    system/ulib/c
+
+MODULE_PACKAGE := src
+
+include make/module.mk
@@ -19,9 +19,15 @@ __BEGIN_CDECLS;
 // The ethermac interface supports both synchronous and asynchronous transmissions using the
 // proto->queue_tx() and ifc->complete_tx() methods.
 //
-// Receive operations are supported with the ifc->recv() interface.
-// TODO: implement netbuf-based receive operations by implementing proto->queue_rx() and
-// ifc->complete_rx()
+// Receive operations are supported with the ifc->recv() interface, which hands the
+// generic ethernet driver a frame in a driver-owned buffer to be copied out.
+//
+// Devices that advertise FEATURE_RX_QUEUE additionally support netbuf-based receive
+// operations via proto->queue_rx() and ifc->complete_rx(): the generic ethernet driver
+// queues client-owned receive buffers down to the device, which DMAs incoming frames
+// directly into them, eliminating the per-packet copy. Frames arriving while no receive
+// buffers are queued may be delivered via ifc->recv() or dropped, as with a full ring.
+// FEATURE_RX_QUEUE requires FEATURE_DMA.
 //
 // The FEATURE_WLAN flag indicates a device that supports wlan operations.
 //
@@ -33,6 +39,7 @@ __BEGIN_CDECLS;
 #define ETHMAC_FEATURE_WLAN     (1u)
 #define ETHMAC_FEATURE_SYNTH    (2u)
 #define ETHMAC_FEATURE_DMA      (4u)
+#define ETHMAC_FEATURE_RX_QUEUE (8u)
 
 typedef struct ethmac_info {
     uint32_t features;
@@ -72,6 +79,12 @@ typedef struct ethmac_ifc_virt {
     // Upon a return of ZX_OK, the packet has been enqueued, but no information is returned as to
     // the completion state of the transmission itself.
     void (*complete_tx)(void* cookie, ethmac_netbuf_t* netbuf, zx_status_t status);
+
+    // complete_rx() is called to return ownership of a receive netbuf to the generic
+    // ethernet driver. |length| is the number of bytes of the received frame, or 0 if
+    // the buffer is being returned unused (e.g. during stop()).
+    // Only used by devices that advertise ETHMAC_FEATURE_RX_QUEUE.
+    void (*complete_rx)(void* cookie, ethmac_netbuf_t* netbuf, size_t length);
 } ethmac_ifc_t;
 
 // Indicates that additional data is available to be sent after this call finishes. Allows a ethmac
@@ -144,6 +157,16 @@ typedef struct ethmac_protocol_ops {
     // The caller does *not* take ownership of the BTI handle and must never close
     // the handle.
     zx_handle_t (*get_bti)(void* ctx);
+
+    // Hand the device an empty receive buffer described by netbuf. Return status
+    // indicates disposition:
+    //   ZX_OK: The device owns the netbuf and will return it via complete_rx().
+    //   Other: The buffer was rejected and remains owned by the caller.
+    //
+    // Only valid on devices that advertise ETHMAC_FEATURE_RX_QUEUE; may be NULL
+    // otherwise. queue_rx() may be called at any time after start() is called
+    // including from multiple threads simultaneously.
+    zx_status_t (*queue_rx)(void* ctx, uint32_t options, ethmac_netbuf_t* netbuf);
 } ethmac_protocol_ops_t;
 
 typedef struct ethmac_protocol {
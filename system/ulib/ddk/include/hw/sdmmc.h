@@ -124,6 +124,8 @@ __BEGIN_CDECLS;
 #define MMC_OCR_BUSY            (1 << 31)
 
 // EXT_CSD fields (MMC)
+#define MMC_EXT_CSD_CMDQ_MODE_EN    15
+
 #define MMC_EXT_CSD_BUS_WIDTH   183
 #define MMC_EXT_CSD_BUS_WIDTH_8_DDR 6
 #define MMC_EXT_CSD_BUS_WIDTH_4_DDR 5
@@ -139,6 +141,10 @@ __BEGIN_CDECLS;
 
 #define MMC_EXT_CSD_DEVICE_TYPE 196
 
+#define MMC_EXT_CSD_CMDQ_DEPTH          307
+#define MMC_EXT_CSD_CMDQ_SUPPORT        308
+#define MMC_EXT_CSD_CMDQ_SUPPORT_CMDQ   (1 << 0)
+
 // Device register (CMD13 response) fields (SD/MMC)
 #define MMC_STATUS_ADDR_OUT_OF_RANGE    (1 << 31)
 #define MMC_STATUS_ADDR_MISALIGN        (1 << 30)
@@ -58,6 +58,14 @@ public:
     static zx_status_t Create(const void* data, size_t data_len, void* tree,
                               size_t tree_len, Digest* digest);
 
+    // As |Create|, but hashes the data-level nodes on a pool of worker
+    // threads before ascending the tree, since every node is hashed
+    // independently. Produces a tree and root digest identical to |Create|.
+    // Falls back to |Create| on the host, and for data small enough that
+    // fanning out is not worthwhile.
+    static zx_status_t CreateParallel(const void* data, size_t data_len, void* tree,
+                                      size_t tree_len, Digest* digest);
+
     // Checks the integrity of a the region of data given by the offset and
     // length.  It checks integrity using the given Merkle tree and trusted root
     // digest. |tree_len| must be at least as much as returned by
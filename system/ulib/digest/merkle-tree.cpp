@@ -7,6 +7,11 @@
 #include <stdint.h>
 #include <string.h>
 
+#ifdef __Fuchsia__
+#include <threads.h>
+#include <zircon/syscalls.h>
+#endif
+
 #include <digest/digest.h>
 #include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
@@ -116,6 +121,158 @@ zx_status_t MerkleTree::Create(const void* data, size_t data_len, void* tree, si
     return ZX_OK;
 }
 
+#ifdef __Fuchsia__
+
+namespace {
+
+// Upper bound on the number of worker threads used by |CreateParallel|.
+constexpr size_t kMaxHashWorkers = 8;
+
+// Data smaller than this is hashed serially; below this size the cost of
+// spawning workers outweighs the hashing itself.
+constexpr size_t kMinBytesPerWorker = 64 * MerkleTree::kNodeSize;
+
+// A contiguous, node-aligned slice of one level of the tree for a worker to
+// hash. Digests are written directly to |out|, which the caller has already
+// zeroed out to the node-aligned length of the level above.
+struct HashWork {
+    const uint8_t* data; // Start of this level's data
+    size_t data_len;     // Total length of this level
+    size_t offset;       // Node-aligned offset of this slice
+    size_t length;       // Length of this slice
+    uint64_t level;
+    uint8_t* out;        // Where to write this slice's digests
+    zx_status_t status;
+};
+
+int HashWorker(void* arg) {
+    HashWork* work = static_cast<HashWork*>(arg);
+    const uint8_t* in = work->data + work->offset;
+    size_t offset = work->offset;
+    size_t length = work->length;
+    uint8_t* out = work->out;
+    Digest digest;
+    zx_status_t rc = ZX_OK;
+    while (length > 0 && rc == ZX_OK) {
+        if ((rc = DigestInit(&digest, offset | work->level,
+                             work->data_len - offset)) != ZX_OK) {
+            break;
+        }
+        size_t chunk = DigestUpdate(&digest, in, offset, length);
+        in += chunk;
+        offset += chunk;
+        length -= chunk;
+        DigestFinal(&digest, offset);
+        digest.CopyTo(out, Digest::kLength);
+        out += Digest::kLength;
+    }
+    work->status = rc;
+    return 0;
+}
+
+// Hashes one level of the tree, splitting the nodes across worker threads.
+// If a worker thread cannot be spawned, its slice is hashed inline.
+zx_status_t HashLevelParallel(const uint8_t* data, size_t data_len, uint64_t level,
+                              uint8_t* out) {
+    size_t workers = fbl::min((data_len + kMinBytesPerWorker - 1) / kMinBytesPerWorker,
+                              fbl::min(static_cast<size_t>(zx_system_get_num_cpus()),
+                                       kMaxHashWorkers));
+    workers = fbl::max(workers, static_cast<size_t>(1));
+    size_t nodes = fbl::round_up(data_len, MerkleTree::kNodeSize) / MerkleTree::kNodeSize;
+    size_t nodes_per_worker = (nodes + workers - 1) / workers;
+
+    HashWork work[kMaxHashWorkers];
+    thrd_t threads[kMaxHashWorkers];
+    bool spawned[kMaxHashWorkers] = {};
+    size_t used = 0;
+    for (size_t node = 0; node < nodes; node += nodes_per_worker, ++used) {
+        HashWork* w = &work[used];
+        w->data = data;
+        w->data_len = data_len;
+        w->offset = node * MerkleTree::kNodeSize;
+        w->length = fbl::min(nodes_per_worker * MerkleTree::kNodeSize, data_len - w->offset);
+        w->level = level;
+        w->out = out + (node * Digest::kLength);
+        w->status = ZX_ERR_INTERNAL;
+    }
+    for (size_t i = 1; i < used; i++) {
+        spawned[i] = thrd_create_with_name(&threads[i], HashWorker, &work[i],
+                                           "merkle-hash") == thrd_success;
+        if (!spawned[i]) {
+            HashWorker(&work[i]);
+        }
+    }
+    HashWorker(&work[0]);
+    for (size_t i = 1; i < used; i++) {
+        if (spawned[i]) {
+            thrd_join(threads[i], nullptr);
+        }
+    }
+    for (size_t i = 0; i < used; i++) {
+        if (work[i].status != ZX_OK) {
+            return work[i].status;
+        }
+    }
+    return ZX_OK;
+}
+
+} // namespace
+
+zx_status_t MerkleTree::CreateParallel(const void* data, size_t data_len, void* tree,
+                                       size_t tree_len, Digest* digest) {
+    // Small data produces no tree, or too little hashing to be worth fanning
+    // out; the serial path also handles the degenerate argument cases.
+    if (data_len <= kMinBytesPerWorker) {
+        return Create(data, data_len, tree, tree_len, digest);
+    }
+    if (!data || !tree || !digest) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    if (tree_len < GetTreeLength(data_len)) {
+        return ZX_ERR_BUFFER_TOO_SMALL;
+    }
+
+    // Hash each level in turn; the data level dominates the work and fans out
+    // across workers, while the far smaller upper levels follow the same path
+    // with fewer (or one) workers.
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    uint8_t* out = static_cast<uint8_t*>(tree);
+    size_t level_len = data_len;
+    uint64_t level = 0;
+    zx_status_t rc;
+    while (level_len > kNodeSize) {
+        size_t next_aligned = NextAligned(level_len);
+        memset(out, 0, next_aligned);
+        if ((rc = HashLevelParallel(in, level_len, level, out)) != ZX_OK) {
+            return rc;
+        }
+        in = out;
+        out += next_aligned;
+        level_len = next_aligned;
+        ++level;
+    }
+
+    // The remaining node is the top of the tree; its digest is the root.
+    Digest root;
+    if ((rc = DigestInit(&root, level, level_len)) != ZX_OK) {
+        return rc;
+    }
+    DigestUpdate(&root, in, 0, level_len);
+    DigestFinal(&root, level_len);
+    *digest = root.AcquireBytes();
+    root.ReleaseBytes();
+    return ZX_OK;
+}
+
+#else  // !__Fuchsia__
+
+zx_status_t MerkleTree::CreateParallel(const void* data, size_t data_len, void* tree,
+                                       size_t tree_len, Digest* digest) {
+    return Create(data, data_len, tree, tree_len, digest);
+}
+
+#endif  // __Fuchsia__
+
 MerkleTree::MerkleTree() : initialized_(false), next_(nullptr), level_(0), offset_(0), length_(0) {}
 
 MerkleTree::~MerkleTree() {}
@@ -20,6 +20,12 @@ bool ThreadPool::system_shutdown_ = false;
 
 static constexpr uint32_t MAX_THREAD_PRIORITY = 31;
 
+// Scaling hysteresis.  A thread which picks up this many packets in a row
+// while no other thread in the pool is idle grows the pool by one thread; a
+// thread whose port wait stays empty for this long retires itself.
+static constexpr uint32_t GROW_PRESSURE_THRESHOLD = 8;
+static constexpr zx::duration THREAD_IDLE_TIMEOUT = zx::sec(5);
+
 // static
 zx_status_t ThreadPool::Get(fbl::RefPtr<ThreadPool>* pool_out, uint32_t priority) {
     if ((pool_out == nullptr) || (priority > MAX_THREAD_PRIORITY))
@@ -96,32 +102,25 @@ void ThreadPool::Shutdown() {
 
 zx_status_t ThreadPool::AddDomainToPool(fbl::RefPtr<ExecutionDomain> domain) {
     ZX_DEBUG_ASSERT(domain != nullptr);
-    fbl::AutoLock pool_lock(&pool_lock_);
-
-    if (pool_shutting_down_)
-        return ZX_ERR_BAD_STATE;
+    {
+        fbl::AutoLock pool_lock(&pool_lock_);
 
-    active_domains_.push_back(fbl::move(domain));
-    ++active_domain_count_;
+        if (pool_shutting_down_)
+            return ZX_ERR_BAD_STATE;
 
-    while ((active_thread_count_ < active_domain_count_) &&
-           (active_thread_count_ < zx_system_get_num_cpus())) {
-        auto thread = Thread::Create(fbl::WrapRefPtr(this), active_thread_count_);
-        if (thread == nullptr) {
-            LOG("Failed to create new thread\n");
-            break;
-        }
+        active_domains_.push_back(fbl::move(domain));
+        ++active_domain_count_;
 
-        active_threads_.push_front(fbl::move(thread));
-        if (active_threads_.front().Start() != ZX_OK) {
-            LOG("Failed to start new thread\n");
-            thread = active_threads_.pop_front();
-            break;
+        while ((active_thread_count_ < active_domain_count_) &&
+               (active_thread_count_ < zx_system_get_num_cpus())) {
+            if (!AddThreadLocked())
+                break;
         }
-
-        active_thread_count_++;
     }
 
+    // Now that the lock has been dropped, use the opportunity to join any
+    // threads which have retired since the last time someone looked.
+    ReapRetiredThreads();
     return ZX_OK;
 }
 
@@ -174,6 +173,90 @@ zx_status_t ThreadPool::Init() {
     return ZX_OK;
 }
 
+void ThreadPool::NoteDispatchPressure() {
+    // If some other thread is still idle, the pool is keeping up; reset the
+    // pressure counter.  Otherwise, count this dispatch against the growth
+    // threshold.  Nothing here takes a lock or allocates; the (rare) growth
+    // event is the only place which does either.
+    if (idle_thread_count_.load(fbl::memory_order_relaxed) > 0) {
+        dispatch_pressure_.store(0u, fbl::memory_order_relaxed);
+        return;
+    }
+
+    uint32_t pressure = dispatch_pressure_.fetch_add(1u, fbl::memory_order_relaxed) + 1;
+    if (pressure >= GROW_PRESSURE_THRESHOLD)
+        TryGrowPool();
+}
+
+void ThreadPool::TryGrowPool() {
+    fbl::AutoLock pool_lock(&pool_lock_);
+
+    dispatch_pressure_.store(0u, fbl::memory_order_relaxed);
+
+    if (pool_shutting_down_)
+        return;
+
+    // Stay within the same bounds used when domains join the pool.
+    if ((active_thread_count_ >= active_domain_count_) ||
+        (active_thread_count_ >= zx_system_get_num_cpus()))
+        return;
+
+    DEBUG_LOG("Sustained dispatch pressure; growing pool to %u threads\n",
+              active_thread_count_ + 1);
+    AddThreadLocked();
+}
+
+bool ThreadPool::TryRetireThread(Thread* thread) {
+    ZX_DEBUG_ASSERT(thread != nullptr);
+    fbl::AutoLock pool_lock(&pool_lock_);
+
+    // Never retire while the pool is shutting down (the shutdown sequence is
+    // counting on joining us), and keep at least one thread running for as
+    // long as any domain is bound to the pool.
+    if (pool_shutting_down_)
+        return false;
+
+    uint32_t min_threads = active_domains_.is_empty() ? 0u : 1u;
+    if (active_thread_count_ <= min_threads)
+        return false;
+
+    auto self = active_threads_.erase_if(
+        [thread](const Thread& t) { return &t == thread; });
+    ZX_DEBUG_ASSERT(self != nullptr);
+    retired_threads_.push_back(fbl::move(self));
+    active_thread_count_--;
+    return true;
+}
+
+void ThreadPool::ReapRetiredThreads() {
+    decltype(retired_threads_) retired;
+    {
+        fbl::AutoLock pool_lock(&pool_lock_);
+        retired = fbl::move(retired_threads_);
+    }
+
+    while (!retired.is_empty())
+        retired.pop_front()->Join();
+}
+
+bool ThreadPool::AddThreadLocked() {
+    auto thread = Thread::Create(fbl::WrapRefPtr(this), active_thread_count_);
+    if (thread == nullptr) {
+        LOG("Failed to create new thread\n");
+        return false;
+    }
+
+    active_threads_.push_front(fbl::move(thread));
+    if (active_threads_.front().Start() != ZX_OK) {
+        LOG("Failed to start new thread\n");
+        active_threads_.pop_front();
+        return false;
+    }
+
+    active_thread_count_++;
+    return true;
+}
+
 void ThreadPool::InternalShutdown() {
     // Be careful when shutting down, a specific sequence needs to be followed.
     // See MG-1118 for details.
@@ -229,6 +312,10 @@ void ThreadPool::InternalShutdown() {
 
         thread->Join();
     }
+
+    // Finally, join any threads which retired on their own before shutdown
+    // began.
+    ReapRetiredThreads();
 }
 
 // static
@@ -289,12 +376,22 @@ int ThreadPool::Thread::Main() {
     while (true) {
         zx_port_packet_t pkt;
 
-        // TODO(johngro) : consider automatically shutting down if we have more
-        // threads than clients.
-
         // Wait for there to be work to dispatch.  We should never encounter an
-        // error, but if we do, shut down.
-        res = pool_->port().wait(zx::time::infinite(), &pkt);
+        // error, but if we do, shut down.  While we wait, we count towards the
+        // pool's idle thread population; if the wait times out, offer to
+        // retire.  The pool will refuse if we are the last thread standing (or
+        // if shutdown is in progress), in which case we simply wait again.
+        pool_->idle_thread_count_.fetch_add(1u, fbl::memory_order_relaxed);
+        res = pool_->port().wait(zx::deadline_after(THREAD_IDLE_TIMEOUT), &pkt);
+        pool_->idle_thread_count_.fetch_sub(1u, fbl::memory_order_relaxed);
+
+        if (res == ZX_ERR_TIMED_OUT) {
+            if (pool_->TryRetireThread(this)) {
+                DEBUG_LOG("Idle thread retiring\n");
+                break;
+            }
+            continue;
+        }
         ZX_DEBUG_ASSERT(res == ZX_OK);
 
         // Is it time to exit?
@@ -307,6 +404,11 @@ int ThreadPool::Thread::Main() {
             continue;
         }
 
+        // We have real work and we are no longer idle; if no other thread is
+        // idle either, note the pressure so that sustained load grows the
+        // pool.
+        pool_->NoteDispatchPressure();
+
         // Reclaim our event source reference from the kernel.
         static_assert(sizeof(pkt.key) >= sizeof(EventSource*),
                       "Port packet keys are not large enough to hold a pointer!");
@@ -7,6 +7,7 @@
 #include <zircon/compiler.h>
 #include <zircon/types.h>
 #include <lib/zx/port.h>
+#include <fbl/atomic.h>
 #include <fbl/auto_lock.h>
 #include <fbl/intrusive_double_list.h>
 #include <fbl/intrusive_single_list.h>
@@ -74,6 +75,17 @@ private:
     zx_status_t Init();
     void InternalShutdown();
 
+    // Load-adaptive scaling.  Dispatch threads keep the idle thread count up
+    // to date around their port waits using nothing but atomic counters (no
+    // locks or allocation on the hot path).  When a thread repeatedly picks
+    // up work while no other thread is idle, it grows the pool; when a
+    // thread's port wait times out, it retires itself.
+    void NoteDispatchPressure();
+    void TryGrowPool();
+    bool TryRetireThread(Thread* thread);
+    void ReapRetiredThreads();
+    bool AddThreadLocked() __TA_REQUIRES(pool_lock_);
+
     static fbl::Mutex active_pools_lock_;
     static fbl::WAVLTree<uint32_t, fbl::RefPtr<ThreadPool>> active_pools_
         __TA_GUARDED(active_pools_lock_);
@@ -93,6 +105,17 @@ private:
 
     fbl::DoublyLinkedList<fbl::unique_ptr<Thread>> active_threads_
         __TA_GUARDED(pool_lock_);
+
+    // Threads which have retired after an idle timeout and are waiting to be
+    // joined.  Reaped opportunistically and during shutdown.
+    fbl::DoublyLinkedList<fbl::unique_ptr<Thread>> retired_threads_
+        __TA_GUARDED(pool_lock_);
+
+    // Number of threads currently blocked waiting on the port, and the number
+    // of consecutive dispatches which found no other thread idle.  Maintained
+    // with atomics so the dispatch hot path never takes pool_lock_.
+    fbl::atomic<uint32_t> idle_thread_count_{0};
+    fbl::atomic<uint32_t> dispatch_pressure_{0};
 };
 
 }  // namespace dispatcher
@@ -130,9 +130,18 @@ static zx_status_t choose_load_bias(zx_handle_t root_vmar,
     return status;
 }
 
+// Commit the pages backing a range of the VMO up front, so the new
+// process never takes first-touch faults on them.  This trades a little
+// RSS for deterministic startup; failure (e.g. a VMO type that does not
+// support the op) just leaves the pages to be faulted lazily as before,
+// so this is best-effort.
+static void prefault_range(zx_handle_t vmo, uint64_t offset, uint64_t size) {
+    zx_vmo_op_range(vmo, ZX_VMO_OP_COMMIT, offset, size, NULL, 0);
+}
+
 static zx_status_t finish_load_segment(
     zx_handle_t vmar, zx_handle_t vmo, const char vmo_name[ZX_MAX_NAME_LEN],
-    const elf_phdr_t* ph, size_t start_offset, size_t size,
+    const elf_phdr_t* ph, uint32_t flags, size_t start_offset, size_t size,
     uintptr_t file_start, uintptr_t file_end, size_t partial_page) {
     const zx_vm_option_t options = ZX_VM_SPECIFIC |
         ((ph->p_flags & PF_R) ? ZX_VM_PERM_READ : 0) |
@@ -140,16 +149,21 @@ static zx_status_t finish_load_segment(
         ((ph->p_flags & PF_X) ? ZX_VM_PERM_EXECUTE : 0);
 
     uintptr_t start;
-    if (ph->p_filesz == ph->p_memsz)
+    if (ph->p_filesz == ph->p_memsz) {
         // Straightforward segment, map all the whole pages from the file.
+        if (flags & ELF_LOAD_PREFAULT)
+            prefault_range(vmo, file_start, size);
         return zx_vmar_map(vmar, options, start_offset, vmo, file_start, size,
                            &start);
+    }
 
     const size_t file_size = file_end - file_start;
 
     // This segment has some bss, so things are more complicated.
     // Only the leading portion is directly mapped in from the file.
     if (file_size > 0) {
+        if (flags & ELF_LOAD_PREFAULT)
+            prefault_range(vmo, file_start, file_size);
         zx_status_t status = zx_vmar_map(vmar, options, start_offset, vmo,
                                          file_start, file_size, &start);
         if (status != ZX_OK)
@@ -192,6 +206,9 @@ static zx_status_t finish_load_segment(
         }
     }
 
+    if (flags & ELF_LOAD_PREFAULT)
+        prefault_range(bss_vmo, 0, size);
+
     status = zx_vmar_map(vmar, options, start_offset, bss_vmo, 0, size, &start);
     zx_handle_close(bss_vmo);
 
@@ -200,7 +217,7 @@ static zx_status_t finish_load_segment(
 
 static zx_status_t load_segment(zx_handle_t vmar, size_t vmar_offset,
                                 zx_handle_t vmo, const char* vmo_name,
-                                const elf_phdr_t* ph) {
+                                const elf_phdr_t* ph, uint32_t flags) {
     // The p_vaddr can start in the middle of a page, but the
     // semantics are that all the whole pages containing the
     // p_vaddr+p_filesz range are mapped in.
@@ -226,7 +243,7 @@ static zx_status_t load_segment(zx_handle_t vmar, size_t vmar_offset,
 
     // With no writable data, it's the simple case.
     if (!(ph->p_flags & PF_W) || data_size == 0)
-        return finish_load_segment(vmar, vmo, vmo_name, ph, start, size,
+        return finish_load_segment(vmar, vmo, vmo_name, ph, flags, start, size,
                                    file_start, file_end, partial_page);
 
     // For a writable segment, we need a writable VMO.
@@ -240,20 +257,45 @@ static zx_status_t load_segment(zx_handle_t vmar, size_t vmar_offset,
         status = zx_object_set_property(writable_vmo, ZX_PROP_NAME,
                                         name, strlen(name));
         if (status == ZX_OK)
+            // Note that with ELF_LOAD_PREFAULT this commits the
+            // copy-on-write clone, eagerly copying the data pages so the
+            // process never shares (or faults on) them.
             status = finish_load_segment(
-                vmar, writable_vmo, vmo_name, ph, start, size,
+                vmar, writable_vmo, vmo_name, ph, flags, start, size,
                 0, file_end - file_start, partial_page);
         zx_handle_close(writable_vmo);
     }
     return status;
 }
 
-zx_status_t elf_load_map_segments(zx_handle_t root_vmar,
-                                  const elf_load_header_t* header,
-                                  const elf_phdr_t phdrs[],
-                                  zx_handle_t vmo,
-                                  zx_handle_t* segments_vmar,
-                                  zx_vaddr_t* base, zx_vaddr_t* entry) {
+// Whether |b| can be folded into the mapping for |a| (which may already
+// cover several earlier segments).  Merging is only sound when the two
+// would be mapped with the same permissions from contiguous file pages
+// at contiguous addresses.
+static bool segments_mergeable(const elf_phdr_t* a, const elf_phdr_t* b) {
+    if (a->p_flags != b->p_flags)
+        return false;
+    // Only the final segment of a merged run may carry bss.
+    if (a->p_memsz != a->p_filesz)
+        return false;
+    // Both must have the same offset-to-vaddr bias so one mapping of the
+    // file covers both.
+    if (b->p_vaddr - a->p_vaddr != b->p_offset - a->p_offset)
+        return false;
+    // No page gap between the rounded spans; mapping across a gap would
+    // put file contents at addresses the image says are unmapped.
+    uintptr_t a_end = (a->p_vaddr + a->p_memsz + PAGE_SIZE - 1) & -PAGE_SIZE;
+    uintptr_t b_start = b->p_vaddr & -PAGE_SIZE;
+    return b_start <= a_end;
+}
+
+zx_status_t elf_load_map_segments_flags(zx_handle_t root_vmar,
+                                        const elf_load_header_t* header,
+                                        const elf_phdr_t phdrs[],
+                                        zx_handle_t vmo,
+                                        uint32_t flags,
+                                        zx_handle_t* segments_vmar,
+                                        zx_vaddr_t* base, zx_vaddr_t* entry) {
     char vmo_name[ZX_MAX_NAME_LEN];
     if (zx_object_get_property(vmo, ZX_PROP_NAME,
                                vmo_name, sizeof(vmo_name)) != ZX_OK ||
@@ -268,8 +310,23 @@ zx_status_t elf_load_map_segments(zx_handle_t root_vmar,
 
     size_t vmar_offset = bias - vmar_base;
     for (uint_fast16_t i = 0; status == ZX_OK && i < header->e_phnum; ++i) {
-        if (phdrs[i].p_type == PT_LOAD)
-            status = load_segment(vmar, vmar_offset, vmo, vmo_name, &phdrs[i]);
+        if (phdrs[i].p_type != PT_LOAD)
+            continue;
+        elf_phdr_t ph = phdrs[i];
+        if (flags & ELF_LOAD_MERGE_SEGMENTS) {
+            // Fold immediately-following compatible PT_LOADs into this
+            // mapping, using a synthetic phdr covering the whole run.
+            for (uint_fast16_t j = i + 1; j < header->e_phnum; ++j) {
+                if (phdrs[j].p_type != PT_LOAD)
+                    continue;
+                if (!segments_mergeable(&ph, &phdrs[j]))
+                    break;
+                ph.p_filesz = phdrs[j].p_offset + phdrs[j].p_filesz - ph.p_offset;
+                ph.p_memsz = phdrs[j].p_vaddr + phdrs[j].p_memsz - ph.p_vaddr;
+                i = j;
+            }
+        }
+        status = load_segment(vmar, vmar_offset, vmo, vmo_name, &ph, flags);
     }
 
     if (status == ZX_OK && segments_vmar != NULL)
@@ -286,6 +343,16 @@ zx_status_t elf_load_map_segments(zx_handle_t root_vmar,
     return status;
 }
 
+zx_status_t elf_load_map_segments(zx_handle_t root_vmar,
+                                  const elf_load_header_t* header,
+                                  const elf_phdr_t phdrs[],
+                                  zx_handle_t vmo,
+                                  zx_handle_t* segments_vmar,
+                                  zx_vaddr_t* base, zx_vaddr_t* entry) {
+    return elf_load_map_segments_flags(root_vmar, header, phdrs, vmo, 0,
+                                       segments_vmar, base, entry);
+}
+
 bool elf_load_find_interp(const elf_phdr_t phdrs[], size_t phnum,
                           uintptr_t* interp_off, size_t* interp_len) {
     for (size_t i = 0; i < phnum; ++i) {
@@ -56,6 +56,28 @@ zx_status_t elf_load_map_segments(zx_handle_t vmar,
                                   zx_handle_t* segments_vmar,
                                   zx_vaddr_t* bias, zx_vaddr_t* entry);
 
+// Map adjacent PT_LOAD segments with identical permissions, the same
+// offset-to-vaddr bias, and no page gap between them as one mapping
+// instead of one per phdr.
+#define ELF_LOAD_MERGE_SEGMENTS (1u << 0)
+
+// Commit the pages backing each segment before mapping it, so the new
+// process starts without first-touch fault storms.  Writable segments
+// get their copy-on-write pages copied eagerly, trading RSS for
+// deterministic startup.  Commit failures are ignored; the affected
+// pages just fault lazily as before.
+#define ELF_LOAD_PREFAULT       (1u << 1)
+
+// As elf_load_map_segments, with behavior tweaked by the ELF_LOAD_*
+// flags above (0 is identical to elf_load_map_segments).
+zx_status_t elf_load_map_segments_flags(zx_handle_t vmar,
+                                        const elf_load_header_t* header,
+                                        const elf_phdr_t* phdrs,
+                                        zx_handle_t vmo,
+                                        uint32_t flags,
+                                        zx_handle_t* segments_vmar,
+                                        zx_vaddr_t* bias, zx_vaddr_t* entry);
+
 // Locate the PT_INTERP program header and extract its bounds in the file.
 // Returns false if there was no PT_INTERP.
 bool elf_load_find_interp(const elf_phdr_t* phdrs, size_t phnum,
@@ -0,0 +1,99 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <fbl/alloc_checker.h>
+#include <fbl/macros.h>
+#include <fbl/new.h>
+#include <fbl/type_support.h>
+
+namespace fbl {
+
+// BumpArena is a scoped bump allocator for construction phases which
+// create many small objects with a single common lifetime, such as
+// building a parse tree. One checked allocation reserves the backing
+// slab up front; each carve-out after that is a pointer bump with no
+// per-object heap traffic, and the whole slab is returned to the heap
+// when the arena goes out of scope.
+//
+// Objects carved out of the arena are never individually destroyed, so
+// New<T>() only admits trivially destructible types. Arena objects may
+// carry intrusive container node state (list or tree nodes pointing at
+// other arena objects); any container holding arena objects must be
+// cleared before the arena is destroyed.
+//
+// Usage follows the AllocChecker pattern:
+//
+//   fbl::AllocChecker ac;
+//   fbl::BumpArena arena(&ac, budget_bytes);
+//   if (!ac.check())
+//       return ZX_ERR_NO_MEMORY;
+//
+//   auto node = arena.New<Node>(&ac, args...);
+//   if (!ac.check())
+//       return ZX_ERR_NO_MEMORY;  // slab exhausted
+class BumpArena {
+public:
+    // Reserves a slab of |size| bytes. |ac| reports whether the
+    // reservation succeeded, exactly like checked operator new.
+    BumpArena(AllocChecker* ac, size_t size)
+        : slab_(static_cast<uint8_t*>(::malloc(size))),
+          next_(slab_),
+          end_((slab_ != nullptr) ? slab_ + size : nullptr) {
+        ac->arm(size, slab_ != nullptr);
+    }
+
+    ~BumpArena() {
+        ::free(slab_);
+    }
+
+    // Carves |size| bytes out of the slab, aligned for any ordinary
+    // object. Returns nullptr when the slab is exhausted; the arena
+    // never falls back to the heap.
+    void* Allocate(size_t size) {
+        size = (size + kAlignment - 1) & ~(kAlignment - 1);
+        if (size > static_cast<size_t>(end_ - next_))
+            return nullptr;
+        void* mem = next_;
+        next_ += size;
+        return mem;
+    }
+
+    // Constructs a T in the arena. |ac| must be checked, as with any
+    // checked allocation; on exhaustion nothing is constructed and
+    // nullptr is returned.
+    template <typename T, typename... Args>
+    T* New(AllocChecker* ac, Args&&... args) {
+        static_assert(has_trivial_destructor<T>::value,
+                      "BumpArena objects are freed wholesale; destructors never run");
+        void* mem = Allocate(sizeof(T));
+        ac->arm(sizeof(T), mem != nullptr);
+        if (mem == nullptr)
+            return nullptr;
+        return new (mem) T(forward<Args>(args)...);
+    }
+
+    size_t used() const { return static_cast<size_t>(next_ - slab_); }
+    size_t available() const { return static_cast<size_t>(end_ - next_); }
+
+private:
+    DISALLOW_COPY_ASSIGN_AND_MOVE(BumpArena);
+
+    // Sufficient for every fundamental type; matches what malloc would
+    // guarantee for allocations of these sizes.
+    static constexpr size_t kAlignment = alignof(long double) > alignof(void*)
+                                             ? alignof(long double)
+                                             : alignof(void*);
+
+    uint8_t* const slab_;
+    uint8_t* next_;
+    uint8_t* const end_;
+};
+
+}  // namespace fbl
@@ -14,9 +14,28 @@
 #include <fbl/type_support.h>
 #include <fbl/unique_ptr.h>
 
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+#include <fbl/atomic.h>
+#endif
+
 namespace fbl {
 namespace internal {
 
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+// Storage for the spill counter lives in this inline function so the
+// header stays self-contained; the static local is shared program-wide.
+inline fbl::atomic_uint64_t& function_heap_spill_counter() {
+    static fbl::atomic_uint64_t counter{0u};
+    return counter;
+}
+#endif
+
+inline void function_count_heap_spill() {
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+    function_heap_spill_counter().fetch_add(1u, fbl::memory_order_relaxed);
+#endif
+}
+
 // Checks if |T| is null. Defaults to false. |Comparison| is the type yielded by
 // comparing a T value with nullptr.
 template <typename T, typename Comparison = bool>
@@ -100,9 +119,13 @@ template <typename Callable, typename Result, typename... Args>
 class HeapFunctionTarget final : public FunctionTarget<Result, Args...> {
 public:
     explicit HeapFunctionTarget(Callable target)
-        : target_ptr_(fbl::make_unique<Callable>(fbl::move(target))) {}
+        : target_ptr_(fbl::make_unique<Callable>(fbl::move(target))) {
+        function_count_heap_spill();
+    }
     HeapFunctionTarget(Callable target, AllocChecker* ac)
-        : target_ptr_(fbl::make_unique_checked<Callable>(ac, fbl::move(target))) {}
+        : target_ptr_(fbl::make_unique_checked<Callable>(ac, fbl::move(target))) {
+        function_count_heap_spill();
+    }
     HeapFunctionTarget(HeapFunctionTarget&& other)
         : target_ptr_(fbl::move(other.target_ptr_)) {}
     ~HeapFunctionTarget() final = default;
@@ -419,6 +442,27 @@ using SizedFunction = fbl::internal::Function<inline_callable_size, false, T>;
 template <typename T, size_t inline_callable_size>
 using InlineFunction = fbl::internal::Function<inline_callable_size, true, T>;
 
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+// When the module is built with FBL_FUNCTION_TRACE_HEAP_SPILLS=1, every
+// fbl::Function construction or assignment whose callable is too large
+// to store inline (and therefore spills to the heap) bumps a
+// program-wide counter.  Hot paths can assert the counter stays flat
+// across a dispatch loop, then make the guarantee permanent by
+// switching to fbl::InlineFunction, which rejects spilling callables at
+// compile time.
+//
+// The flag must be set uniformly across the program (e.g. via build
+// system defines); defining it for only some translation units violates
+// the one-definition rule for the function internals.
+inline uint64_t function_heap_spill_count() {
+    return internal::function_heap_spill_counter().load(fbl::memory_order_relaxed);
+}
+
+inline void function_reset_heap_spill_count() {
+    internal::function_heap_spill_counter().store(0u, fbl::memory_order_relaxed);
+}
+#endif
+
 // Comparing functions with nullptr.
 template <size_t inline_callable_size, bool require_inline, typename Result, typename... Args>
 bool operator==(const fbl::internal::Function<inline_callable_size, require_inline, Result, Args...>& f,
@@ -0,0 +1,384 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <zircon/assert.h>
+#include <fbl/alloc_checker.h>
+#include <fbl/intrusive_container_utils.h>
+#include <fbl/intrusive_pointer_traits.h>
+#include <fbl/intrusive_single_list.h>
+#include <fbl/macros.h>
+#include <fbl/unique_ptr.h>
+
+namespace fbl {
+
+// DefaultResizableHashTraits defines a default implementation of traits used
+// to define the hash function for a resizable hash table.
+//
+// Unlike DefaultHashTraits, the value returned by GetHash is not required to
+// be bounded by a compile time bucket count.  Users only need to implement a
+// static method of ObjType named GetHash which takes a const reference to a
+// KeyType and returns a HashType; the table reduces the hash to its current
+// bucket count internally (after a round of avalanche mixing, so cheap hash
+// functions with hidden periods still spread across power-of-two bucket
+// counts).
+template <typename KeyType,
+          typename ObjType,
+          typename HashType>
+struct DefaultResizableHashTraits {
+    static_assert(is_unsigned_integer<HashType>::value, "HashTypes must be unsigned integers");
+    static HashType GetHash(const KeyType& key) {
+        return static_cast<HashType>(ObjType::GetHash(key));
+    }
+};
+
+// ResizableHashTable is a variant of HashTable whose bucket array grows as
+// elements are added, so that lookups stay O(1) instead of degrading to long
+// chains when the population outgrows a compile time bucket count.
+//
+// The nodes themselves remain fully intrusive; the only allocations are the
+// bucket arrays.  Growth uses incremental rehashing: when the load factor
+// reaches 1.0 a new bucket array of twice the size is allocated and elements
+// are migrated a few buckets at a time, piggy-backed on subsequent
+// operations, so no single insert pays for rehashing the whole table.  If a
+// bucket array allocation fails the table simply keeps the current array and
+// retries on a later insert; no operation can fail, chains just stay longer.
+//
+// Differences from HashTable:
+// + HashTraits::GetHash returns an unreduced hash; the table owns the
+//   reduction to a bucket index.
+// + Iterators are not provided (elements may be spread across two bucket
+//   arrays mid-rehash); use find/find_if/erase_if instead.
+template <typename  _KeyType,
+          typename  _PtrType,
+          typename  _BucketType = SinglyLinkedList<_PtrType>,
+          typename  _HashType   = size_t,
+          typename  _KeyTraits  = DefaultKeyedObjectTraits<
+                                    _KeyType,
+                                    typename internal::ContainerPtrTraits<_PtrType>::ValueType>,
+          typename  _HashTraits = DefaultResizableHashTraits<
+                                    _KeyType,
+                                    typename internal::ContainerPtrTraits<_PtrType>::ValueType,
+                                    _HashType>>
+class ResizableHashTable {
+public:
+    // Pointer types/traits
+    using PtrType      = _PtrType;
+    using PtrTraits    = internal::ContainerPtrTraits<PtrType>;
+    using ValueType    = typename PtrTraits::ValueType;
+
+    // Key types/traits
+    using KeyType      = _KeyType;
+    using KeyTraits    = _KeyTraits;
+
+    // Hash types/traits
+    using HashType     = _HashType;
+    using HashTraits   = _HashTraits;
+
+    // Bucket types/traits
+    using BucketType   = _BucketType;
+    using NodeTraits   = typename BucketType::NodeTraits;
+
+    // The initial bucket array size, and the number of old buckets migrated
+    // to the new array per table operation while a rehash is in progress.
+    // Bucket counts are always powers of two so the hash reduction is a mask.
+    static constexpr HashType kInitialBucketCount = 16;
+    static constexpr HashType kRehashBucketsPerOp = 2;
+
+    static constexpr bool SupportsConstantOrderErase = BucketType::SupportsConstantOrderErase;
+    static constexpr bool SupportsConstantOrderSize = true;
+    static constexpr bool IsAssociative = true;
+    static constexpr bool IsSequenced = false;
+
+    static_assert(is_unsigned_integer<HashType>::value, "HashTypes must be unsigned integers");
+
+    constexpr ResizableHashTable() {}
+    ~ResizableHashTable() { ZX_DEBUG_ASSERT(PtrTraits::IsManaged || is_empty()); }
+
+    DISALLOW_COPY_ASSIGN_AND_MOVE(ResizableHashTable);
+
+    void insert(const PtrType& ptr) { insert(PtrType(ptr)); }
+    void insert(PtrType&& ptr) {
+        ZX_DEBUG_ASSERT(ptr != nullptr);
+        KeyType key = KeyTraits::GetKey(*ptr);
+
+        PrepareForInsert();
+        BucketType* bucket = BucketForInsert(GetHash(key));
+
+        // Duplicate keys are disallowed, as in HashTable.  The bucket checked
+        // here is the only bucket the key can live in: lookups of this hash
+        // value search both arrays, and migration drains the old array's
+        // bucket into this one.
+        ZX_DEBUG_ASSERT(FindInTable(key) == nullptr);
+
+        bucket->push_front(fbl::move(ptr));
+        ++count_;
+    }
+
+    // insert_or_find
+    //
+    // Insert the element pointed to by ptr if its key is not already in the
+    // table.  If a collision occurs and 'collided' is non-null, set it to
+    // point at the previously inserted element.
+    //
+    // Returns true if there was no collision and the item was successfully
+    // inserted, otherwise returns false.
+    bool insert_or_find(const PtrType& ptr, ValueType** collided = nullptr) {
+        return insert_or_find(PtrType(ptr), collided);
+    }
+
+    bool insert_or_find(PtrType&& ptr, ValueType** collided = nullptr) {
+        ZX_DEBUG_ASSERT(ptr != nullptr);
+        KeyType key = KeyTraits::GetKey(*ptr);
+
+        PrepareForInsert();
+
+        ValueType* found = FindInTable(key);
+        if (found != nullptr) {
+            if (collided) *collided = found;
+            return false;
+        }
+
+        BucketForInsert(GetHash(key))->push_front(fbl::move(ptr));
+        ++count_;
+        return true;
+    }
+
+    ValueType* find(const KeyType& key) {
+        MigrateSome();
+        return FindInTable(key);
+    }
+
+    const ValueType* find(const KeyType& key) const {
+        return FindInTable(key);
+    }
+
+    PtrType erase(const KeyType& key) {
+        MigrateSome();
+
+        HashType hash = GetHash(key);
+        PtrType ret = internal::KeyEraseUtils<BucketType, KeyTraits>::erase(
+                BucketFor(buckets_, bucket_count_, hash), key);
+        if (ret == nullptr && old_buckets_ != nullptr) {
+            ret = internal::KeyEraseUtils<BucketType, KeyTraits>::erase(
+                    BucketFor(old_buckets_, old_bucket_count_, hash), key);
+        }
+
+        if (ret != nullptr)
+            --count_;
+
+        return ret;
+    }
+
+    PtrType erase(ValueType& obj) {
+        MigrateSome();
+
+        HashType hash = GetHash(KeyTraits::GetKey(obj));
+        PtrType ret = internal::DirectEraseUtils<BucketType>::erase(
+                BucketFor(buckets_, bucket_count_, hash), obj);
+        if (ret == nullptr && old_buckets_ != nullptr) {
+            ret = internal::DirectEraseUtils<BucketType>::erase(
+                    BucketFor(old_buckets_, old_bucket_count_, hash), obj);
+        }
+
+        if (ret != nullptr)
+            --count_;
+
+        return ret;
+    }
+
+    // clear
+    //
+    // Clear out all of the hashtable buckets.  For managed pointer types,
+    // this will release all references held by the hashtable to the objects
+    // which were in it.  The current bucket array is kept; any in-progress
+    // rehash is completed trivially by dropping the drained old array.
+    void clear() {
+        for (HashType i = 0; i < bucket_count_; ++i)
+            buckets_[i].clear();
+        for (HashType i = 0; i < old_bucket_count_; ++i)
+            old_buckets_[i].clear();
+        old_buckets_.reset();
+        old_bucket_count_ = 0;
+        count_ = 0;
+    }
+
+    size_t size()     const { return count_; }
+    bool   is_empty() const { return count_ == 0; }
+
+    // The current size of the (new, if mid-rehash) bucket array; exposed
+    // mainly so tests can observe growth.
+    HashType bucket_count() const { return bucket_count_; }
+    bool is_rehashing() const { return old_buckets_ != nullptr; }
+
+    // erase_if
+    //
+    // Find the first member of the hash table which satisfies the predicate
+    // given by 'fn' and erase it from its bucket, returning a referenced
+    // pointer to the removed element.  Return nullptr if no member satisfies
+    // the predicate.
+    template <typename UnaryFn>
+    PtrType erase_if(UnaryFn fn) {
+        if (is_empty())
+            return PtrType(nullptr);
+
+        for (HashType i = 0; i < bucket_count_; ++i) {
+            PtrType ret = buckets_[i].erase_if(fn);
+            if (ret != nullptr) {
+                --count_;
+                return ret;
+            }
+        }
+
+        for (HashType i = 0; i < old_bucket_count_; ++i) {
+            PtrType ret = old_buckets_[i].erase_if(fn);
+            if (ret != nullptr) {
+                --count_;
+                return ret;
+            }
+        }
+
+        return PtrType(nullptr);
+    }
+
+    // find_if
+    //
+    // Find the first member of the hash table which satisfies the predicate
+    // given by 'fn'.  Return nullptr if no member satisfies the predicate.
+    template <typename UnaryFn>
+    ValueType* find_if(UnaryFn fn) {
+        for (HashType i = 0; i < bucket_count_; ++i) {
+            auto iter = buckets_[i].find_if(fn);
+            if (iter.IsValid())
+                return &*iter;
+        }
+
+        for (HashType i = 0; i < old_bucket_count_; ++i) {
+            auto iter = old_buckets_[i].find_if(fn);
+            if (iter.IsValid())
+                return &*iter;
+        }
+
+        return nullptr;
+    }
+
+private:
+    // Finalize-style avalanche mix so that sequential or otherwise weak hash
+    // values still spread across a power-of-two bucket count.
+    static HashType GetHash(const KeyType& key) {
+        uint64_t h = static_cast<uint64_t>(HashTraits::GetHash(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<HashType>(h);
+    }
+
+    static BucketType& BucketFor(const unique_ptr<BucketType[]>& buckets,
+                                 HashType bucket_count,
+                                 HashType hash) {
+        return buckets[hash & (bucket_count - 1)];
+    }
+
+    ValueType* FindInTable(const KeyType& key) const {
+        if (buckets_ == nullptr)
+            return nullptr;
+
+        HashType hash = GetHash(key);
+        auto iter = FindInBucket(BucketFor(buckets_, bucket_count_, hash), key);
+        if (iter.IsValid())
+            return &*iter;
+
+        if (old_buckets_ != nullptr) {
+            iter = FindInBucket(BucketFor(old_buckets_, old_bucket_count_, hash), key);
+            if (iter.IsValid())
+                return &*iter;
+        }
+
+        return nullptr;
+    }
+
+    static typename BucketType::iterator FindInBucket(BucketType& bucket,
+                                                      const KeyType& key) {
+        return bucket.find_if(
+            [key](const ValueType& other) -> bool {
+                return KeyTraits::EqualTo(key, KeyTraits::GetKey(other));
+            });
+    }
+
+    // While a rehash is in progress, new elements always land in the new
+    // array; the old array is drain-only.
+    BucketType* BucketForInsert(HashType hash) {
+        return &BucketFor(buckets_, bucket_count_, hash);
+    }
+
+    // Lazily allocate the initial array, advance any in-progress rehash, and
+    // kick off a new rehash if the load factor has reached 1.0.  Failure to
+    // allocate is absorbed; the table keeps working with what it has.
+    void PrepareForInsert() {
+        if (buckets_ == nullptr) {
+            AllocBuckets(kInitialBucketCount);
+            ZX_ASSERT(buckets_ != nullptr);  // initial array failure cannot be absorbed
+            return;
+        }
+
+        MigrateSome();
+
+        if ((old_buckets_ == nullptr) && (count_ >= bucket_count_)) {
+            // Growth doubles the array; bucket_count_ stays a power of two.
+            fbl::AllocChecker ac;
+            HashType new_count = bucket_count_ * 2;
+            unique_ptr<BucketType[]> new_buckets(new (&ac) BucketType[new_count]);
+            if (!ac.check())
+                return;
+
+            old_buckets_ = fbl::move(buckets_);
+            old_bucket_count_ = bucket_count_;
+            buckets_ = fbl::move(new_buckets);
+            bucket_count_ = new_count;
+            migrate_ndx_ = 0;
+        }
+    }
+
+    // Move the contents of up to kRehashBucketsPerOp old buckets into the new
+    // array, releasing the old array once it has been drained.
+    void MigrateSome() {
+        if (old_buckets_ == nullptr)
+            return;
+
+        for (HashType n = 0; (n < kRehashBucketsPerOp) && (migrate_ndx_ < old_bucket_count_);
+             ++n, ++migrate_ndx_) {
+            BucketType& bucket = old_buckets_[migrate_ndx_];
+            while (!bucket.is_empty()) {
+                PtrType ptr = bucket.pop_front();
+                HashType hash = GetHash(KeyTraits::GetKey(*ptr));
+                BucketFor(buckets_, bucket_count_, hash).push_front(fbl::move(ptr));
+            }
+        }
+
+        if (migrate_ndx_ >= old_bucket_count_) {
+            old_buckets_.reset();
+            old_bucket_count_ = 0;
+        }
+    }
+
+    void AllocBuckets(HashType bucket_count) {
+        fbl::AllocChecker ac;
+        unique_ptr<BucketType[]> buckets(new (&ac) BucketType[bucket_count]);
+        if (!ac.check())
+            return;
+
+        buckets_ = fbl::move(buckets);
+        bucket_count_ = bucket_count;
+    }
+
+    unique_ptr<BucketType[]> buckets_;
+    unique_ptr<BucketType[]> old_buckets_;
+    HashType bucket_count_ = 0;
+    HashType old_bucket_count_ = 0;
+    HashType migrate_ndx_ = 0;
+    size_t count_ = 0;
+};
+
+}  // namespace fbl
@@ -274,6 +274,47 @@ public:
         return nullptr;
     }
 
+    // bulk_load
+    //
+    // Populate an empty tree with |count| elements handed over, in strictly
+    // ascending key order, by successive invocations of |next| (a callable
+    // taking no arguments and returning PtrType).  The tree is built
+    // perfectly balanced in O(count) time with no rebalancing; loading a
+    // sorted snapshot this way is dramatically cheaper than |count|
+    // individual inserts.  It is an error to call bulk_load on a non-empty
+    // tree, or to supply elements out of order (both are DEBUG_ASSERTs).
+    //
+    template <typename NextFn>
+    void bulk_load(size_t count, NextFn next) {
+        ZX_DEBUG_ASSERT(is_empty());
+
+        if (!count)
+            return;
+
+        RawPtrType last = nullptr;
+        int height;
+        root_ = internal_build_balanced(count, next, &last, &height);
+
+        RawPtrType root_raw = PtrTraits::GetRaw(root_);
+        NodeTraits::node_state(*root_raw).parent_ = sentinel();
+
+        // The left-most node is found by walking down the left spine; the
+        // right-most node is simply the last element consumed.  Hang the
+        // begin/end sentinels off of them.
+        RawPtrType lm = root_raw;
+        while (NodeTraits::node_state(*lm).left_ != nullptr)
+            lm = PtrTraits::GetRaw(NodeTraits::node_state(*lm).left_);
+
+        left_most_  = lm;
+        right_most_ = last;
+        NodeTraits::node_state(*lm).left_    = PtrTraits::MakeSentinel(this);
+        NodeTraits::node_state(*last).right_ = PtrTraits::MakeSentinel(this);
+        count_ = count;
+
+        for (size_t i = 0; i < count; ++i)
+            Observer::RecordInsert();
+    }
+
     // pop_front and pop_back
     //
     // Removes either the left-most or right-most member of tree and transfers
@@ -360,6 +401,50 @@ public:
         return internal_erase(&obj);
     }
 
+    // erase_range
+    //
+    // Remove every element in the range [first, last), or (in the key-based
+    // form) every element whose key lies in the inclusive range
+    // [min_key, max_key].  Each removed pointer is handed to |fn|; overloads
+    // without |fn| simply drop the references (which, for managed pointer
+    // types, releases them).  Returns the number of elements removed.
+    //
+    // Note: removal is node-at-a-time rather than a subtree splice.  The
+    // node state stores only rank parity, which is not enough information to
+    // re-join the flanking subtrees directly; instead this leans on the
+    // tree's amortized constant post-erase rebalancing, so erasing k
+    // elements costs O(k) rebalance work beyond the O(log) cost of finding
+    // the range's bounds.
+    //
+    template <typename UnaryFn>
+    size_t erase_range(iterator first, const iterator& last, UnaryFn fn) {
+        size_t erased = 0;
+
+        while (first != last) {
+            // Advance past the doomed node before erasing it; |last| refers
+            // to a node beyond the range which stays in the tree, so it
+            // remains valid throughout.
+            auto target = first++;
+            fn(erase(target));
+            ++erased;
+        }
+
+        return erased;
+    }
+
+    size_t erase_range(iterator first, const iterator& last) {
+        return erase_range(first, last, [](PtrType) { });
+    }
+
+    template <typename UnaryFn>
+    size_t erase_range(const KeyType& min_key, const KeyType& max_key, UnaryFn fn) {
+        return erase_range(lower_bound(min_key), upper_bound(max_key), fn);
+    }
+
+    size_t erase_range(const KeyType& min_key, const KeyType& max_key) {
+        return erase_range(lower_bound(min_key), upper_bound(max_key), [](PtrType) { });
+    }
+
     // clear
     //
     // Clear out the tree, unlinking all of the elements in the process.  For
@@ -774,6 +859,63 @@ private:
         BalancePostInsert(PtrTraits::GetRaw(*owner));
     }
 
+    // Recursive worker for bulk_load.  Consumes |count| elements from |next|
+    // in-order and returns the root of a perfectly balanced subtree built
+    // from them, along with the subtree's height via |height| (-1 for an
+    // empty subtree).  |last| tracks the most recently consumed node, both
+    // for the sorted-input debug check and so bulk_load can locate the
+    // right-most node.  Parent pointers and sentinels of the returned root
+    // are fixed up by the caller.
+    //
+    // Node ranks are assigned to match subtree height, the same rank
+    // function an AVL-shaped tree has; all rank differences come out as 1 or
+    // 2, so the result is a valid WAVL tree.  Ranks start at 0 and are
+    // promoted up to the height (rank storage may only track parity); total
+    // promotions across the whole build sum to O(count).
+    template <typename NextFn>
+    PtrType internal_build_balanced(size_t count, NextFn& next, RawPtrType* last, int* height) {
+        if (!count) {
+            *height = -1;
+            return PtrType(nullptr);
+        }
+
+        size_t left_count  = (count - 1) / 2;
+        size_t right_count = count - 1 - left_count;
+
+        int left_height;
+        PtrType left = internal_build_balanced(left_count, next, last, &left_height);
+
+        PtrType node = next();
+        ZX_DEBUG_ASSERT(node != nullptr);
+
+        auto& ns = NodeTraits::node_state(*node);
+        ZX_DEBUG_ASSERT(ns.IsValid() && !ns.InContainer());
+        ZX_DEBUG_ASSERT((*last == nullptr) ||
+                        KeyTraits::LessThan(KeyTraits::GetKey(**last), KeyTraits::GetKey(*node)));
+
+        RawPtrType raw = PtrTraits::GetRaw(node);
+        *last = raw;
+
+        if (left != nullptr) {
+            NodeTraits::node_state(*left).parent_ = raw;
+            ns.left_ = fbl::move(left);
+        }
+
+        int right_height;
+        PtrType right = internal_build_balanced(right_count, next, last, &right_height);
+        if (right != nullptr) {
+            NodeTraits::node_state(*right).parent_ = raw;
+            ns.right_ = fbl::move(right);
+        }
+
+        *height = 1 + ((left_height > right_height) ? left_height : right_height);
+        ns.rank_ = 0;
+        for (int i = 0; i < *height; ++i)
+            ns.promote_rank();
+
+        return node;
+    }
+
     PtrType internal_erase(RawPtrType ptr) {
         if (!PtrTraits::IsValid(ptr))
             return PtrType(nullptr);
@@ -0,0 +1,163 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <zircon/assert.h>
+#include <zircon/compiler.h>
+#include <fbl/atomic.h>
+#include <fbl/macros.h>
+#include <fbl/ref_counted_internal.h>
+
+#if _KERNEL
+#include <kernel/thread.h>
+#else
+#include <threads.h>
+#endif
+
+namespace fbl {
+namespace internal {
+
+// An opaque token identifying the calling thread, used to decide whether a
+// reference count operation may take the non-atomic owner fast path.
+inline uintptr_t current_thread_token() {
+#if _KERNEL
+    return reinterpret_cast<uintptr_t>(get_current_thread());
+#else
+    // thrd_t is an integer on some architectures and a pointer on others.
+    return (uintptr_t)thrd_current();
+#endif
+}
+
+template <bool EnableAdoptionValidator>
+class BiasedRefCountedBase {
+protected:
+    constexpr BiasedRefCountedBase()
+        : biased_count_(1), shared_count_(1), owner_(kUnowned) {}
+    ~BiasedRefCountedBase() {}
+
+    void AddRef() const {
+        adoption_validator_.ValidateAddRef();
+        if (owner_.load(memory_order_relaxed) == current_thread_token()) {
+            ++biased_count_;
+        } else {
+            const int rc = shared_count_.fetch_add(1, memory_order_relaxed);
+            if (EnableAdoptionValidator) {
+                ZX_DEBUG_ASSERT_MSG(rc >= 1, "count %d < 1\n", rc);
+            }
+        }
+    }
+
+    // See RefCountedBase::AddRefMaybeInDestructor().  While the bias is
+    // held it contributes one reference to the shared count, so upgrading
+    // through the shared count alone is always safe.
+    bool AddRefMaybeInDestructor() {
+        return AddRefMaybeInDestructorDefault(shared_count_);
+    }
+
+    // Returns true if the object should self-delete.
+    bool Release() const __WARN_UNUSED_RESULT {
+        adoption_validator_.ValidateRelease();
+        if (owner_.load(memory_order_relaxed) == current_thread_token()) {
+            if (EnableAdoptionValidator) {
+                ZX_DEBUG_ASSERT_MSG(biased_count_ >= 1,
+                                    "biased count %d < 1\n", biased_count_);
+            }
+            if (--biased_count_ > 0) {
+                return false;
+            }
+            // The last owner-held reference is gone; revoke the bias and
+            // fold its contribution into the shared count.  From here on
+            // the (former) owner thread takes the shared path like any
+            // other thread.
+            owner_.store(kUnowned, memory_order_relaxed);
+        }
+        return ReleaseSharedRef();
+    }
+
+    // The adopting thread becomes the owner and counts its references with
+    // plain (non-atomic) arithmetic from here on.
+    void Adopt() const {
+        adoption_validator_.Adopt();
+        owner_.store(current_thread_token(), memory_order_relaxed);
+    }
+
+    // Current shared ref count. Only to be used for debugging purposes.
+    int ref_count_debug() const {
+        return shared_count_.load(memory_order_relaxed);
+    }
+
+private:
+    bool ReleaseSharedRef() const {
+        const int rc = shared_count_.fetch_sub(1, memory_order_release);
+        if (EnableAdoptionValidator) {
+            ZX_DEBUG_ASSERT_MSG(rc >= 1, "count %d < 1\n", rc);
+        }
+        if (rc == 1) {
+            atomic_thread_fence(memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+
+    static constexpr uintptr_t kUnowned = 0u;
+
+    // References taken and dropped on the owner thread.  Only ever touched
+    // by the owner thread while the bias is held, so no atomics are needed.
+    mutable int biased_count_;
+
+    // References taken and dropped by other threads, plus one for the bias
+    // itself while it is held.
+    mutable fbl::atomic_int shared_count_;
+
+    // Token of the owning thread, or kUnowned once the bias is revoked.
+    mutable fbl::atomic<uintptr_t> owner_;
+
+    AdoptionValidator<EnableAdoptionValidator> adoption_validator_;
+};
+
+} // namespace internal
+
+// A variant of fbl::RefCounted biased towards the thread which adopts the
+// object.  Use as
+//
+// class PerCpuQueue : public BiasedRefCounted<PerCpuQueue> {
+// };
+//
+// The adopting thread becomes the object's owner: AddRef() and Release()
+// calls made on that thread update a plain counter with no atomic
+// operations or cache-line contention, while every other thread falls back
+// to a shared atomic count.  When the owner drops its last reference the
+// bias is revoked and all threads (including the former owner) use the
+// shared count.  This is a win for objects with strong thread affinity --
+// per-core structures, dispatcher state touched on every syscall -- where
+// the owner accounts for nearly all of the reference churn.
+//
+// CAUTION: a reference must be dropped on the same side it was acquired
+// on.  A RefPtr created on the owner thread must not be handed to another
+// thread to be dropped there (and vice versa); doing so corrupts the split
+// count.  Cross-thread sharing is fine as long as the remote thread takes
+// its own reference (e.g. copies a RefPtr) and drops that.  Objects
+// without this kind of affinity should use fbl::RefCounted, which has no
+// such constraint.
+template <typename T,
+          bool EnableAdoptionValidator = ZX_DEBUG_ASSERT_IMPLEMENTED>
+class BiasedRefCounted
+    : public internal::BiasedRefCountedBase<EnableAdoptionValidator> {
+public:
+    BiasedRefCounted() {}
+    ~BiasedRefCounted() {}
+
+    using internal::BiasedRefCountedBase<EnableAdoptionValidator>::AddRef;
+    using internal::BiasedRefCountedBase<EnableAdoptionValidator>::Release;
+    using internal::BiasedRefCountedBase<EnableAdoptionValidator>::Adopt;
+    // Don't use this method. See the relevant RefPtr implementation for details.
+    using internal::BiasedRefCountedBase<
+        EnableAdoptionValidator>::AddRefMaybeInDestructor;
+
+    // BiasedRefCounted<> instances may not be copied, assigned or moved.
+    DISALLOW_COPY_ASSIGN_AND_MOVE(BiasedRefCounted);
+};
+
+} // namespace fbl
@@ -6,6 +6,7 @@
 
 #include <zircon/compiler.h>
 #include <fbl/algorithm.h>
+#include <fbl/atomic.h>
 #include <fbl/auto_lock.h>
 #include <fbl/deleter.h>
 #include <fbl/intrusive_single_list.h>
@@ -284,7 +285,8 @@ template <typename T,
           size_t SLAB_SIZE,
           typename LockType,
           SlabAllocatorFlavor AllocatorFlavor,
-          bool ENABLE_OBJ_COUNT>
+          bool ENABLE_OBJ_COUNT,
+          bool USE_LOCK_FREE_DEPOT>
 struct SlabAllocatorTraits;
 template <typename SATraits, typename = void> class SlabAllocator;
 template <typename SATraits, typename = void> class SlabAllocated;
@@ -409,6 +411,14 @@ protected:
 
     static constexpr size_t SlabOverhead = offsetof(Slab, storage_);
 
+    // Free objects handed back through the lock-free depot are linked through
+    // a simple next pointer constructed in the object's storage; a full
+    // FreeListEntry is built later, when the chain is spliced onto the
+    // (locked) free list.
+    struct DepotEntry {
+        DepotEntry* next;
+    };
+
 public:
     DISALLOW_COPY_ASSIGN_AND_MOVE(SlabAllocatorBase);
 
@@ -439,6 +449,11 @@ public:
     }
 
     ~SlabAllocatorBase() {
+        // Any objects still parked in the lock-free depot need to make it back
+        // to the free list before the bookkeeping checks below.  No locking is
+        // required; no one else can possibly still know about us.
+        DrainDepotLocked();
+
 #if ZX_DEBUG_ASSERT_IMPLEMENTED
         size_t allocated_count = 0;
         size_t free_list_size = this->free_list_.size_slow();
@@ -505,6 +520,35 @@ protected:
         free_list_.push_front(free_obj);
     }
 
+    // Push a free object onto the lock-free depot.  This is a classic Treiber
+    // stack push; it may be called concurrently from any number of threads
+    // without holding the allocator's lock.
+    void DepotPush(void* ptr) {
+        DepotEntry* entry = new (ptr) DepotEntry;
+
+        DepotEntry* old_head = depot_head_.load(memory_order_relaxed);
+        do {
+            entry->next = old_head;
+        } while (!depot_head_.compare_exchange_weak(&old_head, entry,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+    }
+
+    // Splice the entire depot chain onto the free list.  Called with the
+    // allocator's lock held (or during destruction).  Taking the whole chain
+    // with an unconditional exchange is what keeps the depot safe from the
+    // ABA problem which plagues one-at-a-time lock-free pops: no pop ever
+    // dereferences a next pointer read from shared memory.
+    void DrainDepotLocked() {
+        DepotEntry* chain = depot_head_.exchange(nullptr, memory_order_acquire);
+
+        while (chain != nullptr) {
+            DepotEntry* next = chain->next;
+            ReturnToFreeListLocked(chain);
+            chain = next;
+        }
+    }
+
 private:
     // Constant properties of the allocator passed to us by our templated
     // wrapper during construction.
@@ -518,6 +562,7 @@ private:
     SinglyLinkedList<FreeListEntry*> free_list_;
     SinglyLinkedList<Slab*>          slab_list_;
     size_t                           slab_count_ = 0;
+    atomic<DepotEntry*>              depot_head_{nullptr};
 };
 
 template <typename SATraits>
@@ -555,6 +600,13 @@ public:
                   "Objects which are slab allocated from an allocator of type "
                   "SlabAllocator<T> must derive from SlabAllocated<T>.");
 
+    // The lock-free depot updates no shared state under the allocator's lock
+    // during free, so it cannot maintain the object counters.
+    static_assert(!SATraits::USE_LOCK_FREE_DEPOT || !SATraits::ENABLE_OBJ_COUNT,
+                  "Lock-free depot slab allocators do not support object counting.");
+    static_assert(AllocSize >= sizeof(SlabAllocatorBase::DepotEntry),
+                  "Allocation size too small to hold a depot entry!");
+
     DISALLOW_COPY_ASSIGN_AND_MOVE(SlabAllocator);
 
     explicit SlabAllocator(size_t max_slabs, bool alloc_initial = false)
@@ -618,12 +670,26 @@ protected:
 
     void* Allocate() {
         AutoLock alloc_lock(&this->alloc_lock_);
+        if (SATraits::USE_LOCK_FREE_DEPOT) {
+            // Reclaim anything freed since the last allocation.  This is a
+            // single unconditional exchange when the depot is empty, and
+            // amortized constant work per freed object otherwise.
+            DrainDepotLocked();
+        }
         void* ptr = AllocateLocked();
         sa_obj_counter_.Inc(ptr);
         return ptr;
     }
 
     void ReturnToFreeList(void* ptr) {
+        if (SATraits::USE_LOCK_FREE_DEPOT) {
+            // Free operations never take the allocator's lock; the object is
+            // parked on the lock-free depot until the allocation side comes
+            // looking for memory.
+            DepotPush(ptr);
+            return;
+        }
+
         FreeListEntry* free_obj = new (ptr) FreeListEntry;
         {
             AutoLock alloc_lock(&alloc_lock_);
@@ -675,12 +741,22 @@ protected:
 //     the object to the allocator it came from.  MANUAL_DELETE allocators are
 //     only permitted for unmanaged pointer types.
 //
+// ++ USE_LOCK_FREE_DEPOT
+//  When set, freed objects are pushed onto a lock-free depot (a Treiber stack)
+//  instead of being returned to the free list under the allocator's lock, so
+//  free operations from any thread never contend with each other or with
+//  allocations.  The allocation side drains the whole depot onto the free
+//  list, in amortized constant time per object, whenever it takes the lock.
+//  This is a good fit for workloads where objects are allocated on one thread
+//  and released on others at high rates.  Incompatible with ENABLE_OBJ_COUNT.
+//
 ////////////////////////////////////////////////////////////////////////////////
 template <typename T,
           size_t   _SLAB_SIZE = DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE,
           typename _LockType  = ::fbl::Mutex,
           SlabAllocatorFlavor _AllocatorFlavor = SlabAllocatorFlavor::INSTANCED,
-          bool _ENABLE_OBJ_COUNT = false>
+          bool _ENABLE_OBJ_COUNT = false,
+          bool _USE_LOCK_FREE_DEPOT = false>
 struct SlabAllocatorTraits {
     using PtrTraits     = internal::SlabAllocatorPtrTraits<T>;
     using PtrType       = typename PtrTraits::PtrType;
@@ -690,6 +766,7 @@ struct SlabAllocatorTraits {
     static constexpr size_t SLAB_SIZE = _SLAB_SIZE;
     static constexpr SlabAllocatorFlavor AllocatorFlavor = _AllocatorFlavor;
     static constexpr bool ENABLE_OBJ_COUNT = _ENABLE_OBJ_COUNT;
+    static constexpr bool USE_LOCK_FREE_DEPOT = _USE_LOCK_FREE_DEPOT;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -815,6 +892,15 @@ using UnlockedSlabAllocatorTraits =
     SlabAllocatorTraits<T, SLAB_SIZE, ::fbl::NullLock, SlabAllocatorFlavor::INSTANCED,
                         ENABLE_OBJ_COUNT>;
 
+// Shorthand for declaring the properties of an instanced allocator whose free
+// path goes through the lock-free depot.
+template <typename T,
+          size_t   SLAB_SIZE = DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE,
+          typename LockType  = ::fbl::Mutex>
+using LockFreeDepotSlabAllocatorTraits =
+    SlabAllocatorTraits<T, SLAB_SIZE, LockType, SlabAllocatorFlavor::INSTANCED,
+                        false, true>;
+
 // Shorthand for declaring the properties of a MANUAL_DELETE slab allocator.
 template <typename T,
           size_t   SLAB_SIZE = DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE,
@@ -909,6 +995,13 @@ using UnlockedStaticSlabAllocatorTraits =
     SlabAllocatorTraits<T, SLAB_SIZE, ::fbl::NullLock, SlabAllocatorFlavor::STATIC,
                         ENABLE_OBJ_COUNT>;
 
+template <typename T,
+          size_t   SLAB_SIZE = DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE,
+          typename LockType  = ::fbl::Mutex>
+using LockFreeDepotStaticSlabAllocatorTraits =
+    SlabAllocatorTraits<T, SLAB_SIZE, LockType, SlabAllocatorFlavor::STATIC,
+                        false, true>;
+
 // Shorthand for declaring the global storage required for a static allocator
 #define DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(ALLOC_TRAITS, ...) \
 template<> ::fbl::SlabAllocator<ALLOC_TRAITS>::InternalAllocatorType \
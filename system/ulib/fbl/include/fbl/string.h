@@ -26,6 +26,14 @@ struct StringTestHelper;
 // stored on the heap.  Note that fbl::String does not have a null state
 // distinct from the empty state.
 //
+// fbl::String deliberately does not implement a small-string optimization:
+// the shared heap buffer is what makes copies allocation-free and keeps
+// |c_str()| stable for as long as any copy is alive, and an in-object
+// buffer would forfeit both properties while growing every String-bearing
+// structure.  When building short strings whose lifetime is bounded by a
+// scope, prefer fbl::StringBuffer, which stores its characters entirely
+// inline, or fbl::InlineVector for other small short-lived containers.
+//
 // The content of a fbl::String object is always stored with a null terminator
 // so that |c_str()| is fast.  However, be aware that the string may also contain
 // embedded null characters (this is not checked by the implementation).
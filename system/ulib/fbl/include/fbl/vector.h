@@ -20,6 +20,24 @@ namespace internal {
 template <typename U>
 using remove_cv_ref = typename remove_cv<typename remove_reference<U>::type>::type;
 
+// Storage for the first |InlineCount| elements of a Vector.  The raw
+// buffer is deliberately left uninitialized; element lifetimes within
+// it are managed explicitly by the Vector.
+template <typename T, size_t InlineCount>
+struct VectorInlineStorage {
+    T* inline_ptr() { return reinterpret_cast<T*>(storage_); }
+    const T* inline_ptr() const { return reinterpret_cast<const T*>(storage_); }
+
+private:
+    alignas(T) char storage_[InlineCount * sizeof(T)];
+};
+
+// Vectors without inline storage carry no extra state.
+template <typename T>
+struct VectorInlineStorage<T, 0> {
+    constexpr T* inline_ptr() const { return nullptr; }
+};
+
 } // namespace internal
 
 struct DefaultAllocatorTraits {
@@ -58,27 +76,37 @@ struct DefaultAllocatorTraits {
 // This Vector supports O(1) indexing and O(1) (amortized) insertion and
 // deletion at the end (due to possible reallocations during push_back
 // and pop_back).
-template <typename T, typename AllocatorTraits = DefaultAllocatorTraits>
-class Vector {
+//
+// When |InlineCount| is non-zero, storage for the first |InlineCount|
+// elements lives inside the Vector object itself and the heap is only
+// touched once the vector grows beyond that. This is a good fit for
+// short-lived vectors which usually hold a handful of elements. Note
+// that with inline storage, pointers returned by get()/begin() are
+// invalidated when the vector is moved or swapped, and that moving or
+// swapping an inline vector moves its elements one at a time rather
+// than exchanging a pointer. See also the fbl::InlineVector alias below.
+template <typename T, typename AllocatorTraits = DefaultAllocatorTraits,
+          size_t InlineCount = 0>
+class Vector : private internal::VectorInlineStorage<T, InlineCount> {
 public:
     // move semantics only
     DISALLOW_COPY_AND_ASSIGN_ALLOW_MOVE(Vector);
 
     constexpr Vector()
-        : ptr_(nullptr), size_(0U), capacity_(0U) {}
+        : ptr_(this->inline_ptr()), size_(0U), capacity_(InlineCount) {}
 
     Vector(Vector&& other)
-        : ptr_(nullptr), size_(other.size_), capacity_(other.capacity_) {
-        ptr_ = other.release();
+        : ptr_(this->inline_ptr()), size_(0U), capacity_(InlineCount) {
+        move_from(other);
     }
 
 #ifndef _KERNEL
     Vector(fbl::initializer_list<T> init)
-        : ptr_(init.size() != 0u ? reinterpret_cast<T*>(AllocatorTraits::Allocate(
-                                       init.size() * sizeof(T)))
-                                 : nullptr),
-          size_(init.size()),
-          capacity_(size_) {
+        : ptr_(this->inline_ptr()), size_(init.size()), capacity_(InlineCount) {
+        if (init.size() > InlineCount) {
+            ptr_ = reinterpret_cast<T*>(AllocatorTraits::Allocate(init.size() * sizeof(T)));
+            capacity_ = init.size();
+        }
         T* out = ptr_;
         for (const T* in = init.begin(); in != init.end(); ++in, ++out) {
             new (out) T(*in);
@@ -87,9 +115,8 @@ public:
 #endif
 
     Vector& operator=(Vector&& o) {
-        auto size = o.size_;
-        auto capacity = o.capacity_;
-        reset(o.release(), size, capacity);
+        reset();
+        move_from(o);
         return *this;
     }
 
@@ -124,21 +151,72 @@ public:
 #endif // _KERNEL
 
     void reset() {
-        reset(nullptr, 0U, 0U);
+        while (size_ > 0) {
+            ptr_[--size_].~T();
+        }
+        if (!is_inline()) {
+            AllocatorTraits::Deallocate(ptr_);
+        }
+        ptr_ = this->inline_ptr();
+        capacity_ = InlineCount;
     }
 
     void swap(Vector& other) {
-        T* t = ptr_;
-        ptr_ = other.ptr_;
-        other.ptr_ = t;
+        if (!is_inline() && !other.is_inline()) {
+            T* t = ptr_;
+            ptr_ = other.ptr_;
+            other.ptr_ = t;
+            size_t size = size_;
+            size_t capacity = capacity_;
+
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+
+            other.size_ = size;
+            other.capacity_ = capacity;
+            return;
+        }
+        if (is_inline() && !other.is_inline()) {
+            other.swap(*this);
+            return;
+        }
+        if (!is_inline()) {
+            // |this| is heap-backed and |other|'s elements are inline: hand
+            // |other| the heap buffer and move its elements into our inline
+            // buffer.
+            T* ptr = ptr_;
+            size_t size = size_;
+            size_t capacity = capacity_;
+            ptr_ = this->inline_ptr();
+            capacity_ = InlineCount;
+            other.transfer_to(ptr_, other.size_);
+            size_ = other.size_;
+            other.ptr_ = ptr;
+            other.size_ = size;
+            other.capacity_ = capacity;
+            return;
+        }
+        // Both sets of elements are inline: swap the common prefix
+        // element-wise and move the tail between the inline buffers.
+        Vector* longer = this;
+        Vector* shorter = &other;
+        if (longer->size_ < shorter->size_) {
+            longer = &other;
+            shorter = this;
+        }
+        size_t i = 0;
+        for (; i < shorter->size_; i++) {
+            T tmp(fbl::move(shorter->ptr_[i]));
+            shorter->ptr_[i] = fbl::move(longer->ptr_[i]);
+            longer->ptr_[i] = fbl::move(tmp);
+        }
+        for (; i < longer->size_; i++) {
+            new (&shorter->ptr_[i]) T(fbl::move(longer->ptr_[i]));
+            longer->ptr_[i].~T();
+        }
         size_t size = size_;
-        size_t capacity = capacity_;
-
         size_ = other.size_;
-        capacity_ = other.capacity_;
-
         other.size_ = size;
-        other.capacity_ = capacity;
     }
 
     void push_back(T&& value, AllocChecker* ac) {
@@ -388,13 +466,22 @@ private:
     bool reallocate(size_t newCapacity, AllocChecker* ac) {
         ZX_DEBUG_ASSERT(newCapacity > 0);
         ZX_DEBUG_ASSERT(newCapacity >= size_);
+        if (newCapacity <= InlineCount) {
+            // Moving into (or staying within) the inline buffer never
+            // touches the allocator.
+            shrink_to_inline();
+            ac->arm(0u, true);
+            return true;
+        }
         auto newPtr = reinterpret_cast<T*>(AllocatorTraits::Allocate(newCapacity * sizeof(T)));
         if (newPtr == nullptr) {
             ac->arm(1u, false);
             return false;
         }
         transfer_to(newPtr, size_);
-        AllocatorTraits::Deallocate(ptr_);
+        if (!is_inline()) {
+            AllocatorTraits::Deallocate(ptr_);
+        }
         capacity_ = newCapacity;
         ptr_ = newPtr;
         ac->arm(0u, true);
@@ -405,35 +492,56 @@ private:
     void reallocate(size_t newCapacity) {
         ZX_DEBUG_ASSERT(newCapacity > 0);
         ZX_DEBUG_ASSERT(newCapacity >= size_);
+        if (newCapacity <= InlineCount) {
+            shrink_to_inline();
+            return;
+        }
         auto newPtr = reinterpret_cast<T*>(AllocatorTraits::Allocate(newCapacity * sizeof(T)));
         transfer_to(newPtr, size_);
-        AllocatorTraits::Deallocate(ptr_);
+        if (!is_inline()) {
+            AllocatorTraits::Deallocate(ptr_);
+        }
         capacity_ = newCapacity;
         ptr_ = newPtr;
     }
 #endif
 
-    // Release returns the underlying storage of the vector,
-    // while emptying out the vector itself (so it can be destroyed
-    // without deleting the release storage).
-    T* release() {
-        T* t = ptr_;
-        ptr_ = nullptr;
-        size_ = 0;
-        capacity_ = 0;
-        return t;
+    // Moves the elements back into the inline buffer, releasing any
+    // heap-backed storage. May only be called when size_ <= InlineCount.
+    void shrink_to_inline() {
+        if (!is_inline()) {
+            T* oldPtr = ptr_;
+            transfer_to(this->inline_ptr(), size_);
+            AllocatorTraits::Deallocate(oldPtr);
+            ptr_ = this->inline_ptr();
+            capacity_ = InlineCount;
+        }
     }
 
-    void reset(T* t, size_t size, size_t capacity) {
-        ZX_DEBUG_ASSERT(size <= capacity);
-        while (size_ > 0) {
-            ptr_[--size_].~T();
+    // Returns true when the elements live in the inline buffer rather
+    // than in a heap allocation.
+    bool is_inline() const {
+        return InlineCount > 0 && ptr_ == this->inline_ptr();
+    }
+
+    // Takes the contents of |other|, leaving it empty. Heap-backed
+    // storage is stolen by pointer; elements living in |other|'s inline
+    // buffer are moved one at a time since that buffer cannot outlive
+    // |other|.
+    void move_from(Vector& other) {
+        ZX_DEBUG_ASSERT(size_ == 0);
+        if (!other.is_inline()) {
+            ptr_ = other.ptr_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.ptr_ = other.inline_ptr();
+            other.size_ = 0;
+            other.capacity_ = InlineCount;
+        } else {
+            other.transfer_to(ptr_, other.size_);
+            size_ = other.size_;
+            other.size_ = 0;
         }
-        T* ptr = ptr_;
-        ptr_ = t;
-        size_ = size;
-        capacity_ = capacity;
-        AllocatorTraits::Deallocate(ptr);
     }
 
     T* ptr_;
@@ -445,4 +553,10 @@ private:
     static constexpr size_t kCapacityShrinkFactor = 4;
 };
 
+// Shorthand for a Vector with inline storage for its first |InlineCount|
+// elements, e.g. fbl::InlineVector<zx_handle_t, 4>.
+template <typename T, size_t InlineCount,
+          typename AllocatorTraits = DefaultAllocatorTraits>
+using InlineVector = Vector<T, AllocatorTraits, InlineCount>;
+
 } // namespace fbl
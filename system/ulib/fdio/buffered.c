@@ -0,0 +1,465 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+#include <unistd.h>
+
+#include <zircon/types.h>
+#include <lib/fdio/io.h>
+#include <lib/fdio/util.h>
+
+#include "private.h"
+#include "unistd.h"
+
+// A buffered fdio_t wraps another fdio_t and interposes on the stream
+// operations (read/write/seek), staging small sequential transfers
+// through in-process buffers so that they amortize to one call on the
+// underlying transport per buffer fill or drain.  Everything else is
+// forwarded to the wrapped object.
+//
+// The read buffer is invalidated whenever the stream position moves
+// underneath it (seek, or a write to an object with a shared seek
+// pointer); the write buffer is flushed before any operation that
+// observes the underlying object (read, seek, clone, get_vmo, close).
+
+typedef struct bfdio {
+    fdio_t io;
+    fdio_t* inner;
+    mtx_t lock;
+    size_t bufsize;
+    // Read buffer: buf[rpos, rlen) is data fetched from inner but not
+    // yet consumed.  Write buffer: buf[bufsize, bufsize + wlen) is data
+    // accepted from the caller but not yet written to inner.
+    size_t rpos;
+    size_t rlen;
+    size_t wlen;
+    uint8_t buf[];
+} bfdio_t;
+
+#define BUFFERED_DEFAULT_SIZE 8192
+
+static inline uint8_t* bfdio_wbuf(bfdio_t* b) {
+    return b->buf + b->bufsize;
+}
+
+// Push the write buffer down to the wrapped object.  On failure
+// (including ZX_ERR_SHOULD_WAIT) the unwritten tail is kept so the
+// caller's retry picks up where this attempt stopped.
+static zx_status_t bfdio_flush_locked(bfdio_t* b) {
+    size_t off = 0;
+    while (off < b->wlen) {
+        ssize_t r = b->inner->ops->write(b->inner, bfdio_wbuf(b) + off, b->wlen - off);
+        if (r < 0) {
+            memmove(bfdio_wbuf(b), bfdio_wbuf(b) + off, b->wlen - off);
+            b->wlen -= off;
+            return (zx_status_t)r;
+        }
+        if (r == 0) {
+            memmove(bfdio_wbuf(b), bfdio_wbuf(b) + off, b->wlen - off);
+            b->wlen -= off;
+            return ZX_ERR_IO;
+        }
+        off += (size_t)r;
+    }
+    b->wlen = 0;
+    return ZX_OK;
+}
+
+// Drop unconsumed readahead.  For objects with a seek pointer the
+// pointer is moved back over the unread bytes so the caller observes
+// the position it has logically consumed to; objects without a seek
+// pointer (pipes, sockets) have independent directions and fail the
+// seek harmlessly.
+static void bfdio_purge_read_locked(bfdio_t* b) {
+    if (b->rpos < b->rlen) {
+        b->inner->ops->seek(b->inner, (off_t)b->rpos - (off_t)b->rlen, SEEK_CUR);
+    }
+    b->rpos = 0;
+    b->rlen = 0;
+}
+
+static ssize_t bfdio_read(fdio_t* io, void* data, size_t len) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    if (r != ZX_OK) {
+        mtx_unlock(&b->lock);
+        return r;
+    }
+    size_t avail = b->rlen - b->rpos;
+    if (avail == 0) {
+        if (len >= b->bufsize) {
+            // Large reads gain nothing from staging; go straight down.
+            ssize_t n = b->inner->ops->read(b->inner, data, len);
+            mtx_unlock(&b->lock);
+            return n;
+        }
+        ssize_t n = b->inner->ops->read(b->inner, b->buf, b->bufsize);
+        if (n <= 0) {
+            mtx_unlock(&b->lock);
+            return n;
+        }
+        b->rpos = 0;
+        b->rlen = (size_t)n;
+        avail = (size_t)n;
+    }
+    size_t n = (len < avail) ? len : avail;
+    memcpy(data, b->buf + b->rpos, n);
+    b->rpos += n;
+    mtx_unlock(&b->lock);
+    return (ssize_t)n;
+}
+
+static ssize_t bfdio_write(fdio_t* io, const void* data, size_t len) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    bfdio_purge_read_locked(b);
+    if (len >= b->bufsize) {
+        // A write this large would just pass through the buffer;
+        // flush what's pending and send it down in one call.
+        zx_status_t r = bfdio_flush_locked(b);
+        if (r != ZX_OK) {
+            mtx_unlock(&b->lock);
+            return r;
+        }
+        ssize_t n = b->inner->ops->write(b->inner, data, len);
+        mtx_unlock(&b->lock);
+        return n;
+    }
+    if (b->wlen + len > b->bufsize) {
+        zx_status_t r = bfdio_flush_locked(b);
+        if (r != ZX_OK) {
+            mtx_unlock(&b->lock);
+            return r;
+        }
+    }
+    memcpy(bfdio_wbuf(b) + b->wlen, data, len);
+    b->wlen += len;
+    mtx_unlock(&b->lock);
+    return (ssize_t)len;
+}
+
+static off_t bfdio_seek(fdio_t* io, off_t offset, int whence) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    if (r != ZX_OK) {
+        mtx_unlock(&b->lock);
+        return r;
+    }
+    if (whence == SEEK_CUR) {
+        // The caller's notion of "current" excludes unread readahead.
+        offset -= (off_t)(b->rlen - b->rpos);
+    }
+    b->rpos = 0;
+    b->rlen = 0;
+    off_t n = b->inner->ops->seek(b->inner, offset, whence);
+    mtx_unlock(&b->lock);
+    return n;
+}
+
+// Positional io does not move the stream pointer, so it bypasses the
+// buffers; pending writes are flushed first so a read_at sees them.
+static ssize_t bfdio_read_at(fdio_t* io, void* data, size_t len, off_t offset) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    if (r != ZX_OK) {
+        mtx_unlock(&b->lock);
+        return r;
+    }
+    ssize_t n = b->inner->ops->read_at(b->inner, data, len, offset);
+    mtx_unlock(&b->lock);
+    return n;
+}
+
+static ssize_t bfdio_write_at(fdio_t* io, const void* data, size_t len, off_t offset) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    if (r != ZX_OK) {
+        mtx_unlock(&b->lock);
+        return r;
+    }
+    ssize_t n = b->inner->ops->write_at(b->inner, data, len, offset);
+    mtx_unlock(&b->lock);
+    return n;
+}
+
+static zx_status_t bfdio_close(fdio_t* io) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    // Best effort; the underlying close proceeds regardless so the fd
+    // does not leak on a full disk.
+    bfdio_flush_locked(b);
+    mtx_unlock(&b->lock);
+    zx_status_t r = b->inner->ops->close(b->inner);
+    fdio_release(b->inner);
+    b->inner = NULL;
+    return r;
+}
+
+static zx_status_t bfdio_sync(fdio_t* io) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    mtx_unlock(&b->lock);
+    if (r != ZX_OK) {
+        return r;
+    }
+    return b->inner->ops->sync(b->inner);
+}
+
+static zx_status_t bfdio_misc(fdio_t* io, uint32_t op, int64_t off, uint32_t arg, void* data, size_t len) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->misc(b->inner, op, off, arg, data, len);
+}
+
+static zx_status_t bfdio_open(fdio_t* io, const char* path, uint32_t flags, uint32_t mode, fdio_t** out) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->open(b->inner, path, flags, mode, out);
+}
+
+static zx_status_t bfdio_clone(fdio_t* io, zx_handle_t* handles, uint32_t* types) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    mtx_unlock(&b->lock);
+    if (r != ZX_OK) {
+        return r;
+    }
+    return b->inner->ops->clone(b->inner, handles, types);
+}
+
+static zx_status_t bfdio_unwrap(fdio_t* io, zx_handle_t* handles, uint32_t* types) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    mtx_unlock(&b->lock);
+    if (r != ZX_OK) {
+        return r;
+    }
+    return b->inner->ops->unwrap(b->inner, handles, types);
+}
+
+static void bfdio_wait_begin(fdio_t* io, uint32_t events, zx_handle_t* handle, zx_signals_t* signals) {
+    bfdio_t* b = (bfdio_t*)io;
+    b->inner->ops->wait_begin(b->inner, events, handle, signals);
+}
+
+static void bfdio_wait_end(fdio_t* io, zx_signals_t signals, uint32_t* events) {
+    bfdio_t* b = (bfdio_t*)io;
+    b->inner->ops->wait_end(b->inner, signals, events);
+}
+
+static ssize_t bfdio_ioctl(fdio_t* io, uint32_t op, const void* in_buf,
+                           size_t in_len, void* out_buf, size_t out_len) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->ioctl(b->inner, op, in_buf, in_len, out_buf, out_len);
+}
+
+static ssize_t bfdio_posix_ioctl(fdio_t* io, int req, va_list va) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->posix_ioctl(b->inner, req, va);
+}
+
+static zx_status_t bfdio_get_vmo(fdio_t* io, int flags, zx_handle_t* out) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    mtx_unlock(&b->lock);
+    if (r != ZX_OK) {
+        return r;
+    }
+    return b->inner->ops->get_vmo(b->inner, flags, out);
+}
+
+static zx_status_t bfdio_get_token(fdio_t* io, zx_handle_t* out) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->get_token(b->inner, out);
+}
+
+static zx_status_t bfdio_get_attr(fdio_t* io, vnattr_t* out) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->get_attr(b->inner, out);
+}
+
+static zx_status_t bfdio_set_attr(fdio_t* io, const vnattr_t* attr) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->set_attr(b->inner, attr);
+}
+
+static zx_status_t bfdio_readdir(fdio_t* io, void* ptr, size_t max, size_t* actual) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->readdir(b->inner, ptr, max, actual);
+}
+
+static zx_status_t bfdio_rewind(fdio_t* io) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->rewind(b->inner);
+}
+
+static zx_status_t bfdio_unlink(fdio_t* io, const char* path, size_t len) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->unlink(b->inner, path, len);
+}
+
+static zx_status_t bfdio_truncate(fdio_t* io, off_t off) {
+    bfdio_t* b = (bfdio_t*)io;
+    mtx_lock(&b->lock);
+    zx_status_t r = bfdio_flush_locked(b);
+    bfdio_purge_read_locked(b);
+    mtx_unlock(&b->lock);
+    if (r != ZX_OK) {
+        return r;
+    }
+    return b->inner->ops->truncate(b->inner, off);
+}
+
+static zx_status_t bfdio_rename(fdio_t* io, const char* src, size_t srclen,
+                                zx_handle_t dst_token, const char* dst, size_t dstlen) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->rename(b->inner, src, srclen, dst_token, dst, dstlen);
+}
+
+static zx_status_t bfdio_link(fdio_t* io, const char* src, size_t srclen,
+                              zx_handle_t dst_token, const char* dst, size_t dstlen) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->link(b->inner, src, srclen, dst_token, dst, dstlen);
+}
+
+static zx_status_t bfdio_get_flags(fdio_t* io, uint32_t* out_flags) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->get_flags(b->inner, out_flags);
+}
+
+static zx_status_t bfdio_set_flags(fdio_t* io, uint32_t flags) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->set_flags(b->inner, flags);
+}
+
+static ssize_t bfdio_recvfrom(fdio_t* io, void* data, size_t len, int flags, struct sockaddr* restrict addr, socklen_t* restrict addrlen) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->recvfrom(b->inner, data, len, flags, addr, addrlen);
+}
+
+static ssize_t bfdio_sendto(fdio_t* io, const void* data, size_t len, int flags, const struct sockaddr* addr, socklen_t addrlen) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->sendto(b->inner, data, len, flags, addr, addrlen);
+}
+
+static ssize_t bfdio_recvmsg(fdio_t* io, struct msghdr* msg, int flags) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->recvmsg(b->inner, msg, flags);
+}
+
+static ssize_t bfdio_sendmsg(fdio_t* io, const struct msghdr* msg, int flags) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->sendmsg(b->inner, msg, flags);
+}
+
+static zx_status_t bfdio_shutdown(fdio_t* io, int how) {
+    bfdio_t* b = (bfdio_t*)io;
+    return b->inner->ops->shutdown(b->inner, how);
+}
+
+static fdio_ops_t fdio_buffered_ops = {
+    .read = bfdio_read,
+    .read_at = bfdio_read_at,
+    .write = bfdio_write,
+    .write_at = bfdio_write_at,
+    .seek = bfdio_seek,
+    .misc = bfdio_misc,
+    .close = bfdio_close,
+    .open = bfdio_open,
+    .clone = bfdio_clone,
+    .ioctl = bfdio_ioctl,
+    .wait_begin = bfdio_wait_begin,
+    .wait_end = bfdio_wait_end,
+    .unwrap = bfdio_unwrap,
+    .posix_ioctl = bfdio_posix_ioctl,
+    .get_vmo = bfdio_get_vmo,
+    .get_token = bfdio_get_token,
+    .get_attr = bfdio_get_attr,
+    .set_attr = bfdio_set_attr,
+    .sync = bfdio_sync,
+    .readdir = bfdio_readdir,
+    .rewind = bfdio_rewind,
+    .unlink = bfdio_unlink,
+    .truncate = bfdio_truncate,
+    .rename = bfdio_rename,
+    .link = bfdio_link,
+    .get_flags = bfdio_get_flags,
+    .set_flags = bfdio_set_flags,
+    .recvfrom = bfdio_recvfrom,
+    .sendto = bfdio_sendto,
+    .recvmsg = bfdio_recvmsg,
+    .sendmsg = bfdio_sendmsg,
+    .shutdown = bfdio_shutdown,
+};
+
+// Takes ownership of inner on success.
+static fdio_t* fdio_buffered_create(fdio_t* inner, size_t bufsize) {
+    bfdio_t* b = fdio_alloc(sizeof(*b) + bufsize * 2);
+    if (b == NULL) {
+        return NULL;
+    }
+    b->io.ops = &fdio_buffered_ops;
+    b->io.magic = FDIO_MAGIC;
+    atomic_init(&b->io.refcount, 1);
+    b->io.ioflag = inner->ioflag;
+    b->inner = inner;
+    b->bufsize = bufsize;
+    mtx_init(&b->lock, mtx_plain);
+    return &b->io;
+}
+
+zx_status_t fdio_buffer_fd(int fd, size_t buffer_size) {
+    if (buffer_size == 0) {
+        buffer_size = BUFFERED_DEFAULT_SIZE;
+    }
+    fdio_t* inner;
+    zx_status_t r = fdio_unbind_from_fd(fd, &inner);
+    if (r != ZX_OK) {
+        return r;
+    }
+    if (inner->ops == &fdio_buffered_ops) {
+        // Already buffered; put it back untouched.
+        fdio_bind_to_fd(inner, fd, 0);
+        return ZX_OK;
+    }
+    fdio_t* io = fdio_buffered_create(inner, buffer_size);
+    if (io == NULL) {
+        fdio_bind_to_fd(inner, fd, 0);
+        return ZX_ERR_NO_MEMORY;
+    }
+    if (fdio_bind_to_fd(io, fd, 0) < 0) {
+        // The slot was stolen between unbind and bind; unwind fully.
+        io->ops->close(io);
+        fdio_release(io);
+        return ZX_ERR_BAD_STATE;
+    }
+    return ZX_OK;
+}
+
+zx_status_t fdio_flush_fd(int fd) {
+    fdio_t* io = fd_to_io(fd);
+    if (io == NULL) {
+        return ZX_ERR_BAD_HANDLE;
+    }
+    zx_status_t r = ZX_OK;
+    if (io->ops == &fdio_buffered_ops) {
+        bfdio_t* b = (bfdio_t*)io;
+        mtx_lock(&b->lock);
+        r = bfdio_flush_locked(b);
+        mtx_unlock(&b->lock);
+    }
+    fdio_release(io);
+    return r;
+}
@@ -10,6 +10,7 @@
 
 #include <lib/fdio/io.h>
 #include <lib/fdio/remoteio.h>
+#include <lib/fdio/util.h>
 #include <lib/fdio/vfs.h>
 
 #define MIN_WINDOW (PAGE_SIZE * 4)
@@ -166,3 +167,57 @@ zx_status_t fdio_get_vmo_exact(int fd, zx_handle_t* out_vmo) {
 zx_status_t fdio_get_exact_vmo(int fd, zx_handle_t* out_vmo) {
     return fdio_get_vmo_exact(fd, out_vmo);
 }
+
+zx_status_t fdio_vmofile_fd(int fd) {
+    fdio_t* inner;
+    zx_status_t status = fdio_unbind_from_fd(fd, &inner);
+    if (status != ZX_OK) {
+        return status;
+    }
+
+    // Capture the size and seek position so the swap is invisible to
+    // the caller's stream io.
+    vnattr_t attr;
+    if ((status = inner->ops->get_attr(inner, &attr)) != ZX_OK) {
+        goto fail_rebind;
+    }
+    off_t ptr = inner->ops->seek(inner, 0, SEEK_CUR);
+    if (ptr < 0) {
+        ptr = 0;
+    }
+
+    // Prefer a copy-on-write clone of the server's VMO (one IPC, pages
+    // shared with the server's cache); servers that can't clone get the
+    // contents read into a fresh VMO instead.  Either way, reads from
+    // here on are satisfied locally.
+    zx_handle_t vmo;
+    if ((status = copy_file_vmo(inner, &vmo)) != ZX_OK) {
+        goto fail_rebind;
+    }
+
+    fdio_t* io = fdio_vmofile_create(vmo, 0, attr.size);
+    if (io == NULL) {
+        status = ZX_ERR_NO_MEMORY;
+        goto fail_rebind;
+    }
+    io->ioflag = inner->ioflag;
+    if (ptr != 0) {
+        io->ops->seek(io, ptr, SEEK_SET);
+    }
+
+    inner->ops->close(inner);
+    fdio_release(inner);
+
+    if (fdio_bind_to_fd(io, fd, 0) < 0) {
+        // The slot was stolen between unbind and bind; the original
+        // connection is already gone, so just clean up.
+        io->ops->close(io);
+        fdio_release(io);
+        return ZX_ERR_BAD_STATE;
+    }
+    return ZX_OK;
+
+fail_rebind:
+    fdio_bind_to_fd(inner, fd, 0);
+    return status;
+}
@@ -88,4 +88,68 @@ zx_status_t fdio_get_exact_vmo(int fd, zx_handle_t* out_vmo) __DEPRECATE;
 // is closed.
 int fdio_vmo_fd(zx_handle_t vmo, uint64_t offset, uint64_t length);
 
+// Replace the remote connection behind |fd| with a local VMO-backed
+// snapshot of the file's contents, so subsequent read()/pread()s are
+// satisfied from memory with no round trip to the server.  The file's
+// VMO is fetched once (a copy-on-write clone when the server supports
+// it, a one-time copy otherwise) and the seek position is preserved.
+//
+// The resulting fd is read-only and does not observe later changes to
+// the file; intended for config/data files that are opened once and
+// read repeatedly.  Fails with ZX_ERR_UNAVAILABLE if the fd has been
+// dup()'d.
+zx_status_t fdio_vmofile_fd(int fd);
+
+// Interpose a buffered stream layer over |fd|, so that small sequential
+// read()s and write()s are staged through in-process buffers and cost
+// one underlying transaction per buffer fill or drain rather than one
+// per call.  Buffered writes are pushed down on flush, seek, sync,
+// clone, and close; readahead is discarded (and the seek pointer
+// repositioned) whenever the stream position moves underneath it.
+// A |buffer_size| of 0 selects a default.  Fails with
+// ZX_ERR_UNAVAILABLE if the fd has been dup()'d, since the duplicates
+// would bypass the buffers.
+zx_status_t fdio_buffer_fd(int fd, size_t buffer_size);
+
+// Flush any write-buffered data for |fd| down to the underlying object.
+// Succeeds trivially if the fd is not buffered.
+zx_status_t fdio_flush_fd(int fd);
+
+// A poll set holds persistent fd registrations on a port, so an event
+// loop pays for registration once per fd instead of once per
+// poll()/select() call; the per-wakeup cost is O(ready fds).
+//
+// Events are edge-style: a registration queues a packet when its
+// signals become asserted, and the same fd may be reported more than
+// once per wait if its signals re-assert.  Callers should drain a
+// reported fd until it would block before waiting again.
+typedef struct fdio_poll_set fdio_poll_set_t;
+
+typedef struct fdio_poll_event {
+    int fd;
+    uint32_t events; // POLL* events observed
+} fdio_poll_event_t;
+
+zx_status_t fdio_poll_set_create(fdio_poll_set_t** out);
+void fdio_poll_set_destroy(fdio_poll_set_t* ps);
+
+// Register interest in POLL* |events| on |fd|.  The fd must not
+// already be in the set.  The registration holds a reference to the
+// underlying io object; remove the fd from the set before close() if
+// the transport should be torn down promptly.
+zx_status_t fdio_poll_set_add(fdio_poll_set_t* ps, int fd, uint32_t events);
+
+// Change the events a registered fd is watched for.
+zx_status_t fdio_poll_set_mod(fdio_poll_set_t* ps, int fd, uint32_t events);
+
+// Drop a registration.
+zx_status_t fdio_poll_set_remove(fdio_poll_set_t* ps, int fd);
+
+// Wait until at least one registered fd has events pending (or the
+// deadline passes, returning ZX_ERR_TIMED_OUT).  Up to |max_events|
+// ready fds are reported; only the first blocks, the rest are drained
+// opportunistically.
+zx_status_t fdio_poll_set_wait(fdio_poll_set_t* ps, fdio_poll_event_t* events,
+                               size_t max_events, zx_time_t deadline, size_t* actual);
+
 __END_CDECLS
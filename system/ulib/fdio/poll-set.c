@@ -0,0 +1,224 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <poll.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include <zircon/listnode.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/port.h>
+#include <zircon/types.h>
+#include <lib/fdio/io.h>
+
+#include "private.h"
+#include "unistd.h"
+
+// Persistent poll registration, built on a port.
+//
+// ppoll()/select() pay O(registered) on every call: each fd's signals
+// are translated and a fresh wait is assembled every time around the
+// event loop.  A poll set registers interest once per fd with
+// ZX_WAIT_ASYNC_REPEATING, so the steady-state cost of a wakeup is one
+// zx_port_wait() plus one packet per ready fd.
+//
+// Events are edge-style: a packet is queued when the signals become
+// asserted, and the caller is expected to drain the fd until it would
+// block before waiting again.
+
+typedef struct fdio_poll_entry {
+    list_node_t node;
+    fdio_t* io;          // held alive for the life of the registration
+    zx_handle_t handle;  // borrowed from io via wait_begin
+    zx_signals_t signals;
+    uint32_t events;     // POLL* events requested
+    int fd;
+} fdio_poll_entry_t;
+
+struct fdio_poll_set {
+    zx_handle_t port;
+    mtx_t lock;
+    list_node_t entries;
+};
+
+static fdio_poll_entry_t* poll_set_find_locked(fdio_poll_set_t* ps, int fd) {
+    fdio_poll_entry_t* entry;
+    list_for_every_entry(&ps->entries, entry, fdio_poll_entry_t, node) {
+        if (entry->fd == fd) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void poll_entry_destroy_locked(fdio_poll_set_t* ps, fdio_poll_entry_t* entry) {
+    zx_port_cancel(ps->port, entry->handle, (uint64_t)entry->fd);
+    list_delete(&entry->node);
+    fdio_release(entry->io);
+    free(entry);
+}
+
+zx_status_t fdio_poll_set_create(fdio_poll_set_t** out) {
+    fdio_poll_set_t* ps = calloc(1, sizeof(fdio_poll_set_t));
+    if (ps == NULL) {
+        return ZX_ERR_NO_MEMORY;
+    }
+    zx_status_t r = zx_port_create(0, &ps->port);
+    if (r != ZX_OK) {
+        free(ps);
+        return r;
+    }
+    mtx_init(&ps->lock, mtx_plain);
+    list_initialize(&ps->entries);
+    *out = ps;
+    return ZX_OK;
+}
+
+void fdio_poll_set_destroy(fdio_poll_set_t* ps) {
+    mtx_lock(&ps->lock);
+    fdio_poll_entry_t* entry;
+    while ((entry = list_peek_head_type(&ps->entries, fdio_poll_entry_t, node)) != NULL) {
+        poll_entry_destroy_locked(ps, entry);
+    }
+    mtx_unlock(&ps->lock);
+    zx_handle_close(ps->port);
+    free(ps);
+}
+
+zx_status_t fdio_poll_set_add(fdio_poll_set_t* ps, int fd, uint32_t events) {
+    fdio_t* io = fd_to_io(fd);
+    if (io == NULL) {
+        return ZX_ERR_BAD_HANDLE;
+    }
+    zx_handle_t h;
+    zx_signals_t sigs;
+    io->ops->wait_begin(io, events, &h, &sigs);
+    if (h == ZX_HANDLE_INVALID) {
+        // this object's signals can't be waited on
+        fdio_release(io);
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
+    mtx_lock(&ps->lock);
+    if (poll_set_find_locked(ps, fd) != NULL) {
+        mtx_unlock(&ps->lock);
+        fdio_release(io);
+        return ZX_ERR_ALREADY_EXISTS;
+    }
+    fdio_poll_entry_t* entry = calloc(1, sizeof(fdio_poll_entry_t));
+    if (entry == NULL) {
+        mtx_unlock(&ps->lock);
+        fdio_release(io);
+        return ZX_ERR_NO_MEMORY;
+    }
+    zx_status_t r = zx_object_wait_async(h, ps->port, (uint64_t)fd, sigs,
+                                         ZX_WAIT_ASYNC_REPEATING);
+    if (r != ZX_OK) {
+        mtx_unlock(&ps->lock);
+        free(entry);
+        fdio_release(io);
+        return r;
+    }
+    entry->io = io;
+    entry->handle = h;
+    entry->signals = sigs;
+    entry->events = events;
+    entry->fd = fd;
+    list_add_tail(&ps->entries, &entry->node);
+    mtx_unlock(&ps->lock);
+    return ZX_OK;
+}
+
+zx_status_t fdio_poll_set_mod(fdio_poll_set_t* ps, int fd, uint32_t events) {
+    mtx_lock(&ps->lock);
+    fdio_poll_entry_t* entry = poll_set_find_locked(ps, fd);
+    if (entry == NULL) {
+        mtx_unlock(&ps->lock);
+        return ZX_ERR_NOT_FOUND;
+    }
+    zx_handle_t h;
+    zx_signals_t sigs;
+    entry->io->ops->wait_begin(entry->io, events, &h, &sigs);
+    if (h == ZX_HANDLE_INVALID) {
+        mtx_unlock(&ps->lock);
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+    zx_port_cancel(ps->port, entry->handle, (uint64_t)fd);
+    zx_status_t r = zx_object_wait_async(h, ps->port, (uint64_t)fd, sigs,
+                                         ZX_WAIT_ASYNC_REPEATING);
+    if (r != ZX_OK) {
+        // the old registration is gone; drop the entry entirely
+        list_delete(&entry->node);
+        fdio_release(entry->io);
+        free(entry);
+        mtx_unlock(&ps->lock);
+        return r;
+    }
+    entry->handle = h;
+    entry->signals = sigs;
+    entry->events = events;
+    mtx_unlock(&ps->lock);
+    return ZX_OK;
+}
+
+zx_status_t fdio_poll_set_remove(fdio_poll_set_t* ps, int fd) {
+    mtx_lock(&ps->lock);
+    fdio_poll_entry_t* entry = poll_set_find_locked(ps, fd);
+    if (entry == NULL) {
+        mtx_unlock(&ps->lock);
+        return ZX_ERR_NOT_FOUND;
+    }
+    poll_entry_destroy_locked(ps, entry);
+    mtx_unlock(&ps->lock);
+    return ZX_OK;
+}
+
+// Translate one signal packet into a user event.  Returns false if the
+// registration vanished between the packet being queued and drained, or
+// if masking leaves no events to report.
+static bool poll_set_translate_locked(fdio_poll_set_t* ps, const zx_port_packet_t* packet,
+                                      fdio_poll_event_t* out) {
+    fdio_poll_entry_t* entry = poll_set_find_locked(ps, (int)packet->key);
+    if (entry == NULL) {
+        return false;
+    }
+    uint32_t events = 0;
+    entry->io->ops->wait_end(entry->io, packet->signal.observed, &events);
+    events &= entry->events | POLLHUP | POLLERR;
+    if (events == 0) {
+        return false;
+    }
+    out->fd = entry->fd;
+    out->events = events;
+    return true;
+}
+
+zx_status_t fdio_poll_set_wait(fdio_poll_set_t* ps, fdio_poll_event_t* events,
+                               size_t max_events, zx_time_t deadline, size_t* actual) {
+    if (max_events == 0) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    size_t count = 0;
+    while (count < max_events) {
+        zx_port_packet_t packet;
+        // Block only for the first packet; drain the rest opportunistically.
+        zx_status_t r = zx_port_wait(ps->port, count == 0 ? deadline : 0, &packet);
+        if (r == ZX_ERR_TIMED_OUT) {
+            break;
+        }
+        if (r != ZX_OK) {
+            return r;
+        }
+        if (!ZX_PKT_IS_SIGNAL_REP(packet.type)) {
+            continue;
+        }
+        mtx_lock(&ps->lock);
+        if (poll_set_translate_locked(ps, &packet, &events[count])) {
+            count++;
+        }
+        mtx_unlock(&ps->lock);
+    }
+    *actual = count;
+    return (count == 0) ? ZX_ERR_TIMED_OUT : ZX_OK;
+}
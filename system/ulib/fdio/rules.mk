@@ -12,6 +12,7 @@ MODULE_TYPE := userlib
 
 MODULE_SRCS += \
     $(LOCAL_DIR)/bsdsocket.c \
+    $(LOCAL_DIR)/buffered.c \
     $(LOCAL_DIR)/debug.c \
     $(LOCAL_DIR)/get-vmo.c \
     $(LOCAL_DIR)/fidl.c \
@@ -21,6 +22,7 @@ MODULE_SRCS += \
     $(LOCAL_DIR)/null.c \
     $(LOCAL_DIR)/output.c \
     $(LOCAL_DIR)/pipe.c \
+    $(LOCAL_DIR)/poll-set.c \
     $(LOCAL_DIR)/remoteio.c \
     $(LOCAL_DIR)/service.c \
     $(LOCAL_DIR)/socketpair.c \
@@ -843,44 +843,152 @@ int fdio_status_to_errno(zx_status_t status) {
 // The functions from here on provide implementations of fd and path
 // centric posix-y io operations.
 
-ssize_t readv(int fd, const struct iovec* iov, int num) {
+// The vectored operations below bounce the segments through a single
+// gather/scatter buffer per transaction rather than issuing one
+// transaction per iovec element.  Since remote I/O carries at most
+// FDIO_CHUNK_SIZE bytes of payload per message either way, this turns a
+// scattered 8-segment write into one message instead of eight without
+// any new wire protocol.  |ofs| selects positional I/O (preadv/pwritev)
+// and is advanced past the transferred bytes; NULL means use the seek
+// pointer.
+
+static ssize_t fdio_writev(int fd, const struct iovec* iov, int num, off_t* ofs) {
+    char buf[FDIO_CHUNK_SIZE];
     ssize_t count = 0;
-    ssize_t r;
-    while (num > 0) {
-        if (iov->iov_len != 0) {
-            r = read(fd, iov->iov_base, iov->iov_len);
-            if (r < 0) {
-                return count ? count : r;
+    if (num <= 0) {
+        return 0;
+    }
+    // Working copy of the first unconsumed segment; a transfer can end
+    // partway through it.
+    struct iovec head = *iov;
+    for (;;) {
+        while (head.iov_len == 0) {
+            iov++;
+            if (--num == 0) {
+                return count;
+            }
+            head = *iov;
+        }
+        const void* src;
+        size_t n;
+        if (num == 1) {
+            // A single remaining segment needs no gathering.
+            src = head.iov_base;
+            n = head.iov_len;
+        } else {
+            n = head.iov_len < sizeof(buf) ? head.iov_len : sizeof(buf);
+            memcpy(buf, head.iov_base, n);
+            for (int i = 1; i < num && n < sizeof(buf); i++) {
+                size_t c = iov[i].iov_len;
+                if (c > sizeof(buf) - n) {
+                    c = sizeof(buf) - n;
+                }
+                memcpy(buf + n, iov[i].iov_base, c);
+                n += c;
             }
-            if ((size_t)r < iov->iov_len) {
-                return count + r;
+            src = buf;
+        }
+        ssize_t r = ofs ? pwrite(fd, src, n, *ofs) : write(fd, src, n);
+        if (r < 0) {
+            return count ? count : r;
+        }
+        count += r;
+        if (ofs) {
+            *ofs += r;
+        }
+        if ((size_t)r < n) {
+            return count;
+        }
+        // Consume the segments this transfer covered.
+        size_t done = (size_t)r;
+        while (done >= head.iov_len) {
+            done -= head.iov_len;
+            iov++;
+            if (--num == 0) {
+                return count;
             }
-            count += r;
+            head = *iov;
         }
-        iov++;
-        num--;
+        head.iov_base = (char*)head.iov_base + done;
+        head.iov_len -= done;
     }
-    return count;
 }
 
-ssize_t writev(int fd, const struct iovec* iov, int num) {
+static ssize_t fdio_readv(int fd, const struct iovec* iov, int num, off_t* ofs) {
+    char buf[FDIO_CHUNK_SIZE];
     ssize_t count = 0;
-    ssize_t r;
-    while (num > 0) {
-        if (iov->iov_len != 0) {
-            r = write(fd, iov->iov_base, iov->iov_len);
-            if (r < 0) {
-                return count ? count : r;
+    if (num <= 0) {
+        return 0;
+    }
+    struct iovec head = *iov;
+    for (;;) {
+        while (head.iov_len == 0) {
+            iov++;
+            if (--num == 0) {
+                return count;
+            }
+            head = *iov;
+        }
+        size_t n;
+        ssize_t r;
+        if (num == 1) {
+            // A single remaining segment can be read in place.
+            n = head.iov_len;
+            r = ofs ? pread(fd, head.iov_base, n, *ofs) : read(fd, head.iov_base, n);
+        } else {
+            n = head.iov_len;
+            for (int i = 1; i < num && n < sizeof(buf); i++) {
+                n += iov[i].iov_len;
             }
-            if ((size_t)r < iov->iov_len) {
-                return count + r;
+            if (n > sizeof(buf)) {
+                n = sizeof(buf);
             }
-            count += r;
+            r = ofs ? pread(fd, buf, n, *ofs) : read(fd, buf, n);
+            if (r > 0) {
+                // Scatter the data out to the segments.
+                size_t c = head.iov_len < (size_t)r ? head.iov_len : (size_t)r;
+                memcpy(head.iov_base, buf, c);
+                size_t off = c;
+                for (int i = 1; i < num && off < (size_t)r; i++) {
+                    c = iov[i].iov_len;
+                    if (c > (size_t)r - off) {
+                        c = (size_t)r - off;
+                    }
+                    memcpy(iov[i].iov_base, buf + off, c);
+                    off += c;
+                }
+            }
+        }
+        if (r < 0) {
+            return count ? count : r;
+        }
+        count += r;
+        if (ofs) {
+            *ofs += r;
+        }
+        if ((size_t)r < n) {
+            return count;
+        }
+        size_t done = (size_t)r;
+        while (done >= head.iov_len) {
+            done -= head.iov_len;
+            iov++;
+            if (--num == 0) {
+                return count;
+            }
+            head = *iov;
         }
-        iov++;
-        num--;
+        head.iov_base = (char*)head.iov_base + done;
+        head.iov_len -= done;
     }
-    return count;
+}
+
+ssize_t readv(int fd, const struct iovec* iov, int num) {
+    return fdio_readv(fd, iov, num, NULL);
+}
+
+ssize_t writev(int fd, const struct iovec* iov, int num) {
+    return fdio_writev(fd, iov, num, NULL);
 }
 
 zx_status_t _mmap_file(size_t offset, size_t len, zx_vm_option_t zx_options, int flags, int fd,
@@ -966,24 +1074,7 @@ ssize_t write(int fd, const void* buf, size_t count) {
 }
 
 ssize_t preadv(int fd, const struct iovec* iov, int count, off_t ofs) {
-    ssize_t iov_count = 0;
-    ssize_t r;
-    while (count > 0) {
-        if (iov->iov_len != 0) {
-            r = pread(fd, iov->iov_base, iov->iov_len, ofs);
-            if (r < 0) {
-                return iov_count ? iov_count : r;
-            }
-            if ((size_t)r < iov->iov_len) {
-                return iov_count + r;
-            }
-            iov_count += r;
-            ofs += r;
-        }
-        iov++;
-        count--;
-    }
-    return iov_count;
+    return fdio_readv(fd, iov, count, &ofs);
 }
 
 ssize_t pread(int fd, void* buf, size_t size, off_t ofs) {
@@ -1008,24 +1099,7 @@ ssize_t pread(int fd, void* buf, size_t size, off_t ofs) {
 }
 
 ssize_t pwritev(int fd, const struct iovec* iov, int count, off_t ofs) {
-    ssize_t iov_count = 0;
-    ssize_t r;
-    while (count > 0) {
-        if (iov->iov_len != 0) {
-            r = pwrite(fd, iov->iov_base, iov->iov_len, ofs);
-            if (r < 0) {
-                return iov_count ? iov_count : r;
-            }
-            if ((size_t)r < iov->iov_len) {
-                return iov_count + r;
-            }
-            iov_count += r;
-            ofs += r;
-        }
-        iov++;
-        count--;
-    }
-    return iov_count;
+    return fdio_writev(fd, iov, count, &ofs);
 }
 
 ssize_t pwrite(int fd, const void* buf, size_t size, off_t ofs) {
@@ -47,4 +47,29 @@ Builder MessageBuffer::CreateBuilder() {
     return Builder(bytes(), bytes_capacity());
 }
 
+UnownedMessageBuffer::UnownedMessageBuffer(void* buffer,
+                                           uint32_t bytes_capacity,
+                                           uint32_t handles_capacity)
+    : buffer_(static_cast<uint8_t*>(buffer)),
+      bytes_capacity_(bytes_capacity),
+      handles_capacity_(handles_capacity) {
+    ZX_ASSERT_MSG(buffer_ != nullptr,
+                  "NULL buffer in UnownedMessageBuffer::UnownedMessageBuffer()");
+    ZX_ASSERT_MSG((reinterpret_cast<uintptr_t>(buffer_) & (FIDL_ALIGNMENT - 1)) == 0,
+                  "misaligned buffer in UnownedMessageBuffer::UnownedMessageBuffer()");
+}
+
+zx_handle_t* UnownedMessageBuffer::handles() const {
+    return reinterpret_cast<zx_handle_t*>(buffer_ + AddPadding(bytes_capacity_));
+}
+
+Message UnownedMessageBuffer::CreateEmptyMessage() {
+    return Message(BytePart(bytes(), bytes_capacity()),
+                   HandlePart(handles(), handles_capacity()));
+}
+
+Builder UnownedMessageBuffer::CreateBuilder() {
+    return Builder(bytes(), bytes_capacity());
+}
+
 } // namespace fidl
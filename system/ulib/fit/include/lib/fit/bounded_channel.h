@@ -0,0 +1,149 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fit {
+
+// A bounded multi-producer multi-consumer channel for passing values
+// (typically deferred work, such as a |fit::function<void()>|) between
+// threads without taking locks.
+//
+// Producers and consumers synchronize through per-slot sequence
+// counters (Vyukov's bounded MPMC queue), so a push or pop performs one
+// compare-and-swap on the shared cursor plus one acquire/release pair
+// on the slot; threads never block one another and there is no mutex to
+// convoy on.  Capacity is fixed at construction, which keeps the
+// channel's memory bounded and makes backpressure explicit: |try_push|
+// fails rather than allocating when the channel is full.
+//
+// |T| must be movable.  Values are reported in FIFO order per producer;
+// ordering between producers is the order their CAS operations land.
+//
+// EXAMPLE:
+//
+//     fit::bounded_channel<fit::function<void()>> work(256);
+//
+//     // any thread:
+//     work.try_push([] { do_stuff(); });
+//
+//     // worker threads:
+//     fit::function<void()> task;
+//     while (work.try_pop(&task))
+//         task();
+//
+template <typename T>
+class bounded_channel {
+public:
+    // Creates a channel holding at most |capacity| values; |capacity|
+    // is rounded up to a power of two (minimum 2).
+    explicit bounded_channel(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        mask_ = cap - 1;
+        slots_.reset(new slot[cap]);
+        for (size_t i = 0; i < cap; i++)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    ~bounded_channel() {
+        // Drain anything the consumers never took.
+        T value;
+        while (try_pop(&value)) {
+        }
+    }
+
+    bounded_channel(const bounded_channel&) = delete;
+    bounded_channel& operator=(const bounded_channel&) = delete;
+
+    // Attempts to move |value| into the channel.
+    // Returns false (leaving |value| untouched) if the channel is full.
+    bool try_push(T value) {
+        slot* s;
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            s = &slots_[pos & mask_];
+            size_t seq = s->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        new (&s->storage) T(std::move(value));
+        s->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Attempts to move the oldest value out of the channel into
+    // |*value|.  Returns false if the channel is empty.
+    bool try_pop(T* value) {
+        slot* s;
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            s = &slots_[pos & mask_];
+            size_t seq = s->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        T* stored = reinterpret_cast<T*>(&s->storage);
+        *value = std::move(*stored);
+        stored->~T();
+        s->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns the number of slots in the channel.
+    size_t capacity() const { return mask_ + 1; }
+
+    // Returns true if the channel appeared empty at the time of the
+    // call; under concurrent use this is only a hint.
+    bool empty() const {
+        return head_.load(std::memory_order_relaxed) ==
+               tail_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct slot {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    // The cursors are kept on separate cache lines from each other (and
+    // from the slot array pointer) with explicit padding; C++14 heap
+    // allocation does not honor extended alignment, so alignas is
+    // deliberately not used here.
+    std::unique_ptr<slot[]> slots_;
+    size_t mask_;
+    char pad0_[64];
+    std::atomic<size_t> head_;
+    char pad1_[64];
+    std::atomic<size_t> tail_;
+};
+
+} // namespace fit
@@ -0,0 +1,185 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fbl/auto_call.h>
+#include <fbl/unique_fd.h>
+
+#include "fs-host/cache.h"
+
+namespace {
+
+// First line of every sidecar; bump the version when the format changes so
+// older sidecars are simply treated as absent.
+constexpr char kCacheHeader[] = "fs-host image cache v1";
+
+constexpr size_t kHexLength = digest::Digest::kLength * 2;
+
+} // namespace
+
+zx_status_t ImageCache::Load(const char* image_path) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s.cache", image_path) >=
+        static_cast<int>(sizeof(path))) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    sidecar_path_ = path;
+
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) {
+        return ZX_ERR_NOT_FOUND;
+    }
+    auto cleanup = fbl::MakeAutoCall([f]() { fclose(f); });
+
+    char line[PATH_MAX + kHexLength + 32];
+    if (fgets(line, sizeof(line), f) == nullptr ||
+        strncmp(line, kCacheHeader, strlen(kCacheHeader))) {
+        return ZX_ERR_IO_DATA_INTEGRITY;
+    }
+
+    if (fscanf(f, "image %" SCNu64 " %" SCNd64 "\n", &image_size_,
+               &image_mtime_) != 2) {
+        return ZX_ERR_IO_DATA_INTEGRITY;
+    }
+
+    // Each remaining line is "<hex digest> <length> <path>". The path is
+    // last so that it may contain spaces.
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        if (strlen(line) < kHexLength + 1 || line[kHexLength] != ' ') {
+            return ZX_ERR_IO_DATA_INTEGRITY;
+        }
+        digest::Digest digest;
+        if (digest.Parse(line, kHexLength) != ZX_OK) {
+            return ZX_ERR_IO_DATA_INTEGRITY;
+        }
+
+        char* end;
+        uint64_t length = strtoull(&line[kHexLength + 1], &end, 10);
+        if (end == &line[kHexLength + 1] || *end != ' ') {
+            return ZX_ERR_IO_DATA_INTEGRITY;
+        }
+
+        char* file = end + 1;
+        char* newline = strchr(file, '\n');
+        if (newline == nullptr || newline == file) {
+            return ZX_ERR_IO_DATA_INTEGRITY;
+        }
+        *newline = '\0';
+
+        Entry entry;
+        entry.path = file;
+        digest.CopyTo(entry.digest, sizeof(entry.digest));
+        entry.length = length;
+        previous_.push_back(fbl::move(entry));
+    }
+
+    return ZX_OK;
+}
+
+bool ImageCache::Validate(const struct stat& stats) const {
+    return image_size_ == static_cast<uint64_t>(stats.st_size) &&
+           image_mtime_ == static_cast<int64_t>(stats.st_mtime);
+}
+
+const ImageCache::Entry* ImageCache::Lookup(const char* path) const {
+    for (size_t n = 0; n < previous_.size(); n++) {
+        if (!strcmp(path, previous_[n].path.c_str())) {
+            return &previous_[n];
+        }
+    }
+    return nullptr;
+}
+
+void ImageCache::Record(const char* path, const digest::Digest& digest,
+                        uint64_t length) {
+    Entry entry;
+    entry.path = path;
+    digest.CopyTo(entry.digest, sizeof(entry.digest));
+    entry.length = length;
+    current_.push_back(fbl::move(entry));
+}
+
+zx_status_t ImageCache::Save(int image_fd) {
+    if (sidecar_path_.empty()) {
+        return ZX_ERR_BAD_STATE;
+    }
+
+    struct stat stats;
+    if (fstat(image_fd, &stats) < 0) {
+        return ZX_ERR_IO;
+    }
+
+    char tmp[PATH_MAX];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", sidecar_path_.c_str()) >=
+        static_cast<int>(sizeof(tmp))) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    FILE* f = fopen(tmp, "w");
+    if (f == nullptr) {
+        return ZX_ERR_IO;
+    }
+
+    fprintf(f, "%s\n", kCacheHeader);
+    fprintf(f, "image %" PRIu64 " %" PRId64 "\n",
+            static_cast<uint64_t>(stats.st_size),
+            static_cast<int64_t>(stats.st_mtime));
+
+    for (size_t n = 0; n < current_.size(); n++) {
+        char hex[kHexLength + 1];
+        digest::Digest digest(current_[n].digest);
+        digest.ToString(hex, sizeof(hex));
+        fprintf(f, "%s %" PRIu64 " %s\n", hex, current_[n].length,
+                current_[n].path.c_str());
+    }
+
+    if (fclose(f) != 0 || rename(tmp, sidecar_path_.c_str()) < 0) {
+        unlink(tmp);
+        return ZX_ERR_IO;
+    }
+    return ZX_OK;
+}
+
+void ImageCache::Discard() {
+    if (!sidecar_path_.empty()) {
+        unlink(sidecar_path_.c_str());
+    }
+}
+
+zx_status_t ImageCache::HashFile(const char* path, digest::Digest* out,
+                                 uint64_t* out_length) {
+    fbl::unique_fd fd(open(path, O_RDONLY, 0644));
+    if (!fd) {
+        return ZX_ERR_IO;
+    }
+
+    digest::Digest digest;
+    zx_status_t status;
+    if ((status = digest.Init()) != ZX_OK) {
+        return status;
+    }
+
+    char buffer[64 * 1024];
+    uint64_t total = 0;
+    ssize_t r;
+    while ((r = read(fd.get(), buffer, sizeof(buffer))) > 0) {
+        digest.Update(buffer, r);
+        total += r;
+    }
+    if (r < 0) {
+        return ZX_ERR_IO;
+    }
+
+    digest.Final();
+    *out = fbl::move(digest);
+    *out_length = total;
+    return ZX_OK;
+}
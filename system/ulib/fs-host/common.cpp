@@ -26,6 +26,8 @@ struct {
 } OPTS[] = {
     {"depfile", Option::kDepfile, "",          nullptr,
         "Produce a depfile"},
+    {"cache",   Option::kCache,   "",          nullptr,
+        "On create, reuse the existing image and only rewrite changed files"},
     {"readonly", Option::kReadonly, "",        nullptr,
         "Mount filesystem read-only"},
     {"offset",   Option::kOffset,   "[bytes]", "0",
@@ -229,7 +231,7 @@ zx_status_t FsCreator::ProcessArgs(int argc, char** argv) {
 
         int opt_index;
 
-        int c = getopt_long(argc, argv, "+dro:l:h", opts, &opt_index);
+        int c = getopt_long(argc, argv, "+dcro:l:h", opts, &opt_index);
         if (c < 0) {
             break;
         }
@@ -238,6 +240,9 @@ zx_status_t FsCreator::ProcessArgs(int argc, char** argv) {
         case 'd':
             depfile_needed = true;
             break;
+        case 'c':
+            use_cache_ = true;
+            break;
         case 'r':
             read_only_ = true;
             break;
@@ -314,6 +319,13 @@ zx_status_t FsCreator::ProcessArgs(int argc, char** argv) {
         return ZX_ERR_IO;
     }
 
+    if (use_cache_) {
+        // Pick up the sidecar from the previous run, if any; whether the
+        // existing image may actually be reused is decided in ResizeFile,
+        // once the required size for the new input set is known.
+        cache_loaded_ = cache_.Load(device) == ZX_OK;
+    }
+
     // Unless we are creating an image, the length_ has already been decided.
     if (command_ != Command::kMkfs) {
         if (length_) {
@@ -433,8 +445,19 @@ zx_status_t FsCreator::RunCommand() {
     }
 
     switch (command_) {
-    case Command::kMkfs:
-        return Mkfs();
+    case Command::kMkfs: {
+        zx_status_t status = incremental_ ? Update() : Mkfs();
+        if (status == ZX_OK && use_cache_) {
+            // The image is fully written; stamp the sidecar against it so
+            // the next run can tell whether the image is still ours. A
+            // failure here only costs the next run a full rebuild.
+            if (cache_.Save(fd_.get()) != ZX_OK) {
+                fprintf(stderr, "warning: could not write image cache\n");
+                cache_.Discard();
+            }
+        }
+        return status;
+    }
     case Command::kFsck:
         return Fsck();
     case Command::kAdd:
@@ -522,6 +545,19 @@ zx_status_t FsCreator::ResizeFile(off_t requested_size, struct stat stats) {
         }
     }
 
+    if (cache_loaded_ && !is_block && cache_.Validate(stats) &&
+        required_size <= stats.st_size &&
+        (!requested_size || requested_size == stats.st_size)) {
+        // The image on disk is the one the previous cached run wrote, and it
+        // is large enough for the new input set: leave it untouched so that
+        // Update() can rewrite only the files whose content changed.
+        incremental_ = true;
+        if (!length_) {
+            length_ = stats.st_size - offset_;
+        }
+        return ZX_OK;
+    }
+
     if (command_ == Command::kMkfs && !is_block &&
         (stats.st_size != required_size || requested_size)) {
         // Only truncate the file size under the following conditions:
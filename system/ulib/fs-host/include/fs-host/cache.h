@@ -0,0 +1,78 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <digest/digest.h>
+#include <fbl/macros.h>
+#include <fbl/string.h>
+#include <fbl/vector.h>
+#include <zircon/types.h>
+
+// ImageCache is a content-addressed index of the files already present in a
+// generated fs image, stored in a sidecar file next to the image
+// ("<image>.cache"). Each entry maps a destination path to the digest and
+// length of the content written there, and the index as a whole is stamped
+// with the size and mtime the image had when the sidecar was written. A
+// later run whose inputs still fit may verify the stamp and update the image
+// in place, rewriting only the files whose content digest changed rather
+// than re-packing the entire image.
+class ImageCache {
+public:
+    struct Entry {
+        fbl::String path;
+        uint8_t digest[digest::Digest::kLength];
+        uint64_t length;
+    };
+
+    ImageCache() {}
+    DISALLOW_COPY_ASSIGN_AND_MOVE(ImageCache);
+
+    // Associates the cache with |image_path| and attempts to parse the
+    // sidecar left by a previous run. Returns ZX_ERR_NOT_FOUND if no sidecar
+    // exists, or ZX_ERR_IO_DATA_INTEGRITY if one exists but cannot be
+    // parsed. |Save| and |Discard| may be used regardless of the result.
+    zx_status_t Load(const char* image_path);
+
+    // Returns true if |stats| matches the image stamp recorded by |Load|,
+    // i.e. the image on disk is still the one the sidecar describes.
+    bool Validate(const struct stat& stats) const;
+
+    // Returns the previous run's entry for |path|, or nullptr.
+    const Entry* Lookup(const char* path) const;
+
+    // All entries parsed from the previous run's sidecar.
+    const fbl::Vector<Entry>& Previous() const { return previous_; }
+
+    // Records |path| as containing content with the given |digest| and
+    // |length| in the image currently being generated.
+    void Record(const char* path, const digest::Digest& digest, uint64_t length);
+
+    // Atomically replaces the sidecar with the recorded entries, stamped
+    // with the state of the (fully written) image open at |image_fd|.
+    zx_status_t Save(int image_fd);
+
+    // Removes the sidecar, forcing the next run to rebuild from scratch.
+    // Used when an in-place update fails partway through.
+    void Discard();
+
+    // Computes the content digest and length of the host file at |path|.
+    static zx_status_t HashFile(const char* path, digest::Digest* out,
+                                uint64_t* out_length);
+
+private:
+    fbl::String sidecar_path_;
+
+    // Stamp of the image at the time the sidecar was written. The mtime has
+    // second granularity, which is sufficient to detect the image being
+    // rebuilt or modified by anything other than the run which stamped it.
+    uint64_t image_size_ = 0;
+    int64_t image_mtime_ = 0;
+
+    fbl::Vector<Entry> previous_;
+    fbl::Vector<Entry> current_;
+};
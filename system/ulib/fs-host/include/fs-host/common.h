@@ -12,6 +12,7 @@
 #include <fbl/string.h>
 #include <fbl/unique_fd.h>
 #include <fbl/vector.h>
+#include <fs-host/cache.h>
 #include <zircon/types.h>
 
 // The "manifest" command is only being retained here for backwards compatibility.
@@ -29,6 +30,7 @@ enum class Command {
 
 enum class Option {
     kDepfile,
+    kCache,
     kReadonly,
     kOffset,
     kLength,
@@ -58,7 +60,8 @@ public:
     DISALLOW_COPY_ASSIGN_AND_MOVE(FsCreator);
 
     FsCreator(uint64_t data_blocks) : data_blocks_(data_blocks),command_(Command::kNone),
-                                      offset_(0), length_(0), read_only_(false), depfile_lock_() {}
+                                      offset_(0), length_(0), read_only_(false), use_cache_(false),
+                                      cache_loaded_(false), incremental_(false), depfile_lock_() {}
     virtual ~FsCreator() {}
 
     // Process the command line arguments and run the specified command.
@@ -108,6 +111,10 @@ protected:
     virtual zx_status_t Fsck() { return ZX_ERR_NOT_SUPPORTED; }
     // Adds all files specified in manifests or other command line arguments to the fs.
     virtual zx_status_t Add()  { return ZX_ERR_NOT_SUPPORTED; }
+    // Updates the existing fs at fd_ in place, rewriting only the files whose
+    // content differs from the image cache. Only invoked on "create" when the
+    // cache option is set and the previous image verified against its sidecar.
+    virtual zx_status_t Update() { return ZX_ERR_NOT_SUPPORTED; }
     // Runs ls on the fs at fd_, at the specified path (if any).
     virtual zx_status_t Ls()   { return ZX_ERR_NOT_SUPPORTED; }
 
@@ -115,6 +122,11 @@ protected:
     off_t GetOffset() const { return offset_; }
     off_t GetLength() const { return length_; }
 
+    // True if the cache option was set; the child should record the content
+    // of each file it adds on create, so the sidecar can be written out.
+    bool CacheEnabled() const { return use_cache_; }
+    ImageCache& Cache() { return cache_; }
+
     fbl::unique_fd fd_;
 
     off_t data_blocks_;
@@ -138,6 +150,13 @@ private:
     off_t offset_;
     off_t length_;
     bool read_only_;
+    bool use_cache_;
+    // Whether a sidecar from a previous run was successfully parsed.
+    bool cache_loaded_;
+    // Whether the existing image verified against the sidecar and Update()
+    // should be run in place of Mkfs().
+    bool incremental_;
+    ImageCache cache_;
     std::mutex depfile_lock_;
     fbl::unique_fd depfile_;
 };
@@ -10,15 +10,20 @@ MODULE := $(LOCAL_DIR).hostlib
 
 MODULE_TYPE := hostlib
 
-MODULE_SRCS := $(LOCAL_DIR)/common.cpp
+MODULE_SRCS := \
+    $(LOCAL_DIR)/cache.cpp \
+    $(LOCAL_DIR)/common.cpp \
 
 MODULE_COMPILEFLAGS := \
     -Werror-implicit-function-declaration \
     -Wstrict-prototypes -Wwrite-strings \
+    -Isystem/ulib/digest/include \
     -Isystem/ulib/zircon/include \
     -Isystem/ulib/fbl/include \
 
 MODULE_HOST_LIBS := \
+    third_party/ulib/uboringssl.hostlib \
+    system/ulib/digest.hostlib \
     system/ulib/fbl.hostlib \
 
 include make/module.mk
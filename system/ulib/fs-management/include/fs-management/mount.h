@@ -147,6 +147,29 @@ zx_status_t mount(int device_fd, const char* mount_path, disk_format_t df,
 zx_status_t fmount(int device_fd, int mount_fd, disk_format_t df,
                    const mount_options_t* options, LaunchCallback cb);
 
+// One volume in a mount_many() batch. |device_fd| is consumed, as with
+// mount(). The result for this volume is recorded in |status|.
+typedef struct mount_request {
+    int device_fd;
+    const char* mount_path;
+    disk_format_t df;
+    const mount_options_t* options;
+    zx_status_t status;
+} mount_request_t;
+
+// Mounts a batch of volumes concurrently: every filesystem process is
+// launched before the first readiness wait, so with wait_until_ready the
+// total wall-clock time is bounded by the slowest volume rather than the
+// sum of them all. Mount points are installed in request order.
+//
+// |cb| should be one of the _async launch callbacks; a _sync callback
+// waits for each filesystem process to terminate and so serializes the
+// batch again.
+//
+// Returns ZX_OK only if every mount succeeded; otherwise returns the
+// first error, with per-volume results left in each request's |status|.
+zx_status_t mount_many(mount_request_t* requests, size_t count, LaunchCallback cb);
+
 // Format the provided device with a requested disk format.
 zx_status_t mkfs(const char* device_path, disk_format_t df, LaunchCallback cb,
                  const mkfs_options_t* options);
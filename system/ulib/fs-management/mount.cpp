@@ -15,6 +15,7 @@
 #include <fbl/type_support.h>
 #include <fbl/unique_fd.h>
 #include <fbl/unique_ptr.h>
+#include <fbl/vector.h>
 #include <fs/client.h>
 #include <lib/fdio/limits.h>
 #include <lib/fdio/util.h>
@@ -52,11 +53,21 @@ public:
     zx_status_t Mount(unique_fd device, disk_format_t format, const mount_options_t& options,
                       LaunchCallback cb);
 
+    // Launches the filesystem for the given device but defers the
+    // readiness wait and mount-point installation to FinishMount().
+    // This lets a caller bringing up several volumes launch them all
+    // before waiting on any of them.
+    zx_status_t MountAsync(unique_fd device, disk_format_t format,
+                           const mount_options_t& options, LaunchCallback cb);
+    zx_status_t FinishMount(const mount_options_t& options);
+
     DISALLOW_COPY_AND_ASSIGN_ALLOW_MOVE(Mounter);
 
 private:
     zx_status_t PrepareHandles(unique_fd device);
     zx_status_t MakeDirAndMount(const mount_options_t& options);
+    zx_status_t Launch(LaunchCallback cb, const mount_options_t& options, const char** argv,
+                       int argc);
     zx_status_t LaunchAndMount(LaunchCallback cb, const mount_options_t& options, const char** argv,
                                int argc);
     zx_status_t MountNativeFs(const char* binary, unique_fd device, const mount_options_t& options,
@@ -67,6 +78,7 @@ private:
     const char* path_;
     int fd_;
     uint32_t flags_ = 0; // Currently not used.
+    bool defer_install_ = false;
     size_t num_handles_ = 0;
     zx_handle_t handles_[FDIO_MAX_HANDLES * 2];
     uint32_t ids_[FDIO_MAX_HANDLES * 2];
@@ -140,22 +152,28 @@ zx_status_t Mounter::MakeDirAndMount(const mount_options_t& options) {
     return static_cast<zx_status_t>(ioctl_vfs_mount_mkdir_fs(parent.get(), config, config_size));
 }
 
-// Calls the 'launch callback' and mounts the remote handle to the target vnode, if successful.
-zx_status_t Mounter::LaunchAndMount(LaunchCallback cb, const mount_options_t& options,
-                                    const char** argv, int argc) {
-    auto cleanup =
-        fbl::MakeAutoCall([this, options]() { UnmountHandle(root_, options.wait_until_ready); });
-
+// Calls the 'launch callback'; the filesystem process now owns the device.
+zx_status_t Mounter::Launch(LaunchCallback cb, const mount_options_t& options,
+                            const char** argv, int argc) {
     zx_status_t status = cb(argc, argv, handles_, ids_, num_handles_);
     if (status != ZX_OK) {
-        return status;
+        UnmountHandle(root_, options.wait_until_ready);
+        root_ = ZX_HANDLE_INVALID;
     }
+    return status;
+}
+
+// Waits for the launched filesystem to become ready (if requested) and
+// mounts the remote handle to the target vnode.
+zx_status_t Mounter::FinishMount(const mount_options_t& options) {
+    auto cleanup =
+        fbl::MakeAutoCall([this, options]() { UnmountHandle(root_, options.wait_until_ready); });
 
     if (options.wait_until_ready) {
         // Wait until the filesystem is ready to take incoming requests
         zx_signals_t observed;
-        status = zx_object_wait_one(root_, ZX_USER_SIGNAL_0 | ZX_CHANNEL_PEER_CLOSED,
-                                    ZX_TIME_INFINITE, &observed);
+        zx_status_t status = zx_object_wait_one(root_, ZX_USER_SIGNAL_0 | ZX_CHANNEL_PEER_CLOSED,
+                                                ZX_TIME_INFINITE, &observed);
         if ((status != ZX_OK) || (observed & ZX_CHANNEL_PEER_CLOSED)) {
             status = (status != ZX_OK) ? status : ZX_ERR_BAD_STATE;
             return status;
@@ -171,6 +189,15 @@ zx_status_t Mounter::LaunchAndMount(LaunchCallback cb, const mount_options_t& op
     return static_cast<zx_status_t>(ioctl_vfs_mount_fs(fd_, &root_));
 }
 
+zx_status_t Mounter::LaunchAndMount(LaunchCallback cb, const mount_options_t& options,
+                                    const char** argv, int argc) {
+    zx_status_t status = Launch(cb, options, argv, argc);
+    if (status != ZX_OK || defer_install_) {
+        return status;
+    }
+    return FinishMount(options);
+}
+
 zx_status_t Mounter::MountNativeFs(const char* binary, unique_fd device,
                                    const mount_options_t& options, LaunchCallback cb) {
     zx_status_t status = PrepareHandles(fbl::move(device));
@@ -240,6 +267,26 @@ zx_status_t Mounter::Mount(unique_fd device, disk_format_t format, const mount_o
     }
 }
 
+zx_status_t Mounter::MountAsync(unique_fd device, disk_format_t format,
+                                const mount_options_t& options, LaunchCallback cb) {
+    defer_install_ = true;
+    zx_status_t status = Mount(fbl::move(device), format, options, cb);
+    defer_install_ = false;
+    return status;
+}
+
+// One launched-but-not-yet-installed volume in a mount_many() batch.
+struct PendingMount {
+    explicit PendingMount(int fd) : mounter(fd) {}
+    explicit PendingMount(const char* path) : mounter(path) {}
+
+    Mounter mounter;
+    // Keeps the mount point open until installation for the non
+    // create_mountpoint case.
+    unique_fd mount_point;
+    mount_request_t* request = nullptr;
+};
+
 } // namespace
 
 const mount_options_t default_mount_options = {
@@ -339,6 +386,64 @@ zx_status_t mount(int device_fd, const char* mount_path, disk_format_t df,
     return mounter.Mount(unique_fd(device_fd), df, *options, cb);
 }
 
+zx_status_t mount_many(mount_request_t* requests, size_t count, LaunchCallback cb) {
+    fbl::Vector<fbl::unique_ptr<PendingMount>> pending;
+
+    // Phase 1: launch every filesystem process without waiting for any of
+    // them, so the whole batch comes up concurrently.
+    for (size_t i = 0; i < count; ++i) {
+        mount_request_t* request = &requests[i];
+        const mount_options_t* options = request->options;
+        unique_fd device(request->device_fd);
+
+        fbl::AllocChecker checker;
+        fbl::unique_ptr<PendingMount> mount;
+        unique_fd mount_point;
+        if (options->create_mountpoint) {
+            mount.reset(new (&checker) PendingMount(request->mount_path));
+        } else {
+            mount_point.reset(open(request->mount_path, O_RDONLY | O_DIRECTORY | O_ADMIN));
+            if (!mount_point) {
+                request->status = ZX_ERR_BAD_STATE;
+                continue;
+            }
+            mount.reset(new (&checker) PendingMount(mount_point.get()));
+        }
+        if (!checker.check()) {
+            request->status = ZX_ERR_NO_MEMORY;
+            continue;
+        }
+        mount->mount_point = fbl::move(mount_point);
+        mount->request = request;
+
+        request->status = mount->mounter.MountAsync(fbl::move(device), request->df,
+                                                    *options, cb);
+        if (request->status != ZX_OK) {
+            continue;
+        }
+        pending.push_back(fbl::move(mount), &checker);
+        if (!checker.check()) {
+            // Can't track this one; the filesystem is already launched, so
+            // finish it synchronously rather than abandoning it.
+            request->status = mount->mounter.FinishMount(*options);
+        }
+    }
+
+    // Phase 2: readiness waits and mount-point installation, in request
+    // order. Every filesystem is already coming up, so the total wait is
+    // bounded by the slowest volume rather than the sum of them all.
+    for (auto& mount : pending) {
+        mount->request->status = mount->mounter.FinishMount(*mount->request->options);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (requests[i].status != ZX_OK) {
+            return requests[i].status;
+        }
+    }
+    return ZX_OK;
+}
+
 zx_status_t fumount(int mount_fd) {
     zx_handle_t h;
     zx_status_t status = static_cast<zx_status_t>(ioctl_vfs_unmount_node(mount_fd, &h));
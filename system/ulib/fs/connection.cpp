@@ -261,7 +261,8 @@ void Connection::SyncTeardown() {
 
 zx_status_t Connection::Serve() {
     wait_.set_object(channel_.get());
-    return wait_.Begin(vfs_->dispatcher());
+    dispatcher_ = vfs_->DispatcherForVnode(vnode_.get());
+    return wait_.Begin(dispatcher_);
 }
 
 void Connection::HandleSignals(async_dispatcher_t* dispatcher, async::WaitBase* wait, zx_status_t status,
@@ -392,7 +393,7 @@ zx_status_t Connection::NodeSync(fidl_txn_t* txn) {
         fuchsia_io_NodeSync_reply(&ctxn.txn, status);
 
         // Try to reset the wait object
-        ZX_ASSERT_MSG(wait_.Begin(vfs_->dispatcher()) == ZX_OK,
+        ZX_ASSERT_MSG(wait_.Begin(dispatcher_) == ZX_OK,
                       "Dispatch loop unexpectedly ended");
     });
 
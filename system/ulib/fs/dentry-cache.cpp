@@ -0,0 +1,127 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/alloc_checker.h>
+#include <fs/dentry-cache.h>
+#include <fs/vnode.h>
+
+namespace fs {
+namespace {
+
+// FNV-1a over the parent pointer and the name.
+size_t HashKey(const Vnode* parent, fbl::StringPiece name) {
+    uint64_t hash = 14695981039346656037ull;
+    uintptr_t key = reinterpret_cast<uintptr_t>(parent);
+    for (size_t i = 0; i < sizeof(key); i++) {
+        hash = (hash ^ ((key >> (i * 8)) & 0xFF)) * 1099511628211ull;
+    }
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+} // namespace
+
+DentryCache::DentryCache() = default;
+
+DentryCache::~DentryCache() {
+    Reset();
+}
+
+size_t DentryCache::BucketIndex(const Vnode* parent, fbl::StringPiece name) {
+    return HashKey(parent, name) % kNumBuckets;
+}
+
+DentryCache::Entry* DentryCache::Find(const Vnode* parent, fbl::StringPiece name) {
+    for (auto& entry : buckets_[BucketIndex(parent, name)]) {
+        if (entry.parent.get() == parent && entry.name.ToStringPiece() == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool DentryCache::Lookup(const Vnode* parent, fbl::StringPiece name,
+                         fbl::RefPtr<Vnode>* out, zx_status_t* status) {
+    Entry* entry = Find(parent, name);
+    if (entry == nullptr) {
+        return false;
+    }
+    // Refresh the entry's position in the LRU list.
+    lru_.erase(*entry);
+    lru_.push_front(entry);
+    if (entry->vnode == nullptr) {
+        *status = ZX_ERR_NOT_FOUND;
+    } else {
+        *out = entry->vnode;
+        *status = ZX_OK;
+    }
+    return true;
+}
+
+void DentryCache::Insert(fbl::RefPtr<Vnode> parent, fbl::StringPiece name,
+                         fbl::RefPtr<Vnode> vn) {
+    Entry* entry = Find(parent.get(), name);
+    if (entry != nullptr) {
+        // Refresh the existing entry in place.
+        entry->vnode = fbl::move(vn);
+        lru_.erase(*entry);
+        lru_.push_front(entry);
+        return;
+    }
+    if (num_entries_ == kMaxEntries) {
+        Evict(&lru_.back());
+    }
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<Entry> new_entry(new (&ac) Entry());
+    if (!ac.check()) {
+        // The cache is strictly an optimization; on allocation failure the
+        // lookup is simply not memoized.
+        return;
+    }
+    new_entry->parent = fbl::move(parent);
+    new_entry->name = fbl::String(name, &ac);
+    if (!ac.check()) {
+        return;
+    }
+    new_entry->vnode = fbl::move(vn);
+    lru_.push_front(new_entry.get());
+    buckets_[BucketIndex(new_entry->parent.get(), name)].push_front(fbl::move(new_entry));
+    num_entries_++;
+}
+
+void DentryCache::Purge(const Vnode* parent, fbl::StringPiece name) {
+    Entry* entry = Find(parent, name);
+    if (entry != nullptr) {
+        Evict(entry);
+    }
+}
+
+void DentryCache::Purge(const Vnode* parent) {
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        Entry* entry = &*it;
+        ++it;
+        if (entry->parent.get() == parent) {
+            Evict(entry);
+        }
+    }
+}
+
+void DentryCache::Reset() {
+    lru_.clear();
+    for (auto& bucket : buckets_) {
+        bucket.clear();
+    }
+    num_entries_ = 0;
+}
+
+void DentryCache::Evict(Entry* entry) {
+    lru_.erase(*entry);
+    buckets_[BucketIndex(entry->parent.get(), entry->name)].erase_if(
+        [entry](const Entry& e) { return &e == entry; });
+    num_entries_--;
+}
+
+} // namespace fs
@@ -132,6 +132,10 @@ private:
     // The object field is |ZX_HANDLE_INVALID| when not actively waiting.
     async::WaitMethod<Connection, &Connection::HandleSignals> wait_;
 
+    // Dispatcher on which this connection is served; selected by the VFS
+    // when |Serve| is called, and constant thereafter.
+    async_dispatcher_t* dispatcher_{};
+
     // Open flags such as |ZX_FS_RIGHT_READABLE|, and other bits.
     uint32_t flags_;
 
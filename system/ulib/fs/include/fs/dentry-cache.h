@@ -0,0 +1,88 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <fbl/intrusive_double_list.h>
+#include <fbl/intrusive_single_list.h>
+#include <fbl/macros.h>
+#include <fbl/ref_ptr.h>
+#include <fbl/string.h>
+#include <fbl/string_piece.h>
+#include <fbl/unique_ptr.h>
+#include <zircon/types.h>
+
+namespace fs {
+
+class Vnode;
+
+// DentryCache memoizes the results of directory lookups performed while
+// walking paths, so that repeatedly resolved components become hash table
+// hits rather than vnode Lookup() calls. Both successful lookups and misses
+// ("negative" entries) are cached; entries are evicted in LRU order once
+// the cache is full, and purged when the parent directory is modified.
+//
+// The cache is not internally synchronized; the Vfs guards it with the
+// same lock which serializes lookup and walk operations.
+class DentryCache {
+public:
+    DISALLOW_COPY_ASSIGN_AND_MOVE(DentryCache);
+
+    // Maximum number of cached entries, positive and negative combined.
+    static constexpr size_t kMaxEntries = 256;
+
+    DentryCache();
+    ~DentryCache();
+
+    // Looks for a cached lookup of |name| within |parent|. Returns true on a
+    // hit, storing the lookup's result in |out| and |status|: ZX_OK and the
+    // child vnode for a positive entry, or ZX_ERR_NOT_FOUND for a negative
+    // entry. Returns false on a miss, leaving the outputs untouched.
+    bool Lookup(const Vnode* parent, fbl::StringPiece name,
+                fbl::RefPtr<Vnode>* out, zx_status_t* status);
+
+    // Records the result of looking up |name| within |parent|. A null |vn|
+    // records a negative entry. The oldest entry is evicted if the cache is
+    // full.
+    void Insert(fbl::RefPtr<Vnode> parent, fbl::StringPiece name, fbl::RefPtr<Vnode> vn);
+
+    // Drops the entry for |name| within |parent|, if one is cached.
+    void Purge(const Vnode* parent, fbl::StringPiece name);
+
+    // Drops all entries cached within |parent|.
+    void Purge(const Vnode* parent);
+
+    // Drops all entries.
+    void Reset();
+
+private:
+    struct Entry : public fbl::SinglyLinkedListable<fbl::unique_ptr<Entry>>,
+                   public fbl::DoublyLinkedListable<Entry*> {
+        // Keeps the parent pointer (the hash key) valid while cached.
+        fbl::RefPtr<Vnode> parent;
+        fbl::String name;
+        // The cached lookup result; null for a negative entry.
+        fbl::RefPtr<Vnode> vnode;
+    };
+
+    static constexpr size_t kNumBuckets = 64;
+
+    static size_t BucketIndex(const Vnode* parent, fbl::StringPiece name);
+
+    // Finds the cached entry for (|parent|, |name|), or returns nullptr.
+    Entry* Find(const Vnode* parent, fbl::StringPiece name);
+
+    // Removes |entry| from both the bucket chain and the LRU list.
+    void Evict(Entry* entry);
+
+    // Hash buckets of entries; each entry is owned by its bucket chain.
+    fbl::SinglyLinkedList<fbl::unique_ptr<Entry>> buckets_[kNumBuckets];
+
+    // All entries, most recently used first.
+    fbl::DoublyLinkedList<Entry*> lru_;
+
+    size_t num_entries_ = 0;
+};
+
+} // namespace fs
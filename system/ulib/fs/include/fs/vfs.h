@@ -12,6 +12,7 @@
 #include <lib/fdio/remoteio.h>
 #include <lib/fdio/vfs.h>
 #include <fs/client.h>
+#include <fs/dentry-cache.h>
 #include <fs/locking.h>
 #include <zircon/assert.h>
 #include <zircon/compiler.h>
@@ -129,6 +130,18 @@ public:
     // Sets whether this file system is read-only.
     void SetReadonly(bool value) FS_TA_EXCLUDES(vfs_lock_);
 
+    // Sets whether path walks memoize lookups in a dentry cache (see
+    // |DentryCache|). Only safe to enable for filesystems whose directories
+    // are modified exclusively through this Vfs object; filesystems which
+    // mutate vnodes directly (such as memfs publishing nodes) must leave the
+    // cache disabled, as their changes would not invalidate it.
+    void SetDentryCacheEnabled(bool value) FS_TA_EXCLUDES(vfs_lock_);
+
+    // Drops all dentry cache entries, releasing the vnode references they
+    // hold. Called during filesystem shutdown so cached vnodes do not
+    // outlive teardown.
+    void ResetDentryCache() FS_TA_EXCLUDES(vfs_lock_);
+
 #ifdef __Fuchsia__
     // Unmounts the underlying filesystem.
     //
@@ -158,6 +171,21 @@ public:
     async_dispatcher_t* dispatcher() { return dispatcher_; }
     void SetDispatcher(async_dispatcher_t* dispatcher) { dispatcher_ = dispatcher; }
 
+    // Maximum number of dispatcher shards which may be registered.
+    static constexpr size_t kMaxDispatcherShards = 8;
+
+    // Adds |dispatcher| as a dispatch shard. When shards are present, each
+    // connection is served on the shard chosen by a hash of its vnode, so
+    // operations on distinct vnodes may proceed in parallel while all
+    // connections to a single vnode stay ordered on one dispatch loop.
+    //
+    // Shards must be registered before any connections are served.
+    zx_status_t AddDispatcherShard(async_dispatcher_t* dispatcher);
+
+    // Returns the dispatcher which should serve connections to |vn|: one of
+    // the registered shards, or the default dispatcher if none were added.
+    async_dispatcher_t* DispatcherForVnode(const Vnode* vn);
+
     // Begins serving VFS messages over the specified connection.
     zx_status_t ServeConnection(fbl::unique_ptr<Connection> connection) FS_TA_EXCLUDES(vfs_lock_);
 
@@ -211,6 +239,16 @@ private:
 
     bool readonly_{};
 
+    // Memoizes path component lookups when enabled (see
+    // |SetDentryCacheEnabled|); guarded by the VFS lock, like walks.
+    DentryCache dentry_cache_;
+    bool dentry_cache_enabled_{};
+
+    // Performs a single component lookup of |name| within |vndir|,
+    // consulting and maintaining the dentry cache when it is enabled.
+    zx_status_t LookupNode(fbl::RefPtr<Vnode> vndir, fbl::RefPtr<Vnode>* out,
+                           fbl::StringPiece name) FS_TA_REQUIRES(vfs_lock_);
+
 #ifdef __Fuchsia__
     zx_status_t TokenToVnode(zx::event token, fbl::RefPtr<Vnode>* out) FS_TA_REQUIRES(vfs_lock_);
     zx_status_t InstallRemoteLocked(fbl::RefPtr<Vnode> vn, MountChannel h) FS_TA_REQUIRES(vfs_lock_);
@@ -240,6 +278,11 @@ private:
 
     async_dispatcher_t* dispatcher_{};
 
+    // Dispatcher shards; written during setup, read without locking while
+    // serving (see |AddDispatcherShard|).
+    async_dispatcher_t* shards_[kMaxDispatcherShards] = {};
+    size_t num_shards_{};
+
 protected:
     // A lock which should be used to protect lookup and walk operations
     mtx_t vfs_lock_{};
@@ -12,6 +12,7 @@ MODULE_COMPILEFLAGS += -fvisibility=hidden
 
 COMMON_SRCS := \
     $(LOCAL_DIR)/block-txn.cpp \
+    $(LOCAL_DIR)/dentry-cache.cpp \
     $(LOCAL_DIR)/vfs.cpp \
     $(LOCAL_DIR)/vnode.cpp \
 
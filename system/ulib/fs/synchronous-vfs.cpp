@@ -26,6 +26,7 @@ void SynchronousVfs::Shutdown(ShutdownCallback handler) {
     is_shutting_down_ = true;
 
     UninstallAll(ZX_TIME_INFINITE);
+    ResetDentryCache();
     while (!connections_.is_empty()) {
         connections_.front().SyncTeardown();
     }
@@ -58,17 +58,6 @@ zx_status_t vfs_name_trim(fbl::StringPiece name, fbl::StringPiece* name_out,
     return ZX_OK;
 }
 
-zx_status_t vfs_lookup(fbl::RefPtr<Vnode> vn, fbl::RefPtr<Vnode>* out,
-                       fbl::StringPiece name) {
-    if (name == "..") {
-        return ZX_ERR_INVALID_ARGS;
-    } else if (name == ".") {
-        *out = fbl::move(vn);
-        return ZX_OK;
-    }
-    return vn->Lookup(out, name);
-}
-
 // Validate open flags as much as they can be validated
 // independently of the target node.
 zx_status_t vfs_prevalidate_flags(uint32_t flags) {
@@ -124,6 +113,30 @@ zx_status_t Vfs::Open(fbl::RefPtr<Vnode> vndir, fbl::RefPtr<Vnode>* out,
     return OpenLocked(fbl::move(vndir), out, path, out_path, flags, mode);
 }
 
+zx_status_t Vfs::LookupNode(fbl::RefPtr<Vnode> vndir, fbl::RefPtr<Vnode>* out,
+                            fbl::StringPiece name) {
+    if (name == "..") {
+        return ZX_ERR_INVALID_ARGS;
+    } else if (name == ".") {
+        *out = fbl::move(vndir);
+        return ZX_OK;
+    }
+    if (!dentry_cache_enabled_) {
+        return vndir->Lookup(out, name);
+    }
+    zx_status_t r;
+    if (dentry_cache_.Lookup(vndir.get(), name, out, &r)) {
+        return r;
+    }
+    r = vndir->Lookup(out, name);
+    if (r == ZX_OK) {
+        dentry_cache_.Insert(fbl::move(vndir), name, *out);
+    } else if (r == ZX_ERR_NOT_FOUND) {
+        dentry_cache_.Insert(fbl::move(vndir), name, nullptr);
+    }
+    return r;
+}
+
 zx_status_t Vfs::OpenLocked(fbl::RefPtr<Vnode> vndir, fbl::RefPtr<Vnode>* out,
                             fbl::StringPiece path, fbl::StringPiece* out_path,
                             uint32_t flags, uint32_t mode) {
@@ -172,10 +185,12 @@ zx_status_t Vfs::OpenLocked(fbl::RefPtr<Vnode> vndir, fbl::RefPtr<Vnode>* out,
             }
             return r;
         }
+        // Creation invalidates any cached miss for this name.
+        dentry_cache_.Purge(vndir.get(), path);
         vndir->Notify(path, VFS_WATCH_EVT_ADDED);
     } else {
     try_open:
-        r = vfs_lookup(fbl::move(vndir), &vn, path);
+        r = LookupNode(fbl::move(vndir), &vn, path);
         if (r < 0) {
             return r;
         }
@@ -232,6 +247,9 @@ zx_status_t Vfs::Unlink(fbl::RefPtr<Vnode> vndir, fbl::StringPiece path) {
             r = ZX_ERR_ACCESS_DENIED;
         } else {
             r = vndir->Unlink(path, must_be_dir);
+            if (r == ZX_OK) {
+                dentry_cache_.Purge(vndir.get(), path);
+            }
         }
     }
     if (r != ZX_OK) {
@@ -338,6 +356,10 @@ zx_status_t Vfs::Rename(zx::event token, fbl::RefPtr<Vnode> oldparent,
 
         r = oldparent->Rename(newparent, oldStr, newStr, old_must_be_dir,
                               new_must_be_dir);
+        if (r == ZX_OK) {
+            dentry_cache_.Purge(oldparent.get(), oldStr);
+            dentry_cache_.Purge(newparent.get(), newStr);
+        }
     }
     if (r != ZX_OK) {
         return r;
@@ -393,10 +415,32 @@ zx_status_t Vfs::Link(zx::event token, fbl::RefPtr<Vnode> oldparent,
     if (r != ZX_OK) {
         return r;
     }
+    dentry_cache_.Purge(newparent.get(), newStr);
     newparent->Notify(newStr, VFS_WATCH_EVT_ADDED);
     return ZX_OK;
 }
 
+zx_status_t Vfs::AddDispatcherShard(async_dispatcher_t* dispatcher) {
+    if (dispatcher == nullptr) {
+        return ZX_ERR_INVALID_ARGS;
+    } else if (num_shards_ == kMaxDispatcherShards) {
+        return ZX_ERR_NO_RESOURCES;
+    }
+    shards_[num_shards_++] = dispatcher;
+    return ZX_OK;
+}
+
+async_dispatcher_t* Vfs::DispatcherForVnode(const Vnode* vn) {
+    if (num_shards_ == 0) {
+        return dispatcher_;
+    }
+    // Fibonacci hash of the vnode pointer, discarding the alignment bits.
+    // All connections to one vnode map to the same shard, preserving the
+    // per-vnode ordering a single dispatch loop would provide.
+    uintptr_t key = reinterpret_cast<uintptr_t>(vn) >> 4;
+    return shards_[((key * 0x9E3779B97F4A7C15ull) >> 32) % num_shards_];
+}
+
 zx_status_t Vfs::ServeConnection(fbl::unique_ptr<Connection> connection) {
     ZX_DEBUG_ASSERT(connection);
 
@@ -498,6 +542,23 @@ void Vfs::SetReadonly(bool value) {
     readonly_ = value;
 }
 
+void Vfs::SetDentryCacheEnabled(bool value) {
+#ifdef __Fuchsia__
+    fbl::AutoLock lock(&vfs_lock_);
+#endif
+    dentry_cache_enabled_ = value;
+    if (!value) {
+        dentry_cache_.Reset();
+    }
+}
+
+void Vfs::ResetDentryCache() {
+#ifdef __Fuchsia__
+    fbl::AutoLock lock(&vfs_lock_);
+#endif
+    dentry_cache_.Reset();
+}
+
 zx_status_t Vfs::Walk(fbl::RefPtr<Vnode> vn, fbl::RefPtr<Vnode>* out_vn,
                       fbl::StringPiece path, fbl::StringPiece* out_path) {
     zx_status_t r;
@@ -536,7 +597,7 @@ zx_status_t Vfs::Walk(fbl::RefPtr<Vnode> vn, fbl::RefPtr<Vnode>* out_vn,
 
         // Path has at least one additional segment.
         fbl::StringPiece component(path.data(), next_path - path.data());
-        if ((r = vfs_lookup(fbl::move(vn), &vn, component)) != ZX_OK) {
+        if ((r = LookupNode(fbl::move(vn), &vn, component)) != ZX_OK) {
             return r;
         }
         // Traverse to the next segment.
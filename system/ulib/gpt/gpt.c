@@ -60,6 +60,12 @@ typedef struct gpt_priv {
     // copy of buffer from when last init'd or sync'd.
     gpt_partition_t backup[PARTITIONS_COUNT];
 
+    // image of the partition table as last read from or written to the
+    // device, in on-disk (packed) order. when valid, sync only rewrites
+    // the table blocks that differ from this image.
+    gpt_partition_t disk_table[PARTITIONS_COUNT];
+    bool disk_table_valid;
+
     gpt_device_t device;
 } gpt_priv_t;
 
@@ -265,6 +271,20 @@ int gpt_device_init(int fd, uint64_t blocksize, uint64_t blocks, gpt_device_t**
     // save original state so we can know what we changed
     memcpy(priv->backup, priv->ptable, sizeof(priv->ptable));
 
+    // remember the on-disk table image so sync can skip rewriting
+    // unchanged table blocks. sync always writes all PARTITIONS_COUNT
+    // entries to both gpt copies, so this only applies when the table is
+    // full-size and the backup copy already matches the primary.
+    if ((size_t)ptable_size == sizeof(priv->disk_table)) {
+        uint8_t check[sizeof(priv->disk_table)];
+        if (pread(fd, check, sizeof(check), (header->last + 1) * blocksize) ==
+                (ssize_t)sizeof(check) &&
+            !memcmp(check, ptable, sizeof(check))) {
+            memcpy(priv->disk_table, ptable, sizeof(priv->disk_table));
+            priv->disk_table_valid = true;
+        }
+    }
+
     // fill the table of valid partitions
     for (unsigned i = 0; i < header->entries_count; i++) {
         if (ptable[i].first == 0 && ptable[i].last == 0) continue;
@@ -284,25 +304,35 @@ void gpt_device_release(gpt_device_t* dev) {
 }
 
 static int gpt_sync_current(int fd, uint64_t blocksize, gpt_header_t* header,
-                            gpt_partition_t* ptable) {
-    // write partition table first
-    ssize_t rc = lseek(fd, header->entries * blocksize, SEEK_SET);
-    if (rc < 0) {
-        return -1;
-    }
+                            gpt_partition_t* ptable,
+                            const gpt_partition_t* last_synced) {
+    // write partition table first. if we know what the table looked like
+    // after the last sync, skip the blocks that haven't changed -- a
+    // typical edit touches one or two entries, so this turns a full
+    // table rewrite into a block or two. a NULL last_synced forces a
+    // full write.
     size_t ptable_size = header->entries_count * header->entries_size;
-    rc = write(fd, ptable, ptable_size);
-    if (rc < 0 || (size_t)rc != ptable_size) {
-        return -1;
+    const uint8_t* new_bytes = (const uint8_t*)ptable;
+    const uint8_t* old_bytes = (const uint8_t*)last_synced;
+    for (size_t off = 0; off < ptable_size; off += blocksize) {
+        size_t chunk = MIN(blocksize, ptable_size - off);
+        if (old_bytes && !memcmp(new_bytes + off, old_bytes + off, chunk)) {
+            continue;
+        }
+        ssize_t rc = pwrite(fd, new_bytes + off, chunk,
+                            header->entries * blocksize + off);
+        if (rc < 0 || (size_t)rc != chunk) {
+            return -1;
+        }
     }
     // then write the header
-    rc = lseek(fd, header->current * blocksize, SEEK_SET);
+    ssize_t rc = lseek(fd, header->current * blocksize, SEEK_SET);
     if (rc < 0) {
         return -1;
     }
 
     uint8_t block[blocksize];
-    memset(block, 0, sizeof(blocksize));
+    memset(block, 0, blocksize);
     memcpy(block, header, sizeof(*header));
     rc = write(fd, block, blocksize);
     if (rc != (ssize_t) blocksize) {
@@ -399,17 +429,29 @@ static int gpt_device_finalize_and_sync(gpt_device_t* dev, bool persist) {
     header.crc32 = crc32(0, (const unsigned char*)&header, GPT_HEADER_SIZE);
 
     if (persist) {
+        // both copies hold identical entries, so the image from the last
+        // sync applies to each.
+        const gpt_partition_t* last_synced =
+            priv->disk_table_valid ? priv->disk_table : NULL;
+
+        // a failed sync leaves the device in an unknown state; force a
+        // full write next time unless both copies land.
+        priv->disk_table_valid = false;
+
         // write backup to disk
-        rc = gpt_sync_current(priv->fd, priv->blocksize, &header, buf);
+        rc = gpt_sync_current(priv->fd, priv->blocksize, &header, buf, last_synced);
         if (rc < 0) {
             goto fail;
         }
 
         // write primary copy to disk
-        rc = gpt_sync_current(priv->fd, priv->blocksize, &priv->header, buf);
+        rc = gpt_sync_current(priv->fd, priv->blocksize, &priv->header, buf, last_synced);
         if (rc < 0) {
             goto fail;
         }
+
+        memcpy(priv->disk_table, buf, ptable_size);
+        priv->disk_table_valid = true;
     }
 
     // align backup with new on-disk state
@@ -0,0 +1,86 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <hid-parser/parser.h>
+
+namespace hid {
+
+// ParseReportDescriptor() produces a linked model that is convenient for
+// inspecting a device, but walking it for every report is too slow for
+// devices that deliver reports at a high rate, such as touch digitizers.
+//
+// CompileReportDescriptor() flattens the fields of a given node type into
+// one table of slots per report id, with the bit position of every data
+// field precomputed, so decoding a report is a plain table walk with no
+// descriptor interpretation. Constant (padding) fields only contribute to
+// the bit positions; they get no slot.
+//
+// Typical use:
+//
+//   hid::ReportProgram* prog;
+//   if (hid::CompileReportDescriptor(dev_desc, hid::kInput, &prog) !=
+//       hid::kParseOk) { ... }
+//
+//   // for each report received from the device:
+//   auto table = hid::MatchReportTable(prog, report, len);
+//   for (size_t ix = 0; ix != table->count; ++ix) {
+//       int32_t value;
+//       if (hid::ExtractFieldValue(prog, report, len,
+//                                  table->first_slot[ix], &value)) { ... }
+//   }
+//
+// When no longer needed the program can be freed via FreeReportProgram().
+
+// A single data field of a report, with its position precomputed.
+struct FieldSlot {
+    uint32_t bit_offset;    // from the start of the payload; id byte excluded
+    uint8_t bit_sz;
+    bool is_signed;         // logical minimum is negative; value sign-extends
+    uint32_t flags;         // FieldTypeFlags of the source field
+    Usage usage;
+    MinMax logc_mm;
+    MinMax phys_mm;
+};
+
+// All the data fields of one report id, in report order.
+struct ReportTable {
+    uint8_t report_id;
+    uint32_t byte_sz;       // payload size in bytes; id byte excluded
+    size_t count;
+    FieldSlot* first_slot;
+};
+
+struct ReportProgram {
+    bool has_report_id;     // reports carry a leading report id byte
+    size_t rep_count;
+    ReportTable report[];
+};
+
+ParseResult CompileReportDescriptor(const DeviceDescriptor* dev_desc,
+                                    NodeType type, ReportProgram** program);
+
+void FreeReportProgram(ReportProgram* program);
+
+// Returns the table matching |report|'s id byte, or the single table when
+// report ids are not used, or nullptr if the report cannot be matched.
+const ReportTable* MatchReportTable(const ReportProgram* program,
+                                    const uint8_t* report, size_t len);
+
+// Extracts |slot|'s value from |report| as delivered by the device (id
+// byte included when used). Returns false if the report is too short.
+bool ExtractFieldValue(const ReportProgram* program,
+                       const uint8_t* report, size_t len,
+                       const FieldSlot& slot, int32_t* value);
+
+// Maps a value extracted by ExtractFieldValue() from the logical to the
+// physical range of |slot|. Returns the value unchanged when the
+// descriptor did not declare a physical range.
+int32_t ScaleFieldValue(const FieldSlot& slot, int32_t value);
+
+}  // namespace hid
@@ -0,0 +1,151 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <hid-parser/report.h>
+
+#include <fbl/alloc_checker.h>
+
+namespace {
+
+char* Alloc(size_t size) {
+    fbl::AllocChecker ac;
+    auto mem = new (&ac) char[size];
+    return ac.check() ? mem : nullptr;
+}
+
+}  // namespace
+
+namespace hid {
+
+ParseResult CompileReportDescriptor(const DeviceDescriptor* dev_desc,
+                                    NodeType type, ReportProgram** program) {
+    // First pass: count the data fields so the whole program can be packed
+    // into a single allocation, same as ParseReportDescriptor() does.
+    size_t total_slots = 0u;
+    for (size_t ix = 0; ix != dev_desc->rep_count; ++ix) {
+        const ReportDescriptor& rep = dev_desc->report[ix];
+        for (size_t fx = 0; fx != rep.count; ++fx) {
+            const ReportField& field = rep.first_field[fx];
+            if ((field.type == type) && (field.flags & kData))
+                ++total_slots;
+        }
+    }
+
+    size_t program_sz =
+        sizeof(ReportProgram) + dev_desc->rep_count * sizeof(ReportTable);
+
+    auto mem = Alloc(program_sz + total_slots * sizeof(FieldSlot));
+    if (mem == nullptr)
+        return kParseNoMemory;
+
+    // Scenario #1 from parser.h: a single report with id zero means the
+    // report stream does not carry an id byte.
+    bool has_report_id =
+        (dev_desc->rep_count > 1) || (dev_desc->report[0].report_id != 0);
+
+    auto prog = reinterpret_cast<ReportProgram*>(mem);
+    prog->has_report_id = has_report_id;
+    prog->rep_count = dev_desc->rep_count;
+
+    auto slots = reinterpret_cast<FieldSlot*>(mem + program_sz);
+
+    for (size_t ix = 0; ix != dev_desc->rep_count; ++ix) {
+        const ReportDescriptor& rep = dev_desc->report[ix];
+        ReportTable& table = prog->report[ix];
+        table.report_id = rep.report_id;
+        table.first_slot = slots;
+        table.count = 0u;
+
+        // The bit cursor advances over every field of the requested type,
+        // padding included; only data fields produce a slot.
+        uint32_t bit_cursor = 0u;
+        for (size_t fx = 0; fx != rep.count; ++fx) {
+            const ReportField& field = rep.first_field[fx];
+            if (field.type != type)
+                continue;
+            if (field.flags & kData) {
+                FieldSlot& slot = slots[table.count++];
+                slot.bit_offset = bit_cursor;
+                slot.bit_sz = field.attr.bit_sz;
+                slot.is_signed = (field.attr.logc_mm.min < 0);
+                slot.flags = field.flags;
+                slot.usage = field.attr.usage;
+                slot.logc_mm = field.attr.logc_mm;
+                slot.phys_mm = field.attr.phys_mm;
+            }
+            bit_cursor += field.attr.bit_sz;
+        }
+        table.byte_sz = (bit_cursor + 7u) / 8u;
+        slots += table.count;
+    }
+
+    *program = prog;
+    return kParseOk;
+}
+
+void FreeReportProgram(ReportProgram* program) {
+    delete[] reinterpret_cast<char*>(program);
+}
+
+const ReportTable* MatchReportTable(const ReportProgram* program,
+                                    const uint8_t* report, size_t len) {
+    if ((program == nullptr) || (len == 0u))
+        return nullptr;
+
+    if (!program->has_report_id)
+        return &program->report[0];
+
+    for (size_t ix = 0; ix != program->rep_count; ++ix) {
+        if (program->report[ix].report_id == report[0])
+            return &program->report[ix];
+    }
+    return nullptr;
+}
+
+bool ExtractFieldValue(const ReportProgram* program,
+                       const uint8_t* report, size_t len,
+                       const FieldSlot& slot, int32_t* value) {
+    if (program->has_report_id) {
+        if (len == 0u)
+            return false;
+        ++report;
+        --len;
+    }
+
+    uint32_t last_byte = (slot.bit_offset + slot.bit_sz + 7u) / 8u;
+    if ((slot.bit_sz == 0u) || (slot.bit_sz > 32u) || (last_byte > len))
+        return false;
+
+    // Little-endian accumulation of every byte the field touches; a 32-bit
+    // field at an odd bit offset spans at most 5 bytes.
+    uint64_t bits = 0u;
+    uint32_t first_byte = slot.bit_offset / 8u;
+    for (uint32_t ix = last_byte; ix != first_byte;)
+        bits = (bits << 8) | report[--ix];
+
+    bits >>= (slot.bit_offset & 7u);
+    uint64_t mask = (1ull << slot.bit_sz) - 1u;
+    bits &= mask;
+
+    if (slot.is_signed && (bits & (1ull << (slot.bit_sz - 1u))))
+        bits |= ~mask;
+
+    *value = static_cast<int32_t>(bits);
+    return true;
+}
+
+int32_t ScaleFieldValue(const FieldSlot& slot, int32_t value) {
+    int64_t logc_range =
+        static_cast<int64_t>(slot.logc_mm.max) - slot.logc_mm.min;
+    int64_t phys_range =
+        static_cast<int64_t>(slot.phys_mm.max) - slot.phys_mm.min;
+    if ((logc_range <= 0) || (phys_range == 0))
+        return value;
+
+    int64_t scaled = slot.phys_mm.min +
+        (static_cast<int64_t>(value) - slot.logc_mm.min) * phys_range / logc_range;
+    return static_cast<int32_t>(scaled);
+}
+
+}  // namespace hid
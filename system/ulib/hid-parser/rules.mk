@@ -13,6 +13,7 @@ MODULE_PACKAGE := static
 MODULE_SRCS += \
     $(LOCAL_DIR)/item.cpp \
     $(LOCAL_DIR)/parser.cpp \
+    $(LOCAL_DIR)/report.cpp \
 
 MODULE_STATIC_LIBS := \
     system/ulib/fbl \
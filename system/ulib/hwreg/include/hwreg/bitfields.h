@@ -119,6 +119,37 @@ public:
         return *static_cast<SelfType*>(this);
     }
 
+    // Reads just the field [BitHigh:BitLow] from the device, using the
+    // narrowest naturally aligned MMIO access that covers the field. The
+    // access width is selected at compile time. Use via DEF_NARROW_FIELD /
+    // DEF_NARROW_BIT, and only on registers whose partial-width access is
+    // documented to be free of side effects.
+    template <uint32_t BitHigh, uint32_t BitLow>
+    ValueType ReadFieldNarrowFrom(RegisterIo* reg_io) {
+        using Access = internal::NarrowAccess<ValueType, BitHigh, BitLow>;
+        auto lane = reg_io->Read<typename Access::IntType>(reg_addr_ + Access::kByteOffset);
+        return static_cast<ValueType>((lane >> Access::kShift) & Access::kMask);
+    }
+
+    // Read-modify-writes just the field [BitHigh:BitLow] on the device,
+    // using the narrowest naturally aligned MMIO access that covers the
+    // field and leaving the rest of the register untouched. RsvdZ bits
+    // sharing the accessed lane are written as zero, matching WriteTo.
+    // Same caveats as ReadFieldNarrowFrom.
+    template <uint32_t BitHigh, uint32_t BitLow>
+    SelfType& WriteFieldNarrowTo(RegisterIo* reg_io, ValueType val) {
+        using Access = internal::NarrowAccess<ValueType, BitHigh, BitLow>;
+        using LaneType = typename Access::IntType;
+        ZX_DEBUG_ASSERT((val & ~static_cast<ValueType>(Access::kMask)) == 0);
+        const LaneType rsvdz = static_cast<LaneType>(rsvdz_mask_ >> (Access::kByteOffset * CHAR_BIT));
+        LaneType lane = reg_io->Read<LaneType>(reg_addr_ + Access::kByteOffset);
+        lane = static_cast<LaneType>(lane & ~static_cast<LaneType>(Access::kMask << Access::kShift));
+        lane = static_cast<LaneType>(lane | static_cast<LaneType>(val << Access::kShift));
+        lane = static_cast<LaneType>(lane & ~rsvdz);
+        reg_io->Write<LaneType>(reg_addr_ + Access::kByteOffset, lane);
+        return *static_cast<SelfType*>(this);
+    }
+
     // Invokes print_fn(const char* buf) once for each field, including each
     // RsvdZ field, and one extra time if there are any undefined bits set.
     // The callback argument must not be accessed after the callback
@@ -238,6 +269,29 @@ private:
 // produces functions "T NAME() const" and "void set_NAME(T)".
 #define DEF_BIT(BIT, NAME) DEF_FIELD(BIT, BIT, NAME)
 
+// Declares a field that may additionally be accessed on the device with the
+// narrowest naturally aligned MMIO access that covers it (e.g. a byte or
+// word access instead of the full register width), selected at compile
+// time.  On top of the DEF_FIELD accessors this produces
+// "T read_NAME(RegisterIo*)" and "D& update_NAME(RegisterIo*, T)";
+// update_NAME read-modify-writes only the covering lane on the device (hot
+// paths like interrupt moderation updates avoid full-width I/O this way)
+// and keeps the staged value in sync.  Declare fields this way only on
+// registers whose partial-width access is documented to be free of side
+// effects.
+#define DEF_NARROW_FIELD(BIT_HIGH, BIT_LOW, NAME)                                                 \
+    DEF_FIELD(BIT_HIGH, BIT_LOW, NAME)                                                            \
+    ValueType read_ ## NAME(hwreg::RegisterIo* reg_io) {                                          \
+        return ReadFieldNarrowFrom<(BIT_HIGH), (BIT_LOW)>(reg_io);                                \
+    }                                                                                             \
+    SelfType& update_ ## NAME(hwreg::RegisterIo* reg_io, ValueType val) {                         \
+        set_ ## NAME(val);                                                                        \
+        return WriteFieldNarrowTo<(BIT_HIGH), (BIT_LOW)>(reg_io, val);                            \
+    }
+
+// Single-bit version of DEF_NARROW_FIELD.
+#define DEF_NARROW_BIT(BIT, NAME) DEF_NARROW_FIELD(BIT, BIT, NAME)
+
 // Declares multi-bit reserved-zero fields in a derived class of RegisterBase<D, T>.
 // This will ensure that on RegisterBase<T>::WriteTo(), reserved-zero bits are
 // automatically zeroed.  Both bit indices are inclusive.
@@ -30,6 +30,37 @@ template <class IntType> constexpr IntType ComputeMask(uint32_t num_bits) {
     return static_cast<IntType>((static_cast<IntType>(1) << num_bits) - 1);
 }
 
+// Number of bytes of the smallest naturally aligned power-of-two access
+// that covers bits [bit_high_incl:bit_low] of a full_bytes-wide register.
+constexpr uint32_t NarrowAccessBytes(uint32_t bit_high_incl, uint32_t bit_low,
+                                     uint32_t full_bytes) {
+    uint32_t bytes = 1;
+    while (bytes < full_bytes &&
+           (bit_low / (bytes * CHAR_BIT)) != (bit_high_incl / (bytes * CHAR_BIT))) {
+        bytes *= 2;
+    }
+    return bytes;
+}
+
+template <uint32_t Bytes> struct NarrowAccessInt;
+template <> struct NarrowAccessInt<1> { using type = uint8_t; };
+template <> struct NarrowAccessInt<2> { using type = uint16_t; };
+template <> struct NarrowAccessInt<4> { using type = uint32_t; };
+template <> struct NarrowAccessInt<8> { using type = uint64_t; };
+
+// Compile-time description of the narrowest naturally aligned access lane
+// covering bits [BitHigh:BitLow] of a RegIntType-wide register. Lane
+// addressing assumes a little-endian register file, which holds for all
+// supported targets.
+template <typename RegIntType, uint32_t BitHigh, uint32_t BitLow>
+struct NarrowAccess {
+    static constexpr uint32_t kBytes = NarrowAccessBytes(BitHigh, BitLow, sizeof(RegIntType));
+    using IntType = typename NarrowAccessInt<kBytes>::type;
+    static constexpr uint32_t kByteOffset = (BitLow / (kBytes * CHAR_BIT)) * kBytes;
+    static constexpr uint32_t kShift = BitLow - kByteOffset * CHAR_BIT;
+    static constexpr IntType kMask = ComputeMask<IntType>(BitHigh - BitLow + 1);
+};
+
 class FieldPrinter {
 public:
     constexpr FieldPrinter() : name_(nullptr), bit_high_incl_(0), bit_low_(0) {
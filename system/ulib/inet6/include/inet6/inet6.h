@@ -158,6 +158,14 @@ void udp6_recv(void* data, size_t len,
 
 unsigned ip6_checksum(ip6_hdr_t* ip, unsigned type, size_t length);
 
+// Incremental interface to the internet checksum: accumulate the ones'
+// complement sum over one or more buffers (e.g. a precomputed pseudo-header
+// partial, then the payload), then invert it with ip6_checksum_finish().
+// ip6_checksum() is equivalent to running these over the pseudo-header
+// fields and payload in order.
+uint16_t ip6_checksum_partial(const void* data, size_t len, uint16_t sum);
+uint16_t ip6_checksum_finish(uint16_t sum);
+
 // NOTES
 //
 // This is an extremely minimal IPv6 stack, supporting just enough
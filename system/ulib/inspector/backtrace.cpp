@@ -279,13 +279,23 @@ static int dso_lookup_for_unw(void* context, unw_word_t pc,
     return 1;
 }
 
-static
-void inspector_print_backtrace_impl(FILE* f,
-                                    zx_handle_t process, zx_handle_t thread,
-                                    inspector_dsoinfo_t* dso_list,
-                                    uintptr_t pc, uintptr_t sp, uintptr_t fp,
-                                    bool use_libunwind,
-                                    bool use_new_format) {
+// An unwound frame. Unwinding is the expensive part of a backtrace (every
+// step reads remote memory from the suspended process), so we unwind once
+// into a table of these and print from the table, however many output
+// formats were asked for.
+struct Frame {
+    uintptr_t pc;
+    uintptr_t sp;
+};
+
+// Maximum number of frames we collect, matching the old per-frame limit.
+constexpr size_t kMaxFrames = 50;
+
+static size_t collect_frames(zx_handle_t process, zx_handle_t thread,
+                             inspector_dsoinfo_t* dso_list,
+                             uintptr_t pc, uintptr_t sp, uintptr_t fp,
+                             bool use_libunwind,
+                             Frame* frames) {
     // Set up libunwind if requested.
 
     bool libunwind_ok = use_libunwind;
@@ -335,17 +345,11 @@ void inspector_print_backtrace_impl(FILE* f,
     // TODO: Handle libunwind not finding .eh_frame in which case fallback
     // on using heuristics. Ideally this would be handled on a per-DSO basis.
 
-    // Keep a cache of loaded debug info to maintain some performance
-    // without loading debug info for all shared libs.
-    // This won't get used if initializing libunwind failed, but we can still
-    // use |dso_list|.
-    DebugInfoCache di_cache(dso_list, kDebugInfoCacheNumWays);
-
-    // On with the show.
-
-    int n = 1;
-    btprint(f, &di_cache, n++, pc, sp, use_new_format);
-    while ((sp >= 0x1000000) && (n < 50)) {
+    size_t n = 0;
+    frames[n].pc = pc;
+    frames[n].sp = sp;
+    ++n;
+    while ((sp >= 0x1000000) && (n + 1 < kMaxFrames)) {
         if (libunwind_ok) {
             int ret = unw_step(&cursor);
             if (ret < 0) {
@@ -369,14 +373,50 @@ void inspector_print_backtrace_impl(FILE* f,
                 break;
             }
         }
-        btprint(f, &di_cache, n++, pc, sp, use_new_format);
-    }
-    if (!use_new_format) {
-        fprintf(f, "bt#%02d: end\n", n);
+        frames[n].pc = pc;
+        frames[n].sp = sp;
+        ++n;
     }
 
     unw_destroy_addr_space(remote_as);
     unw_destroy_fuchsia(fuchsia);
+    return n;
+}
+
+static void print_frames(FILE* f, DebugInfoCache* di_cache,
+                         const Frame* frames, size_t nframes,
+                         bool use_new_format) {
+    for (size_t i = 0; i < nframes; ++i) {
+        btprint(f, di_cache, static_cast<int>(i + 1),
+                frames[i].pc, frames[i].sp, use_new_format);
+    }
+    if (!use_new_format) {
+        fprintf(f, "bt#%02zu: end\n", nframes + 1);
+    }
+}
+
+static
+void inspector_print_backtrace_impl(FILE* f,
+                                    zx_handle_t process, zx_handle_t thread,
+                                    inspector_dsoinfo_t* dso_list,
+                                    uintptr_t pc, uintptr_t sp, uintptr_t fp,
+                                    bool use_libunwind,
+                                    bool print_old_format,
+                                    bool print_markup) {
+    Frame frames[kMaxFrames];
+    size_t nframes = collect_frames(process, thread, dso_list, pc, sp, fp,
+                                    use_libunwind, frames);
+
+    // Keep a cache of loaded debug info to maintain some performance
+    // without loading debug info for all shared libs.
+    // This won't get used if initializing libunwind failed, but we can still
+    // use |dso_list|.
+    DebugInfoCache di_cache(dso_list, kDebugInfoCacheNumWays);
+
+    if (print_old_format)
+        print_frames(f, &di_cache, frames, nframes, false);
+    if (print_markup)
+        print_frames(f, &di_cache, frames, nframes, true);
 }
 
 extern "C"
@@ -386,7 +426,7 @@ void inspector_print_backtrace_markup(FILE* f,
                                       uintptr_t pc, uintptr_t sp, uintptr_t fp,
                                       bool use_libunwind) {
     inspector_print_backtrace_impl(f, process, thread, dso_list, pc, sp, fp,
-                                  use_libunwind, true);
+                                  use_libunwind, false, true);
 }
 
 extern "C"
@@ -396,7 +436,17 @@ void inspector_print_backtrace(FILE* f,
                                uintptr_t pc, uintptr_t sp, uintptr_t fp,
                                bool use_libunwind) {
     inspector_print_backtrace_impl(f, process, thread, dso_list, pc, sp, fp,
-                                  use_libunwind, false);
+                                  use_libunwind, true, false);
+}
+
+extern "C"
+void inspector_print_backtrace_all_formats(FILE* f,
+                                           zx_handle_t process, zx_handle_t thread,
+                                           inspector_dsoinfo_t* dso_list,
+                                           uintptr_t pc, uintptr_t sp, uintptr_t fp,
+                                           bool use_libunwind) {
+    inspector_print_backtrace_impl(f, process, thread, dso_list, pc, sp, fp,
+                                  use_libunwind, true, true);
 }
 
 }  // namespace inspector
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <unistd.h>
 
 #include <zircon/assert.h>
@@ -98,15 +99,16 @@ inspector_dsoinfo_t* inspector_dso_fetch_list(zx_handle_t h) {
         zx_vaddr_t base;
         uintptr_t next;
         uintptr_t str;
-        if (read_mem(h, lmap + lmap_off_addr, &base, sizeof(base))) {
-            break;
-        }
-        if (read_mem(h, lmap + lmap_off_next, &next, sizeof(next))) {
-            break;
-        }
-        if (read_mem(h, lmap + lmap_off_name, &str, sizeof(str))) {
+        // One read covers every link_map field we need instead of a
+        // syscall per field.
+        char lmap_buf[MAX(MAX(lmap_off_addr, lmap_off_name), lmap_off_next) +
+                      sizeof(uintptr_t)];
+        if (read_mem(h, lmap, lmap_buf, sizeof(lmap_buf))) {
             break;
         }
+        memcpy(&base, lmap_buf + lmap_off_addr, sizeof(base));
+        memcpy(&next, lmap_buf + lmap_off_next, sizeof(next));
+        memcpy(&str, lmap_buf + lmap_off_name, sizeof(str));
         if (fetch_string(h, str, dsoname, sizeof(dsoname))) {
             break;
         }
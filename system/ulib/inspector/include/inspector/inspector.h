@@ -43,6 +43,18 @@ extern void inspector_print_backtrace_markup(FILE* f,
                                              uintptr_t pc, uintptr_t sp,
                                              uintptr_t fp, bool use_libunwind);
 
+// Print a backtrace of |thread| to |f| in both the old format and
+// symbolizer markup, old format first.  This unwinds the thread only
+// once, so prefer it over calling inspector_print_backtrace() and
+// inspector_print_backtrace_markup() back to back: every unwind step
+// reads memory from the stopped process.
+extern void inspector_print_backtrace_all_formats(FILE* f,
+                                                  zx_handle_t process,
+                                                  zx_handle_t thread,
+                                                  inspector_dsoinfo_t* dso_list,
+                                                  uintptr_t pc, uintptr_t sp,
+                                                  uintptr_t fp, bool use_libunwind);
+
 // Print a backtrace of |thread| to |f|.
 // |thread| must currently be stopped: either suspended or in an exception.
 // The format of the output is verify specific: It is read by
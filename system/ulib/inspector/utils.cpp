@@ -76,14 +76,22 @@ zx_status_t read_mem(zx_handle_t h, zx_vaddr_t vaddr, void* ptr, size_t len) {
 
 zx_status_t fetch_string(zx_handle_t h, zx_vaddr_t vaddr, char* ptr, size_t max) {
     while (max > 1) {
+        // Fetch a page-bounded chunk at a time rather than a syscall per
+        // byte.  Chunks never cross a page boundary, so a string sitting
+        // near the end of a mapping can't turn into a failed read.
+        size_t chunk = PAGE_SIZE - (vaddr & (PAGE_SIZE - 1));
+        if (chunk > max - 1)
+            chunk = max - 1;
         zx_status_t status;
-        if ((status = read_mem(h, vaddr, ptr, 1)) < 0) {
+        if ((status = read_mem(h, vaddr, ptr, chunk)) < 0) {
             *ptr = 0;
             return status;
         }
-        ptr++;
-        vaddr++;
-        max--;
+        if (memchr(ptr, 0, chunk) != nullptr)
+            return ZX_OK;
+        ptr += chunk;
+        vaddr += chunk;
+        max -= chunk;
     }
     *ptr = 0;
     return ZX_OK;
@@ -103,6 +111,7 @@ typedef Elf32_Off elf_off_t;
 // ELF used "word" for 32 bits, sigh.
 typedef Elf32_Word elf_word_t;
 typedef Elf32_Word elf_native_word_t;
+typedef Elf32_Ehdr elf_ehdr_t;
 typedef Elf32_Phdr elf_phdr_t;
 
 #else
@@ -118,85 +127,94 @@ typedef Elf64_Half elf_half_t;
 typedef Elf64_Off elf_off_t;
 typedef Elf64_Word elf_word_t;
 typedef Elf64_Xword elf_native_word_t;
+typedef Elf64_Ehdr elf_ehdr_t;
 typedef Elf64_Phdr elf_phdr_t;
 
 #endif
 
+// Walk one PT_NOTE segment looking for the GNU build id.
+// Returns ZX_ERR_NOT_FOUND if the segment doesn't contain one.
+static zx_status_t fetch_build_id_from_notes(zx_handle_t h, zx_vaddr_t vaddr,
+                                             elf_off_t off,
+                                             elf_native_word_t size,
+                                             char* buf, size_t buf_size) {
+    struct {
+        Elf32_Nhdr hdr;
+        char name[sizeof("GNU")];
+    } hdr;
+    while (size > sizeof(hdr)) {
+        zx_status_t status = read_mem(h, vaddr + off, &hdr, sizeof(hdr));
+        if (status != ZX_OK)
+            return status;
+        size_t header_size =
+            sizeof(Elf32_Nhdr) + ((hdr.hdr.n_namesz + 3) & -4);
+        size_t payload_size = (hdr.hdr.n_descsz + 3) & -4;
+        off += header_size;
+        size -= header_size;
+        zx_vaddr_t payload_vaddr = vaddr + off;
+        off += payload_size;
+        size -= payload_size;
+        if (hdr.hdr.n_type != NT_GNU_BUILD_ID ||
+            hdr.hdr.n_namesz != sizeof("GNU") ||
+            memcmp(hdr.name, "GNU", sizeof("GNU")) != 0) {
+            continue;
+        }
+        if (hdr.hdr.n_descsz > MAX_BUILDID_SIZE) {
+            snprintf(buf, buf_size,
+                     "build_id_too_large_%u", hdr.hdr.n_descsz);
+        } else {
+            uint8_t buildid[MAX_BUILDID_SIZE];
+            status = read_mem(h, payload_vaddr, buildid, hdr.hdr.n_descsz);
+            if (status != ZX_OK)
+                return status;
+            for (uint32_t i = 0; i < hdr.hdr.n_descsz; ++i) {
+                snprintf(&buf[i * 2], 3, "%02x", buildid[i]);
+            }
+        }
+        return ZX_OK;
+    }
+
+    return ZX_ERR_NOT_FOUND;
+}
+
 zx_status_t fetch_build_id(zx_handle_t h, zx_vaddr_t base, char* buf, size_t buf_size) {
     zx_vaddr_t vaddr = base;
-    uint8_t tmp[4];
     zx_status_t status;
 
     if (buf_size < MAX_BUILDID_SIZE * 2 + 1)
         return ZX_ERR_INVALID_ARGS;
 
-    status = read_mem(h, vaddr, tmp, 4);
+    // Fetch the whole ELF header in one read instead of a read per field.
+    elf_ehdr_t ehdr;
+    status = read_mem(h, vaddr, &ehdr, sizeof(ehdr));
     if (status != ZX_OK)
         return status;
-    if (memcmp(tmp, ELFMAG, SELFMAG))
+    if (memcmp(ehdr.e_ident, ELFMAG, SELFMAG))
         return ZX_ERR_WRONG_TYPE;
 
-    elf_off_t phoff;
-    elf_half_t num;
-    status = read_mem(h, vaddr + ehdr_off_phoff, &phoff, sizeof(phoff));
-    if (status != ZX_OK)
-        return status;
-    status = read_mem(h, vaddr + ehdr_off_phnum, &num, sizeof(num));
-    if (status != ZX_OK)
-        return status;
-
-    for (unsigned n = 0; n < num; n++) {
-        zx_vaddr_t phaddr = vaddr + phoff + (n * sizeof(elf_phdr_t));
-        elf_word_t type;
-        status = read_mem(h, phaddr + phdr_off_type, &type, sizeof(type));
-        if (status != ZX_OK)
-            return status;
-        if (type != PT_NOTE)
-            continue;
-
-        elf_off_t off;
-        elf_native_word_t size;
-        status = read_mem(h, phaddr + phdr_off_offset, &off, sizeof(off));
-        if (status != ZX_OK)
-            return status;
-        status = read_mem(h, phaddr + phdr_off_filesz, &size, sizeof(size));
+    elf_off_t phoff = ehdr.e_phoff;
+    elf_half_t num = ehdr.e_phnum;
+
+    // Likewise fetch the program headers a batch at a time rather than a
+    // field at a time; typical binaries have around a dozen, so this is
+    // usually one read.
+    elf_phdr_t phdrs[16];
+    for (unsigned n = 0; n < num; n += countof(phdrs)) {
+        unsigned batch = num - n;
+        if (batch > countof(phdrs))
+            batch = countof(phdrs);
+        status = read_mem(h, vaddr + phoff + (n * sizeof(elf_phdr_t)),
+                          phdrs, batch * sizeof(elf_phdr_t));
         if (status != ZX_OK)
             return status;
-
-        struct {
-            Elf32_Nhdr hdr;
-            char name[sizeof("GNU")];
-        } hdr;
-        while (size > sizeof(hdr)) {
-            status = read_mem(h, vaddr + off, &hdr, sizeof(hdr));
-            if (status != ZX_OK)
-                return status;
-            size_t header_size =
-                sizeof(Elf32_Nhdr) + ((hdr.hdr.n_namesz + 3) & -4);
-            size_t payload_size = (hdr.hdr.n_descsz + 3) & -4;
-            off += header_size;
-            size -= header_size;
-            zx_vaddr_t payload_vaddr = vaddr + off;
-            off += payload_size;
-            size -= payload_size;
-            if (hdr.hdr.n_type != NT_GNU_BUILD_ID ||
-                hdr.hdr.n_namesz != sizeof("GNU") ||
-                memcmp(hdr.name, "GNU", sizeof("GNU")) != 0) {
+        for (unsigned i = 0; i < batch; i++) {
+            if (phdrs[i].p_type != PT_NOTE)
                 continue;
-            }
-            if (hdr.hdr.n_descsz > MAX_BUILDID_SIZE) {
-                snprintf(buf, buf_size,
-                         "build_id_too_large_%u", hdr.hdr.n_descsz);
-            } else {
-                uint8_t buildid[MAX_BUILDID_SIZE];
-                status = read_mem(h, payload_vaddr, buildid, hdr.hdr.n_descsz);
-                if (status != ZX_OK)
-                    return status;
-                for (uint32_t i = 0; i < hdr.hdr.n_descsz; ++i) {
-                    snprintf(&buf[i * 2], 3, "%02x", buildid[i]);
-                }
-            }
-            return ZX_OK;
+            status = fetch_build_id_from_notes(h, vaddr, phdrs[i].p_offset,
+                                               phdrs[i].p_filesz,
+                                               buf, buf_size);
+            if (status != ZX_ERR_NOT_FOUND)
+                return status;
         }
     }
 
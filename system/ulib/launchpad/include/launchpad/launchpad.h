@@ -186,6 +186,42 @@ zx_status_t launchpad_load_from_fd(launchpad_t* lp, int fd);
 zx_status_t launchpad_load_from_vmo(launchpad_t* lp, zx_handle_t vmo);
 
 
+// TEMPLATE-BASED FAST SPAWN
+// A template captures the process-independent part of loading a binary
+// (the executable VMO, the interpreter VMO resolved via the loader
+// service, and the parsed ELF headers) so that many processes can be
+// stamped out from it without re-reading or re-parsing the file each
+// time.  Scripts (#!) are not supported by templates.
+// -------------------------------------------------------------------
+
+// Opaque type representing a prepared binary.
+// Use of this object is not thread-safe.
+typedef struct launchpad_template launchpad_template_t;
+
+// Prepare a template from an ELF binary found at path / in a VM object.
+// The _from_vmo variant consumes the VM object.  On success the caller
+// owns the template and must destroy it with launchpad_template_destroy
+// once no more processes will be spawned from it.
+zx_status_t launchpad_template_from_file(const char* path,
+                                         launchpad_template_t** out);
+zx_status_t launchpad_template_from_vmo(zx_handle_t vmo,
+                                        launchpad_template_t** out);
+
+// Create a new process under job (as launchpad_create) with the
+// template's binary and the vDSO already loaded, equivalent to
+// launchpad_create + launchpad_load_from_file but without touching the
+// filesystem.  The template is not consumed and may be reused.  The
+// returned launchpad is ready for launchpad_set_args etc. and
+// launchpad_go.
+zx_status_t launchpad_create_from_template(zx_handle_t job, const char* name,
+                                           launchpad_template_t* tmpl,
+                                           launchpad_t** result);
+
+// Clean up a template, closing the cached VM objects.  Processes
+// already spawned from it are unaffected.
+void launchpad_template_destroy(launchpad_template_t* tmpl);
+
+
 // ADDING ARGUMENTS, ENVIRONMENT, AND HANDLES
 // These functions setup arguments, environment, or handles to be
 // passed to the new process via the processargs protocol.
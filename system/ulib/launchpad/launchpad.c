@@ -1012,6 +1012,49 @@ size_t launchpad_set_stack_size(launchpad_t* lp, size_t new_size) {
     return old_size;
 }
 
+// Best effort: pass a read-only VMO holding a zx_proc_info_t so the new
+// process can answer self-info queries (koid, start time) without making
+// get_info syscalls during startup.  The page is an optional part of the
+// processargs protocol, so any failure here just means the child falls
+// back to zx_object_get_info().
+static void add_proc_info_vmo(launchpad_t* lp) {
+    zx_info_handle_basic_t info;
+    if (zx_object_get_info(lp_proc(lp), ZX_INFO_HANDLE_BASIC,
+                           &info, sizeof(info), NULL, NULL) != ZX_OK)
+        return;
+
+    const zx_proc_info_t proc_info = {
+        .magic = ZX_PROC_INFO_MAGIC,
+        .version = ZX_PROC_INFO_VERSION,
+        .koid = info.koid,
+        // For a process handle, the related koid is the owning job's.
+        .job_koid = info.related_koid,
+        .start_time = zx_clock_get_monotonic(),
+    };
+
+    zx_handle_t vmo;
+    if (zx_vmo_create(sizeof(proc_info), 0, &vmo) != ZX_OK)
+        return;
+    static const char kVmoName[] = "proc-info";
+    zx_object_set_property(vmo, ZX_PROP_NAME, kVmoName, sizeof(kVmoName) - 1);
+    if (zx_vmo_write(vmo, &proc_info, 0, sizeof(proc_info)) != ZX_OK) {
+        zx_handle_close(vmo);
+        return;
+    }
+
+    // The child maps this page for the life of the process; drop the
+    // write right so nothing can change the contents after the fact.
+    // zx_handle_replace() consumes the handle even on failure.
+    zx_handle_t ro_vmo;
+    if (zx_handle_replace(vmo,
+                          ZX_RIGHT_READ | ZX_RIGHT_MAP | ZX_RIGHT_TRANSFER |
+                          ZX_RIGHT_DUPLICATE | ZX_RIGHT_GET_PROPERTY,
+                          &ro_vmo) != ZX_OK)
+        return;
+
+    launchpad_add_handle(lp, ro_vmo, PA_VMO_PROCESS_INFO);
+}
+
 static zx_status_t prepare_start(launchpad_t* lp, launchpad_start_data_t* result) {
     if (lp->entry == 0)
         return lp_error(lp, ZX_ERR_BAD_STATE, "prepare start bad state");
@@ -1051,6 +1094,8 @@ static zx_status_t prepare_start(launchpad_t* lp, launchpad_start_data_t* result
         goto cleanup;
     }
 
+    add_proc_info_vmo(lp);
+
     bool sent_loader_message = lp->loader_message;
     if (lp->loader_message) {
         status = send_loader_message(lp, thread, to_child);
@@ -1312,3 +1357,154 @@ zx_status_t launchpad_load_from_fd(launchpad_t* lp, int fd) {
 zx_status_t launchpad_load_from_vmo(launchpad_t* lp, zx_handle_t vmo) {
     return launchpad_file_load_with_vdso(lp, vmo);
 }
+
+// A template caches everything about loading a binary that does not
+// depend on the particular process: the executable VMO, the interpreter
+// VMO resolved through the loader service (when the binary has a
+// PT_INTERP), and the parsed program headers of whichever of the two
+// launchpad maps.  Stamping a process from a template skips the file
+// read, header parsing, and loader-service round trip; only the
+// per-process segment mapping and bootstrap work remain (writable
+// segments are copy-on-write clones made by the ELF loader, so spawned
+// processes share clean pages).
+struct launchpad_template {
+    zx_handle_t exec_vmo;       // passed as PA_VMO_EXECUTABLE; invalid if no interp
+    zx_handle_t image_vmo;      // what launchpad maps: the PT_INTERP object,
+                                // or the executable itself when there is none
+    elf_load_info_t* image_elf; // parsed program headers for image_vmo
+    bool has_interp;
+};
+
+// Consumes |vmo| on success and failure.
+zx_status_t launchpad_template_from_vmo(zx_handle_t vmo,
+                                        launchpad_template_t** out) {
+    if (vmo == ZX_HANDLE_INVALID)
+        return ZX_ERR_INVALID_ARGS;
+
+    launchpad_template_t* tmpl = calloc(1, sizeof(*tmpl));
+    if (tmpl == NULL) {
+        zx_handle_close(vmo);
+        return ZX_ERR_NO_MEMORY;
+    }
+
+    elf_load_info_t* elf;
+    zx_status_t status = elf_load_start(vmo, NULL, 0, &elf);
+    if (status != ZX_OK)
+        goto fail;
+
+    char* interp;
+    size_t interp_len;
+    status = elf_load_get_interp(elf, vmo, &interp, &interp_len);
+    if (status != ZX_OK) {
+        elf_load_destroy(elf);
+        goto fail;
+    }
+
+    if (interp == NULL) {
+        tmpl->image_vmo = vmo;
+        tmpl->image_elf = elf;
+    } else {
+        // Resolve and parse the interpreter once; this is the part of a
+        // spawn that pays loader-service round trips.
+        elf_load_destroy(elf);
+        zx_handle_t loader_svc;
+        status = dl_clone_loader_service(&loader_svc);
+        if (status == ZX_OK) {
+            status = loader_svc_rpc(loader_svc, LDMSG_OP_LOAD_OBJECT,
+                                    interp, interp_len, &tmpl->image_vmo);
+            zx_handle_close(loader_svc);
+        }
+        free(interp);
+        if (status != ZX_OK)
+            goto fail;
+        status = elf_load_start(tmpl->image_vmo, NULL, 0, &tmpl->image_elf);
+        if (status != ZX_OK) {
+            zx_handle_close(tmpl->image_vmo);
+            goto fail;
+        }
+        tmpl->exec_vmo = vmo;
+        tmpl->has_interp = true;
+    }
+
+    *out = tmpl;
+    return ZX_OK;
+
+fail:
+    if (!tmpl->has_interp)
+        zx_handle_close(vmo);
+    free(tmpl);
+    return status;
+}
+
+zx_status_t launchpad_template_from_file(const char* path,
+                                         launchpad_template_t** out) {
+    zx_handle_t vmo;
+    zx_status_t status = launchpad_vmo_from_file(path, &vmo);
+    if (status != ZX_OK)
+        return status;
+    return launchpad_template_from_vmo(vmo, out);
+}
+
+void launchpad_template_destroy(launchpad_template_t* tmpl) {
+    if (tmpl == NULL)
+        return;
+    if (tmpl->exec_vmo != ZX_HANDLE_INVALID)
+        zx_handle_close(tmpl->exec_vmo);
+    if (tmpl->image_vmo != ZX_HANDLE_INVALID)
+        zx_handle_close(tmpl->image_vmo);
+    elf_load_destroy(tmpl->image_elf);
+    free(tmpl);
+}
+
+zx_status_t launchpad_create_from_template(zx_handle_t job, const char* name,
+                                           launchpad_template_t* tmpl,
+                                           launchpad_t** result) {
+    launchpad_t* lp;
+    launchpad_create(job, name, &lp);
+    if (lp->error)
+        goto done;
+
+    if (tmpl->has_interp) {
+        zx_status_t status = setup_loader_svc(lp);
+        if (status != ZX_OK) {
+            lp_error(lp, status, "template: cannot clone loader service");
+            goto done;
+        }
+        if (lp->fresh_process && reserve_low_address_space(lp) != ZX_OK)
+            goto done;
+    }
+
+    zx_handle_t segments_vmar;
+    zx_status_t status = elf_load_finish(lp_vmar(lp), tmpl->image_elf,
+                                         tmpl->image_vmo, &segments_vmar,
+                                         &lp->base, &lp->entry);
+    if (status != ZX_OK) {
+        lp_error(lp, status, "template: elf_load_finish() failed");
+        goto done;
+    }
+
+    if (tmpl->has_interp) {
+        zx_handle_t exec_vmo;
+        status = zx_handle_duplicate(tmpl->exec_vmo, ZX_RIGHT_SAME_RIGHTS,
+                                     &exec_vmo);
+        if (status != ZX_OK) {
+            zx_handle_close(segments_vmar);
+            lp_error(lp, status, "template: cannot duplicate executable vmo");
+            goto done;
+        }
+        lp->special_handles[HND_EXEC_VMO] = exec_vmo;
+        lp->special_handles[HND_SEGMENTS_VMAR] = segments_vmar;
+        lp->loader_message = true;
+    } else {
+        check_elf_stack_size(lp, tmpl->image_elf);
+        lp->loader_message = false;
+        launchpad_add_handle(lp, segments_vmar, PA_HND(PA_VMAR_LOADED, 0));
+    }
+
+    launchpad_load_vdso(lp, ZX_HANDLE_INVALID);
+    launchpad_add_vdso_vmo(lp);
+
+done:
+    *result = lp;
+    return lp->error;
+}
@@ -87,4 +87,10 @@ zx_status_t loader_service_create(async_dispatcher_t* dispatcher,
 // The |finalizer| in |loader_service_ops_t| will be called shortly before |svc|
 // destroys itself.
 zx_status_t loader_service_release(loader_service_t* svc);
+
+// Discard every VMO the service has cached from earlier load requests,
+// e.g. after a package update replaces libraries on disk.  Clients
+// holding clones handed out previously are unaffected; subsequent loads
+// go back to the filesystem (and repopulate the cache).
+zx_status_t loader_service_purge_cache(loader_service_t* svc);
 __END_CDECLS
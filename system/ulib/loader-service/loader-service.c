@@ -17,9 +17,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <threads.h>
 #include <unistd.h>
 #include <zircon/compiler.h>
 #include <zircon/device/vfs.h>
+#include <zircon/listnode.h>
 #include <zircon/status.h>
 #include <zircon/syscalls.h>
 #include <zircon/types.h>
@@ -44,8 +46,20 @@ struct loader_service {
 
     const loader_service_ops_t* ops;
     void* ctx;
+
+    // Cache of library-name -> VMO for objects this service has already
+    // loaded, so repeat process launches clone a cached VMO instead of
+    // going back to the filesystem.  Guarded by |cache_lock|.
+    mtx_t cache_lock;
+    list_node_t vmo_cache;
 };
 
+typedef struct vmo_cache_entry {
+    list_node_t node;
+    zx_handle_t vmo;
+    char name[];
+} vmo_cache_entry_t;
+
 // Per-session state of a loader service instance.
 typedef struct session_state session_state_t;
 struct session_state {
@@ -61,6 +75,7 @@ static void loader_service_addref(loader_service_t* svc) {
 
 static void loader_service_deref(loader_service_t* svc) {
     if (atomic_fetch_sub(&svc->refcount, 1) == 1) {
+        loader_service_purge_cache(svc);
         if (svc->ops->finalizer)
             svc->ops->finalizer(svc->ctx);
         free(svc);
@@ -126,6 +141,77 @@ void fd_finalizer(void* ctx) {
     free(instance_state);
 }
 
+// Hand out a copy-on-write clone of a cached VMO so no client can
+// scribble on the cached pages.
+static zx_status_t clone_cached_vmo(zx_handle_t vmo, const char* name,
+                                    zx_handle_t* out) {
+    uint64_t size;
+    zx_status_t status = zx_vmo_get_size(vmo, &size);
+    if (status != ZX_OK) {
+        return status;
+    }
+    status = zx_vmo_clone(vmo, ZX_VMO_CLONE_COPY_ON_WRITE, 0, size, out);
+    if (status == ZX_OK) {
+        zx_object_set_property(*out, ZX_PROP_NAME, name, strlen(name));
+    }
+    return status;
+}
+
+static zx_status_t load_object_cached(loader_service_t* svc, const char* name,
+                                      zx_handle_t* out) {
+    mtx_lock(&svc->cache_lock);
+    vmo_cache_entry_t* entry;
+    list_for_every_entry(&svc->vmo_cache, entry, vmo_cache_entry_t, node) {
+        if (!strcmp(entry->name, name)) {
+            zx_status_t status = clone_cached_vmo(entry->vmo, name, out);
+            mtx_unlock(&svc->cache_lock);
+            return status;
+        }
+    }
+    mtx_unlock(&svc->cache_lock);
+
+    // Miss: do the (possibly blocking) filesystem load without the lock
+    // held.  Failures are not cached, so a library that shows up later
+    // will be found.
+    zx_handle_t vmo;
+    zx_status_t status = svc->ops->load_object(svc->ctx, name, &vmo);
+    if (status != ZX_OK) {
+        return status;
+    }
+
+    entry = malloc(sizeof(vmo_cache_entry_t) + strlen(name) + 1);
+    if (entry == NULL) {
+        // Caching is best-effort; just hand the VMO out.
+        *out = vmo;
+        return ZX_OK;
+    }
+    entry->vmo = vmo;
+    strcpy(entry->name, name);
+
+    // Two sessions racing on the same miss may insert duplicate entries;
+    // lookups take the first match, so both stay valid and identical.
+    mtx_lock(&svc->cache_lock);
+    list_add_head(&svc->vmo_cache, &entry->node);
+    status = clone_cached_vmo(entry->vmo, name, out);
+    mtx_unlock(&svc->cache_lock);
+    return status;
+}
+
+zx_status_t loader_service_purge_cache(loader_service_t* svc) {
+    if (svc == NULL) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    mtx_lock(&svc->cache_lock);
+    vmo_cache_entry_t* entry;
+    while ((entry = list_remove_head_type(&svc->vmo_cache, vmo_cache_entry_t,
+                                          node)) != NULL) {
+        zx_handle_close(entry->vmo);
+        free(entry);
+    }
+    mtx_unlock(&svc->cache_lock);
+    return ZX_OK;
+}
+
 static const loader_service_ops_t fd_ops = {
     .load_object = fd_load_object,
     .load_abspath = fd_load_abspath,
@@ -184,7 +270,7 @@ static zx_status_t loader_service_rpc(zx_handle_t h, session_state_t* session_st
             size_t maxlen = PREFIX_MAX + strlen(data) + 1;
             char prefixed_name[maxlen];
             snprintf(prefixed_name, maxlen, "%s%s", session_state->config_prefix, data);
-            if (((status = svc->ops->load_object(svc->ctx, prefixed_name, &rsp_handle)) == ZX_OK) ||
+            if (((status = load_object_cached(svc, prefixed_name, &rsp_handle)) == ZX_OK) ||
                 session_state->config_exclusive) {
                 // if loading with prefix succeeds, or loading
                 // with prefix is configured to be exclusive of
@@ -193,7 +279,7 @@ static zx_status_t loader_service_rpc(zx_handle_t h, session_state_t* session_st
             }
             // otherwise, if non-exclusive, try loading without the prefix
         }
-        status = svc->ops->load_object(svc->ctx, data, &rsp_handle);
+        status = load_object_cached(svc, data, &rsp_handle);
         break;
     case LDMSG_OP_LOAD_SCRIPT_INTERPRETER:
     case LDMSG_OP_DEBUG_LOAD_CONFIG:
@@ -283,6 +369,8 @@ zx_status_t loader_service_create(async_dispatcher_t* dispatcher,
     svc->dispatcher = dispatcher;
     svc->ops = ops;
     svc->ctx = ctx;
+    mtx_init(&svc->cache_lock, mtx_plain);
+    list_initialize(&svc->vmo_cache);
 
     // When we create the loader service, we initialize the refcount to 1, which
     // causes the loader service to stay alive at least until someone calls
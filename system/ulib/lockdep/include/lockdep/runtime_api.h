@@ -46,6 +46,13 @@ extern ThreadLockState* SystemGetThreadLockState();
 // System-defined hook that initializes the ThreadLockState for the current thread.
 extern void SystemInitThreadLockState(ThreadLockState* state);
 
+// System-defined hook that decides whether the current lock acquisition
+// should run full dependency validation. Acquisition bookkeeping is always
+// performed; only the O(held locks) dependency checks are skipped when this
+// returns false. Implementations that want to validate every acquisition
+// simply return true.
+extern bool SystemLockValidationShouldSample();
+
 // System-defined hook that triggers a loop detection pass. In response to this
 // event the implementation must trigger a call lockdep::LoopDetectionPass() on
 // a separate, dedicated or non-reentrant worker thread. Non-reentrancy is a
@@ -91,7 +91,17 @@ public:
         //     lock.
         //  4. Adds each lock class already in the list to the dependency set of the
         //     given lock class.
+        //
+        // The scan may be sampled by the system runtime: the acquired lock
+        // list is always maintained so that validated acquisitions see the
+        // full set of held locks, but the checks themselves can run for only
+        // a fraction of acquisitions to bound overhead.
         last_result_ = LockResult::Success;
+        if (!SystemLockValidationShouldSample()) {
+            if (!LockClassState::IsActiveListDisabled(lock_entry->id()))
+                acquired_locks_.push_back(lock_entry);
+            return;
+        }
         for (AcquiredLockEntry& entry : acquired_locks_) {
             if (entry.id() == lock_entry->id()) {
                 if (lock_entry->order() <= entry.order()) {
@@ -25,4 +25,10 @@ __WEAK ThreadLockState* SystemGetThreadLockState() {
 
 __WEAK void SystemInitThreadLockState(ThreadLockState* state) {}
 
+// By default every acquisition is validated; environments that want bounded
+// overhead override this with a sampling policy.
+__WEAK bool SystemLockValidationShouldSample() {
+    return true;
+}
+
 } // namespace fbl
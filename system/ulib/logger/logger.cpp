@@ -19,6 +19,12 @@ namespace {
 
 static fx_log_packet_t packet;
 
+// Maximum number of datagrams drained per socket wakeup. Draining in batches
+// amortizes the async wait re-arm and dispatcher round trip across every
+// packet already queued in the socket; the bound keeps one chatty writer from
+// starving the dispatcher's other work.
+constexpr size_t kMaxDrainBatch = 32;
+
 } // namespace
 
 LoggerImpl::LoggerImpl(zx::channel channel, int out_fd)
@@ -99,13 +105,16 @@ void LoggerImpl::OnLogMessage(async_dispatcher_t* dispatcher, async::WaitBase* w
     }
 
     if (signal->observed & ZX_SOCKET_READABLE) {
-        memset(&packet, 0, sizeof(packet));
-        status = socket_.read(0, &packet, sizeof(packet), nullptr);
-        if (status != ZX_OK) {
-            NotifyError(status);
-            return;
-        }
-        if (status != ZX_ERR_SHOULD_WAIT) {
+        for (size_t i = 0; i < kMaxDrainBatch; i++) {
+            memset(&packet, 0, sizeof(packet));
+            status = socket_.read(0, &packet, sizeof(packet), nullptr);
+            if (status == ZX_ERR_SHOULD_WAIT) {
+                break;
+            }
+            if (status != ZX_OK) {
+                NotifyError(status);
+                return;
+            }
             // set last byte of packet to zero so that we don't overflow buffer while
             // reading message.
             packet.data[sizeof(packet.data) - 1] = 0;
@@ -159,6 +159,24 @@ int mdns_unmarshal(const void* buf,
                    const size_t buf_len,
                    mdns_message* container);
 
+// Writes an mdns_message into buf as a query packet.
+//
+// Marshals the header followed by every question in the message, so one
+// round trip can carry all outstanding questions. Each question is written
+// as its domain name -- a sequence of length-prefixed labels ending in a
+// zero octet -- followed by its qtype and qclass. Resource record sections
+// are not yet written, mirroring mdns_unmarshal, which only reads the
+// header. Multi-byte fields are copied in the same byte order used by
+// mdns_unmarshal.
+//
+// If the encoded message is longer than buf_len bytes, -1 is returned and
+// errno is set to EMSGSIZE. If any dot-separated label in a domain is empty
+// or longer than MAX_DOMAIN_LABEL bytes, -1 is returned and errno is set to
+// EINVAL.
+//
+// Returns the number of bytes written to buf.
+int mdns_marshal(const mdns_message* message, void* buf, const size_t buf_len);
+
 // Zeroes the values contained in the given mdns_message.
 void mdns_init_message(mdns_message* message);
 
@@ -232,6 +250,77 @@ int mdns_add_additional(mdns_message*,
 // message was allocated on the heap.
 void mdns_free_message(mdns_message* message);
 
+/**
+ * Response caching.
+ *
+ * Received resource records can be stored in an mdns_cache, keyed by name,
+ * type and class, so repeated discovery rounds are answered locally instead
+ * of re-querying the network. TTLs are honored: every call taking a `now`
+ * argument expects the current time in seconds from any fixed reference of
+ * the caller's choosing, and records lapse ttl seconds after insertion.
+ * Time is caller-supplied so the library behaves the same in userspace,
+ * host and EFI builds.
+ **/
+
+// A cache of received resource records.
+typedef struct mdns_cache_t {
+    struct mdns_cache_entry_t* entries;
+} mdns_cache;
+
+// Zeroes the values contained in the given mdns_cache.
+void mdns_init_cache(mdns_cache* cache);
+
+// Frees every entry in the given cache.
+//
+// Clients should free(cache) after calling mdns_free_cache(cache) if the
+// cache was allocated on the heap.
+void mdns_free_cache(mdns_cache* cache);
+
+// Stores a copy of the given resource record in the cache.
+//
+// The record and its rdata are copied; the caller retains ownership of rr.
+// A record with the same name, type and class as an existing entry replaces
+// it. The entry expires rr->ttl seconds after now. Per RFC 6762, a record
+// with a ttl of zero is a "goodbye": any matching entry is removed and
+// nothing is stored.
+//
+// If rr's type or class is invalid, a negative value is returned and errno
+// is set to EINVAL. If memory cannot be allocated for the entry, a negative
+// value is returned and errno is set to ENOMEM.
+//
+// Returns 0 on success.
+int mdns_cache_insert(mdns_cache* cache, const mdns_rr* rr, uint64_t now);
+
+// Returns the cached record with the given name, type and class, or NULL if
+// there is no such record or it has expired. Expired records encountered
+// during the search are evicted.
+//
+// The returned record is owned by the cache and is valid until the next
+// call that mutates the cache.
+const mdns_rr* mdns_cache_lookup(mdns_cache* cache,
+                                 const char* name,
+                                 uint16_t type,
+                                 uint16_t clazz,
+                                 uint64_t now);
+
+// Removes every cached record that has expired at time now.
+//
+// Returns the number of records removed.
+int mdns_cache_evict_expired(mdns_cache* cache, uint64_t now);
+
+// Appends a question for domain to the given query unless the cache holds
+// an unexpired record with matching name, type and class, so a discovery
+// round only asks the network for what it doesn't already know.
+//
+// Returns 1 if the question was added, 0 on a cache hit, or a negative
+// value with errno set as described in mdns_add_question.
+int mdns_query_if_missing(mdns_message* query,
+                          mdns_cache* cache,
+                          const char* domain,
+                          uint16_t qtype,
+                          uint16_t qclass,
+                          uint64_t now);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
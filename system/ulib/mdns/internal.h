@@ -63,6 +63,35 @@ int mdns_add_rr(mdns_rr** rrsptr,
 // consistent with the style of other unmarshal* functions.
 int unmarshal_header(const void* buf, mdns_header* container);
 
+// Writes an mdns_message header into buf. Mirrors unmarshal_header; see its
+// docs for the header layout.
+//
+// Assumes the given buffer holds at least MDNS_HEADER_SIZE bytes.
+//
+// Always returns MDNS_HEADER_SIZE as the number of bytes written to buf.
+int marshal_header(void* buf, const mdns_header* header);
+
+// Writes a single question into buf in DNS wire format: the domain as a
+// sequence of length-prefixed labels followed by a zero octet, then the
+// qtype and qclass.
+//
+// If the encoded question is longer than buf_len bytes, a negative value is
+// returned and errno is set to EMSGSIZE. If any dot-separated label of the
+// domain is empty or longer than MAX_DOMAIN_LABEL bytes, a negative value
+// is returned and errno is set to EINVAL.
+//
+// Returns the number of bytes written to buf.
+int marshal_question(void* buf, size_t buf_len, const mdns_question* question);
+
+// A single response cache entry. rr.rdata points at a heap copy owned by
+// the cache, and rr.next is unused. expiry is the absolute time, in
+// seconds, at which the record lapses.
+typedef struct mdns_cache_entry_t {
+    mdns_rr rr;
+    uint64_t expiry;
+    struct mdns_cache_entry_t* next;
+} mdns_cache_entry;
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -504,6 +504,296 @@ static bool test_mdns_unmarshal_empty_message(void) {
     END_TEST;
 }
 
+static bool test_mdns_marshal_query(void) {
+    BEGIN_TEST;
+
+    mdns_message message;
+    mdns_init_message(&message);
+    message.header.id = 0xABCD;
+
+    char domain[] = "fuchsia.local";
+    int retval = mdns_add_question(&message, domain, RR_TYPE_A, RR_CLASS_IN);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+    retval = mdns_add_question(&message, domain, RR_TYPE_AAAA, RR_CLASS_IN);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    uint8_t buf[128];
+    retval = mdns_marshal(&message, buf, sizeof(buf));
+    // Each question is 1 + 7 ("fuchsia") + 1 + 5 ("local") + 1 (root label)
+    // + 2 (qtype) + 2 (qclass) = 19 bytes.
+    EXPECT_EQ(retval, MDNS_HEADER_SIZE + 2 * 19, "wrong encoded message size");
+
+    // The header should survive a round trip through mdns_unmarshal.
+    mdns_message decoded;
+    retval = mdns_unmarshal(buf, sizeof(buf), &decoded);
+    EXPECT_EQ(retval, MDNS_HEADER_SIZE, "should have read 12 bytes");
+    EXPECT_EQ(decoded.header.id, 0xABCD, "ID should be 0xABCD");
+    EXPECT_EQ(decoded.header.qd_count, 2, "question count should be two");
+
+    // The first question starts with the length-prefixed domain labels.
+    const uint8_t* q = &buf[MDNS_HEADER_SIZE];
+    EXPECT_EQ(q[0], 7, "first label length should be 7");
+    EXPECT_EQ(memcmp(&q[1], "fuchsia", 7), 0, "first label is wrong");
+    EXPECT_EQ(q[8], 5, "second label length should be 5");
+    EXPECT_EQ(memcmp(&q[9], "local", 5), 0, "second label is wrong");
+    EXPECT_EQ(q[14], 0, "domain should end with the root label");
+
+    mdns_free_message(&message);
+    mdns_free_message(&decoded);
+
+    END_TEST;
+}
+
+static bool test_mdns_marshal_buffer_too_small(void) {
+    BEGIN_TEST;
+
+    mdns_message message;
+    mdns_init_message(&message);
+
+    char domain[] = "fuchsia.local";
+    int retval = mdns_add_question(&message, domain, RR_TYPE_A, RR_CLASS_IN);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    uint8_t buf[MDNS_HEADER_SIZE + 4];
+    retval = mdns_marshal(&message, buf, sizeof(buf));
+    EXPECT_EQ(retval, -1, "should return -1 on error");
+    EXPECT_EQ(errno, EMSGSIZE, "errno should be EMSGSIZE");
+
+    retval = mdns_marshal(&message, buf, MDNS_HEADER_SIZE - 1);
+    EXPECT_EQ(retval, -1, "should return -1 on error");
+    EXPECT_EQ(errno, EMSGSIZE, "errno should be EMSGSIZE");
+
+    mdns_free_message(&message);
+
+    END_TEST;
+}
+
+static bool test_mdns_marshal_bad_label(void) {
+    BEGIN_TEST;
+
+    mdns_message message;
+    mdns_init_message(&message);
+
+    // An empty label is not encodable.
+    char domain[] = "fuchsia..local";
+    int retval = mdns_add_question(&message, domain, RR_TYPE_A, RR_CLASS_IN);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    uint8_t buf[128];
+    retval = mdns_marshal(&message, buf, sizeof(buf));
+    EXPECT_EQ(retval, -1, "should return -1 on error");
+    EXPECT_EQ(errno, EINVAL, "errno should be EINVAL");
+
+    mdns_free_message(&message);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_insert_and_lookup(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    const mdns_rr* hit =
+        mdns_cache_lookup(&cache, t.rr.name, t.rr.type, t.rr.clazz, 100);
+    ASSERT_NONNULL(hit, "record should be cached");
+    EXPECT_TRUE(verify_rr(const_cast<mdns_rr*>(hit), t.rr.name, t.rr.type,
+                          t.rr.clazz, t.rr.rdata, t.rr.rdlength, t.rr.ttl));
+    EXPECT_EQ(memcmp(hit->rdata, t.rr.rdata, t.rr.rdlength), 0,
+              "rdata was not copied into the cache");
+    EXPECT_NE(hit->rdata, t.rr.rdata, "cache should own its own copy of rdata");
+
+    // A different type or class should miss.
+    EXPECT_NULL(mdns_cache_lookup(&cache, t.rr.name, RR_TYPE_A, t.rr.clazz, 100),
+                "lookup with wrong type should miss");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_insert_bad_rr_type(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+    t.rr.type = (uint16_t)(RR_TYPE_A + 1); // Unsupported record type.
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 0);
+    EXPECT_EQ(retval, -1, "should return value < zero on error");
+    EXPECT_EQ(errno, EINVAL, "errno should be EINVAL when given bad rr type");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_ttl_expiry(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset(); // t.rr.ttl is 42.
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    EXPECT_NONNULL(mdns_cache_lookup(&cache, t.rr.name, t.rr.type, t.rr.clazz, 141),
+                   "record should still be cached just before its ttl lapses");
+    EXPECT_NULL(mdns_cache_lookup(&cache, t.rr.name, t.rr.type, t.rr.clazz, 142),
+                "record should have expired ttl seconds after insertion");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_goodbye(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    // A zero ttl removes the matching record without caching anything.
+    t.rr.ttl = 0;
+    retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+    EXPECT_NULL(mdns_cache_lookup(&cache, t.rr.name, t.rr.type, t.rr.clazz, 100),
+                "goodbye record should have evicted the cached record");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_replace(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    // Re-announcing a record refreshes its data and ttl in place.
+    uint8_t other_rdata[] = {0xF};
+    t.rr.rdata = other_rdata;
+    t.rr.rdlength = sizeof(other_rdata);
+    t.rr.ttl = 120;
+    retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    const mdns_rr* hit =
+        mdns_cache_lookup(&cache, t.rr.name, t.rr.type, t.rr.clazz, 100);
+    ASSERT_NONNULL(hit, "record should be cached");
+    EXPECT_EQ(hit->ttl, 120, "ttl should have been refreshed");
+    EXPECT_EQ(hit->rdlength, sizeof(other_rdata), "rdlength should be updated");
+    EXPECT_EQ(memcmp(hit->rdata, other_rdata, sizeof(other_rdata)), 0,
+              "rdata should be updated");
+
+    // There should be exactly one entry.
+    EXPECT_EQ(mdns_cache_evict_expired(&cache, 100 + 120), 1,
+              "replacement should not create a second entry");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_cache_evict_expired(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    t.rr.ttl = 10;
+    int retval = mdns_cache_insert(&cache, &t.rr, 0);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    char other_name[] = "other name";
+    strcpy(t.rr.name, other_name);
+    t.rr.ttl = 100;
+    retval = mdns_cache_insert(&cache, &t.rr, 0);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    EXPECT_EQ(mdns_cache_evict_expired(&cache, 50), 1,
+              "only the first record should have expired");
+    EXPECT_NONNULL(mdns_cache_lookup(&cache, other_name, t.rr.type, t.rr.clazz, 50),
+                   "unexpired record should survive eviction");
+    EXPECT_EQ(mdns_cache_evict_expired(&cache, 200), 1,
+              "remaining record should expire");
+
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
+static bool test_mdns_query_if_missing(void) {
+    BEGIN_TEST;
+
+    test_data t;
+    t.reset();
+
+    mdns_cache cache;
+    mdns_init_cache(&cache);
+
+    int retval = mdns_cache_insert(&cache, &t.rr, 100);
+    EXPECT_EQ(retval, 0, "should return zero if no error");
+
+    mdns_message query;
+    mdns_init_message(&query);
+
+    // A cached record suppresses its question.
+    retval = mdns_query_if_missing(&query, &cache, t.rr.name, t.rr.type,
+                                   t.rr.clazz, 100);
+    EXPECT_EQ(retval, 0, "should return zero on a cache hit");
+    EXPECT_EQ(query.header.qd_count, 0, "question count should be zero");
+
+    // Anything not in the cache becomes an outstanding question.
+    char other_domain[] = "other domain";
+    retval = mdns_query_if_missing(&query, &cache, other_domain, t.rr.type,
+                                   t.rr.clazz, 100);
+    EXPECT_EQ(retval, 1, "should return one when a question is added");
+    EXPECT_EQ(query.header.qd_count, 1, "question count should be one");
+    EXPECT_TRUE(verify_question(query.questions, other_domain, t.rr.type,
+                                t.rr.clazz));
+
+    // An expired record no longer suppresses its question.
+    retval = mdns_query_if_missing(&query, &cache, t.rr.name, t.rr.type,
+                                   t.rr.clazz, 100 + t.rr.ttl);
+    EXPECT_EQ(retval, 1, "should return one when a question is added");
+    EXPECT_EQ(query.header.qd_count, 2, "question count should be two");
+
+    mdns_free_message(&query);
+    mdns_free_cache(&cache);
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(mdns_free_message)
 RUN_TEST(test_mdns_free_message)
 END_TEST_CASE(mdns_free_message)
@@ -544,6 +834,22 @@ RUN_TEST(test_mdns_unmarshal_incomplete_header)
 RUN_TEST(test_mdns_unmarshal_empty_message)
 END_TEST_CASE(test_mdns_unmarshal)
 
+BEGIN_TEST_CASE(test_mdns_marshal)
+RUN_TEST(test_mdns_marshal_query)
+RUN_TEST(test_mdns_marshal_buffer_too_small)
+RUN_TEST(test_mdns_marshal_bad_label)
+END_TEST_CASE(test_mdns_marshal)
+
+BEGIN_TEST_CASE(mdns_response_cache)
+RUN_TEST(test_mdns_cache_insert_and_lookup)
+RUN_TEST(test_mdns_cache_insert_bad_rr_type)
+RUN_TEST(test_mdns_cache_ttl_expiry)
+RUN_TEST(test_mdns_cache_goodbye)
+RUN_TEST(test_mdns_cache_replace)
+RUN_TEST(test_mdns_query_if_missing)
+RUN_TEST(test_mdns_cache_evict_expired)
+END_TEST_CASE(mdns_response_cache)
+
 int main(int argc, char* argv[]) {
     return unittest_run_all_tests(argc, argv) ? 0 : -1;
 }
@@ -221,3 +221,223 @@ int unmarshal_header(const void* buf,
     memcpy(container, buf, MDNS_HEADER_SIZE);
     return MDNS_HEADER_SIZE;
 }
+
+int marshal_header(void* buf, const mdns_header* header) {
+    memcpy(buf, header, MDNS_HEADER_SIZE);
+    return MDNS_HEADER_SIZE;
+}
+
+int marshal_question(void* buf, size_t buf_len, const mdns_question* question) {
+    uint8_t* out = buf;
+    size_t pos = 0;
+    const char* label = question->domain;
+
+    while (*label != '\0') {
+        size_t label_len = 0;
+        while (label[label_len] != '\0' && label[label_len] != '.') {
+            label_len++;
+        }
+        if (label_len == 0 || label_len > MAX_DOMAIN_LABEL) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (pos + 1 + label_len > buf_len) {
+            errno = EMSGSIZE;
+            return -1;
+        }
+        out[pos++] = (uint8_t)label_len;
+        memcpy(&out[pos], label, label_len);
+        pos += label_len;
+        label += label_len;
+        if (*label == '.') {
+            label++;
+        }
+    }
+
+    if (pos + 1 + sizeof(question->qtype) + sizeof(question->qclass) > buf_len) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    // The root label terminates the domain name.
+    out[pos++] = 0;
+    memcpy(&out[pos], &question->qtype, sizeof(question->qtype));
+    pos += sizeof(question->qtype);
+    memcpy(&out[pos], &question->qclass, sizeof(question->qclass));
+    pos += sizeof(question->qclass);
+    return (int)pos;
+}
+
+int mdns_marshal(const mdns_message* message,
+                 void* buf,
+                 const size_t buf_len) {
+    // Total number of bytes written during marshalling.
+    int write_count = 0;
+
+    if (buf_len < MDNS_HEADER_SIZE) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    write_count += marshal_header(buf, &(message->header));
+
+    mdns_question* question = message->questions;
+    while (question != NULL) {
+        int retval = marshal_question((uint8_t*)buf + write_count,
+                                      buf_len - write_count, question);
+        if (retval < 0) {
+            return retval;
+        }
+        write_count += retval;
+        question = question->next;
+    }
+
+    // Resource record sections are not yet marshalled, mirroring
+    // mdns_unmarshal.
+    return write_count;
+}
+
+void mdns_init_cache(mdns_cache* cache) {
+    memset(cache, 0, sizeof(mdns_cache));
+}
+
+// Frees a cache entry and the rdata copy it owns.
+static void free_cache_entry(mdns_cache_entry* entry) {
+    free(entry->rr.rdata);
+    free(entry);
+}
+
+void mdns_free_cache(mdns_cache* cache) {
+    mdns_cache_entry* next;
+
+    while (cache->entries != NULL) {
+        next = cache->entries->next;
+        free_cache_entry(cache->entries);
+        cache->entries = next;
+    }
+}
+
+// Returns a pointer to the link holding the entry with the given name, type
+// and class, or NULL if there is no such entry. Expired entries passed over
+// during the walk are evicted.
+static mdns_cache_entry** cache_find(mdns_cache* cache,
+                                     const char* name,
+                                     uint16_t type,
+                                     uint16_t clazz,
+                                     uint64_t now) {
+    mdns_cache_entry** linkptr = &(cache->entries);
+
+    while (*linkptr != NULL) {
+        mdns_cache_entry* entry = *linkptr;
+        if (entry->expiry <= now) {
+            *linkptr = entry->next;
+            free_cache_entry(entry);
+            continue;
+        }
+        if (entry->rr.type == type && entry->rr.clazz == clazz &&
+            strncmp(entry->rr.name, name, MAX_DOMAIN_LENGTH) == 0) {
+            return linkptr;
+        }
+        linkptr = &(entry->next);
+    }
+
+    return NULL;
+}
+
+int mdns_cache_insert(mdns_cache* cache, const mdns_rr* rr, uint64_t now) {
+    if (!(is_valid_rr_type(rr->type) && is_valid_rr_class(rr->clazz))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mdns_cache_entry** linkptr =
+        cache_find(cache, rr->name, rr->type, rr->clazz, now);
+
+    // Per RFC 6762, a zero ttl announces that the record is gone.
+    if (rr->ttl == 0) {
+        if (linkptr != NULL) {
+            mdns_cache_entry* entry = *linkptr;
+            *linkptr = entry->next;
+            free_cache_entry(entry);
+        }
+        return 0;
+    }
+
+    // Copy the rdata before touching the cache so failure leaves any
+    // existing entry intact.
+    uint8_t* rdata = NULL;
+    if (rr->rdlength > 0) {
+        rdata = malloc(rr->rdlength);
+        if (rdata == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        memcpy(rdata, rr->rdata, rr->rdlength);
+    }
+
+    mdns_cache_entry* entry;
+    if (linkptr != NULL) {
+        // Replace the existing record's data in place.
+        entry = *linkptr;
+        free(entry->rr.rdata);
+    } else {
+        entry = calloc(1, sizeof(mdns_cache_entry));
+        if (entry == NULL) {
+            free(rdata);
+            errno = ENOMEM;
+            return -1;
+        }
+        strncpy(entry->rr.name, rr->name, MAX_DOMAIN_LENGTH);
+        entry->rr.type = rr->type;
+        entry->rr.clazz = rr->clazz;
+        entry->next = cache->entries;
+        cache->entries = entry;
+    }
+
+    entry->rr.rdata = rdata;
+    entry->rr.rdlength = rr->rdlength;
+    entry->rr.ttl = rr->ttl;
+    entry->expiry = now + rr->ttl;
+    return 0;
+}
+
+const mdns_rr* mdns_cache_lookup(mdns_cache* cache,
+                                 const char* name,
+                                 uint16_t type,
+                                 uint16_t clazz,
+                                 uint64_t now) {
+    mdns_cache_entry** linkptr = cache_find(cache, name, type, clazz, now);
+    return linkptr == NULL ? NULL : &((*linkptr)->rr);
+}
+
+int mdns_cache_evict_expired(mdns_cache* cache, uint64_t now) {
+    int evicted = 0;
+    mdns_cache_entry** linkptr = &(cache->entries);
+
+    while (*linkptr != NULL) {
+        mdns_cache_entry* entry = *linkptr;
+        if (entry->expiry <= now) {
+            *linkptr = entry->next;
+            free_cache_entry(entry);
+            evicted++;
+            continue;
+        }
+        linkptr = &(entry->next);
+    }
+
+    return evicted;
+}
+
+int mdns_query_if_missing(mdns_message* query,
+                          mdns_cache* cache,
+                          const char* domain,
+                          uint16_t qtype,
+                          uint16_t qclass,
+                          uint64_t now) {
+    if (mdns_cache_lookup(cache, domain, qtype, qclass, now) != NULL) {
+        return 0;
+    }
+
+    int retval = mdns_add_question(query, domain, qtype, qclass);
+    return retval < 0 ? retval : 1;
+}
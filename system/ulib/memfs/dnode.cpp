@@ -80,12 +80,8 @@ void Dnode::AddChild(fbl::RefPtr<Dnode> parent, fbl::RefPtr<Dnode> child) {
         parent->vnode_->link_count_++;
     }
     // Ensure that the ordering of tokens in the children list is absolute.
-    if (parent->children_.is_empty()) {
-        child->ordering_token_ = 2; // '0' for '.', '1' for '..'
-    } else {
-        child->ordering_token_ = parent->children_.back().ordering_token_ + 1;
-    }
-    parent->children_.push_back(fbl::move(child));
+    child->ordering_token_ = parent->next_ordering_token_++;
+    parent->children_.insert(fbl::move(child));
     parent->vnode_->UpdateModified();
 }
 
@@ -152,16 +148,16 @@ void Dnode::Readdir(fs::DirentFiller* df, void* cookie) const {
         }
     }
 
-    for (const auto& dn : children_) {
-        if (dn.ordering_token_ < c->order) {
-            continue;
-        }
-        uint32_t vtype = dn.IsDirectory() ? V_TYPE_DIR : V_TYPE_FILE;
-        if ((r = df->Next(fbl::StringPiece(dn.name_.get(), dn.NameLen()),
-                          VTYPE_TO_DTYPE(vtype), dn.AcquireVnode()->ino())) != ZX_OK) {
+    // Children are keyed on their ordering token, so resuming a continuation
+    // is a lower_bound rather than a scan over already-returned entries. The
+    // filler then packs dirents until the response buffer is exhausted.
+    for (auto it = children_.lower_bound(c->order); it != children_.end(); ++it) {
+        uint32_t vtype = it->IsDirectory() ? V_TYPE_DIR : V_TYPE_FILE;
+        if ((r = df->Next(fbl::StringPiece(it->name_.get(), it->NameLen()),
+                          VTYPE_TO_DTYPE(vtype), it->AcquireVnode()->ino())) != ZX_OK) {
             return;
         }
-        c->order = dn.ordering_token_ + 1;
+        c->order = it->ordering_token_ + 1;
     }
 }
 
@@ -191,7 +187,9 @@ void Dnode::PutName(fbl::unique_ptr<char[]> name, size_t len) {
 bool Dnode::IsDirectory() const { return vnode_->IsDirectory(); }
 
 Dnode::Dnode(fbl::RefPtr<VnodeMemfs> vn, fbl::unique_ptr<char[]> name, uint32_t flags) :
-    vnode_(fbl::move(vn)), parent_(nullptr), ordering_token_(0), flags_(flags), name_(fbl::move(name)) {
+    vnode_(fbl::move(vn)), parent_(nullptr), ordering_token_(0),
+    next_ordering_token_(2), // '0' for '.', '1' for '..'
+    flags_(flags), name_(fbl::move(name)) {
 };
 
 size_t Dnode::NameLen() const {
@@ -10,7 +10,7 @@
 #include <fs/vfs.h>
 #include <fs/vnode.h>
 #include <lib/fdio/vfs.h>
-#include <fbl/intrusive_double_list.h>
+#include <fbl/intrusive_wavl_tree.h>
 #include <fbl/ref_counted.h>
 #include <fbl/ref_ptr.h>
 #include <fbl/unique_ptr.h>
@@ -29,12 +29,23 @@ static_assert(((kDnodeNameMax + 1) & kDnodeNameMax) == 0,
 class Dnode : public fbl::RefCounted<Dnode> {
 public:
     DISALLOW_COPY_ASSIGN_AND_MOVE(Dnode);
-    using NodeState = fbl::DoublyLinkedListNodeState<fbl::RefPtr<Dnode>>;
+    using NodeState = fbl::WAVLTreeNodeState<fbl::RefPtr<Dnode>>;
 
     // ChildTraits is the state used for a Dnode to appear as the child
     // of another dnode.
     struct TypeChildTraits { static NodeState& node_state(Dnode& dn) { return dn.type_child_state_; }};
-    using ChildList = fbl::DoublyLinkedList<fbl::RefPtr<Dnode>, Dnode::TypeChildTraits>;
+
+    // Children are keyed on their ordering token, so a readdir continuation
+    // can resume from its cookie with lower_bound rather than rescanning the
+    // container from the start.
+    struct KeyByTokenTraits {
+        static size_t GetKey(const Dnode& dn) { return dn.ordering_token_; }
+        static bool LessThan(size_t key1, size_t key2) { return key1 < key2; }
+        static bool EqualTo(size_t key1, size_t key2) { return key1 == key2; }
+    };
+
+    using ChildList = fbl::WAVLTree<size_t, fbl::RefPtr<Dnode>,
+                                    Dnode::KeyByTokenTraits, Dnode::TypeChildTraits>;
 
     // Allocates a dnode, attached to a vnode
     static fbl::RefPtr<Dnode> Create(fbl::StringPiece name, fbl::RefPtr<VnodeMemfs> vn);
@@ -89,6 +100,7 @@ public:
 
 private:
     friend struct TypeChildTraits;
+    friend struct KeyByTokenTraits;
 
     Dnode(fbl::RefPtr<VnodeMemfs> vn, fbl::unique_ptr<char[]> name, uint32_t flags);
 
@@ -100,6 +112,9 @@ private:
     fbl::RefPtr<Dnode> parent_;
     // Used to impose an absolute order on dnodes within a directory.
     size_t ordering_token_;
+    // The token handed to the next child added to this directory. Tokens are
+    // never reused, so cookies remain stable across concurrent unlinks.
+    size_t next_ordering_token_;
     ChildList children_;
     uint32_t flags_;
     fbl::unique_ptr<char[]> name_;
@@ -22,6 +22,10 @@ blk_t BitmapBlocksForSize(size_t size) {
 }  // namespace
 
 AllocatorPromise::~AllocatorPromise() {
+    if (run_length_ > 0) {
+        ZX_DEBUG_ASSERT(allocator_ != nullptr);
+        allocator_->ReleaseRun(run_start_, run_length_);
+    }
     if (reserved_ > 0) {
         ZX_DEBUG_ASSERT(allocator_ != nullptr);
         allocator_->Unreserve(reserved_);
@@ -31,8 +35,18 @@ AllocatorPromise::~AllocatorPromise() {
 size_t AllocatorPromise::Allocate(WriteTxn* txn) {
     ZX_DEBUG_ASSERT(allocator_ != nullptr);
     ZX_DEBUG_ASSERT(reserved_ > 0);
+    if (run_length_ == 0) {
+        // Grab a contiguous run of free elements, bounded by the remaining
+        // reservation; subsequent calls pop from the run without searching
+        // the bitmap.
+        allocator_->GrabRun(reserved_, &run_start_, &run_length_);
+    }
+    size_t bitoff = run_start_;
+    allocator_->CommitElement(txn, bitoff);
+    run_start_++;
+    run_length_--;
     reserved_--;
-    return allocator_->Allocate(txn);
+    return bitoff;
 }
 
 AllocatorFvmMetadata::AllocatorFvmMetadata() = default;
@@ -131,21 +145,54 @@ void Allocator::Unreserve(size_t count) {
     reserved_ -= count;
 }
 
-size_t Allocator::Allocate(WriteTxn* txn) {
-    ZX_DEBUG_ASSERT(reserved_ > 0);
+void Allocator::GrabRun(size_t max_length, size_t* out_start, size_t* out_length) {
+    ZX_DEBUG_ASSERT(max_length > 0);
+    ZX_DEBUG_ASSERT(reserved_ >= max_length);
+    size_t length = max_length;
     size_t bitoff_start;
-    if (map_.Find(false, hint_, map_.size(), 1, &bitoff_start) != ZX_OK) {
-        ZX_ASSERT(map_.Find(false, 0, hint_, 1, &bitoff_start) == ZX_OK);
+    uint64_t attempts = 0;
+    while (true) {
+        attempts++;
+        if (map_.Find(false, hint_, map_.size(), length, &bitoff_start) == ZX_OK) {
+            break;
+        }
+        if (map_.Find(false, 0, hint_, length, &bitoff_start) == ZX_OK) {
+            break;
+        }
+        // The reservation guarantees that at least |max_length| elements are
+        // free, so a search for a single element cannot fail.
+        ZX_ASSERT(length > 1);
+        length /= 2;
     }
 
-    ZX_ASSERT(map_.Set(bitoff_start, bitoff_start + 1) == ZX_OK);
+    ZX_ASSERT(map_.Set(bitoff_start, bitoff_start + length) == ZX_OK);
+    hint_ = bitoff_start + length;
+
+    alloc_runs_++;
+    alloc_run_units_ += length;
+    alloc_search_attempts_ += attempts;
+
+    *out_start = bitoff_start;
+    *out_length = length;
+}
 
-    Persist(txn, bitoff_start, 1);
+void Allocator::CommitElement(WriteTxn* txn, size_t index) {
+    ZX_DEBUG_ASSERT(reserved_ > 0);
+    ZX_DEBUG_ASSERT(map_.Get(index, index + 1));
+    Persist(txn, index, 1);
     metadata_.PoolAllocate(1);
     reserved_ -= 1;
     sb_->Write(txn);
-    hint_ = bitoff_start + 1;
-    return bitoff_start;
+}
+
+void Allocator::ReleaseRun(size_t start, size_t length) {
+    ZX_DEBUG_ASSERT(length > 0);
+    ZX_DEBUG_ASSERT(map_.Get(start, start + length));
+    map_.Clear(start, start + length);
+
+    if (start < hint_) {
+        hint_ = start;
+    }
 }
 
 void Allocator::Free(WriteTxn* txn, size_t index) {
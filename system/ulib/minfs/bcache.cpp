@@ -8,6 +8,7 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
 #include <fbl/ref_ptr.h>
 #include <fbl/unique_ptr.h>
@@ -19,7 +20,7 @@
 
 namespace minfs {
 
-zx_status_t Bcache::Readblk(blk_t bno, void* data) {
+zx_status_t Bcache::ReadRange(blk_t bno, uint32_t count, void* data) {
     off_t off = static_cast<off_t>(bno) * kMinfsBlockSize;
     assert(off / kMinfsBlockSize == bno); // Overflow
 #ifndef __Fuchsia__
@@ -29,14 +30,52 @@ zx_status_t Bcache::Readblk(blk_t bno, void* data) {
         FS_TRACE_ERROR("minfs: cannot seek to block %u\n", bno);
         return ZX_ERR_IO;
     }
-    if (read(fd_.get(), data, kMinfsBlockSize) != kMinfsBlockSize) {
-        FS_TRACE_ERROR("minfs: cannot read block %u\n", bno);
+    const ssize_t len = static_cast<ssize_t>(count) * kMinfsBlockSize;
+    if (read(fd_.get(), data, len) != len) {
+        FS_TRACE_ERROR("minfs: cannot read %u blocks at %u\n", count, bno);
         return ZX_ERR_IO;
     }
     return ZX_OK;
 }
 
+zx_status_t Bcache::Readblk(blk_t bno, void* data) {
+    if (readahead_len_ != 0 && bno >= readahead_start_ &&
+        bno - readahead_start_ < readahead_len_) {
+        memcpy(data, &readahead_data_[(bno - readahead_start_) * kMinfsBlockSize],
+               kMinfsBlockSize);
+        readahead_hits_++;
+        last_read_bno_ = bno;
+        return ZX_OK;
+    }
+    readahead_misses_++;
+
+    // If the access pattern looks sequential, prefetch a window of blocks;
+    // on failure (e.g. a short file on the host path), fall back to reading
+    // the single requested block.
+    if (readahead_data_ != nullptr && bno == last_read_bno_ + 1 && bno < blockmax_) {
+        uint32_t count = fbl::min(kReadaheadBlocks, blockmax_ - bno);
+        if (count > 1 && ReadRange(bno, count, readahead_data_.get()) == ZX_OK) {
+            readahead_start_ = bno;
+            readahead_len_ = count;
+            memcpy(data, readahead_data_.get(), kMinfsBlockSize);
+            last_read_bno_ = bno;
+            return ZX_OK;
+        }
+    }
+
+    zx_status_t status = ReadRange(bno, 1, data);
+    if (status == ZX_OK) {
+        last_read_bno_ = bno;
+    }
+    return status;
+}
+
 zx_status_t Bcache::Writeblk(blk_t bno, const void* data) {
+    // Drop the readahead window if it covers the block being overwritten.
+    if (readahead_len_ != 0 && bno >= readahead_start_ &&
+        bno - readahead_start_ < readahead_len_) {
+        readahead_len_ = 0;
+    }
     off_t off = static_cast<off_t>(bno) * kMinfsBlockSize;
     assert(off / kMinfsBlockSize == bno); // Overflow
 #ifndef __Fuchsia__
@@ -65,6 +104,10 @@ zx_status_t Bcache::Create(fbl::unique_ptr<Bcache>* out, fbl::unique_fd fd, uint
     if (!ac.check()) {
         return ZX_ERR_NO_MEMORY;
     }
+    bc->readahead_data_.reset(new (&ac) uint8_t[kReadaheadBlocks * kMinfsBlockSize]);
+    if (!ac.check()) {
+        return ZX_ERR_NO_MEMORY;
+    }
 #ifdef __Fuchsia__
     zx::fifo fifo;
     ssize_t r;
@@ -148,6 +191,7 @@ zx_status_t Bcache::SetSparse(off_t offset, const fbl::Vector<size_t>& extent_le
     extent_lengths_[2] = extent_lengths[2];
     extent_lengths_[3] = extent_lengths[3];
     extent_lengths_[4] = extent_lengths[4];
+    extent_lengths_[5] = extent_lengths[5];
     offset_ = offset;
     return ZX_OK;
 }
@@ -423,6 +423,35 @@ typedef struct MINDIR {
     struct dirent de;
 } MINDIR;
 
+int emu_unlink(const char* path) {
+    ZX_DEBUG_ASSERT_MSG(!host_path(path), "'emu_' functions can only operate on target paths");
+    const char* fn = path + PREFIX_SIZE;
+    fbl::RefPtr<fs::Vnode> parent = fakeFs.fake_root;
+    zx_status_t status;
+
+    // Resolve the parent directory by hand; Vfs::Unlink only consumes the
+    // final path component.
+    const char* last_slash = strrchr(fn, '/');
+    if (last_slash != nullptr) {
+        fbl::RefPtr<fs::Vnode> vn;
+        fbl::StringPiece dir(fn, last_slash - fn);
+        fn = last_slash + 1;
+        if (!dir.empty()) {
+            status = fakeFs.fake_vfs->Open(fakeFs.fake_root, &vn, dir, &dir, O_RDONLY, 0);
+            if (status != ZX_OK) {
+                STATUS(status);
+            }
+            parent = fbl::RefPtr<fs::Vnode>::Downcast(vn);
+        }
+    }
+
+    status = fakeFs.fake_vfs->Unlink(parent, fbl::StringPiece(fn));
+    if (parent != fakeFs.fake_root) {
+        parent->Close();
+    }
+    STATUS(status);
+}
+
 int emu_mkdir(const char* path, mode_t mode) {
     ZX_DEBUG_ASSERT_MSG(!host_path(path), "'emu_' functions can only operate on target paths");
     mode = S_IFDIR;
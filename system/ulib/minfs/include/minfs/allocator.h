@@ -52,6 +52,13 @@ private:
 
     Allocator* allocator_ = nullptr;
     size_t reserved_ = 0;
+
+    // A contiguous run of elements grabbed from the allocator, from which
+    // |Allocate| draws without searching the bitmap. The run is only held
+    // in memory; elements are committed to disk as they are allocated, and
+    // any remainder is returned to the allocator when the promise dies.
+    size_t run_start_ = 0;
+    size_t run_length_ = 0;
 };
 
 // Represents the FVM-related information for the allocator, including
@@ -203,6 +210,20 @@ public:
     // Free an item from the allocator.
     void Free(WriteTxn* txn, size_t index);
 
+    // Advisory free-search cursor, persisted across clean unmounts so a
+    // new session resumes searching where the previous one stopped.
+    size_t GetHint() const { return hint_; }
+    void SetHint(size_t hint) {
+        if (hint < map_.size()) {
+            hint_ = hint;
+        }
+    }
+
+    // Allocation search statistics, for metrics.
+    uint64_t AllocRuns() const { return alloc_runs_; }
+    uint64_t AllocRunUnits() const { return alloc_run_units_; }
+    uint64_t AllocSearchAttempts() const { return alloc_search_attempts_; }
+
 private:
     friend class MinfsChecker;
     friend class AllocatorPromise;
@@ -213,8 +234,18 @@ private:
     // Extend the on-disk extent containing map_.
     zx_status_t Extend(WriteTxn* txn);
 
-    // Allocate an element and return the newly allocated index.
-    size_t Allocate(WriteTxn* txn);
+    // Optimistically grab a contiguous run of up to |max_length| free
+    // elements for an AllocatorPromise, marking them in the in-memory map
+    // only. |max_length| must not exceed the caller's reservation.
+    void GrabRun(size_t max_length, size_t* out_start, size_t* out_length);
+
+    // Commit the allocation of a single element previously grabbed by
+    // |GrabRun| to disk.
+    void CommitElement(WriteTxn* txn, size_t index);
+
+    // Return the unused portion of a grabbed run. Since the elements were
+    // never committed, this only updates the in-memory map.
+    void ReleaseRun(size_t start, size_t length);
 
     // Write back the allocation of the following items to disk.
     void Persist(WriteTxn* txn, size_t index, size_t count);
@@ -238,6 +269,11 @@ private:
 
     size_t reserved_;
     size_t hint_;
+
+    // Allocation search statistics.
+    uint64_t alloc_runs_ = 0;
+    uint64_t alloc_run_units_ = 0;
+    uint64_t alloc_search_attempts_ = 0;
 };
 
 } // namespace minfs
@@ -67,6 +67,11 @@ public:
     zx_status_t Readblk(blk_t bno, void* data);
     zx_status_t Writeblk(blk_t bno, const void* data);
 
+    // Number of Readblk calls serviced from the readahead buffer, and the
+    // number which had to go to the underlying device.
+    uint64_t ReadaheadHits() const { return readahead_hits_; }
+    uint64_t ReadaheadMisses() const { return readahead_misses_; }
+
     ////////////////
     // Other methods.
 
@@ -135,6 +140,22 @@ public:
 private:
     Bcache(fbl::unique_fd fd, uint32_t blockmax);
 
+    // Issues a read of |count| blocks starting at |bno| from the underlying
+    // device, bypassing the readahead buffer.
+    zx_status_t ReadRange(blk_t bno, uint32_t count, void* data);
+
+    // Readblk detects sequential access and prefetches a window of
+    // |kReadaheadBlocks| into |readahead_data_|, servicing subsequent reads
+    // of those blocks from memory. Writeblk drops the window if it overlaps
+    // the written block.
+    static constexpr uint32_t kReadaheadBlocks = 8;
+    fbl::unique_ptr<uint8_t[]> readahead_data_;
+    blk_t readahead_start_{};   // First block held in |readahead_data_|
+    uint32_t readahead_len_{};  // Number of valid blocks in |readahead_data_|
+    blk_t last_read_bno_{};     // Target of the previous Readblk call
+    uint64_t readahead_hits_{};
+    uint64_t readahead_misses_{};
+
 #ifdef __Fuchsia__
     block_client::Client fifo_client_{}; // Fast path to interact with block device
     block_info_t info_{};
@@ -42,6 +42,12 @@ public:
 
     fbl::Vector<write_request_t>& Requests() { return requests_; }
 
+    // Appends the enqueued requests to |out| as block device requests
+    // reading from the |vmoid| buffer (converted to disk blocks), and
+    // clears the transaction. Used when several transactions are submitted
+    // to the device as a single batch.
+    void AppendRequests(vmoid_t vmoid, fbl::Vector<block_fifo_request_t>* out);
+
     size_t BlkCount() const;
 
 protected:
@@ -33,10 +33,10 @@ typedef uint32_t ino_t;
 
 constexpr uint64_t kMinfsMagic0         = (0x002153466e694d21ULL);
 constexpr uint64_t kMinfsMagic1         = (0x385000d3d3d3d304ULL);
-constexpr uint32_t kMinfsVersion        = 0x00000005;
+constexpr uint32_t kMinfsVersion        = 0x00000006;
 
 constexpr ino_t    kMinfsRootIno        = 1;
-constexpr uint32_t kMinfsFlagClean      = 0x00000001; // Currently unused
+constexpr uint32_t kMinfsFlagClean      = 0x00000001; // Set on clean unmount, cleared while mounted
 constexpr uint32_t kMinfsFlagFVM        = 0x00000002; // Mounted on FVM
 constexpr uint32_t kMinfsBlockSize      = 8192;
 constexpr uint32_t kMinfsBlockBits      = (kMinfsBlockSize * 8);
@@ -71,10 +71,26 @@ constexpr uint32_t MinfsMagicType(uint32_t n) { return n & 0xFF; }
 constexpr size_t kFVMBlockInodeBmStart = 0x10000;
 constexpr size_t kFVMBlockDataBmStart  = 0x20000;
 constexpr size_t kFVMBlockInodeStart   = 0x30000;
-constexpr size_t kFVMBlockDataStart    = 0x40000;
+constexpr size_t kFVMBlockJournalStart = 0x40000;
+constexpr size_t kFVMBlockDataStart    = 0x50000;
 
 constexpr uint64_t kMinfsDefaultInodeCount = 32768;
 
+// Metadata journal. The journal region sits between the inode table and
+// the data blocks, and consists of an info block followed by the entry
+// area. At most one entry is live at a time: the entry area holds a
+// header block (listing the target block of each payload block, plus a
+// checksum over the payload) followed by the payload blocks themselves.
+// The info block names the sequence number of the entry which is fully
+// on disk and not yet known to have landed in-place; on mount, a
+// matching, checksummed entry is replayed.
+constexpr uint64_t kMinfsJournalMagic      = (0x6c6e726a53466e6dULL);
+constexpr blk_t    kJournalNumInfoBlocks   = 1;
+constexpr blk_t    kJournalNumEntryBlocks  = 127;
+constexpr blk_t    kJournalNumBlocks       = kJournalNumInfoBlocks + kJournalNumEntryBlocks;
+// One block of each entry is consumed by the header.
+constexpr blk_t    kJournalEntryMaxBlocks  = kJournalNumEntryBlocks - 1;
+
 typedef struct {
     uint64_t magic0;
     uint64_t magic1;
@@ -89,6 +105,7 @@ typedef struct {
     blk_t ibm_block;     // first blockno of inode allocation bitmap
     blk_t abm_block;     // first blockno of block allocation bitmap
     blk_t ino_block;     // first blockno of inode table
+    blk_t jnl_block;     // first blockno of journal
     blk_t dat_block;     // first blockno available for file data
     // The following flags are only valid with (flags & kMinfsFlagFVM):
     uint64_t slice_size;    // Underlying slice size
@@ -96,11 +113,19 @@ typedef struct {
     uint32_t ibm_slices;    // Slices allocated to inode bitmap
     uint32_t abm_slices;    // Slices allocated to block bitmap
     uint32_t ino_slices;    // Slices allocated to inode table
+    uint32_t jnl_slices;    // Slices allocated to journal
     uint32_t dat_slices;    // Slices allocated to file data section
+    // Allocator summaries persisted on clean unmount (kMinfsFlagClean
+    // set), letting the next mount resume allocation where the previous
+    // session stopped.  Purely advisory: a stale or zero cursor costs an
+    // extra bitmap search, never correctness, so these read back as zero
+    // from images written before the fields existed.
+    uint32_t abm_hint;      // free-search cursor into the block bitmap
+    uint32_t ibm_hint;      // free-search cursor into the inode bitmap
 } minfs_info_t;
 
 // Notes:
-// - the ibm, abm, ino, and dat regions must be in that order
+// - the ibm, abm, ino, jnl, and dat regions must be in that order
 //   and may not overlap
 // - the abm has an entry for every block on the volume, including
 //   the info block (0), the bitmaps, etc
@@ -132,6 +157,25 @@ typedef struct {
 static_assert(sizeof(minfs_inode_t) == kMinfsInodeSize,
               "minfs inode size is wrong");
 
+typedef struct {
+    uint64_t magic;      // kMinfsJournalMagic
+    uint64_t sequence;   // Sequence number of the pending entry; 0 if none
+    uint32_t checksum;   // crc32 of this structure, with checksum set to 0
+    uint32_t reserved;
+} minfs_journal_info_t;
+
+typedef struct {
+    uint64_t magic;      // kMinfsJournalMagic
+    uint64_t sequence;   // Must match the sequence of the journal info block
+    uint32_t num_blocks; // Number of payload blocks following this header
+    uint32_t checksum;   // crc32 of the payload blocks
+    // In-place destination of each payload block, as an absolute blockno.
+    blk_t target_blocks[kJournalEntryMaxBlocks];
+} minfs_journal_entry_header_t;
+
+static_assert(sizeof(minfs_journal_entry_header_t) <= kMinfsBlockSize,
+              "minfs journal entry header must fit in one block");
+
 typedef struct {
     ino_t ino;                      // inode number
     uint32_t reclen;                // Low 28 bits: Length of record
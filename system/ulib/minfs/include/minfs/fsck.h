@@ -31,7 +31,7 @@ zx_status_t minfs_check(fbl::unique_ptr<Bcache> bc);
 // |start| indicates where the minfs partition starts within the file (in bytes)
 // |end| indicates the end of the minfs partition (in bytes)
 // |extent_lengths| contains the length (in bytes) of each minfs extent: currently this includes
-// the superblock, inode bitmap, block bitmap, inode table, and data blocks.
+// the superblock, inode bitmap, block bitmap, inode table, journal, and data blocks.
 zx_status_t minfs_fsck(fbl::unique_fd fd, off_t start, off_t end,
                        const fbl::Vector<size_t>& extent_lengths);
 #endif
@@ -50,6 +50,8 @@ off_t emu_lseek(int fd, off_t offset, int whence);
 int emu_fstat(int fd, struct stat* s);
 int emu_stat(const char* fn, struct stat* s);
 
+int emu_unlink(const char* path);
+
 int emu_mkdir(const char* path, mode_t mode);
 DIR* emu_opendir(const char* name);
 struct dirent* emu_readdir(DIR* dirp);
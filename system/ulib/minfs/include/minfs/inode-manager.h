@@ -44,6 +44,10 @@ public:
         inode_allocator_->Free(txn, index);
     }
 
+    // Advisory free-search cursor of the inode allocator.
+    size_t GetHint() const { return inode_allocator_->GetHint(); }
+    void SetHint(size_t hint) { inode_allocator_->SetHint(hint); }
+
     // Persist the inode to storage.
     void Update(WriteTxn* txn, ino_t ino, const minfs_inode_t* inode);
 
@@ -61,11 +65,25 @@ private:
 
     InodeManager(Bcache* bc, blk_t start_block);
 
+#ifndef __Fuchsia__
+    // Fault the block of the inode table containing |inoblock_rel| into the
+    // in-memory cache, if it is not resident already.
+    void LoadInodeBlock(blk_t inoblock_rel) const;
+#endif
+
     Bcache* bc_;
     blk_t start_block_;
     fbl::unique_ptr<Allocator> inode_allocator_;
 #ifdef __Fuchsia__
     fbl::unique_ptr<fzl::MappedVmo> inode_table_{};
+#else
+    // In-memory cache of the inode table, faulted in from the Bcache one
+    // block at a time. Loads are served from the cache and updates are
+    // written through it, so repeated access to the same inode block does
+    // not re-read it from the device. This mirrors the mapped VMO used as
+    // the table on the target.
+    mutable fbl::unique_ptr<uint8_t[]> inode_table_{};
+    mutable RawBitmap cached_blocks_{};
 #endif
 };
 
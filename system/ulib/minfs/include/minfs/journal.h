@@ -0,0 +1,87 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <fbl/macros.h>
+#include <fbl/unique_ptr.h>
+
+#include <minfs/bcache.h>
+#include <minfs/format.h>
+
+#ifdef __Fuchsia__
+#include <lib/fzl/mapped-vmo.h>
+#endif
+
+namespace minfs {
+
+// Replays any journal entry left behind by a crash, re-applying its
+// payload blocks in-place, and leaves the journal clean. Must be invoked
+// before any other filesystem structures are read from |bc|, since the
+// on-disk metadata is not trustworthy until the log has been applied.
+zx_status_t ReplayJournal(Bcache* bc, const minfs_info_t* info);
+
+// Formats the journal region starting at |start_block| as clean. Used by
+// mkfs.
+zx_status_t MkfsJournal(Bcache* bc, blk_t start_block);
+
+#ifdef __Fuchsia__
+
+// Journal writes groups of metadata updates to a write-ahead log before
+// they are issued in-place, providing crash consistency for the
+// writeback path: after a crash, a committed group is either fully
+// replayed from the log or (if it never committed) ignored entirely.
+//
+// Each committed group becomes one log entry: a header block recording
+// the in-place destination of every payload block and a checksum over
+// the payload, followed by the payload blocks themselves. The info block
+// at the start of the journal region names the entry which may need
+// replay. Only one entry is live at a time; committing a group waits for
+// its in-place writes to be durable before the entry area is reused.
+class Journal {
+public:
+    DISALLOW_COPY_ASSIGN_AND_MOVE(Journal);
+    ~Journal();
+
+    // Creates a journal which logs to the |kJournalNumBlocks| blocks
+    // starting at |start_block|.
+    static zx_status_t Create(Bcache* bc, blk_t start_block,
+                              fbl::unique_ptr<Journal>* out);
+
+    // Logs the write requests of one writeback group, then issues them
+    // in-place. |reqs| must all read from the (mapped) writeback buffer
+    // |wb_data|, in disk-block units. Groups larger than
+    // |kJournalEntryMaxBlocks| are committed as several entries.
+    zx_status_t CommitGroup(block_fifo_request_t* reqs, size_t count,
+                            const void* wb_data);
+
+    // Marks the journal clean, so the next mount has nothing to replay.
+    // Callers must ensure all logged writes have already landed in-place.
+    zx_status_t MarkClean();
+
+private:
+    Journal(Bcache* bc, blk_t start_block, fbl::unique_ptr<fzl::MappedVmo> buffer);
+
+    // Commits a single log entry of |payload_blocks| Minfs blocks.
+    zx_status_t CommitEntry(block_fifo_request_t* reqs, size_t count,
+                            blk_t payload_blocks, const void* wb_data);
+
+    // Writes the journal info block naming |sequence| as the pending entry.
+    zx_status_t WriteInfo(uint64_t sequence);
+
+    // Issues a flush to the underlying block device, ensuring all
+    // previously submitted writes are durable.
+    zx_status_t Flush();
+
+    Bcache* bc_;
+    const blk_t start_block_;
+    uint64_t sequence_ = 0;
+    // Block 0: journal info block. Block 1: entry header staging area.
+    fbl::unique_ptr<fzl::MappedVmo> buffer_;
+    vmoid_t buffer_vmoid_ = VMOID_INVALID;
+};
+
+#endif  // __Fuchsia__
+
+} // namespace minfs
@@ -16,6 +16,7 @@
 #include <fbl/macros.h>
 #include <fbl/ref_ptr.h>
 #include <fbl/unique_ptr.h>
+#include <fbl/vector.h>
 
 #include <fs/queue.h>
 #include <fs/vfs.h>
@@ -25,6 +26,9 @@
 #include <minfs/bcache.h>
 #include <minfs/block-txn.h>
 #include <minfs/format.h>
+#ifdef __Fuchsia__
+#include <minfs/journal.h>
+#endif
 
 namespace minfs {
 
@@ -46,12 +50,11 @@ public:
     void Reset();
 
 #ifdef __Fuchsia__
-    // Actually transacts the enqueued work, and resets the WritebackWork to
-    // its initial state.
-    //
-    // Returns the number of blocks of the writeback buffer that have been
-    // consumed.
-    size_t Complete(zx_handle_t vmo, vmoid_t vmoid);
+    // Signals the sync closure (if any) with |status| and resets the
+    // WritebackWork, without flushing anything. The enqueued requests must
+    // already have been submitted to the device (see
+    // WriteTxn::AppendRequests), as part of a larger batched transaction.
+    void MarkCompleted(zx_status_t status);
 
     // Adds a closure to the WritebackWork, such that it will be signalled
     // when the WritebackWork is flushed to disk.
@@ -128,8 +131,12 @@ private:
 class WritebackBuffer {
 public:
     // Calls constructor, return an error if anything goes wrong.
+    //
+    // If |journal| is non-null, each group of work is logged to the
+    // journal before being written in-place, making the metadata updates
+    // crash-consistent. The journal must outlive the WritebackBuffer.
     static zx_status_t Create(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer,
-                              fbl::unique_ptr<WritebackBuffer>* out);
+                              Journal* journal, fbl::unique_ptr<WritebackBuffer>* out);
     ~WritebackBuffer();
 
     // Enqueues work into the writeback buffer.
@@ -143,7 +150,7 @@ public:
     void Enqueue(fbl::unique_ptr<WritebackWork> work) __TA_EXCLUDES(writeback_lock_);
 
 private:
-    WritebackBuffer(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer);
+    WritebackBuffer(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer, Journal* journal);
 
     // Blocks until |blocks| blocks of data are free for the caller.
     // Returns |ZX_OK| with the lock still held in this case.
@@ -162,6 +169,16 @@ private:
     // safely guarantee that space exists within the buffer.
     void CopyToBufferLocked(WriteTxn* txn) __TA_REQUIRES(writeback_lock_);
 
+    // Submits the requests of all work units in |group| to the underlying
+    // block device as a single sorted batch (group commit), so independent
+    // metadata flushes share one round-trip to the block server and may be
+    // kept in flight concurrently, up to the device queue depth. Signals
+    // the completion closure of each work unit once the batch is on disk.
+    //
+    // Returns the number of blocks of the writeback buffer consumed.
+    size_t CompleteGroup(fbl::Vector<fbl::unique_ptr<WritebackWork>>* group)
+        __TA_EXCLUDES(writeback_lock_);
+
     static int WritebackThread(void* arg);
 
     // The waiter struct may be used as a stack-allocated queue for producers.
@@ -182,6 +199,8 @@ private:
     // writeback buffer.
     thrd_t writeback_thrd_;
     Bcache* bc_;
+    // Write-ahead log for group commits; may be null (no journaling).
+    Journal* journal_;
     fbl::Mutex writeback_lock_;
 
     // Ensures that if multiple producers are waiting for space to write their
@@ -4,6 +4,8 @@
 
 #include <stdlib.h>
 
+#include <fbl/alloc_checker.h>
+
 #include <minfs/block-txn.h>
 #include <minfs/inode-manager.h>
 
@@ -32,9 +34,9 @@ zx_status_t InodeManager::Create(Bcache* bc, Superblock* sb, fs::ReadTxn* txn,
         return status;
     }
 
-#ifdef __Fuchsia__
     uint32_t inoblks = (static_cast<uint32_t>(inodes) + kMinfsInodesPerBlock - 1) /
             kMinfsInodesPerBlock;
+#ifdef __Fuchsia__
     if ((status = fzl::MappedVmo::Create(inoblks * kMinfsBlockSize, "minfs-inode-table",
                                          &mgr->inode_table_)) != ZX_OK) {
         return status;
@@ -45,6 +47,15 @@ zx_status_t InodeManager::Create(Bcache* bc, Superblock* sb, fs::ReadTxn* txn,
         return status;
     }
     txn->Enqueue(vmoid, 0, start_block, inoblks);
+#else
+    fbl::AllocChecker ac;
+    mgr->inode_table_.reset(new (&ac) uint8_t[inoblks * kMinfsBlockSize]);
+    if (!ac.check()) {
+        return ZX_ERR_NO_MEMORY;
+    }
+    if ((status = mgr->cached_blocks_.Reset(inoblks)) != ZX_OK) {
+        return status;
+    }
 #endif
     *out = fbl::move(mgr);
     return ZX_OK;
@@ -62,12 +73,12 @@ void InodeManager::Update(WriteTxn* txn, ino_t ino, const minfs_inode_t* inode)
     memcpy((void*)((uintptr_t)inodata + off_of_ino), inode, kMinfsInodeSize);
     txn->Enqueue(inode_table_->GetVmo(), inoblock_rel, inoblock_abs, 1);
 #else
-    // Since host-side tools don't have "mapped vmos", just read / update /
-    // write the single absolute inode block.
-    uint8_t inodata[kMinfsBlockSize];
-    bc_->Readblk(inoblock_abs, inodata);
+    // Update the cached inode table and write through from it, rather than
+    // re-reading the block from the device to modify it.
+    LoadInodeBlock(inoblock_rel);
+    void* inodata = fs::GetBlock(kMinfsBlockSize, inode_table_.get(), inoblock_rel);
     memcpy((void*)((uintptr_t)inodata + off_of_ino), inode, kMinfsInodeSize);
-    bc_->Writeblk(inoblock_abs, inodata);
+    txn->Enqueue(inode_table_.get(), inoblock_rel, inoblock_abs, 1);
 #endif
 }
 
@@ -78,14 +89,26 @@ void InodeManager::Load(ino_t ino, minfs_inode_t* out) const {
     void* inodata = (void*)((uintptr_t)(inode_table_->GetData()) +
                             (uintptr_t)((ino / kMinfsInodesPerBlock) * kMinfsBlockSize));
 #else
-    uint8_t inodata[kMinfsBlockSize];
-    bc_->Readblk(start_block_ + (ino / kMinfsInodesPerBlock), inodata);
+    LoadInodeBlock(ino / kMinfsInodesPerBlock);
+    const void* inodata = fs::GetBlock(kMinfsBlockSize, inode_table_.get(),
+                                       ino / kMinfsInodesPerBlock);
 #endif
     const minfs_inode_t* inode = reinterpret_cast<const minfs_inode_t*>((uintptr_t)inodata +
                                                                         off_of_ino);
     memcpy(out, inode, kMinfsInodeSize);
 }
 
+#ifndef __Fuchsia__
+void InodeManager::LoadInodeBlock(blk_t inoblock_rel) const {
+    if (cached_blocks_.Get(inoblock_rel, inoblock_rel + 1)) {
+        return;
+    }
+    bc_->Readblk(start_block_ + inoblock_rel,
+                 fs::GetBlock(kMinfsBlockSize, inode_table_.get(), inoblock_rel));
+    ZX_ASSERT(cached_blocks_.Set(inoblock_rel, inoblock_rel + 1) == ZX_OK);
+}
+#endif
+
 zx_status_t InodeManager::Grow(size_t inodes) {
 #ifdef __Fuchsia__
     uint32_t inoblks = (static_cast<uint32_t>(inodes) + kMinfsInodesPerBlock - 1) /
@@ -0,0 +1,326 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/unique_ptr.h>
+#include <fs/trace.h>
+#include <lib/cksum.h>
+
+#include "minfs-private.h"
+#include <minfs/journal.h>
+
+namespace minfs {
+
+namespace {
+
+uint32_t JournalInfoChecksum(const minfs_journal_info_t* info) {
+    minfs_journal_info_t copy = *info;
+    copy.checksum = 0;
+    return crc32(0, reinterpret_cast<const uint8_t*>(&copy), sizeof(copy));
+}
+
+} // namespace
+
+zx_status_t MkfsJournal(Bcache* bc, blk_t start_block) {
+    char blk[kMinfsBlockSize];
+    memset(blk, 0, sizeof(blk));
+    minfs_journal_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.magic = kMinfsJournalMagic;
+    info.sequence = 0;
+    info.checksum = JournalInfoChecksum(&info);
+    memcpy(blk, &info, sizeof(info));
+    return bc->Writeblk(start_block, blk);
+}
+
+zx_status_t ReplayJournal(Bcache* bc, const minfs_info_t* info) {
+    if ((info->magic0 != kMinfsMagic0) || (info->magic1 != kMinfsMagic1)) {
+        // Not a minfs partition; let the mount path report the error.
+        return ZX_OK;
+    }
+    const blk_t jnl_block = info->jnl_block;
+
+    char blk[kMinfsBlockSize];
+    zx_status_t status;
+    if ((status = bc->Readblk(jnl_block, blk)) != ZX_OK) {
+        FS_TRACE_ERROR("minfs: journal: could not read info block\n");
+        return status;
+    }
+    minfs_journal_info_t jnl_info;
+    memcpy(&jnl_info, blk, sizeof(jnl_info));
+
+    if (jnl_info.magic != kMinfsJournalMagic ||
+        jnl_info.checksum != JournalInfoChecksum(&jnl_info)) {
+        // The journal info block never landed intact; there cannot be a
+        // committed entry, so just reformat it.
+        FS_TRACE_WARN("minfs: journal: reinitializing invalid info block\n");
+        jnl_info.sequence = 0;
+    } else if (jnl_info.sequence == 0) {
+        // Journal is clean.
+        return ZX_OK;
+    } else {
+        // Validate the entry named by the info block before replaying it.
+        if ((status = bc->Readblk(jnl_block + kJournalNumInfoBlocks, blk)) != ZX_OK) {
+            FS_TRACE_ERROR("minfs: journal: could not read entry header\n");
+            return status;
+        }
+        minfs_journal_entry_header_t header;
+        memcpy(&header, blk, sizeof(header));
+
+        if (header.magic != kMinfsJournalMagic ||
+            header.sequence != jnl_info.sequence ||
+            header.num_blocks > kJournalEntryMaxBlocks) {
+            // The entry never committed; the in-place writes were never
+            // issued, so there is nothing to replay.
+            jnl_info.sequence = 0;
+        } else {
+            uint32_t checksum = 0;
+            for (uint32_t n = 0; n < header.num_blocks; n++) {
+                blk_t bno = jnl_block + kJournalNumInfoBlocks + 1 + n;
+                if ((status = bc->Readblk(bno, blk)) != ZX_OK) {
+                    FS_TRACE_ERROR("minfs: journal: could not read payload\n");
+                    return status;
+                }
+                checksum = crc32(checksum, reinterpret_cast<const uint8_t*>(blk),
+                                 kMinfsBlockSize);
+            }
+
+            if (checksum != header.checksum) {
+                // Torn entry; never committed.
+                jnl_info.sequence = 0;
+            } else {
+                FS_TRACE_WARN("minfs: journal: replaying entry %" PRIu64
+                              " (%u blocks)\n", header.sequence, header.num_blocks);
+                for (uint32_t n = 0; n < header.num_blocks; n++) {
+                    blk_t bno = jnl_block + kJournalNumInfoBlocks + 1 + n;
+                    if ((status = bc->Readblk(bno, blk)) != ZX_OK) {
+                        return status;
+                    }
+                    if (header.target_blocks[n] >= bc->Maxblk()) {
+                        FS_TRACE_ERROR("minfs: journal: invalid target block\n");
+                        return ZX_ERR_IO_DATA_INTEGRITY;
+                    }
+                    if ((status = bc->Writeblk(header.target_blocks[n], blk)) != ZX_OK) {
+                        return status;
+                    }
+                }
+                jnl_info.sequence = header.sequence;
+            }
+        }
+    }
+
+    // Mark the journal clean, preserving the sequence so future entries
+    // are never confused with the one just replayed.
+    jnl_info.magic = kMinfsJournalMagic;
+    uint64_t sequence = jnl_info.sequence;
+    jnl_info.sequence = 0;
+    jnl_info.reserved = static_cast<uint32_t>(sequence);
+    jnl_info.checksum = JournalInfoChecksum(&jnl_info);
+    memset(blk, 0, sizeof(blk));
+    memcpy(blk, &jnl_info, sizeof(jnl_info));
+    if ((status = bc->Writeblk(jnl_block, blk)) != ZX_OK) {
+        FS_TRACE_ERROR("minfs: journal: could not clean info block\n");
+        return status;
+    }
+    bc->Sync();
+    return ZX_OK;
+}
+
+#ifdef __Fuchsia__
+
+Journal::Journal(Bcache* bc, blk_t start_block, fbl::unique_ptr<fzl::MappedVmo> buffer)
+    : bc_(bc), start_block_(start_block), buffer_(fbl::move(buffer)) {}
+
+Journal::~Journal() {
+    if (buffer_vmoid_ != VMOID_INVALID) {
+        block_fifo_request_t request;
+        request.group = bc_->BlockGroupID();
+        request.vmoid = buffer_vmoid_;
+        request.opcode = BLOCKIO_CLOSE_VMO;
+        bc_->Transaction(&request, 1);
+    }
+}
+
+zx_status_t Journal::Create(Bcache* bc, blk_t start_block,
+                            fbl::unique_ptr<Journal>* out) {
+    fbl::unique_ptr<fzl::MappedVmo> buffer;
+    zx_status_t status;
+    if ((status = fzl::MappedVmo::Create(2 * kMinfsBlockSize, "minfs-journal",
+                                         &buffer)) != ZX_OK) {
+        return status;
+    }
+    fbl::unique_ptr<Journal> journal(new Journal(bc, start_block, fbl::move(buffer)));
+    if ((status = bc->AttachVmo(journal->buffer_->GetVmo(),
+                                &journal->buffer_vmoid_)) != ZX_OK) {
+        return status;
+    }
+
+    // Pick up the sequence the replayed (or freshly made) journal left off at.
+    char blk[kMinfsBlockSize];
+    if ((status = bc->Readblk(start_block, blk)) != ZX_OK) {
+        return status;
+    }
+    minfs_journal_info_t info;
+    memcpy(&info, blk, sizeof(info));
+    if (info.magic == kMinfsJournalMagic &&
+        info.checksum == JournalInfoChecksum(&info)) {
+        journal->sequence_ = (info.sequence != 0) ? info.sequence : info.reserved;
+    }
+
+    *out = fbl::move(journal);
+    return ZX_OK;
+}
+
+zx_status_t Journal::Flush() {
+    block_fifo_request_t request;
+    request.group = bc_->BlockGroupID();
+    request.vmoid = buffer_vmoid_;
+    request.opcode = BLOCKIO_FLUSH;
+    return bc_->Transaction(&request, 1);
+}
+
+zx_status_t Journal::WriteInfo(uint64_t sequence) {
+    auto info = reinterpret_cast<minfs_journal_info_t*>(buffer_->GetData());
+    memset(info, 0, kMinfsBlockSize);
+    info->magic = kMinfsJournalMagic;
+    info->sequence = sequence;
+    info->reserved = static_cast<uint32_t>(sequence_);
+    info->checksum = JournalInfoChecksum(info);
+
+    const uint32_t kDiskBlocksPerMinfsBlock = kMinfsBlockSize / bc_->DeviceBlockSize();
+    block_fifo_request_t request;
+    request.group = bc_->BlockGroupID();
+    request.vmoid = buffer_vmoid_;
+    request.opcode = BLOCKIO_WRITE;
+    request.vmo_offset = 0;
+    request.dev_offset = start_block_ * kDiskBlocksPerMinfsBlock;
+    request.length = kDiskBlocksPerMinfsBlock;
+    zx_status_t status = bc_->Transaction(&request, 1);
+    if (status != ZX_OK) {
+        return status;
+    }
+    return Flush();
+}
+
+zx_status_t Journal::MarkClean() {
+    return WriteInfo(0);
+}
+
+zx_status_t Journal::CommitEntry(block_fifo_request_t* reqs, size_t count,
+                                 blk_t payload_blocks, const void* wb_data) {
+    ZX_DEBUG_ASSERT(payload_blocks <= kJournalEntryMaxBlocks);
+    const uint32_t kDiskBlocksPerMinfsBlock = kMinfsBlockSize / bc_->DeviceBlockSize();
+    const uint32_t kDeviceBlockSize = bc_->DeviceBlockSize();
+
+    sequence_++;
+    auto header = reinterpret_cast<minfs_journal_entry_header_t*>(
+        static_cast<uint8_t*>(buffer_->GetData()) + kMinfsBlockSize);
+    memset(header, 0, kMinfsBlockSize);
+    header->magic = kMinfsJournalMagic;
+    header->sequence = sequence_;
+    header->num_blocks = payload_blocks;
+
+    // Log writes: the payload is written straight out of the writeback
+    // buffer, followed by the header block describing it.
+    fbl::Vector<block_fifo_request_t> log_reqs;
+    uint32_t checksum = 0;
+    blk_t log_block = start_block_ + kJournalNumInfoBlocks + 1;
+    blk_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        blk_t nblocks = reqs[i].length / kDiskBlocksPerMinfsBlock;
+        for (blk_t n = 0; n < nblocks; n++) {
+            header->target_blocks[pos + n] =
+                static_cast<blk_t>(reqs[i].dev_offset / kDiskBlocksPerMinfsBlock) + n;
+        }
+        checksum = crc32(checksum,
+                         static_cast<const uint8_t*>(wb_data) +
+                             reqs[i].vmo_offset * kDeviceBlockSize,
+                         reqs[i].length * kDeviceBlockSize);
+
+        block_fifo_request_t log_req = reqs[i];
+        log_req.dev_offset = (log_block + pos) * kDiskBlocksPerMinfsBlock;
+        log_reqs.push_back(log_req);
+        pos += nblocks;
+    }
+    ZX_DEBUG_ASSERT(pos == payload_blocks);
+    header->checksum = checksum;
+
+    block_fifo_request_t header_req;
+    header_req.group = bc_->BlockGroupID();
+    header_req.vmoid = buffer_vmoid_;
+    header_req.opcode = BLOCKIO_WRITE;
+    header_req.vmo_offset = kDiskBlocksPerMinfsBlock;
+    header_req.dev_offset = (start_block_ + kJournalNumInfoBlocks) * kDiskBlocksPerMinfsBlock;
+    header_req.length = kDiskBlocksPerMinfsBlock;
+    log_reqs.push_back(header_req);
+
+    zx_status_t status;
+    if ((status = bc_->Transaction(log_reqs.get(), log_reqs.size())) != ZX_OK) {
+        return status;
+    }
+    if ((status = Flush()) != ZX_OK) {
+        return status;
+    }
+
+    // Commit: once the info block names this entry, a crash replays it.
+    if ((status = WriteInfo(sequence_)) != ZX_OK) {
+        return status;
+    }
+
+    // Now the in-place writes themselves.
+    if ((status = bc_->Transaction(reqs, count)) != ZX_OK) {
+        return status;
+    }
+    return Flush();
+}
+
+zx_status_t Journal::CommitGroup(block_fifo_request_t* reqs, size_t count,
+                                 const void* wb_data) {
+    const uint32_t kDiskBlocksPerMinfsBlock = kMinfsBlockSize / bc_->DeviceBlockSize();
+
+    size_t i = 0;
+    while (i < count) {
+        // Take as many requests as fit in one log entry, splitting a
+        // request at the entry boundary if necessary.
+        size_t first = i;
+        blk_t payload_blocks = 0;
+        block_fifo_request_t remainder = {};
+        bool split = false;
+        while (i < count) {
+            blk_t nblocks = reqs[i].length / kDiskBlocksPerMinfsBlock;
+            if (payload_blocks + nblocks > kJournalEntryMaxBlocks) {
+                blk_t take = kJournalEntryMaxBlocks - payload_blocks;
+                if (take > 0) {
+                    remainder = reqs[i];
+                    remainder.vmo_offset += take * kDiskBlocksPerMinfsBlock;
+                    remainder.dev_offset += take * kDiskBlocksPerMinfsBlock;
+                    remainder.length -= take * kDiskBlocksPerMinfsBlock;
+                    reqs[i].length = take * kDiskBlocksPerMinfsBlock;
+                    payload_blocks += take;
+                    split = true;
+                    i++;
+                }
+                break;
+            }
+            payload_blocks += nblocks;
+            i++;
+        }
+
+        zx_status_t status = CommitEntry(&reqs[first], i - first, payload_blocks, wb_data);
+        if (status != ZX_OK) {
+            return status;
+        }
+        if (split) {
+            // Process the tail of the split request in the next entry.
+            i--;
+            reqs[i] = remainder;
+        }
+    }
+    return ZX_OK;
+}
+
+#endif  // __Fuchsia__
+
+} // namespace minfs
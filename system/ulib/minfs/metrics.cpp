@@ -44,6 +44,13 @@ void MinfsMetrics::Dump() const {
            vnodes_opened_cache_hit, vnodes_opened, TicksToMs(vnode_open_ticks));
     printf("  %zu / %zu Lookup (lookup by path) successful calls, %zu ms\n",
            lookup_calls_success, lookup_calls, TicksToMs(lookup_ticks));
+    printf("Bcache stats:\n");
+    printf("  %zu / %zu readahead cache hits\n",
+           readahead_hits, readahead_hits + readahead_misses);
+    printf("Block allocator stats:\n");
+    printf("  %zu contiguous runs grabbed, covering %zu blocks\n",
+           alloc_runs, alloc_run_units);
+    printf("  %zu bitmap searches to grab those runs\n", alloc_search_attempts);
 }
 
 } // namespace minfs
@@ -66,6 +66,21 @@ struct MinfsMetrics {
     uint64_t lookup_calls_success = 0;
     zx::ticks lookup_ticks = {};
 
+    // BCACHE STATS
+
+    // Readahead behavior of the raw block path; snapshotted from the Bcache
+    // when metrics are dumped.
+    uint64_t readahead_hits = 0;
+    uint64_t readahead_misses = 0;
+
+    // BLOCK ALLOCATOR STATS
+
+    // Bitmap search behavior of the block allocator; snapshotted from the
+    // Allocator when metrics are dumped.
+    uint64_t alloc_runs = 0;
+    uint64_t alloc_run_units = 0;
+    uint64_t alloc_search_attempts = 0;
+
     // FVM STATS
     // TODO(smklein)
 };
@@ -46,7 +46,7 @@
 #include "metrics.h"
 #endif
 
-#define EXTENT_COUNT 5
+#define EXTENT_COUNT 6
 
 // A compile-time debug check, which, if enabled, causes
 // inline functions to be expanded to error checking code.
@@ -191,6 +191,13 @@ public:
     void SetUnmountCallback(fbl::Closure closure) { on_unmount_ = fbl::move(closure); }
     void Shutdown(fs::Vfs::ShutdownCallback cb) final;
 
+    // Clears the clean flag on the superblock for the duration of this
+    // session; a crash then leaves the volume marked dirty.  Shutdown()
+    // restores the flag (and persists the allocation cursors) once all
+    // writes have landed.  Not called for read-only mounts, which must
+    // leave the on-disk state untouched.
+    void MarkDirty();
+
     // Returns a unique identifier for this instance.
     uint64_t GetFsId() const { return fs_id_; }
 
@@ -231,7 +238,7 @@ public:
     // Update aggregate information about renaming Vnodes.
     void UpdateRenameMetrics(bool success, const fs::Duration& duration);
     // Print information about filesystem metrics.
-    void DumpMetrics() const;
+    void DumpMetrics();
 
     // Return an immutable reference to a copy of the internal info.
     const minfs_info_t& Info() const {
@@ -250,6 +257,7 @@ private:
     Minfs(fbl::unique_ptr<Bcache> bc, fbl::unique_ptr<Superblock> sb,
           fbl::unique_ptr<Allocator> block_allocator,
           fbl::unique_ptr<InodeManager> inodes,
+          fbl::unique_ptr<Journal> journal,
           fbl::unique_ptr<WritebackBuffer> writeback,
           uint64_t fs_id);
 #else
@@ -288,8 +296,13 @@ private:
 #ifdef __Fuchsia__
     fbl::Closure on_unmount_{};
     MinfsMetrics metrics_ = {};
+    // The journal must outlive the writeback buffer, which logs to it.
+    fbl::unique_ptr<Journal> journal_;
     fbl::unique_ptr<WritebackBuffer> writeback_;
     uint64_t fs_id_{};
+    // Set by MarkDirty(); tells Shutdown() that this session owns the
+    // clean flag and must restore it.
+    bool clean_managed_ = false;
 #else
     // Store start block + length for all extents. These may differ from info block for
     // sparse files.
@@ -577,7 +590,9 @@ private:
 
     // Get the disk block 'bno' corresponding to the 'n' block
     // If 'txn' is non-null, new blocks are allocated for all un-allocated bnos.
-    // This can be extended to retrieve multiple contiguous blocks in one call
+    // Read-only lookups resolve a whole run of contiguous blocks per walk of
+    // the block map and cache it in |extent_|, so sequential access over large
+    // files does not pay the indirect traversal for every block.
     zx_status_t BlockGet(Transaction* state, blk_t n, blk_t* bno);
     // Deletes all blocks (relative to a file) from "start" (inclusive) to the end
     // of the file. Does not update mtime/atime.
@@ -658,8 +673,22 @@ private:
     fs::WatcherContainer watcher_{};
 #endif
 
+    // Maximum number of blocks resolved by a single walk of the block map on
+    // behalf of a read-only BlockGet lookup.
+    static constexpr blk_t kMaxExtentBlocks = 32;
+
+    // The most recently resolved extent of the file's block map. |count| of
+    // zero means no extent is cached; |dev_block| of zero describes a hole (a
+    // run of unallocated blocks). Invalidated whenever the block map changes.
+    struct BlockExtent {
+        blk_t file_block; // First file-relative block covered by the extent
+        blk_t dev_block;  // Disk block (relative to dat_block) backing |file_block|
+        blk_t count;      // Number of contiguous blocks described
+    };
+
     ino_t ino_{};
     minfs_inode_t inode_{};
+    BlockExtent extent_{};
 
     // This field tracks the current number of file descriptors with
     // an open reference to this Vnode. Notably, this is distinct from the
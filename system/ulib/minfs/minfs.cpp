@@ -29,6 +29,7 @@
 #endif
 
 #include <minfs/fsck.h>
+#include <minfs/journal.h>
 #include <minfs/minfs.h>
 
 #include "minfs-private.h"
@@ -66,6 +67,11 @@ void minfs_free_slices(Bcache* bc, const minfs_info_t* info) {
         request.offset = kFVMBlockInodeStart / kBlocksPerSlice;
         bc->FVMShrink(&request);
     }
+    if (info->jnl_slices) {
+        request.length = info->jnl_slices;
+        request.offset = kFVMBlockJournalStart / kBlocksPerSlice;
+        bc->FVMShrink(&request);
+    }
     if (info->dat_slices) {
         request.length = info->dat_slices;
         request.offset = kFVMBlockDataStart / kBlocksPerSlice;
@@ -84,6 +90,7 @@ void minfs_dump_info(const minfs_info_t* info) {
     xprintf("minfs: inode bitmap @ %10u\n", info->ibm_block);
     xprintf("minfs: alloc bitmap @ %10u\n", info->abm_block);
     xprintf("minfs: inode table  @ %10u\n", info->ino_block);
+    xprintf("minfs: journal      @ %10u\n", info->jnl_block);
     xprintf("minfs: data blocks  @ %10u\n", info->dat_block);
     xprintf("minfs: FVM-aware: %s\n", (info->flags & kMinfsFlagFVM) ? "YES" : "NO");
 }
@@ -131,18 +138,20 @@ zx_status_t minfs_check_info(const minfs_info_t* info, Bcache* bc) {
             return ZX_ERR_BAD_STATE;
         }
 
-        size_t expected_count[4];
+        size_t expected_count[5];
         expected_count[0] = info->ibm_slices;
         expected_count[1] = info->abm_slices;
         expected_count[2] = info->ino_slices;
-        expected_count[3] = info->dat_slices;
+        expected_count[3] = info->jnl_slices;
+        expected_count[4] = info->dat_slices;
 
         query_request_t request;
-        request.count = 4;
+        request.count = 5;
         request.vslice_start[0] = kFVMBlockInodeBmStart / kBlocksPerSlice;
         request.vslice_start[1] = kFVMBlockDataBmStart / kBlocksPerSlice;
         request.vslice_start[2] = kFVMBlockInodeStart / kBlocksPerSlice;
-        request.vslice_start[3] = kFVMBlockDataStart / kBlocksPerSlice;
+        request.vslice_start[3] = kFVMBlockJournalStart / kBlocksPerSlice;
+        request.vslice_start[4] = kFVMBlockDataStart / kBlocksPerSlice;
 
         query_response_t response;
 
@@ -209,8 +218,17 @@ zx_status_t minfs_check_info(const minfs_info_t* info, Bcache* bc) {
         if (ino_blocks_needed > ino_blocks_allocated) {
             FS_TRACE_ERROR("minfs: Not enough slices for inode table\n");
             return ZX_ERR_INVALID_ARGS;
-        } else if (ino_blocks_allocated + info->ino_block >= info->dat_block) {
-            FS_TRACE_ERROR("minfs: Inode table collides with data blocks\n");
+        } else if (ino_blocks_allocated + info->ino_block >= info->jnl_block) {
+            FS_TRACE_ERROR("minfs: Inode table collides with journal\n");
+            return ZX_ERR_INVALID_ARGS;
+        }
+        size_t jnl_blocks_needed = kJournalNumBlocks;
+        size_t jnl_blocks_allocated = info->jnl_slices * kBlocksPerSlice;
+        if (jnl_blocks_needed > jnl_blocks_allocated) {
+            FS_TRACE_ERROR("minfs: Not enough slices for journal\n");
+            return ZX_ERR_INVALID_ARGS;
+        } else if (jnl_blocks_allocated + info->jnl_block >= info->dat_block) {
+            FS_TRACE_ERROR("minfs: Journal collides with data blocks\n");
             return ZX_ERR_INVALID_ARGS;
         }
         size_t dat_blocks_needed = info->block_count;
@@ -237,12 +255,13 @@ BlockOffsets::BlockOffsets(const Bcache* bc, const Superblock* sb) {
         ibm_block_count_ = bc->extent_lengths_[1] / kMinfsBlockSize;
         abm_block_count_ = bc->extent_lengths_[2] / kMinfsBlockSize;
         ino_block_count_ = bc->extent_lengths_[3] / kMinfsBlockSize;
-        dat_block_count_ = bc->extent_lengths_[4] / kMinfsBlockSize;
+        blk_t jnl_block_count = bc->extent_lengths_[4] / kMinfsBlockSize;
+        dat_block_count_ = bc->extent_lengths_[5] / kMinfsBlockSize;
 
         ibm_start_block_ = bc->extent_lengths_[0] / kMinfsBlockSize;
         abm_start_block_ = ibm_start_block_ + ibm_block_count_;
         ino_start_block_ = abm_start_block_ + abm_block_count_;
-        dat_start_block_ = ino_start_block_ + ino_block_count_;
+        dat_start_block_ = ino_start_block_ + ino_block_count_ + jnl_block_count;
     } else {
         ibm_start_block_ = sb->Info().ibm_block;
         abm_start_block_ = sb->Info().abm_block;
@@ -251,7 +270,7 @@ BlockOffsets::BlockOffsets(const Bcache* bc, const Superblock* sb) {
 
         ibm_block_count_ = abm_start_block_ - ibm_start_block_;
         abm_block_count_ = ino_start_block_ - abm_start_block_;
-        ino_block_count_ = dat_start_block_ - ino_start_block_;
+        ino_block_count_ = sb->Info().jnl_block - ino_start_block_;
         dat_block_count_ = sb->Info().block_count;
     }
 }
@@ -292,9 +311,11 @@ void Minfs::Sync(SyncCallback closure) {
 #ifdef __Fuchsia__
 Minfs::Minfs(fbl::unique_ptr<Bcache> bc, fbl::unique_ptr<Superblock> sb,
              fbl::unique_ptr<Allocator> block_allocator, fbl::unique_ptr<InodeManager> inodes,
-             fbl::unique_ptr<WritebackBuffer> writeback, uint64_t fs_id)
+             fbl::unique_ptr<Journal> journal, fbl::unique_ptr<WritebackBuffer> writeback,
+             uint64_t fs_id)
     : bc_(fbl::move(bc)), sb_(fbl::move(sb)), block_allocator_(fbl::move(block_allocator)),
-      inodes_(fbl::move(inodes)), writeback_(fbl::move(writeback)), fs_id_(fs_id) {}
+      inodes_(fbl::move(inodes)), journal_(fbl::move(journal)),
+      writeback_(fbl::move(writeback)), fs_id_(fs_id) {}
 #else
 Minfs::Minfs(fbl::unique_ptr<Bcache> bc, fbl::unique_ptr<Superblock> sb,
              fbl::unique_ptr<Allocator> block_allocator, fbl::unique_ptr<InodeManager> inodes,
@@ -626,6 +647,14 @@ zx_status_t Minfs::Create(fbl::unique_ptr<Bcache> bc, const minfs_info_t* info,
         return status;
     }
 
+    if (info->flags & kMinfsFlagClean) {
+        // The previous session shut down cleanly, so the allocation
+        // cursors it persisted are fresh; resume searching where it
+        // stopped instead of re-walking the bitmaps from zero.
+        block_allocator->SetHint(info->abm_hint);
+        inodes->SetHint(info->ibm_hint);
+    }
+
     if ((status = txn.Transact()) != ZX_OK) {
         FS_TRACE_ERROR("Minfs::Create failed to read initial blocks: %d\n", status);
         return status;
@@ -645,8 +674,15 @@ zx_status_t Minfs::Create(fbl::unique_ptr<Bcache> bc, const minfs_info_t* info,
         return status;
     }
 
+    fbl::unique_ptr<Journal> journal;
+    if ((status = Journal::Create(bc.get(), sb->Info().jnl_block, &journal)) != ZX_OK) {
+        FS_TRACE_ERROR("Minfs::Create failed to initialize journal: %d\n", status);
+        return status;
+    }
+
     fbl::unique_ptr<WritebackBuffer> writeback;
-    if ((status = WritebackBuffer::Create(bc.get(), fbl::move(buffer), &writeback)) != ZX_OK) {
+    if ((status = WritebackBuffer::Create(bc.get(), fbl::move(buffer), journal.get(),
+                                          &writeback)) != ZX_OK) {
         return status;
     }
 
@@ -658,7 +694,8 @@ zx_status_t Minfs::Create(fbl::unique_ptr<Bcache> bc, const minfs_info_t* info,
     }
     auto fs =
         fbl::unique_ptr<Minfs>(new Minfs(fbl::move(bc), fbl::move(sb), fbl::move(block_allocator),
-                                         fbl::move(inodes), fbl::move(writeback), id));
+                                         fbl::move(inodes), fbl::move(journal),
+                                         fbl::move(writeback), id));
 #else
     auto fs =
         fbl::unique_ptr<Minfs>(new Minfs(fbl::move(bc), fbl::move(sb), fbl::move(block_allocator),
@@ -725,6 +762,16 @@ zx_status_t minfs_mount(fbl::unique_ptr<minfs::Bcache> bc, fbl::RefPtr<VnodeMinf
     }
     const minfs_info_t* info = reinterpret_cast<minfs_info_t*>(blk);
 
+#ifdef __Fuchsia__
+    // Apply any metadata which only made it to the journal before a
+    // crash. Host-side images are constructed, not crashed, so they never
+    // have anything to replay.
+    if ((status = ReplayJournal(bc.get(), info)) != ZX_OK) {
+        FS_TRACE_ERROR("minfs: journal replay failed\n");
+        return status;
+    }
+#endif
+
     fbl::unique_ptr<Minfs> fs;
     if ((status = Minfs::Create(fbl::move(bc), info, &fs)) != ZX_OK) {
         FS_TRACE_ERROR("minfs: mount failed\n");
@@ -757,12 +804,28 @@ zx_status_t MountAndServe(const minfs_options_t* options, async_dispatcher_t* di
 
     Minfs* vfs = vn->fs_;
     vfs->SetReadonly(options->readonly);
+    if (!options->readonly) {
+        // Drop the clean flag for the duration of the mount; Shutdown
+        // restores it once everything has been synced.
+        vfs->MarkDirty();
+    }
+    // All minfs directory modifications flow through the VFS, so path walks
+    // may safely memoize lookups.
+    vfs->SetDentryCacheEnabled(true);
     vfs->SetMetrics(options->metrics);
     vfs->SetUnmountCallback(fbl::move(on_unmount));
     vfs->SetDispatcher(dispatcher);
     return vfs->ServeDirectory(fbl::move(vn), fbl::move(mount_channel));
 }
 
+void Minfs::MarkDirty() {
+    sb_->MutableInfo()->flags &= ~kMinfsFlagClean;
+    // Written synchronously, before any modification is accepted: if the
+    // flag never reaches disk, neither did anything worth distrusting.
+    bc_->Writeblk(0, sb_->MutableInfo());
+    clean_managed_ = true;
+}
+
 void Minfs::Shutdown(fs::Vfs::ShutdownCallback cb) {
     ManagedVfs::Shutdown([this, cb = fbl::move(cb)](zx_status_t status) mutable {
         Sync([this, cb = fbl::move(cb)](zx_status_t) mutable {
@@ -770,6 +833,24 @@ void Minfs::Shutdown(fs::Vfs::ShutdownCallback cb) {
                 // Ensure writeback buffer completes before auxilliary structures
                 // are deleted.
                 writeback_ = nullptr;
+                if (journal_ != nullptr) {
+                    // All logged writes have landed; the next mount has
+                    // nothing to replay.
+                    journal_->MarkClean();
+                    journal_ = nullptr;
+                }
+                if (clean_managed_) {
+                    // Every in-flight write has landed, so the in-memory
+                    // allocation cursors describe the on-disk bitmaps;
+                    // persist them alongside the clean flag so the next
+                    // mount resumes searching where this session stopped.
+                    sb_->MutableInfo()->flags |= kMinfsFlagClean;
+                    sb_->MutableInfo()->abm_hint =
+                        static_cast<uint32_t>(block_allocator_->GetHint());
+                    sb_->MutableInfo()->ibm_hint =
+                        static_cast<uint32_t>(inodes_->GetHint());
+                    bc_->Writeblk(0, sb_->MutableInfo());
+                }
                 bc_->Sync();
 
                 DumpMetrics();
@@ -847,6 +928,15 @@ zx_status_t Mkfs(const Options& options, fbl::unique_ptr<Bcache> bc) {
         }
         info.ino_slices = 1;
 
+        blk_t jnl_blocks = fbl::round_up(kJournalNumBlocks, static_cast<blk_t>(kBlocksPerSlice));
+        request.length = jnl_blocks / kBlocksPerSlice;
+        request.offset = kFVMBlockJournalStart / kBlocksPerSlice;
+        if ((status = bc->FVMExtend(&request)) != ZX_OK) {
+            fprintf(stderr, "minfs mkfs: Failed to allocate journal: %d\n", status);
+            return status;
+        }
+        info.jnl_slices = static_cast<uint32_t>(request.length);
+
         ZX_ASSERT(options.fvm_data_slices > 0);
         request.length = options.fvm_data_slices;
         request.offset = kFVMBlockDataStart / kBlocksPerSlice;
@@ -876,7 +966,7 @@ zx_status_t Mkfs(const Options& options, fbl::unique_ptr<Bcache> bc) {
     info.alloc_inode_count = 0;
     if ((info.flags & kMinfsFlagFVM) == 0) {
         // Aligning distinct data areas to 8 block groups.
-        uint32_t non_dat_blocks = (8 + fbl::round_up(ibmblks, 8u) + inoblks);
+        uint32_t non_dat_blocks = (8 + fbl::round_up(ibmblks, 8u) + inoblks + kJournalNumBlocks);
         if (non_dat_blocks >= blocks) {
             fprintf(stderr, "mkfs: Partition size (%" PRIu64 " bytes) is too small\n",
                     static_cast<uint64_t>(blocks) * kMinfsBlockSize);
@@ -889,13 +979,15 @@ zx_status_t Mkfs(const Options& options, fbl::unique_ptr<Bcache> bc) {
         info.ibm_block = 8;
         info.abm_block = info.ibm_block + fbl::round_up(ibmblks, 8u);
         info.ino_block = info.abm_block + fbl::round_up(abmblks, 8u);
-        info.dat_block = info.ino_block + inoblks;
+        info.jnl_block = info.ino_block + inoblks;
+        info.dat_block = info.jnl_block + kJournalNumBlocks;
     } else {
         info.block_count = blocks;
         abmblks = (info.block_count + kMinfsBlockBits - 1) / kMinfsBlockBits;
         info.ibm_block = kFVMBlockInodeBmStart;
         info.abm_block = kFVMBlockDataBmStart;
         info.ino_block = kFVMBlockInodeStart;
+        info.jnl_block = kFVMBlockJournalStart;
         info.dat_block = kFVMBlockDataStart;
     }
 
@@ -974,6 +1066,12 @@ zx_status_t Mkfs(const Options& options, fbl::unique_ptr<Bcache> bc) {
     ino[kMinfsRootIno].dnum[0] = 1;
     bc->Writeblk(info.ino_block, blk);
 
+    // format the journal as clean
+    if ((status = MkfsJournal(bc.get(), info.jnl_block)) != ZX_OK) {
+        FS_TRACE_ERROR("mkfs: Failed to format journal\n");
+        return status;
+    }
+
     memset(blk, 0, sizeof(blk));
     memcpy(blk, &info, sizeof(info));
     bc->Writeblk(0, blk);
@@ -1134,9 +1232,14 @@ void Minfs::UpdateOpenMetrics(bool cache_hit, const fs::Duration& duration) {
 #endif
 }
 
-void Minfs::DumpMetrics() const {
+void Minfs::DumpMetrics() {
 #ifdef FS_WITH_METRICS
     if (collecting_metrics_) {
+        metrics_.readahead_hits = bc_->ReadaheadHits();
+        metrics_.readahead_misses = bc_->ReadaheadMisses();
+        metrics_.alloc_runs = block_allocator_->AllocRuns();
+        metrics_.alloc_run_units = block_allocator_->AllocRunUnits();
+        metrics_.alloc_search_attempts = block_allocator_->AllocSearchAttempts();
         metrics_.Dump();
     }
 #endif
@@ -213,13 +213,35 @@ zx_status_t VnodeMinfs::InitVmo() {
                                ticker.End());
     });
 
+    // Accumulate contiguous [file block --> disk block] runs, so large files
+    // are read with a few maximal requests rather than one request per block.
+    blk_t run_start = 0;
+    blk_t run_bno = 0;
+    blk_t run_len = 0;
+    auto enqueue_run = [&]() {
+        if (run_len > 0) {
+            txn.Enqueue(vmoid_, run_start, run_bno + fs_->Info().dat_block, run_len);
+            run_len = 0;
+        }
+    };
+    auto enqueue_block = [&](blk_t n, blk_t bno) {
+        if (run_len > 0 && n == run_start + run_len && bno == run_bno + run_len) {
+            run_len++;
+            return;
+        }
+        enqueue_run();
+        run_start = n;
+        run_bno = bno;
+        run_len = 1;
+    };
+
     // Initialize all direct blocks
     blk_t bno;
     for (uint32_t d = 0; d < kMinfsDirect; d++) {
         if ((bno = inode_.dnum[d]) != 0) {
             fs_->ValidateBno(bno);
             dnum_count++;
-            txn.Enqueue(vmoid_, d, bno + fs_->Info().dat_block, 1);
+            enqueue_block(d, bno);
         }
     }
 
@@ -243,7 +265,7 @@ zx_status_t VnodeMinfs::InitVmo() {
                 if ((bno = ientry[j]) != 0) {
                     fs_->ValidateBno(bno);
                     uint32_t n = kMinfsDirect + i * kMinfsDirectPerIndirect + j;
-                    txn.Enqueue(vmoid_, n, bno + fs_->Info().dat_block, 1);
+                    enqueue_block(n, bno);
                 }
             }
         }
@@ -285,7 +307,7 @@ zx_status_t VnodeMinfs::InitVmo() {
                             fs_->ValidateBno(bno);
                             uint32_t n = kMinfsDirect + kMinfsIndirect * kMinfsDirectPerIndirect
                                          + j * kMinfsDirectPerIndirect + k;
-                            txn.Enqueue(vmoid_, n, bno + fs_->Info().dat_block, 1);
+                            enqueue_block(n, bno);
                         }
                     }
                 }
@@ -293,6 +315,7 @@ zx_status_t VnodeMinfs::InitVmo() {
         }
     }
 
+    enqueue_run();
     status = txn.Transact();
     ValidateVmoTail();
     return status;
@@ -511,6 +534,11 @@ void VnodeMinfs::ClearIndirectBlock(blk_t bno) {
 #endif
 
 zx_status_t VnodeMinfs::BlockOp(Transaction* state, blk_op_t op, bop_params_t* boparams) {
+    if (op != READ) {
+        // The block map is about to change; drop the cached extent.
+        extent_.count = 0;
+    }
+
     blk_t start = boparams->start;
     blk_t found = 0;
     bool dirty = false;
@@ -614,8 +642,30 @@ zx_status_t VnodeMinfs::BlockOp(Transaction* state, blk_op_t op, bop_params_t* b
 }
 
 zx_status_t VnodeMinfs::BlockGet(Transaction* state, blk_t n, blk_t* bno) {
+    if (n >= kMinfsMaxFileBlock) {
+        return ZX_ERR_OUT_OF_RANGE;
+    }
+
+    blk_t count = 1;
+    if (state == nullptr) {
+        // Service read-only lookups from the cached extent when possible.
+        if (extent_.count != 0 && n >= extent_.file_block &&
+            n - extent_.file_block < extent_.count) {
+            *bno = extent_.dev_block ? extent_.dev_block + (n - extent_.file_block) : 0;
+            return ZX_OK;
+        }
+
+        // Otherwise, resolve a run of blocks starting at |n| with a single
+        // walk of the block map, and cache the contiguous prefix.
+        count = static_cast<blk_t>(fbl::min<uint64_t>(kMaxExtentBlocks,
+                                                      kMinfsMaxFileBlock - n));
+    }
+
 #ifdef __Fuchsia__
-    if (n >= kMinfsDirect) {
+    // The last block of the lookup determines how much of the indirect
+    // structure must be resident.
+    blk_t last = n + count - 1;
+    if (last >= kMinfsDirect) {
         zx_status_t status;
         // If the vmo_indirect_ vmo has not been created, make it now.
         if ((status = InitIndirectVmo()) != ZX_OK) {
@@ -624,9 +674,9 @@ zx_status_t VnodeMinfs::BlockGet(Transaction* state, blk_t n, blk_t* bno) {
 
         // Number of blocks prior to dindirect blocks
         blk_t pre_dindirect = kMinfsDirect + kMinfsDirectPerIndirect * kMinfsIndirect;
-        if (n >= pre_dindirect) {
+        if (last >= pre_dindirect) {
             // Index of last doubly indirect block
-            blk_t dibindex = (n - pre_dindirect) / kMinfsDirectPerDindirect;
+            blk_t dibindex = (last - pre_dindirect) / kMinfsDirectPerDindirect;
             ZX_DEBUG_ASSERT(dibindex < kMinfsDoublyIndirect);
             uint64_t vmo_size = GetVmoSizeForIndirect(dibindex);
             // Grow VMO if we need more space to fit doubly indirect blocks
@@ -639,8 +689,35 @@ zx_status_t VnodeMinfs::BlockGet(Transaction* state, blk_t n, blk_t* bno) {
     }
 #endif
 
-    bop_params_t boparams(n, 1, bno);
-    return BlockOp(state, state ? WRITE : READ, &boparams);
+    if (state != nullptr) {
+        bop_params_t boparams(n, 1, bno);
+        return BlockOp(state, WRITE, &boparams);
+    }
+
+    blk_t bnos[kMaxExtentBlocks];
+    bop_params_t boparams(n, count, bnos);
+    zx_status_t status;
+    if ((status = BlockOp(nullptr, READ, &boparams)) != ZX_OK) {
+        return status;
+    }
+
+    // Cache the contiguous run (allocated or hole) beginning at |n|.
+    blk_t run = 1;
+    if (bnos[0] == 0) {
+        while (run < count && bnos[run] == 0) {
+            run++;
+        }
+    } else {
+        while (run < count && bnos[run] == bnos[0] + run) {
+            run++;
+        }
+    }
+    extent_.file_block = n;
+    extent_.dev_block = bnos[0];
+    extent_.count = run;
+
+    *bno = bnos[0];
+    return ZX_OK;
 }
 
 // Immediately stop iterating over the directory.
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <inttypes.h>
+#include <stdlib.h>
 
 #ifdef __Fuchsia__
 #include <fbl/auto_lock.h>
@@ -60,31 +61,37 @@ void WriteTxn::Enqueue(zx_handle_t vmo, uint64_t vmo_offset, uint64_t dev_offset
     requests_.push_back(fbl::move(request));
 }
 
-zx_status_t WriteTxn::Flush(zx_handle_t vmo, vmoid_t vmoid) {
-    ZX_DEBUG_ASSERT(vmo != ZX_HANDLE_INVALID);
+void WriteTxn::AppendRequests(vmoid_t vmoid, fbl::Vector<block_fifo_request_t>* out) {
     ZX_DEBUG_ASSERT(vmoid != VMOID_INVALID);
 
     // Update all the outgoing transactions to be in "disk blocks",
     // not "Minfs blocks".
-    block_fifo_request_t blk_reqs[requests_.size()];
     const uint32_t kDiskBlocksPerMinfsBlock = kMinfsBlockSize / bc_->DeviceBlockSize();
     for (size_t i = 0; i < requests_.size(); i++) {
-        blk_reqs[i].group = bc_->BlockGroupID();
-        blk_reqs[i].vmoid = vmoid;
-        blk_reqs[i].opcode = BLOCKIO_WRITE;
-        blk_reqs[i].vmo_offset = requests_[i].vmo_offset * kDiskBlocksPerMinfsBlock;
-        blk_reqs[i].dev_offset = requests_[i].dev_offset * kDiskBlocksPerMinfsBlock;
+        block_fifo_request_t blk_req;
+        blk_req.group = bc_->BlockGroupID();
+        blk_req.vmoid = vmoid;
+        blk_req.opcode = BLOCKIO_WRITE;
+        blk_req.vmo_offset = requests_[i].vmo_offset * kDiskBlocksPerMinfsBlock;
+        blk_req.dev_offset = requests_[i].dev_offset * kDiskBlocksPerMinfsBlock;
         // TODO(ZX-2253): Remove this assertion.
         uint64_t length = requests_[i].length * kDiskBlocksPerMinfsBlock;
         ZX_ASSERT_MSG(length < UINT32_MAX, "Too many blocks");
-        blk_reqs[i].length = static_cast<uint32_t>(length);
+        blk_req.length = static_cast<uint32_t>(length);
+        out->push_back(blk_req);
     }
 
-    // Actually send the operations to the underlying block device.
-    zx_status_t status = bc_->Transaction(blk_reqs, requests_.size());
-
     requests_.reset();
-    return status;
+}
+
+zx_status_t WriteTxn::Flush(zx_handle_t vmo, vmoid_t vmoid) {
+    ZX_DEBUG_ASSERT(vmo != ZX_HANDLE_INVALID);
+
+    fbl::Vector<block_fifo_request_t> blk_reqs;
+    AppendRequests(vmoid, &blk_reqs);
+
+    // Actually send the operations to the underlying block device.
+    return bc_->Transaction(blk_reqs.get(), blk_reqs.size());
 }
 
 size_t WriteTxn::BlkCount() const {
@@ -114,16 +121,11 @@ void WritebackWork::Reset() {
 }
 
 #ifdef __Fuchsia__
-// Returns the number of blocks of the writeback buffer that have been
-// consumed
-size_t WritebackWork::Complete(zx_handle_t vmo, vmoid_t vmoid) {
-    size_t blk_count = BlkCount();
-    zx_status_t status = Flush(vmo, vmoid);
+void WritebackWork::MarkCompleted(zx_status_t status) {
     if (closure_) {
         closure_(status);
     }
     Reset();
-    return blk_count;
 }
 
 void WritebackWork::SetClosure(SyncCallback closure) {
@@ -153,8 +155,8 @@ void WritebackWork::PinVnode(fbl::RefPtr<VnodeMinfs> vn) {
 #ifdef __Fuchsia__
 
 zx_status_t WritebackBuffer::Create(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer,
-                                    fbl::unique_ptr<WritebackBuffer>* out) {
-    fbl::unique_ptr<WritebackBuffer> wb(new WritebackBuffer(bc, fbl::move(buffer)));
+                                    Journal* journal, fbl::unique_ptr<WritebackBuffer>* out) {
+    fbl::unique_ptr<WritebackBuffer> wb(new WritebackBuffer(bc, fbl::move(buffer), journal));
     if (wb->buffer_->GetSize() % kMinfsBlockSize != 0) {
         return ZX_ERR_INVALID_ARGS;
     } else if (cnd_init(&wb->consumer_cvar_) != thrd_success) {
@@ -175,8 +177,9 @@ zx_status_t WritebackBuffer::Create(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo>
     return ZX_OK;
 }
 
-WritebackBuffer::WritebackBuffer(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer) :
-    bc_(bc), unmounting_(false), buffer_(fbl::move(buffer)),
+WritebackBuffer::WritebackBuffer(Bcache* bc, fbl::unique_ptr<fzl::MappedVmo> buffer,
+                                 Journal* journal) :
+    bc_(bc), journal_(journal), unmounting_(false), buffer_(fbl::move(buffer)),
     cap_(buffer_->GetSize() / kMinfsBlockSize) {}
 
 WritebackBuffer::~WritebackBuffer() {
@@ -310,30 +313,98 @@ void WritebackBuffer::Enqueue(fbl::unique_ptr<WritebackWork> work) {
     cnd_signal(&consumer_cvar_);
 }
 
+namespace {
+
+int CompareBlockRequests(const void* a, const void* b) {
+    auto* left = static_cast<const block_fifo_request_t*>(a);
+    auto* right = static_cast<const block_fifo_request_t*>(b);
+    if (left->dev_offset < right->dev_offset) {
+        return -1;
+    }
+    return (left->dev_offset > right->dev_offset) ? 1 : 0;
+}
+
+} // namespace
+
+size_t WritebackBuffer::CompleteGroup(fbl::Vector<fbl::unique_ptr<WritebackWork>>* group) {
+    TRACE_DURATION("minfs", "WritebackBuffer::CompleteGroup", "works", group->size());
+
+    // Gather the requests of all work units into one submission. All
+    // requests already read from the writeback buffer, so they are safe
+    // to reorder relative to each other.
+    size_t blk_count = 0;
+    fbl::Vector<block_fifo_request_t> blk_reqs;
+    for (size_t i = 0; i < group->size(); i++) {
+        blk_count += (*group)[i]->BlkCount();
+        (*group)[i]->AppendRequests(buffer_vmoid_, &blk_reqs);
+    }
+
+    // Sort by device offset so the block device sees one mostly-sequential
+    // stream, then coalesce requests which ended up adjacent both on disk
+    // and in the writeback buffer.
+    qsort(blk_reqs.get(), blk_reqs.size(), sizeof(block_fifo_request_t),
+          CompareBlockRequests);
+    size_t out = 0;
+    for (size_t i = 1; i < blk_reqs.size(); i++) {
+        if ((blk_reqs[out].dev_offset + blk_reqs[out].length == blk_reqs[i].dev_offset) &&
+            (blk_reqs[out].vmo_offset + blk_reqs[out].length == blk_reqs[i].vmo_offset)) {
+            blk_reqs[out].length += blk_reqs[i].length;
+        } else {
+            blk_reqs[++out] = blk_reqs[i];
+        }
+    }
+
+    // Submit the whole group as a single transaction; the block server
+    // keeps as many of these requests in flight as the device queue depth
+    // allows, rather than waiting on each work unit in turn. With a
+    // journal, the group is logged first, so it either replays in full
+    // after a crash or never happened.
+    zx_status_t status = ZX_OK;
+    if (!blk_reqs.is_empty()) {
+        if (journal_ != nullptr) {
+            status = journal_->CommitGroup(blk_reqs.get(), out + 1, buffer_->GetData());
+        } else {
+            status = bc_->Transaction(blk_reqs.get(), out + 1);
+        }
+    }
+
+    for (size_t i = 0; i < group->size(); i++) {
+        auto work = fbl::move((*group)[i]);
+        TRACE_FLOW_END("minfs", "writeback", reinterpret_cast<trace_flow_id_t>(work.get()));
+        work->MarkCompleted(status);
+    }
+    return blk_count;
+}
+
 int WritebackBuffer::WritebackThread(void* arg) {
     WritebackBuffer* b = reinterpret_cast<WritebackBuffer*>(arg);
 
     b->writeback_lock_.Acquire();
     while (true) {
         while (!b->work_queue_.is_empty()) {
-            auto work = b->work_queue_.pop();
             TRACE_DURATION("minfs", "WritebackBuffer::WritebackThread");
 
-            // Stay unlocked while processing a unit of work
+            // Pop everything which is currently pending, so independent
+            // transactions are flushed as a single group commit.
+            fbl::Vector<fbl::unique_ptr<WritebackWork>> group;
+            while (!b->work_queue_.is_empty()) {
+                group.push_back(b->work_queue_.pop());
+            }
+
+            // Stay unlocked while processing the group
             b->writeback_lock_.Release();
 
             // TODO(smklein): We could add additional validation that the blocks
-            // in "work" are contiguous and in the range of [start_, len_) (including
-            // wraparound).
-            size_t blks_consumed = work->Complete(b->buffer_->GetVmo(), b->buffer_vmoid_);
-            TRACE_FLOW_END("minfs", "writeback", reinterpret_cast<trace_flow_id_t>(work.get()));
-            work = nullptr;
+            // in the group are contiguous and in the range of [start_, len_)
+            // (including wraparound).
+            size_t blks_consumed = b->CompleteGroup(&group);
 
             // Relock before checking the state of the queue
             b->writeback_lock_.Acquire();
             b->start_ = (b->start_ + blks_consumed) % b->cap_;
             b->len_ -= blks_consumed;
-            cnd_signal(&b->producer_cvar_);
+            // A group may free space for several waiting producers at once.
+            cnd_broadcast(&b->producer_cvar_);
         }
 
         // Before waiting, we should check if we're unmounting.
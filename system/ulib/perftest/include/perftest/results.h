@@ -33,6 +33,23 @@ struct SummaryStatistics {
     double median;
 };
 
+// Summary statistics computed after discarding warmup runs and outliers,
+// along with a confidence interval, for use when comparing results across
+// builds.
+struct RobustStatistics {
+    // Number of leading samples discarded as warmup.
+    size_t warmup_runs_dropped;
+    // Number of remaining samples discarded as outliers.
+    size_t outliers_dropped;
+    // Number of samples the statistics below were computed from.
+    size_t samples_used;
+    double mean;
+    double median;
+    double std_dev;
+    // Half-width of the 95% confidence interval around |mean|.
+    double ci_half_width;
+};
+
 // This represents the results for a particular test case.  It contains a
 // sequence of values, which are typically the times taken by each run of
 // the test case, in order.
@@ -52,6 +69,12 @@ struct TestCaseResults {
 
     SummaryStatistics GetSummaryStatistics() const;
 
+    // As GetSummaryStatistics(), but discards leading warmup runs and
+    // outliers first (both identified using the median absolute deviation
+    // of the full sample) and includes a 95% confidence interval for the
+    // mean.  If the sample has no spread, nothing is discarded.
+    RobustStatistics GetRobustStatistics() const;
+
     fbl::String test_suite;
     fbl::String label;
     fbl::String unit;
@@ -67,6 +90,7 @@ struct TestCaseResults {
 class ResultsSet {
 public:
     fbl::Vector<TestCaseResults>* results() { return &results_; }
+    const fbl::Vector<TestCaseResults>& results() const { return results_; }
 
     TestCaseResults* AddTestCase(const fbl::String& test_suite,
                                  const fbl::String& label,
@@ -85,4 +109,19 @@ private:
     fbl::Vector<TestCaseResults> results_;
 };
 
+// Reads a results set from a JSON file previously written by
+// WriteJSONFile() (i.e. conforming to performance-results-schema.json),
+// appending its test cases to |dest|.  Returns whether this was
+// successful; prints an error to stderr if not.
+bool ReadJSONFile(const char* filename, ResultsSet* dest);
+
+// Compares |current| against |baseline|, matching test cases by test
+// suite and label and using GetRobustStatistics() on both sides.  A test
+// case is reported as a regression when its mean worsened by more than
+// |threshold_factor| (e.g. 0.01 for 1%) and the difference is
+// statistically significant at the 95% level.  Logs a line per test case
+// to |log_stream|.  Returns false if any regressions were found.
+bool CompareResults(const ResultsSet& current, const ResultsSet& baseline,
+                    double threshold_factor, FILE* log_stream);
+
 } // namespace perftest
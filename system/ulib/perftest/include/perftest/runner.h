@@ -26,11 +26,17 @@ bool RunTests(const char* test_suite, TestList* test_list,
 
 struct CommandArgs {
     const char* output_filename = nullptr;
+    // JSON file of baseline results to compare against, or null for no
+    // comparison.
+    const char* baseline_filename = nullptr;
     // Note that this default matches any string.
     const char* filter_regex = "";
     uint32_t run_count = 1000;
     bool enable_tracing = false;
     double startup_delay_seconds = 0;
+    // Minimum relative worsening of a test's mean for it to be reported
+    // as a regression (in addition to statistical significance).
+    double regression_threshold = 0.05;
 };
 
 void ParseCommandArgs(int argc, char** argv, CommandArgs* dest);
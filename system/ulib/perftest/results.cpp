@@ -4,11 +4,15 @@
 
 #include <perftest/results.h>
 
+#include <ctype.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <fbl/algorithm.h>
+#include <fbl/unique_ptr.h>
 #include <zircon/assert.h>
 
 namespace perftest {
@@ -66,6 +70,19 @@ double Median(const fbl::Vector<double>& values) {
     return copy[index];
 }
 
+// Median absolute deviation: the median of |value - median| over the
+// sample.  Unlike the standard deviation this is not itself skewed by
+// outliers, which makes it suitable for deciding what an outlier is.
+double MedianAbsoluteDeviation(const fbl::Vector<double>& values,
+                               double median) {
+    fbl::Vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double value : values) {
+        deviations.push_back(fabs(value - median));
+    }
+    return Median(deviations);
+}
+
 } // namespace
 
 SummaryStatistics TestCaseResults::GetSummaryStatistics() const {
@@ -80,6 +97,56 @@ SummaryStatistics TestCaseResults::GetSummaryStatistics() const {
     };
 }
 
+RobustStatistics TestCaseResults::GetRobustStatistics() const {
+    ZX_ASSERT(values.size() > 0);
+    RobustStatistics stats{};
+
+    // Accept samples within 3 estimated standard deviations of the median,
+    // using the median absolute deviation (scaled by 1.4826, its
+    // relationship to the standard deviation for normally-distributed
+    // data) as the spread estimate.  If the sample has no spread the
+    // bounds would degenerate to a single point, so keep everything.
+    double median = Median(values);
+    double mad = MedianAbsoluteDeviation(values, median);
+    double lower_bound = -INFINITY;
+    double upper_bound = INFINITY;
+    if (mad != 0) {
+        lower_bound = median - 3 * 1.4826 * mad;
+        upper_bound = median + 3 * 1.4826 * mad;
+    }
+
+    // Leading out-of-bounds samples are warmup (caches, page faults,
+    // frequency scaling); later out-of-bounds samples are outliers.
+    fbl::Vector<double> kept;
+    kept.reserve(values.size());
+    bool in_warmup = true;
+    for (double value : values) {
+        bool in_bounds = value >= lower_bound && value <= upper_bound;
+        if (in_warmup && !in_bounds) {
+            ++stats.warmup_runs_dropped;
+            continue;
+        }
+        in_warmup = false;
+        if (!in_bounds) {
+            ++stats.outliers_dropped;
+            continue;
+        }
+        kept.push_back(value);
+    }
+    ZX_ASSERT(kept.size() > 0);
+
+    stats.samples_used = kept.size();
+    stats.mean = Mean(kept);
+    stats.median = Median(kept);
+    stats.std_dev = StdDev(kept, stats.mean);
+    // 95% confidence interval for the mean, using the normal
+    // approximation; our run counts are comfortably large enough for
+    // this.
+    stats.ci_half_width =
+        1.96 * stats.std_dev / sqrt(static_cast<double>(kept.size()));
+    return stats;
+}
+
 void WriteJSONString(FILE* out_file, const char* string) {
     fputc('"', out_file);
     for (const char* ptr = string; *ptr; ptr++) {
@@ -196,4 +263,267 @@ void ResultsSet::PrintSummaryStatistics(FILE* out_file) const {
     }
 }
 
+namespace {
+
+// Minimal parser for the JSON subset produced by WriteJSON(): an array of
+// objects whose values are strings, numbers, or arrays of numbers.  The
+// input buffer must be null-terminated (for strtod()).  Unrecognized keys
+// are skipped so that additions to the schema don't break older readers.
+class JSONParser {
+public:
+    JSONParser(const char* data)
+        : pos_(data) {}
+
+    bool ParseResultsSet(ResultsSet* dest);
+
+private:
+    bool ParseTestCase(ResultsSet* dest);
+    bool ParseString(fbl::String* out);
+    bool ParseNumber(double* out);
+    bool SkipValue();
+
+    void SkipWhitespace() {
+        while (isspace(*pos_)) {
+            ++pos_;
+        }
+    }
+
+    // Consumes the next non-whitespace character if it is |c|.
+    bool Consume(char c) {
+        SkipWhitespace();
+        if (*pos_ != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    const char* pos_;
+};
+
+bool JSONParser::ParseString(fbl::String* out) {
+    if (!Consume('"')) {
+        return false;
+    }
+    fbl::Vector<char> chars;
+    for (;;) {
+        char c = *pos_;
+        if (c == '\0') {
+            return false;
+        }
+        ++pos_;
+        if (c == '"') {
+            break;
+        }
+        if (c == '\\') {
+            char escaped = *pos_;
+            if (escaped == '"' || escaped == '\\' || escaped == '/') {
+                c = escaped;
+                ++pos_;
+            } else if (escaped == 'u') {
+                // Decode the \uXXXX sequences WriteJSONString() produces.
+                ++pos_;
+                char hex[5] = {};
+                for (int i = 0; i < 4; ++i) {
+                    if (!isxdigit(*pos_)) {
+                        return false;
+                    }
+                    hex[i] = *pos_++;
+                }
+                c = static_cast<char>(strtol(hex, nullptr, 16));
+            } else {
+                return false;
+            }
+        }
+        chars.push_back(c);
+    }
+    *out = fbl::String(chars.get(), chars.size());
+    return true;
+}
+
+bool JSONParser::ParseNumber(double* out) {
+    SkipWhitespace();
+    char* end;
+    *out = strtod(pos_, &end);
+    if (end == pos_) {
+        return false;
+    }
+    pos_ = end;
+    return true;
+}
+
+bool JSONParser::SkipValue() {
+    SkipWhitespace();
+    if (*pos_ == '"') {
+        fbl::String ignored;
+        return ParseString(&ignored);
+    }
+    if (*pos_ == '[') {
+        ++pos_;
+        if (Consume(']')) {
+            return true;
+        }
+        do {
+            if (!SkipValue()) {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume(']');
+    }
+    double ignored;
+    return ParseNumber(&ignored);
+}
+
+bool JSONParser::ParseTestCase(ResultsSet* dest) {
+    if (!Consume('{')) {
+        return false;
+    }
+    fbl::String label;
+    fbl::String test_suite;
+    fbl::String unit;
+    uint64_t bytes_processed_per_run = 0;
+    fbl::Vector<double> values;
+    do {
+        fbl::String key;
+        if (!ParseString(&key) || !Consume(':')) {
+            return false;
+        }
+        if (key == "label") {
+            if (!ParseString(&label)) {
+                return false;
+            }
+        } else if (key == "test_suite") {
+            if (!ParseString(&test_suite)) {
+                return false;
+            }
+        } else if (key == "unit") {
+            if (!ParseString(&unit)) {
+                return false;
+            }
+        } else if (key == "bytes_processed_per_run") {
+            double value;
+            if (!ParseNumber(&value)) {
+                return false;
+            }
+            bytes_processed_per_run = static_cast<uint64_t>(value);
+        } else if (key == "values") {
+            if (!Consume('[')) {
+                return false;
+            }
+            do {
+                double value;
+                if (!ParseNumber(&value)) {
+                    return false;
+                }
+                values.push_back(value);
+            } while (Consume(','));
+            if (!Consume(']')) {
+                return false;
+            }
+        } else if (!SkipValue()) {
+            return false;
+        }
+    } while (Consume(','));
+    if (!Consume('}')) {
+        return false;
+    }
+
+    TestCaseResults* test_case = dest->AddTestCase(test_suite, label, unit);
+    test_case->bytes_processed_per_run = bytes_processed_per_run;
+    for (double value : values) {
+        test_case->AppendValue(value);
+    }
+    return true;
+}
+
+bool JSONParser::ParseResultsSet(ResultsSet* dest) {
+    if (!Consume('[')) {
+        return false;
+    }
+    if (Consume(']')) {
+        return true;
+    }
+    do {
+        if (!ParseTestCase(dest)) {
+            return false;
+        }
+    } while (Consume(','));
+    return Consume(']');
+}
+
+} // namespace
+
+bool ReadJSONFile(const char* filename, ResultsSet* dest) {
+    FILE* fh = fopen(filename, "r");
+    if (!fh) {
+        fprintf(stderr, "Failed to open file \"%s\": %s\n",
+                filename, strerror(errno));
+        return false;
+    }
+    fseek(fh, 0, SEEK_END);
+    long size = ftell(fh);
+    fseek(fh, 0, SEEK_SET);
+    fbl::unique_ptr<char[]> data(new char[size + 1]);
+    size_t bytes_read = fread(data.get(), 1, size, fh);
+    fclose(fh);
+    if (bytes_read != static_cast<size_t>(size)) {
+        fprintf(stderr, "Failed to read file \"%s\"\n", filename);
+        return false;
+    }
+    data[size] = '\0';
+
+    JSONParser parser(data.get());
+    if (!parser.ParseResultsSet(dest)) {
+        fprintf(stderr, "Failed to parse JSON in file \"%s\"\n", filename);
+        return false;
+    }
+    return true;
+}
+
+bool CompareResults(const ResultsSet& current, const ResultsSet& baseline,
+                    double threshold_factor, FILE* log_stream) {
+    // Values are times, so larger means worse.
+    fprintf(log_stream, "%-12s %8s %s\n", "Verdict", "Change", "Test case");
+    bool ok = true;
+    for (const auto& test : current.results()) {
+        const TestCaseResults* baseline_test = nullptr;
+        for (const auto& other : baseline.results()) {
+            if (other.test_suite == test.test_suite &&
+                other.label == test.label) {
+                baseline_test = &other;
+                break;
+            }
+        }
+        if (!baseline_test) {
+            fprintf(log_stream, "%-12s %8s %s\n", "no_baseline", "-",
+                    test.label.c_str());
+            continue;
+        }
+
+        RobustStatistics cur = test.GetRobustStatistics();
+        RobustStatistics base = baseline_test->GetRobustStatistics();
+        double diff = cur.mean - base.mean;
+        double percent = diff / base.mean * 100;
+        // The difference is statistically significant (at the 95% level)
+        // when it exceeds the combined confidence interval half-widths.
+        bool significant =
+            fabs(diff) > sqrt(cur.ci_half_width * cur.ci_half_width +
+                              base.ci_half_width * base.ci_half_width);
+        bool beyond_threshold = fabs(diff) > threshold_factor * base.mean;
+
+        const char* verdict = "ok";
+        if (significant && beyond_threshold) {
+            if (diff > 0) {
+                verdict = "regression";
+                ok = false;
+            } else {
+                verdict = "improved";
+            }
+        }
+        fprintf(log_stream, "%-12s %+7.1f%% %s\n", verdict, percent,
+                test.label.c_str());
+    }
+    return ok;
+}
+
 } // namespace perftest
@@ -368,6 +368,8 @@ bool RunTests(const char* test_suite, TestList* test_list, uint32_t run_count,
 void ParseCommandArgs(int argc, char** argv, CommandArgs* dest) {
     static const struct option opts[] = {
         {"out", required_argument, nullptr, 'o'},
+        {"compare", required_argument, nullptr, 'c'},
+        {"regression-threshold", required_argument, nullptr, 'g'},
         {"filter", required_argument, nullptr, 'f'},
         {"runs", required_argument, nullptr, 'r'},
         {"enable-tracing", no_argument, nullptr, 't'},
@@ -383,6 +385,22 @@ void ParseCommandArgs(int argc, char** argv, CommandArgs* dest) {
         case 'o':
             dest->output_filename = optarg;
             break;
+        case 'c':
+            dest->baseline_filename = optarg;
+            break;
+        case 'g': {
+            // Convert string to number (double type).
+            char* end;
+            double val = strtod(optarg, &end);
+            if (*end != '\0' || *optarg == '\0' || val < 0) {
+                fprintf(stderr,
+                        "Invalid argument for --regression-threshold: "
+                        "\"%s\"\n", optarg);
+                exit(1);
+            }
+            dest->regression_threshold = val;
+            break;
+        }
         case 'f':
             dest->filter_regex = optarg;
             break;
@@ -470,6 +488,20 @@ static bool PerfTestMode(const char* test_suite, int argc, char** argv) {
         }
     }
 
+    if (args.baseline_filename) {
+        ResultsSet baseline;
+        if (!ReadJSONFile(args.baseline_filename, &baseline)) {
+            exit(1);
+        }
+        printf("Comparing against baseline %s...\n", args.baseline_filename);
+        if (!CompareResults(results, baseline, args.regression_threshold,
+                            stdout)) {
+            printf("Performance regressions found\n");
+            success = false;
+        }
+        printf("\n");
+    }
+
     return success;
 }
 
@@ -496,6 +528,15 @@ int PerfTestMain(int argc, char** argv, const char* test_suite) {
                "      Filename to write JSON results data to.  If this is "
                "omitted, no JSON output is produced. JSON output will conform to this schema: "
                "//zircon/system/ulib/perftest/performance-results-schema.json\n"
+               "  --compare FILENAME\n"
+               "      JSON file of baseline results (in the same schema) to "
+               "compare against.  Each test's mean is compared after "
+               "discarding warmup runs and outliers; the run fails if any "
+               "test worsened by more than the regression threshold with "
+               "95%% statistical significance.\n"
+               "  --regression-threshold FACTOR\n"
+               "      Minimum relative worsening for a comparison failure, "
+               "e.g. 0.05 for 5%% (the default).\n"
                "  --filter REGEX\n"
                "      Regular expression that specifies a subset of tests "
                "to run.  By default, all the tests are run.\n"
@@ -7,6 +7,17 @@
 #include <region-alloc/region-alloc.h>
 #include <string.h>
 
+namespace {
+
+// When an aligned allocation is requested, this is the number of best-fit
+// candidates examined in size order before GetRegion gives up on the walk and
+// jumps straight to the first region large enough to satisfy the alignment
+// regardless of where it starts.  See the comments in GetRegion(size,
+// alignment) below.
+constexpr uint32_t kMaxUnalignedCandidates = 32;
+
+} // namespace
+
 // Support for Pool allocated bookkeeping
 RegionAllocator::RegionPool::RefPtr RegionAllocator::RegionPool::Create(size_t max_memory) {
     // Sanity check our allocation arguments.
@@ -304,10 +315,19 @@ zx_status_t RegionAllocator::GetRegion(uint64_t size,
     // is large enough to hold this allocation (if any)
     auto iter = avail_regions_by_size_.lower_bound({ .base = 0, .size = size });
 
-    // Consider all of the regions which are large enough to hold our
-    // allocation.  Stop as soon as we find one which can satisfy the alignment
-    // restrictions.
+    // Consider the regions which are large enough to hold our allocation in
+    // size order.  Stop as soon as we find one which can satisfy the alignment
+    // restrictions.  A heavily fragmented allocator can hold tens of thousands
+    // of regions which are large enough but badly aligned, so after examining
+    // a bounded number of candidates, jump straight to the first region of at
+    // least size + alignment - 1 bytes: such a region can satisfy the
+    // alignment no matter where it starts, and finding it is a single
+    // logarithmic descent of the size index.  This trades at most
+    // alignment - 1 bytes of best-fit quality for a search cost which no
+    // longer grows with fragmentation.
     uint64_t aligned_base = 0;
+    uint32_t candidates = 0;
+    bool tried_padded = false;
     while (iter.IsValid()) {
         ZX_DEBUG_ASSERT(iter->size >= size);
         aligned_base = (iter->base + mask) & inv_mask;
@@ -321,6 +341,25 @@ zx_status_t RegionAllocator::GetRegion(uint64_t size,
         if ((aligned_base >= iter->base) && (overhead <= leftover))
             break;
 
+        if (!tried_padded && (++candidates >= kMaxUnalignedCandidates)) {
+            tried_padded = true;
+            uint64_t padded_size = size + mask;
+            if (padded_size >= size) {
+                auto padded_iter = avail_regions_by_size_.lower_bound(
+                        { .base = 0, .size = padded_size });
+                if (padded_iter.IsValid()) {
+                    iter = padded_iter;
+                    aligned_base = (iter->base + mask) & inv_mask;
+                    ZX_DEBUG_ASSERT(aligned_base >= iter->base);
+                    ZX_DEBUG_ASSERT(aligned_base - iter->base <= iter->size - size);
+                    break;
+                }
+            }
+            // No padded region exists; resume the exhaustive walk in case a
+            // badly aligned region further up the index happens to have a
+            // compatible base.
+        }
+
         ++iter;
     }
 
@@ -95,6 +95,13 @@ typedef enum {
 // These are the default values used when sending a tftp request
 #define TFTP_DEFAULT_CLIENT_MODE MODE_OCTET
 
+// The window size (RFC 7440) requested when neither tftp_set_options() nor
+// the per-request override specifies one. Without a window the transfer is
+// lock-step (one ACK per block) and throughput is bound by round-trip time.
+// Servers that don't support the option simply omit it from their OACK and
+// the session falls back to a window of 1.
+#define TFTP_DEFAULT_CLIENT_WINDOWSIZE 16
+
 typedef struct {
     char* inbuf;          // required - buffer for assembling incoming msgs
     size_t inbuf_sz;      // required
@@ -241,7 +248,9 @@ void tftp_session_set_opcode_prefix_use(tftp_session* session,
 // setting.
 // When acting as a client, the default options that will be used when
 // initiating a transfer. If any of the values are not set, it will not be
-// specified in the request packet, and so the tftp defaults will be used.
+// specified in the request packet, and so the tftp defaults will be used
+// (except for window size, which is requested as
+// TFTP_DEFAULT_CLIENT_WINDOWSIZE when not otherwise configured).
 tftp_status tftp_set_options(tftp_session* session,
                              const uint16_t* block_size,
                              const uint8_t* timeout,
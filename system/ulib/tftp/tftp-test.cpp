@@ -219,9 +219,11 @@ static bool test_tftp_generate_request(tftp_file_direction dir,
         EXPECT_TRUE(find_str_in_mem(str, str_sz, msg, ts.outlen),
                     "window size not properly requested");
     } else {
-        str_sz = snprintf(str, sizeof(str), "WINDOWSIZE") + 1;
-        EXPECT_FALSE(find_str_in_mem(str, str_sz, msg, ts.outlen),
-                     "window size shouldn't appear in request");
+        // An unconfigured session still requests the default pipelining window
+        str_sz = snprintf(str, sizeof(str), "WINDOWSIZE%c%d", '\0',
+                          TFTP_DEFAULT_CLIENT_WINDOWSIZE) + 1;
+        EXPECT_TRUE(find_str_in_mem(str, str_sz, msg, ts.outlen),
+                    "default window size not requested");
     }
 
     END_TEST;
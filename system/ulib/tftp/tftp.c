@@ -381,21 +381,23 @@ tftp_status tftp_generate_request(tftp_session* session,
         sent_opts->mask |= TIMEOUT_OPTION;
     }
 
-    if (window_size || session->options.mask & WINDOWSIZE_OPTION) {
-        if (left < kMaxWindowSizeOpt) {
-            return TFTP_ERR_BUFFER_TOO_SMALL;
-        }
-        bool force_value;
-        if (window_size) {
-            force_value = true;
-            sent_opts->window_size = *window_size;
-        } else {
-            force_value = false;
-            sent_opts->window_size = session->options.window_size;
-        }
-        append_option(&body, &left, kWindowSize, force_value, "%"PRIu16, sent_opts->window_size);
-        sent_opts->mask |= WINDOWSIZE_OPTION;
+    if (left < kMaxWindowSizeOpt) {
+        return TFTP_ERR_BUFFER_TOO_SMALL;
+    }
+    bool force_value = false;
+    if (window_size) {
+        force_value = true;
+        sent_opts->window_size = *window_size;
+    } else if (session->options.mask & WINDOWSIZE_OPTION) {
+        sent_opts->window_size = session->options.window_size;
+    } else {
+        // Always ask for a window so transfers are pipelined rather than
+        // RTT-bound; a server without RFC 7440 support will leave the option
+        // out of its OACK and we fall back to lock-step.
+        sent_opts->window_size = TFTP_DEFAULT_CLIENT_WINDOWSIZE;
     }
+    append_option(&body, &left, kWindowSize, force_value, "%"PRIu16, sent_opts->window_size);
+    sent_opts->mask |= WINDOWSIZE_OPTION;
 
     *outlen = *outlen - left;
     // Nothing has been negotiated yet so use default
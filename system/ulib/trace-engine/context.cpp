@@ -87,6 +87,35 @@ namespace {
 // The next context generation number.
 fbl::atomic<uint32_t> g_next_generation{1u};
 
+// Per-thread chunk of the rolling buffer that records are bump-allocated
+// from. A thread reserves |kPerThreadChunkSize| bytes from the shared
+// buffer in one shot and then satisfies subsequent allocations locally,
+// so the shared atomic offset is only touched once per chunk instead of
+// once per record.
+//
+// The chunk is only valid for the context generation and rolling buffer
+// (wrapped count) it was carved from; if either has moved on the chunk is
+// simply abandoned. Abandoning requires no cleanup because the unused
+// tail of a chunk always holds a padding record: the padding header is
+// (re)written after every allocation, so the buffer is parseable at all
+// times no matter when tracing stops or a buffer is saved.
+struct PerThreadChunk {
+    uint32_t generation;
+    uint32_t wrapped_count;
+    uint64_t* current;
+    uint64_t* end;
+};
+
+thread_local PerThreadChunk tls_chunk{};
+
+// Header of a padding record covering |num_words| words (including the
+// header itself). Padding records carry no payload; readers skip them.
+uint64_t MakePaddingHeader(size_t num_words) {
+    return trace::RecordFields::Type::Make(
+               trace::ToUnderlyingType(trace::RecordType::kPadding)) |
+           trace::RecordFields::RecordSize::Make(num_words);
+}
+
 } // namespace
 } // namespace trace
 
@@ -113,6 +142,51 @@ uint64_t* trace_context::AllocRecord(size_t num_bytes) {
         return nullptr;
     static_assert(TRACE_ENCODED_RECORD_MAX_LENGTH < kMaxRollingBufferSize, "");
 
+    // Fast path: bump-allocate from this thread's chunk. The only shared
+    // data touched is a relaxed load of |rolling_buffer_current_| to verify
+    // that the chunk's buffer hasn't been switched out from under us.
+    trace::PerThreadChunk* chunk = &trace::tls_chunk;
+    size_t num_words = num_bytes >> 3;
+    if (likely(chunk->generation == generation_ &&
+               num_words <= static_cast<size_t>(chunk->end - chunk->current) &&
+               chunk->wrapped_count == CurrentWrappedCount())) {
+        uint64_t* ptr = chunk->current;
+        chunk->current += num_words;
+        // Keep the remainder of the chunk parseable.
+        if (chunk->current != chunk->end)
+            *chunk->current = trace::MakePaddingHeader(chunk->end - chunk->current);
+        return ptr;
+    }
+
+    return AllocRecordSlow(num_bytes);
+}
+
+uint64_t* trace_context::AllocRecordSlow(size_t num_bytes) {
+    // Records too large to leave useful space behind in a chunk are
+    // allocated directly from the shared buffer.
+    if (unlikely(num_bytes > kPerThreadChunkSize / 2))
+        return AllocFromSharedBuffer(num_bytes, nullptr);
+
+    // Carve out a fresh chunk and satisfy the allocation from its start.
+    // The old chunk, if any, needs no attention: its unused tail already
+    // holds a padding record.
+    uint32_t wrapped_count;
+    uint64_t* ptr = AllocFromSharedBuffer(kPerThreadChunkSize, &wrapped_count);
+    if (unlikely(!ptr))
+        return nullptr;
+
+    trace::PerThreadChunk* chunk = &trace::tls_chunk;
+    chunk->generation = generation_;
+    chunk->wrapped_count = wrapped_count;
+    chunk->current = ptr + (num_bytes >> 3);
+    chunk->end = ptr + (kPerThreadChunkSize >> 3);
+    if (chunk->current != chunk->end)
+        *chunk->current = trace::MakePaddingHeader(chunk->end - chunk->current);
+    return ptr;
+}
+
+uint64_t* trace_context::AllocFromSharedBuffer(size_t num_bytes,
+                                               uint32_t* out_wrapped_count) {
     // For the circular and streaming cases, try at most once for each buffer.
     // Note: Keep the normal case of one successful pass the fast path.
     // E.g., We don't do a mode comparison unless we have to.
@@ -128,6 +202,8 @@ uint64_t* trace_context::AllocRecord(size_t num_bytes) {
         // Note: There's no worry of an overflow in the calcs here.
         if (likely(buffer_offset + num_bytes <= rolling_buffer_size_)) {
             uint8_t* ptr = rolling_buffer_start_[buffer_number] + buffer_offset;
+            if (out_wrapped_count)
+                *out_wrapped_count = wrapped_count;
             return reinterpret_cast<uint64_t*>(ptr); // success!
         }
 
@@ -69,6 +69,13 @@ struct trace_context {
 
     uint64_t* AllocRecord(size_t num_bytes);
     uint64_t* AllocDurableRecord(size_t num_bytes);
+
+    // The size, in bytes, of the chunks that threads carve out of the
+    // rolling buffers and then bump-allocate records from locally.
+    // The common-case record allocation thus costs a handful of
+    // thread-local instructions rather than contending on
+    // |rolling_buffer_current_| for every record.
+    static constexpr size_t kPerThreadChunkSize = 4096;
     bool AllocThreadIndex(trace_thread_index_t* out_index);
     bool AllocStringIndex(trace_string_index_t* out_index);
 
@@ -200,6 +207,16 @@ private:
 
     void ComputeBufferSizes();
 
+    // Chunk-miss path of |AllocRecord()|: grabs a fresh per-thread chunk
+    // from the shared buffer (or allocates directly for records too large
+    // to be worth chunking).
+    uint64_t* AllocRecordSlow(size_t num_bytes);
+
+    // Reserves |num_bytes| directly from the shared rolling buffer.
+    // On success, if |out_wrapped_count| is non-null it receives the
+    // wrapped count of the buffer the space was reserved in.
+    uint64_t* AllocFromSharedBuffer(size_t num_bytes, uint32_t* out_wrapped_count);
+
     void MarkDurableBufferFull(uint64_t last_offset);
 
     void MarkOneshotBufferFull(uint64_t last_offset);
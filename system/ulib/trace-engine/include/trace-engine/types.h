@@ -357,6 +357,10 @@ enum class RecordType {
     kThread = 3,
     kEvent = 4,
     kBlob = 5,
+    // Padding records carry no information and are skipped by readers.
+    // The engine emits them to cover the unused tails of per-thread
+    // buffer chunks.
+    kPadding = 6,
     kKernelObject = 7,
     kContextSwitch = 8,
     kLog = 9,
@@ -11,6 +11,7 @@
 #include <zircon/status.h>
 #include <zircon/syscalls.h>
 
+#include <trace-engine/buffer_internal.h>
 #include <trace-provider/provider.h>
 #include <lib/zx/vmar.h>
 #include <fbl/type_support.h>
@@ -145,6 +146,13 @@ bool TraceHandlerImpl::ReadFifoMessage() {
         }
         break;
     }
+    case TRACE_PROVIDER_REQUEST_CHUNK_DESCRIPTORS:
+        if (packet.data32 != 0 || packet.data64 != 0) {
+            printf("TraceHandler: Data fields non-zero from TraceManager\n");
+            return false;
+        }
+        send_chunk_descriptors_ = true;
+        break;
     default:
         printf("TraceHandler: Bad request from TraceManager: %u\n",
                packet.request);
@@ -195,6 +203,34 @@ void TraceHandlerImpl::NotifyBufferFull(uint32_t wrapped_count,
     // the fifo buffer.
     ZX_DEBUG_ASSERT(status == ZX_OK ||
                     status == ZX_ERR_PEER_CLOSED);
+
+    if (send_chunk_descriptors_) {
+        SendChunkDescriptor(wrapped_count);
+    }
+}
+
+void TraceHandlerImpl::SendChunkDescriptor(uint32_t wrapped_count) {
+    // By the time the engine asks for a buffer to be saved it has published
+    // the buffer's filled extent in the header, so we can describe the chunk
+    // by reference and TraceManager never has to read the live header.
+    auto header = reinterpret_cast<const trace_buffer_header*>(buffer_);
+    int buffer_number = wrapped_count & 1;
+    uint64_t offset = sizeof(*header) + header->durable_buffer_size +
+                      buffer_number * header->rolling_buffer_size;
+    uint64_t length = header->rolling_data_end[buffer_number];
+    if (offset > UINT32_MAX || length > UINT32_MAX) {
+        // Not representable in the descriptor; TraceManager falls back to
+        // reading the buffer header.
+        return;
+    }
+
+    trace_provider_packet_t packet{};
+    packet.request = TRACE_PROVIDER_SAVE_CHUNK;
+    packet.data32 = wrapped_count;
+    packet.data64 = (offset << 32) | length;
+    auto status = fifo_.write(sizeof(packet), &packet, 1, nullptr);
+    ZX_DEBUG_ASSERT(status == ZX_OK ||
+                    status == ZX_ERR_PEER_CLOSED);
 }
 
 } // namespace internal
@@ -53,9 +53,16 @@ private:
     static zx_status_t MarkBufferSaved(uint32_t wrapped_count,
                                        uint64_t durable_data_end);
 
+    // Sends a TRACE_PROVIDER_SAVE_CHUNK packet describing the filled extent
+    // of rolling buffer |wrapped_count & 1| so TraceManager can save it by
+    // reference.
+    void SendChunkDescriptor(uint32_t wrapped_count);
+
     void* buffer_;
     size_t buffer_num_bytes_;
     zx::fifo fifo_;
+    // Whether TraceManager asked for TRACE_PROVIDER_SAVE_CHUNK descriptors.
+    bool send_chunk_descriptors_ = false;
     async::WaitMethod<TraceHandlerImpl, &TraceHandlerImpl::HandleFifo> fifo_wait_;
     fbl::Vector<fbl::String> const enabled_categories_;
 
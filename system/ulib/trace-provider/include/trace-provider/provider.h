@@ -33,7 +33,9 @@ typedef struct trace_provider_packet {
 
 // The protocol version we are using.
 // This is non-zero to catch initialization bugs.
-#define TRACE_PROVIDER_FIFO_PROTOCOL_VERSION 1
+// Version 2 adds TRACE_PROVIDER_SAVE_CHUNK and
+// TRACE_PROVIDER_REQUEST_CHUNK_DESCRIPTORS.
+#define TRACE_PROVIDER_FIFO_PROTOCOL_VERSION 2
 
 // Provider->Manager
 // Zero is reserved to catch initialization bugs.
@@ -54,7 +56,20 @@ typedef struct trace_provider_packet {
 // Can be removed when garnet side lands.
 #define TRACE_PROVIDER_BUFFER_OVERFLOW (0x2)
 
-// Next Provider->Manager packet = 0x3
+// Provider->Manager
+// Describes the filled chunk of the buffer vmo corresponding to the
+// preceding TRACE_PROVIDER_SAVE_BUFFER request, so the manager can map just
+// that region read-only and stream it out by reference instead of consulting
+// the live buffer header (streaming mode only). Only sent after the manager
+// opts in with TRACE_PROVIDER_REQUEST_CHUNK_DESCRIPTORS.
+// |data32| is the "wrapped count", as in TRACE_PROVIDER_SAVE_BUFFER.
+// |data64| holds the chunk's byte offset within the vmo in the upper 32 bits
+// and its byte length in the lower 32 bits. Chunks whose offset or length
+// do not fit in 32 bits are not described; the manager falls back to reading
+// the buffer header.
+#define TRACE_PROVIDER_SAVE_CHUNK (0x3)
+
+// Next Provider->Manager packet = 0x4
 
 // Manager->Provider
 // A buffer has been saved (streaminng mode only).
@@ -63,7 +78,13 @@ typedef struct trace_provider_packet {
 // |data64| is unused (must be zero).
 #define TRACE_PROVIDER_BUFFER_SAVED (0x100)
 
-// Next Manager->Provider packet = 0x101
+// Manager->Provider
+// Requests that each subsequent TRACE_PROVIDER_SAVE_BUFFER request be
+// followed by a TRACE_PROVIDER_SAVE_CHUNK descriptor (streaming mode only).
+// |data32| and |data64| are unused (must be zero).
+#define TRACE_PROVIDER_REQUEST_CHUNK_DESCRIPTORS (0x101)
+
+// Next Manager->Provider packet = 0x102
 
 // End fifo packet descriptions.
 
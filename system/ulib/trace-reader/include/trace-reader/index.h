@@ -0,0 +1,110 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <trace-reader/reader.h>
+
+#include <fbl/macros.h>
+#include <fbl/vector.h>
+
+#include <stdint.h>
+
+namespace trace {
+
+// A compact side table for a trace file, built in a single cheap pass over
+// the record headers, that makes time-windowed queries possible without
+// re-decoding the trace from byte zero.
+//
+// The index records two things:
+// - the byte offsets of all "definition" records (provider metadata,
+//   initialization, string and thread records), which must be replayed
+//   before any slice of the trace so that string and thread references
+//   resolve, and
+// - one entry per timeslice giving the byte offset of the first timestamped
+//   record at or after the slice boundary.
+//
+// Timeslice entries assume timestamps are approximately monotonic in file
+// order, which holds for single-provider traces and is a good approximation
+// for interleaved ones; window edges are therefore approximate and callers
+// should filter the delivered records by timestamp.
+class TraceIndex {
+public:
+    // Default timeslice width, in ticks.
+    static constexpr uint64_t kDefaultSliceInterval = 1ull << 22;
+
+    explicit TraceIndex(uint64_t slice_interval = kDefaultSliceInterval);
+
+    // Scans record headers in |chunk|, extending the index.  Only headers and
+    // timestamp words are examined; record bodies are skipped.  May be called
+    // repeatedly with new chunks as they become available, like
+    // |TraceReader::ReadRecords|.  Returns false if the stream is
+    // unrecoverably corrupt.
+    bool IndexChunk(Chunk& chunk);
+
+    // Byte offsets of all definition records seen so far, in file order.
+    const fbl::Vector<uint64_t>& definition_offsets() const {
+        return definition_offsets_;
+    }
+
+    uint64_t slice_interval() const { return slice_interval_; }
+    size_t num_slices() const { return slices_.size(); }
+
+    // Total number of bytes indexed so far.
+    uint64_t total_bytes() const { return next_byte_offset_; }
+
+    // Returns in |*out_begin| and |*out_end| the byte range of the trace
+    // covering records with timestamps in [start_time, end_time].
+    void LookupRange(uint64_t start_time, uint64_t end_time,
+                     uint64_t* out_begin, uint64_t* out_end) const;
+
+    // Serializes the index into |*out| as a flat array of words, suitable
+    // for storing alongside the trace file.
+    void Serialize(fbl::Vector<uint64_t>* out) const;
+
+    // Reconstructs an index previously produced by |Serialize|.
+    // Returns false if the data is not a valid serialized index.
+    static bool Deserialize(const uint64_t* data, size_t num_words,
+                            TraceIndex* out);
+
+private:
+    struct Slice {
+        uint64_t start_time;
+        uint64_t byte_offset;
+    };
+
+    // Serialization framing.
+    static constexpr uint64_t kMagic = 0x7472656964786565ull;
+    static constexpr uint64_t kVersion = 1u;
+
+    uint64_t slice_interval_;
+    fbl::Vector<uint64_t> definition_offsets_;
+    fbl::Vector<Slice> slices_;
+
+    // Running byte offset of the next unread record across chunks.
+    uint64_t next_byte_offset_ = 0u;
+    // Slice boundary the next timestamped record is tested against.
+    uint64_t next_slice_time_ = 0u;
+
+    // A record header whose body straddles a chunk boundary, and the offset
+    // of that header, carried over to the next |IndexChunk| call.
+    RecordHeader pending_header_ = 0u;
+    uint64_t pending_record_offset_ = 0u;
+
+    DISALLOW_COPY_ASSIGN_AND_MOVE(TraceIndex);
+};
+
+// Reads the records of the trace in [data, data + num_words) relevant to
+// the time window [start_time, end_time], using |index| to seek: all
+// definition records are replayed first so string and thread references
+// resolve, then only the byte range covering the window is decoded.  The
+// reader's consumer will see the replayed definition records and may see
+// records slightly outside the window; filter by timestamp for exact
+// boundaries.  Returns false if decoding failed.
+bool ReadRecordsInWindow(TraceReader& reader,
+                         const uint64_t* data, size_t num_words,
+                         const TraceIndex& index,
+                         uint64_t start_time, uint64_t end_time);
+
+} // namespace trace
@@ -0,0 +1,201 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <trace-reader/index.h>
+
+#include <trace-engine/fields.h>
+
+#include <fbl/algorithm.h>
+
+namespace trace {
+
+namespace {
+
+// Returns true if records of |type| must be replayed before decoding an
+// arbitrary slice of the trace.
+bool IsDefinitionRecord(RecordType type) {
+    switch (type) {
+    case RecordType::kMetadata:
+    case RecordType::kInitialization:
+    case RecordType::kString:
+    case RecordType::kThread:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns true if the first payload word of records of |type| is a
+// timestamp, in ticks.
+bool HasLeadingTimestamp(RecordType type) {
+    switch (type) {
+    case RecordType::kEvent:
+    case RecordType::kContextSwitch:
+    case RecordType::kLog:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+constexpr uint64_t TraceIndex::kDefaultSliceInterval;
+constexpr uint64_t TraceIndex::kMagic;
+constexpr uint64_t TraceIndex::kVersion;
+
+TraceIndex::TraceIndex(uint64_t slice_interval)
+    : slice_interval_(slice_interval) {
+    ZX_DEBUG_ASSERT(slice_interval > 0);
+}
+
+bool TraceIndex::IndexChunk(Chunk& chunk) {
+    while (true) {
+        if (!pending_header_) {
+            pending_record_offset_ = next_byte_offset_ + chunk.current_byte_offset();
+            if (!chunk.ReadUint64(&pending_header_)) {
+                next_byte_offset_ += chunk.current_byte_offset();
+                return true; // need more data
+            }
+        }
+
+        auto size = RecordFields::RecordSize::Get<size_t>(pending_header_);
+        if (size == 0) {
+            return false; // fatal error
+        }
+
+        Chunk record;
+        if (!chunk.ReadChunk(size - 1, &record)) {
+            // The header word has been consumed; account for it so the
+            // payload's offset lines up when the next chunk arrives.
+            next_byte_offset_ += chunk.current_byte_offset();
+            return true; // need more data
+        }
+
+        auto type = RecordFields::Type::Get<RecordType>(pending_header_);
+        if (IsDefinitionRecord(type)) {
+            definition_offsets_.push_back(pending_record_offset_);
+        } else if (HasLeadingTimestamp(type)) {
+            uint64_t timestamp;
+            if (record.ReadUint64(&timestamp) && timestamp >= next_slice_time_) {
+                slices_.push_back(Slice{timestamp - timestamp % slice_interval_,
+                                        pending_record_offset_});
+                next_slice_time_ = timestamp - timestamp % slice_interval_ + slice_interval_;
+            }
+        }
+
+        pending_header_ = 0u;
+    }
+}
+
+void TraceIndex::LookupRange(uint64_t start_time, uint64_t end_time,
+                             uint64_t* out_begin, uint64_t* out_end) const {
+    // Find the last slice starting at or before |start_time| and the first
+    // slice starting after |end_time|; slices are in both time and offset
+    // order.
+    uint64_t begin = 0u;
+    uint64_t end = next_byte_offset_;
+    size_t lo = 0u, hi = slices_.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (slices_[mid].start_time <= start_time) {
+            begin = slices_[mid].byte_offset;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (size_t i = lo; i < slices_.size(); i++) {
+        if (slices_[i].start_time > end_time) {
+            end = slices_[i].byte_offset;
+            break;
+        }
+    }
+    *out_begin = begin;
+    *out_end = end;
+}
+
+void TraceIndex::Serialize(fbl::Vector<uint64_t>* out) const {
+    out->reserve(out->size() + 6u + definition_offsets_.size() + 2u * slices_.size());
+    out->push_back(kMagic);
+    out->push_back(kVersion);
+    out->push_back(slice_interval_);
+    out->push_back(next_byte_offset_);
+    out->push_back(definition_offsets_.size());
+    out->push_back(slices_.size());
+    for (auto offset : definition_offsets_) {
+        out->push_back(offset);
+    }
+    for (const auto& slice : slices_) {
+        out->push_back(slice.start_time);
+        out->push_back(slice.byte_offset);
+    }
+}
+
+bool TraceIndex::Deserialize(const uint64_t* data, size_t num_words,
+                             TraceIndex* out) {
+    if (num_words < 6u || data[0] != kMagic || data[1] != kVersion ||
+        data[2] == 0u) {
+        return false;
+    }
+    uint64_t num_defs = data[4];
+    uint64_t num_slices = data[5];
+    if (num_defs > num_words || num_slices > num_words ||
+        num_words - 6u < num_defs + 2u * num_slices) {
+        return false;
+    }
+
+    out->slice_interval_ = data[2];
+    out->next_byte_offset_ = data[3];
+    out->next_slice_time_ = 0u;
+    out->definition_offsets_.reset();
+    out->slices_.reset();
+
+    const uint64_t* p = &data[6];
+    for (uint64_t i = 0; i < num_defs; i++) {
+        out->definition_offsets_.push_back(*p++);
+    }
+    for (uint64_t i = 0; i < num_slices; i++) {
+        uint64_t start_time = *p++;
+        uint64_t byte_offset = *p++;
+        out->slices_.push_back(Slice{start_time, byte_offset});
+        out->next_slice_time_ = start_time + out->slice_interval_;
+    }
+    return true;
+}
+
+bool ReadRecordsInWindow(TraceReader& reader,
+                         const uint64_t* data, size_t num_words,
+                         const TraceIndex& index,
+                         uint64_t start_time, uint64_t end_time) {
+    // Replay the definition records so string and thread references within
+    // the window resolve.
+    for (auto offset : index.definition_offsets()) {
+        uint64_t word = offset / sizeof(uint64_t);
+        if (offset % sizeof(uint64_t) != 0 || word >= num_words) {
+            return false;
+        }
+        auto size = RecordFields::RecordSize::Get<size_t>(data[word]);
+        if (size == 0 || word + size > num_words) {
+            return false;
+        }
+        Chunk record(data + word, size);
+        if (!reader.ReadRecords(record)) {
+            return false;
+        }
+    }
+
+    // Decode just the byte range covering the window.
+    uint64_t begin, end;
+    index.LookupRange(start_time, end_time, &begin, &end);
+    if (begin % sizeof(uint64_t) != 0 || end % sizeof(uint64_t) != 0 ||
+        begin > end || end / sizeof(uint64_t) > num_words) {
+        return false;
+    }
+    Chunk window(data + begin / sizeof(uint64_t),
+                 (end - begin) / sizeof(uint64_t));
+    return reader.ReadRecords(window);
+}
+
+} // namespace trace
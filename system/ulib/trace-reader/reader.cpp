@@ -75,6 +75,11 @@ bool TraceReader::ReadRecords(Chunk& chunk) {
             }
             break;
         }
+        case RecordType::kPadding: {
+            // Padding covers the unused tail of a per-thread buffer chunk;
+            // it carries no information, so just skip over it.
+            break;
+        }
         case RecordType::kKernelObject: {
             if (!ReadKernelObjectRecord(record, pending_header_)) {
                 ReportError("Failed to read kernel object record");
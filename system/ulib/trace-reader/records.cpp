@@ -43,7 +43,7 @@ const char* ThreadStateToString(ThreadState state) {
 }
 
 const char* ObjectTypeToString(zx_obj_type_t type) {
-    static_assert(ZX_OBJ_TYPE_LAST == 28, "need to update switch below");
+    static_assert(ZX_OBJ_TYPE_LAST == 29, "need to update switch below");
 
     switch (type) {
     case ZX_OBJ_TYPE_PROCESS:
@@ -92,6 +92,8 @@ const char* ObjectTypeToString(zx_obj_type_t type) {
         return "pmt";
     case ZX_OBJ_TYPE_SUSPEND_TOKEN:
         return "suspend-token";
+    case ZX_OBJ_TYPE_WAIT_SET:
+        return "wait-set";
     default:
         return "???";
     }
@@ -386,6 +388,9 @@ void Record::Destroy() {
     case RecordType::kLog:
         log_.~Log();
         break;
+    case RecordType::kPadding:
+        // Padding records are skipped by the reader and never stored.
+        break;
     }
 }
 
@@ -419,6 +424,9 @@ void Record::MoveFrom(Record&& other) {
     case RecordType::kLog:
         new (&log_) Log(fbl::move(other.log_));
         break;
+    case RecordType::kPadding:
+        // Padding records are skipped by the reader and never stored.
+        break;
     }
 }
 
@@ -470,6 +478,9 @@ fbl::String Record::ToString() const {
         return fbl::StringPrintf("Log(ts: %" PRIu64 ", pt: %s, \"%s\")",
                                   log_.timestamp, log_.process_thread.ToString().c_str(),
                                   log_.message.c_str());
+    case RecordType::kPadding:
+        // Padding records are skipped by the reader and never stored.
+        break;
     }
     ZX_ASSERT(false);
 }
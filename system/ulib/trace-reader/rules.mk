@@ -12,6 +12,7 @@ MODULE_TYPE := userlib
 MODULE_COMPILEFLAGS += -fvisibility=hidden
 
 MODULE_SRCS = \
+    $(LOCAL_DIR)/index.cpp \
     $(LOCAL_DIR)/reader.cpp \
     $(LOCAL_DIR)/reader_internal.cpp \
     $(LOCAL_DIR)/records.cpp
@@ -36,6 +37,7 @@ MODULE_TYPE := hostlib
 MODULE_COMPILEFLAGS += -fvisibility=hidden
 
 MODULE_SRCS = \
+    $(LOCAL_DIR)/index.cpp \
     $(LOCAL_DIR)/reader.cpp \
     $(LOCAL_DIR)/records.cpp
 
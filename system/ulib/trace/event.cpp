@@ -6,12 +6,13 @@
 
 #include <zircon/assert.h>
 #include <zircon/syscalls.h>
+#include <zircon/ticks.h>
 
 namespace {
 
 struct EventHelper {
     EventHelper(trace_context_t* context, const char* name_literal)
-        : ticks(zx_ticks_get()) {
+        : ticks(zx_ticks_get_inline()) {
         trace_context_register_current_thread(context, &thread_ref);
         trace_context_register_string_literal(context, name_literal, &name_ref);
     }
@@ -3,9 +3,16 @@
 // found in the LICENSE file.
 
 #include <endian.h>
+#include <string.h>
 #include <utf_conversion/utf_conversion.h>
 #include <zircon/assert.h>
 
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace {
 
 enum class Endianness {
@@ -33,6 +40,42 @@ struct CodeUnit<Endianness::INVERT> {
     static inline uint16_t Read(uint16_t val) { return __bswap16(val); }
 };
 
+// Number of code units handled per iteration of the bulk-ASCII fast path.
+constexpr size_t kAsciiChunkUnits = 8;
+
+// If the |kAsciiChunkUnits| host-endian code units at |src| are all ASCII
+// (< 0x80), narrow them into |dst| and return true.  Returns false (writing
+// nothing) as soon as any unit in the chunk needs real encoding; the caller
+// falls back to the code-point-at-a-time path.
+inline bool NarrowAsciiChunk(const uint16_t* src, uint8_t* dst) {
+#if defined(__x86_64__)
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i hi = _mm_and_si128(v, _mm_set1_epi16(static_cast<int16_t>(0xFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(hi, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(v, v));
+    return true;
+#elif defined(__aarch64__)
+    uint16x8_t v = vld1q_u16(src);
+    if (vmaxvq_u16(v) >= 0x80) {
+        return false;
+    }
+    vst1_u8(dst, vmovn_u16(v));
+    return true;
+#else
+    uint8_t tmp[kAsciiChunkUnits];
+    for (size_t i = 0; i < kAsciiChunkUnits; i++) {
+        if (src[i] >= 0x80) {
+            return false;
+        }
+        tmp[i] = static_cast<uint8_t>(src[i]);
+    }
+    memcpy(dst, tmp, sizeof(tmp));
+    return true;
+#endif
+}
+
 static constexpr bool IsHighSurrogate(uint16_t val)  { return ((val >= 0xD800) && (val <= 0xDBFF)); }
 static constexpr bool IsLowSurrogate(uint16_t val) { return ((val >= 0xDC00) && (val <= 0xDFFF)); }
 constexpr uint32_t kMaxUnicodeCodePoint = 0x10FFFF;
@@ -100,6 +143,24 @@ zx_status_t Utf16ToUtf8(const uint16_t* src, size_t src_len, uint8_t* dst, size_
     // Process all of our source characters.  Even if we run out of space in our
     // destination, we need to compute the space that we would have needed.
     while (rd < src_len) {
+        // Bulk-convert runs of ASCII code units, which dominate the strings we
+        // see in practice (GPT/FAT labels, log text): a whole chunk is
+        // classified and narrowed at once instead of being encoded unit by
+        // unit.  Only applicable when the source is host endian and the
+        // destination has room for the chunk; the scalar path below handles
+        // everything else, including sizing-only calls.
+        if (E == Endianness::HOST) {
+            while (((src_len - rd) >= kAsciiChunkUnits) &&
+                   (*dst_len > wr) && ((*dst_len - wr) >= kAsciiChunkUnits) &&
+                   NarrowAsciiChunk(&src[rd], &dst[wr])) {
+                rd += kAsciiChunkUnits;
+                wr += kAsciiChunkUnits;
+            }
+            if (rd >= src_len) {
+                break;
+            }
+        }
+
         uint16_t code_unit = CodeUnit<E>::Read(src[rd++]);
         uint32_t code_point;
 
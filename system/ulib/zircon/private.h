@@ -21,6 +21,10 @@ extern "C" {
 
 __LOCAL decltype(zx_ticks_get) CODE_soft_ticks_get;
 
+// The kernel can redirect {_,}zx_clock_get_monotonic here when the
+// monotonic clock is a scaling of the tick counter.  See VDso::Create.
+__LOCAL decltype(zx_clock_get_monotonic) CODE_fast_clock_get_monotonic;
+
 };
 
 // Code should define '_zx_foo' and then do 'VDSO_INTERFACE_FUNCTION(zx_foo);'
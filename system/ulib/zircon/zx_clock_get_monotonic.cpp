@@ -0,0 +1,43 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <zircon/syscalls.h>
+
+#include "private.h"
+
+// At boot time the kernel can decide to redirect the
+// {_,}zx_clock_get_monotonic dynamic symbol table entries to point to this
+// instead of the syscall stub.  It does so when the monotonic clock is a
+// pure scaling of the tick counter zx_ticks_get reads, publishing the
+// conversion factor in DATA_CONSTANTS.  See VDso::Create.
+VDSO_KERNEL_EXPORT zx_time_t CODE_fast_clock_get_monotonic(void) {
+    uint64_t ticks = VDSO_zx_ticks_get();
+
+    // Compute ticks * ns_per_tick with the published 32.64 fixed-point
+    // conversion factor; this is the same arithmetic the kernel's
+    // u64_mul_u64_fp32_64 (lib/fixed_point.h) performs for current_time(),
+    // so the result matches what the syscall would have returned.
+    uint32_t a_r32 = (uint32_t)(ticks >> 32);
+    uint32_t a_0 = (uint32_t)ticks;
+    uint64_t res_0;
+    uint64_t res_l32;
+    uint32_t res_l32_32;
+    uint64_t tmp;
+
+    res_0 = (uint64_t)a_r32 * DATA_CONSTANTS.ns_per_tick_l0 << 32;
+    res_0 += (uint64_t)a_0 * DATA_CONSTANTS.ns_per_tick_l0;
+    res_0 += (uint64_t)a_r32 * DATA_CONSTANTS.ns_per_tick_l32;
+    tmp = (uint64_t)a_0 * DATA_CONSTANTS.ns_per_tick_l32;
+    res_0 += tmp >> 32;
+    res_l32 = (uint32_t)tmp;
+    tmp = (uint64_t)a_r32 * DATA_CONSTANTS.ns_per_tick_l64;
+    res_0 += tmp >> 32;
+    res_l32 += (uint32_t)tmp;
+    tmp = (uint64_t)a_0 * DATA_CONSTANTS.ns_per_tick_l64; // Improve rounding accuracy
+    res_l32 += tmp >> 32;
+    res_0 += res_l32 >> 32;
+    res_l32_32 = (uint32_t)res_l32;
+
+    return res_0 + (res_l32_32 >> 31); // Round to nearest integer
+}
@@ -330,6 +330,56 @@ template <typename RawBitmap> static bool FindSimple(void) {
     END_TEST;
 }
 
+template <typename RawBitmap> static bool FindWithHint(void) {
+    BEGIN_TEST;
+
+    RawBitmap bitmap;
+    EXPECT_EQ(bitmap.Reset(128), ZX_OK);
+    EXPECT_EQ(bitmap.size(), 128U, "get size");
+
+    size_t bitoff_start;
+
+    // Invalid finds
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 0, 1, &bitoff_start), ZX_ERR_INVALID_ARGS,
+              "bad range");
+    EXPECT_EQ(bitmap.FindWithHint(false, 1, 0, 1, &bitoff_start), ZX_ERR_INVALID_ARGS,
+              "bad range");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 1, 1, nullptr), ZX_ERR_INVALID_ARGS, "bad output");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 100, 101, &bitoff_start), ZX_ERR_NO_RESOURCES,
+              "run too long");
+
+    // Allocator-style loop: each successful find advances the hint past the
+    // returned run.
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 4, &bitoff_start), ZX_OK, "find unset");
+    EXPECT_EQ(bitoff_start, 0, "check returned arg");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 4, &bitoff_start), ZX_OK, "find next unset");
+    EXPECT_EQ(bitoff_start, 4, "check returned arg");
+
+    // A freed run below the hint is found via the wrap-around pass.
+    EXPECT_EQ(bitmap.Set(0, 128), ZX_OK, "set range");
+    EXPECT_EQ(bitmap.Clear(10, 20), ZX_OK, "clear range");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 10, &bitoff_start), ZX_OK,
+              "find below hint");
+    EXPECT_EQ(bitoff_start, 10, "check returned arg");
+    EXPECT_EQ(bitmap.Set(10, 20), ZX_OK, "claim found range");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 10, &bitoff_start), ZX_ERR_NO_RESOURCES,
+              "no space");
+
+    // A run straddling the hint is still found.
+    EXPECT_EQ(bitmap.Clear(16, 26), ZX_OK, "clear range");
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 10, &bitoff_start), ZX_OK,
+              "find straddling hint");
+    EXPECT_EQ(bitoff_start, 16, "check returned arg");
+
+    // ClearAll resets the hint.
+    bitmap.ClearAll();
+    EXPECT_EQ(bitmap.FindWithHint(false, 0, 128, 1, &bitoff_start), ZX_OK,
+              "find after clear all");
+    EXPECT_EQ(bitoff_start, 0, "check returned arg");
+
+    END_TEST;
+}
+
 template <typename RawBitmap> static bool ClearAll(void) {
     BEGIN_TEST;
 
@@ -527,6 +577,7 @@ template <typename RawBitmap> static bool GrowFailure(void) {
     RUN_TEMPLATIZED_TEST(GetReturnArg, specialization)                                             \
     RUN_TEMPLATIZED_TEST(SetRange, specialization)                                                 \
     RUN_TEMPLATIZED_TEST(FindSimple, specialization)                                               \
+    RUN_TEMPLATIZED_TEST(FindWithHint, specialization)                                             \
     RUN_TEMPLATIZED_TEST(ClearSubrange, specialization)                                            \
     RUN_TEMPLATIZED_TEST(BoundaryArguments, specialization)                                        \
     RUN_TEMPLATIZED_TEST(ClearAll, specialization)                                                 \
@@ -0,0 +1,146 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cpuperf/reader.h>
+
+#include <string.h>
+
+#include <unittest/unittest.h>
+
+namespace {
+
+constexpr cpuperf_event_id_t kEventId =
+    CPUPERF_MAKE_EVENT_ID(CPUPERF_UNIT_FIXED, 1);
+
+// Appends |record| to |buffer| at offset |*offset|, advancing the offset.
+template <typename T>
+void AppendRecord(uint8_t* buffer, size_t* offset, const T& record) {
+    memcpy(buffer + *offset, &record, sizeof(record));
+    *offset += sizeof(record);
+}
+
+size_t WriteTestBuffer(uint8_t* buffer) {
+    size_t offset = sizeof(cpuperf_buffer_header_t);
+
+    cpuperf_time_record_t time_record{};
+    time_record.header.type = CPUPERF_RECORD_TIME;
+    time_record.header.event = CPUPERF_EVENT_ID_NONE;
+    time_record.time = 1000;
+    AppendRecord(buffer, &offset, time_record);
+
+    cpuperf_tick_record_t tick_record{};
+    tick_record.header.type = CPUPERF_RECORD_TICK;
+    tick_record.header.event = kEventId;
+    AppendRecord(buffer, &offset, tick_record);
+
+    cpuperf_count_record_t count_record{};
+    count_record.header.type = CPUPERF_RECORD_COUNT;
+    count_record.header.event = kEventId;
+    count_record.count = 42;
+    AppendRecord(buffer, &offset, count_record);
+
+    cpuperf_pc_record_t pc_record{};
+    pc_record.header.type = CPUPERF_RECORD_PC;
+    pc_record.header.event = kEventId;
+    pc_record.aspace = 0x1234;
+    pc_record.pc = 0x5678;
+    AppendRecord(buffer, &offset, pc_record);
+
+    cpuperf_buffer_header_t header{};
+    header.version = CPUPERF_BUFFER_VERSION;
+    header.arch = CPUPERF_BUFFER_ARCH_UNKNOWN;
+    header.ticks_per_second = 1000000000;
+    header.capture_end = offset;
+    memcpy(buffer, &header, sizeof(header));
+
+    return offset;
+}
+
+bool read_records_test() {
+    BEGIN_TEST;
+
+    uint8_t buffer[256];
+    memset(buffer, 0, sizeof(buffer));
+    WriteTestBuffer(buffer);
+
+    cpuperf::Reader reader(buffer, sizeof(buffer));
+    ASSERT_TRUE(reader.is_valid());
+    EXPECT_EQ(1000000000, reader.ticks_per_second());
+    EXPECT_EQ(0, reader.time());
+
+    cpuperf::SampleRecord record;
+    ASSERT_TRUE(reader.ReadNextRecord(&record));
+    EXPECT_EQ(CPUPERF_RECORD_TIME, record.type());
+    EXPECT_EQ(1000, record.time->time);
+    EXPECT_EQ(1000, reader.time());
+
+    ASSERT_TRUE(reader.ReadNextRecord(&record));
+    EXPECT_EQ(CPUPERF_RECORD_TICK, record.type());
+    EXPECT_EQ(kEventId, record.event());
+
+    ASSERT_TRUE(reader.ReadNextRecord(&record));
+    EXPECT_EQ(CPUPERF_RECORD_COUNT, record.type());
+    EXPECT_EQ(42, record.count->count);
+
+    ASSERT_TRUE(reader.ReadNextRecord(&record));
+    EXPECT_EQ(CPUPERF_RECORD_PC, record.type());
+    EXPECT_EQ(0x1234, record.pc->aspace);
+    EXPECT_EQ(0x5678, record.pc->pc);
+
+    // The time base from the TIME record still applies at the end.
+    EXPECT_EQ(1000, reader.time());
+
+    EXPECT_FALSE(reader.ReadNextRecord(&record));
+    EXPECT_FALSE(reader.error());
+    EXPECT_EQ(4, reader.num_records_read());
+
+    END_TEST;
+}
+
+bool invalid_buffer_test() {
+    BEGIN_TEST;
+
+    uint8_t buffer[256];
+    memset(buffer, 0, sizeof(buffer));
+    size_t size = WriteTestBuffer(buffer);
+
+    // Unrecognized version.
+    {
+        auto header = reinterpret_cast<cpuperf_buffer_header_t*>(buffer);
+        header->version = CPUPERF_BUFFER_VERSION + 1;
+        cpuperf::Reader reader(buffer, sizeof(buffer));
+        EXPECT_FALSE(reader.is_valid());
+        header->version = CPUPERF_BUFFER_VERSION;
+    }
+
+    // Capture end beyond the buffer.
+    {
+        auto header = reinterpret_cast<cpuperf_buffer_header_t*>(buffer);
+        uint64_t saved_capture_end = header->capture_end;
+        header->capture_end = sizeof(buffer) + 1;
+        cpuperf::Reader reader(buffer, sizeof(buffer));
+        EXPECT_FALSE(reader.is_valid());
+        header->capture_end = saved_capture_end;
+    }
+
+    // A record with an unknown type poisons the rest of the buffer.
+    {
+        buffer[sizeof(cpuperf_buffer_header_t)] = CPUPERF_NUM_RECORD_TYPES;
+        cpuperf::Reader reader(buffer, size);
+        ASSERT_TRUE(reader.is_valid());
+        cpuperf::SampleRecord record;
+        EXPECT_FALSE(reader.ReadNextRecord(&record));
+        EXPECT_TRUE(reader.error());
+        EXPECT_EQ(0, reader.num_records_read());
+    }
+
+    END_TEST;
+}
+
+} // namespace
+
+BEGIN_TEST_CASE(cpuperf_reader_tests)
+RUN_TEST(read_records_test)
+RUN_TEST(invalid_buffer_test)
+END_TEST_CASE(cpuperf_reader_tests)
@@ -0,0 +1,29 @@
+# Copyright 2018 The Fuchsia Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+LOCAL_DIR := $(GET_LOCAL_DIR)
+
+MODULE := $(LOCAL_DIR)
+
+MODULE_TYPE := usertest
+
+MODULE_SRCS := \
+    $(LOCAL_DIR)/main.c \
+    $(LOCAL_DIR)/reader_tests.cpp
+
+MODULE_NAME := cpuperf-test
+
+MODULE_STATIC_LIBS := \
+    system/ulib/cpuperf \
+    system/ulib/zircon-internal \
+    system/ulib/zxcpp \
+    system/ulib/fbl
+
+MODULE_LIBS := \
+    system/ulib/c \
+    system/ulib/fdio \
+    system/ulib/zircon \
+    system/ulib/unittest
+
+include make/module.mk
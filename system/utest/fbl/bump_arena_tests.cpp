@@ -0,0 +1,111 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/alloc_checker.h>
+#include <fbl/bump_arena.h>
+#include <fbl/intrusive_single_list.h>
+#include <unittest/unittest.h>
+
+namespace {
+
+struct Node : public fbl::SinglyLinkedListable<Node*> {
+    explicit Node(int v) : value(v) {}
+    int value;
+};
+
+bool construction_test() {
+    BEGIN_TEST;
+
+    fbl::AllocChecker ac;
+    fbl::BumpArena arena(&ac, 256);
+    ASSERT_TRUE(ac.check());
+    EXPECT_EQ(0u, arena.used());
+    EXPECT_EQ(256u, arena.available());
+
+    Node* node = arena.New<Node>(&ac, 42);
+    ASSERT_TRUE(ac.check());
+    ASSERT_NONNULL(node);
+    EXPECT_EQ(42, node->value);
+    EXPECT_GE(arena.used(), sizeof(Node));
+
+    END_TEST;
+}
+
+bool alignment_test() {
+    BEGIN_TEST;
+
+    fbl::AllocChecker ac;
+    fbl::BumpArena arena(&ac, 256);
+    ASSERT_TRUE(ac.check());
+
+    // Odd-sized carve-outs must not misalign the next one.
+    void* first = arena.Allocate(3);
+    void* second = arena.Allocate(sizeof(uint64_t));
+    ASSERT_NONNULL(first);
+    ASSERT_NONNULL(second);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % alignof(uint64_t));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % alignof(uint64_t));
+
+    END_TEST;
+}
+
+bool exhaustion_test() {
+    BEGIN_TEST;
+
+    fbl::AllocChecker ac;
+    fbl::BumpArena arena(&ac, 64);
+    ASSERT_TRUE(ac.check());
+
+    // Drain the slab, then verify further carve-outs fail cleanly and
+    // arm the checker with a failure.
+    size_t count = 0;
+    while (arena.New<Node>(&ac, 0) != nullptr) {
+        ASSERT_TRUE(ac.check());
+        ++count;
+    }
+    EXPECT_FALSE(ac.check());
+    EXPECT_GT(count, 0u);
+    EXPECT_LT(arena.available(), sizeof(Node));
+
+    // An over-sized request can never succeed.
+    EXPECT_NULL(arena.Allocate(128));
+
+    END_TEST;
+}
+
+bool intrusive_container_test() {
+    BEGIN_TEST;
+
+    fbl::AllocChecker ac;
+    fbl::BumpArena arena(&ac, 1024);
+    ASSERT_TRUE(ac.check());
+
+    // Arena objects may be linked into intrusive containers; the
+    // container just has to let go of them before the arena dies.
+    fbl::SinglyLinkedList<Node*> list;
+    for (int i = 0; i < 10; ++i) {
+        Node* node = arena.New<Node>(&ac, i);
+        ASSERT_TRUE(ac.check());
+        list.push_front(node);
+    }
+
+    int expected = 9;
+    for (const Node& node : list) {
+        EXPECT_EQ(expected, node.value);
+        --expected;
+    }
+
+    list.clear();
+
+    END_TEST;
+}
+
+}  // namespace
+
+BEGIN_TEST_CASE(bump_arena_tests)
+RUN_NAMED_TEST("Construction test", construction_test)
+RUN_NAMED_TEST("Alignment test", alignment_test)
+RUN_NAMED_TEST("Exhaustion test", exhaustion_test)
+RUN_NAMED_TEST("Intrusive container test", intrusive_container_test)
+END_TEST_CASE(bump_arena_tests);
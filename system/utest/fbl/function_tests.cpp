@@ -720,6 +720,34 @@ bool example_code() {
     END_TEST;
 }
 
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+bool heap_spill_count() {
+    BEGIN_TEST;
+
+    fbl::function_reset_heap_spill_count();
+
+    // Small callables stay inline and leave the counter untouched.
+    fbl::Function<Closure> finline([] {});
+    EXPECT_EQ(0u, fbl::function_heap_spill_count());
+
+    // A big capture spills to the heap and is counted; so is replacing
+    // the target with another big callable.
+    fbl::Function<Closure> fheap([big = Big()] {});
+    EXPECT_EQ(1u, fbl::function_heap_spill_count());
+    fheap = [big = Big()] {};
+    EXPECT_EQ(2u, fbl::function_heap_spill_count());
+
+    // Moves hand the existing heap target over without a new spill.
+    fbl::Function<Closure> fmoved(fbl::move(fheap));
+    EXPECT_EQ(2u, fbl::function_heap_spill_count());
+
+    fbl::function_reset_heap_spill_count();
+    EXPECT_EQ(0u, fbl::function_heap_spill_count());
+
+    END_TEST;
+}
+#endif
+
 } // namespace
 
 BEGIN_TEST_CASE(function_tests)
@@ -738,6 +766,9 @@ RUN_TEST(implicit_construction);
 RUN_TEST(bind_member);
 RUN_TEST(null_check);
 RUN_TEST(example_code);
+#if FBL_FUNCTION_TRACE_HEAP_SPILLS
+RUN_TEST(heap_spill_count);
+#endif
 END_TEST_CASE(function_tests)
 
 } // namespace tests
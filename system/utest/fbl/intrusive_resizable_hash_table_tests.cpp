@@ -0,0 +1,200 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/alloc_checker.h>
+#include <fbl/intrusive_resizable_hash_table.h>
+#include <fbl/intrusive_single_list.h>
+#include <fbl/unique_ptr.h>
+#include <unittest/unittest.h>
+
+namespace {
+
+class TestObj : public fbl::SinglyLinkedListable<TestObj*> {
+public:
+    explicit TestObj(uint64_t key) : key_(key) { ++live_obj_count_; }
+    ~TestObj() { --live_obj_count_; }
+
+    uint64_t GetKey() const { return key_; }
+    // Deliberately weak hash function; the table's internal mixing is
+    // responsible for spreading sequential keys across buckets.
+    static size_t GetHash(uint64_t key) { return static_cast<size_t>(key); }
+
+    static size_t live_obj_count() { return live_obj_count_; }
+
+private:
+    const uint64_t key_;
+    static size_t live_obj_count_;
+};
+
+size_t TestObj::live_obj_count_ = 0;
+
+class ManagedTestObj : public fbl::SinglyLinkedListable<fbl::unique_ptr<ManagedTestObj>> {
+public:
+    explicit ManagedTestObj(uint64_t key) : key_(key) {}
+
+    uint64_t GetKey() const { return key_; }
+    static size_t GetHash(uint64_t key) { return static_cast<size_t>(key); }
+
+private:
+    const uint64_t key_;
+};
+
+using UnmanagedHashTable = fbl::ResizableHashTable<uint64_t, TestObj*>;
+using ManagedHashTable = fbl::ResizableHashTable<uint64_t, fbl::unique_ptr<ManagedTestObj>>;
+
+bool basic_lifecycle_test() {
+    BEGIN_TEST;
+
+    UnmanagedHashTable table;
+    EXPECT_TRUE(table.is_empty());
+    EXPECT_EQ(0u, table.size());
+    EXPECT_NULL(table.find(42u));
+
+    TestObj obj_a(42u);
+    TestObj obj_b(43u);
+
+    table.insert(&obj_a);
+    table.insert(&obj_b);
+    EXPECT_EQ(2u, table.size());
+
+    EXPECT_EQ(&obj_a, table.find(42u));
+    EXPECT_EQ(&obj_b, table.find(43u));
+    EXPECT_NULL(table.find(44u));
+
+    EXPECT_EQ(&obj_a, table.erase(42u));
+    EXPECT_NULL(table.find(42u));
+    EXPECT_EQ(&obj_b, table.erase(obj_b));
+    EXPECT_TRUE(table.is_empty());
+
+    END_TEST;
+}
+
+bool insert_or_find_test() {
+    BEGIN_TEST;
+
+    UnmanagedHashTable table;
+    TestObj obj_a(1u);
+    TestObj obj_dup(1u);
+
+    EXPECT_TRUE(table.insert_or_find(&obj_a));
+
+    TestObj* collided = nullptr;
+    EXPECT_FALSE(table.insert_or_find(&obj_dup, &collided));
+    EXPECT_EQ(&obj_a, collided);
+    EXPECT_EQ(1u, table.size());
+
+    EXPECT_EQ(&obj_a, table.erase(1u));
+
+    END_TEST;
+}
+
+bool growth_test() {
+    BEGIN_TEST;
+
+    static constexpr uint64_t kTestObjCount = 1000;
+
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<fbl::unique_ptr<TestObj>[]> objs(
+            new (&ac) fbl::unique_ptr<TestObj>[kTestObjCount]);
+    ASSERT_TRUE(ac.check());
+
+    UnmanagedHashTable table;
+    const auto initial_buckets = UnmanagedHashTable::kInitialBucketCount;
+
+    for (uint64_t i = 0; i < kTestObjCount; ++i) {
+        objs[i].reset(new (&ac) TestObj(i));
+        ASSERT_TRUE(ac.check());
+        table.insert(objs[i].get());
+
+        // Every element inserted so far must remain findable, including ones
+        // parked in the old bucket array mid-rehash.
+        EXPECT_EQ(i + 1, table.size());
+        EXPECT_EQ(objs[0].get(), table.find(0u));
+        EXPECT_EQ(objs[i].get(), table.find(i));
+    }
+
+    // The bucket array must have grown to keep the load factor at or below
+    // 1.0 (growth doubles, so the count stays a power of two).
+    EXPECT_GT(table.bucket_count(), initial_buckets);
+    EXPECT_GE(static_cast<uint64_t>(table.bucket_count()), kTestObjCount);
+
+    // Drain any in-progress rehash via ordinary lookups and verify that the
+    // old array is eventually released.
+    while (table.is_rehashing())
+        EXPECT_NONNULL(table.find(0u));
+
+    for (uint64_t i = 0; i < kTestObjCount; ++i)
+        EXPECT_EQ(objs[i].get(), table.find(i));
+
+    for (uint64_t i = 0; i < kTestObjCount; ++i)
+        EXPECT_EQ(objs[i].get(), table.erase(i));
+
+    EXPECT_TRUE(table.is_empty());
+
+    END_TEST;
+}
+
+bool find_if_erase_if_test() {
+    BEGIN_TEST;
+
+    UnmanagedHashTable table;
+    TestObj obj_a(10u);
+    TestObj obj_b(20u);
+
+    table.insert(&obj_a);
+    table.insert(&obj_b);
+
+    auto match_b = [](const TestObj& obj) { return obj.GetKey() == 20u; };
+    EXPECT_EQ(&obj_b, table.find_if(match_b));
+    EXPECT_EQ(&obj_b, table.erase_if(match_b));
+    EXPECT_NULL(table.find_if(match_b));
+    EXPECT_EQ(1u, table.size());
+
+    EXPECT_EQ(&obj_a, table.erase(10u));
+
+    END_TEST;
+}
+
+bool managed_clear_test() {
+    BEGIN_TEST;
+
+    static constexpr uint64_t kTestObjCount = 100;
+
+    {
+        ManagedHashTable table;
+        fbl::AllocChecker ac;
+
+        for (uint64_t i = 0; i < kTestObjCount; ++i) {
+            fbl::unique_ptr<ManagedTestObj> obj(new (&ac) ManagedTestObj(i));
+            ASSERT_TRUE(ac.check());
+            table.insert(fbl::move(obj));
+        }
+        EXPECT_EQ(kTestObjCount, table.size());
+
+        // clear() must release every reference, completing any in-progress
+        // rehash along the way.
+        table.clear();
+        EXPECT_TRUE(table.is_empty());
+        EXPECT_FALSE(table.is_rehashing());
+
+        // Managed tables may also be destroyed while populated.
+        for (uint64_t i = 0; i < kTestObjCount; ++i) {
+            fbl::unique_ptr<ManagedTestObj> obj(new (&ac) ManagedTestObj(i));
+            ASSERT_TRUE(ac.check());
+            table.insert(fbl::move(obj));
+        }
+    }
+
+    END_TEST;
+}
+
+}  // namespace
+
+BEGIN_TEST_CASE(resizable_hashtable_tests)
+RUN_NAMED_TEST("Basic lifecycle", basic_lifecycle_test)
+RUN_NAMED_TEST("insert_or_find", insert_or_find_test)
+RUN_NAMED_TEST("Incremental growth", growth_test)
+RUN_NAMED_TEST("find_if / erase_if", find_if_erase_if_test)
+RUN_NAMED_TEST("Managed pointers and clear", managed_clear_test)
+END_TEST_CASE(resizable_hashtable_tests)
@@ -421,6 +421,73 @@ static bool WAVLBalanceTest() {
     END_TEST;
 }
 
+static bool WAVLBulkOpsTest() {
+    BEGIN_TEST;
+
+    static constexpr size_t kBulkTestSize = 1024;
+
+    // Declare these in a specific order (object pointer first) so that the tree
+    // has a chance to clean up before the memory backing the objects gets
+    // cleaned up.
+    unique_ptr<BalanceTestObj[]> objects;
+    BalanceTestTree tree;
+
+    {
+        AllocChecker ac;
+        objects.reset(new (&ac) BalanceTestObj[kBulkTestSize]);
+        ASSERT_TRUE(ac.check(), "Failed to allocate test objects!");
+    }
+
+    for (size_t i = 0; i < kBulkTestSize; ++i)
+        objects[i].Init(i);
+
+    WAVLBalanceTestObserver::ResetObserverOpCounts();
+
+    // Bulk load the sorted snapshot, then make sure the result is a valid
+    // WAVL tree which contains every element, in order.
+    size_t ndx = 0;
+    tree.bulk_load(kBulkTestSize,
+                   [&objects, &ndx]() { return BalanceTestObjPtr(&objects[ndx++]); });
+
+    ASSERT_EQ(kBulkTestSize, tree.size());
+    ASSERT_TRUE(WAVLTreeChecker::SanityCheck(tree));
+
+    BalanceTestKeyType expected_key = 0;
+    for (const auto& obj : tree)
+        EXPECT_EQ(expected_key++, obj.GetKey());
+    EXPECT_EQ(kBulkTestSize, expected_key);
+
+    // Erase the middle half of the key space using the key-based (inclusive)
+    // range erase, and verify both the count and the validity of what's left.
+    constexpr BalanceTestKeyType kEraseLow  = kBulkTestSize / 4;
+    constexpr BalanceTestKeyType kEraseHigh = (3 * kBulkTestSize / 4) - 1;
+    size_t erased = tree.erase_range(kEraseLow, kEraseHigh,
+                                     [](BalanceTestObjPtr ptr) {
+                                         EXPECT_NONNULL(ptr.get());
+                                     });
+
+    EXPECT_EQ(static_cast<size_t>(kEraseHigh - kEraseLow + 1), erased);
+    ASSERT_EQ(kBulkTestSize - erased, tree.size());
+    ASSERT_TRUE(WAVLTreeChecker::SanityCheck(tree));
+
+    expected_key = 0;
+    for (const auto& obj : tree) {
+        EXPECT_EQ(expected_key, obj.GetKey());
+        expected_key = (expected_key + 1 == kEraseLow) ? (kEraseHigh + 1) : (expected_key + 1);
+    }
+
+    // Now erase everything which remains using the iterator based form.
+    erased = tree.erase_range(tree.begin(), tree.end());
+    EXPECT_EQ(kBulkTestSize - static_cast<size_t>(kEraseHigh - kEraseLow + 1), erased);
+    EXPECT_EQ(0u, tree.size());
+
+    // An empty bulk load should be legal and leave the tree empty.
+    tree.bulk_load(0, []() { return BalanceTestObjPtr(nullptr); });
+    EXPECT_EQ(0u, tree.size());
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(wavl_tree_tests)
 //////////////////////////////////////////
 // General container specific tests.
@@ -545,6 +612,7 @@ RUN_NAMED_TEST("LowerBound (RefPtr)",            RPTE::LowerBoundTest)
 ////////////////////////////
 // ZX-2230: This can take more than 20 seconds in CI, so mark it medium.
 RUN_NAMED_TEST_MEDIUM("BalanceTest", WAVLBalanceTest)
+RUN_NAMED_TEST("BulkOpsTest", WAVLBulkOpsTest)
 
 END_TEST_CASE(wavl_tree_tests);
 
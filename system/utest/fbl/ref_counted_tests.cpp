@@ -13,6 +13,7 @@
 #include <fbl/auto_lock.h>
 #include <fbl/mutex.h>
 #include <fbl/ref_counted.h>
+#include <fbl/ref_counted_biased.h>
 #include <fbl/ref_ptr.h>
 #include <unittest/unittest.h>
 
@@ -302,9 +303,111 @@ static bool upgrade_success_test() {
     END_TEST;
 }
 
+class BiasedDestructionTracker
+    : public fbl::BiasedRefCounted<BiasedDestructionTracker> {
+public:
+    explicit BiasedDestructionTracker(bool* destroyed)
+        : destroyed_(destroyed) {}
+    ~BiasedDestructionTracker() { *destroyed_ = true; }
+
+private:
+    bool* destroyed_;
+};
+
+static void* biased_inc_and_dec(void* arg) {
+    auto* tracker = reinterpret_cast<BiasedDestructionTracker*>(arg);
+    // Each wrap takes a fresh reference on this (non-owner) thread and
+    // drops it on this thread, exercising the shared count.
+    for (size_t i = 0u; i < 500; ++i) {
+        fbl::RefPtr<BiasedDestructionTracker> ptr(tracker);
+    }
+    return nullptr;
+}
+
+static bool biased_ref_counted_test() {
+    BEGIN_TEST;
+
+    bool destroyed = false;
+    {
+        fbl::AllocChecker ac;
+        // The adopting (main) thread becomes the owner.
+        fbl::RefPtr<BiasedDestructionTracker> ptr =
+            fbl::AdoptRef(new (&ac) BiasedDestructionTracker(&destroyed));
+        EXPECT_TRUE(ac.check());
+        EXPECT_FALSE(destroyed, "should not be destroyed");
+
+        // Owner-thread churn takes the non-atomic path.
+        for (size_t i = 0u; i < 500; ++i) {
+            fbl::RefPtr<BiasedDestructionTracker> copy = ptr;
+        }
+        EXPECT_FALSE(destroyed, "should not be destroyed after owner churn");
+
+        // Remote threads take and drop their own references concurrently
+        // with owner-thread churn.
+        void* arg = reinterpret_cast<void*>(ptr.get());
+        pthread_t threads[5];
+        for (size_t i = 0u; i < fbl::count_of(threads); ++i) {
+            int res = pthread_create(&threads[i], NULL, &biased_inc_and_dec, arg);
+            ASSERT_LE(0, res, "Failed to create biased_inc_and_dec thread!");
+        }
+
+        biased_inc_and_dec(arg);
+
+        for (size_t i = 0u; i < fbl::count_of(threads); ++i)
+            pthread_join(threads[i], NULL);
+
+        EXPECT_FALSE(destroyed, "should not be destroyed after inc/dec pairs");
+    }
+    EXPECT_TRUE(destroyed, "should be when RefPtr falls out of scope");
+    END_TEST;
+}
+
+static bool biased_non_owner_destruction_test() {
+    BEGIN_TEST;
+
+    bool destroyed = false;
+    fbl::AllocChecker ac;
+    fbl::RefPtr<BiasedDestructionTracker> ptr =
+        fbl::AdoptRef(new (&ac) BiasedDestructionTracker(&destroyed));
+    EXPECT_TRUE(ac.check());
+
+    // Drop the owner's last reference first; the bias folds into the
+    // shared count and a reference held by another thread keeps the
+    // object alive until that thread drops it.
+    BiasedDestructionTracker* raw = ptr.get();
+    fbl::RefPtr<BiasedDestructionTracker> remote_ref;
+
+    pthread_t thread;
+    struct Ctx {
+        BiasedDestructionTracker* raw;
+        fbl::RefPtr<BiasedDestructionTracker>* out;
+    } ctx = {raw, &remote_ref};
+    int res = pthread_create(&thread, NULL,
+                             [](void* arg) -> void* {
+                                 auto* c = reinterpret_cast<Ctx*>(arg);
+                                 *c->out = fbl::RefPtr<BiasedDestructionTracker>(c->raw);
+                                 return nullptr;
+                             },
+                             &ctx);
+    ASSERT_LE(0, res, "Failed to create reference-taking thread!");
+    pthread_join(thread, NULL);
+
+    ptr.reset();
+    EXPECT_FALSE(destroyed, "remote reference should keep the object alive");
+
+    // Dropping the remote reference on this thread is fine: the bias was
+    // already revoked, so every thread is on the shared path.
+    remote_ref.reset();
+    EXPECT_TRUE(destroyed, "should be destroyed with the last reference");
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(ref_counted_tests)
 RUN_NAMED_TEST("Ref Counted", ref_counted_test)
 RUN_NAMED_TEST("Make Ref Counted", make_ref_counted_test)
+RUN_NAMED_TEST("Biased Ref Counted", biased_ref_counted_test)
+RUN_NAMED_TEST("Biased non-owner destruction", biased_non_owner_destruction_test)
 RUN_NAMED_TEST("Wrapping dead pointer should assert", wrap_dead_pointer_asserts)
 RUN_NAMED_TEST("Extra release should assert", extra_release_asserts)
 RUN_NAMED_TEST("Wrapping zero-count pointer should assert",
@@ -788,6 +788,106 @@ bool vector_test_initializer_list() {
     END_TEST;
 }
 
+template <typename ItemTraits, size_t size>
+bool vector_test_inline_no_alloc() {
+    using ItemType = typename ItemTraits::ItemType;
+
+    BEGIN_TEST;
+
+    Generator<ItemTraits> gen;
+
+    CountedAllocatorTraits::allocation_count = 0;
+    ASSERT_TRUE(ItemTraits::CheckCtorDtorCount());
+    {
+        fbl::Vector<ItemType, CountedAllocatorTraits, size> vector;
+        ASSERT_EQ(vector.capacity(), size);
+
+        // Filling the inline buffer must not touch the allocator.
+        fbl::AllocChecker ac;
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_TRUE(ItemTraits::CheckLiveCount(i));
+            vector.push_back(gen.NextItem(), &ac);
+            ASSERT_TRUE(ac.check());
+        }
+        ASSERT_EQ(CountedAllocatorTraits::allocation_count, 0);
+
+        // The next element spills the vector to the heap.
+        vector.push_back(gen.NextItem(), &ac);
+        ASSERT_TRUE(ac.check());
+        ASSERT_EQ(CountedAllocatorTraits::allocation_count, 1);
+
+        gen.Reset();
+        for (size_t i = 0; i < size + 1; i++) {
+            ASSERT_EQ(ItemTraits::GetValue(vector[i]), gen.NextValue());
+        }
+        ASSERT_TRUE(ItemTraits::CheckLiveCount(size + 1));
+
+        // Resetting a spilled vector returns it to its inline capacity.
+        vector.reset();
+        ASSERT_EQ(vector.size(), 0);
+        ASSERT_EQ(vector.capacity(), size);
+        ASSERT_TRUE(ItemTraits::CheckLiveCount(0));
+    }
+    ASSERT_TRUE(ItemTraits::CheckLiveCount(0));
+    ASSERT_TRUE(ItemTraits::CheckCtorDtorCount());
+
+    END_TEST;
+}
+
+template <typename ItemTraits, size_t size>
+bool vector_test_inline_move_swap() {
+    using ItemType = typename ItemTraits::ItemType;
+
+    BEGIN_TEST;
+
+    Generator<ItemTraits> gen;
+    ASSERT_TRUE(ItemTraits::CheckCtorDtorCount());
+    {
+        // Move while the elements are still inline.
+        fbl::Vector<ItemType, TestAllocatorTraits, size> vectorA;
+        fbl::AllocChecker ac;
+        for (size_t i = 0; i < size; i++) {
+            vectorA.push_back(gen.NextItem(), &ac);
+            ASSERT_TRUE(ac.check());
+        }
+        fbl::Vector<ItemType, TestAllocatorTraits, size> vectorB(fbl::move(vectorA));
+        ASSERT_EQ(vectorA.size(), 0);
+        ASSERT_EQ(vectorB.size(), size);
+        ASSERT_TRUE(ItemTraits::CheckLiveCount(size));
+        gen.Reset();
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_EQ(ItemTraits::GetValue(vectorB[i]), gen.NextValue());
+        }
+
+        // Swap an inline vector with a heap-backed one.
+        for (size_t i = 0; i < size + 1; i++) {
+            vectorA.push_back(gen.NextItem(), &ac);
+            ASSERT_TRUE(ac.check());
+        }
+        vectorA.swap(vectorB);
+        ASSERT_EQ(vectorA.size(), size);
+        ASSERT_EQ(vectorB.size(), size + 1);
+        ASSERT_TRUE(ItemTraits::CheckLiveCount(size * 2 + 1));
+        gen.Reset();
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_EQ(ItemTraits::GetValue(vectorA[i]), gen.NextValue());
+        }
+        for (size_t i = 0; i < size + 1; i++) {
+            ASSERT_EQ(ItemTraits::GetValue(vectorB[i]), gen.NextValue());
+        }
+
+        // Move assignment drains the heap-backed vector too.
+        vectorA = fbl::move(vectorB);
+        ASSERT_EQ(vectorA.size(), size + 1);
+        ASSERT_EQ(vectorB.size(), 0);
+        ASSERT_TRUE(ItemTraits::CheckLiveCount(size + 1));
+    }
+    ASSERT_TRUE(ItemTraits::CheckLiveCount(0));
+    ASSERT_TRUE(ItemTraits::CheckCtorDtorCount());
+
+    END_TEST;
+}
+
 bool vector_test_implicit_conversion() {
     BEGIN_TEST;
 
@@ -854,6 +954,12 @@ RUN_FOR_ALL(vector_test_swap)
 RUN_FOR_ALL(vector_test_iterator)
 RUN_FOR_ALL(vector_test_insert_delete)
 RUN_FOR_ALL(vector_test_no_alloc_check)
+RUN_TEST((vector_test_inline_no_alloc<ValueTypeTraits, 4>))
+RUN_TEST((vector_test_inline_no_alloc<StructTypeTraits, 4>))
+RUN_TEST((vector_test_inline_no_alloc<UniquePtrTraits, 8>))
+RUN_TEST((vector_test_inline_move_swap<ValueTypeTraits, 4>))
+RUN_TEST((vector_test_inline_move_swap<StructTypeTraits, 4>))
+RUN_TEST((vector_test_inline_move_swap<RefPtrTraits, 8>))
 RUN_TEST(vector_test_initializer_list<ValueTypeTraits>)
 RUN_TEST(vector_test_initializer_list<RefPtrTraits>)
 RUN_TEST(vector_test_implicit_conversion)
@@ -91,9 +91,39 @@ bool message_builder_test() {
     END_TEST;
 }
 
+bool inline_message_buffer_test() {
+    BEGIN_TEST;
+
+    static_assert(fidl::UnownedMessageBuffer::RequiredSize(512u, 4u) ==
+                      512u + 4u * sizeof(zx_handle_t),
+                  "");
+
+    fidl::InlineMessageBuffer<512u, 4u> buffer;
+    EXPECT_EQ(buffer.bytes_capacity(), 512u);
+    EXPECT_EQ(buffer.handles_capacity(), 4u);
+    EXPECT_EQ(reinterpret_cast<uint8_t*>(buffer.handles()),
+              buffer.bytes() + 512u);
+
+    fidl::Builder builder = buffer.CreateBuilder();
+
+    fidl_message_header_t* header = builder.New<fidl_message_header_t>();
+    header->txid = 5u;
+    header->ordinal = 42u;
+
+    zx_handle_t handle_buffer[4u];
+    fidl::Message message(builder.Finalize(),
+                          fidl::HandlePart(handle_buffer, 4u));
+
+    EXPECT_EQ(message.txid(), 5u);
+    EXPECT_EQ(message.ordinal(), 42u);
+
+    END_TEST;
+}
+
 }  // namespace
 
 BEGIN_TEST_CASE(message_tests)
 RUN_NAMED_TEST("Message test", message_test)
 RUN_NAMED_TEST("MessageBuilder test", message_builder_test)
+RUN_NAMED_TEST("InlineMessageBuffer test", inline_message_buffer_test)
 END_TEST_CASE(message_tests);
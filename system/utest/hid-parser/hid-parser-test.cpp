@@ -7,6 +7,7 @@
 
 #include <hid-parser/item.h>
 #include <hid-parser/parser.h>
+#include <hid-parser/report.h>
 #include <hid-parser/usages.h>
 
 #include <unistd.h>
@@ -658,6 +659,62 @@ static bool parse_asus_touch() {
    END_TEST;
 }
 
+static bool extract_boot_mouse_report() {
+    BEGIN_TEST;
+
+    hid::DeviceDescriptor* dev = nullptr;
+    auto res = hid::ParseReportDescriptor(
+        boot_mouse_r_desc, sizeof(boot_mouse_r_desc), &dev);
+    ASSERT_EQ(res, hid::ParseResult::kParseOk);
+
+    hid::ReportProgram* prog = nullptr;
+    res = hid::CompileReportDescriptor(dev, hid::kInput, &prog);
+    ASSERT_EQ(res, hid::ParseResult::kParseOk);
+
+    // No report id byte and a single 3-byte report: 3 buttons, 5 bits of
+    // padding, then X and Y. The padding gets no slot but still advances
+    // the bit cursor.
+    EXPECT_FALSE(prog->has_report_id);
+    ASSERT_EQ(prog->rep_count, 1u);
+
+    const hid::ReportTable& table = prog->report[0];
+    EXPECT_EQ(table.byte_sz, 3u);
+    ASSERT_EQ(table.count, 5u);
+
+    EXPECT_EQ(table.first_slot[0].bit_offset, 0u);
+    EXPECT_EQ(table.first_slot[0].bit_sz, 1);
+    EXPECT_FALSE(table.first_slot[0].is_signed);
+    EXPECT_EQ(table.first_slot[2].bit_offset, 2u);
+    EXPECT_EQ(table.first_slot[3].bit_offset, 8u);
+    EXPECT_EQ(table.first_slot[3].bit_sz, 8);
+    EXPECT_TRUE(table.first_slot[3].is_signed);
+    EXPECT_EQ(table.first_slot[4].bit_offset, 16u);
+
+    // Buttons 1 and 3 pressed, X = -2, Y = 127.
+    const uint8_t report[3] = {0x05, 0xfe, 0x7f};
+    ASSERT_EQ(hid::MatchReportTable(prog, report, sizeof(report)), &table);
+
+    const int32_t expected[5] = {1, 0, 1, -2, 127};
+    for (size_t ix = 0; ix != table.count; ++ix) {
+        int32_t value;
+        EXPECT_TRUE(hid::ExtractFieldValue(prog, report, sizeof(report),
+                                           table.first_slot[ix], &value));
+        EXPECT_EQ(value, expected[ix]);
+    }
+
+    // A short report fails cleanly.
+    int32_t value;
+    EXPECT_FALSE(hid::ExtractFieldValue(prog, report, 1u,
+                                        table.first_slot[4], &value));
+
+    // The boot mouse declares no physical range, so scaling is identity.
+    EXPECT_EQ(hid::ScaleFieldValue(table.first_slot[3], -2), -2);
+
+    hid::FreeReportProgram(prog);
+    hid::FreeDeviceDescriptor(dev);
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(hidparser_tests)
 RUN_TEST(itemize_acer12_rpt1)
 RUN_TEST(itemize_eve_tablet_rpt)
@@ -667,6 +724,7 @@ RUN_TEST(parse_ps3_controller)
 RUN_TEST(parse_acer12_touch)
 RUN_TEST(parse_eve_tablet)
 RUN_TEST(parse_asus_touch)
+RUN_TEST(extract_boot_mouse_report)
 END_TEST_CASE(hidparser_tests)
 
 int main(int argc, char** argv) {
@@ -113,6 +113,28 @@ static bool run_one_argument_size_test(size_t size) {
     END_TEST;
 }
 
+// This test binary is itself started by launchpad, so the self-info page
+// passed via PA_VMO_PROCESS_INFO should have been mapped by libc startup
+// and should agree with what get_info reports.
+static bool proc_info_test(void) {
+    BEGIN_TEST;
+
+    const zx_proc_info_t* proc_info = zx_process_self_info();
+    ASSERT_NONNULL(proc_info, "no process self-info page");
+    EXPECT_EQ(proc_info->magic, ZX_PROC_INFO_MAGIC, "bad magic");
+    EXPECT_EQ(proc_info->version, ZX_PROC_INFO_VERSION, "bad version");
+    EXPECT_GT(proc_info->start_time, 0, "bad start time");
+
+    zx_info_handle_basic_t info;
+    ASSERT_EQ(zx_object_get_info(zx_process_self(), ZX_INFO_HANDLE_BASIC,
+                                 &info, sizeof(info), NULL, NULL),
+              ZX_OK, "");
+    EXPECT_EQ(proc_info->koid, info.koid, "koid mismatch");
+    EXPECT_EQ(proc_info->job_koid, info.related_koid, "job koid mismatch");
+
+    END_TEST;
+}
+
 static bool argument_size_test(void) {
     bool ok = true;
     for (size_t size = 0; size < 2 * PAGE_SIZE; size += 1024) {
@@ -127,6 +149,7 @@ static bool argument_size_test(void) {
 
 BEGIN_TEST_CASE(launchpad_tests)
 RUN_TEST(launchpad_test);
+RUN_TEST(proc_info_test);
 RUN_TEST(argument_size_test);
 END_TEST_CASE(launchpad_tests)
 
@@ -472,6 +472,59 @@ static bool set_chaining_test() {
     END_TEST;
 }
 
+static bool reg_narrow_test() {
+    BEGIN_TEST;
+
+    class TestReg32 : public hwreg::RegisterBase<TestReg32, uint32_t> {
+    public:
+        DEF_NARROW_FIELD(31, 24, top_byte);
+        DEF_NARROW_FIELD(17, 14, split);
+        DEF_NARROW_BIT(13, flag);
+        DEF_RSVDZ_BIT(12);
+        DEF_NARROW_FIELD(7, 0, low_byte);
+
+        static auto Get() { return hwreg::RegisterAddr<TestReg32>(0); }
+    };
+
+    // The access width is selected at compile time from the field layout.
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 31, 24>::kBytes == 1, "");
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 31, 24>::kByteOffset == 3, "");
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 13, 13>::kBytes == 1, "");
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 13, 13>::kByteOffset == 1, "");
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 15, 0>::kBytes == 2, "");
+    static_assert(hwreg::internal::NarrowAccess<uint32_t, 17, 14>::kBytes == 4, "");
+    static_assert(hwreg::internal::NarrowAccess<uint64_t, 39, 32>::kBytes == 1, "");
+    static_assert(hwreg::internal::NarrowAccess<uint64_t, 39, 32>::kByteOffset == 4, "");
+
+    volatile uint32_t fake_reg = 0xdeadbeef;
+    hwreg::RegisterIo mmio(&fake_reg);
+
+    auto reg = TestReg32::Get().FromValue(0);
+    EXPECT_EQ(0xdeu, reg.read_top_byte(&mmio));
+    EXPECT_EQ(1u, reg.read_flag(&mmio));
+    EXPECT_EQ(0xefu, reg.read_low_byte(&mmio));
+
+    // update_* touches only the lane covering the field.
+    reg.update_top_byte(&mmio, 0x12);
+    EXPECT_EQ(0x12adbeefu, fake_reg);
+    // The staged copy is kept in sync.
+    EXPECT_EQ(0x12u, reg.top_byte());
+
+    reg.update_low_byte(&mmio, 0x34);
+    EXPECT_EQ(0x12adbe34u, fake_reg);
+
+    // flag shares its byte lane with the RsvdZ bit 12, which must be
+    // written back as zero.
+    reg.update_flag(&mmio, 0);
+    EXPECT_EQ(0x12ad8e34u, fake_reg);
+
+    // A field spanning byte lanes falls back to a full-width access.
+    reg.update_split(&mmio, 0xf);
+    EXPECT_EQ(0x12afce34u, fake_reg);
+
+    END_TEST;
+}
+
 // Compile-time test that not enabling printing functions provides a size reduction
 static void printer_size_reduction() {
     class TestRegWithPrinter : public hwreg::RegisterBase<TestRegWithPrinter, uint64_t,
@@ -495,6 +548,7 @@ RUN_TEST_FOR_UINTS(struct_sub_field_test)
 RUN_TEST(reg_rsvdz_test)
 RUN_TEST(reg_rsvdz_full_test)
 RUN_TEST(reg_field_test)
+RUN_TEST(reg_narrow_test)
 RUN_TEST(print_test)
 RUN_TEST(set_chaining_test)
 END_TEST_CASE(libhwreg_tests)
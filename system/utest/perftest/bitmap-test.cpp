@@ -0,0 +1,62 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <bitmap/raw-bitmap.h>
+#include <bitmap/storage.h>
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+namespace {
+
+using RawBitmap = bitmap::RawBitmapGeneric<bitmap::DefaultStorage>;
+
+// Measure an allocator-style scan for the first free bit in a bitmap of
+// |size| bits whose prefix is almost entirely set, as minfs's block
+// allocator sees after the volume fills up.  Find() rescans the set prefix
+// on every call.
+bool BitmapFindTest(perftest::RepeatState* state, size_t size) {
+    RawBitmap bitmap;
+    ZX_ASSERT(bitmap.Reset(size) == ZX_OK);
+    ZX_ASSERT(bitmap.Set(0, size - 64) == ZX_OK);
+
+    while (state->KeepRunning()) {
+        size_t bitoff;
+        ZX_ASSERT(bitmap.Find(false, 0, size, 1, &bitoff) == ZX_OK);
+        perftest::DoNotOptimize(bitoff);
+    }
+    return true;
+}
+
+// The same scan via FindWithHint(), which resumes where the previous call
+// left off instead of rescanning the set prefix.
+bool BitmapFindWithHintTest(perftest::RepeatState* state, size_t size) {
+    RawBitmap bitmap;
+    ZX_ASSERT(bitmap.Reset(size) == ZX_OK);
+    ZX_ASSERT(bitmap.Set(0, size - 64) == ZX_OK);
+
+    while (state->KeepRunning()) {
+        size_t bitoff;
+        ZX_ASSERT(bitmap.FindWithHint(false, 0, size, 1, &bitoff) == ZX_OK);
+        perftest::DoNotOptimize(bitoff);
+    }
+    return true;
+}
+
+void RegisterTests() {
+    static const size_t kSizesBits[] = {
+        1 << 10,
+        1 << 16,
+        1 << 20,
+    };
+    for (auto size : kSizesBits) {
+        auto find_name = fbl::StringPrintf("Bitmap/Find/%zubits", size);
+        perftest::RegisterTest(find_name.c_str(), BitmapFindTest, size);
+        auto hint_name = fbl::StringPrintf("Bitmap/FindWithHint/%zubits", size);
+        perftest::RegisterTest(hint_name.c_str(), BitmapFindWithHintTest, size);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -0,0 +1,47 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <lib/cksum.h>
+#include <perftest/perftest.h>
+
+namespace {
+
+// Test performance of crc32() on a block of the given size.  This
+// covers both the table path (small sizes) and the hardware-assisted
+// path used for larger buffers on CPUs that support it.
+bool Crc32Test(perftest::RepeatState* state, size_t size) {
+    state->SetBytesProcessedPerRun(size);
+
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    // Fill with varying data so the checksum is not degenerate.
+    for (size_t i = 0; i < size; ++i) {
+        buf[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    while (state->KeepRunning()) {
+        uint32_t crc = crc32(0, buf.get(), size);
+        perftest::DoNotOptimize(crc);
+    }
+    return true;
+}
+
+void RegisterTests() {
+    static const size_t kSizesBytes[] = {
+        32,        // below the hardware-path threshold
+        1024,
+        65536,
+        1 << 20,   // typical of GPT/FVM metadata and disk-pave images
+    };
+    for (auto size : kSizesBytes) {
+        auto name = fbl::StringPrintf("Crc32/%zubytes", size);
+        perftest::RegisterTest(name.c_str(), Crc32Test, size);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -0,0 +1,422 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+#include <threads.h>
+
+#include <fbl/atomic.h>
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <lib/zx/channel.h>
+#include <lib/zx/event.h>
+#include <lib/zx/fifo.h>
+#include <lib/zx/port.h>
+#include <lib/zx/socket.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/port.h>
+
+// Benchmarks for the kernel IPC primitives: channels, ports, sockets,
+// FIFOs and futexes.  Each primitive is measured both same-thread
+// (write immediately followed by read, isolating syscall cost) and,
+// where it makes sense, as a round trip to an echo thread (adding
+// wakeup and reschedule cost).
+
+namespace {
+
+constexpr uint32_t kMessageSizes[] = {
+    64,
+    1024,
+    65536,  // largest channel message
+};
+
+// --- Channels ---
+
+// Measure writing a message of the given size into a channel and
+// reading it back out on the same thread.
+bool ChannelWriteReadTest(perftest::RepeatState* state, uint32_t size) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+    state->SetBytesProcessedPerRun(size);
+
+    zx::channel local;
+    zx::channel remote;
+    ZX_ASSERT(zx::channel::create(0, &local, &remote) == ZX_OK);
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    memset(buf.get(), 0xaa, size);
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(local.write(0, buf.get(), size, nullptr, 0) == ZX_OK);
+        state->NextStep();
+        uint32_t actual;
+        ZX_ASSERT(remote.read(0, buf.get(), size, &actual, nullptr, 0, nullptr) == ZX_OK);
+    }
+    return true;
+}
+
+struct ChannelEchoArgs {
+    zx_handle_t channel;
+    uint32_t size;
+};
+
+// Echoes messages back over |channel| until the peer is closed.
+int ChannelEchoThread(void* arg) {
+    auto* a = static_cast<ChannelEchoArgs*>(arg);
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[a->size]);
+    for (;;) {
+        zx_signals_t observed;
+        ZX_ASSERT(zx_object_wait_one(a->channel, ZX_CHANNEL_READABLE | ZX_CHANNEL_PEER_CLOSED,
+                                     ZX_TIME_INFINITE, &observed) == ZX_OK);
+        if ((observed & ZX_CHANNEL_READABLE) == 0) {
+            return 0;
+        }
+        uint32_t actual;
+        ZX_ASSERT(zx_channel_read(a->channel, 0, buf.get(), nullptr, a->size, 0, &actual,
+                                  nullptr) == ZX_OK);
+        ZX_ASSERT(zx_channel_write(a->channel, 0, buf.get(), actual, nullptr, 0) == ZX_OK);
+    }
+}
+
+// Measure a round trip of a message of the given size to an echo
+// thread and back, including the cross-thread wakeups.
+bool ChannelEchoTest(perftest::RepeatState* state, uint32_t size) {
+    state->SetBytesProcessedPerRun(size);
+
+    zx::channel local;
+    zx::channel remote;
+    ZX_ASSERT(zx::channel::create(0, &local, &remote) == ZX_OK);
+
+    ChannelEchoArgs args = {remote.get(), size};
+    thrd_t thread;
+    ZX_ASSERT(thrd_create(&thread, ChannelEchoThread, &args) == thrd_success);
+
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    memset(buf.get(), 0xaa, size);
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(local.write(0, buf.get(), size, nullptr, 0) == ZX_OK);
+        zx_signals_t observed;
+        ZX_ASSERT(local.wait_one(ZX_CHANNEL_READABLE, zx::time::infinite(), &observed) == ZX_OK);
+        uint32_t actual;
+        ZX_ASSERT(local.read(0, buf.get(), size, &actual, nullptr, 0, nullptr) == ZX_OK);
+    }
+
+    // Closing our end stops the echo thread.
+    local.reset();
+    int rc;
+    ZX_ASSERT(thrd_join(thread, &rc) == thrd_success);
+    ZX_ASSERT(rc == 0);
+    return true;
+}
+
+// Measure transferring the given number of handles through a channel:
+// duplicating them, writing them, reading them out and closing the
+// received copies.
+bool ChannelWriteHandlesTest(perftest::RepeatState* state, uint32_t num_handles) {
+    state->DeclareStep("duplicate");
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+    state->DeclareStep("close");
+
+    zx::channel local;
+    zx::channel remote;
+    ZX_ASSERT(zx::channel::create(0, &local, &remote) == ZX_OK);
+    zx::event event;
+    ZX_ASSERT(zx::event::create(0, &event) == ZX_OK);
+
+    zx_handle_t handles[8];
+    ZX_ASSERT(num_handles <= fbl::count_of(handles));
+
+    while (state->KeepRunning()) {
+        for (uint32_t i = 0; i < num_handles; ++i) {
+            ZX_ASSERT(zx_handle_duplicate(event.get(), ZX_RIGHT_SAME_RIGHTS, &handles[i]) ==
+                      ZX_OK);
+        }
+        state->NextStep();
+        ZX_ASSERT(local.write(0, nullptr, 0, handles, num_handles) == ZX_OK);
+        state->NextStep();
+        uint32_t actual_handles;
+        ZX_ASSERT(remote.read(0, nullptr, 0, nullptr, handles, num_handles, &actual_handles) ==
+                  ZX_OK);
+        ZX_ASSERT(actual_handles == num_handles);
+        state->NextStep();
+        for (uint32_t i = 0; i < num_handles; ++i) {
+            ZX_ASSERT(zx_handle_close(handles[i]) == ZX_OK);
+        }
+    }
+    return true;
+}
+
+// --- Ports ---
+
+// Measure queueing a user packet to a port and waiting it back out on
+// the same thread.
+bool PortQueueWaitTest(perftest::RepeatState* state) {
+    state->DeclareStep("queue");
+    state->DeclareStep("wait");
+
+    zx::port port;
+    ZX_ASSERT(zx::port::create(0, &port) == ZX_OK);
+    zx_port_packet_t packet = {};
+    packet.type = ZX_PKT_TYPE_USER;
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(port.queue(&packet) == ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(port.wait(zx::time(), &packet) == ZX_OK);
+    }
+    return true;
+}
+
+struct PortEchoArgs {
+    zx_handle_t in;
+    zx_handle_t out;
+};
+
+// Forwards user packets from |in| to |out| until one arrives with
+// u64[0] set, which is the request to stop.
+int PortEchoThread(void* arg) {
+    auto* a = static_cast<PortEchoArgs*>(arg);
+    for (;;) {
+        zx_port_packet_t packet;
+        ZX_ASSERT(zx_port_wait(a->in, ZX_TIME_INFINITE, &packet) == ZX_OK);
+        if (packet.user.u64[0] != 0) {
+            return 0;
+        }
+        ZX_ASSERT(zx_port_queue(a->out, &packet) == ZX_OK);
+    }
+}
+
+// Measure a packet round trip through an echo thread using a pair of
+// ports.
+bool PortEchoTest(perftest::RepeatState* state) {
+    zx::port ping;
+    zx::port pong;
+    ZX_ASSERT(zx::port::create(0, &ping) == ZX_OK);
+    ZX_ASSERT(zx::port::create(0, &pong) == ZX_OK);
+
+    PortEchoArgs args = {ping.get(), pong.get()};
+    thrd_t thread;
+    ZX_ASSERT(thrd_create(&thread, PortEchoThread, &args) == thrd_success);
+
+    zx_port_packet_t packet = {};
+    packet.type = ZX_PKT_TYPE_USER;
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(ping.queue(&packet) == ZX_OK);
+        ZX_ASSERT(pong.wait(zx::time::infinite(), &packet) == ZX_OK);
+    }
+
+    packet.user.u64[0] = 1;
+    ZX_ASSERT(ping.queue(&packet) == ZX_OK);
+    int rc;
+    ZX_ASSERT(thrd_join(thread, &rc) == thrd_success);
+    ZX_ASSERT(rc == 0);
+    return true;
+}
+
+// --- Sockets ---
+
+// Measure writing the given number of bytes into a stream socket and
+// reading them back out on the same thread.
+bool SocketWriteReadTest(perftest::RepeatState* state, uint32_t size) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+    state->SetBytesProcessedPerRun(size);
+
+    zx::socket local;
+    zx::socket remote;
+    ZX_ASSERT(zx::socket::create(0, &local, &remote) == ZX_OK);
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    memset(buf.get(), 0xaa, size);
+
+    while (state->KeepRunning()) {
+        size_t actual;
+        ZX_ASSERT(local.write(0, buf.get(), size, &actual) == ZX_OK);
+        ZX_ASSERT(actual == size);
+        state->NextStep();
+        ZX_ASSERT(remote.read(0, buf.get(), size, &actual) == ZX_OK);
+        ZX_ASSERT(actual == size);
+    }
+    return true;
+}
+
+struct SocketEchoArgs {
+    zx_handle_t socket;
+    uint32_t size;
+};
+
+// Echoes stream data back over |socket| until the peer is closed.
+int SocketEchoThread(void* arg) {
+    auto* a = static_cast<SocketEchoArgs*>(arg);
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[a->size]);
+    for (;;) {
+        zx_signals_t observed;
+        ZX_ASSERT(zx_object_wait_one(a->socket, ZX_SOCKET_READABLE | ZX_SOCKET_PEER_CLOSED,
+                                     ZX_TIME_INFINITE, &observed) == ZX_OK);
+        if ((observed & ZX_SOCKET_READABLE) == 0) {
+            return 0;
+        }
+        size_t actual;
+        ZX_ASSERT(zx_socket_read(a->socket, 0, buf.get(), a->size, &actual) == ZX_OK);
+        size_t written;
+        ZX_ASSERT(zx_socket_write(a->socket, 0, buf.get(), actual, &written) == ZX_OK);
+        ZX_ASSERT(written == actual);
+    }
+}
+
+// Measure a round trip of the given number of bytes to a socket echo
+// thread and back.
+bool SocketEchoTest(perftest::RepeatState* state, uint32_t size) {
+    state->SetBytesProcessedPerRun(size);
+
+    zx::socket local;
+    zx::socket remote;
+    ZX_ASSERT(zx::socket::create(0, &local, &remote) == ZX_OK);
+
+    SocketEchoArgs args = {remote.get(), size};
+    thrd_t thread;
+    ZX_ASSERT(thrd_create(&thread, SocketEchoThread, &args) == thrd_success);
+
+    fbl::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    memset(buf.get(), 0xaa, size);
+
+    while (state->KeepRunning()) {
+        size_t actual;
+        ZX_ASSERT(local.write(0, buf.get(), size, &actual) == ZX_OK);
+        // Stream data may arrive in pieces; read until the whole echo
+        // is back.
+        size_t received = 0;
+        while (received < size) {
+            zx_signals_t observed;
+            ZX_ASSERT(local.wait_one(ZX_SOCKET_READABLE, zx::time::infinite(), &observed) ==
+                      ZX_OK);
+            ZX_ASSERT(local.read(0, buf.get(), size - received, &actual) == ZX_OK);
+            received += actual;
+        }
+    }
+
+    local.reset();
+    int rc;
+    ZX_ASSERT(thrd_join(thread, &rc) == thrd_success);
+    ZX_ASSERT(rc == 0);
+    return true;
+}
+
+// --- FIFOs ---
+
+constexpr size_t kFifoElemSize = 64;
+constexpr size_t kFifoElemCount = 64;
+
+// Measure writing a batch of the given number of elements into a FIFO
+// and reading them back out on the same thread.
+bool FifoWriteReadTest(perftest::RepeatState* state, size_t batch) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+    state->SetBytesProcessedPerRun(batch * kFifoElemSize);
+
+    zx::fifo local;
+    zx::fifo remote;
+    ZX_ASSERT(zx::fifo::create(kFifoElemCount, kFifoElemSize, 0, &local, &remote) == ZX_OK);
+    uint8_t buf[kFifoElemCount * kFifoElemSize];
+    memset(buf, 0xaa, sizeof(buf));
+
+    while (state->KeepRunning()) {
+        size_t actual;
+        ZX_ASSERT(local.write(kFifoElemSize, buf, batch, &actual) == ZX_OK);
+        ZX_ASSERT(actual == batch);
+        state->NextStep();
+        ZX_ASSERT(remote.read(kFifoElemSize, buf, batch, &actual) == ZX_OK);
+        ZX_ASSERT(actual == batch);
+    }
+    return true;
+}
+
+// --- Futexes ---
+
+struct FutexPair {
+    fbl::atomic<int32_t> ping;
+    fbl::atomic<int32_t> pong;
+};
+
+zx_futex_t* FutexPtr(fbl::atomic<int32_t>* value) {
+    static_assert(sizeof(fbl::atomic<int32_t>) == sizeof(zx_futex_t), "futex size mismatch");
+    return reinterpret_cast<zx_futex_t*>(value);
+}
+
+// Waits for pings and replies with pongs until a ping of 2 arrives,
+// which is the request to stop.
+int FutexEchoThread(void* arg) {
+    auto* f = static_cast<FutexPair*>(arg);
+    for (;;) {
+        int32_t v;
+        while ((v = f->ping.load()) == 0) {
+            zx_futex_wait(FutexPtr(&f->ping), 0, ZX_TIME_INFINITE);
+        }
+        if (v == 2) {
+            return 0;
+        }
+        f->ping.store(0);
+        f->pong.store(1);
+        ZX_ASSERT(zx_futex_wake(FutexPtr(&f->pong), 1) == ZX_OK);
+    }
+}
+
+// Measure a futex wake round trip between two threads: wake the echo
+// thread and wait to be woken back.  This is the building block of
+// mutex and condvar handoff.
+bool FutexPingPongTest(perftest::RepeatState* state) {
+    FutexPair futexes;
+    futexes.ping.store(0);
+    futexes.pong.store(0);
+
+    thrd_t thread;
+    ZX_ASSERT(thrd_create(&thread, FutexEchoThread, &futexes) == thrd_success);
+
+    while (state->KeepRunning()) {
+        futexes.ping.store(1);
+        ZX_ASSERT(zx_futex_wake(FutexPtr(&futexes.ping), 1) == ZX_OK);
+        while (futexes.pong.load() == 0) {
+            zx_futex_wait(FutexPtr(&futexes.pong), 0, ZX_TIME_INFINITE);
+        }
+        futexes.pong.store(0);
+    }
+
+    futexes.ping.store(2);
+    ZX_ASSERT(zx_futex_wake(FutexPtr(&futexes.ping), 1) == ZX_OK);
+    int rc;
+    ZX_ASSERT(thrd_join(thread, &rc) == thrd_success);
+    ZX_ASSERT(rc == 0);
+    return true;
+}
+
+void RegisterTests() {
+    for (auto size : kMessageSizes) {
+        auto name = fbl::StringPrintf("Channel/WriteRead/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), ChannelWriteReadTest, size);
+        name = fbl::StringPrintf("Channel/EchoRoundTrip/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), ChannelEchoTest, size);
+        name = fbl::StringPrintf("Socket/WriteRead/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), SocketWriteReadTest, size);
+        name = fbl::StringPrintf("Socket/EchoRoundTrip/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), SocketEchoTest, size);
+    }
+    static const uint32_t kHandleCounts[] = {1, 4, 8};
+    for (auto count : kHandleCounts) {
+        auto name = fbl::StringPrintf("Channel/WriteHandles/%uhandles", count);
+        perftest::RegisterTest(name.c_str(), ChannelWriteHandlesTest, count);
+    }
+    static const size_t kFifoBatches[] = {1, 8};
+    for (auto batch : kFifoBatches) {
+        auto name = fbl::StringPrintf("Fifo/WriteRead/%zuelements", batch);
+        perftest::RegisterTest(name.c_str(), FifoWriteReadTest, batch);
+    }
+    perftest::RegisterTest("Port/QueueWait", PortQueueWaitTest);
+    perftest::RegisterTest("Port/EchoRoundTrip", PortEchoTest);
+    perftest::RegisterTest("Futex/PingPong", FutexPingPongTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
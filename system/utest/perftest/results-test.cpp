@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <unistd.h>
+
 #include <fbl/algorithm.h>
 #include <fbl/unique_ptr.h>
 #include <perftest/results.h>
@@ -70,6 +72,111 @@ static bool test_summary_statistics() {
     END_TEST;
 }
 
+static bool test_robust_statistics() {
+    BEGIN_TEST;
+
+    perftest::ResultsSet results;
+    perftest::TestCaseResults* test_case =
+        results.AddTestCase("results_test", "ExampleNullSyscall", "nanoseconds");
+    // Two leading warmup runs, then stable data with one outlier.
+    test_case->AppendValue(500);
+    test_case->AppendValue(300);
+    for (int i = 0; i < 50; ++i) {
+        test_case->AppendValue(100 + (i % 5));
+    }
+    test_case->AppendValue(900);
+    for (int i = 0; i < 50; ++i) {
+        test_case->AppendValue(100 + (i % 5));
+    }
+
+    perftest::RobustStatistics stats = test_case->GetRobustStatistics();
+    EXPECT_EQ(stats.warmup_runs_dropped, 2u);
+    EXPECT_EQ(stats.outliers_dropped, 1u);
+    EXPECT_EQ(stats.samples_used, 100u);
+    EXPECT_EQ(stats.mean, 102);
+    EXPECT_GT(stats.ci_half_width, 0);
+
+    // A sample with no spread should have nothing discarded.
+    perftest::TestCaseResults* flat_case =
+        results.AddTestCase("results_test", "Flat", "nanoseconds");
+    for (int i = 0; i < 10; ++i) {
+        flat_case->AppendValue(42);
+    }
+    stats = flat_case->GetRobustStatistics();
+    EXPECT_EQ(stats.warmup_runs_dropped, 0u);
+    EXPECT_EQ(stats.outliers_dropped, 0u);
+    EXPECT_EQ(stats.samples_used, 10u);
+    EXPECT_EQ(stats.mean, 42);
+    EXPECT_EQ(stats.std_dev, 0);
+
+    END_TEST;
+}
+
+// Test that reading back JSON output reproduces the original results.
+static bool test_json_read_round_trip() {
+    BEGIN_TEST;
+
+    perftest::ResultsSet results;
+    perftest::TestCaseResults* test_case =
+        results.AddTestCase("results_test", "Example \"quoted\"", "nanoseconds");
+    test_case->bytes_processed_per_run = 4096;
+    test_case->AppendValue(101.5);
+    test_case->AppendValue(102);
+    test_case->AppendValue(99);
+    results.AddTestCase("results_test", "Other", "nanoseconds")
+        ->AppendValue(7);
+
+    const char* filename = "/tmp/perftest-results-test.json";
+    ASSERT_TRUE(results.WriteJSONFile(filename));
+    perftest::ResultsSet readback;
+    ASSERT_TRUE(perftest::ReadJSONFile(filename, &readback));
+    ASSERT_EQ(unlink(filename), 0);
+
+    ASSERT_EQ(readback.results()->size(), 2u);
+    const perftest::TestCaseResults& copy = (*readback.results())[0];
+    EXPECT_STR_EQ("results_test", copy.test_suite.c_str(), "");
+    EXPECT_STR_EQ("Example \"quoted\"", copy.label.c_str(), "");
+    EXPECT_EQ(copy.bytes_processed_per_run, 4096u);
+    ASSERT_EQ(copy.values.size(), 3u);
+    EXPECT_EQ(copy.values[0], 101.5);
+    EXPECT_EQ(copy.values[2], 99);
+    ASSERT_EQ((*readback.results())[1].values.size(), 1u);
+
+    END_TEST;
+}
+
+static bool test_compare_results() {
+    BEGIN_TEST;
+
+    perftest::ResultsSet baseline;
+    perftest::ResultsSet current;
+    auto fill = [](perftest::TestCaseResults* test_case, double base) {
+        for (int i = 0; i < 100; ++i) {
+            test_case->AppendValue(base + (i % 5));
+        }
+    };
+    fill(baseline.AddTestCase("suite", "regressed", "nanoseconds"), 100);
+    fill(current.AddTestCase("suite", "regressed", "nanoseconds"), 130);
+    fill(baseline.AddTestCase("suite", "stable", "nanoseconds"), 100);
+    fill(current.AddTestCase("suite", "stable", "nanoseconds"), 100);
+    fill(baseline.AddTestCase("suite", "improved", "nanoseconds"), 100);
+    fill(current.AddTestCase("suite", "improved", "nanoseconds"), 70);
+    // Test cases with no baseline should not cause a failure.
+    fill(current.AddTestCase("suite", "new_test", "nanoseconds"), 50);
+
+    FILE* log = fopen("/dev/null", "w");
+    ASSERT_NONNULL(log);
+    EXPECT_FALSE(perftest::CompareResults(current, baseline, 0.05, log));
+
+    // Without the regressed test case, the comparison should pass.
+    perftest::ResultsSet current2;
+    fill(current2.AddTestCase("suite", "stable", "nanoseconds"), 100);
+    EXPECT_TRUE(perftest::CompareResults(current2, baseline, 0.05, log));
+    ASSERT_EQ(fclose(log), 0);
+
+    END_TEST;
+}
+
 // Test escaping special characters in strings in JSON output.
 static bool test_json_string_escaping() {
     BEGIN_TEST;
@@ -89,5 +196,8 @@ static bool test_json_string_escaping() {
 BEGIN_TEST_CASE(perf_results_output_tests)
 RUN_TEST(test_json_output)
 RUN_TEST(test_summary_statistics)
+RUN_TEST(test_robust_statistics)
+RUN_TEST(test_json_read_round_trip)
+RUN_TEST(test_compare_results)
 RUN_TEST(test_json_string_escaping)
 END_TEST_CASE(perf_results_output_tests)
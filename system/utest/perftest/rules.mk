@@ -9,8 +9,12 @@ MODULE := $(LOCAL_DIR)
 MODULE_TYPE := usertest
 
 MODULE_SRCS += \
+    $(LOCAL_DIR)/bitmap-test.cpp \
     $(LOCAL_DIR)/clock-test.cpp \
+    $(LOCAL_DIR)/crc32-test.cpp \
+    $(LOCAL_DIR)/fidl-test.cpp \
     $(LOCAL_DIR)/handle-creation-test.cpp \
+    $(LOCAL_DIR)/ipc-test.cpp \
     $(LOCAL_DIR)/malloc-test.cpp \
     $(LOCAL_DIR)/memcpy-test.cpp \
     $(LOCAL_DIR)/mutex-test.cpp \
@@ -20,6 +24,9 @@ MODULE_SRCS += \
     $(LOCAL_DIR)/runner-test.cpp \
     $(LOCAL_DIR)/sleep-test.cpp \
     $(LOCAL_DIR)/syscalls-test.cpp \
+    $(LOCAL_DIR)/utf-conversion-test.cpp \
+    $(LOCAL_DIR)/vector-test.cpp \
+    $(LOCAL_DIR)/zx-wrapper-test.cpp \
 
 MODULE_NAME := perf-test
 
@@ -28,12 +35,16 @@ MODULE_STATIC_LIBS := \
     system/ulib/async-loop \
     system/ulib/async-loop.cpp \
     system/ulib/async.cpp \
+    system/ulib/bitmap \
     system/ulib/fbl \
+    system/ulib/fidl \
     system/ulib/perftest \
     system/ulib/trace \
     system/ulib/trace-provider \
     system/ulib/zx \
+    system/ulib/utf_conversion \
     system/ulib/zxcpp \
+    third_party/ulib/cksum \
 
 MODULE_LIBS := \
     system/ulib/async.default \
@@ -0,0 +1,85 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <perftest/perftest.h>
+#include <utf_conversion/utf_conversion.h>
+
+namespace {
+
+enum class Content {
+    Ascii,    // exercises the bulk-ASCII fast path
+    Mixed,    // ASCII runs broken up by multi-byte code points
+    NonAscii, // every unit needs real encoding
+};
+
+const char* ContentName(Content content) {
+    switch (content) {
+    case Content::Ascii:
+        return "Ascii";
+    case Content::Mixed:
+        return "Mixed";
+    default:
+        return "NonAscii";
+    }
+}
+
+// Test performance of utf16_to_utf8() on a buffer of the given number
+// of code units with the given content mix.
+bool Utf16ToUtf8Test(perftest::RepeatState* state, size_t num_units, Content content) {
+    state->SetBytesProcessedPerRun(num_units * sizeof(uint16_t));
+
+    fbl::unique_ptr<uint16_t[]> src(new uint16_t[num_units]);
+    for (size_t i = 0; i < num_units; ++i) {
+        switch (content) {
+        case Content::Ascii:
+            src[i] = static_cast<uint16_t>('a' + (i % 26));
+            break;
+        case Content::Mixed:
+            src[i] = (i % 16 == 15) ? static_cast<uint16_t>(0x00E9)
+                                    : static_cast<uint16_t>('a' + (i % 26));
+            break;
+        case Content::NonAscii:
+            src[i] = static_cast<uint16_t>(0x4E00 + (i % 256));
+            break;
+        }
+    }
+
+    size_t max_dst = num_units * 3;
+    fbl::unique_ptr<uint8_t[]> dst(new uint8_t[max_dst]);
+
+    while (state->KeepRunning()) {
+        size_t dst_len = max_dst;
+        zx_status_t status = utf16_to_utf8(src.get(), num_units, dst.get(), &dst_len, 0);
+        perftest::DoNotOptimize(status);
+        perftest::DoNotOptimize(dst.get());
+    }
+    return true;
+}
+
+void RegisterTests() {
+    static const size_t kSizesUnits[] = {
+        16,     // typical GPT/FAT label
+        1024,
+        65536,  // bulk log text
+    };
+    static const Content kContents[] = {
+        Content::Ascii,
+        Content::Mixed,
+        Content::NonAscii,
+    };
+    for (auto size : kSizesUnits) {
+        for (auto content : kContents) {
+            auto name = fbl::StringPrintf("Utf16ToUtf8/%s/%zuunits",
+                                          ContentName(content), size);
+            perftest::RegisterTest(name.c_str(), Utf16ToUtf8Test, size, content);
+        }
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
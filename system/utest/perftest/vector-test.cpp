@@ -0,0 +1,55 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/string_printf.h>
+#include <fbl/vector.h>
+#include <perftest/perftest.h>
+
+namespace {
+
+// Measure the time taken to construct a fbl::Vector, push |size| small
+// elements onto it and destroy it.  For a plain Vector every run pays for
+// at least one heap allocation; this establishes the baseline that the
+// inline-storage variant below is intended to avoid.
+bool VectorPushBackTest(perftest::RepeatState* state, size_t size) {
+    while (state->KeepRunning()) {
+        fbl::Vector<int> vector;
+        for (size_t i = 0; i < size; ++i) {
+            vector.push_back(static_cast<int>(i));
+        }
+        perftest::DoNotOptimize(vector.get());
+    }
+    return true;
+}
+
+// As above, but using inline storage sized to fit the workload, so runs
+// never touch the allocator.
+template <size_t inline_count>
+bool InlineVectorPushBackTest(perftest::RepeatState* state, size_t size) {
+    while (state->KeepRunning()) {
+        fbl::InlineVector<int, inline_count> vector;
+        for (size_t i = 0; i < size; ++i) {
+            vector.push_back(static_cast<int>(i));
+        }
+        perftest::DoNotOptimize(vector.get());
+    }
+    return true;
+}
+
+void RegisterTests() {
+    static const size_t kElementCounts[] = {
+        1,
+        4,
+        8,
+    };
+    for (auto count : kElementCounts) {
+        auto name = fbl::StringPrintf("Vector/PushBack/%zuelements", count);
+        perftest::RegisterTest(name.c_str(), VectorPushBackTest, count);
+        name = fbl::StringPrintf("InlineVector/PushBack/%zuelements", count);
+        perftest::RegisterTest(name.c_str(), InlineVectorPushBackTest<8>, count);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -0,0 +1,126 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/zx/channel.h>
+#include <lib/zx/event.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+
+// The zx C++ wrappers are expected to compile down to the raw zx_*
+// syscalls: everything on a hot path is defined inline in the headers,
+// and only the create()-style factories live out of line. These
+// benchmarks pair each wrapper with its raw counterpart so that a
+// regression which moves a thin wrapper out of line (or grows
+// zx::unowned construction) shows up as a gap between the two.
+
+namespace {
+
+constexpr uint32_t kMessageSize = 64;
+
+// Write a small message into a channel and read it back out using the
+// raw syscalls. This is the baseline for the two wrapped variants below.
+bool RawChannelWriteReadTest(perftest::RepeatState* state) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t local;
+    zx_handle_t remote;
+    ZX_ASSERT(zx_channel_create(0, &local, &remote) == ZX_OK);
+    uint8_t buf[kMessageSize] = {};
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(zx_channel_write(local, 0, buf, sizeof(buf), nullptr, 0) == ZX_OK);
+        state->NextStep();
+        uint32_t actual;
+        ZX_ASSERT(zx_channel_read(remote, 0, buf, nullptr, sizeof(buf), 0,
+                                  &actual, nullptr) == ZX_OK);
+    }
+
+    zx_handle_close(local);
+    zx_handle_close(remote);
+    return true;
+}
+
+// The same operation through owned zx::channel objects.
+bool WrappedChannelWriteReadTest(perftest::RepeatState* state) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx::channel local;
+    zx::channel remote;
+    ZX_ASSERT(zx::channel::create(0, &local, &remote) == ZX_OK);
+    uint8_t buf[kMessageSize] = {};
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(local.write(0, buf, sizeof(buf), nullptr, 0) == ZX_OK);
+        state->NextStep();
+        uint32_t actual;
+        ZX_ASSERT(remote.read(0, buf, sizeof(buf), &actual, nullptr, 0,
+                              nullptr) == ZX_OK);
+    }
+    return true;
+}
+
+// The same operation entering through zx::unowned_channel on every
+// iteration, the way code which receives a raw zx_handle_t uses the
+// wrappers.
+bool UnownedChannelWriteReadTest(perftest::RepeatState* state) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx::channel local;
+    zx::channel remote;
+    ZX_ASSERT(zx::channel::create(0, &local, &remote) == ZX_OK);
+    zx_handle_t local_raw = local.get();
+    zx_handle_t remote_raw = remote.get();
+    uint8_t buf[kMessageSize] = {};
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(zx::unowned_channel(local_raw)->write(
+                      0, buf, sizeof(buf), nullptr, 0) == ZX_OK);
+        state->NextStep();
+        uint32_t actual;
+        ZX_ASSERT(zx::unowned_channel(remote_raw)->read(
+                      0, buf, sizeof(buf), &actual, nullptr, 0, nullptr) == ZX_OK);
+    }
+    return true;
+}
+
+// Set and clear a user signal using the raw syscall.
+bool RawEventSignalTest(perftest::RepeatState* state) {
+    zx_handle_t event;
+    ZX_ASSERT(zx_event_create(0, &event) == ZX_OK);
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(zx_object_signal(event, 0, ZX_USER_SIGNAL_0) == ZX_OK);
+        ZX_ASSERT(zx_object_signal(event, ZX_USER_SIGNAL_0, 0) == ZX_OK);
+    }
+
+    zx_handle_close(event);
+    return true;
+}
+
+// The same operation through zx::event.
+bool WrappedEventSignalTest(perftest::RepeatState* state) {
+    zx::event event;
+    ZX_ASSERT(zx::event::create(0, &event) == ZX_OK);
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(event.signal(0, ZX_USER_SIGNAL_0) == ZX_OK);
+        ZX_ASSERT(event.signal(ZX_USER_SIGNAL_0, 0) == ZX_OK);
+    }
+    return true;
+}
+
+void RegisterTests() {
+    perftest::RegisterTest("ZxWrapper/Channel/Raw", RawChannelWriteReadTest);
+    perftest::RegisterTest("ZxWrapper/Channel/Object", WrappedChannelWriteReadTest);
+    perftest::RegisterTest("ZxWrapper/Channel/Unowned", UnownedChannelWriteReadTest);
+    perftest::RegisterTest("ZxWrapper/EventSignal/Raw", RawEventSignalTest);
+    perftest::RegisterTest("ZxWrapper/EventSignal/Object", WrappedEventSignalTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
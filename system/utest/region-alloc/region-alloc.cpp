@@ -294,6 +294,41 @@ static bool ralloc_alloc_walk_test() {
     END_TEST;
 }
 
+static bool ralloc_aligned_frag_test() {
+    BEGIN_TEST;
+
+    RegionAllocator alloc(RegionAllocator::RegionPool::Create(REGION_POOL_MAX_SIZE));
+
+    // Add a large number of single-page fragments whose bases are odd, so a
+    // page-aligned allocation cannot use any of them, plus one double-size
+    // fragment which can absorb the alignment no matter where it starts.
+    // This exercises the padded-size descent GetRegion falls back to instead
+    // of walking every fragment.
+    constexpr uint64_t kPage = 0x1000;
+    constexpr unsigned kFragments = 64;
+    for (unsigned i = 0; i < kFragments; i++) {
+        EXPECT_EQ(ZX_OK, alloc.AddRegion({ .base = (uint64_t(i) << 20) | 1,
+                                           .size = kPage }));
+    }
+    EXPECT_EQ(ZX_OK, alloc.AddRegion({ .base = (uint64_t(kFragments) << 20) | 1,
+                                       .size = 2 * kPage }));
+
+    // The aligned allocation must skip every unaligned fragment and land in
+    // the large one.
+    RegionAllocator::Region::UPtr region;
+    EXPECT_EQ(ZX_OK, alloc.GetRegion(kPage, kPage, region));
+    ASSERT_NONNULL(region);
+    EXPECT_EQ(0u, region->base & (kPage - 1));
+    EXPECT_EQ(kPage, region->size);
+
+    // With the large fragment consumed, the same request must fail even
+    // though plenty of unaligned space remains.
+    RegionAllocator::Region::UPtr region2;
+    EXPECT_EQ(ZX_ERR_NOT_FOUND, alloc.GetRegion(kPage, kPage, region2));
+
+    END_TEST;
+}
+
 } //namespace
 
 BEGIN_TEST_CASE(ralloc_tests)
@@ -303,4 +338,5 @@ RUN_NAMED_TEST("Alloc specific", ralloc_specific_test)
 RUN_NAMED_TEST("Add/Overlap",    ralloc_add_overlap_test)
 RUN_NAMED_TEST("Subtract",       ralloc_subtract_test)
 RUN_NAMED_TEST("Allocated Walk", ralloc_alloc_walk_test)
+RUN_NAMED_TEST("Aligned/Fragmented", ralloc_aligned_frag_test)
 END_TEST_CASE(ralloc_tests)
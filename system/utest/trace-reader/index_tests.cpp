@@ -0,0 +1,178 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <trace-reader/index.h>
+
+#include <stdint.h>
+
+#include <fbl/algorithm.h>
+#include <fbl/vector.h>
+#include <unittest/unittest.h>
+
+namespace {
+
+// A small synthetic trace:
+// word 0:  initialization record (2 words)
+// word 2:  string record, index 1, "hi" (2 words)
+// word 4:  instant event, timestamp 80 (5 words)
+// word 9:  instant event, timestamp 336 (5 words)
+//
+// Events use an inline thread ref (pid/tid in the payload) and empty
+// category/name refs so they decode without further definitions.
+const uint64_t kTrace[] = {
+    // initialization record: type 1, size 2
+    1u | (2ull << 4),
+    100u,
+    // string record: type 2, size 2, index 1, length 2
+    2u | (2ull << 4) | (1ull << 16) | (2ull << 32),
+    0x6968u, // "hi"
+    // instant event: type 4, size 5, inline thread ref, empty string refs
+    4u | (5ull << 4),
+    80u,  // timestamp
+    1u,   // pid
+    2u,   // tid
+    0u,   // scope
+    // instant event, as above
+    4u | (5ull << 4),
+    336u, // timestamp
+    1u,   // pid
+    2u,   // tid
+    0u,   // scope
+};
+
+constexpr uint64_t kSliceInterval = 256u;
+
+trace::TraceReader::RecordConsumer MakeRecordConsumer(
+    fbl::Vector<trace::Record>* out_records) {
+    return [out_records](trace::Record record) {
+        out_records->push_back(fbl::move(record));
+    };
+}
+
+trace::TraceReader::ErrorHandler MakeErrorHandler(fbl::String* out_error) {
+    return [out_error](fbl::String error) {
+        *out_error = fbl::move(error);
+    };
+}
+
+bool index_build_test() {
+    BEGIN_TEST;
+
+    trace::TraceIndex index(kSliceInterval);
+    trace::Chunk chunk(kTrace, fbl::count_of(kTrace));
+    EXPECT_TRUE(index.IndexChunk(chunk));
+
+    EXPECT_EQ(sizeof(kTrace), index.total_bytes());
+
+    ASSERT_EQ(2, index.definition_offsets().size());
+    EXPECT_EQ(0u, index.definition_offsets()[0]);
+    EXPECT_EQ(16u, index.definition_offsets()[1]);
+
+    // One slice per event: timestamps 80 and 336 fall in different slices.
+    EXPECT_EQ(2, index.num_slices());
+
+    uint64_t begin, end;
+    index.LookupRange(0u, 100u, &begin, &end);
+    EXPECT_EQ(32u, begin); // first event record
+    EXPECT_EQ(72u, end);   // second event record
+
+    index.LookupRange(300u, 400u, &begin, &end);
+    EXPECT_EQ(72u, begin);
+    EXPECT_EQ(sizeof(kTrace), end);
+
+    END_TEST;
+}
+
+bool index_split_chunk_test() {
+    BEGIN_TEST;
+
+    // Feeding the trace in two chunks, split mid-record, must produce the
+    // same index as one big chunk.
+    trace::TraceIndex index(kSliceInterval);
+    trace::Chunk first(kTrace, 6u);
+    EXPECT_TRUE(index.IndexChunk(first));
+
+    // Resume with the data the first call did not consume.
+    size_t consumed = first.current_byte_offset() / sizeof(uint64_t);
+    trace::Chunk second(kTrace + consumed, fbl::count_of(kTrace) - consumed);
+    EXPECT_TRUE(index.IndexChunk(second));
+
+    EXPECT_EQ(sizeof(kTrace), index.total_bytes());
+    ASSERT_EQ(2, index.definition_offsets().size());
+    EXPECT_EQ(0u, index.definition_offsets()[0]);
+    EXPECT_EQ(16u, index.definition_offsets()[1]);
+    EXPECT_EQ(2, index.num_slices());
+
+    uint64_t begin, end;
+    index.LookupRange(0u, 100u, &begin, &end);
+    EXPECT_EQ(32u, begin);
+    EXPECT_EQ(72u, end);
+
+    END_TEST;
+}
+
+bool index_serialize_test() {
+    BEGIN_TEST;
+
+    trace::TraceIndex index(kSliceInterval);
+    trace::Chunk chunk(kTrace, fbl::count_of(kTrace));
+    EXPECT_TRUE(index.IndexChunk(chunk));
+
+    fbl::Vector<uint64_t> table;
+    index.Serialize(&table);
+
+    trace::TraceIndex copy;
+    ASSERT_TRUE(trace::TraceIndex::Deserialize(table.get(), table.size(), &copy));
+    EXPECT_EQ(index.slice_interval(), copy.slice_interval());
+    EXPECT_EQ(index.total_bytes(), copy.total_bytes());
+    EXPECT_EQ(index.definition_offsets().size(), copy.definition_offsets().size());
+    EXPECT_EQ(index.num_slices(), copy.num_slices());
+
+    uint64_t begin, end;
+    copy.LookupRange(300u, 400u, &begin, &end);
+    EXPECT_EQ(72u, begin);
+    EXPECT_EQ(sizeof(kTrace), end);
+
+    // Corrupt data must be rejected.
+    EXPECT_FALSE(trace::TraceIndex::Deserialize(table.get(), 3u, &copy));
+    table[0] = 0u;
+    EXPECT_FALSE(trace::TraceIndex::Deserialize(table.get(), table.size(), &copy));
+
+    END_TEST;
+}
+
+bool windowed_read_test() {
+    BEGIN_TEST;
+
+    trace::TraceIndex index(kSliceInterval);
+    trace::Chunk chunk(kTrace, fbl::count_of(kTrace));
+    EXPECT_TRUE(index.IndexChunk(chunk));
+
+    fbl::Vector<trace::Record> records;
+    fbl::String error;
+    trace::TraceReader reader(MakeRecordConsumer(&records),
+                              MakeErrorHandler(&error));
+
+    // A window covering only the second event: the definitions are replayed,
+    // then just that event is decoded.
+    EXPECT_TRUE(trace::ReadRecordsInWindow(reader, kTrace, fbl::count_of(kTrace),
+                                           index, 300u, 400u));
+    EXPECT_TRUE(error.empty());
+    ASSERT_EQ(3, records.size());
+    EXPECT_EQ(trace::RecordType::kInitialization, records[0].type());
+    EXPECT_EQ(trace::RecordType::kString, records[1].type());
+    ASSERT_EQ(trace::RecordType::kEvent, records[2].type());
+    EXPECT_EQ(336u, records[2].GetEvent().timestamp);
+
+    END_TEST;
+}
+
+} // namespace
+
+BEGIN_TEST_CASE(index_tests)
+RUN_TEST(index_build_test)
+RUN_TEST(index_split_chunk_test)
+RUN_TEST(index_serialize_test)
+RUN_TEST(windowed_read_test)
+END_TEST_CASE(index_tests)
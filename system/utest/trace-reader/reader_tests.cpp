@@ -178,6 +178,37 @@ bool empty_buffer_test() {
     END_TEST;
 }
 
+bool padding_record_test() {
+    BEGIN_TEST;
+
+    fbl::Vector<trace::Record> records;
+    fbl::String error;
+    trace::TraceReader reader(MakeRecordConsumer(&records), MakeErrorHandler(&error));
+
+    // A three word padding record, as emitted by the engine to cover the
+    // unused tail of a per-thread buffer chunk, followed by an
+    // initialization record.  The padding must be skipped without
+    // producing a record or an error.
+    uint64_t kData[] = {
+        // padding record: type 6, size 3 words
+        6u | (3ull << 4),
+        0xdeadbeefdeadbeefull,
+        0xdeadbeefdeadbeefull,
+        // initialization record: type 1, size 2 words
+        1u | (2ull << 4),
+        100,
+    };
+
+    trace::Chunk chunk(kData, fbl::count_of(kData));
+    EXPECT_TRUE(reader.ReadRecords(chunk));
+    EXPECT_TRUE(error.empty());
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ(trace::RecordType::kInitialization, records[0].type());
+    EXPECT_EQ(100u, records[0].GetInitialization().ticks_per_second);
+
+    END_TEST;
+}
+
 // NOTE: Most of the reader is covered by the libtrace tests.
 
 } // namespace
@@ -187,4 +218,5 @@ RUN_TEST(empty_chunk_test)
 RUN_TEST(non_empty_chunk_test)
 RUN_TEST(initial_state_test)
 RUN_TEST(empty_buffer_test)
+RUN_TEST(padding_record_test)
 END_TEST_CASE(reader_tests)
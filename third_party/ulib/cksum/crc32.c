@@ -32,6 +32,8 @@
 
 #include <lib/cksum.h>
 
+#include "crc32_accel.h"
+
 /* Definitions for doing the crc four data bytes at a time. */
 #if !defined(NOBYFOUR) && defined(Z_U4)
 #error
@@ -202,6 +204,9 @@ uint32_t ZEXPORT crc32(uint32_t crc, const uint8_t* buf, size_t len)
 {
     if (buf == Z_NULL) return 0UL;
 
+    if (len >= CRC32_ACCEL_MIN && crc32_accel_supported())
+        return crc32_accel(crc, buf, len);
+
 #ifdef DYNAMIC_CRC_TABLE
     if (crc_table_empty)
         make_crc_table();
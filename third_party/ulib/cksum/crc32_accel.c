@@ -0,0 +1,205 @@
+/* crc32_accel.c -- hardware-assisted CRC-32 for the zlib polynomial
+ *
+ * Folds 64 bytes at a time with carry-less multiplies (PCLMULQDQ on
+ * x86-64, following Gopal et al., "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ Instruction", Intel 2009) or uses the
+ * ARMv8 CRC32 extension, which implements this polynomial directly.
+ * The dispatch in crc32() falls back to the table implementation for
+ * short buffers and on CPUs without the relevant instructions.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc32_accel.h"
+
+#if defined(__x86_64__)
+
+#include <cpuid.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+
+int crc32_accel_supported(void)
+{
+    static int supported = -1;
+    if (supported < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                    (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+    }
+    return supported;
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32_accel(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    /* Folding constants for the reflected polynomial 0xEDB88320:
+     * each pair is { x^(n+32) mod P, x^(n-32) mod P } for folding a
+     * 128-bit lane forward by n bits. */
+    static const uint64_t __attribute__((aligned(16))) k1k2[2] =
+        { 0x0000000154442bd4ULL, 0x00000001c6e41596ULL }; /* n = 512 */
+    static const uint64_t __attribute__((aligned(16))) k3k4[2] =
+        { 0x00000001751997d0ULL, 0x00000000ccaa009eULL }; /* n = 128 */
+    static const uint64_t __attribute__((aligned(16))) k5k6[2] =
+        { 0x00000000ccaa009eULL, 0x0000000163cd6124ULL }; /* n = 64 */
+    static const uint64_t __attribute__((aligned(16))) poly[2] =
+        { 0x00000001db710641ULL, 0x00000001f7011641ULL }; /* P, mu */
+
+    __m128i x0, x1, x2, x3, t0;
+    const __m128i k = _mm_load_si128((const __m128i *)k1k2);
+
+    /* caller guarantees len >= CRC32_ACCEL_MIN (>= 64) */
+    x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)buf),
+                       _mm_cvtsi32_si128((int)~crc));
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 16));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 32));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 48));
+    buf += 64;
+    len -= 64;
+
+    /* fold four lanes, 64 bytes per iteration */
+    while (len >= 64) {
+        t0 = _mm_clmulepi64_si128(x0, k, 0x00);
+        x0 = _mm_clmulepi64_si128(x0, k, 0x11);
+        x0 = _mm_xor_si128(x0, t0);
+        x0 = _mm_xor_si128(x0, _mm_loadu_si128((const __m128i *)buf));
+
+        t0 = _mm_clmulepi64_si128(x1, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x1 = _mm_xor_si128(x1, t0);
+        x1 = _mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)(buf + 16)));
+
+        t0 = _mm_clmulepi64_si128(x2, k, 0x00);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x2 = _mm_xor_si128(x2, t0);
+        x2 = _mm_xor_si128(x2, _mm_loadu_si128((const __m128i *)(buf + 32)));
+
+        t0 = _mm_clmulepi64_si128(x3, k, 0x00);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x3 = _mm_xor_si128(x3, t0);
+        x3 = _mm_xor_si128(x3, _mm_loadu_si128((const __m128i *)(buf + 48)));
+
+        buf += 64;
+        len -= 64;
+    }
+
+    /* reduce the four lanes to one */
+    const __m128i kf = _mm_load_si128((const __m128i *)k3k4);
+    t0 = _mm_clmulepi64_si128(x0, kf, 0x00);
+    x0 = _mm_clmulepi64_si128(x0, kf, 0x11);
+    x1 = _mm_xor_si128(x1, t0);
+    x1 = _mm_xor_si128(x1, x0);
+
+    t0 = _mm_clmulepi64_si128(x1, kf, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, kf, 0x11);
+    x2 = _mm_xor_si128(x2, t0);
+    x2 = _mm_xor_si128(x2, x1);
+
+    t0 = _mm_clmulepi64_si128(x2, kf, 0x00);
+    x2 = _mm_clmulepi64_si128(x2, kf, 0x11);
+    x3 = _mm_xor_si128(x3, t0);
+    x3 = _mm_xor_si128(x3, x2);
+
+    /* remaining whole 16-byte blocks */
+    while (len >= 16) {
+        t0 = _mm_clmulepi64_si128(x3, kf, 0x00);
+        x3 = _mm_clmulepi64_si128(x3, kf, 0x11);
+        x3 = _mm_xor_si128(x3, t0);
+        x3 = _mm_xor_si128(x3, _mm_loadu_si128((const __m128i *)buf));
+        buf += 16;
+        len -= 16;
+    }
+
+    /* reduce 128 -> 64 bits */
+    const __m128i kr = _mm_load_si128((const __m128i *)k5k6);
+    t0 = _mm_clmulepi64_si128(x3, kr, 0x00);
+    x3 = _mm_srli_si128(x3, 8);
+    x3 = _mm_xor_si128(x3, t0);
+
+    t0 = _mm_srli_si128(x3, 4);
+    x3 = _mm_and_si128(x3, _mm_set_epi32(0, 0, 0, ~0));
+    x3 = _mm_clmulepi64_si128(x3, kr, 0x10);
+    x3 = _mm_xor_si128(x3, t0);
+
+    /* Barrett reduce 64 -> 32 bits */
+    const __m128i kp = _mm_load_si128((const __m128i *)poly);
+    t0 = _mm_and_si128(x3, _mm_set_epi32(0, 0, 0, ~0));
+    t0 = _mm_clmulepi64_si128(t0, kp, 0x10);
+    t0 = _mm_and_si128(t0, _mm_set_epi32(0, 0, 0, ~0));
+    t0 = _mm_clmulepi64_si128(t0, kp, 0x00);
+    x3 = _mm_xor_si128(x3, t0);
+
+    crc = ~(uint32_t)_mm_extract_epi32(x3, 1);
+
+    /* sub-16-byte tail goes back through the table path */
+    if (len)
+        crc = crc32(crc, buf, len);
+    return crc;
+}
+
+#elif defined(__aarch64__)
+
+#include <arm_acle.h>
+
+#ifdef __Fuchsia__
+#include <zircon/features.h>
+#include <zircon/syscalls.h>
+#endif
+
+int crc32_accel_supported(void)
+{
+    static int supported = -1;
+    if (supported < 0) {
+#if defined(__ARM_FEATURE_CRC32)
+        /* the whole build targets a CPU with the CRC extension */
+        supported = 1;
+#elif defined(__Fuchsia__)
+        uint32_t features = 0;
+        supported = zx_system_get_features(ZX_FEATURE_KIND_CPU, &features) == ZX_OK &&
+                    (features & ZX_ARM64_FEATURE_ISA_CRC32) != 0;
+#else
+        supported = 0;
+#endif
+    }
+    return supported;
+}
+
+__attribute__((target("+crc")))
+uint32_t crc32_accel(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    crc = ~crc;
+    while (((uintptr_t)buf & 7) && len) {
+        crc = __crc32b(crc, *buf++);
+        len--;
+    }
+    while (len >= 8) {
+        crc = __crc32d(crc, *(const uint64_t *)buf);
+        buf += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        crc = __crc32w(crc, *(const uint32_t *)buf);
+        buf += 4;
+        len -= 4;
+    }
+    while (len) {
+        crc = __crc32b(crc, *buf++);
+        len--;
+    }
+    return ~crc;
+}
+
+#else
+
+int crc32_accel_supported(void)
+{
+    return 0;
+}
+
+uint32_t crc32_accel(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    /* never reached: crc32() only dispatches here when supported */
+    return crc32(crc, buf, len);
+}
+
+#endif
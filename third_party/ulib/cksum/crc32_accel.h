@@ -0,0 +1,26 @@
+/* crc32_accel.h -- internal interface between crc32() and the
+ * hardware-assisted implementations in crc32_accel.c
+ */
+
+#ifndef CRC32_ACCEL_H
+#define CRC32_ACCEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/cksum.h>
+
+/* Buffers shorter than this are not worth the fixed folding overhead;
+ * crc32() keeps them on the table path. */
+#define CRC32_ACCEL_MIN 64
+
+/* Returns nonzero if this CPU has instructions usable for the zlib
+ * polynomial (PCLMULQDQ+SSE4.1 on x86-64, the CRC32 extension on
+ * ARMv8).  The probe runs once and is cached. */
+int crc32_accel_supported(void);
+
+/* Equivalent to crc32() for len >= CRC32_ACCEL_MIN; must only be
+ * called when crc32_accel_supported() returned nonzero. */
+uint32_t crc32_accel(uint32_t crc, const uint8_t *buf, size_t len);
+
+#endif /* CRC32_ACCEL_H */
@@ -3,7 +3,8 @@ LOCAL_DIR := $(GET_LOCAL_DIR)
 SHARED_SRCS := \
     $(LOCAL_DIR)/adler32.c \
     $(LOCAL_DIR)/crc16.c \
-    $(LOCAL_DIR)/crc32.c
+    $(LOCAL_DIR)/crc32.c \
+    $(LOCAL_DIR)/crc32_accel.c
 
 SHARED_CFLAGS := -Wno-strict-prototypes
 
@@ -260,6 +260,41 @@ JEMALLOC_EXPORT void JEMALLOC_NOTHROW	je_malloc_stats_print(
 JEMALLOC_EXPORT size_t JEMALLOC_NOTHROW	je_malloc_usable_size(
     JEMALLOC_USABLE_SIZE_CONST void *ptr) JEMALLOC_CXX_THROW;
 
+#ifdef __Fuchsia__
+/*
+ * Zircon extensions.  These are not part of the upstream jemalloc API; they
+ * exist so system services can export allocator statistics to their metrics
+ * pipelines and react to memory pressure without speaking raw mallctl.
+ */
+
+/* Aggregate allocator statistics, filled in by je_zx_malloc_stats_get(). */
+typedef struct zx_malloc_stats_s {
+	size_t		allocated;	/* bytes allocated by the application */
+	size_t		active;		/* bytes in active pages */
+	size_t		metadata;	/* allocator metadata bytes */
+	size_t		resident;	/* bytes in physically resident pages */
+	size_t		mapped;		/* bytes in active extents */
+	size_t		retained;	/* bytes retained but unbacked */
+	unsigned	narenas;	/* number of initialized arenas */
+} zx_malloc_stats_t;
+
+/*
+ * Refreshes the allocator's cached statistics (mallctl "epoch") and copies
+ * the aggregate counters into *stats.  Returns 0 on success or an errno
+ * value from mallctl (e.g. ENOENT when stats are compiled out).
+ */
+JEMALLOC_EXPORT int JEMALLOC_NOTHROW	je_zx_malloc_stats_get(
+    zx_malloc_stats_t *stats);
+
+/*
+ * Sheds allocator caches in response to memory pressure: flushes the calling
+ * thread's tcache and purges the dirty pages of every arena.  Intended to be
+ * called from the C library's memory-pressure handler once the kernel
+ * delivers such events; callers may also invoke it directly.
+ */
+JEMALLOC_EXPORT int JEMALLOC_NOTHROW	je_zx_malloc_memory_pressure(void);
+#endif
+
 #ifdef JEMALLOC_OVERRIDE_MEMALIGN
 JEMALLOC_EXPORT JEMALLOC_ALLOCATOR JEMALLOC_RESTRICT_RETURN
     void JEMALLOC_NOTHROW	*je_memalign(size_t alignment, size_t size)
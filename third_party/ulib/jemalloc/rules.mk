@@ -33,5 +33,6 @@ LOCAL_SRCS += \
     $(GET_LOCAL_DIR)/src/tsd.c \
     $(GET_LOCAL_DIR)/src/util.c \
     $(GET_LOCAL_DIR)/src/witness.c \
+    $(GET_LOCAL_DIR)/src/zircon.c \
 
 LOCAL_CFLAGS += -I$(GET_LOCAL_DIR)/include
@@ -0,0 +1,64 @@
+#define	JEMALLOC_ZIRCON_C_
+#include "jemalloc/internal/jemalloc_internal.h"
+
+/*
+ * Zircon-specific extensions: a stats exporter and a memory-pressure hook
+ * layered on top of mallctl.  See the "Zircon extensions" section of
+ * jemalloc.h for the public contract.
+ */
+
+int
+je_zx_malloc_stats_get(zx_malloc_stats_t *stats)
+{
+	uint64_t epoch = 1;
+	size_t sz;
+	int err;
+
+	if (stats == NULL)
+		return (EINVAL);
+
+	/* Refresh the cached statistics before reading them. */
+	sz = sizeof(epoch);
+	err = je_mallctl("epoch", &epoch, &sz, &epoch, sizeof(epoch));
+	if (err != 0)
+		return (err);
+
+#define	ZX_STATS_GET(n, v) do {						\
+	sz = sizeof(stats->v);						\
+	err = je_mallctl(n, &stats->v, &sz, NULL, 0);			\
+	if (err != 0)							\
+		return (err);						\
+} while (0)
+	ZX_STATS_GET("stats.allocated", allocated);
+	ZX_STATS_GET("stats.active", active);
+	ZX_STATS_GET("stats.metadata", metadata);
+	ZX_STATS_GET("stats.resident", resident);
+	ZX_STATS_GET("stats.mapped", mapped);
+	ZX_STATS_GET("stats.retained", retained);
+	ZX_STATS_GET("arenas.narenas", narenas);
+#undef ZX_STATS_GET
+
+	return (0);
+}
+
+int
+je_zx_malloc_memory_pressure(void)
+{
+	size_t mib[3];
+	size_t miblen = sizeof(mib) / sizeof(size_t);
+	int err;
+
+	/*
+	 * Drop the calling thread's cache first so its cached regions are
+	 * returned to their arenas and become purgeable below.  Ignore the
+	 * error in case tcache is compiled out or disabled.
+	 */
+	je_mallctl("thread.tcache.flush", NULL, NULL, NULL, 0);
+
+	/* Return every arena's dirty pages to the operating system. */
+	err = je_mallctlnametomib("arena.0.purge", mib, &miblen);
+	if (err != 0)
+		return (err);
+	mib[1] = MALLCTL_ARENAS_ALL;
+	return (je_mallctlbymib(mib, miblen, NULL, NULL, NULL, 0));
+}
@@ -0,0 +1,50 @@
+/*
+   LZ4MT - multi-threaded LZ4 frame compression
+   Zircon-local addition layered on the LZ4 frame format.
+
+   Splits an input buffer into independent blocks and compresses each
+   as a complete LZ4 frame on a pool of worker threads; the output is
+   the frames concatenated in input order.  Concatenated frames are
+   valid input for any conforming LZ4 frame decoder (including
+   LZ4F_decompress and the lz4 uapp), so readers need no changes.
+
+   The trade-off versus one big frame is a few dozen bytes of header
+   per block and no cross-block matches; with multi-MB blocks the
+   ratio loss is well under 1%.
+*/
+#pragma once
+
+#include <stddef.h>
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* Default block size: large enough that per-frame overhead and the
+ * lost cross-block matches are noise, small enough to load-balance
+ * across workers. */
+#define LZ4MT_DEFAULT_BLOCK_SIZE (4u << 20)
+
+/* Worst-case output size for LZ4MT_compressFrames() with the given
+ * parameters; size dst accordingly.  Returns 0 if the parameters are
+ * invalid. */
+size_t LZ4MT_compressBound(size_t src_len, size_t block_size);
+
+/* Compress src_len bytes from src into dst as a sequence of
+ * independent LZ4 frames, block_size input bytes per frame, using up
+ * to num_workers threads (the calling thread counts as one; values
+ * < 1 are treated as 1).  block_size of 0 selects
+ * LZ4MT_DEFAULT_BLOCK_SIZE.  compression_level follows
+ * LZ4F_preferences_t.compressionLevel.
+ *
+ * Returns the number of bytes written to dst, or an LZ4F error code
+ * (test with LZ4F_isError()). */
+size_t LZ4MT_compressFrames(void* dst, size_t dst_capacity,
+                            const void* src, size_t src_len,
+                            size_t block_size,
+                            int compression_level,
+                            int num_workers);
+
+#if defined (__cplusplus)
+}
+#endif
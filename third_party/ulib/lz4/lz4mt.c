@@ -0,0 +1,149 @@
+/*
+   LZ4MT - multi-threaded LZ4 frame compression
+   Zircon-local addition; see include/lz4/lz4mt.h for the interface
+   contract.
+
+   Each input block becomes a complete, independent LZ4 frame, so
+   workers never share compression state.  Blocks are claimed from a
+   shared atomic counter (self-balancing when block compressibility
+   varies) and compressed in place into the caller's output buffer at
+   stride LZ4F_compressFrameBound(block_size); once all workers have
+   joined, the frames are compacted front-to-back into their final,
+   densely packed positions.  Compacting in input order with memmove is
+   safe because the write cursor can never pass a block's staging
+   offset.
+*/
+#include <lz4/lz4mt.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lz4/lz4frame.h>
+#include <lz4/lz4frame_static.h>
+
+typedef struct {
+    const uint8_t* src;
+    size_t src_len;
+    uint8_t* dst;
+    size_t stride;          /* per-block staging stride in dst */
+    size_t block_size;
+    size_t nblocks;
+    LZ4F_preferences_t prefs;
+    size_t* sizes;          /* per-block compressed size or LZ4F error */
+    atomic_size_t next;     /* next unclaimed block index */
+} lz4mt_job_t;
+
+static size_t lz4mt_block_size(size_t block_size) {
+    return block_size ? block_size : LZ4MT_DEFAULT_BLOCK_SIZE;
+}
+
+static size_t lz4mt_nblocks(size_t src_len, size_t block_size) {
+    /* An empty input still produces one (empty) frame so the output is
+     * always a decodable stream. */
+    if (src_len == 0)
+        return 1;
+    return (src_len + block_size - 1) / block_size;
+}
+
+/* The frame bound depends only on the frame parameters, not on the
+ * compression level, so compressBound and compressFrames agree on the
+ * stride regardless of the level the caller picks. */
+static size_t lz4mt_stride(size_t block_size) {
+    return LZ4F_compressFrameBound(block_size, NULL);
+}
+
+size_t LZ4MT_compressBound(size_t src_len, size_t block_size) {
+    block_size = lz4mt_block_size(block_size);
+    return lz4mt_nblocks(src_len, block_size) * lz4mt_stride(block_size);
+}
+
+static void* lz4mt_worker(void* arg) {
+    lz4mt_job_t* job = arg;
+    for (;;) {
+        size_t i = atomic_fetch_add(&job->next, 1);
+        if (i >= job->nblocks)
+            break;
+        size_t off = i * job->block_size;
+        size_t len = job->src_len - off;
+        if (len > job->block_size)
+            len = job->block_size;
+        job->sizes[i] = LZ4F_compressFrame(job->dst + i * job->stride, job->stride,
+                                           job->src + off, len, &job->prefs);
+    }
+    return NULL;
+}
+
+size_t LZ4MT_compressFrames(void* dst, size_t dst_capacity,
+                            const void* src, size_t src_len,
+                            size_t block_size,
+                            int compression_level,
+                            int num_workers) {
+    if (dst == NULL || (src == NULL && src_len != 0))
+        return (size_t)-LZ4F_ERROR_GENERIC;
+
+    block_size = lz4mt_block_size(block_size);
+    if (dst_capacity < LZ4MT_compressBound(src_len, block_size))
+        return (size_t)-LZ4F_ERROR_dstMaxSize_tooSmall;
+
+    lz4mt_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.src = src;
+    job.src_len = src_len;
+    job.dst = dst;
+    job.stride = lz4mt_stride(block_size);
+    job.block_size = block_size;
+    job.nblocks = lz4mt_nblocks(src_len, block_size);
+    job.prefs.compressionLevel = compression_level;
+    atomic_init(&job.next, 0);
+
+    job.sizes = malloc(job.nblocks * sizeof(*job.sizes));
+    if (job.sizes == NULL)
+        return (size_t)-LZ4F_ERROR_allocation_failed;
+
+    size_t nthreads = (num_workers < 1) ? 1 : (size_t)num_workers;
+    if (nthreads > job.nblocks)
+        nthreads = job.nblocks;
+
+    /* The calling thread is worker zero; only the extras need spawning.
+     * A failed pthread_create just means fewer workers: the atomic
+     * claim loop redistributes the blocks, so correctness is
+     * unaffected. */
+    pthread_t* threads = NULL;
+    size_t spawned = 0;
+    if (nthreads > 1) {
+        threads = malloc((nthreads - 1) * sizeof(*threads));
+        if (threads != NULL) {
+            for (size_t i = 0; i < nthreads - 1; i++) {
+                if (pthread_create(&threads[spawned], NULL, lz4mt_worker, &job) != 0)
+                    break;
+                spawned++;
+            }
+        }
+    }
+
+    lz4mt_worker(&job);
+
+    for (size_t i = 0; i < spawned; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+
+    /* Compact the staged frames into a contiguous stream, bailing on
+     * the first per-block error. */
+    size_t total = 0;
+    uint8_t* out = dst;
+    for (size_t i = 0; i < job.nblocks; i++) {
+        size_t sz = job.sizes[i];
+        if (LZ4F_isError(sz)) {
+            total = sz;
+            break;
+        }
+        memmove(out + total, out + i * job.stride, sz);
+        total += sz;
+    }
+
+    free(job.sizes);
+    return total;
+}
@@ -4,6 +4,7 @@ SHARED_SRCS := \
     $(LOCAL_DIR)/lz4.c \
     $(LOCAL_DIR)/lz4frame.c \
     $(LOCAL_DIR)/lz4hc.c \
+    $(LOCAL_DIR)/lz4mt.c \
     $(LOCAL_DIR)/xxhash.c
 
 SHARED_CFLAGS := \
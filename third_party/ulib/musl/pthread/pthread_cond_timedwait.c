@@ -22,6 +22,11 @@ struct waiter {
     atomic_int state;
     atomic_int barrier;
     atomic_int* notify;
+    /* Futex of the mutex this waiter will reacquire, set only for mutex
+     * types that record their owner.  It lets __private_cond_signal()
+     * requeue the waiter directly onto the mutex when the signaling
+     * thread still owns it.  NULL means wake normally. */
+    atomic_int* mutex_futex;
 };
 
 enum {
@@ -50,6 +55,12 @@ int pthread_cond_timedwait(pthread_cond_t* restrict c, pthread_mutex_t* restrict
     };
     atomic_int* fut = &node.barrier;
 
+    /* Only mutex types that track their owner let a signaler prove it
+     * still holds the mutex, which is what makes requeueing us onto the
+     * mutex (instead of waking us into immediate contention) safe. */
+    if ((m->_m_type & PTHREAD_MUTEX_MASK) != PTHREAD_MUTEX_NORMAL)
+        node.mutex_futex = &m->_m_lock;
+
     /* Add our waiter node onto the condvar's list.  We add the node to the
      * head of the list, but this is logically the end of the queue. */
     node.next = c->_c_head;
@@ -206,7 +217,32 @@ void __private_cond_signal(void* condvar, int n) {
     while ((cur = atomic_load(&ref)))
         __wait(&ref, 0, cur);
 
-    /* Allow first signaled waiter, if any, to proceed. */
-    if (first)
-        unlock(&first->barrier);
+    /* Allow first signaled waiter, if any, to proceed.  Waiters after the
+     * first are requeued onto the mutex in turn by each woken predecessor
+     * (see unlock_requeue() above), so only the first normally pays a
+     * wake -> contend -> sleep round trip.  If the waiter advertised its
+     * mutex and the calling thread still owns it, avoid even that: mark
+     * the mutex contended and requeue the waiter directly onto its futex,
+     * so pthread_mutex_unlock() wakes it once the mutex is actually
+     * available.  Holding the mutex is what makes this race-free -- no
+     * unlock can slip in between marking the mutex and the requeue and
+     * strand the waiter.  The contended bit is consumed by the next
+     * unlock, so a waiter that times out before the requeue lands costs
+     * at most one spurious wake. */
+    if (first) {
+        atomic_int* mf = first->mutex_futex;
+        if (mf && (atomic_load(mf) & PTHREAD_MUTEX_OWNED_LOCK_MASK) ==
+                      __thread_get_tid()) {
+            for (;;) {
+                int mval = atomic_load(mf);
+                if (mval & PTHREAD_MUTEX_OWNED_LOCK_BIT)
+                    break;
+                if (a_cas_shim(mf, mval, mval | PTHREAD_MUTEX_OWNED_LOCK_BIT) == mval)
+                    break;
+            }
+            unlock_requeue(&first->barrier, mf);
+        } else {
+            unlock(&first->barrier);
+        }
+    }
 }
@@ -121,6 +121,7 @@ __NO_SAFESTACK _Noreturn void __libc_start_main(
 
     // Find the handles we're interested in among what we were given.
     zx_handle_t main_thread_handle = ZX_HANDLE_INVALID;
+    zx_handle_t proc_info_vmo = ZX_HANDLE_INVALID;
     for (uint32_t i = 0; i < p.nhandles; ++i) {
         switch (PA_HND_TYPE(p.handle_info[i])) {
         case PA_PROC_SELF:
@@ -161,9 +162,21 @@ __NO_SAFESTACK _Noreturn void __libc_start_main(
             handles[i] = ZX_HANDLE_INVALID;
             p.handle_info[i] = 0;
             break;
+
+        case PA_VMO_PROCESS_INFO:
+            proc_info_vmo = handles[i];
+            handles[i] = ZX_HANDLE_INVALID;
+            p.handle_info[i] = 0;
+            break;
         }
     }
 
+    // Map the self-info page, if our creator provided one, so that
+    // zx_process_self_info() works without any syscalls.  This has to
+    // wait until after the loop so the root VMAR handle is in place.
+    if (proc_info_vmo != ZX_HANDLE_INVALID)
+        __libc_init_process_info(proc_info_vmo);
+
     atomic_store(&libc.thread_count, 1);
 
     // This consumes the thread handle and sets up the thread pointer.
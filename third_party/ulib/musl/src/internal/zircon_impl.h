@@ -8,6 +8,14 @@ extern zx_handle_t __zircon_process_self ATTR_LIBC_VISIBILITY;
 extern zx_handle_t __zircon_vmar_root_self ATTR_LIBC_VISIBILITY;
 extern zx_handle_t __zircon_job_default ATTR_LIBC_VISIBILITY;
 
+// Read-only self-info page provided via PA_VMO_PROCESS_INFO, or NULL if
+// the process creator did not provide one.
+extern const zx_proc_info_t* __zircon_process_info ATTR_LIBC_VISIBILITY;
+
+// Maps the PA_VMO_PROCESS_INFO page and points __zircon_process_info at
+// it.  Consumes (and closes) |vmo|.
+void __libc_init_process_info(zx_handle_t vmo) ATTR_LIBC_VISIBILITY;
+
 #define _zx_process_self() (__zircon_process_self + 0)
 #define _zx_vmar_root_self() (__zircon_vmar_root_self + 0)
 #define _zx_job_default() (__zircon_job_default + 0)
@@ -4,7 +4,9 @@
 
 #include <zircon/process.h>
 #include <zircon/syscalls.h>
+#include <stdatomic.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 static pthread_rwlock_t allocation_lock = PTHREAD_RWLOCK_INITIALIZER;
@@ -36,7 +38,55 @@ static ptrdiff_t offset_for_module(const struct tls_module* module) {
 #endif
 }
 
-__NO_SAFESTACK static thrd_t copy_tls(unsigned char* mem, size_t alloc) {
+// Pre-composed image of every module's TLS initializer laid out at its
+// final offset, so that a new thread's static TLS area can be filled with
+// a single memcpy instead of one per module.  The module offsets relative
+// to the thread pointer are fixed process-wide by the Initial Exec ABI,
+// so one image serves every thread.  The image is composed lazily under
+// the allocation read lock (which keeps the module list stable) and is
+// keyed on (tls_cnt, tls_size); a dlopen that brings in new TLS modules
+// changes those and causes recomposition.  A superseded image is leaked
+// rather than freed, since another thread may still be copying from it;
+// TLS-bearing dlopens are rare and bounded by the module count.
+struct tls_template {
+    size_t cnt;        // libc.tls_cnt this image was composed against
+    size_t size;       // libc.tls_size likewise
+    ptrdiff_t lo;      // span start, relative to the aligned TLS base
+    size_t len;        // initialized span length in bytes
+    unsigned char data[];
+};
+
+static _Atomic(struct tls_template*) tls_template;
+
+static struct tls_template* compose_tls_template(void) {
+    struct tls_module* p = libc.tls_head;
+    ptrdiff_t lo = offset_for_module(p);
+    ptrdiff_t hi = lo;
+
+    for (; p; p = p->next) {
+        ptrdiff_t off = offset_for_module(p);
+        if (off < lo)
+            lo = off;
+        if (off + (ptrdiff_t)p->len > hi)
+            hi = off + (ptrdiff_t)p->len;
+    }
+
+    struct tls_template* tmpl = calloc(1, sizeof(*tmpl) + (hi - lo));
+    if (tmpl == NULL)
+        return NULL;
+    tmpl->cnt = libc.tls_cnt;
+    tmpl->size = libc.tls_size;
+    tmpl->lo = lo;
+    tmpl->len = hi - lo;
+    for (p = libc.tls_head; p; p = p->next)
+        memcpy(tmpl->data + (offset_for_module(p) - lo), p->image, p->len);
+
+    atomic_store(&tls_template, tmpl);
+    return tmpl;
+}
+
+__NO_SAFESTACK static thrd_t copy_tls(unsigned char* mem, size_t alloc,
+                                      bool use_template) {
     thrd_t td;
     struct tls_module* p;
     size_t i;
@@ -79,9 +129,27 @@ __NO_SAFESTACK static thrd_t copy_tls(unsigned char* mem, size_t alloc) {
     td = (thrd_t)mem;
 #endif
 
-    for (i = 1, p = libc.tls_head; p; i++, p = p->next) {
-        dtv[i] = mem + offset_for_module(p);
-        memcpy(dtv[i], p->image, p->len);
+    // Only worth templating with more than one module; with one, the
+    // per-module copy below is already a single memcpy.  The initial
+    // thread is allocated too early to call into malloc, so it always
+    // takes the per-module path.
+    struct tls_template* tmpl = NULL;
+    if (use_template && libc.tls_cnt > 1) {
+        tmpl = atomic_load(&tls_template);
+        if (tmpl == NULL ||
+            tmpl->cnt != libc.tls_cnt || tmpl->size != libc.tls_size)
+            tmpl = compose_tls_template();
+    }
+
+    if (tmpl != NULL) {
+        memcpy(mem + tmpl->lo, tmpl->data, tmpl->len);
+        for (i = 1, p = libc.tls_head; p; i++, p = p->next)
+            dtv[i] = mem + offset_for_module(p);
+    } else {
+        for (i = 1, p = libc.tls_head; p; i++, p = p->next) {
+            dtv[i] = mem + offset_for_module(p);
+            memcpy(dtv[i], p->image, p->len);
+        }
     }
 
     dtv[0] = (void*)libc.tls_cnt;
@@ -167,7 +235,7 @@ __NO_SAFESTACK thrd_t __allocate_thread(
         return NULL;
     }
 
-    thrd_t td = copy_tls(tcb.iov_base, tcb.iov_len);
+    thrd_t td = copy_tls(tcb.iov_base, tcb.iov_len, vmo_name != NULL);
 
     // At this point all our access to global TLS state is done, so we
     // can allow dlopen again.
@@ -13,6 +13,11 @@ struct waiter {
     atomic_int state;
     atomic_int barrier;
     atomic_int* notify;
+    /* Layout must match the pthread waiter (pthread_cond_timedwait.c),
+     * since __private_cond_signal() serves both.  Always NULL here: a
+     * zxr_mutex does not record its owner, so a signaler can never prove
+     * it holds the mutex and waiters are always woken normally. */
+    atomic_int* mutex_futex;
 };
 
 enum {
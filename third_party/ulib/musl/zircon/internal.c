@@ -4,11 +4,35 @@
 #undef _zx_vmar_root_self
 #undef _zx_job_default
 
+#include <limits.h>
 #include <zircon/process.h>
+#include <zircon/syscalls.h>
 
 zx_handle_t __zircon_process_self;
 zx_handle_t __zircon_vmar_root_self;
 zx_handle_t __zircon_job_default;
+const zx_proc_info_t* __zircon_process_info;
+
+__NO_SAFESTACK void __libc_init_process_info(zx_handle_t vmo) {
+    // The creator warrants the page was fully written before the process
+    // started, so a plain read-only mapping is all that's needed; the
+    // mapping lives for the rest of the process.
+    uintptr_t ptr;
+    zx_status_t status = _zx_vmar_map(__zircon_vmar_root_self,
+                                      ZX_VM_PERM_READ, 0,
+                                      vmo, 0, PAGE_SIZE, &ptr);
+    _zx_handle_close(vmo);
+    if (status != ZX_OK)
+        return;
+
+    const zx_proc_info_t* info = (const zx_proc_info_t*)ptr;
+    if (info->magic != ZX_PROC_INFO_MAGIC ||
+        info->version != ZX_PROC_INFO_VERSION) {
+        _zx_vmar_unmap(__zircon_vmar_root_self, ptr, PAGE_SIZE);
+        return;
+    }
+    __zircon_process_info = info;
+}
 
 zx_handle_t _zx_process_self(void) {
     return __zircon_process_self;
@@ -27,3 +51,9 @@ zx_handle_t _zx_job_default(void) {
 }
 __typeof(zx_job_default) zx_job_default
     __attribute__((weak, alias("_zx_job_default")));
+
+const zx_proc_info_t* _zx_process_self_info(void) {
+    return __zircon_process_info;
+}
+__typeof(zx_process_self_info) zx_process_self_info
+    __attribute__((weak, alias("_zx_process_self_info")));